@@ -0,0 +1,58 @@
+#pragma once
+
+// Windows system headers
+#include <windows.h>
+#include <tchar.h>
+
+// Standard library headers
+#include <filesystem>
+
+
+
+// TabTap's files (TabTap.state, TabTap.log, the skin, CBTHook.dll, ...) sit
+// next to TabTap.exe. They are resolved from the module directory, not the
+// working directory: the Run key starts TabTap in System32, and the hook
+// runs inside osk.exe. TabTap.exe and CBTHook.dll live in the same directory,
+// so both sides resolve the same file.
+
+// Path of `pszFileName` in the directory of the module calling this (the
+// executable, or the DLL inside osk.exe); just the file name on failure
+inline std::filesystem::path GetAppFilePath(LPCTSTR pszFileName)
+{
+	static const char anchor{};   // Any address inside this module
+	HMODULE hModule{};
+	if (!GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		reinterpret_cast<LPCTSTR>(&anchor), &hModule))
+	{
+		return pszFileName;
+	}
+
+	TCHAR szModulePath[MAX_PATH];
+	const DWORD dwLength = GetModuleFileName(hModule, szModulePath, MAX_PATH);
+	if (!dwLength or dwLength >= MAX_PATH) { return pszFileName; }
+
+	std::filesystem::path path{ szModulePath };
+	path.replace_filename(pszFileName);
+	return path;
+}
+
+// Buffer form for callers that pass paths as TCHAR arrays
+inline BOOL GetAppFilePath(LPCTSTR pszFileName, LPTSTR szBuffer, size_t cchBuffer)
+{
+	const std::filesystem::path path = GetAppFilePath(pszFileName);
+	if (!path.has_parent_path()) { return FALSE; }
+	return _tcscpy_s(szBuffer, cchBuffer, path.c_str()) == 0;
+}
+
+
+
+
+/*
+Usage example:
+
+	Snapshot::Load(GetAppFilePath(_T("TabTap.state")), &state);
+
+	TCHAR szBuffer[MAX_PATH];
+	if (GetAppFilePath(_T("TabTap.png"), szBuffer, MAX_PATH)) { ... }
+
+*/
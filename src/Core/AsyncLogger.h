@@ -0,0 +1,685 @@
+#pragma once
+
+// Implementation-specific headers
+#include "LogFormat.h"
+#include "RotatingFile.h"
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+
+// Always-on low-overhead logger.
+// A log call copies its site id, a timestamp and the raw arguments into a
+// buffer owned by the calling thread; no formatting, locking or I/O happens
+// on that path. A background thread merges the thread buffers by time and
+// appends binary chunks (see LogFormat.h) to a size-capped rotating file.
+namespace Logging
+{
+	// Static description of one log call site
+	struct Site
+	{
+		Level level;
+		const char* file;
+		uint32_t line;
+		const char* format;
+		std::atomic<uint32_t> id;    // Assigned on first use (0 = unassigned)
+
+		constexpr Site(Level lvl, const char* fileName, uint32_t lineNumber, const char* text) :
+			level{ lvl },
+			file{ fileName },
+			line{ lineNumber },
+			format{ text },
+			id{ 0 }
+		{}
+	};
+
+
+
+	// Normalized log argument
+	struct Arg
+	{
+		ArgType type{};
+		union
+		{
+			int64_t i;
+			uint64_t u;
+			double d;
+		};
+		const char* pText{};         // Narrow string (UTF-8)
+		const wchar_t* pWide{};      // Wide string, converted while encoding
+		size_t length{};             // Encoded string bytes
+
+		Arg() : u{} {}
+	};
+
+	namespace Detail
+	{
+		// UTF-8 bytes of one code point
+		inline size_t Utf8Size(uint32_t cp)
+		{
+			return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+		}
+
+		// Decodes the code point at `*pIndex` (UTF-16 or UTF-32 wchar_t)
+		inline uint32_t NextCodePoint(const wchar_t* pText, size_t* pIndex)
+		{
+			uint32_t cp = uint32_t(pText[(*pIndex)++]);
+			if (sizeof(wchar_t) == 2 and cp >= 0xD800 and cp < 0xDC00) {
+				const uint32_t low = uint32_t(pText[*pIndex]);
+				if (low >= 0xDC00 and low < 0xE000) {
+					++*pIndex;
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				}
+			}
+			return cp;
+		}
+
+		// Encodes at most `capacity` UTF-8 bytes; returns the bytes written
+		inline size_t EncodeWide(const wchar_t* pText, uint8_t* pOut, size_t capacity)
+		{
+			size_t written{}, index{};
+			while (pText[index]) {
+				const uint32_t cp = NextCodePoint(pText, &index);
+				const size_t size = Utf8Size(cp);
+				if (written + size > capacity) { break; }
+
+				if (pOut) {
+					uint8_t* p = pOut + written;
+					if (size == 1) { p[0] = uint8_t(cp); }
+					else if (size == 2) {
+						p[0] = uint8_t(0xC0 | (cp >> 6));
+						p[1] = uint8_t(0x80 | (cp & 0x3F));
+					}
+					else if (size == 3) {
+						p[0] = uint8_t(0xE0 | (cp >> 12));
+						p[1] = uint8_t(0x80 | ((cp >> 6) & 0x3F));
+						p[2] = uint8_t(0x80 | (cp & 0x3F));
+					}
+					else {
+						p[0] = uint8_t(0xF0 | (cp >> 18));
+						p[1] = uint8_t(0x80 | ((cp >> 12) & 0x3F));
+						p[2] = uint8_t(0x80 | ((cp >> 6) & 0x3F));
+						p[3] = uint8_t(0x80 | (cp & 0x3F));
+					}
+				}
+				written += size;
+			}
+			return written;
+		}
+
+		inline Arg MakeString(const char* pText)
+		{
+			Arg arg{};
+			arg.type = ArgType::String;
+			arg.pText = pText ? pText : "(null)";
+			while (arg.length < MaxStringBytes and arg.pText[arg.length]) { ++arg.length; }
+			return arg;
+		}
+
+		inline Arg MakeString(const wchar_t* pText)
+		{
+			if (!pText) { return MakeString("(null)"); }
+			Arg arg{};
+			arg.type = ArgType::String;
+			arg.pWide = pText;
+			arg.length = EncodeWide(pText, nullptr, MaxStringBytes);
+			return arg;
+		}
+
+		template <typename ValueTy>
+		Arg MakeArg(const ValueTy& value)
+		{
+			Arg arg{};
+			if constexpr (std::is_enum_v<ValueTy>) {
+				return MakeArg(std::underlying_type_t<ValueTy>(value));
+			}
+			else if constexpr (std::is_same_v<ValueTy, bool>) {
+				arg.type = ArgType::UInt;
+				arg.u = value ? 1 : 0;
+			}
+			else if constexpr (std::is_floating_point_v<ValueTy>) {
+				arg.type = ArgType::Double;
+				arg.d = double(value);
+			}
+			else if constexpr (std::is_integral_v<ValueTy> and std::is_signed_v<ValueTy>) {
+				arg.type = ArgType::Int;
+				arg.i = int64_t(value);
+			}
+			else if constexpr (std::is_integral_v<ValueTy>) {
+				arg.type = ArgType::UInt;
+				arg.u = uint64_t(value);
+			}
+			else if constexpr (std::is_convertible_v<ValueTy, const char*>) {
+				return MakeString(static_cast<const char*>(value));
+			}
+			else if constexpr (std::is_convertible_v<ValueTy, const wchar_t*>) {
+				return MakeString(static_cast<const wchar_t*>(value));
+			}
+			else if constexpr (std::is_same_v<ValueTy, std::string>) {
+				return MakeString(value.c_str());
+			}
+			else if constexpr (std::is_same_v<ValueTy, std::wstring>) {
+				return MakeString(value.c_str());
+			}
+			else if constexpr (std::is_pointer_v<ValueTy>) {
+				arg.type = ArgType::UInt;
+				arg.u = uint64_t(reinterpret_cast<uintptr_t>(value));
+			}
+			else {
+				static_assert(std::is_pointer_v<ValueTy>, "Unsupported log argument type");
+			}
+			return arg;
+		}
+
+		// Encoded size of one argument
+		inline size_t EncodedSize(const Arg& arg)
+		{
+			return 1 + (arg.type == ArgType::String ? sizeof(uint16_t) + arg.length : 8);
+		}
+
+		// Writes one argument; returns the next output position
+		inline uint8_t* Encode(const Arg& arg, uint8_t* pOut)
+		{
+			*pOut++ = uint8_t(arg.type);
+			if (arg.type == ArgType::String) {
+				const uint16_t length = uint16_t(arg.length);
+				std::memcpy(pOut, &length, sizeof(length));
+				pOut += sizeof(length);
+				if (arg.pWide) { EncodeWide(arg.pWide, pOut, arg.length); }
+				else { std::memcpy(pOut, arg.pText, arg.length); }
+				return pOut + arg.length;
+			}
+			std::memcpy(pOut, &arg.u, 8);
+			return pOut + 8;
+		}
+	}
+
+
+
+	// Single-producer byte ring owned by one logging thread
+	class ThreadBuffer
+	{
+	public:
+		static constexpr size_t Capacity = 64 * 1024;   // Bytes (power of two)
+		static constexpr size_t Alignment = 8;
+
+		// Entry prefix inside the ring. Entries start at Alignment boundaries;
+		// zeroed bytes (siteId 0) pad the end of the ring before a wrap, and a
+		// tail shorter than an Entry is always padding.
+		struct Entry
+		{
+			uint32_t size{};         // Entry bytes including this prefix (unaligned)
+			uint32_t siteId{};
+			uint64_t time{};
+		};
+
+		static constexpr size_t AlignUp(size_t size)
+		{
+			return (size + Alignment - 1) & ~(Alignment - 1);
+		}
+
+	private:
+		alignas(64) std::atomic<uint64_t> writeIndex{};   // Producer position
+		std::atomic<bool> isWriting{};                    // Owning thread is inside a log call
+		alignas(64) std::atomic<uint64_t> readIndex{};    // Consumer position
+		alignas(64) std::atomic<uint64_t> dropped{};      // Entries lost to a full buffer
+		std::atomic<bool> isRetired{};                    // Owning thread has exited
+		const uint32_t threadId;
+		std::unique_ptr<uint8_t[]> spData{ new uint8_t[Capacity] };
+
+	public:
+		explicit ThreadBuffer(uint32_t id) :
+			threadId{ id }
+		{}
+
+		uint32_t GetThreadId() const { return threadId; }
+
+		// Producer: reserves `size` (aligned) contiguous bytes, or nullptr if full
+		uint8_t* Reserve(size_t size)
+		{
+			const uint64_t tail = writeIndex.load(std::memory_order_relaxed);
+			const uint64_t head = readIndex.load(std::memory_order_acquire);
+			const size_t offset = size_t(tail & (Capacity - 1));
+			const size_t contiguous = Capacity - offset;
+			const size_t needed = size + (size > contiguous ? contiguous : 0);
+
+			if (tail + needed - head > Capacity) {
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			if (size > contiguous) {
+				// Pad to the end so entries never wrap; the tail may be shorter than an Entry
+				std::memset(spData.get() + offset, 0, contiguous);
+				writeIndex.store(tail + contiguous, std::memory_order_release);
+				return spData.get();
+			}
+			return spData.get() + offset;
+		}
+
+		// Producer: publishes the entry written into the reserved bytes
+		void Commit(size_t size)
+		{
+			const uint64_t tail = writeIndex.load(std::memory_order_relaxed);
+			writeIndex.store(tail + size, std::memory_order_release);
+		}
+
+		// Consumer: passes each complete entry to `sink(const Entry&, args, argsLength)`
+		template <typename SinkFunc>
+		size_t Drain(SinkFunc&& sink)
+		{
+			uint64_t head = readIndex.load(std::memory_order_relaxed);
+			const uint64_t tail = writeIndex.load(std::memory_order_acquire);
+			size_t count{};
+
+			while (head != tail) {
+				const size_t offset = size_t(head & (Capacity - 1));
+				const uint8_t* p = spData.get() + offset;
+				Entry entry{};
+				if (Capacity - offset >= sizeof(Entry)) { std::memcpy(&entry, p, sizeof(entry)); }
+
+				if (!entry.siteId) {
+					// Wrap padding
+					head += Capacity - offset;
+					continue;
+				}
+
+				sink(entry, p + sizeof(Entry), size_t(entry.size) - sizeof(Entry));
+				++count;
+				head += AlignUp(entry.size);
+			}
+
+			readIndex.store(head, std::memory_order_release);
+			return count;
+		}
+
+		bool IsEmpty() const
+		{
+			return readIndex.load(std::memory_order_relaxed) ==
+				writeIndex.load(std::memory_order_acquire);
+		}
+
+		// Producer: brackets a log call so Stop can wait for it
+		void BeginWrite() { isWriting.store(true, std::memory_order_seq_cst); }
+		void EndWrite() { isWriting.store(false, std::memory_order_release); }
+		bool IsWriting() const { return isWriting.load(std::memory_order_acquire); }
+
+		uint64_t TakeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+		void Retire() { isRetired.store(true, std::memory_order_release); }
+		bool IsRetired() const { return isRetired.load(std::memory_order_acquire); }
+	};
+
+
+
+	class AsyncLogger
+	{
+	public:
+		struct Config
+		{
+			uint64_t maxFileBytes{ 4 * 1024 * 1024 };       // Rotation size
+			unsigned keepFiles{ 3 };                         // Rotated copies kept
+			std::chrono::milliseconds flushInterval{ 200 };  // Background flush period
+			Level minimumLevel{ Level::Info };               // Calls below are skipped
+		};
+
+	private:
+		// Pending record copied out of a thread buffer
+		struct Pending
+		{
+			uint64_t time{};
+			uint32_t siteId{};
+			uint32_t threadId{};
+			size_t offset{};         // Into the argument arena
+			size_t length{};
+		};
+
+		// Per-thread registration (one logger per thread at a time)
+		struct LocalSlot
+		{
+			const AsyncLogger* pOwner{};
+			std::shared_ptr<ThreadBuffer> spBuffer{};
+
+			~LocalSlot() { if (spBuffer) { spBuffer->Retire(); } }
+		};
+
+		Config config{};
+		std::atomic<bool> isRunning{};
+		std::atomic<uint8_t> minimumLevel{};
+
+		std::mutex registryMutex{};                               // Guards the two lists below
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers{};
+		std::vector<const Site*> sites{};                         // Index = id - 1
+		uint32_t nextThreadId{ 1 };
+
+		// Flush thread state
+		std::mutex wakeMutex{};
+		std::condition_variable wake{};
+		bool isStopping{};
+		std::thread flusher{};
+
+		RotatingFile file{};
+		FileHeader fileHeader{};
+		size_t writtenSites{};                                    // Sites defined in the active file
+		std::chrono::steady_clock::time_point origin{};
+
+	private:
+		static uint64_t Now()
+		{
+			return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		ThreadBuffer* GetLocalBuffer()
+		{
+			thread_local LocalSlot slot{};
+			if (slot.pOwner != this or !slot.spBuffer) {
+				if (slot.spBuffer) { slot.spBuffer->Retire(); }
+
+				std::lock_guard<std::mutex> lock{ registryMutex };
+				slot.spBuffer = std::make_shared<ThreadBuffer>(nextThreadId++);
+				slot.pOwner = this;
+				buffers.push_back(slot.spBuffer);
+			}
+			return slot.spBuffer.get();
+		}
+
+		uint32_t RegisterSite(Site& site)
+		{
+			std::lock_guard<std::mutex> lock{ registryMutex };
+			uint32_t id = site.id.load(std::memory_order_relaxed);
+			if (!id) {
+				sites.push_back(&site);
+				id = uint32_t(sites.size());
+				site.id.store(id, std::memory_order_release);
+			}
+			return id;
+		}
+
+		void WriteChunk(ChunkType type, const void* pHead, size_t headLength,
+			const void* pTail = nullptr, size_t tailLength = 0,
+			const void* pExtra = nullptr, size_t extraLength = 0)
+		{
+			ChunkHeader header{};
+			header.type = uint16_t(type);
+			header.size = uint32_t(headLength + tailLength + extraLength);
+
+			// Every file starts with its own header and the site table
+			if (!file.Fits(sizeof(header) + header.size)) {
+				file.Rotate();
+				WriteFileStart();
+			}
+
+			file.Write(&header, sizeof(header));
+			file.Write(pHead, headLength);
+			if (tailLength) { file.Write(pTail, tailLength); }
+			if (extraLength) { file.Write(pExtra, extraLength); }
+		}
+
+		void WriteSite(uint32_t id, const Site& site)
+		{
+			const char* fileName = site.file ? site.file : "";
+			const char* format = site.format ? site.format : "";
+
+			SiteChunk chunk{};
+			chunk.id = id;
+			chunk.level = uint8_t(site.level);
+			chunk.fileLength = uint16_t(std::min<size_t>(std::strlen(fileName), UINT16_MAX));
+			chunk.line = site.line;
+			chunk.formatLength = uint16_t(std::min<size_t>(std::strlen(format), UINT16_MAX));
+
+			WriteChunk(ChunkType::Site, &chunk, sizeof(chunk),
+				fileName, chunk.fileLength, format, chunk.formatLength);
+		}
+
+		// Writes the file header and every site known so far
+		void WriteFileStart()
+		{
+			file.Write(&fileHeader, sizeof(fileHeader));
+
+			std::vector<const Site*> known{};
+			{
+				std::lock_guard<std::mutex> lock{ registryMutex };
+				known.assign(sites.begin(), sites.begin() + writtenSites);
+			}
+			for (size_t i{}; i < known.size(); ++i) {
+				WriteSite(uint32_t(i + 1), *known[i]);
+			}
+		}
+
+		// Moves everything committed so far into the file
+		void FlushOnce()
+		{
+			std::vector<std::shared_ptr<ThreadBuffer>> snapshot{};
+			{
+				std::lock_guard<std::mutex> lock{ registryMutex };
+				snapshot = buffers;
+			}
+
+			std::vector<Pending> pending{};
+			std::vector<uint8_t> arena{};
+			for (const auto& spBuffer : snapshot) {
+				const uint32_t threadId = spBuffer->GetThreadId();
+				spBuffer->Drain([&](const ThreadBuffer::Entry& entry, const uint8_t* pArgs, size_t length) {
+					pending.push_back({ entry.time, entry.siteId, threadId, arena.size(), length });
+					arena.insert(arena.end(), pArgs, pArgs + length);
+					});
+			}
+
+			// Define sites registered since the last pass (records only use registered ids)
+			std::vector<const Site*> added{};
+			{
+				std::lock_guard<std::mutex> lock{ registryMutex };
+				added.assign(sites.begin() + writtenSites, sites.end());
+			}
+			for (const Site* pSite : added) {
+				WriteSite(uint32_t(writtenSites + 1), *pSite);
+				++writtenSites;
+			}
+
+			// Merge the per-thread streams into one timeline
+			std::stable_sort(pending.begin(), pending.end(),
+				[](const Pending& a, const Pending& b) { return a.time < b.time; });
+
+			for (const Pending& item : pending) {
+				const RecordChunk chunk{ item.siteId, item.threadId, item.time };
+				WriteChunk(ChunkType::Record, &chunk, sizeof(chunk),
+					arena.data() + item.offset, item.length);
+			}
+
+			for (const auto& spBuffer : snapshot) {
+				if (const uint64_t count = spBuffer->TakeDropped()) {
+					const DroppedChunk chunk{ spBuffer->GetThreadId(), 0, count };
+					WriteChunk(ChunkType::Dropped, &chunk, sizeof(chunk));
+				}
+			}
+
+			file.Flush();
+
+			// Forget buffers of exited threads once they are empty
+			std::lock_guard<std::mutex> lock{ registryMutex };
+			buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+				[](const std::shared_ptr<ThreadBuffer>& spBuffer) {
+					// Retire follows the thread's last write, so empty means done
+					return spBuffer->IsRetired() and spBuffer->IsEmpty();
+				}), buffers.end());
+		}
+
+		// Waits for log calls that saw the logger running to commit or give up
+		void WaitForWriters()
+		{
+			std::vector<std::shared_ptr<ThreadBuffer>> snapshot{};
+			{
+				std::lock_guard<std::mutex> lock{ registryMutex };
+				snapshot = buffers;
+			}
+			for (const auto& spBuffer : snapshot) {
+				while (spBuffer->IsWriting()) { std::this_thread::yield(); }
+			}
+		}
+
+		void FlushLoop()
+		{
+			std::unique_lock<std::mutex> lock{ wakeMutex };
+			while (!isStopping) {
+				wake.wait_for(lock, config.flushInterval);
+				lock.unlock();
+				FlushOnce();
+				lock.lock();
+			}
+		}
+
+	public:
+		~AsyncLogger() { Stop(); }
+		AsyncLogger() = default;
+		AsyncLogger(const AsyncLogger&) = delete;
+		AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+		// Opens a fresh log file and starts the flush thread
+		bool Start(const std::filesystem::path& path)
+		{
+			return Start(path, Config{});
+		}
+
+		bool Start(const std::filesystem::path& path, const Config& cfg)
+		{
+			if (isRunning.load(std::memory_order_relaxed)) { return false; }
+
+			config = cfg;
+			minimumLevel.store(uint8_t(cfg.minimumLevel), std::memory_order_relaxed);
+
+			if (!file.Open(path, config.maxFileBytes, config.keepFiles)) { return false; }
+			if (file.GetSize() and !file.Rotate()) { return false; }   // One session per file
+
+			origin = std::chrono::steady_clock::now();
+			fileHeader.magic = FileMagic;
+			fileHeader.version = FileVersion;
+			fileHeader.steadyOriginNs = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				origin.time_since_epoch()).count());
+			fileHeader.wallOriginNs = int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count());
+
+			writtenSites = 0;
+			file.Write(&fileHeader, sizeof(fileHeader));
+
+			isStopping = false;
+			flusher = std::thread{ [this]() { FlushLoop(); } };
+			isRunning.store(true, std::memory_order_release);
+			return true;
+		}
+
+		// Stops accepting records, waits for log calls under way, writes everything
+		// they and earlier calls logged and closes the file
+		void Stop()
+		{
+			if (!isRunning.exchange(false, std::memory_order_seq_cst)) { return; }
+
+			{
+				std::lock_guard<std::mutex> lock{ wakeMutex };
+				isStopping = true;
+			}
+			wake.notify_one();
+			flusher.join();
+
+			WaitForWriters();
+			FlushOnce();   // Records committed while the flusher was finishing
+			file.Close();
+		}
+
+		bool IsRunning() const
+		{
+			return isRunning.load(std::memory_order_relaxed);
+		}
+
+		void SetMinimumLevel(Level level)
+		{
+			minimumLevel.store(uint8_t(level), std::memory_order_relaxed);
+		}
+
+		// Hot path: copies the call into the thread buffer (never blocks)
+		template <typename... ArgTy>
+		void Log(Site& site, const ArgTy&... args)
+		{
+			if (!isRunning.load(std::memory_order_relaxed) or
+				uint8_t(site.level) < minimumLevel.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			uint32_t siteId = site.id.load(std::memory_order_acquire);
+			if (!siteId) { siteId = RegisterSite(site); }
+
+			const Arg encoded[sizeof...(ArgTy) + 1] = { Detail::MakeArg(args)... };
+			size_t size = sizeof(ThreadBuffer::Entry);
+			for (size_t i{}; i < sizeof...(ArgTy); ++i) {
+				size += Detail::EncodedSize(encoded[i]);
+			}
+			const size_t reserved = ThreadBuffer::AlignUp(size);
+
+			// A call that still sees the logger running after BeginWrite is one
+			// Stop waits for, so it lands in the file or in the drop count
+			ThreadBuffer* pBuffer = GetLocalBuffer();
+			pBuffer->BeginWrite();
+			if (!isRunning.load(std::memory_order_seq_cst)) {
+				pBuffer->EndWrite();
+				return;
+			}
+
+			if (uint8_t* p = pBuffer->Reserve(reserved)) {
+				const ThreadBuffer::Entry entry{ uint32_t(size), siteId, Now() };
+				std::memcpy(p, &entry, sizeof(entry));
+				uint8_t* pOut = p + sizeof(entry);
+				for (size_t i{}; i < sizeof...(ArgTy); ++i) {
+					pOut = Detail::Encode(encoded[i], pOut);
+				}
+				pBuffer->Commit(reserved);
+			}
+			pBuffer->EndWrite();
+		}
+	};
+}
+
+
+
+// Call-site macros; the format uses "{}" placeholders filled in by the decoder
+#define LOG_AT(logger, level, format, ...) \
+	do { \
+		static Logging::Site logSite_{ level, __FILE__, __LINE__, format }; \
+		(logger).Log(logSite_, ##__VA_ARGS__); \
+	} while (0)
+
+#define LOG_DEBUG(logger, format, ...)   LOG_AT(logger, Logging::Level::Debug, format, ##__VA_ARGS__)
+#define LOG_INFO(logger, format, ...)    LOG_AT(logger, Logging::Level::Info, format, ##__VA_ARGS__)
+#define LOG_WARNING(logger, format, ...) LOG_AT(logger, Logging::Level::Warning, format, ##__VA_ARGS__)
+#define LOG_ERROR(logger, format, ...)   LOG_AT(logger, Logging::Level::Error, format, ##__VA_ARGS__)
+
+
+
+
+/*
+Usage example:
+
+	Logging::AsyncLogger logger{};
+	logger.Start("TabTap.log");
+
+	LOG_INFO(logger, "OSK started, pid {}", processId);
+	LOG_ERROR(logger, "{} failed: {}", L"CreateWindow", GetLastError());
+
+	logger.Stop();   // Everything logged before Stop is in the file
+
+	// Offline: LogDecoder TabTap.log
+
+*/
@@ -0,0 +1,275 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+
+// Decides when focus changes should show or hide the keyboard, the way
+// TabTip pops up over an editable field. Focus events are reduced to a
+// target class (text or not) per element; a change only counts once focus
+// has rested on the new element for a while, shorter for showing than for
+// hiding, so focus storms and tabbing through a form post nothing until
+// they settle. Times are milliseconds on a caller-supplied clock.
+namespace AutoShow
+{
+	// UIA control type identifiers (UIAutomationClient.h) the classifier reads
+	constexpr int32_t ControlTypeComboBox = 50003;
+	constexpr int32_t ControlTypeEdit = 50004;
+	constexpr int32_t ControlTypeDocument = 50030;
+
+	// Pattern and property lookups of an element (combinable)
+	enum TraitFlags : uint8_t
+	{
+		TraitNone         = 0x00,
+		TraitValuePattern = 0x01,  // IsValuePatternAvailable
+		TraitTextPattern  = 0x02,  // IsTextPatternAvailable
+		TraitReadOnly     = 0x04,  // ValueIsReadOnly
+		TraitOwnWindow    = 0x08   // Belongs to the tab or the keyboard itself
+	};
+
+	struct Element
+	{
+		int32_t controlType{};
+		uint8_t traits{};                    // TraitFlags
+	};
+
+	enum class Target : uint8_t
+	{
+		Other,                               // Anything that takes no text
+		Text,                                // An editable field
+		Ignored                              // The tab or keyboard; focus there changes nothing
+	};
+
+	enum class Action : uint8_t
+	{
+		None,
+		Show,
+		Hide
+	};
+
+	constexpr uint64_t NoDeadline = std::numeric_limits<uint64_t>::max();
+
+	/// Sorts a focused element into a target class
+	inline Target Classify(const Element& element)
+	{
+		if (element.traits & TraitOwnWindow) { return Target::Ignored; }
+
+		const bool isEditableValue = (element.traits & TraitValuePattern) and !(element.traits & TraitReadOnly);
+		switch (element.controlType)
+		{
+		case ControlTypeEdit:
+			// Some editors (and password boxes) expose no value pattern
+			return (isEditableValue or !(element.traits & TraitValuePattern)) ? Target::Text : Target::Other;
+		case ControlTypeDocument:
+			// Browser pages are read-only documents; rich editors are not
+		case ControlTypeComboBox:
+			return isEditableValue ? Target::Text : Target::Other;
+		default:
+			return Target::Other;
+		}
+	}
+
+	/// Hashes a UIA runtime identifier into a cache and policy key (FNV-1a)
+	inline uint64_t HashRuntimeId(const int32_t* pParts, size_t count)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i{}; i < count; ++i) {
+			const uint32_t part = uint32_t(pParts[i]);
+			for (unsigned shift{}; shift < 32; shift += 8) {
+				hash ^= (part >> shift) & 0xFF;
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+
+
+	// Remembers the lookups of recently focused elements, so focus returning to
+	// an element needs no round trip into its process. Least recently used
+	// entries make room; entries expire so a field turning read-only is noticed.
+	class ElementCache
+	{
+	public:
+		static constexpr size_t Capacity = 64;
+
+		struct Config
+		{
+			uint32_t maxAgeMs{ 30000 };      // Oldest lookup still trusted
+		};
+
+	private:
+		struct Entry
+		{
+			uint64_t key{};
+			uint64_t storedMs{};
+			uint64_t usedTick{};             // Order of use for eviction
+			Element element{};
+			bool isUsed{};
+		};
+
+		Config config{};
+		Entry entries[Capacity]{};
+		uint64_t tick{};
+		uint64_t hits{};
+		uint64_t misses{};
+
+	public:
+		ElementCache() = default;
+		explicit ElementCache(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		/// Looks up an element; false if unknown or expired
+		bool Find(uint64_t key, uint64_t nowMs, Element* pElement)
+		{
+			for (Entry& entry : entries) {
+				if (entry.isUsed and entry.key == key) {
+					if (nowMs - entry.storedMs > config.maxAgeMs) { break; }
+					entry.usedTick = ++tick;
+					*pElement = entry.element;
+					++hits;
+					return true;
+				}
+			}
+			++misses;
+			return false;
+		}
+
+		/// Stores a lookup, replacing the entry of the same key or the least recently used one
+		void Store(uint64_t key, const Element& element, uint64_t nowMs)
+		{
+			Entry* pVictim = &entries[0];
+			for (Entry& entry : entries) {
+				if (entry.isUsed and entry.key == key) {
+					pVictim = &entry;
+					break;
+				}
+				if (!entry.isUsed) {
+					if (pVictim->isUsed) { pVictim = &entry; }
+				}
+				else if (pVictim->isUsed and entry.usedTick < pVictim->usedTick) {
+					pVictim = &entry;
+				}
+			}
+			*pVictim = { key, nowMs, ++tick, element, true };
+		}
+
+		void Clear() { *this = ElementCache{ config }; }
+		uint64_t GetHits() const { return hits; }
+		uint64_t GetMisses() const { return misses; }
+	};
+
+
+
+	// Turns the stream of focused targets into show and hide decisions.
+	// A text field shows the keyboard once focus has rested on it; leaving
+	// text hides it again only if it was shown for focus. A keyboard the user
+	// opened stays until the user closes it, and one the user closed over a
+	// field stays closed until focus moves to another field.
+	class Policy
+	{
+	public:
+		struct Config
+		{
+			uint32_t showDelayMs{ 100 };     // Rest on a text field before showing
+			uint32_t hideDelayMs{ 500 };     // Rest elsewhere before hiding
+		};
+
+	private:
+		Config config{};
+		Target focus{ Target::Other };       // Latest focused target
+		uint64_t focusKey{};                 // ...its element
+		uint64_t focusMs{};                  // ...when focus arrived there
+		uint64_t settledKey{};               // Element the last decision was made for
+		bool isPending{};                    // Focus moved since then
+		Action lastAction{ Action::Hide };   // Last decision, or the user's toggle
+		bool isPinned{};                     // The user opened the keyboard
+
+	public:
+		Policy() = default;
+		explicit Policy(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		/// Records a focus change to an element (`key` from HashRuntimeId)
+		void OnFocus(Target target, uint64_t key, uint64_t nowMs)
+		{
+			if (target == Target::Ignored) { return; }
+			// Repeats of the same focus do not restart the delay
+			if (isPending and key == focusKey and target == focus) { return; }
+
+			focus = target;
+			focusKey = key;
+			focusMs = nowMs;
+			// Back on the settled element before it was left for good
+			isPending = key != settledKey;
+		}
+
+		/// Records a show or hide by the user (tab tap)
+		void OnUserToggle(bool isVisible)
+		{
+			lastAction = isVisible ? Action::Show : Action::Hide;
+			isPinned = isVisible;
+		}
+
+		/// Returns when the pending decision is due (NoDeadline when none is)
+		uint64_t GetDeadline() const
+		{
+			if (!isPending) { return NoDeadline; }
+			return focusMs + (focus == Target::Text ? config.showDelayMs : config.hideDelayMs);
+		}
+
+		/// Takes the decision once focus has settled; Action::None otherwise
+		Action Take(uint64_t nowMs)
+		{
+			if (!isPending or nowMs < GetDeadline()) { return Action::None; }
+
+			isPending = false;
+			settledKey = focusKey;
+
+			// Every newly focused field asks for the keyboard; it may have been closed meanwhile
+			if (focus == Target::Text) {
+				lastAction = Action::Show;
+				return Action::Show;
+			}
+			if (lastAction == Action::Show and !isPinned) {
+				lastAction = Action::Hide;
+				return Action::Hide;
+			}
+			return Action::None;
+		}
+
+		bool IsPending() const { return isPending; }
+		const Config& GetConfig() const { return config; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	AutoShow::ElementCache cache{};
+	AutoShow::Policy policy{};
+
+	// Focus event (UIA thread)
+	AutoShow::Element element{};
+	if (!cache.Find(key, NowMs(), &element)) {
+		element = LookUpElement(pElement);      // Cross-process
+		cache.Store(key, element, NowMs());
+	}
+	policy.OnFocus(AutoShow::Classify(element), key, NowMs());
+
+	// Watcher thread, woken by the event or at policy.GetDeadline()
+	switch (policy.Take(NowMs())) {
+	case AutoShow::Action::Show: PostShow(); break;
+	case AutoShow::Action::Hide: PostHide(); break;
+	default: break;
+	}
+
+*/
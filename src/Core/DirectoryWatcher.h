@@ -0,0 +1,23 @@
+#pragma once
+
+// Standard library headers
+#include <filesystem>
+#include <functional>
+
+
+
+// Interface for platform directory change notification sources
+struct IDirectoryWatcher
+{
+	// Callback invoked from the watcher thread on any change in the directory
+	using ChangeCallback = std::function<void()>;
+
+	// Starts watching the directory; returns false if it cannot be watched
+	virtual bool Start(const std::filesystem::path&, ChangeCallback) = 0;
+	// Stops watching and joins the watcher thread
+	virtual void Stop() = 0;
+	// Checks if the watcher is running
+	virtual bool IsRunning() const = 0;
+	// Default virtual destructor
+	virtual ~IDirectoryWatcher() = default;
+};
@@ -0,0 +1,345 @@
+#pragma once
+
+// Implementation-specific headers
+#include "RenderBackend.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// Keyframed visual effects for the tab image. An effect is a set of tracks
+// (tint, alpha, pulse) sampled on a fixed frame grid from a monotonic
+// millisecond clock. Samples are quantized to bytes, so equal frames share
+// one pre-rendered image in the FrameCache and the owner only needs a timer
+// while an effect is playing.
+namespace Effects
+{
+	enum class Channel : uint8_t
+	{
+		Tint,        // Amount of the effect colour added (0..1)
+		Alpha,       // Opacity multiplier (0..1)
+		Pulse        // Brightness multiplier (0..1)
+	};
+
+	enum class Interpolation : uint8_t
+	{
+		Step,        // Holds each value until the next key
+		Linear       // Blends toward the next key
+	};
+
+	struct Keyframe
+	{
+		uint32_t timeMs{};
+		float value{};
+	};
+
+	// Keys sorted by time; a looping track repeats every last-key time
+	struct Track
+	{
+		Channel channel{};
+		Interpolation interpolation{};
+		bool isLooping{};
+		const Keyframe* pKeys{};
+		size_t keyCount{};
+	};
+
+	struct Effect
+	{
+		const Track* pTracks{};
+		size_t trackCount{};
+		uint32_t durationMs{};
+		uint32_t frameMs{};          // Sampling grid (the timer period)
+		uint32_t tintColor{};        // 0xRRGGBB
+	};
+
+	// Quantized effect state for one frame (with the tint colour, the frame cache key)
+	struct Sample
+	{
+		uint8_t tint{};
+		uint8_t alpha{ 0xff };
+		uint8_t pulse{ 0xff };
+
+		bool IsNeutral() const { return tint == 0 and alpha == 0xff and pulse == 0xff; }
+		bool operator==(const Sample& other) const
+		{
+			return tint == other.tint and alpha == other.alpha and pulse == other.pulse;
+		}
+		bool operator!=(const Sample& other) const { return !(*this == other); }
+	};
+
+
+
+	// Value of a track at a time since the effect started
+	inline float SampleTrack(const Track& track, uint32_t timeMs)
+	{
+		if (!track.keyCount) { return 0.0f; }
+
+		const Keyframe* pKeys = track.pKeys;
+		const uint32_t lastMs = pKeys[track.keyCount - 1].timeMs;
+		if (track.isLooping and lastMs) { timeMs %= lastMs; }
+
+		if (timeMs <= pKeys[0].timeMs) { return pKeys[0].value; }
+		for (size_t i = 1; i < track.keyCount; ++i) {
+			if (timeMs < pKeys[i].timeMs) {
+				const Keyframe& from = pKeys[i - 1];
+				if (track.interpolation == Interpolation::Step) { return from.value; }
+
+				const float t = float(timeMs - from.timeMs) / float(pKeys[i].timeMs - from.timeMs);
+				return from.value + (pKeys[i].value - from.value) * t;
+			}
+		}
+		return pKeys[track.keyCount - 1].value;
+	}
+
+	inline uint8_t ToByte(float value)
+	{
+		return uint8_t(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	// Quantized state of all tracks
+	inline Sample SampleEffect(const Effect& effect, uint32_t timeMs)
+	{
+		Sample sample{};
+		for (size_t i{}; i < effect.trackCount; ++i) {
+			const Track& track = effect.pTracks[i];
+			const uint8_t value = ToByte(SampleTrack(track, timeMs));
+			switch (track.channel)
+			{
+			case Channel::Tint:    sample.tint = value; break;
+			case Channel::Alpha:   sample.alpha = value; break;
+			case Channel::Pulse:   sample.pulse = value; break;
+			}
+		}
+		return sample;
+	}
+
+	// Colour transform that renders a sample
+	inline Render::ColorMatrix MakeMatrix(const Sample& sample, uint32_t tintColor)
+	{
+		Render::ColorMatrix matrix = Render::IdentityMatrix;
+		const float pulse = sample.pulse / 255.0f;
+		const float tint = sample.tint / 255.0f;
+
+		matrix.m[0][0] = matrix.m[1][1] = matrix.m[2][2] = pulse;
+		matrix.m[3][3] = sample.alpha / 255.0f;
+		matrix.m[4][0] = ((tintColor >> 16) & 0xff) / 255.0f * tint;
+		matrix.m[4][1] = ((tintColor >> 8) & 0xff) / 255.0f * tint;
+		matrix.m[4][2] = (tintColor & 0xff) / 255.0f * tint;
+		return matrix;
+	}
+
+
+
+	// Plays one effect against a monotonic millisecond clock
+	class Player
+	{
+	private:
+		const Effect* pEffect{};
+		uint64_t startMs{};
+		uint32_t frameIndex{};
+		Sample sample{};
+
+	public:
+		void Start(const Effect& effect, uint64_t nowMs)
+		{
+			pEffect = &effect;
+			startMs = nowMs;
+			frameIndex = 0;
+			sample = SampleEffect(effect, 0);
+		}
+
+		void Stop()
+		{
+			pEffect = nullptr;
+			sample = {};
+		}
+
+		bool IsPlaying() const { return pEffect != nullptr; }
+		const Effect* GetEffect() const { return pEffect; }
+		const Sample& GetSample() const { return sample; }
+		uint32_t GetFrameIndex() const { return frameIndex; }
+
+		// Moves to the frame for `nowMs`; returns true if the sample changed
+		bool Advance(uint64_t nowMs)
+		{
+			if (!pEffect) { return false; }
+
+			// A clock that stepped back restarts the current frame
+			const uint64_t elapsed = nowMs >= startMs ? nowMs - startMs : 0;
+			const Sample previous = sample;
+
+			if (elapsed >= pEffect->durationMs) {
+				Stop();
+				return !previous.IsNeutral();
+			}
+
+			const uint32_t frameMs = std::max<uint32_t>(pEffect->frameMs, 1);
+			frameIndex = uint32_t(elapsed / frameMs);
+			sample = SampleEffect(*pEffect, frameIndex * frameMs);
+			return sample != previous;
+		}
+
+		// Milliseconds until the next frame or the end (0 when stopped)
+		uint32_t GetDelayMs(uint64_t nowMs) const
+		{
+			if (!pEffect) { return 0; }
+
+			const uint64_t elapsed = nowMs >= startMs ? nowMs - startMs : 0;
+			if (elapsed >= pEffect->durationMs) { return 1; }
+
+			const uint32_t frameMs = std::max<uint32_t>(pEffect->frameMs, 1);
+			const uint64_t nextMs = std::min<uint64_t>((elapsed / frameMs + 1) * frameMs, pEffect->durationMs);
+			return uint32_t(nextMs - elapsed);
+		}
+	};
+
+
+
+	// Source image rendered once per distinct sample
+	class FrameCache
+	{
+	public:
+		static constexpr size_t MaxFrames = 32;   // Older frames are dropped beyond this
+
+	private:
+		struct Entry
+		{
+			Sample sample{};
+			uint32_t tintColor{};
+			std::vector<Render::Pixel> pixels{};
+
+			bool Matches(const Sample& other, uint32_t otherTint) const
+			{
+				return sample == other and tintColor == otherTint;
+			}
+		};
+
+		uint64_t sourceId{};             // Generation of the cached source image (0: none)
+		long width{};
+		long height{};
+		std::vector<Entry> entries{};
+		uint64_t hits{};
+		uint64_t misses{};
+
+	private:
+		const Entry& RenderFrame(const Render::ImageView& source, const Sample& sample, uint32_t tintColor)
+		{
+			if (entries.size() >= MaxFrames) { entries.erase(entries.begin()); }
+
+			Entry entry{ sample, tintColor, std::vector<Render::Pixel>(size_t(width) * size_t(height)) };
+			const Render::ColorMatrix matrix = MakeMatrix(sample, tintColor);
+
+			Render::Layer layer{};
+			layer.kind = Render::LayerKind::Image;
+			layer.image = source;
+			layer.pMatrix = &matrix;
+			Render::Compose({ entry.pixels.data(), width, height, width }, layer);
+
+			entries.push_back(std::move(entry));
+			return entries.back();
+		}
+
+		// Drops frames rendered from another image
+		void Bind(const Render::ImageView& source, uint64_t id)
+		{
+			if (id == sourceId and source.width == width and source.height == height) { return; }
+			entries.clear();
+			sourceId = id;
+			width = source.width;
+			height = source.height;
+		}
+
+	public:
+		// Rendered source for a sample (the source itself when neutral). `id`
+		// names one loaded image, e.g. its FrameSwapper generation; a reloaded
+		// image must get a new id even if it reuses the old one's memory.
+		Render::ImageView Get(const Render::ImageView& source, uint64_t id,
+			const Sample& sample, uint32_t tintColor)
+		{
+			if (sample.IsNeutral()) { return source; }
+
+			Bind(source, id);
+			for (const Entry& entry : entries) {
+				if (entry.Matches(sample, tintColor)) {
+					++hits;
+					return { entry.pixels.data(), width, height, width };
+				}
+			}
+
+			++misses;
+			const Entry& entry = RenderFrame(source, sample, tintColor);
+			return { entry.pixels.data(), width, height, width };
+		}
+
+		// Renders every distinct frame of an effect ahead of playback
+		void Prerender(const Effect& effect, const Render::ImageView& source, uint64_t id)
+		{
+			Bind(source, id);
+
+			const uint32_t frameMs = std::max<uint32_t>(effect.frameMs, 1);
+			for (uint32_t timeMs{}; timeMs < effect.durationMs; timeMs += frameMs) {
+				const Sample sample = SampleEffect(effect, timeMs);
+				if (sample.IsNeutral()) { continue; }
+
+				const bool isCached = std::any_of(entries.begin(), entries.end(),
+					[&](const Entry& entry) { return entry.Matches(sample, effect.tintColor); });
+				if (!isCached) { RenderFrame(source, sample, effect.tintColor); }
+			}
+		}
+
+		void Clear()
+		{
+			entries.clear();
+			sourceId = 0;
+			width = height = 0;
+		}
+
+		bool IsBound(uint64_t id) const { return id == sourceId and !entries.empty(); }
+		size_t GetFrameCount() const { return entries.size(); }
+		uint64_t GetHits() const { return hits; }
+		uint64_t GetMisses() const { return misses; }
+	};
+
+
+
+	// --- Built-in effects ---
+
+	// Yellow tint toggled every 400 ms for 3 s (snap rejected, side switched)
+	inline constexpr Keyframe BlinkTintKeys[] = {
+		{ 0, 0.9f }, { 400, 0.0f }, { 800, 0.0f }
+	};
+	inline constexpr Track BlinkTracks[] = {
+		{ Channel::Tint, Interpolation::Step, true, BlinkTintKeys, 3 }
+	};
+	inline constexpr Effect Blink{ BlinkTracks, 1, 3000, 400, 0xffff00 };
+}
+
+
+
+
+/*
+Usage example:
+
+	// Fade out over 300 ms in 30 ms frames
+	static constexpr Effects::Keyframe fadeKeys[] = { { 0, 1.0f }, { 300, 0.0f } };
+	static constexpr Effects::Track fadeTracks[] = {
+		{ Effects::Channel::Alpha, Effects::Interpolation::Linear, false, fadeKeys, 2 }
+	};
+	static constexpr Effects::Effect fade{ fadeTracks, 1, 300, 30, 0 };
+
+	Effects::Player player{};
+	Effects::FrameCache cache{};
+
+	player.Start(fade, nowMs);
+	cache.Prerender(fade, image, imageGeneration);
+
+	if (player.Advance(nowMs)) {
+		Render::ImageView frame = cache.Get(image, imageGeneration, player.GetSample(), fade.tintColor);
+	}
+	SetTimer(..., player.GetDelayMs(nowMs));
+
+*/
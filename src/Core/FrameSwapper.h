@@ -0,0 +1,86 @@
+#pragma once
+
+// Standard library headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+
+
+// Double-buffered holder for a fully prepared frame set.
+// The producer builds the next set off-screen and publishes it in one atomic
+// pointer swap; readers keep their snapshot alive until the frame is drawn.
+// Every publish gets a new generation, swapped together with the set, so a
+// cache keyed on it never mistakes a reloaded set for the one it replaced
+// (the allocator may hand the new set the old set's address).
+template <typename FrameTy>
+class FrameSwapper
+{
+private:
+	struct Slot
+	{
+		uint64_t generation{};
+		std::shared_ptr<FrameTy> spFrames{};
+	};
+
+	std::shared_ptr<const Slot> spFront{};   // Frame set visible to the draw path
+	std::atomic<uint64_t> lastGeneration{};  // Generation of the latest publish
+
+public:
+	~FrameSwapper() = default;
+	FrameSwapper() = default;
+	FrameSwapper(const FrameSwapper&) = delete;
+	FrameSwapper& operator=(const FrameSwapper&) = delete;
+
+	// Returns the current frame set (stays valid while the caller holds it)
+	// and optionally the generation it was published with (0 when empty)
+	std::shared_ptr<FrameTy> Acquire(uint64_t* pGeneration = nullptr) const
+	{
+		const std::shared_ptr<const Slot> spSlot = std::atomic_load_explicit(&spFront, std::memory_order_acquire);
+		if (pGeneration) { *pGeneration = spSlot ? spSlot->generation : 0; }
+		return spSlot ? spSlot->spFrames : nullptr;
+	}
+
+	// Makes a completely built frame set visible, releasing the previous one
+	// once its last reader is done
+	void Publish(std::shared_ptr<FrameTy> spFrames)
+	{
+		std::shared_ptr<const Slot> spSlot{};
+		if (spFrames) {
+			const uint64_t generation = lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+			spSlot = std::make_shared<const Slot>(Slot{ generation, std::move(spFrames) });
+		}
+		std::atomic_store_explicit(&spFront, std::move(spSlot), std::memory_order_release);
+	}
+
+	// Drops the current frame set
+	void Reset()
+	{
+		Publish(nullptr);
+	}
+
+	// Checks if no frame set has been published yet
+	bool IsEmpty() const
+	{
+		return !Acquire();
+	}
+
+};
+
+
+
+
+/*
+Usage example:
+
+	static FrameSwapper<Frames> frames{};
+
+	// Worker thread
+	frames.Publish(std::make_shared<Frames>(BuildFrames()));
+
+	// Draw path
+	uint64_t generation{};
+	auto spFrames = frames.Acquire(&generation);
+	if (spFrames) { Draw(*spFrames, generation); }
+
+*/
@@ -0,0 +1,154 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+
+
+
+// Decides whether a fullscreen app or a presentation owns the screen.
+// TabTap fills the inputs from SHQueryUserNotificationState and a z-ordered
+// list of top-level windows; the rules only see this abstract form, so they
+// run unchanged outside Windows.
+namespace Fullscreen
+{
+	// Shell notification state (same values as QUERY_USER_NOTIFICATION_STATE)
+	enum class NotificationState : uint8_t
+	{
+		Unknown = 0,
+		NotPresent = 1,            // Screen saver, lock screen or fast user switching
+		Busy = 2,                  // Fullscreen app running or presentation settings applied
+		RunningD3DFullScreen = 3,  // Exclusive fullscreen Direct3D app
+		PresentationMode = 4,      // Presentation mode switched on
+		AcceptsNotifications = 5,  // Normal desktop
+		QuietTime = 6,             // First hour after setup
+		App = 7                    // Windows Store app in the foreground
+	};
+
+	// How a window takes part in the coverage test
+	enum class WindowKind : uint8_t
+	{
+		Normal,      // Application window
+		Own,         // TabTap tab or the OSK (skipped)
+		Shell        // Desktop, taskbar and other shell surfaces (never fullscreen)
+	};
+
+	// One top-level window, listed topmost first
+	struct Window
+	{
+		Geometry::Rect bounds{};
+		WindowKind kind{};
+		bool isVisible{};
+		bool isCloaked{};          // Hidden by DWM (other virtual desktop, suspended app)
+		bool isBordered{};         // Has a caption or sizing frame
+		bool isForeground{};
+	};
+
+	enum class Reason : uint8_t
+	{
+		None,
+		Exclusive,                 // RunningD3DFullScreen
+		Presentation,              // PresentationMode
+		Busy,                      // Shell reports a fullscreen app
+		Covering                   // Foreground window covers its monitor
+	};
+
+	inline const char* GetReasonName(Reason reason)
+	{
+		switch (reason)
+		{
+		case Reason::None:           return "none";
+		case Reason::Exclusive:      return "exclusive";
+		case Reason::Presentation:   return "presentation";
+		case Reason::Busy:           return "busy";
+		case Reason::Covering:       return "covering";
+		default:                     return "?";
+		}
+	}
+
+	// Monitor containing the centre of a rectangle, or nullptr
+	inline const Geometry::Rect* FindMonitor(const Geometry::Rect& bounds,
+		const Geometry::Rect* pMonitors, size_t monitorCount)
+	{
+		const Geometry::Point centre{
+			bounds.left + bounds.Width() / 2,
+			bounds.top + bounds.Height() / 2
+		};
+		for (size_t i{}; i < monitorCount; ++i) {
+			if (pMonitors[i].Contains(centre)) { return &pMonitors[i]; }
+		}
+		return nullptr;
+	}
+
+	// Checks if a borderless window spans a whole monitor
+	inline bool CoversMonitor(const Window& window, const Geometry::Rect* pMonitors, size_t monitorCount)
+	{
+		// Maximized windows overhang the monitor by their frame, so bordered ones never count
+		if (window.isBordered) { return false; }
+
+		const Geometry::Rect* pMonitor = FindMonitor(window.bounds, pMonitors, monitorCount);
+		return pMonitor and
+			window.bounds.left <= pMonitor->left and window.bounds.top <= pMonitor->top and
+			window.bounds.right >= pMonitor->right and window.bounds.bottom >= pMonitor->bottom;
+	}
+
+	// Front application window: the foreground window, or the first visible
+	// window below it when TabTap or the OSK holds the foreground
+	inline const Window* FindFrontWindow(const Window* pWindows, size_t windowCount)
+	{
+		bool isPastForeground{};
+		for (size_t i{}; i < windowCount; ++i) {
+			const Window& window = pWindows[i];
+			if (window.isForeground) {
+				if (window.kind != WindowKind::Own) { return &window; }
+				isPastForeground = true;
+				continue;
+			}
+			if (isPastForeground and window.isVisible and !window.isCloaked and window.kind != WindowKind::Own) {
+				return &window;
+			}
+		}
+		return nullptr;
+	}
+
+	// Why the tab should give way, or Reason::None
+	inline Reason Detect(NotificationState state,
+		const Window* pWindows, size_t windowCount,
+		const Geometry::Rect* pMonitors, size_t monitorCount)
+	{
+		switch (state)
+		{
+		case NotificationState::RunningD3DFullScreen:   return Reason::Exclusive;
+		case NotificationState::PresentationMode:       return Reason::Presentation;
+		case NotificationState::Busy:                   return Reason::Busy;
+		default: break;
+		}
+
+		const Window* pFront = FindFrontWindow(pWindows, windowCount);
+		if (pFront and pFront->kind == WindowKind::Normal and pFront->isVisible and !pFront->isCloaked and
+			CoversMonitor(*pFront, pMonitors, monitorCount))
+		{
+			return Reason::Covering;
+		}
+		return Reason::None;
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	const Fullscreen::Window windows[] = {
+		{ { 0, 0, 1920, 1080 }, Fullscreen::WindowKind::Normal, true, false, false, true },
+	};
+	const Geometry::Rect monitors[] = { { 0, 0, 1920, 1080 } };
+
+	Fullscreen::Reason reason = Fullscreen::Detect(Fullscreen::NotificationState::AcceptsNotifications,
+		windows, std::size(windows), monitors, std::size(monitors));  // Reason::Covering
+
+*/
@@ -0,0 +1,103 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+
+
+
+// Platform-neutral screen geometry (same layout as POINT/SIZE/RECT)
+namespace Geometry
+{
+	struct Point
+	{
+		long x{};
+		long y{};
+
+		bool operator==(const Point& other) const { return x == other.x and y == other.y; }
+		bool operator!=(const Point& other) const { return !(*this == other); }
+	};
+
+	struct Size
+	{
+		long cx{};
+		long cy{};
+
+		bool operator==(const Size& other) const { return cx == other.cx and cy == other.cy; }
+		bool operator!=(const Size& other) const { return !(*this == other); }
+	};
+
+	struct Rect
+	{
+		long left{};
+		long top{};
+		long right{};
+		long bottom{};
+
+		long Width() const { return right - left; }
+		long Height() const { return bottom - top; }
+		Size GetSize() const { return { Width(), Height() }; }
+		Point TopLeft() const { return { left, top }; }
+		bool IsEmpty() const { return right <= left or bottom <= top; }
+
+		bool Contains(const Point& pt) const
+		{
+			return pt.x >= left and pt.x < right and pt.y >= top and pt.y < bottom;
+		}
+
+		bool Intersects(const Rect& other) const
+		{
+			return left < other.right and other.left < right and
+				top < other.bottom and other.top < bottom;
+		}
+
+		bool operator==(const Rect& other) const
+		{
+			return left == other.left and top == other.top and
+				right == other.right and bottom == other.bottom;
+		}
+		bool operator!=(const Rect& other) const { return !(*this == other); }
+	};
+
+	// Builds a rectangle from its top-left corner and size
+	inline Rect MakeRect(const Point& pt, const Size& size)
+	{
+		return { pt.x, pt.y, pt.x + size.cx, pt.y + size.cy };
+	}
+
+	// Returns the intersection (empty if the rectangles do not overlap)
+	inline Rect Intersect(const Rect& a, const Rect& b)
+	{
+		Rect result{
+			std::max(a.left, b.left), std::max(a.top, b.top),
+			std::min(a.right, b.right), std::min(a.bottom, b.bottom)
+		};
+		return result.IsEmpty() ? Rect{} : result;
+	}
+
+	// Clamps a coordinate so a span of the given length stays inside [low, high);
+	// an oversized span is pinned to the low edge
+	inline long ClampSpan(long value, long length, long low, long high)
+	{
+		return std::max(low, std::min(value, high - length));
+	}
+
+	// Clamps a top-left point so a rectangle of the given size stays inside the bounds
+	inline Point ClampToBounds(const Point& pt, const Size& size, const Rect& bounds)
+	{
+		return {
+			ClampSpan(pt.x, size.cx, bounds.left, bounds.right),
+			ClampSpan(pt.y, size.cy, bounds.top, bounds.bottom)
+		};
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	const Geometry::Rect workArea{ 0, 0, 1920, 1040 };
+	Geometry::Point pt = Geometry::ClampToBounds({ -10, 1000 }, { 28, 95 }, workArea);
+
+*/
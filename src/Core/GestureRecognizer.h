@@ -0,0 +1,229 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+
+
+// Turns one touch or pen contact into tab gestures: tap, vertical drag, long
+// press and horizontal flick. TabTap feeds it WM_POINTER positions and times;
+// the rules only see screen pixels and millisecond stamps, so recorded
+// traces replay unchanged outside Windows. Times are 32-bit tick counts and
+// are compared by difference, so the wrap after 49.7 days is harmless.
+namespace Gestures
+{
+	enum class PointerPhase : uint8_t
+	{
+		Down,
+		Update,
+		Up,
+		Cancel       // Contact lost (capture changed, palm rejection)
+	};
+
+	struct PointerEvent
+	{
+		PointerPhase phase{};
+		uint32_t pointerId{};
+		Geometry::Point pt{};        // Screen pixels
+		uint32_t timeMs{};
+	};
+
+	enum class ActionKind : uint8_t
+	{
+		None,
+		Tap,         // Short touch without movement
+		DragStart,   // Vertical movement beyond the slop
+		DragMove,    // `offset` from the touch-down point
+		DragEnd,
+		LongPress,   // Held still for `longPressMs`
+		Flick        // Fast horizontal release; `offset.x` gives the direction
+	};
+
+	struct Action
+	{
+		ActionKind kind{};
+		Geometry::Point pt{};        // Contact position
+		Geometry::Point offset{};    // Movement since touch-down
+		uint32_t timeMs{};           // When the action was recognized
+	};
+
+	inline const char* GetActionName(ActionKind kind)
+	{
+		switch (kind)
+		{
+		case ActionKind::None:        return "none";
+		case ActionKind::Tap:         return "tap";
+		case ActionKind::DragStart:   return "drag start";
+		case ActionKind::DragMove:    return "drag move";
+		case ActionKind::DragEnd:     return "drag end";
+		case ActionKind::LongPress:   return "long press";
+		case ActionKind::Flick:       return "flick";
+		default:                      return "?";
+		}
+	}
+
+	class Recognizer
+	{
+	public:
+		struct Config
+		{
+			long slopPx{ 8 };                // Movement that still counts as a tap
+			uint32_t longPressMs{ 500 };     // Hold time that opens the menu
+			long flickMinPx{ 12 };           // Horizontal distance of a flick (the tab is 28 px wide)
+			uint32_t flickMaxMs{ 300 };      // Longest contact that can be a flick
+		};
+
+	private:
+		enum class State : uint8_t
+		{
+			Idle,
+			Pressed,     // Down, not yet moved beyond the slop
+			Dragging,    // Vertical movement
+			Swiping,     // Horizontal movement (flick candidate)
+			Consumed     // Long press fired; wait for the contact to end
+		};
+
+		Config config{};
+		State state{};
+		uint32_t pointerId{};
+		Geometry::Point downPt{};
+		uint32_t downMs{};
+
+	private:
+		static uint32_t Elapsed(uint32_t from, uint32_t to)
+		{
+			return to - from;
+		}
+
+		Action Make(ActionKind kind, const Geometry::Point& pt, uint32_t timeMs) const
+		{
+			return { kind, pt, { pt.x - downPt.x, pt.y - downPt.y }, timeMs };
+		}
+
+		Action OnUp(const PointerEvent& event)
+		{
+			const State last = state;
+			state = State::Idle;
+
+			switch (last)
+			{
+			case State::Pressed:
+				if (Elapsed(downMs, event.timeMs) < config.longPressMs) {
+					return Make(ActionKind::Tap, event.pt, event.timeMs);
+				}
+				return Make(ActionKind::LongPress, event.pt, event.timeMs);  // Timer never came
+
+			case State::Dragging:
+				return Make(ActionKind::DragEnd, event.pt, event.timeMs);
+
+			case State::Swiping:
+			{
+				const long dx = event.pt.x - downPt.x;
+				if (std::labs(dx) >= config.flickMinPx and Elapsed(downMs, event.timeMs) <= config.flickMaxMs) {
+					return Make(ActionKind::Flick, event.pt, event.timeMs);
+				}
+				return {};
+			}
+
+			default:
+				return {};
+			}
+		}
+
+	public:
+		Recognizer() = default;
+		explicit Recognizer(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		/// Feeds one pointer message; returns what it means for the tab
+		Action OnPointer(const PointerEvent& event)
+		{
+			// Only the first contact counts; later fingers are ignored
+			if (event.phase == PointerPhase::Down) {
+				if (state != State::Idle) { return {}; }
+
+				state = State::Pressed;
+				pointerId = event.pointerId;
+				downPt = event.pt;
+				downMs = event.timeMs;
+				return {};
+			}
+			if (state == State::Idle or event.pointerId != pointerId) { return {}; }
+
+			if (event.phase == PointerPhase::Cancel) {
+				const bool wasDragging = state == State::Dragging;
+				state = State::Idle;
+				return wasDragging ? Make(ActionKind::DragEnd, event.pt, event.timeMs) : Action{};
+			}
+			if (event.phase == PointerPhase::Up) { return OnUp(event); }
+
+			// --- Update ---
+			const long dx = event.pt.x - downPt.x;
+			const long dy = event.pt.y - downPt.y;
+
+			if (state == State::Pressed and (std::labs(dx) > config.slopPx or std::labs(dy) > config.slopPx)) {
+				if (std::labs(dy) >= std::labs(dx)) {
+					state = State::Dragging;
+					return Make(ActionKind::DragStart, event.pt, event.timeMs);
+				}
+				state = State::Swiping;
+				return {};
+			}
+			if (state == State::Dragging) {
+				return Make(ActionKind::DragMove, event.pt, event.timeMs);
+			}
+			return {};
+		}
+
+		/// Checks for a long press; call GetLongPressDelay() after touch-down
+		Action OnTimer(uint32_t nowMs)
+		{
+			if (state != State::Pressed or Elapsed(downMs, nowMs) < config.longPressMs) { return {}; }
+
+			state = State::Consumed;
+			return Make(ActionKind::LongPress, downPt, nowMs);
+		}
+
+		/// Drops the contact (window hidden, drag taken over elsewhere)
+		void Reset()
+		{
+			state = State::Idle;
+		}
+
+		/// Checks if a contact is being tracked
+		bool IsActive() const { return state != State::Idle; }
+		/// Checks if the contact is dragging the tab
+		bool IsDragging() const { return state == State::Dragging; }
+		/// Milliseconds after touch-down when OnTimer should run
+		uint32_t GetLongPressDelay() const { return config.longPressMs; }
+		const Config& GetConfig() const { return config; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	static Gestures::Recognizer gestures{};
+
+	case WM_POINTERDOWN / WM_POINTERUPDATE / WM_POINTERUP:
+	{
+		const Gestures::Action action = gestures.OnPointer({ phase, id, pt, info.dwTime });
+		if (action.kind == Gestures::ActionKind::Tap) { ToggleKeyboard(); }
+		if (phase == Gestures::PointerPhase::Down) { SetTimer(..., gestures.GetLongPressDelay()); }
+	}
+
+	case WM_TIMER:
+	{
+		if (gestures.OnTimer(GetTickCount()).kind == Gestures::ActionKind::LongPress) { ShowMenu(); }
+	}
+
+*/
@@ -0,0 +1,232 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+#include "RenderBackend.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+
+
+// Short overlay text (keyboard layout codes such as "EN") without a text
+// engine on the draw path. A platform rasteriser renders every character
+// once per DPI into an 8-bit coverage atlas; a label is laid out from the
+// atlas once per text change into its own mask, and each redraw blends
+// that one small mask over the composed frame.
+namespace Glyphs
+{
+	constexpr char FirstChar = ' ';
+	constexpr char LastChar = '_';               // Space, punctuation, digits and upper case
+	constexpr size_t CharCount = size_t(LastChar - FirstChar) + 1;
+	constexpr size_t MaxLabelChars = 3;
+
+	// One character as the rasteriser draws it (`width` columns of the cell height)
+	struct Bitmap
+	{
+		std::vector<uint8_t> coverage{};
+		long width{};
+		long advance{};                          // Pen step to the next character
+	};
+
+	struct Glyph
+	{
+		long x{};                                // First column in the atlas
+		long width{};
+		long advance{};
+	};
+
+	// All characters of one DPI side by side in a single row
+	class Atlas
+	{
+	private:
+		std::vector<uint8_t> pixels{};
+		long width{};
+		long height{};
+		uint32_t dpi{};
+		uint32_t generation{};                   // Changes with every build
+		Glyph glyphs[CharCount]{};
+
+	public:
+		/// Rasterises every character; `rasterize(char, cellHeight, Bitmap*)` returns false on failure
+		template <typename Rasterize>
+		bool Build(uint32_t atDpi, long cellHeight, Rasterize rasterize)
+		{
+			Clear();
+			if (cellHeight <= 0) { return false; }
+
+			std::vector<Bitmap> bitmaps(CharCount);
+			long totalWidth{};
+			for (size_t i{}; i < CharCount; ++i) {
+				Bitmap& bitmap = bitmaps[i];
+				if (!rasterize(char(FirstChar + i), cellHeight, &bitmap)) { return false; }
+				if (bitmap.width < 0 or bitmap.coverage.size() < size_t(bitmap.width) * size_t(cellHeight)) {
+					return false;
+				}
+				totalWidth += bitmap.width;
+			}
+
+			std::vector<uint8_t> packed(size_t(totalWidth) * size_t(cellHeight));
+			long x{};
+			for (size_t i{}; i < CharCount; ++i) {
+				const Bitmap& bitmap = bitmaps[i];
+				for (long y{}; y < cellHeight; ++y) {
+					std::copy_n(bitmap.coverage.data() + size_t(y) * size_t(bitmap.width), bitmap.width,
+						packed.data() + size_t(y) * size_t(totalWidth) + size_t(x));
+				}
+				glyphs[i] = { x, bitmap.width, bitmap.advance };
+				x += bitmap.width;
+			}
+
+			pixels = std::move(packed);
+			width = totalWidth;
+			height = cellHeight;
+			dpi = atDpi;
+			return true;
+		}
+
+		void Clear()
+		{
+			const uint32_t next = generation + 1;
+			*this = {};
+			generation = next;
+		}
+
+		/// Returns the glyph of a character, or nullptr outside the character set
+		const Glyph* Find(char ch) const
+		{
+			if (ch < FirstChar or ch > LastChar or !height) { return nullptr; }
+			return &glyphs[size_t(ch - FirstChar)];
+		}
+
+		/// Returns a glyph's coverage inside the atlas
+		Render::MaskView GetMask(const Glyph& glyph) const
+		{
+			return { pixels.data() + glyph.x, glyph.width, height, width };
+		}
+
+		bool IsBuilt() const { return height != 0; }
+		long GetHeight() const { return height; }
+		uint32_t GetDpi() const { return dpi; }
+		uint32_t GetGeneration() const { return generation; }
+	};
+
+
+
+	// A text laid out from an atlas into its own mask
+	class Label
+	{
+	private:
+		std::vector<uint8_t> pixels{};
+		long width{};
+		long height{};
+		char text[MaxLabelChars + 1]{};
+		uint32_t generation{};                   // Atlas build the mask came from
+
+	public:
+		/// Lays out up to MaxLabelChars of `pszText` (characters outside the set
+		/// are skipped); returns false if text and atlas are unchanged
+		bool Update(const Atlas& atlas, const char* pszText)
+		{
+			if (generation == atlas.GetGeneration() and std::strncmp(text, pszText, MaxLabelChars) == 0) {
+				return false;
+			}
+
+			std::memset(text, 0, sizeof(text));
+			std::strncpy(text, pszText, MaxLabelChars);
+			generation = atlas.GetGeneration();
+			pixels.clear();
+			width = 0;
+			height = atlas.GetHeight();
+
+			// The mask ends at the rightmost glyph edge (no trailing spacing or
+			// spaces, so it centres)
+			long pen{};
+			for (const char* p = text; *p; ++p) {
+				if (const Glyph* pGlyph = atlas.Find(*p)) {
+					if (pGlyph->width) { width = std::max(width, pen + pGlyph->width); }
+					pen += pGlyph->advance;
+				}
+			}
+			if (!width or !height) { return true; }
+
+			pixels.assign(size_t(width) * size_t(height), 0);
+			pen = 0;
+			for (const char* p = text; *p; ++p) {
+				const Glyph* pGlyph = atlas.Find(*p);
+				if (!pGlyph) { continue; }
+
+				// Neighbouring glyphs may overlap by a column; keep the stronger coverage
+				const Render::MaskView glyph = atlas.GetMask(*pGlyph);
+				for (long y{}; y < height; ++y) {
+					const uint8_t* pSrc = glyph.Row(y);
+					uint8_t* pDst = pixels.data() + size_t(y) * size_t(width) + size_t(pen);
+					for (long x{}; x < glyph.width; ++x) {
+						pDst[x] = std::max(pDst[x], pSrc[x]);
+					}
+				}
+				pen += pGlyph->advance;
+			}
+			return true;
+		}
+
+		Render::MaskView GetMask() const { return { pixels.data(), width, height, width }; }
+		Geometry::Size GetSize() const { return { width, height }; }
+		const char* GetText() const { return text; }
+		bool IsEmpty() const { return pixels.empty(); }
+	};
+
+
+
+	/// Centres a label in a frame; false if it does not fit with `margin` on each side
+	inline bool PlaceLabel(const Geometry::Size& frame, const Geometry::Size& label, long margin,
+		Geometry::Point* pAt)
+	{
+		if (label.cx + 2 * margin > frame.cx or label.cy + 2 * margin > frame.cy) { return false; }
+
+		*pAt = { (frame.cx - label.cx) / 2, (frame.cy - label.cy) / 2 };
+		return true;
+	}
+
+	/// Turns a language name ("en", "de-CH", "fil") into a tab code ("EN", "DE",
+	/// "FIL"): the letters before the first separator, upper case
+	inline void FormatLayoutCode(const char* pszName, char (&code)[MaxLabelChars + 1])
+	{
+		std::memset(code, 0, sizeof(code));
+		for (size_t i{}; i < MaxLabelChars and pszName[i]; ++i) {
+			const char ch = pszName[i];
+			if (ch >= 'a' and ch <= 'z') { code[i] = char(ch - 'a' + 'A'); }
+			else if (ch >= 'A' and ch <= 'Z') { code[i] = ch; }
+			else { break; }
+		}
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	Glyphs::Atlas atlas{};
+	atlas.Build(dpi, 14, [](char ch, long cellHeight, Glyphs::Bitmap* pBitmap) {
+		return RasterizeWithPlatformFont(ch, cellHeight, pBitmap);
+		});
+
+	char code[Glyphs::MaxLabelChars + 1]{};
+	Glyphs::FormatLayoutCode("de-CH", code);    // "DE"
+
+	Glyphs::Label label{};
+	label.Update(atlas, code);                  // Once per layout change
+
+	Geometry::Point at{};
+	if (Glyphs::PlaceLabel(frameSize, label.GetSize(), 2, &at)) {
+		backend.BlendMask(label.GetMask(), at, Render::MakeOpaque(255, 255, 255));
+	}
+
+*/
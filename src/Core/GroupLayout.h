@@ -0,0 +1,109 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstdint>
+
+
+
+// Layout of the tab and the OSK when they move as one group
+namespace GroupLayout
+{
+	// Target positions for one input frame
+	struct Placement
+	{
+		Geometry::Point tab{};    // New tab top-left
+		Geometry::Point osk{};    // New OSK top-left
+		bool moveTab{};           // Tab position changed
+		bool moveOsk{};           // OSK position changed
+	};
+
+	// Top that centres a window of `height` on an anchor span
+	// (the vertical anchoring used by SyncOskPositionWithMain)
+	inline long CenteredTop(long anchorTop, long anchorHeight, long height)
+	{
+		return anchorTop - (height - anchorHeight) / 2;
+	}
+
+	// Solves a vertical linked drag: the tab follows the requested Y inside the
+	// work area and the OSK keeps its X while staying centred on the tab
+	inline Placement SolveLinkedDrag(
+		const Geometry::Point& requested,
+		const Geometry::Rect& tabRect,
+		const Geometry::Rect& oskRect,
+		const Geometry::Rect& workArea,
+		bool isOskVisible)
+	{
+		Placement placement{};
+
+		const long tabTop = Geometry::ClampSpan(
+			requested.y, tabRect.Height(), workArea.top, workArea.bottom);
+		placement.tab = { tabRect.left, tabTop };
+		placement.moveTab = (tabTop != tabRect.top);
+
+		placement.osk = oskRect.TopLeft();
+		if (isOskVisible and !oskRect.IsEmpty()) {
+			const long oskTop = Geometry::ClampSpan(
+				CenteredTop(tabTop, tabRect.Height(), oskRect.Height()),
+				oskRect.Height(), workArea.top, workArea.bottom);
+			placement.osk.y = oskTop;
+			placement.moveOsk = (oskTop != oskRect.top);
+		}
+
+		return placement;
+	}
+
+
+
+	// Counts window moves issued per input frame
+	class MoveCounter
+	{
+	private:
+		uint64_t frameCount{};       // Frames that issued at least one move
+		uint64_t moveCount{};        // Total window moves
+		uint32_t maxMovesPerFrame{}; // Largest batch
+
+	public:
+		// Records one batched update containing `moves` windows
+		void RecordFrame(uint32_t moves)
+		{
+			if (!moves) { return; }
+			++frameCount;
+			moveCount += moves;
+			maxMovesPerFrame = std::max(maxMovesPerFrame, moves);
+		}
+
+		// Clears the statistics
+		void Reset()
+		{
+			*this = {};
+		}
+
+		uint64_t GetFrameCount() const { return frameCount; }
+		uint64_t GetMoveCount() const { return moveCount; }
+		uint32_t GetMaxMovesPerFrame() const { return maxMovesPerFrame; }
+
+		// Average windows moved per frame
+		double GetMovesPerFrame() const
+		{
+			return frameCount ? double(moveCount) / double(frameCount) : 0.0;
+		}
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag(
+		cursorPoint, tabRect, oskRect, workArea, isOskVisible);
+
+	// Issue placement.tab / placement.osk in one batched window update
+	moveCounter.RecordFrame(placement.moveTab + placement.moveOsk);
+
+*/
@@ -0,0 +1,530 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+#include "GlyphAtlas.h"
+#include "RenderBackend.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+
+// Built-in keyboard: layout table, key geometry, hit-testing, modifier
+// latching and cached key frames, all without a window. A layout is a text
+// table, one line per row and one cell per key:
+//
+//   VK[*WIDTH][FLAGS][=LABEL]
+//
+// VK is the virtual-key code in hex (00 leaves a gap), WIDTH is in keys
+// (quarter steps, default 1), FLAGS are `m` (modifier, latches until the
+// next key), `l` (lock key) and `e` (extended key), and LABEL replaces the
+// character the system layout gives the key. `#` starts a comment line.
+namespace KeyLayout
+{
+	constexpr size_t MaxKeys = 128;
+	constexpr size_t MaxRows = 8;
+	constexpr size_t MaxLabelChars = 6;
+	constexpr uint16_t UnitsPerKey = 4;          // Widths are stored in quarter keys
+	constexpr uint16_t MaxRowUnits = 32 * UnitsPerKey;
+
+	// Key flags (combinable)
+	enum KeyFlags : uint8_t
+	{
+		KeyNone     = 0x00,
+		KeyModifier = 0x01,  // Latches for the next key instead of typing
+		KeyLock     = 0x02,  // Caps or Num Lock; the system keeps its state
+		KeyExtended = 0x04   // Sent with KEYEVENTF_EXTENDEDKEY
+	};
+
+	// Latched modifiers (combinable); a frame is cached per combination
+	enum ModifierFlags : uint8_t
+	{
+		ModifierNone  = 0x00,
+		ModifierShift = 0x01,
+		ModifierCtrl  = 0x02,
+		ModifierAlt   = 0x04,
+		ModifierWin   = 0x08
+	};
+
+	constexpr size_t ModifierCount = 4;
+	constexpr size_t ModifierStates = size_t(1) << ModifierCount;
+	constexpr size_t MaxEvents = 2 * ModifierCount + 2;  // Latched modifiers around one key
+
+	struct Key
+	{
+		char label[MaxLabelChars + 1]{};         // Fixed label; empty to ask the system layout
+		uint16_t left{};                         // Quarter keys from the row start
+		uint16_t width{ UnitsPerKey };
+		uint8_t vk{};
+		uint8_t flags{};                         // KeyFlags
+		uint8_t row{};
+	};
+
+	struct Layout
+	{
+		Key keys[MaxKeys]{};
+		uint16_t rowFirst[MaxRows + 1]{};        // First key of each row; rowFirst[rowCount] is keyCount
+		size_t keyCount{};
+		size_t rowCount{};
+		uint16_t rowUnits{};                     // Widest row in quarter keys
+	};
+
+	// Parse outcome
+	enum class Status
+	{
+		Ok,
+		Empty,
+		BadKey,                                  // Cell is not VK[*WIDTH][FLAGS][=LABEL]
+		BadWidth,                                // Not a positive quarter step, or the row is too wide
+		LabelTooLong,
+		TooManyKeys,
+		TooManyRows
+	};
+
+	inline const char* GetStatusName(Status status)
+	{
+		switch (status)
+		{
+		case Status::Ok:              return "ok";
+		case Status::Empty:           return "empty";
+		case Status::BadKey:          return "bad key";
+		case Status::BadWidth:        return "bad width";
+		case Status::LabelTooLong:    return "label too long";
+		case Status::TooManyKeys:     return "too many keys";
+		case Status::TooManyRows:     return "too many rows";
+		default:                      return "?";
+		}
+	}
+
+	// US layout in five rows (15 keys wide); character keys are labelled by the system layout
+	constexpr const char* DefaultTable =
+		"C0 31 32 33 34 35 36 37 38 39 30 BD BB 08*2=BKSP\n"
+		"09*1.5=TAB 51 57 45 52 54 59 55 49 4F 50 DB DD DC*1.5\n"
+		"14*1.75l=CAPS 41 53 44 46 47 48 4A 4B 4C BA DE 0D*2.25=ENTER\n"
+		"A0*2.25m=SHIFT 5A 58 43 56 42 4E 4D BC BE BF 26e=^ A1*1.75m=SHIFT\n"
+		"A2*1.5m=CTRL 5B*1.25me=WIN A4*1.25m=ALT 20*6.75 A5*1.25me=ALT 25e=< 28e=V 27e=>\n";
+
+	namespace Detail
+	{
+		inline bool IsSpace(char ch) { return ch == ' ' or ch == '\t' or ch == '\r'; }
+
+		inline int HexDigit(char ch)
+		{
+			if (ch >= '0' and ch <= '9') { return ch - '0'; }
+			if (ch >= 'A' and ch <= 'F') { return ch - 'A' + 10; }
+			if (ch >= 'a' and ch <= 'f') { return ch - 'a' + 10; }
+			return -1;
+		}
+
+		// Parses "1", "1.5" or "2.25" keys into quarter keys
+		inline Status ParseWidth(const char*& p, uint16_t* pUnits)
+		{
+			uint32_t whole{};
+			size_t digits{};
+			for (; *p >= '0' and *p <= '9' and digits < 3; ++p, ++digits) { whole = whole * 10 + uint32_t(*p - '0'); }
+			if (!digits) { return Status::BadWidth; }
+
+			uint32_t hundredths{};
+			if (*p == '.') {
+				++p;
+				uint32_t scale{ 10 };
+				for (; *p >= '0' and *p <= '9' and scale; ++p, scale /= 10) { hundredths += uint32_t(*p - '0') * scale; }
+			}
+
+			const uint32_t total = whole * 100 + hundredths;
+			if (!total or total % 25 or total / 25 > MaxRowUnits) { return Status::BadWidth; }
+			*pUnits = uint16_t(total / 25);
+			return Status::Ok;
+		}
+
+		// Parses one cell up to the next blank; a gap cell only advances `left`
+		inline Status ParseCell(const char*& p, Key* pKey, bool* pIsGap)
+		{
+			int high = HexDigit(p[0]);
+			int low = HexDigit(p[1]);
+			if (high < 0 or low < 0) { return Status::BadKey; }
+			p += 2;
+			*pKey = {};
+			pKey->vk = uint8_t(high * 16 + low);
+			*pIsGap = pKey->vk == 0;
+
+			if (*p == '*') {
+				++p;
+				if (const Status status = ParseWidth(p, &pKey->width); status != Status::Ok) { return status; }
+			}
+
+			for (; *p == 'm' or *p == 'l' or *p == 'e'; ++p) {
+				pKey->flags |= *p == 'm' ? KeyModifier : *p == 'l' ? KeyLock : KeyExtended;
+			}
+
+			if (*p == '=') {
+				++p;
+				size_t length{};
+				for (; *p and *p != '\n' and !IsSpace(*p); ++p, ++length) {
+					if (length == MaxLabelChars) { return Status::LabelTooLong; }
+					pKey->label[length] = *p;
+				}
+				if (!length) { return Status::BadKey; }
+			}
+
+			return (*p and *p != '\n' and !IsSpace(*p)) ? Status::BadKey : Status::Ok;
+		}
+	}
+
+	/// Parses a layout table; `*pLayout` is only changed on success
+	inline Status Parse(const char* pszTable, Layout* pLayout)
+	{
+		Layout layout{};
+		const char* p = pszTable;
+
+		while (*p) {
+			while (Detail::IsSpace(*p)) { ++p; }
+			if (*p == '#') {
+				while (*p and *p != '\n') { ++p; }
+			}
+			if (*p == '\n') {
+				++p;
+				continue;
+			}
+			if (!*p) { break; }
+
+			// A row of cells
+			if (layout.rowCount == MaxRows) { return Status::TooManyRows; }
+			layout.rowFirst[layout.rowCount] = uint16_t(layout.keyCount);
+			uint32_t units{};
+
+			while (*p and *p != '\n') {
+				Key key{};
+				bool isGap{};
+				if (const Status status = Detail::ParseCell(p, &key, &isGap); status != Status::Ok) { return status; }
+
+				if (units + key.width > MaxRowUnits) { return Status::BadWidth; }
+				if (!isGap) {
+					if (layout.keyCount == MaxKeys) { return Status::TooManyKeys; }
+					key.left = uint16_t(units);
+					key.row = uint8_t(layout.rowCount);
+					layout.keys[layout.keyCount++] = key;
+				}
+				units += key.width;
+
+				while (Detail::IsSpace(*p)) { ++p; }
+			}
+
+			layout.rowUnits = std::max(layout.rowUnits, uint16_t(units));
+			++layout.rowCount;
+		}
+
+		if (!layout.keyCount) { return Status::Empty; }
+		layout.rowFirst[layout.rowCount] = uint16_t(layout.keyCount);
+		*pLayout = layout;
+		return Status::Ok;
+	}
+
+	/// Returns the latch a key sets, or ModifierNone if it types
+	inline uint8_t GetModifier(const Key& key)
+	{
+		if (!(key.flags & KeyModifier)) { return ModifierNone; }
+		switch (key.vk)
+		{
+		case 0x10: case 0xA0: case 0xA1:     return ModifierShift;   // VK_SHIFT, VK_LSHIFT, VK_RSHIFT
+		case 0x11: case 0xA2: case 0xA3:     return ModifierCtrl;    // VK_CONTROL, VK_LCONTROL, VK_RCONTROL
+		case 0x12: case 0xA4: case 0xA5:     return ModifierAlt;     // VK_MENU, VK_LMENU, VK_RMENU
+		case 0x5B: case 0x5C:                return ModifierWin;     // VK_LWIN, VK_RWIN
+		default:                             return ModifierNone;
+		}
+	}
+
+
+
+	// Key rectangles for a layout stretched over a pixel area. Every row is
+	// as high as the others and a quarter key is as wide everywhere, so a
+	// point finds its row by division and its key by binary search; the gap
+	// between keys belongs to the key on its left, blank cells to no key.
+	class Arrangement
+	{
+	private:
+		const Layout* pLayout{};
+		Geometry::Rect bounds{};
+		long gap{};                              // Pixels between drawn keys
+		long rowTop[MaxRows + 1]{};
+		long slotLeft[MaxKeys]{};
+		long slotRight[MaxKeys]{};
+
+	private:
+		long UnitX(uint32_t units) const
+		{
+			return bounds.left + long(int64_t(units) * bounds.Width() / pLayout->rowUnits);
+		}
+
+	public:
+		/// Lays the keys out over `area`, drawing them `keyGap` pixels apart
+		void Build(const Layout& layout, const Geometry::Rect& area, long keyGap)
+		{
+			pLayout = &layout;
+			bounds = area;
+			gap = keyGap;
+			if (!layout.rowCount or !layout.rowUnits) { return; }
+
+			for (size_t row{}; row <= layout.rowCount; ++row) {
+				rowTop[row] = bounds.top + long(int64_t(row) * bounds.Height() / int64_t(layout.rowCount));
+			}
+			for (size_t i{}; i < layout.keyCount; ++i) {
+				const Key& key = layout.keys[i];
+				slotLeft[i] = UnitX(key.left);
+				slotRight[i] = UnitX(uint32_t(key.left) + key.width);
+			}
+		}
+
+		/// Returns the key under a point, or -1
+		int HitTest(const Geometry::Point& pt) const
+		{
+			if (!pLayout or !pLayout->rowCount or !bounds.Contains(pt)) { return -1; }
+
+			// Integer division may land one row off at a boundary
+			size_t row = size_t(int64_t(pt.y - bounds.top) * int64_t(pLayout->rowCount) / bounds.Height());
+			while (row > 0 and pt.y < rowTop[row]) { --row; }
+			while (row + 1 < pLayout->rowCount and pt.y >= rowTop[row + 1]) { ++row; }
+
+			const long* pFirst = slotLeft + pLayout->rowFirst[row];
+			const long* pLast = slotLeft + pLayout->rowFirst[row + 1];
+			const long* pSlot = std::upper_bound(pFirst, pLast, pt.x);
+			if (pSlot == pFirst) { return -1; }
+
+			const size_t index = size_t(pSlot - slotLeft) - 1;
+			return pt.x < slotRight[index] ? int(index) : -1;
+		}
+
+		/// Returns the drawn rectangle of a key (its slot less the gap)
+		Geometry::Rect GetKeyRect(size_t index) const
+		{
+			const size_t row = pLayout->keys[index].row;
+			const long inset = gap / 2;
+			return {
+				slotLeft[index] + inset, rowTop[row] + inset,
+				slotRight[index] - (gap - inset), rowTop[row + 1] - (gap - inset)
+			};
+		}
+
+		/// Returns the area a key answers to
+		Geometry::Rect GetSlot(size_t index) const
+		{
+			const size_t row = pLayout->keys[index].row;
+			return { slotLeft[index], rowTop[row], slotRight[index], rowTop[row + 1] };
+		}
+
+		const Geometry::Rect& GetBounds() const { return bounds; }
+	};
+
+
+
+	// One key transition to inject
+	struct KeyEvent
+	{
+		uint8_t vk{};
+		bool isUp{};
+		bool isExtended{};
+	};
+
+	// Sticky modifiers: tapping Shift, Ctrl, Alt or Win latches it (tapping
+	// again releases it) and the next typing key is sent wrapped in the
+	// latched modifiers, all in one batch, after which the latches clear
+	class ModifierLatch
+	{
+	private:
+		struct Latched
+		{
+			uint8_t vk{};
+			bool isExtended{};
+		};
+
+		Latched latched[ModifierCount]{};        // By bit position of ModifierFlags
+		uint8_t mask{};
+
+	public:
+		/// Presses a key; fills `events` and returns their count (0 for a latch change)
+		size_t Press(const Key& key, KeyEvent (&events)[MaxEvents])
+		{
+			if (const uint8_t modifier = GetModifier(key)) {
+				mask ^= modifier;
+				for (size_t bit{}; bit < ModifierCount; ++bit) {
+					if (modifier == (1u << bit)) { latched[bit] = { key.vk, (key.flags & KeyExtended) != 0 }; }
+				}
+				return 0;
+			}
+
+			const bool isExtended = (key.flags & KeyExtended) != 0;
+			size_t count{};
+			for (size_t bit{}; bit < ModifierCount; ++bit) {
+				if (mask & (1u << bit)) { events[count++] = { latched[bit].vk, false, latched[bit].isExtended }; }
+			}
+			events[count++] = { key.vk, false, isExtended };
+			events[count++] = { key.vk, true, isExtended };
+			for (size_t bit{ ModifierCount }; bit-- > 0; ) {
+				if (mask & (1u << bit)) { events[count++] = { latched[bit].vk, true, latched[bit].isExtended }; }
+			}
+
+			// A lock key leaves the latches for the key after it
+			if (!(key.flags & KeyLock)) { mask = ModifierNone; }
+			return count;
+		}
+
+		void Clear() { mask = ModifierNone; }
+		uint8_t GetMask() const { return mask; }
+	};
+
+
+
+	struct Palette
+	{
+		Render::Pixel background{ Render::MakeOpaque(32, 32, 32) };
+		Render::Pixel key{ Render::MakeOpaque(64, 64, 64) };
+		Render::Pixel namedKey{ Render::MakeOpaque(48, 48, 48) };   // Keys with a fixed label
+		Render::Pixel latchedKey{ Render::MakeOpaque(0, 120, 215) };
+		Render::Pixel label{ Render::MakeOpaque(255, 255, 255) };
+	};
+
+	/// Draws a label centred in a key (upper case; characters outside the atlas are skipped)
+	inline void DrawLabel(const Render::SurfaceView& target, const Glyphs::Atlas& atlas, const char* pszLabel,
+		Render::Pixel color)
+	{
+		auto Upper = [](char ch) { return (ch >= 'a' and ch <= 'z') ? char(ch - 'a' + 'A') : ch; };
+
+		long width{}, pen{};
+		for (const char* p = pszLabel; *p; ++p) {
+			if (const Glyphs::Glyph* pGlyph = atlas.Find(Upper(*p))) {
+				width = std::max(width, pen + pGlyph->width);
+				pen += pGlyph->advance;
+			}
+		}
+
+		Geometry::Point at{};
+		if (!width or !Glyphs::PlaceLabel({ target.width, target.height }, { width, atlas.GetHeight() }, 0, &at)) {
+			return;
+		}
+		for (const char* p = pszLabel; *p; ++p) {
+			if (const Glyphs::Glyph* pGlyph = atlas.Find(Upper(*p))) {
+				Render::BlendMask(target, atlas.GetMask(*pGlyph), at, color);
+				at.x += pGlyph->advance;
+			}
+		}
+	}
+
+
+
+	// Whole-keyboard frames, painted once per latch state and kept until the
+	// size, the atlas or the labels change; a key press only blends the
+	// pressed key over the cached frame
+	class FrameCache
+	{
+	private:
+		std::vector<Render::Pixel> frames[ModifierStates]{};
+		std::vector<uint8_t> solid{};            // One row of full coverage (key masks)
+		Geometry::Size size{};
+		uint32_t atlasGeneration{};
+		uint64_t paintCount{};
+
+	private:
+		template <typename GetLabel>
+		void Paint(std::vector<Render::Pixel>& pixels, uint8_t latches, const Layout& layout,
+			const Arrangement& arrangement, const Glyphs::Atlas& atlas, const Palette& palette, GetLabel& getLabel)
+		{
+			pixels.assign(size_t(size.cx) * size_t(size.cy), 0);
+			const Render::SurfaceView frame{ pixels.data(), size.cx, size.cy, size.cx };
+
+			Render::Layer fill{};
+			fill.kind = Render::LayerKind::Rectangle;
+			fill.fillColor = palette.background;
+			Render::Compose(frame, fill);
+
+			const bool isShifted = (latches & ModifierShift) != 0;
+			for (size_t i{}; i < layout.keyCount; ++i) {
+				const Key& key = layout.keys[i];
+				const Geometry::Rect rect = Geometry::Intersect(arrangement.GetKeyRect(i), { 0, 0, size.cx, size.cy });
+				if (rect.IsEmpty()) { continue; }
+
+				const Render::SurfaceView keyView{ frame.Row(rect.top) + rect.left, rect.Width(), rect.Height(), frame.stride };
+				const uint8_t modifier = GetModifier(key);
+				fill.fillColor = (modifier & latches) ? palette.latchedKey : key.label[0] ? palette.namedKey : palette.key;
+				Render::Compose(keyView, fill);
+
+				char label[MaxLabelChars + 1]{};
+				if (key.label[0]) {
+					std::memcpy(label, key.label, sizeof(label));
+				}
+				else if (!getLabel(key, isShifted, label)) {
+					continue;
+				}
+				DrawLabel(keyView, atlas, label, palette.label);
+			}
+			++paintCount;
+		}
+
+	public:
+		/// Drops every frame (labels or palette changed)
+		void Invalidate()
+		{
+			for (std::vector<Render::Pixel>& frame : frames) { frame.clear(); }
+		}
+
+		/// Returns the frame of a latch state, painting it on first use;
+		/// `getLabel(key, isShifted, label)` names keys without a fixed label
+		template <typename GetLabel>
+		Render::ImageView Get(const Geometry::Size& surface, uint8_t latches, const Layout& layout,
+			const Arrangement& arrangement, const Glyphs::Atlas& atlas, const Palette& palette, GetLabel getLabel)
+		{
+			if (surface != size or atlas.GetGeneration() != atlasGeneration) {
+				Invalidate();
+				size = surface;
+				atlasGeneration = atlas.GetGeneration();
+				solid.assign(size_t(std::max(size.cx, 0L)), 0xff);
+			}
+			if (size.cx <= 0 or size.cy <= 0) { return {}; }
+
+			std::vector<Render::Pixel>& frame = frames[latches % ModifierStates];
+			if (frame.empty()) { Paint(frame, latches, layout, arrangement, atlas, palette, getLabel); }
+			return { frame.data(), size.cx, size.cy, size.cx };
+		}
+
+		/// Returns a full-coverage mask the size of a key (for the pressed highlight)
+		Render::MaskView GetKeyMask(const Geometry::Rect& rect) const
+		{
+			return { solid.data(), std::min(rect.Width(), long(solid.size())), rect.Height(), 0 };
+		}
+
+		bool IsCached(uint8_t latches) const { return !frames[latches % ModifierStates].empty(); }
+		uint64_t GetPaintCount() const { return paintCount; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	KeyLayout::Layout layout{};
+	KeyLayout::Parse(KeyLayout::DefaultTable, &layout);
+
+	KeyLayout::Arrangement arrangement{};
+	arrangement.Build(layout, { 0, 0, 720, 240 }, 2);
+
+	// Pointer down
+	const int index = arrangement.HitTest({ x, y });
+	if (index >= 0) {
+		KeyLayout::KeyEvent events[KeyLayout::MaxEvents]{};
+		const size_t count = latch.Press(layout.keys[index], events);
+		SendAsOneBatch(events, count);
+	}
+
+	// Draw
+	const Render::ImageView frame = frames.Get(size, latch.GetMask(), layout, arrangement, atlas, palette,
+		[](const KeyLayout::Key& key, bool isShifted, char (&label)[KeyLayout::MaxLabelChars + 1]) {
+			return LookUpCharacter(key.vk, isShifted, label);
+		});
+
+*/
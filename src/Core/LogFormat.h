@@ -0,0 +1,177 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+
+
+
+// Binary log file layout shared by AsyncLogger and the offline LogDecoder.
+// A file is a FileHeader followed by chunks. Message text is never formatted
+// at run time: each call site is written once as a Site chunk, and every
+// Record chunk carries only the site id, a timestamp and the raw arguments.
+namespace Logging
+{
+	constexpr uint32_t FileMagic = 0x474C5454;   // 'TTLG'
+	constexpr uint32_t FileVersion = 1;
+
+	enum class Level : uint8_t
+	{
+		Debug,
+		Info,
+		Warning,
+		Error,
+		Count
+	};
+
+	inline const char* GetLevelName(Level level)
+	{
+		static constexpr const char* names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+		return level < Level::Count ? names[size_t(level)] : "?";
+	}
+
+	enum class ChunkType : uint16_t
+	{
+		Site = 1,       // Call site definition
+		Record = 2,     // One log call
+		Dropped = 3     // Records lost to a full thread buffer
+	};
+
+	// Encoded argument tags
+	enum class ArgType : uint8_t
+	{
+		Int = 1,        // int64_t
+		UInt = 2,       // uint64_t
+		Double = 3,     // double
+		String = 4      // uint16_t length + UTF-8 bytes
+	};
+
+	constexpr size_t MaxStringBytes = 256;   // Longer strings are truncated
+
+#pragma pack(push, 1)
+	struct FileHeader
+	{
+		uint32_t magic{};
+		uint32_t version{};
+		uint64_t steadyOriginNs{};   // Steady clock at logger start
+		int64_t wallOriginNs{};      // Wall clock (ns since 1970) at the same moment
+	};
+
+	struct ChunkHeader
+	{
+		uint16_t type{};             // ChunkType
+		uint16_t reserved{};
+		uint32_t size{};             // Payload bytes following this header
+	};
+
+	// Followed by `fileLength` bytes of file name and `formatLength` bytes of format
+	struct SiteChunk
+	{
+		uint32_t id{};
+		uint8_t level{};
+		uint8_t reserved{};
+		uint16_t fileLength{};
+		uint32_t line{};
+		uint16_t formatLength{};
+	};
+
+	// Followed by the encoded arguments
+	struct RecordChunk
+	{
+		uint32_t siteId{};
+		uint32_t threadId{};         // Logger-assigned thread index
+		uint64_t time{};             // Steady clock nanoseconds
+	};
+
+	struct DroppedChunk
+	{
+		uint32_t threadId{};
+		uint32_t reserved{};
+		uint64_t count{};
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(FileHeader) == 24, "Unexpected FileHeader layout");
+	static_assert(sizeof(ChunkHeader) == 8, "Unexpected ChunkHeader layout");
+	static_assert(sizeof(RecordChunk) == 16, "Unexpected RecordChunk layout");
+
+
+
+	// Expands "{}" placeholders in `format` with the encoded arguments;
+	// returns false if the argument block is malformed
+	inline bool RenderMessage(const char* format, size_t formatLength,
+		const uint8_t* pArgs, size_t argsLength, std::string* pText)
+	{
+		size_t offset{};
+		char number[40];
+
+		auto appendNext = [&]() {
+			if (offset >= argsLength) {
+				pText->append("{?}");
+				return true;
+			}
+
+			const ArgType type = ArgType(pArgs[offset++]);
+			if (type == ArgType::String) {
+				if (offset + sizeof(uint16_t) > argsLength) { return false; }
+				uint16_t length{};
+				std::memcpy(&length, pArgs + offset, sizeof(length));
+				offset += sizeof(length);
+				if (offset + length > argsLength) { return false; }
+				pText->append(reinterpret_cast<const char*>(pArgs + offset), length);
+				offset += length;
+				return true;
+			}
+
+			if (offset + 8 > argsLength) { return false; }
+			if (type == ArgType::Int) {
+				int64_t value{};
+				std::memcpy(&value, pArgs + offset, 8);
+				std::snprintf(number, sizeof(number), "%lld", (long long)value);
+			}
+			else if (type == ArgType::UInt) {
+				uint64_t value{};
+				std::memcpy(&value, pArgs + offset, 8);
+				std::snprintf(number, sizeof(number), "%llu", (unsigned long long)value);
+			}
+			else if (type == ArgType::Double) {
+				double value{};
+				std::memcpy(&value, pArgs + offset, 8);
+				std::snprintf(number, sizeof(number), "%g", value);
+			}
+			else {
+				return false;
+			}
+			offset += 8;
+			pText->append(number);
+			return true;
+			};
+
+		for (size_t i{}; i < formatLength; ++i) {
+			if (format[i] == '{' and i + 1 < formatLength and format[i + 1] == '}') {
+				if (!appendNext()) { return false; }
+				++i;
+				continue;
+			}
+			pText->push_back(format[i]);
+		}
+
+		return true;
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	// Decoder side
+	Logging::SiteChunk site = ...;   // From a Site chunk
+	std::string text{};
+	Logging::RenderMessage(format.data(), format.size(), pArgs, argsLength, &text);
+
+*/
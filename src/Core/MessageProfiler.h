@@ -0,0 +1,208 @@
+#pragma once
+
+// Standard library headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+
+
+
+// Per-message handler profiler.
+// Each process declares the (message, command) pairs it handles in a constexpr
+// key table; handler scopes resolve their slot at compile time, so recording
+// is two clock reads and three relaxed atomic updates. A handler whose key is
+// missing from the table does not compile. Compiled in only when
+// TABTAP_PROFILE is defined.
+namespace Profiling
+{
+	// Profiled handler identity
+	struct Key
+	{
+		uint32_t message{};    // Window message
+		uint32_t command{};    // Command/timer ID, or 0 for the whole message
+		const char* name{};    // Label used in dumps
+	};
+
+	// Resolves the slot of a key; unknown keys give N (rejected by PROFILE_HANDLER)
+	template <size_t N>
+	constexpr size_t IndexOf(const Key(&keys)[N], uint32_t message, uint32_t command)
+	{
+		for (size_t i{}; i < N; ++i) {
+			if (keys[i].message == message and keys[i].command == command) {
+				return i;
+			}
+		}
+		return N;
+	}
+
+	// Snapshot of one slot
+	struct Stats
+	{
+		uint64_t count{};
+		uint64_t totalNs{};
+		uint64_t maxNs{};
+	};
+
+
+
+	// Fixed-size table of handler statistics
+	template <size_t N>
+	class MessageProfiler
+	{
+	private:
+		struct Slot
+		{
+			std::atomic<uint64_t> count{};
+			std::atomic<uint64_t> totalNs{};
+			std::atomic<uint64_t> maxNs{};
+		};
+
+		const Key(&keys)[N];                 // Key table (static storage)
+		std::array<Slot, N> slots{};         // One per key
+
+	public:
+		explicit MessageProfiler(const Key(&table)[N]) :
+			keys{ table }
+		{}
+
+		MessageProfiler(const MessageProfiler&) = delete;
+		MessageProfiler& operator=(const MessageProfiler&) = delete;
+
+		// Adds one handler invocation
+		void Record(size_t slot, uint64_t elapsedNs)
+		{
+			if (slot >= N) { return; }
+			Slot& entry = slots[slot];
+
+			// Only the owning UI thread writes; relaxed ordering is enough for dumps
+			entry.count.fetch_add(1, std::memory_order_relaxed);
+			entry.totalNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+			if (elapsedNs > entry.maxNs.load(std::memory_order_relaxed)) {
+				entry.maxNs.store(elapsedNs, std::memory_order_relaxed);
+			}
+		}
+
+		// Returns the statistics of one slot
+		Stats GetStats(size_t slot) const
+		{
+			if (slot >= N) { return {}; }
+			const Slot& entry = slots[slot];
+			return {
+				entry.count.load(std::memory_order_relaxed),
+				entry.totalNs.load(std::memory_order_relaxed),
+				entry.maxNs.load(std::memory_order_relaxed)
+			};
+		}
+
+		// Clears all slots
+		void Reset()
+		{
+			for (Slot& entry : slots) {
+				entry.count.store(0, std::memory_order_relaxed);
+				entry.totalNs.store(0, std::memory_order_relaxed);
+				entry.maxNs.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		// Formats non-empty slots as a text table (microseconds)
+		std::string Format(const char* title) const
+		{
+			std::string text{};
+			char line[160];
+
+			std::snprintf(line, sizeof(line), "%s\n%-32s %10s %12s %10s %10s\n",
+				title, "handler", "count", "total_us", "avg_us", "max_us");
+			text += line;
+
+			for (size_t i{}; i < N; ++i) {
+				const Stats stats = GetStats(i);
+				if (!stats.count) { continue; }
+
+				std::snprintf(line, sizeof(line), "%-32s %10" PRIu64 " %12.1f %10.2f %10.1f\n",
+					keys[i].name,
+					stats.count,
+					stats.totalNs / 1000.0,
+					stats.totalNs / 1000.0 / double(stats.count),
+					stats.maxNs / 1000.0);
+				text += line;
+			}
+
+			return text;
+		}
+	};
+
+
+
+	// Measures the enclosing handler scope
+	template <typename ProfilerTy>
+	class ScopedTimer
+	{
+	private:
+		ProfilerTy& profiler;
+		const size_t slot;
+		const std::chrono::steady_clock::time_point start;
+
+	public:
+		ScopedTimer(ProfilerTy& target, size_t index) :
+			profiler{ target },
+			slot{ index },
+			start{ std::chrono::steady_clock::now() }
+		{}
+
+		~ScopedTimer()
+		{
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			profiler.Record(slot, uint64_t(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+}
+
+
+
+// Handler scope instrumentation (no code is generated without TABTAP_PROFILE)
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef TABTAP_PROFILE
+#define PROFILE_HANDLER(profiler, keys, message, command) \
+	constexpr size_t PROFILE_CONCAT(profileSlot_, __LINE__) = \
+		Profiling::IndexOf(keys, (message), (command)); \
+	static_assert(PROFILE_CONCAT(profileSlot_, __LINE__) < std::size(keys), \
+		"Profiled handler missing from the key table: " #message ", " #command); \
+	Profiling::ScopedTimer<decltype(profiler)> PROFILE_CONCAT(profileTimer_, __LINE__){ \
+		profiler, PROFILE_CONCAT(profileSlot_, __LINE__) }
+#else
+#define PROFILE_HANDLER(profiler, keys, message, command) ((void)0)
+#endif
+
+
+
+
+/*
+Usage example:
+
+	constexpr Profiling::Key ProfileKeys[] = {
+		{ WM_MOUSEMOVE, 0, "WM_MOUSEMOVE" },
+		{ WM_TIMER, IDT_BLINK_TIMER, "WM_TIMER/IDT_BLINK_TIMER" },
+	};
+	Profiling::MessageProfiler<std::size(ProfileKeys)> g_profiler{ ProfileKeys };
+
+	case WM_MOUSEMOVE:
+	{
+		PROFILE_HANDLER(g_profiler, ProfileKeys, WM_MOUSEMOVE, 0);
+		...
+	}
+
+	OutputDebugStringA(g_profiler.Format("TabTap").c_str());
+
+*/
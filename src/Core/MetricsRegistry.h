@@ -0,0 +1,574 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+// Counters, gauges and histograms placed in caller-provided (shared) memory.
+// Every thread that records claims its own shard of cells, so recording is
+// a relaxed load and store on a cache line no other thread writes; threads
+// beyond the shard count share the last shard with atomic adds. A snapshot
+// sums the shards without stopping writers: each counter it reports is at
+// least its value in any earlier snapshot, and a histogram's count is the
+// sum of its buckets by construction. The block holds no pointers, so TabTap
+// and the hook inside osk.exe register into the same one.
+namespace Metrics
+{
+	constexpr uint32_t Magic = 0x4d545454;    // 'TTTM'
+	constexpr uint32_t Version = 1;
+	constexpr size_t CacheLine = 64;
+
+	constexpr uint32_t MaxMetrics = 64;
+	constexpr uint32_t MaxCells = 256;        // Counter: 1, gauge: 1, histogram: bounds + 2
+	constexpr uint32_t MaxShards = 16;        // The last one is shared
+	constexpr uint32_t MaxBounds = 12;        // Histogram buckets besides +Inf
+	constexpr size_t NameBytes = 48;
+	constexpr size_t HelpBytes = 80;
+
+	enum class Kind : uint8_t
+	{
+		Counter,     // Only goes up
+		Gauge,       // Set to the current value
+		Histogram    // Observations per bucket and their sum
+	};
+
+	inline const char* GetKindName(Kind kind)
+	{
+		switch (kind)
+		{
+		case Kind::Counter:     return "counter";
+		case Kind::Gauge:       return "gauge";
+		case Kind::Histogram:   return "histogram";
+		default:                return "untyped";
+		}
+	}
+
+	// Registered metric (written once, before it is published)
+	struct Descriptor
+	{
+		char name[NameBytes]{};
+		char help[HelpBytes]{};
+		Kind kind{};
+		uint8_t boundCount{};            // Histogram buckets besides +Inf
+		uint16_t firstCell{};
+		uint64_t bounds[MaxBounds]{};    // Inclusive upper bounds, ascending
+	};
+
+	// Registry bookkeeping at the start of the block
+	struct Header
+	{
+		uint32_t magic{};
+		uint32_t version{};
+		uint32_t maxMetrics{};
+		uint32_t maxCells{};
+		uint32_t maxShards{};
+
+		alignas(CacheLine) std::atomic<uint32_t> registerLock{};    // Held while registering
+		std::atomic<uint32_t> metricCount{};                        // Published descriptors
+		uint32_t cellCount{};                                       // Guarded by `registerLock`
+		alignas(CacheLine) std::atomic<uint32_t> shardCount{};      // Shards handed to threads
+	};
+
+	// Cells written by one thread
+	struct alignas(CacheLine) Shard
+	{
+		std::atomic<uint64_t> cells[MaxCells];
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		"Shared memory atomics must be lock-free");
+
+	// Bytes needed for a registry block
+	constexpr size_t RequiredBytes()
+	{
+		return sizeof(Header) + sizeof(Descriptor) * MaxMetrics +
+			sizeof(std::atomic<uint64_t>) * MaxCells + sizeof(Shard) * MaxShards + CacheLine;
+	}
+
+	// Checks a Prometheus metric name ([a-zA-Z_:][a-zA-Z0-9_:]*)
+	inline bool IsValidName(const char* pszName)
+	{
+		if (!pszName or !*pszName or std::strlen(pszName) >= NameBytes) { return false; }
+		for (const char* p = pszName; *p; ++p) {
+			const bool isAlpha = (*p >= 'a' and *p <= 'z') or (*p >= 'A' and *p <= 'Z') or *p == '_' or *p == ':';
+			const bool isDigit = *p >= '0' and *p <= '9';
+			if (!isAlpha and !(isDigit and p != pszName)) { return false; }
+		}
+		return true;
+	}
+
+
+
+	// Values of all published metrics at one point
+	struct Snapshot
+	{
+		std::vector<Descriptor> metrics{};
+		std::vector<uint64_t> cells{};       // Summed over shards; gauges as stored
+
+		// Counter or gauge value, or a histogram's observation count
+		uint64_t GetValue(size_t metric) const
+		{
+			const Descriptor& desc = metrics[metric];
+			if (desc.kind != Kind::Histogram) { return cells[desc.firstCell]; }
+
+			uint64_t count{};
+			for (size_t i{}; i <= desc.boundCount; ++i) { count += cells[desc.firstCell + i]; }
+			return count;
+		}
+
+		// Observations in one bucket (not cumulative); `bucket == boundCount` is +Inf
+		uint64_t GetBucket(size_t metric, size_t bucket) const
+		{
+			return cells[metrics[metric].firstCell + bucket];
+		}
+
+		uint64_t GetSum(size_t metric) const
+		{
+			const Descriptor& desc = metrics[metric];
+			return cells[desc.firstCell + desc.boundCount + 1];
+		}
+
+		// Index of a metric by name, or SIZE_MAX
+		size_t Find(const char* pszName) const
+		{
+			for (size_t i{}; i < metrics.size(); ++i) {
+				if (std::strcmp(metrics[i].name, pszName) == 0) { return i; }
+			}
+			return SIZE_MAX;
+		}
+	};
+
+
+
+	class Registry;
+
+	// Monotonic count; a default-constructed handle records nothing
+	class Counter
+	{
+	private:
+		friend class Registry;
+		Registry* pRegistry{};
+		uint32_t cell{};
+
+	public:
+		void Add(uint64_t value = 1) const;
+		bool IsValid() const { return pRegistry != nullptr; }
+	};
+
+	// Current value (not sharded; the last writer wins)
+	class Gauge
+	{
+	private:
+		friend class Registry;
+		Registry* pRegistry{};
+		uint32_t cell{};
+
+	public:
+		void Set(int64_t value) const;
+		void Add(int64_t delta) const;
+		bool IsValid() const { return pRegistry != nullptr; }
+	};
+
+	// Bucketed observations (durations in microseconds, sizes, counts)
+	class Histogram
+	{
+	private:
+		friend class Registry;
+		Registry* pRegistry{};
+		const Descriptor* pDescriptor{};
+
+	public:
+		void Observe(uint64_t value) const;
+		bool IsValid() const { return pRegistry != nullptr; }
+	};
+
+
+
+	// View over a registry block; does not own the memory
+	class Registry
+	{
+	private:
+		friend class Counter;
+		friend class Gauge;
+		friend class Histogram;
+
+		static constexpr uint32_t SharedShard = MaxShards - 1;
+		static constexpr unsigned LockSpins = 1000;    // Yields before registration gives up
+
+		Header* pHeader{};
+		Descriptor* pDescriptors{};
+		std::atomic<uint64_t>* pGauges{};
+		Shard* pShards{};
+
+		struct ShardRef
+		{
+			const Header* pHeader{};
+			Shard* pShard{};
+			bool isShared{};
+		};
+
+	private:
+		static Registry Layout(void* pMemory)
+		{
+			unsigned char* p = static_cast<unsigned char*>(pMemory);
+			Registry registry{};
+			registry.pHeader = reinterpret_cast<Header*>(p);
+			registry.pDescriptors = reinterpret_cast<Descriptor*>(p + sizeof(Header));
+			registry.pGauges = reinterpret_cast<std::atomic<uint64_t>*>(
+				p + sizeof(Header) + sizeof(Descriptor) * MaxMetrics);
+
+			// Shards start on a cache line of their own
+			uintptr_t shards = reinterpret_cast<uintptr_t>(registry.pGauges + MaxCells);
+			shards = (shards + CacheLine - 1) & ~uintptr_t(CacheLine - 1);
+			registry.pShards = reinterpret_cast<Shard*>(shards);
+			return registry;
+		}
+
+		// Shard of the calling thread, claimed on first use
+		ShardRef GetShard()
+		{
+			static thread_local ShardRef cache[4]{};
+			static thread_local unsigned nextEntry{};
+
+			for (const ShardRef& ref : cache) {
+				if (ref.pHeader == pHeader) { return ref; }
+			}
+
+			// Exhausted shards (many short-lived threads) fall back to the shared one
+			uint32_t index = pHeader->shardCount.fetch_add(1, std::memory_order_relaxed);
+			if (index > SharedShard) { index = SharedShard; }
+
+			ShardRef& entry = cache[nextEntry++ % std::size(cache)];
+			entry = { pHeader, &pShards[index], index == SharedShard };
+			return entry;
+		}
+
+		void AddToCell(uint32_t cell, uint64_t value)
+		{
+			const ShardRef ref = GetShard();
+			std::atomic<uint64_t>& target = ref.pShard->cells[cell];
+			if (ref.isShared) {
+				target.fetch_add(value, std::memory_order_relaxed);
+			}
+			else {
+				// Single writer: no read-modify-write needed
+				target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+		}
+
+		bool Lock()
+		{
+			for (unsigned spin{}; spin < LockSpins; ++spin) {
+				if (!pHeader->registerLock.exchange(1, std::memory_order_acquire)) { return true; }
+				std::this_thread::yield();
+			}
+			return false;
+		}
+
+		void Unlock()
+		{
+			pHeader->registerLock.store(0, std::memory_order_release);
+		}
+
+		// Finds or adds a metric; nullptr if the block is full or the name is taken by another kind
+		const Descriptor* Register(const char* pszName, const char* pszHelp, Kind kind,
+			std::initializer_list<uint64_t> bounds)
+		{
+			if (!IsValid() or !IsValidName(pszName) or bounds.size() > MaxBounds) { return nullptr; }
+			if (!Lock()) { return nullptr; }
+
+			const uint32_t count = pHeader->metricCount.load(std::memory_order_relaxed);
+			for (uint32_t i{}; i < count; ++i) {
+				if (std::strcmp(pDescriptors[i].name, pszName) == 0) {
+					Unlock();
+					return pDescriptors[i].kind == kind ? &pDescriptors[i] : nullptr;
+				}
+			}
+
+			const uint32_t cells = kind == Kind::Histogram ? uint32_t(bounds.size()) + 2 : 1;
+			if (count >= MaxMetrics or pHeader->cellCount + cells > MaxCells) {
+				Unlock();
+				return nullptr;
+			}
+
+			Descriptor& desc = pDescriptors[count];
+			desc = {};
+			std::snprintf(desc.name, sizeof(desc.name), "%s", pszName);
+			std::snprintf(desc.help, sizeof(desc.help), "%s", pszHelp ? pszHelp : "");
+			desc.kind = kind;
+			desc.boundCount = uint8_t(bounds.size());
+			desc.firstCell = uint16_t(pHeader->cellCount);
+			size_t i{};
+			for (uint64_t bound : bounds) { desc.bounds[i++] = bound; }
+
+			pHeader->cellCount += cells;
+			pHeader->metricCount.store(count + 1, std::memory_order_release);   // Publish
+			Unlock();
+			return &desc;
+		}
+
+	public:
+		Registry() = default;
+
+		// Formats a zeroed block as an empty registry
+		static Registry Create(void* pMemory, size_t bytes)
+		{
+			if (!pMemory or bytes < RequiredBytes()) { return {}; }
+
+			Registry registry = Layout(pMemory);
+			Header* header = new (registry.pHeader) Header{};
+			for (uint32_t i{}; i < MaxMetrics; ++i) { new (&registry.pDescriptors[i]) Descriptor{}; }
+			for (uint32_t i{}; i < MaxCells; ++i) { new (&registry.pGauges[i]) std::atomic<uint64_t>{}; }
+			for (uint32_t s{}; s < MaxShards; ++s) {
+				for (uint32_t i{}; i < MaxCells; ++i) { new (&registry.pShards[s].cells[i]) std::atomic<uint64_t>{}; }
+			}
+
+			header->maxMetrics = MaxMetrics;
+			header->maxCells = MaxCells;
+			header->maxShards = MaxShards;
+			header->version = Version;
+			// Publish the magic last so an attaching process never sees a half-built registry
+			std::atomic_thread_fence(std::memory_order_release);
+			header->magic = Magic;
+
+			return registry;
+		}
+
+		// Attaches to a registry formatted by another process
+		static Registry Attach(void* pMemory, size_t bytes)
+		{
+			if (!pMemory or bytes < RequiredBytes()) { return {}; }
+
+			const Header* header = static_cast<const Header*>(pMemory);
+			if (header->magic != Magic) { return {}; }
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (header->version != Version or header->maxMetrics != MaxMetrics or
+				header->maxCells != MaxCells or header->maxShards != MaxShards)
+			{
+				return {};
+			}
+
+			return Layout(pMemory);
+		}
+
+		bool IsValid() const { return pHeader != nullptr; }
+
+		// --- Registration (returns an inert handle on failure) ---
+
+		/// Adds a counter, or returns the one already registered under the name
+		Counter AddCounter(const char* pszName, const char* pszHelp)
+		{
+			Counter counter{};
+			if (const Descriptor* pDesc = Register(pszName, pszHelp, Kind::Counter, {})) {
+				counter.pRegistry = this;
+				counter.cell = pDesc->firstCell;
+			}
+			return counter;
+		}
+
+		/// Adds a gauge, or returns the one already registered under the name
+		Gauge AddGauge(const char* pszName, const char* pszHelp)
+		{
+			Gauge gauge{};
+			if (const Descriptor* pDesc = Register(pszName, pszHelp, Kind::Gauge, {})) {
+				gauge.pRegistry = this;
+				gauge.cell = pDesc->firstCell;
+			}
+			return gauge;
+		}
+
+		/// Adds a histogram with ascending bucket bounds (the first registration's bounds stay)
+		Histogram AddHistogram(const char* pszName, const char* pszHelp, std::initializer_list<uint64_t> bounds)
+		{
+			Histogram histogram{};
+			if (const Descriptor* pDesc = Register(pszName, pszHelp, Kind::Histogram, bounds)) {
+				histogram.pRegistry = this;
+				histogram.pDescriptor = pDesc;
+			}
+			return histogram;
+		}
+
+		// --- Export ---
+
+		/// Reads every published metric; safe while other threads record
+		Snapshot TakeSnapshot() const
+		{
+			Snapshot snapshot{};
+			if (!IsValid()) { return snapshot; }
+
+			const uint32_t count = pHeader->metricCount.load(std::memory_order_acquire);
+			snapshot.metrics.assign(pDescriptors, pDescriptors + count);
+
+			uint32_t cells{};
+			for (const Descriptor& desc : snapshot.metrics) {
+				const uint32_t used = desc.kind == Kind::Histogram ? desc.boundCount + 2u : 1u;
+				if (desc.firstCell + used > cells) { cells = desc.firstCell + used; }
+			}
+			snapshot.cells.assign(cells, 0);
+
+			const uint32_t shards = std::min(pHeader->shardCount.load(std::memory_order_relaxed), MaxShards);
+			for (const Descriptor& desc : snapshot.metrics) {
+				const uint32_t used = desc.kind == Kind::Histogram ? desc.boundCount + 2u : 1u;
+				for (uint32_t cell = desc.firstCell; cell < desc.firstCell + used; ++cell) {
+					if (desc.kind == Kind::Gauge) {
+						snapshot.cells[cell] = pGauges[cell].load(std::memory_order_relaxed);
+						continue;
+					}
+					uint64_t total{};
+					for (uint32_t s{}; s < shards; ++s) {
+						total += pShards[s].cells[cell].load(std::memory_order_relaxed);
+					}
+					snapshot.cells[cell] = total;
+				}
+			}
+			return snapshot;
+		}
+	};
+
+
+
+	// Handles outliving their registry view (block unmapped) record nothing
+	inline void Counter::Add(uint64_t value) const
+	{
+		if (pRegistry and pRegistry->IsValid()) { pRegistry->AddToCell(cell, value); }
+	}
+
+	inline void Gauge::Set(int64_t value) const
+	{
+		if (pRegistry and pRegistry->IsValid()) {
+			pRegistry->pGauges[cell].store(uint64_t(value), std::memory_order_relaxed);
+		}
+	}
+
+	inline void Gauge::Add(int64_t delta) const
+	{
+		if (pRegistry and pRegistry->IsValid()) {
+			pRegistry->pGauges[cell].fetch_add(uint64_t(delta), std::memory_order_relaxed);
+		}
+	}
+
+	inline void Histogram::Observe(uint64_t value) const
+	{
+		if (!pRegistry or !pRegistry->IsValid()) { return; }
+
+		uint32_t bucket{};
+		while (bucket < pDescriptor->boundCount and value > pDescriptor->bounds[bucket]) { ++bucket; }
+
+		pRegistry->AddToCell(pDescriptor->firstCell + bucket, 1);
+		pRegistry->AddToCell(pDescriptor->firstCell + pDescriptor->boundCount + 1, value);
+	}
+
+
+
+	// Prometheus text exposition format (version 0.0.4)
+	inline std::string FormatText(const Snapshot& snapshot)
+	{
+		std::string text{};
+		char line[192];
+
+		for (size_t m{}; m < snapshot.metrics.size(); ++m) {
+			const Descriptor& desc = snapshot.metrics[m];
+
+			// HELP escapes backslashes and line breaks
+			text += "# HELP ";
+			text += desc.name;
+			text += ' ';
+			for (const char* p = desc.help; *p; ++p) {
+				if (*p == '\\') { text += "\\\\"; }
+				else if (*p == '\n') { text += "\\n"; }
+				else { text += *p; }
+			}
+			std::snprintf(line, sizeof(line), "\n# TYPE %s %s\n", desc.name, GetKindName(desc.kind));
+			text += line;
+
+			if (desc.kind == Kind::Gauge) {
+				std::snprintf(line, sizeof(line), "%s %" PRId64 "\n", desc.name, int64_t(snapshot.GetValue(m)));
+				text += line;
+				continue;
+			}
+			if (desc.kind == Kind::Counter) {
+				std::snprintf(line, sizeof(line), "%s %" PRIu64 "\n", desc.name, snapshot.GetValue(m));
+				text += line;
+				continue;
+			}
+
+			// Buckets are cumulative; +Inf and _count are the same total
+			uint64_t cumulative{};
+			for (size_t b{}; b < desc.boundCount; ++b) {
+				cumulative += snapshot.GetBucket(m, b);
+				std::snprintf(line, sizeof(line), "%s_bucket{le=\"%" PRIu64 "\"} %" PRIu64 "\n",
+					desc.name, desc.bounds[b], cumulative);
+				text += line;
+			}
+			cumulative += snapshot.GetBucket(m, desc.boundCount);
+			std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %" PRIu64 "\n%s_sum %" PRIu64 "\n%s_count %" PRIu64 "\n",
+				desc.name, cumulative, desc.name, snapshot.GetSum(m), desc.name, cumulative);
+			text += line;
+		}
+
+		return text;
+	}
+
+
+
+	// Observes the lifetime of the enclosing scope in microseconds
+	class ScopedTimer
+	{
+	private:
+		const Histogram& histogram;
+		const std::chrono::steady_clock::time_point start;
+
+	public:
+		explicit ScopedTimer(const Histogram& target) :
+			histogram{ target },
+			start{ std::chrono::steady_clock::now() }
+		{}
+
+		~ScopedTimer()
+		{
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			histogram.Observe(uint64_t(
+				std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	alignas(64) static unsigned char block[Metrics::RequiredBytes()]{};
+	static Metrics::Registry registry = Metrics::Registry::Create(block, sizeof(block));
+
+	Metrics::Counter redraws = registry.AddCounter("tabtap_redraws_total", "Tab redraws");
+	Metrics::Histogram drawTime = registry.AddHistogram("tabtap_draw_us", "Tab draw time",
+		{ 100, 250, 500, 1000, 2500 });
+
+	{
+		Metrics::ScopedTimer timer{ drawTime };
+		redraws.Add();
+		...
+	}
+
+	std::string text = Metrics::FormatText(registry.TakeSnapshot());
+
+*/
@@ -0,0 +1,223 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+
+// Decides how TabTap gets a hooked OSK at startup. A running osk.exe that
+// still carries the hook (TabTap restarted or crashed) is reconnected to; a
+// running one without it gets the hook injected into its existing thread;
+// only a missing, hung or outdated one is closed and cold started. TabTap
+// probes the window and reports each step's outcome; the planner picks the
+// next step and falls back to a cold start when an attach fails.
+namespace OskAttach
+{
+	// Reply of the subclassed OSK window to ID_APP_HOOK_PING ('TT' + version)
+	constexpr uint32_t HookMagic = 0x54540000u;
+	constexpr uint32_t HookVersion = 1;
+
+	constexpr uint32_t MakeHookReply(uint32_t version)
+	{
+		return HookMagic | (version & 0xffffu);
+	}
+
+	inline bool IsHookReply(uint32_t reply)
+	{
+		return (reply & 0xffff0000u) == HookMagic;
+	}
+
+	// What TabTap found before starting the OSK
+	struct Probe
+	{
+		bool isWindowFound{};        // An OSKMainClass window exists
+		bool isResponding{};         // It answered the ping within the timeout
+		bool isModuleLoaded{};       // The hook DLL is in its module list (false if unknown)
+		uint32_t hookReply{};        // Ping answer; 0 when not subclassed
+	};
+
+	enum class Step : uint8_t
+	{
+		Reconnect,   // Hook present and current: take over its windows
+		Inject,      // Hook the running OSK thread and adopt its windows
+		Close,       // Close the running OSK (hung, outdated hook, failed attach)
+		Launch,      // Start osk.exe and wait until it is idle
+		Hook,        // Install the CBT hook and wait for the load event
+		Done,
+		Failed
+	};
+
+	enum class Mode : uint8_t
+	{
+		None,
+		Reconnected,
+		Injected,
+		ColdStarted
+	};
+
+	inline const char* GetStepName(Step step)
+	{
+		switch (step)
+		{
+		case Step::Reconnect:    return "reconnect";
+		case Step::Inject:       return "inject";
+		case Step::Close:        return "close";
+		case Step::Launch:       return "launch";
+		case Step::Hook:         return "hook";
+		case Step::Done:         return "done";
+		case Step::Failed:       return "failed";
+		default:                 return "?";
+		}
+	}
+
+	inline const char* GetModeName(Mode mode)
+	{
+		switch (mode)
+		{
+		case Mode::None:         return "none";
+		case Mode::Reconnected:  return "reconnected";
+		case Mode::Injected:     return "injected";
+		case Mode::ColdStarted:  return "cold start";
+		default:                 return "?";
+		}
+	}
+
+	class Planner
+	{
+	public:
+		static constexpr size_t MaxSteps = 8;
+
+	private:
+		Step step{ Step::Failed };
+		Mode mode{};
+		Step path[MaxSteps]{};       // Steps taken so far, in order
+		uint32_t stepMs[MaxSteps]{}; // Time each of them took
+		size_t stepCount{};
+		uint32_t stepStartMs{};
+		uint32_t beginMs{};
+		uint32_t totalMs{};
+		bool isFallback{};
+
+	private:
+		Step Enter(Step next, uint32_t nowMs)
+		{
+			step = next;
+			stepStartMs = nowMs;
+			if (next == Step::Done or next == Step::Failed) {
+				totalMs = nowMs - beginMs;
+			}
+			return step;
+		}
+
+	public:
+		/// Picks the first step from the probe; times are millisecond ticks
+		Step Begin(const Probe& probe, uint32_t nowMs)
+		{
+			*this = {};
+			beginMs = nowMs;
+
+			if (!probe.isWindowFound) {
+				return Enter(Step::Launch, nowMs);
+			}
+			if (!probe.isResponding) {
+				return Enter(Step::Close, nowMs);
+			}
+			if (IsHookReply(probe.hookReply)) {
+				// An older hook would not understand this TabTap's commands
+				const bool isCurrent = probe.hookReply == MakeHookReply(HookVersion);
+				return Enter(isCurrent ? Step::Reconnect : Step::Close, nowMs);
+			}
+			// Hook missing, or its DLL is loaded without windows: inject adopts them either way
+			return Enter(Step::Inject, nowMs);
+		}
+
+		/// Reports the current step's outcome; returns the next step
+		Step Advance(bool isSucceeded, uint32_t nowMs)
+		{
+			if (step == Step::Done or step == Step::Failed) { return step; }
+
+			if (stepCount < MaxSteps) {
+				path[stepCount] = step;
+				stepMs[stepCount] = nowMs - stepStartMs;
+				++stepCount;
+			}
+
+			switch (step)
+			{
+			case Step::Reconnect:
+				if (isSucceeded) { mode = Mode::Reconnected; return Enter(Step::Done, nowMs); }
+				return Enter(Step::Inject, nowMs);
+
+			case Step::Inject:
+				if (isSucceeded) { mode = Mode::Injected; return Enter(Step::Done, nowMs); }
+				isFallback = true;
+				return Enter(Step::Close, nowMs);
+
+			case Step::Close:
+				// osk.exe is single-instance; launching beside a live one would only activate it
+				return Enter(isSucceeded ? Step::Launch : Step::Failed, nowMs);
+
+			case Step::Launch:
+				return Enter(isSucceeded ? Step::Hook : Step::Failed, nowMs);
+
+			case Step::Hook:
+				if (isSucceeded) { mode = Mode::ColdStarted; return Enter(Step::Done, nowMs); }
+				return Enter(Step::Failed, nowMs);
+
+			default:
+				return Enter(Step::Failed, nowMs);
+			}
+		}
+
+		/// Checks if an attach failed and the OSK was restarted instead
+		bool IsFallback() const { return isFallback; }
+
+		/// Formats the steps taken, e.g. "inject 40 ms, close 120 ms, launch 900 ms"
+		std::string FormatPath() const
+		{
+			std::string text{};
+			for (size_t i{}; i < stepCount; ++i) {
+				if (i) { text += ", "; }
+				text += GetStepName(path[i]);
+				text += ' ';
+				text += std::to_string(stepMs[i]);
+				text += " ms";
+			}
+			return text;
+		}
+
+		Step GetStep() const { return step; }
+		Mode GetMode() const { return mode; }
+		/// Milliseconds from Begin to Done or Failed
+		uint32_t GetTotalMs() const { return totalMs; }
+		bool IsFinished() const { return step == Step::Done or step == Step::Failed; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	OskAttach::Planner planner{};
+	OskAttach::Step step = planner.Begin(ProbeRunningOsk(), GetTickCount());
+
+	while (!planner.IsFinished()) {
+		bool isSucceeded{};
+		switch (step)
+		{
+		case OskAttach::Step::Reconnect:  isSucceeded = ReconnectHook(); break;
+		case OskAttach::Step::Inject:     isSucceeded = InjectHook(); break;
+		case OskAttach::Step::Close:      isSucceeded = CloseOsk(); break;
+		case OskAttach::Step::Launch:     isSucceeded = LaunchOsk(); break;
+		case OskAttach::Step::Hook:       isSucceeded = InstallHook(); break;
+		}
+		step = planner.Advance(isSucceeded, GetTickCount());
+	}
+
+	LOG_INFO(logger, "OSK {} in {} ms", OskAttach::GetModeName(planner.GetMode()), planner.GetTotalMs());
+
+*/
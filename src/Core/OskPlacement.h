@@ -0,0 +1,170 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+#include "GroupLayout.h"
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+
+
+// Where the OSK goes so it does not cover the text being typed. The home
+// position is the one SyncOskPositionWithMain always used, centred on the
+// tab; when that covers the caret (kept clear by a margin), the OSK stays
+// where it is if that is clear, or else moves above or below the caret in
+// its own column, or beside it as a last resort. Of the positions that cover
+// the least, the one closest to where the OSK already is wins, so a caret
+// moving along a line moves nothing.
+namespace OskPlacement
+{
+	struct Input
+	{
+		Geometry::Rect caret{};              // Caret or focused element (empty when unknown)
+		Geometry::Rect osk{};                // Current OSK rectangle
+		Geometry::Rect tab{};                // Tab rectangle
+		Geometry::Rect workArea{};
+		long margin{ 12 };                   // Clearance kept around the caret
+	};
+
+	struct Placement
+	{
+		Geometry::Point osk{};               // New OSK top-left
+		long overlap{};                      // Area still covering the caret and its margin
+		bool isMoved{};                      // Differs from the current position
+		bool isHome{};                       // Centred on the tab as before
+	};
+
+	namespace Detail
+	{
+		inline long OverlapArea(const Geometry::Rect& a, const Geometry::Rect& b)
+		{
+			const Geometry::Rect shared = Geometry::Intersect(a, b);
+			return shared.Width() * shared.Height();
+		}
+	}
+
+	/// Returns the OSK top that centres it on the tab inside the work area
+	inline long HomeTop(const Input& input)
+	{
+		return Geometry::ClampSpan(
+			GroupLayout::CenteredTop(input.tab.top, input.tab.Height(), input.osk.Height()),
+			input.osk.Height(), input.workArea.top, input.workArea.bottom);
+	}
+
+	/// Picks the OSK position for a caret
+	inline Placement Solve(const Input& input)
+	{
+		const Geometry::Size size = input.osk.GetSize();
+		const Geometry::Point current = input.osk.TopLeft();
+		const Geometry::Point home{ current.x, HomeTop(input) };
+
+		Placement best{ home, 0, home != current, true };
+		if (input.caret.IsEmpty() or size.cx <= 0 or size.cy <= 0) { return best; }
+
+		const Geometry::Rect avoid{
+			input.caret.left - input.margin, input.caret.top - input.margin,
+			input.caret.right + input.margin, input.caret.bottom + input.margin
+		};
+		best.overlap = Detail::OverlapArea(Geometry::MakeRect(home, size), avoid);
+		if (!best.overlap) { return best; }
+
+		// Above and below the caret keep the column next to the tab; beside it does not
+		const Geometry::Point candidates[] = {
+			current,
+			{ current.x, avoid.top - size.cy },
+			{ current.x, avoid.bottom },
+			{ avoid.left - size.cx, home.y },
+			{ avoid.right, home.y },
+		};
+
+		auto Distance = [&](const Geometry::Point& pt) {
+			return std::labs(pt.x - current.x) + std::labs(pt.y - current.y);
+			};
+
+		for (const Geometry::Point& candidate : candidates) {
+			const Geometry::Point pt = Geometry::ClampToBounds(candidate, size, input.workArea);
+			const long overlap = Detail::OverlapArea(Geometry::MakeRect(pt, size), avoid);
+
+			// Least overlap first, then staying in the column, then the shortest move
+			const bool isSideways = pt.x != current.x;
+			const bool isBestSideways = best.osk.x != current.x;
+			const bool isBetter = overlap != best.overlap ? overlap < best.overlap
+				: isSideways != isBestSideways ? !isSideways
+				: Distance(pt) < Distance(best.osk);
+			if (isBetter) {
+				best = { pt, overlap, pt != current, false };
+			}
+		}
+		return best;
+	}
+
+
+
+	// Lets caret updates through at most once per frame
+	class FrameThrottle
+	{
+	private:
+		uint32_t frameMs{};
+		uint64_t lastMs{};
+		bool hasRun{};
+		bool isPending{};
+
+	public:
+		explicit FrameThrottle(uint32_t frameDurationMs = 16) :
+			frameMs{ frameDurationMs }
+		{}
+
+		/// Notes an update; returns true if the caller must arm a frame wakeup
+		bool Post()
+		{
+			if (isPending) { return false; }
+			isPending = true;
+			return true;
+		}
+
+		/// Returns how long the pending update must still wait (0 when due)
+		uint32_t GetDelay(uint64_t nowMs) const
+		{
+			if (!hasRun or nowMs >= lastMs + frameMs) { return 0; }
+			return uint32_t(lastMs + frameMs - nowMs);
+		}
+
+		/// Takes the pending update if a frame has passed since the last one
+		bool Take(uint64_t nowMs)
+		{
+			if (!isPending or GetDelay(nowMs)) { return false; }
+			isPending = false;
+			hasRun = true;
+			lastMs = nowMs;
+			return true;
+		}
+
+		bool IsPending() const { return isPending; }
+		uint32_t GetFrameMs() const { return frameMs; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	OskPlacement::Input input{};
+	input.caret = caretRect;                    // Screen coordinates
+	input.osk = oskRect;
+	input.tab = tabRect;
+	input.workArea = workArea;
+
+	const OskPlacement::Placement placement = OskPlacement::Solve(input);
+	if (placement.isMoved) { AnimateOskTo(placement.osk); }
+
+	// Caret events
+	if (throttle.Post()) { ArmFrameTimer(throttle.GetDelay(NowMs())); }
+	// Frame timer
+	if (throttle.Take(NowMs())) { Solve... }
+
+*/
@@ -0,0 +1,210 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+
+
+// Short-horizon pointer position predictor.
+// Fits a least-squares velocity over the most recent input samples and
+// extrapolates it a few milliseconds ahead, so a dragged window lands where
+// the pointer will be when the compositor presents the frame. Deceleration
+// and direction reversal damp the prediction; the offset is hard-capped.
+class PointerPredictor
+{
+public:
+	// Input sample (screen pixels, millisecond timestamps that may wrap)
+	struct Sample
+	{
+		long x{};
+		long y{};
+		uint32_t time{};
+	};
+
+	// Offset to add to the latest sample
+	struct Offset
+	{
+		long dx{};
+		long dy{};
+	};
+
+	// Tuning parameters
+	struct Config
+	{
+		uint32_t horizonMs{ 16 };     // How far ahead to predict
+		uint32_t windowMs{ 48 };      // Age of the oldest sample used for the fit
+		uint32_t staleMs{ 40 };       // No prediction once input is this old
+		size_t minSamples{ 3 };       // Samples needed before predicting
+		double damping{ 0.75 };       // 0 = ignore deceleration, 1 = follow it fully
+		double maxOffset{ 48.0 };     // Hard cap on the predicted offset (pixels)
+	};
+
+private:
+	static constexpr size_t Capacity = 16;
+
+	Config config{};
+	std::array<Sample, Capacity> samples{};  // Ring buffer, oldest first from `head`
+	size_t head{};
+	size_t count{};
+
+private:
+	// Signed difference of wrapping millisecond timestamps
+	static int32_t Elapsed(uint32_t from, uint32_t to)
+	{
+		return int32_t(to - from);
+	}
+
+	const Sample& At(size_t index) const
+	{
+		return samples[(head + index) % Capacity];
+	}
+
+	// Least-squares velocity (pixels per ms) over samples [first, last]
+	bool FitVelocity(size_t first, size_t last, double* pVx, double* pVy) const
+	{
+		const size_t n = last - first + 1;
+		if (n < 2) { return false; }
+
+		const uint32_t origin = At(last).time;
+		double sumT{}, sumX{}, sumY{}, sumTT{}, sumTX{}, sumTY{};
+
+		for (size_t i = first; i <= last; ++i) {
+			const double t = Elapsed(origin, At(i).time);
+			const double x = double(At(i).x - At(last).x);
+			const double y = double(At(i).y - At(last).y);
+			sumT += t;
+			sumX += x;
+			sumY += y;
+			sumTT += t * t;
+			sumTX += t * x;
+			sumTY += t * y;
+		}
+
+		const double denom = double(n) * sumTT - sumT * sumT;
+		if (denom <= 0.0) { return false; }
+
+		*pVx = (double(n) * sumTX - sumT * sumX) / denom;
+		*pVy = (double(n) * sumTY - sumT * sumY) / denom;
+		return true;
+	}
+
+public:
+	PointerPredictor() = default;
+
+	explicit PointerPredictor(const Config& cfg) :
+		config{ cfg }
+	{}
+
+	// Drops all samples (call at drag start and end)
+	void Reset()
+	{
+		head = 0;
+		count = 0;
+	}
+
+	// Replaces the tuning parameters
+	void SetConfig(const Config& cfg)
+	{
+		config = cfg;
+	}
+
+	const Config& GetConfig() const
+	{
+		return config;
+	}
+
+	// Adds a sample; out-of-order and duplicate timestamps are ignored
+	void AddSample(const Sample& sample)
+	{
+		if (count and Elapsed(At(count - 1).time, sample.time) <= 0) { return; }
+
+		if (count == Capacity) {
+			head = (head + 1) % Capacity;
+			--count;
+		}
+		samples[(head + count) % Capacity] = sample;
+		++count;
+	}
+
+	// Returns the timestamp of the newest sample (0 if none)
+	uint32_t GetLastTime() const
+	{
+		return count ? At(count - 1).time : 0;
+	}
+
+	// Predicts the offset from the newest sample to the pointer position
+	// `horizonMs` after `nowMs`
+	Offset Predict(uint32_t nowMs) const
+	{
+		if (count < std::max<size_t>(config.minSamples, 2)) { return {}; }
+
+		const Sample& latest = At(count - 1);
+		const int32_t age = Elapsed(latest.time, nowMs);
+		if (age < 0 or uint32_t(age) > config.staleMs) { return {}; }
+
+		// Oldest sample still inside the fit window
+		size_t first = count - 1;
+		while (first > 0 and
+			uint32_t(Elapsed(At(first - 1).time, latest.time)) <= config.windowMs)
+		{
+			--first;
+		}
+		if (count - first < config.minSamples) { return {}; }
+
+		double vx{}, vy{};
+		if (!FitVelocity(first, count - 1, &vx, &vy)) { return {}; }
+
+		// Compare the newest half of the window with the whole to detect slowing
+		double factor = 1.0;
+		const size_t mid = first + (count - first) / 2;
+		double rvx{}, rvy{};
+		if (count - 1 - mid >= 1 and FitVelocity(mid, count - 1, &rvx, &rvy)) {
+			const double speed = std::hypot(vx, vy);
+			const double recentSpeed = std::hypot(rvx, rvy);
+
+			if (rvx * vx + rvy * vy <= 0.0) {
+				factor = 0.0;  // Direction reversal: predicting would overshoot
+			}
+			else if (speed > 0.0 and recentSpeed < speed) {
+				const double ratio = recentSpeed / speed;
+				factor = 1.0 - config.damping * (1.0 - ratio);
+			}
+		}
+
+		const double lead = double(age) + double(config.horizonMs);
+		double dx = vx * lead * factor;
+		double dy = vy * lead * factor;
+
+		// Hard cap keeps a mispredicted flick from throwing the window
+		const double length = std::hypot(dx, dy);
+		if (length > config.maxOffset and length > 0.0) {
+			dx *= config.maxOffset / length;
+			dy *= config.maxOffset / length;
+		}
+
+		return { std::lround(dx), std::lround(dy) };
+	}
+
+};
+
+
+
+
+/*
+Usage example:
+
+	static PointerPredictor predictor{};
+
+	// Drag start
+	predictor.Reset();
+
+	// Each input sample
+	predictor.AddSample({ x, y, timeMs });
+	PointerPredictor::Offset offset = predictor.Predict(nowMs);
+	MoveWindowTo(x + offset.dx, y + offset.dy);
+
+*/
@@ -0,0 +1,204 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+
+
+
+// Power and QoS policy shared by TabTap and the hook.
+// Platform notifications (display, power source, battery saver, session lock,
+// fullscreen apps) and user activity (drags, animations) feed a small state machine; the
+// resulting Decision says whether periodic work may run, how often the
+// topmost refresh fires and which QoS level the process should use.
+namespace Power
+{
+	// Process scheduling level, lowest first
+	enum class Qos : uint8_t
+	{
+		Eco,        // EcoQoS and idle priority
+		Normal,     // Default scheduling
+		High        // Raised priority, no throttling
+	};
+
+	// User-visible work that needs responsive scheduling (bit flags)
+	enum class Activity : uint32_t
+	{
+		Drag = 1 << 0,        // Window drag in progress
+		Snap = 1 << 1,        // Edge snap drag in progress
+		Animation = 1 << 2    // Position animation running
+	};
+
+	// Policy output
+	struct Decision
+	{
+		bool isVisible{};          // Someone can see the UI
+		bool isHidden{};           // Window steps aside for a fullscreen app
+		bool allowPeriodic{};      // Timers, blink and animation loops may run
+		uint32_t keepOnTopMs{};    // Topmost refresh period (0 = stopped)
+		Qos qos{};
+
+		bool operator==(const Decision& other) const
+		{
+			return isVisible == other.isVisible and isHidden == other.isHidden and allowPeriodic == other.allowPeriodic and
+				keepOnTopMs == other.keepOnTopMs and qos == other.qos;
+		}
+		bool operator!=(const Decision& other) const { return !(*this == other); }
+	};
+
+	// Tuning parameters
+	struct Config
+	{
+		uint32_t keepOnTopMs{ 5000 };          // Topmost refresh on AC power
+		uint32_t keepOnTopBatteryMs{ 15000 };  // Topmost refresh on battery
+		Qos idleQos{ Qos::Eco };               // Visible but idle (the OSK keeps Normal)
+		Qos activeQos{ Qos::High };            // During an activity
+	};
+
+
+
+	class PowerPolicy
+	{
+	private:
+		Config config{};
+		bool isDisplayOn{ true };
+		bool isSessionLocked{};
+		bool isOnBattery{};
+		bool isBatterySaver{};
+		bool isWindowShown{ true };     // Owner window itself is showing
+		bool isFullscreen{};            // Fullscreen app or presentation in front
+		uint32_t activities{};          // Activity bits
+		Decision applied{};             // Last decision handed out by TakeChange
+		bool hasApplied{};
+
+	public:
+		PowerPolicy() = default;
+
+		explicit PowerPolicy(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		// --- Inputs ---
+		void SetDisplayOn(bool on) { isDisplayOn = on; }
+		void SetSessionLocked(bool locked) { isSessionLocked = locked; }
+		void SetOnBattery(bool battery) { isOnBattery = battery; }
+		void SetBatterySaver(bool saver) { isBatterySaver = saver; }
+		void SetWindowShown(bool shown) { isWindowShown = shown; }
+		void SetFullscreen(bool fullscreen) { isFullscreen = fullscreen; }
+
+		void BeginActivity(Activity activity) { activities |= uint32_t(activity); }
+		void EndActivity(Activity activity) { activities &= ~uint32_t(activity); }
+		bool IsActive() const { return activities != 0; }
+
+		// Computes the decision for the current inputs
+		Decision Evaluate() const
+		{
+			Decision decision{};
+			decision.isHidden = isFullscreen;
+			decision.isVisible = isDisplayOn and !isSessionLocked and isWindowShown and !isFullscreen;
+			decision.allowPeriodic = decision.isVisible;
+
+			if (!decision.isVisible) {
+				decision.keepOnTopMs = 0;
+				decision.qos = Qos::Eco;
+				return decision;
+			}
+
+			const bool isSaving = isOnBattery or isBatterySaver;
+			decision.keepOnTopMs = isSaving ? config.keepOnTopBatteryMs : config.keepOnTopMs;
+
+			if (activities) {
+				// Battery saver caps the boost at normal scheduling
+				decision.qos = (isBatterySaver and config.activeQos > Qos::Normal) ?
+					Qos::Normal : config.activeQos;
+			}
+			else {
+				decision.qos = config.idleQos;
+			}
+			return decision;
+		}
+
+		// Returns true with the new decision if it differs from the last one taken
+		bool TakeChange(Decision* pDecision)
+		{
+			const Decision decision = Evaluate();
+			if (hasApplied and decision == applied) { return false; }
+
+			applied = decision;
+			hasApplied = true;
+			*pDecision = decision;
+			return true;
+		}
+
+		// Last decision returned by TakeChange
+		const Decision& GetApplied() const
+		{
+			return applied;
+		}
+	};
+
+
+
+	// Wakeups and CPU time normalized to one hour
+	class UsageMeter
+	{
+	public:
+		struct Report
+		{
+			uint64_t elapsedMs{};
+			uint64_t wakeups{};
+			double wakeupsPerHour{};
+			double cpuMsPerHour{};
+		};
+
+	private:
+		uint64_t startMs{};
+		uint64_t startCpuMs{};
+		uint64_t wakeups{};
+
+	public:
+		// Starts a new measurement window
+		void Reset(uint64_t nowMs, uint64_t cpuMs)
+		{
+			startMs = nowMs;
+			startCpuMs = cpuMs;
+			wakeups = 0;
+		}
+
+		// Counts one self-scheduled wakeup (timer tick, posted loop message)
+		void RecordWakeup()
+		{
+			++wakeups;
+		}
+
+		Report GetReport(uint64_t nowMs, uint64_t cpuMs) const
+		{
+			Report report{};
+			report.elapsedMs = nowMs - startMs;
+			report.wakeups = wakeups;
+			if (report.elapsedMs) {
+				const double hours = double(report.elapsedMs) / 3600000.0;
+				report.wakeupsPerHour = double(wakeups) / hours;
+				report.cpuMsPerHour = double(cpuMs - startCpuMs) / hours;
+			}
+			return report;
+		}
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	Power::PowerPolicy policy{};
+
+	policy.SetDisplayOn(false);                   // From a display notification
+	policy.BeginActivity(Power::Activity::Drag);  // Drag starts
+
+	Power::Decision decision{};
+	if (policy.TakeChange(&decision)) {
+		// Restart or stop timers, apply decision.qos
+	}
+
+*/
@@ -0,0 +1,384 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+
+// Layered window rendering split into three steps: create a surface, compose
+// a frame into it and present it at a screen position. TabTap picks a
+// GDI+ or a direct DIB backend; the headless backend below keeps frames in
+// memory so the same frames can be checked and timed without a window.
+namespace Render
+{
+	enum class BackendKind
+	{
+		GdiPlus,     // GDI+ DrawImage into a DIB section, then UpdateLayeredWindow
+		Dib,         // Software compositor writing the DIB section directly
+		Headless     // Software compositor into memory, nothing shown
+	};
+
+	inline const char* GetBackendName(BackendKind kind)
+	{
+		switch (kind)
+		{
+		case BackendKind::GdiPlus:    return "gdiplus";
+		case BackendKind::Dib:        return "dib";
+		case BackendKind::Headless:   return "headless";
+		default:                      return "?";
+		}
+	}
+
+	// Parses a backend name; returns false and keeps the value if unknown
+	inline bool ParseBackendName(const char* pszName, BackendKind* pKind)
+	{
+		for (BackendKind kind : { BackendKind::GdiPlus, BackendKind::Dib, BackendKind::Headless }) {
+			if (std::strcmp(pszName, GetBackendName(kind)) == 0) {
+				*pKind = kind;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 0xAARRGGBB, premultiplied (memory order B, G, R, A as in a 32-bit DIB)
+	using Pixel = uint32_t;
+
+	constexpr Pixel MakeOpaque(uint8_t r, uint8_t g, uint8_t b)
+	{
+		return 0xff000000u | (Pixel(r) << 16) | (Pixel(g) << 8) | Pixel(b);
+	}
+
+	// Read-only pixel rectangle (stride in pixels)
+	struct ImageView
+	{
+		const Pixel* pPixels{};
+		long width{};
+		long height{};
+		long stride{};
+
+		const Pixel* Row(long y) const { return pPixels + size_t(y) * size_t(stride); }
+	};
+
+	// Writable pixel rectangle (stride in pixels)
+	struct SurfaceView
+	{
+		Pixel* pPixels{};
+		long width{};
+		long height{};
+		long stride{};
+
+		Pixel* Row(long y) const { return pPixels + size_t(y) * size_t(stride); }
+		ImageView View() const { return { pPixels, width, height, stride }; }
+	};
+
+	// Read-only 8-bit coverage rectangle, e.g. glyphs (stride in bytes)
+	struct MaskView
+	{
+		const uint8_t* pCoverage{};
+		long width{};
+		long height{};
+		long stride{};
+
+		const uint8_t* Row(long y) const { return pCoverage + size_t(y) * size_t(stride); }
+	};
+
+	// 5x5 colour transform on [r g b a 1] row vectors (same layout as Gdiplus::ColorMatrix)
+	struct ColorMatrix
+	{
+		float m[5][5];
+	};
+
+	constexpr ColorMatrix IdentityMatrix{ {
+		{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 0.0f, 1.0f }
+	} };
+
+	inline bool IsIdentity(const ColorMatrix& matrix)
+	{
+		for (int row{}; row < 5; ++row) {
+			for (int col{}; col < 5; ++col) {
+				if (matrix.m[row][col] != IdentityMatrix.m[row][col]) { return false; }
+			}
+		}
+		return true;
+	}
+
+	enum class LayerKind
+	{
+		Image,       // Copy of an image strip, optionally mirrored and recoloured
+		Rectangle    // Frame of `frameThickness`, filled unless `isHollow`
+	};
+
+	// What one frame shows; the surface is transparent before it is drawn
+	struct Layer
+	{
+		LayerKind kind{};
+
+		// --- Image ---
+		ImageView image{};
+		long srcLeft{};                  // Image column drawn at the surface's left edge
+		bool isMirrored{};               // Flip horizontally (right-edge tab)
+		const ColorMatrix* pMatrix{};    // Colour transform, or nullptr
+
+		// --- Rectangle ---
+		Pixel frameColor{};
+		Pixel fillColor{};
+		long frameThickness{};
+		bool isHollow{};
+	};
+
+	// Image layer showing the tab strip for its expansion state and edge
+	inline Layer MakeTabLayer(const ImageView& image, const Geometry::Size& size,
+		bool isExpanded, bool isMirrored, const ColorMatrix* pMatrix)
+	{
+		Layer layer{};
+		layer.kind = LayerKind::Image;
+		layer.image = image;
+		layer.srcLeft = isExpanded ? 0 : image.width - size.cx;
+		layer.isMirrored = isMirrored;
+		layer.pMatrix = pMatrix;
+		return layer;
+	}
+
+
+
+	// --- Software compositor (Dib and Headless backends) ---
+
+	namespace Detail
+	{
+		inline uint8_t ClampChannel(float value)
+		{
+			return uint8_t(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		// Unpremultiplies, transforms and premultiplies one pixel (the GDI+ order)
+		inline Pixel TransformPixel(Pixel pixel, const ColorMatrix& matrix)
+		{
+			const float a = float(pixel >> 24) / 255.0f;
+			float in[5]{ 0.0f, 0.0f, 0.0f, a, 1.0f };
+			if (a > 0.0f) {
+				in[0] = float((pixel >> 16) & 0xff) / 255.0f / a;
+				in[1] = float((pixel >> 8) & 0xff) / 255.0f / a;
+				in[2] = float(pixel & 0xff) / 255.0f / a;
+			}
+
+			float out[4]{};
+			for (int col{}; col < 4; ++col) {
+				for (int row{}; row < 5; ++row) {
+					out[col] += in[row] * matrix.m[row][col];
+				}
+			}
+
+			// Clamp before premultiplying so no channel ends up above alpha
+			const uint8_t alpha = ClampChannel(out[3]);
+			const float scale = float(alpha) / 255.0f;
+			return (Pixel(alpha) << 24) |
+				(Pixel(ClampChannel(std::clamp(out[0], 0.0f, 1.0f) * scale)) << 16) |
+				(Pixel(ClampChannel(std::clamp(out[1], 0.0f, 1.0f) * scale)) << 8) |
+				Pixel(ClampChannel(std::clamp(out[2], 0.0f, 1.0f) * scale));
+		}
+
+		inline void ComposeImage(const SurfaceView& target, const Layer& layer)
+		{
+			const ImageView& image = layer.image;
+			const bool isPlain = !layer.pMatrix or IsIdentity(*layer.pMatrix);
+			const long rows = std::min(target.height, image.height);
+
+			for (long y{}; y < rows; ++y) {
+				const Pixel* pSrc = image.Row(y);
+				Pixel* pDst = target.Row(y);
+
+				for (long x{}; x < target.width; ++x) {
+					const long srcX = layer.srcLeft + (layer.isMirrored ? target.width - 1 - x : x);
+					if (srcX < 0 or srcX >= image.width) { continue; }
+
+					pDst[x] = isPlain ? pSrc[srcX] : TransformPixel(pSrc[srcX], *layer.pMatrix);
+				}
+			}
+		}
+
+		// Scales all four channels of a premultiplied pixel by factor/255
+		inline Pixel ScalePixel(Pixel pixel, uint32_t factor)
+		{
+			const uint32_t rb = ((pixel & 0x00ff00ffu) * factor + 0x00800080u);
+			const uint32_t ag = (((pixel >> 8) & 0x00ff00ffu) * factor + 0x00800080u);
+			return (((rb + ((rb >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu) |
+				((ag + ((ag >> 8) & 0x00ff00ffu)) & 0xff00ff00u);
+		}
+
+		inline void ComposeRectangle(const SurfaceView& target, const Layer& layer)
+		{
+			const long t = std::min({ layer.frameThickness, target.width / 2, target.height / 2 });
+
+			for (long y{}; y < target.height; ++y) {
+				Pixel* pDst = target.Row(y);
+				const bool isFrameRow = y < t or y >= target.height - t;
+
+				for (long x{}; x < target.width; ++x) {
+					if (isFrameRow or x < t or x >= target.width - t) {
+						pDst[x] = layer.frameColor;
+					}
+					else if (!layer.isHollow) {
+						pDst[x] = layer.fillColor;
+					}
+				}
+			}
+		}
+	}
+
+	// Clears the surface to transparent and draws the layer
+	inline void Compose(const SurfaceView& target, const Layer& layer)
+	{
+		for (long y{}; y < target.height; ++y) {
+			std::memset(target.Row(y), 0, size_t(target.width) * sizeof(Pixel));
+		}
+
+		if (layer.kind == LayerKind::Image) {
+			Detail::ComposeImage(target, layer);
+		}
+		else {
+			Detail::ComposeRectangle(target, layer);
+		}
+	}
+
+	// Draws a coverage mask in a premultiplied colour over the surface
+	// (source over), clipped to the surface; `at` is the mask's top-left
+	inline void BlendMask(const SurfaceView& target, const MaskView& mask, const Geometry::Point& at, Pixel color)
+	{
+		const long left = std::max(0L, -at.x);
+		const long top = std::max(0L, -at.y);
+		const long right = std::min(mask.width, target.width - at.x);
+		const long bottom = std::min(mask.height, target.height - at.y);
+
+		for (long y{ top }; y < bottom; ++y) {
+			const uint8_t* pCoverage = mask.Row(y);
+			Pixel* pDst = target.Row(at.y + y) + at.x;
+
+			for (long x{ left }; x < right; ++x) {
+				const uint32_t coverage = pCoverage[x];
+				if (!coverage) { continue; }
+
+				const Pixel src = coverage == 0xff ? color : Detail::ScalePixel(color, coverage);
+				pDst[x] = src + Detail::ScalePixel(pDst[x], 0xff - (src >> 24));
+			}
+		}
+	}
+
+	// FNV-1a over the visible pixels (compares frames across backends and builds)
+	inline uint32_t HashPixels(const ImageView& image)
+	{
+		uint32_t hash = 2166136261u;
+		for (long y{}; y < image.height; ++y) {
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(image.Row(y));
+			for (size_t i{}; i < size_t(image.width) * sizeof(Pixel); ++i) {
+				hash = (hash ^ p[i]) * 16777619u;
+			}
+		}
+		return hash;
+	}
+
+
+
+	// Renderer used by DrawContext and EdgeSnapData
+	class IBackend
+	{
+	public:
+		virtual ~IBackend() = default;
+
+		/// Returns which backend this is
+		virtual BackendKind GetKind() const = 0;
+		/// Prepares a back buffer (kept while the size is unchanged)
+		virtual bool CreateSurface(const Geometry::Size&) = 0;
+		/// Draws one layer over a transparent back buffer
+		virtual bool Compose(const Layer&) = 0;
+		/// Blends a coverage mask in a colour over the composed back buffer
+		virtual bool BlendMask(const MaskView&, const Geometry::Point&, Pixel color) = 0;
+		/// Shows the back buffer with its top-left corner at a screen position
+		virtual bool Present(const Geometry::Point&, uint8_t opacity) = 0;
+		/// Returns the platform error code of the last failed call
+		virtual uint32_t GetErrorCode() const = 0;
+	};
+
+
+
+	// Keeps frames in memory; Present records where they would appear
+	class HeadlessBackend : public IBackend
+	{
+	private:
+		std::vector<Pixel> pixels{};
+		Geometry::Size size{};
+		Geometry::Point position{};      // Last presented position
+		uint8_t opacity{};               // Last presented opacity
+		uint64_t presentCount{};
+
+	public:
+		BackendKind GetKind() const override { return BackendKind::Headless; }
+
+		bool CreateSurface(const Geometry::Size& surfaceSize) override
+		{
+			if (surfaceSize.cx <= 0 or surfaceSize.cy <= 0) { return false; }
+			if (surfaceSize != size) {
+				pixels.assign(size_t(surfaceSize.cx) * size_t(surfaceSize.cy), 0);
+				size = surfaceSize;
+			}
+			return true;
+		}
+
+		bool Compose(const Layer& layer) override
+		{
+			if (pixels.empty()) { return false; }
+			Render::Compose({ pixels.data(), size.cx, size.cy, size.cx }, layer);
+			return true;
+		}
+
+		bool BlendMask(const MaskView& mask, const Geometry::Point& at, Pixel color) override
+		{
+			if (pixels.empty()) { return false; }
+			Render::BlendMask({ pixels.data(), size.cx, size.cy, size.cx }, mask, at, color);
+			return true;
+		}
+
+		bool Present(const Geometry::Point& pt, uint8_t alpha) override
+		{
+			if (pixels.empty()) { return false; }
+			position = pt;
+			opacity = alpha;
+			++presentCount;
+			return true;
+		}
+
+		uint32_t GetErrorCode() const override { return 0; }
+
+		// --- Inspection ---
+		ImageView GetPixels() const { return { pixels.data(), size.cx, size.cy, size.cx }; }
+		const Geometry::Point& GetPosition() const { return position; }
+		uint8_t GetOpacity() const { return opacity; }
+		uint64_t GetPresentCount() const { return presentCount; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	Render::HeadlessBackend backend{};
+	backend.CreateSurface({ 28, 95 });
+	backend.Compose(Render::MakeTabLayer(image, { 28, 95 }, true, false, nullptr));
+	backend.Present({ 0, 400 }, 0xff);
+
+	uint32_t hash = Render::HashPixels(backend.GetPixels());
+
+*/
@@ -0,0 +1,257 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+
+
+// Session recording layout shared by TabTap and the offline Replay tool.
+// A file is a FileHeader followed by records. Event records carry the tab
+// window's input in portable form; Environment records are written before an
+// event whenever the work area, screen or OSK state differs from the last one.
+namespace Replay
+{
+	constexpr uint32_t FileMagic = 0x50525454;   // 'TTRP'
+	constexpr uint32_t FileVersion = 1;
+
+	// Recorded window messages (platform-neutral ids)
+	enum class Message : uint16_t
+	{
+		MouseMove = 1,
+		MouseLeave,
+		LButtonDown,
+		LButtonUp,
+		RButtonDown,
+		RButtonUp,
+		RButtonDblClk,
+		MButtonDown,
+		MButtonUp,
+		SettingChange,   // detail: SettingKind
+		SyncPosition     // ID_APP_SYNC_Y_POSITION
+	};
+
+	enum class SettingKind : uint8_t
+	{
+		WorkArea,        // Work area, taskbar or an unnamed setting
+		Theme,           // "ImmersiveColorSet"
+		Ignored          // A setting the tab does not read
+	};
+
+	enum class RecordType : uint16_t
+	{
+		Event = 1,
+		Environment = 2
+	};
+
+#pragma pack(push, 1)
+	struct Rect32
+	{
+		int32_t left{};
+		int32_t top{};
+		int32_t right{};
+		int32_t bottom{};
+	};
+
+	struct FileHeader
+	{
+		uint32_t magic{};
+		uint32_t version{};
+		Rect32 tabRect{};            // Tab window at the start of the session
+		uint8_t edge{};              // TabLayout::Edge
+		uint8_t isExpanded{};
+		uint8_t isLinkedDrag{};
+		uint8_t hasSkin{};           // Skin frames redraw on press and release
+	};
+
+	struct RecordHeader
+	{
+		uint16_t type{};             // RecordType
+		uint16_t size{};             // Payload bytes following this header
+	};
+
+	struct EventRecord
+	{
+		uint64_t time{};             // Nanoseconds since the session started
+		uint16_t message{};          // Message
+		uint8_t depth{};             // 0 = from the queue, 1+ = sent by an outer handler
+		uint8_t detail{};            // Message-specific value
+		int32_t x{};                 // Cursor in screen coordinates
+		int32_t y{};
+	};
+
+	struct EnvironmentRecord
+	{
+		Rect32 workArea{};
+		Rect32 oskRect{};
+		int32_t screenWidth{};
+		int32_t screenHeight{};
+		uint8_t isOskVisible{};
+		uint8_t reserved[3]{};
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(FileHeader) == 28, "Unexpected FileHeader layout");
+	static_assert(sizeof(EventRecord) == 20, "Unexpected EventRecord layout");
+	static_assert(sizeof(EnvironmentRecord) == 44, "Unexpected EnvironmentRecord layout");
+
+	inline Rect32 ToRect32(const Geometry::Rect& rc)
+	{
+		return { int32_t(rc.left), int32_t(rc.top), int32_t(rc.right), int32_t(rc.bottom) };
+	}
+
+	inline Geometry::Rect FromRect32(const Rect32& rc)
+	{
+		return { rc.left, rc.top, rc.right, rc.bottom };
+	}
+
+	// Work area, screen and OSK state seen by the tab window
+	struct Environment
+	{
+		Geometry::Rect workArea{};
+		Geometry::Rect oskRect{};
+		Geometry::Size screen{};
+		bool isOskVisible{};
+
+		bool operator==(const Environment& other) const
+		{
+			return workArea == other.workArea and oskRect == other.oskRect and
+				screen == other.screen and isOskVisible == other.isOskVisible;
+		}
+		bool operator!=(const Environment& other) const { return !(*this == other); }
+	};
+
+
+
+	// Window procedure nesting depth on the calling thread
+	inline uint8_t& Depth()
+	{
+		thread_local uint8_t depth{};
+		return depth;
+	}
+
+	// Marks one window procedure invocation (declare at the top of the procedure)
+	struct NestingGuard
+	{
+		NestingGuard() { ++Depth(); }
+		~NestingGuard() { --Depth(); }
+		NestingGuard(const NestingGuard&) = delete;
+		NestingGuard& operator=(const NestingGuard&) = delete;
+	};
+
+
+
+	// Appends a session to a file (UI thread only)
+	class Writer
+	{
+	private:
+		std::ofstream stream{};
+		std::chrono::steady_clock::time_point origin{};
+		Environment environment{};       // Last environment written
+		bool hasEnvironment{};
+
+	private:
+		void WriteRecord(RecordType type, const void* pPayload, uint16_t size)
+		{
+			const RecordHeader header{ uint16_t(type), size };
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(static_cast<const char*>(pPayload), size);
+		}
+
+	public:
+		~Writer() { Close(); }
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		// Starts a new session file with the initial tab state
+		bool Open(const std::filesystem::path& path, const Geometry::Rect& tabRect,
+			uint8_t edge, bool isExpanded, bool isLinkedDrag, bool hasSkin)
+		{
+			Close();
+
+			stream.open(path, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) { return false; }
+
+			FileHeader header{};
+			header.magic = FileMagic;
+			header.version = FileVersion;
+			header.tabRect = ToRect32(tabRect);
+			header.edge = edge;
+			header.isExpanded = isExpanded;
+			header.isLinkedDrag = isLinkedDrag;
+			header.hasSkin = hasSkin;
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			origin = std::chrono::steady_clock::now();
+			hasEnvironment = false;
+			return bool(stream);
+		}
+
+		void Close()
+		{
+			if (stream.is_open()) { stream.close(); }
+		}
+
+		bool IsOpen() const
+		{
+			return stream.is_open();
+		}
+
+		// Writes the environment if it changed since the last call
+		void WriteEnvironment(const Environment& env)
+		{
+			if (!stream.is_open() or (hasEnvironment and env == environment)) { return; }
+
+			EnvironmentRecord record{};
+			record.workArea = ToRect32(env.workArea);
+			record.oskRect = ToRect32(env.oskRect);
+			record.screenWidth = int32_t(env.screen.cx);
+			record.screenHeight = int32_t(env.screen.cy);
+			record.isOskVisible = env.isOskVisible;
+			WriteRecord(RecordType::Environment, &record, sizeof(record));
+
+			environment = env;
+			hasEnvironment = true;
+		}
+
+		// Writes one event stamped with the current time and nesting depth
+		void WriteEvent(Message message, const Geometry::Point& cursor, uint8_t detail = 0)
+		{
+			if (!stream.is_open()) { return; }
+
+			EventRecord record{};
+			record.time = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - origin).count());
+			record.message = uint16_t(message);
+			record.depth = Depth() ? uint8_t(Depth() - 1) : 0;
+			record.detail = detail;
+			record.x = int32_t(cursor.x);
+			record.y = int32_t(cursor.y);
+			WriteRecord(RecordType::Event, &record, sizeof(record));
+		}
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	Replay::Writer writer{};
+	writer.Open("TabTap.replay", tabRect, edge, false, false, false);
+
+	LRESULT CALLBACK WindowProc(...)
+	{
+		Replay::NestingGuard nesting{};
+		writer.WriteEnvironment(env);
+		writer.WriteEvent(Replay::Message::MouseMove, cursor);
+	}
+
+*/
@@ -0,0 +1,335 @@
+#pragma once
+
+// Standard library headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+
+// Handle accounting: owning wrappers report every handle they take and free
+// to a ledger of live counts per kind, and a trend detector watches the
+// process-wide counts sampled over hours for a steady rise. The wrappers
+// only need a traits type that says how to free a handle, so the whole
+// layer runs with fake handles outside Windows.
+namespace Resources
+{
+	enum class Kind : uint8_t
+	{
+		DeviceContext,
+		Bitmap,
+		Pen,
+		Brush,
+		Font,
+		Icon,
+		Window,
+		Count
+	};
+
+	inline const char* GetKindName(Kind kind)
+	{
+		switch (kind)
+		{
+		case Kind::DeviceContext:    return "dc";
+		case Kind::Bitmap:           return "bitmap";
+		case Kind::Pen:              return "pen";
+		case Kind::Brush:            return "brush";
+		case Kind::Font:             return "font";
+		case Kind::Icon:             return "icon";
+		case Kind::Window:           return "window";
+		default:                     return "?";
+		}
+	}
+
+	// Live and total handle counts per kind (any thread)
+	class Ledger
+	{
+	private:
+		struct Counts
+		{
+			std::atomic<int64_t> live{};
+			std::atomic<uint64_t> created{};
+		};
+
+		Counts counts[size_t(Kind::Count)]{};
+
+	public:
+		void OnCreated(Kind kind)
+		{
+			counts[size_t(kind)].live.fetch_add(1, std::memory_order_relaxed);
+			counts[size_t(kind)].created.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void OnDestroyed(Kind kind)
+		{
+			counts[size_t(kind)].live.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		/// Handles of a kind currently owned by wrappers
+		int64_t GetLive(Kind kind) const
+		{
+			return counts[size_t(kind)].live.load(std::memory_order_relaxed);
+		}
+
+		/// Handles of a kind taken since the start
+		uint64_t GetCreated(Kind kind) const
+		{
+			return counts[size_t(kind)].created.load(std::memory_order_relaxed);
+		}
+
+		int64_t GetTotalLive() const
+		{
+			int64_t total{};
+			for (const Counts& entry : counts) { total += entry.live.load(std::memory_order_relaxed); }
+			return total;
+		}
+	};
+
+	// Process-wide ledger used by the wrappers
+	inline Ledger& GetLedger()
+	{
+		static Ledger ledger{};
+		return ledger;
+	}
+
+
+
+	// Owns one handle and accounts for it. Traits provide:
+	//   using Type = ...;                     // Handle type
+	//   static constexpr Kind kind = ...;
+	//   static Type Invalid();                // Value meaning "no handle"
+	//   static void Free(Type);
+	template <typename Traits>
+	class Owned
+	{
+	public:
+		using Type = typename Traits::Type;
+
+	private:
+		Type value{ Traits::Invalid() };
+
+	public:
+		~Owned() { Reset(); }
+		Owned() = default;
+		/// Takes ownership; an invalid handle (failed create) is not counted
+		explicit Owned(Type handle) { Reset(handle); }
+
+		Owned(const Owned&) = delete;
+		Owned& operator=(const Owned&) = delete;
+
+		Owned(Owned&& other) noexcept :
+			value{ std::exchange(other.value, Traits::Invalid()) }
+		{}
+
+		Owned& operator=(Owned&& other) noexcept
+		{
+			if (this != &other) {
+				Reset();
+				value = std::exchange(other.value, Traits::Invalid());
+			}
+			return *this;
+		}
+
+		/// Frees the current handle and takes another
+		void Reset(Type handle = Traits::Invalid())
+		{
+			if (value != Traits::Invalid()) {
+				Traits::Free(value);
+				GetLedger().OnDestroyed(Traits::kind);
+			}
+			value = handle;
+			if (value != Traits::Invalid()) {
+				GetLedger().OnCreated(Traits::kind);
+			}
+		}
+
+		/// Gives up ownership; the handle is no longer counted
+		Type Release()
+		{
+			const Type handle = std::exchange(value, Traits::Invalid());
+			if (handle != Traits::Invalid()) {
+				GetLedger().OnDestroyed(Traits::kind);
+			}
+			return handle;
+		}
+
+		Type Get() const { return value; }
+		explicit operator bool() const { return value != Traits::Invalid(); }
+	};
+
+
+
+	// Spots a steady rise in a sampled handle count. A leak grows with
+	// use and never returns: the fitted slope must exceed the threshold,
+	// the window must have grown overall and its newer half must sit
+	// entirely above the older half's minimum (bursts that fall back do not).
+	class TrendDetector
+	{
+	public:
+		static constexpr size_t MaxSamples = 64;
+
+		struct Config
+		{
+			size_t windowSamples{ 30 };      // Samples fitted (<= MaxSamples)
+			double leakPerHour{ 20.0 };      // Slope that counts as a leak
+			int64_t minGrowth{ 10 };         // Least rise across the window
+		};
+
+		struct Sample
+		{
+			uint64_t timeMs{};
+			int64_t count{};
+		};
+
+	private:
+		Config config{};
+		Sample samples[MaxSamples]{};        // Ring of the newest samples
+		size_t sampleCount{};
+		size_t nextSample{};
+
+	private:
+		size_t GetWindow() const
+		{
+			const size_t window = config.windowSamples < MaxSamples ? config.windowSamples : MaxSamples;
+			return sampleCount < window ? sampleCount : window;
+		}
+
+		// i-th sample of the window, oldest first
+		const Sample& At(size_t i) const
+		{
+			const size_t window = GetWindow();
+			return samples[(nextSample + MaxSamples - window + i) % MaxSamples];
+		}
+
+	public:
+		TrendDetector() = default;
+		explicit TrendDetector(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		void Add(uint64_t timeMs, int64_t count)
+		{
+			samples[nextSample] = { timeMs, count };
+			nextSample = (nextSample + 1) % MaxSamples;
+			if (sampleCount < MaxSamples) { ++sampleCount; }
+		}
+
+		/// Least-squares slope of the window in handles per hour
+		double GetSlopePerHour() const
+		{
+			const size_t window = GetWindow();
+			if (window < 2) { return 0.0; }
+
+			// Centered on the first sample to keep the sums small
+			const double t0 = double(At(0).timeMs);
+			double sumT{}, sumC{}, sumTT{}, sumTC{};
+			for (size_t i{}; i < window; ++i) {
+				const double t = (double(At(i).timeMs) - t0) / 3600000.0;
+				const double c = double(At(i).count);
+				sumT += t;
+				sumC += c;
+				sumTT += t * t;
+				sumTC += t * c;
+			}
+
+			const double n = double(window);
+			const double denominator = n * sumTT - sumT * sumT;
+			if (denominator <= 0.0) { return 0.0; }
+			return (n * sumTC - sumT * sumC) / denominator;
+		}
+
+		/// Checks if the window shows a leak (needs a full window)
+		bool IsLeaking() const
+		{
+			const size_t window = GetWindow();
+			if (window < 4 or window < config.windowSamples) { return false; }
+			if (At(window - 1).count - At(0).count < config.minGrowth) { return false; }
+			if (GetSlopePerHour() < config.leakPerHour) { return false; }
+
+			int64_t olderMin = At(0).count;
+			for (size_t i{ 1 }; i < window / 2; ++i) {
+				if (At(i).count < olderMin) { olderMin = At(i).count; }
+			}
+			for (size_t i{ window / 2 }; i < window; ++i) {
+				if (At(i).count <= olderMin) { return false; }
+			}
+			return true;
+		}
+
+		/// Returns the newest sample (zero before the first)
+		Sample GetLatest() const
+		{
+			return sampleCount ? samples[(nextSample + MaxSamples - 1) % MaxSamples] : Sample{};
+		}
+
+		size_t GetSampleCount() const { return sampleCount; }
+		const Config& GetConfig() const { return config; }
+	};
+
+
+
+	// Soak-test budget: once warmed up, a count may exceed the count it had
+	// at the end of the warmup by `slack` at most
+	class Budget
+	{
+	private:
+		uint64_t warmupMs{};
+		int64_t slack{};
+		uint64_t startMs{};
+		int64_t baseline{};
+		bool isStarted{};
+		bool isBaselined{};
+
+	public:
+		Budget() = default;
+		Budget(uint64_t warmup, int64_t allowed) :
+			warmupMs{ warmup },
+			slack{ allowed }
+		{}
+
+		/// Checks a sample; false once the count is over budget
+		bool Check(uint64_t nowMs, int64_t count)
+		{
+			if (!isStarted) {
+				isStarted = true;
+				startMs = nowMs;
+			}
+			if (!isBaselined) {
+				if (nowMs - startMs < warmupMs) { return true; }
+				isBaselined = true;
+				baseline = count;
+			}
+			return count <= baseline + slack;
+		}
+
+		bool IsBaselined() const { return isBaselined; }
+		int64_t GetBaseline() const { return baseline; }
+		int64_t GetLimit() const { return baseline + slack; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	struct PenTraits
+	{
+		using Type = HPEN;
+		static constexpr Resources::Kind kind = Resources::Kind::Pen;
+		static Type Invalid() { return NULL; }
+		static void Free(Type hPen) { DeleteObject(hPen); }
+	};
+
+	{
+		Resources::Owned<PenTraits> pen{ CreatePen(PS_SOLID, 1, 0) };
+		// ... draw ...
+	}   // Freed; GetLedger().GetLive(Resources::Kind::Pen) is back where it was
+
+	Resources::TrendDetector gdiTrend{};
+	gdiTrend.Add(nowMs, GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS));
+	if (gdiTrend.IsLeaking()) { ... }
+
+*/
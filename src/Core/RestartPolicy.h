@@ -0,0 +1,174 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+
+// Decides when a supervised process is started again after it exits.
+// Restarts back off exponentially; a process that stayed up long enough
+// counts as healthy again and the next crash restarts quickly; a crash loop
+// (too many restarts in a short window) stops the restarts. Times are
+// milliseconds on a caller-supplied clock, so the policy runs unchanged
+// against a fake clock.
+namespace Supervision
+{
+	enum class Verdict : uint8_t
+	{
+		Restart,     // Start again after `delayMs`
+		GiveUp       // Crash loop; leave the process down
+	};
+
+	struct Decision
+	{
+		Verdict verdict{};
+		uint64_t delayMs{};
+		uint32_t attempt{};          // 1 for the first restart after a healthy run
+	};
+
+	inline const char* GetVerdictName(Verdict verdict)
+	{
+		switch (verdict)
+		{
+		case Verdict::Restart:   return "restart";
+		case Verdict::GiveUp:    return "give up";
+		default:                 return "?";
+		}
+	}
+
+	class RestartPolicy
+	{
+	public:
+		static constexpr size_t MaxHistory = 16;
+
+		struct Config
+		{
+			uint32_t initialDelayMs{ 250 };      // First restart after a healthy run
+			uint32_t maxDelayMs{ 30000 };        // Backoff ceiling
+			uint32_t healthyUptimeMs{ 60000 };   // Uptime that resets the backoff
+			uint32_t burstWindowMs{ 300000 };    // Window for counting restarts
+			uint32_t maxBurstRestarts{ 8 };      // More restarts than this in the window give up (<= MaxHistory)
+		};
+
+	private:
+		Config config{};
+		uint32_t attempt{};                  // Restarts since the last healthy run
+		uint64_t startMs{};                  // When the process came up
+		uint64_t exitMs{};                   // When it went down (recovery start)
+		bool isRunning{};
+		bool isRecovering{};
+		bool isGivenUp{};
+		uint64_t history[MaxHistory]{};      // Recent restart times (ring)
+		size_t historyCount{};
+		size_t historyNext{};
+
+	private:
+		size_t CountRecent(uint64_t nowMs) const
+		{
+			size_t count{};
+			for (size_t i{}; i < historyCount; ++i) {
+				if (nowMs - history[i] < config.burstWindowMs) { ++count; }
+			}
+			return count;
+		}
+
+		Decision Schedule(uint64_t nowMs)
+		{
+			if (CountRecent(nowMs) >= std::min<size_t>(config.maxBurstRestarts, MaxHistory)) {
+				isGivenUp = true;
+				isRecovering = false;
+				return { Verdict::GiveUp, 0, attempt };
+			}
+
+			// initial * 2^attempt, capped (the shift is bounded to stay defined)
+			const uint32_t shift = std::min<uint32_t>(attempt, 31);
+			const uint64_t delayMs = std::min<uint64_t>(uint64_t(config.initialDelayMs) << shift, config.maxDelayMs);
+			++attempt;
+
+			history[historyNext] = nowMs;
+			historyNext = (historyNext + 1) % MaxHistory;
+			historyCount = std::min(historyCount + 1, MaxHistory);
+
+			return { Verdict::Restart, delayMs, attempt };
+		}
+
+	public:
+		RestartPolicy() = default;
+		explicit RestartPolicy(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		/// Marks the process as running; returns the recovery time if it was restarted
+		uint64_t OnStarted(uint64_t nowMs)
+		{
+			const uint64_t recoveryMs = isRecovering ? nowMs - exitMs : 0;
+			startMs = nowMs;
+			isRunning = true;
+			isRecovering = false;
+			return recoveryMs;
+		}
+
+		/// Handles an unexpected exit; returns when (or whether) to restart
+		Decision OnExited(uint64_t nowMs)
+		{
+			if (isGivenUp) { return { Verdict::GiveUp, 0, attempt }; }
+
+			if (isRunning and nowMs - startMs >= config.healthyUptimeMs) {
+				attempt = 0;
+			}
+			isRunning = false;
+			if (!isRecovering) {
+				isRecovering = true;
+				exitMs = nowMs;
+			}
+			return Schedule(nowMs);
+		}
+
+		/// Handles a restart that did not bring the process up
+		Decision OnRestartFailed(uint64_t nowMs)
+		{
+			if (isGivenUp) { return { Verdict::GiveUp, 0, attempt }; }
+			return Schedule(nowMs);
+		}
+
+		/// Allows restarts again after a give-up (user asked for the process)
+		void Reset()
+		{
+			const Config kept = config;
+			*this = {};
+			config = kept;
+		}
+
+		/// Checks if the process is down and a restart is pending
+		bool IsRecovering() const { return isRecovering; }
+		/// Checks if restarts were stopped by a crash loop
+		bool IsGivenUp() const { return isGivenUp; }
+		/// Returns the restarts since the last healthy run
+		uint32_t GetAttempt() const { return attempt; }
+		const Config& GetConfig() const { return config; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	static Supervision::RestartPolicy policy{};
+
+	// Process started or restarted
+	uint64_t recoveryMs = policy.OnStarted(NowMs());
+
+	// Process exited
+	Supervision::Decision decision = policy.OnExited(NowMs());
+	if (decision.verdict == Supervision::Verdict::Restart) {
+		SetTimer(hWnd, IDT_RESTART, UINT(decision.delayMs), NULL);
+	}
+
+	// Restart failed
+	decision = policy.OnRestartFailed(NowMs());
+
+*/
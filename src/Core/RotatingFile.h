@@ -0,0 +1,140 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+
+
+// Append-only file capped in size; when full it is renamed to `<name>.1`
+// (older copies shift up to `<name>.<keep>`) and a fresh file is started.
+class RotatingFile
+{
+private:
+	std::filesystem::path path{};    // Active file
+	uint64_t maxBytes{};             // Size that triggers a rotation
+	unsigned keepCount{};            // Rotated copies to keep
+	uint64_t size{};                 // Bytes in the active file
+	std::ofstream stream{};
+
+private:
+	// Path of the n-th rotated copy
+	std::filesystem::path Backup(unsigned index) const
+	{
+		std::filesystem::path backup = path;
+		backup += "." + std::to_string(index);
+		return backup;
+	}
+
+public:
+	~RotatingFile() = default;
+	RotatingFile() = default;
+	RotatingFile(const RotatingFile&) = delete;
+	RotatingFile& operator=(const RotatingFile&) = delete;
+
+	// Opens (appending to) the active file
+	bool Open(const std::filesystem::path& filePath, uint64_t maxFileBytes, unsigned keep)
+	{
+		Close();
+
+		path = filePath;
+		maxBytes = maxFileBytes;
+		keepCount = keep;
+
+		std::error_code ec{};
+		const uintmax_t existing = std::filesystem::file_size(path, ec);
+		size = ec ? 0 : uint64_t(existing);
+
+		stream.open(path, std::ios::binary | std::ios::app);
+		if (stream.is_open() and maxBytes and size >= maxBytes) { return Rotate(); }
+		return stream.is_open();
+	}
+
+	// Appends bytes, rotating first if they would overflow the cap
+	bool Write(const void* pData, size_t length)
+	{
+		if (!stream.is_open()) { return false; }
+
+		if (maxBytes and size and size + length > maxBytes and !Rotate()) {
+			return false;
+		}
+
+		stream.write(static_cast<const char*>(pData), std::streamsize(length));
+		size += length;
+		return bool(stream);
+	}
+
+	bool Write(const std::string& text)
+	{
+		return Write(text.data(), text.size());
+	}
+
+	// Checks if `length` more bytes fit before the next rotation
+	bool Fits(size_t length) const
+	{
+		return !maxBytes or !size or size + length <= maxBytes;
+	}
+
+	// Starts a new active file now (callers that write file headers use this
+	// together with Fits to keep headers at the start of every file)
+	bool Rotate()
+	{
+		std::error_code ec{};
+		stream.close();
+
+		if (keepCount) {
+			std::filesystem::remove(Backup(keepCount), ec);
+			for (unsigned i = keepCount; i > 1; --i) {
+				std::filesystem::rename(Backup(i - 1), Backup(i), ec);
+			}
+			std::filesystem::rename(path, Backup(1), ec);
+		}
+
+		stream.open(path, std::ios::binary | std::ios::trunc);
+		size = 0;
+		return stream.is_open();
+	}
+
+	void Flush()
+	{
+		if (stream.is_open()) { stream.flush(); }
+	}
+
+	void Close()
+	{
+		if (stream.is_open()) { stream.close(); }
+		size = 0;
+	}
+
+	bool IsOpen() const
+	{
+		return stream.is_open();
+	}
+
+	uint64_t GetSize() const
+	{
+		return size;
+	}
+
+	const std::filesystem::path& GetPath() const
+	{
+		return path;
+	}
+};
+
+
+
+
+/*
+Usage example:
+
+	RotatingFile file{};
+	file.Open("TabTap.trace.log", 1024 * 1024, 3);  // TabTap.trace.log.1 ... .3
+	file.Write("started\n");
+	file.Flush();
+
+*/
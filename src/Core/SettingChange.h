@@ -0,0 +1,145 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+
+// WM_SETTINGCHANGE arrives in bursts of dozens (theme switches, logon,
+// display changes), mostly for settings the tab never reads. Classify sorts
+// a notification by its SPI_* action and area string; the Coalescer merges
+// what is left into one deferred pass that runs once the burst has been
+// quiet for a while, or after a ceiling so a steady stream still gets
+// through. Times are milliseconds on a caller-supplied clock.
+namespace Settings
+{
+	// What a notification asks the tab to redo (combinable)
+	enum ChangeFlags : uint8_t
+	{
+		ChangeNone   = 0x00,
+		ChangeTheme  = 0x01,  // Re-apply the light or dark theme
+		ChangeLayout = 0x02   // Re-read the work area, re-snap and redraw
+	};
+
+	// SPI_SETWORKAREA (WinUser.h): the taskbar or an app bar moved
+	constexpr uint32_t SpiSetWorkArea = 0x002F;
+
+	constexpr uint64_t NoDeadline = std::numeric_limits<uint64_t>::max();
+
+	namespace Detail
+	{
+		// ASCII case-insensitive comparison of an area string (char or wchar_t)
+		template <typename Char>
+		inline bool IsArea(const Char* pszArea, const char* pszName)
+		{
+			auto Lower = [](uint32_t ch) { return (ch >= 'A' and ch <= 'Z') ? ch - 'A' + 'a' : ch; };
+
+			for (; *pszArea and *pszName; ++pszArea, ++pszName) {
+				if (Lower(uint32_t(*pszArea)) != Lower(uint32_t(uint8_t(*pszName)))) { return false; }
+			}
+			return !*pszArea and !*pszName;
+		}
+	}
+
+	/// Classifies one WM_SETTINGCHANGE (wParam action, lParam area or nullptr)
+	template <typename Char>
+	inline uint8_t Classify(uint32_t action, const Char* pszArea)
+	{
+		const bool hasArea = pszArea and *pszArea;
+
+		if (hasArea and Detail::IsArea(pszArea, "ImmersiveColorSet")) { return ChangeTheme; }
+		// Taskbar size, position and auto-hide
+		if (hasArea and Detail::IsArea(pszArea, "TraySettings")) { return ChangeLayout; }
+		if (action == SpiSetWorkArea) { return ChangeLayout; }
+		// A bare broadcast names nothing, so it may be anything
+		if (!action and !hasArea) { return ChangeLayout; }
+
+		// Policy, intl, Environment, wallpaper, mouse and keyboard settings...
+		return ChangeNone;
+	}
+
+	class Coalescer
+	{
+	public:
+		struct Config
+		{
+			uint32_t settleMs{ 250 };        // Quiet time that ends a burst
+			uint32_t maxDelayMs{ 2000 };     // Longest a change waits in a steady stream
+		};
+
+	private:
+		Config config{};
+		uint8_t pending{};                   // ChangeFlags waiting for the pass
+		uint32_t merged{};                   // Notifications folded into it
+		uint64_t firstMs{};
+		uint64_t lastMs{};
+
+	public:
+		Coalescer() = default;
+		explicit Coalescer(const Config& cfg) :
+			config{ cfg }
+		{}
+
+		/// Adds a classified notification; returns true if it joined the pending pass
+		bool Add(uint8_t changes, uint64_t nowMs)
+		{
+			if (!changes) { return false; }
+
+			if (!pending) { firstMs = nowMs; }
+			pending |= changes;
+			lastMs = nowMs;
+			++merged;
+			return true;
+		}
+
+		/// Returns when the pending pass is due (NoDeadline when none is)
+		uint64_t GetDeadline() const
+		{
+			if (!pending) { return NoDeadline; }
+			return std::min(lastMs + config.settleMs, firstMs + config.maxDelayMs);
+		}
+
+		/// Takes the merged changes once they are due; ChangeNone otherwise
+		uint8_t Take(uint64_t nowMs, uint32_t* pMerged = nullptr)
+		{
+			if (!pending or nowMs < GetDeadline()) { return ChangeNone; }
+			return Flush(pMerged);
+		}
+
+		/// Takes the merged changes whether due or not
+		uint8_t Flush(uint32_t* pMerged = nullptr)
+		{
+			const uint8_t changes = pending;
+			if (pMerged) { *pMerged = merged; }
+			pending = ChangeNone;
+			merged = 0;
+			return changes;
+		}
+
+		bool IsPending() const { return pending != ChangeNone; }
+		const Config& GetConfig() const { return config; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	static Settings::Coalescer settings{};
+
+	// WM_SETTINGCHANGE
+	if (settings.Add(Settings::Classify(uint32_t(wParam), (LPCWSTR)lParam), NowMs())) {
+		SetTimer(hWnd, IDT_SETTLE, UINT(settings.GetDeadline() - NowMs()), NULL);
+	}
+
+	// WM_TIMER IDT_SETTLE
+	const uint8_t changes = settings.Take(NowMs());
+	if (changes & Settings::ChangeTheme) { ApplyTheme(); }
+	if (changes & Settings::ChangeLayout) { Relayout(); }
+
+*/
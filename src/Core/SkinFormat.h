@@ -0,0 +1,312 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+
+// Tab skin container ("TabTap.skin").
+//
+// Layout (little-endian):
+//   SkinHeader
+//   SkinFrameEntry[frameCount]     at header.frameTableOffset
+//   pixel data                     each frame at entry.pixelOffset
+//
+// Pixels are 32-bit premultiplied BGRA, top-down, rows of entry.stride bytes.
+// Frame offsets are 16-byte aligned for aligned row copies. The reader
+// validates and indexes frames in place over the mapping, so loading decodes
+// and copies nothing; the draw side copies a frame once when it is first shown.
+namespace Skin
+{
+	constexpr uint32_t Magic = 0x4B535454;     // 'TTSK'
+	constexpr uint16_t Version = 1;
+	constexpr uint32_t PixelAlignment = 16;
+	constexpr uint32_t MaxFrames = 256;
+	constexpr uint16_t MaxDimension = 4096;
+
+	// Interaction states a skin can provide frames for
+	enum class State : uint8_t
+	{
+		Idle,
+		Hover,
+		Pressed,
+		Dragging,
+		SnapRejected,
+		OskVisible,
+		Count
+	};
+
+	// Frame flags
+	enum FrameFlags : uint8_t
+	{
+		FrameNone     = 0x00,
+		FrameMirrored = 0x01  // Pre-flipped for the right screen edge
+	};
+
+#pragma pack(push, 1)
+	struct Header
+	{
+		uint32_t magic;
+		uint16_t version;
+		uint16_t headerSize;
+		uint32_t fileSize;
+		uint32_t frameCount;
+		uint32_t frameTableOffset;
+		uint32_t reserved;
+	};
+
+	struct FrameEntry
+	{
+		uint8_t state;
+		uint8_t flags;
+		uint16_t dpi;
+		uint16_t width;
+		uint16_t height;
+		uint32_t stride;
+		uint32_t pixelOffset;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(Header) == 24, "Skin header layout changed");
+	static_assert(sizeof(FrameEntry) == 16, "Skin frame entry layout changed");
+
+	// Validation outcome
+	enum class Status
+	{
+		Ok,
+		TooSmall,
+		BadMagic,
+		BadVersion,
+		BadHeader,
+		BadFrameTable,
+		BadFrame
+	};
+
+	// Read-only frame view into the mapped file
+	struct Frame
+	{
+		const uint8_t* pixels{};
+		uint32_t pixelOffset{};  // Offset from the start of the file
+		uint32_t stride{};
+		uint16_t width{};
+		uint16_t height{};
+		uint16_t dpi{};
+		uint8_t flags{};
+		State state{ State::Idle };
+		int index{ -1 };         // Position in the frame table
+
+		explicit operator bool() const noexcept
+		{
+			return pixels != nullptr;
+		}
+	};
+
+
+
+	// Validating, non-owning reader over a mapped skin file
+	class View
+	{
+	private:
+		const uint8_t* pData{};     // Start of the mapping
+		size_t dataSize{};          // Mapping size
+		Header header{};            // Validated header copy
+		Status status{ Status::TooSmall };
+
+	private:
+		const FrameEntry* Entries() const
+		{
+			return reinterpret_cast<const FrameEntry*>(pData + header.frameTableOffset);
+		}
+
+		Status Validate()
+		{
+			if (!pData or dataSize < sizeof(Header)) { return Status::TooSmall; }
+
+			std::memcpy(&header, pData, sizeof(Header));
+			if (header.magic != Magic) { return Status::BadMagic; }
+			if (header.version != Version) { return Status::BadVersion; }
+			if (header.headerSize < sizeof(Header) or
+				header.fileSize != dataSize or
+				header.frameCount == 0 or
+				header.frameCount > MaxFrames)
+			{
+				return Status::BadHeader;
+			}
+
+			const uint64_t tableEnd =
+				uint64_t(header.frameTableOffset) + uint64_t(header.frameCount) * sizeof(FrameEntry);
+			if (header.frameTableOffset < header.headerSize or
+				header.frameTableOffset % alignof(uint32_t) != 0 or
+				tableEnd > dataSize)
+			{
+				return Status::BadFrameTable;
+			}
+
+			for (uint32_t i{}; i < header.frameCount; ++i) {
+				const FrameEntry& entry = Entries()[i];
+				const uint64_t pixelsEnd =
+					uint64_t(entry.pixelOffset) + uint64_t(entry.stride) * entry.height;
+
+				if (entry.state >= uint8_t(State::Count) or
+					entry.width == 0 or entry.width > MaxDimension or
+					entry.height == 0 or entry.height > MaxDimension or
+					entry.dpi == 0 or
+					entry.stride < uint32_t(entry.width) * 4 or
+					entry.stride % 4 != 0 or
+					entry.pixelOffset % PixelAlignment != 0 or
+					entry.pixelOffset < tableEnd or
+					pixelsEnd > dataSize)
+				{
+					return Status::BadFrame;
+				}
+			}
+
+			return Status::Ok;
+		}
+
+		Frame MakeFrame(int index) const
+		{
+			const FrameEntry& entry = Entries()[index];
+			return {
+				pData + entry.pixelOffset,
+				entry.pixelOffset,
+				entry.stride,
+				entry.width,
+				entry.height,
+				entry.dpi,
+				entry.flags,
+				State(entry.state),
+				index
+			};
+		}
+
+	public:
+		View() = default;
+
+		View(const void* pMapping, size_t size) :
+			pData{ static_cast<const uint8_t*>(pMapping) },
+			dataSize{ size }
+		{
+			status = Validate();
+		}
+
+		// Checks if the mapping holds a well-formed skin
+		bool IsValid() const
+		{
+			return status == Status::Ok;
+		}
+
+		// Returns the validation result
+		Status GetStatus() const
+		{
+			return status;
+		}
+
+		// Returns the number of frames in the table
+		uint32_t GetFrameCount() const
+		{
+			return IsValid() ? header.frameCount : 0;
+		}
+
+		// Returns the frame at the table index
+		Frame GetFrame(uint32_t index) const
+		{
+			if (index >= GetFrameCount()) { return {}; }
+			return MakeFrame(int(index));
+		}
+
+		// Picks the frame of exactly this state and orientation: exact DPI
+		// first, then the closest higher DPI, then the highest available
+		Frame FindState(State state, uint16_t dpi, bool mirrored = false) const
+		{
+			int best = -1;
+			int bestScore = 0;
+
+			for (uint32_t i{}; i < GetFrameCount(); ++i) {
+				const FrameEntry& entry = Entries()[i];
+				if (entry.state != uint8_t(state)) { continue; }
+				if (((entry.flags & FrameMirrored) != 0) != mirrored) { continue; }
+
+				// Lower score wins
+				int score = (entry.dpi >= dpi)
+					? (entry.dpi - dpi)
+					: (0x10000 + dpi - entry.dpi);
+
+				if (best < 0 or score < bestScore) {
+					best = int(i);
+					bestScore = score;
+				}
+			}
+
+			return best >= 0 ? MakeFrame(best) : Frame{};
+		}
+
+		// Like FindState, but falls back to Idle
+		Frame Find(State state, uint16_t dpi, bool mirrored = false) const
+		{
+			if (Frame frame = FindState(state, dpi, mirrored)) { return frame; }
+			if (state != State::Idle) { return FindState(State::Idle, dpi, mirrored); }
+
+			return {};
+		}
+
+	};
+
+
+
+	// Per-DPI lookup table so a state switch is a single array read
+	class FrameTable
+	{
+	private:
+		Frame frames[2][size_t(State::Count)]{};  // [mirrored][state]
+		uint16_t tableDpi{};
+
+	public:
+		// Resolves every state for the given DPI
+		void Build(const View& view, uint16_t dpi)
+		{
+			for (size_t state{}; state < size_t(State::Count); ++state) {
+				frames[0][state] = view.Find(State(state), dpi, false);
+
+				// The state matters more than the orientation: an unmirrored frame
+				// of the state (flipped when drawn) beats a mirrored Idle
+				Frame mirrored = view.FindState(State(state), dpi, true);
+				if (!mirrored) { mirrored = view.FindState(State(state), dpi, false); }
+				if (!mirrored) { mirrored = view.Find(State::Idle, dpi, true); }
+				if (!mirrored) { mirrored = frames[0][state]; }
+				frames[1][state] = mirrored;
+			}
+			tableDpi = dpi;
+		}
+
+		// Returns the resolved frame for the state
+		const Frame& Get(State state, bool mirrored) const
+		{
+			return frames[mirrored ? 1 : 0][size_t(state)];
+		}
+
+		// Returns the DPI the table was built for
+		uint16_t GetDpi() const
+		{
+			return tableDpi;
+		}
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	Skin::View view{ pMappedData, mappedSize };
+	if (!view.IsValid()) { return; }
+
+	Skin::FrameTable table{};
+	table.Build(view, 96);
+
+	const Skin::Frame& frame = table.Get(Skin::State::Hover, false);
+
+*/
@@ -0,0 +1,209 @@
+#pragma once
+
+// Implementation-specific headers
+#include "FrameSwapper.h"
+#include "DirectoryWatcher.h"
+
+// Standard library headers
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+
+
+// Background skin reloader.
+// Listens to directory change notifications, waits for the write burst to
+// settle, decodes the watched file on its own thread and publishes the result
+// into a FrameSwapper. A file that fails to decode leaves the last good frame
+// set in place.
+template <typename FrameTy>
+class SkinReloader
+{
+public:
+	// Decodes and pre-renders the file; returns null if the file is invalid
+	using DecodeFunc = std::function<std::shared_ptr<FrameTy>(const std::filesystem::path&)>;
+	// Notification after a successful swap or a rejected file
+	using NotifyFunc = std::function<void(bool)>;
+
+private:
+	// File identity used to skip unrelated directory changes
+	struct FileStamp
+	{
+		std::filesystem::file_time_type writeTime{};
+		std::uintmax_t size{};
+		bool exists{};
+
+		bool operator==(const FileStamp& other) const
+		{
+			return exists == other.exists and
+				size == other.size and
+				writeTime == other.writeTime;
+		}
+	};
+
+private:
+	// --- Configuration ---
+	const std::chrono::milliseconds settleDelay;  // Quiet period before decoding
+
+	// --- Member Variables ---
+	FrameSwapper<FrameTy>& frames;     // Destination of decoded frame sets
+	std::unique_ptr<IDirectoryWatcher> spWatcher{};  // Change notification source
+	DecodeFunc decode{};               // Decoder run on the worker thread
+	NotifyFunc notify{};               // Called from the worker thread
+	std::filesystem::path filePath{};  // Watched file
+	FileStamp lastStamp{};             // Stamp of the last decoded file
+
+	// --- Worker State ---
+	std::thread worker{};
+	std::mutex mutex{};
+	std::condition_variable wakeup{};
+	std::chrono::steady_clock::time_point lastChange{};
+	bool isPending{};
+	bool isStopping{};
+
+private:
+	// --- Internal Methods ---
+	static FileStamp ReadStamp(const std::filesystem::path& path)
+	{
+		FileStamp stamp{};
+		std::error_code ec{};
+
+		stamp.writeTime = std::filesystem::last_write_time(path, ec);
+		if (ec) { return {}; }
+		stamp.size = std::filesystem::file_size(path, ec);
+		if (ec) { return {}; }
+		stamp.exists = true;
+
+		return stamp;
+	}
+
+	void OnDirectoryChanged()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			isPending = true;
+			lastChange = std::chrono::steady_clock::now();
+		}
+		wakeup.notify_one();
+	}
+
+	void WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock{ mutex };
+
+		while (true) {
+			wakeup.wait(lock, [this] { return isPending or isStopping; });
+			if (isStopping) { return; }
+
+			// Editors save in several steps; decode only after the burst ends
+			auto deadline = lastChange + settleDelay;
+			while (!isStopping and std::chrono::steady_clock::now() < deadline) {
+				wakeup.wait_until(lock, deadline);
+				deadline = lastChange + settleDelay;
+			}
+			if (isStopping) { return; }
+			isPending = false;
+
+			lock.unlock();
+			Reload();
+			lock.lock();
+		}
+	}
+
+	void Reload()
+	{
+		const FileStamp stamp = ReadStamp(filePath);
+		if (!stamp.exists or stamp == lastStamp) { return; }
+
+		std::shared_ptr<FrameTy> spFrames = decode(filePath);
+		const bool isValid = (spFrames != nullptr);
+		lastStamp = stamp;
+
+		// Invalid files keep the last good frame set
+		if (isValid) {
+			frames.Publish(std::move(spFrames));
+		}
+		if (notify) { notify(isValid); }
+	}
+
+public:
+	~SkinReloader()
+	{
+		Stop();
+	}
+
+	SkinReloader(FrameSwapper<FrameTy>& target, std::unique_ptr<IDirectoryWatcher> spSource,
+		std::chrono::milliseconds delay = std::chrono::milliseconds{ 200 }) :
+		settleDelay{ delay },
+		frames{ target },
+		spWatcher{ std::move(spSource) }
+	{}
+
+	SkinReloader(const SkinReloader&) = delete;
+	SkinReloader& operator=(const SkinReloader&) = delete;
+
+	// Starts watching the file's directory; the current file is treated as loaded
+	bool Start(const std::filesystem::path& path, DecodeFunc decoder, NotifyFunc callback = {})
+	{
+		if (!spWatcher or !decoder or worker.joinable()) { return false; }
+
+		filePath = path;
+		decode = std::move(decoder);
+		notify = std::move(callback);
+		lastStamp = ReadStamp(filePath);
+		isPending = false;
+		isStopping = false;
+
+		worker = std::thread{ &SkinReloader::WorkerLoop, this };
+
+		if (!spWatcher->Start(filePath.parent_path(), [this] { OnDirectoryChanged(); })) {
+			Stop();
+			return false;
+		}
+
+		return true;
+	}
+
+	// Stops watching; an in-flight decode finishes before this returns
+	void Stop()
+	{
+		if (spWatcher) { spWatcher->Stop(); }
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			isStopping = true;
+		}
+		wakeup.notify_one();
+
+		if (worker.joinable()) { worker.join(); }
+	}
+
+	// Checks if the reloader is active
+	bool IsRunning() const
+	{
+		return worker.joinable();
+	}
+
+};
+
+
+
+
+/*
+Usage example:
+
+	FrameSwapper<Frames> frames{};
+	SkinReloader<Frames> reloader{ frames, std::make_unique<PlatformDirectoryWatcher>() };
+
+	reloader.Start(L"C:\\TabTap\\TabTap.png",
+		[](const std::filesystem::path& path) { return DecodeFrames(path); },
+		[](bool swapped) { if (swapped) { RequestRedraw(); } }
+	);
+
+*/
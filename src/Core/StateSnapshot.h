@@ -0,0 +1,241 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+
+// Standard library headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+
+
+// Fixed-layout session state shared by TabTap and the hook. Written as a
+// whole to `<name>.tmp` and renamed over the old file, so a reader sees
+// either the previous or the new snapshot; a torn or foreign file fails the
+// magic, version, size or checksum test and is ignored.
+namespace Snapshot
+{
+	constexpr uint32_t FileMagic = 0x53535454;   // 'TTSS'
+	constexpr uint16_t FileVersion = 1;
+	constexpr size_t MaxTopologies = 8;          // Remembered monitor layouts
+
+	enum class Status
+	{
+		Ok,
+		Missing,             // No file
+		TooSmall,            // Shorter than the header
+		BadMagic,            // Not a snapshot
+		UnsupportedVersion,  // Written by a newer build
+		BadSize,             // Payload size does not match the version
+		BadChecksum          // Torn or corrupted payload
+	};
+
+	inline const char* GetStatusName(Status status)
+	{
+		switch (status)
+		{
+		case Status::Ok:                   return "ok";
+		case Status::Missing:              return "missing";
+		case Status::TooSmall:             return "too small";
+		case Status::BadMagic:             return "bad magic";
+		case Status::UnsupportedVersion:   return "unsupported version";
+		case Status::BadSize:              return "bad size";
+		case Status::BadChecksum:          return "bad checksum";
+		default:                           return "?";
+		}
+	}
+
+#pragma pack(push, 1)
+	// Window positions for one monitor topology
+	struct Placement
+	{
+		uint64_t topology{};         // HashTopology of the monitor layout (0 = unused)
+		int32_t tabTop{};            // Tab window top
+		int32_t oskLeft{};           // OSK window top-left
+		int32_t oskTop{};
+		uint32_t stamp{};            // Last use (higher is newer)
+	};
+
+	struct State
+	{
+		uint8_t edge{};              // TabLayout::Edge
+		uint8_t opacity{ 0xff };     // OSK layered window alpha
+		uint8_t isDockMode{};        // Forced dock mode
+		uint8_t reserved{};
+		uint32_t stamp{};            // Last stamp handed out
+		Placement placements[MaxTopologies]{};
+	};
+
+	struct FileHeader
+	{
+		uint32_t magic{};
+		uint16_t version{};
+		uint16_t reserved{};
+		uint32_t payloadSize{};      // sizeof(State) for this version
+		uint32_t checksum{};         // Checksum of the payload
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(Placement) == 24, "Unexpected Placement layout");
+	static_assert(sizeof(FileHeader) == 16, "Unexpected FileHeader layout");
+
+	constexpr size_t FileBytes = sizeof(FileHeader) + sizeof(State);
+
+
+
+	// FNV-1a over a byte range
+	inline uint32_t Checksum(const void* pData, size_t length)
+	{
+		const uint8_t* p = static_cast<const uint8_t*>(pData);
+		uint32_t hash = 2166136261u;
+		for (size_t i{}; i < length; ++i) {
+			hash = (hash ^ p[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	// Identifies a monitor layout by its monitor rectangles (order matters)
+	inline uint64_t HashTopology(const Geometry::Rect* pMonitors, size_t count)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](int64_t value) {
+			for (int i{}; i < 8; ++i) {
+				hash = (hash ^ uint8_t(value >> (i * 8))) * 1099511628211ull;
+			}
+			};
+
+		mix(int64_t(count));
+		for (size_t i{}; i < count; ++i) {
+			mix(pMonitors[i].left);
+			mix(pMonitors[i].top);
+			mix(pMonitors[i].right);
+			mix(pMonitors[i].bottom);
+		}
+		return hash ? hash : 1;  // 0 marks an unused placement
+	}
+
+	// Placement stored for a topology, or nullptr
+	inline const Placement* FindPlacement(const State& state, uint64_t topology)
+	{
+		for (const Placement& placement : state.placements) {
+			if (placement.topology == topology) { return &placement; }
+		}
+		return nullptr;
+	}
+
+	// Stores a placement, replacing the same topology or the least recently used one
+	inline void StorePlacement(State* pState, Placement placement)
+	{
+		Placement* pTarget = &pState->placements[0];
+		for (Placement& slot : pState->placements) {
+			if (slot.topology == placement.topology) {
+				pTarget = &slot;
+				break;
+			}
+			if (slot.stamp < pTarget->stamp) { pTarget = &slot; }
+		}
+
+		// Unchanged and already the newest: keep the state byte-identical
+		if (pTarget->topology == placement.topology and pTarget->stamp == pState->stamp and
+			pTarget->tabTop == placement.tabTop and pTarget->oskLeft == placement.oskLeft and
+			pTarget->oskTop == placement.oskTop)
+		{
+			return;
+		}
+
+		placement.stamp = ++pState->stamp;
+		*pTarget = placement;
+	}
+
+	// Serializes a state into a complete file image
+	inline std::array<uint8_t, FileBytes> Encode(const State& state)
+	{
+		FileHeader header{};
+		header.magic = FileMagic;
+		header.version = FileVersion;
+		header.payloadSize = sizeof(State);
+		header.checksum = Checksum(&state, sizeof(State));
+
+		std::array<uint8_t, FileBytes> image{};
+		std::memcpy(image.data(), &header, sizeof(header));
+		std::memcpy(image.data() + sizeof(header), &state, sizeof(State));
+		return image;
+	}
+
+	// Validates a file image and extracts the state
+	inline Status Decode(const uint8_t* pData, size_t length, State* pState)
+	{
+		if (length < sizeof(FileHeader)) { return Status::TooSmall; }
+
+		FileHeader header{};
+		std::memcpy(&header, pData, sizeof(header));
+		if (header.magic != FileMagic) { return Status::BadMagic; }
+		if (header.version != FileVersion) { return Status::UnsupportedVersion; }
+		if (header.payloadSize != sizeof(State) or length < FileBytes) { return Status::BadSize; }
+
+		const uint8_t* pPayload = pData + sizeof(header);
+		if (Checksum(pPayload, sizeof(State)) != header.checksum) { return Status::BadChecksum; }
+
+		std::memcpy(pState, pPayload, sizeof(State));
+		return Status::Ok;
+	}
+
+	// Reads a snapshot file
+	inline Status Load(const std::filesystem::path& path, State* pState)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if (!file) { return Status::Missing; }
+
+		uint8_t image[FileBytes + 1]{};  // One extra byte detects a longer file
+		file.read(reinterpret_cast<char*>(image), sizeof(image));
+		const size_t length = size_t(file.gcount());
+		if (length > FileBytes) { return Status::BadSize; }
+
+		return Decode(image, length, pState);
+	}
+
+	// Writes a snapshot file by atomic replacement
+	inline bool Save(const std::filesystem::path& path, const State& state)
+	{
+		std::filesystem::path tempPath = path;
+		tempPath += ".tmp";
+
+		const std::array<uint8_t, FileBytes> image = Encode(state);
+		{
+			std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+			if (!file) { return false; }
+			file.write(reinterpret_cast<const char*>(image.data()), std::streamsize(image.size()));
+			file.flush();
+			if (!file) { return false; }
+		}
+
+		std::error_code ec{};
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	Snapshot::State state{};
+	if (Snapshot::Load("TabTap.state", &state) == Snapshot::Status::Ok) {
+		const Snapshot::Placement* pPlacement = Snapshot::FindPlacement(state, topology);
+	}
+
+	Snapshot::StorePlacement(&state, { topology, tabTop, oskLeft, oskTop });
+	Snapshot::Save("TabTap.state", state);
+
+*/
@@ -0,0 +1,111 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Geometry.h"
+#include "GroupLayout.h"
+
+// Standard library headers
+#include <algorithm>
+
+
+
+// Placement decisions for the tab window. MainWindow, EdgeSnapData and
+// AnimationData call these with live Win32 state; the replay harness calls
+// them with recorded state, so both run the same arithmetic.
+namespace TabLayout
+{
+	// Screen edges (same order as ScreenEdge)
+	enum class Edge
+	{
+		None, Left, Right, Top, Bottom
+	};
+
+	constexpr Geometry::Size CollapsedSize{ 7, 95 };   // Narrow idle tab
+	constexpr Geometry::Size ExpandedSize{ 28, 95 };   // Tab under the cursor
+	constexpr long SnapMargin = 50;                    // Edge distance that selects a snap edge
+	constexpr long AnimationStep = 8;                  // Pixels per animation step and axis
+	constexpr unsigned AnimationFrameMs = 8;           // Time between steps (about 1 px/ms)
+
+	// Checks if an edge is not occupied by the taskbar or an app bar
+	inline bool IsFreeEdge(Edge edge, const Geometry::Rect& workArea, const Geometry::Size& screen)
+	{
+		switch (edge)
+		{
+		case Edge::Left:     return workArea.left == 0;
+		case Edge::Right:    return workArea.right == screen.cx;
+		case Edge::Top:      return workArea.top == 0;
+		case Edge::Bottom:   return workArea.bottom == screen.cy;
+		default:             return false;
+		}
+	}
+
+	// Left coordinate of a tab of `width` attached to a side edge
+	inline long EdgeLeft(Edge edge, long screenWidth, long width)
+	{
+		return (edge == Edge::Right) ? screenWidth - width : 0;
+	}
+
+	// Keeps a tab of `size` inside the work area
+	inline Geometry::Point ClampPoint(const Geometry::Point& pt, const Geometry::Size& size,
+		const Geometry::Rect& workArea)
+	{
+		return Geometry::ClampToBounds(pt, size, workArea);
+	}
+
+	// Edge selected by the cursor during a snap drag (None for the current edge)
+	inline Edge DetectSnapEdge(const Geometry::Point& cursor, const Geometry::Rect& workArea, Edge current)
+	{
+		Edge edge = Edge::None;
+		if (cursor.x <= workArea.left + SnapMargin) { edge = Edge::Left; }
+		else if (cursor.x >= workArea.right - SnapMargin) { edge = Edge::Right; }
+		else if (cursor.y <= workArea.top + SnapMargin) { edge = Edge::Top; }
+		else if (cursor.y >= workArea.bottom - SnapMargin) { edge = Edge::Bottom; }
+
+		return edge == current ? Edge::None : edge;
+	}
+
+	// Tab top that centres it on the OSK, kept inside the work area
+	inline long SyncTop(const Geometry::Rect& oskRect, long tabHeight, const Geometry::Rect& workArea)
+	{
+		const long top = oskRect.top + (oskRect.Height() - tabHeight) / 2;
+		return Geometry::ClampSpan(top, tabHeight, workArea.top, workArea.bottom);
+	}
+
+	// OSK top that centres it on the tab, kept inside the work area
+	inline long OskSyncTop(const Geometry::Rect& tabRect, long oskHeight, const Geometry::Rect& workArea)
+	{
+		const long top = GroupLayout::CenteredTop(tabRect.top, tabRect.Height(), oskHeight);
+		return Geometry::ClampSpan(top, oskHeight, workArea.top, workArea.bottom);
+	}
+
+	// One animation step from `current` toward `target`
+	inline Geometry::Point StepToward(const Geometry::Point& current, const Geometry::Point& target)
+	{
+		return {
+			current.x + std::clamp(target.x - current.x, -AnimationStep, AnimationStep),
+			current.y + std::clamp(target.y - current.y, -AnimationStep, AnimationStep)
+		};
+	}
+
+	// Side the tab moves to after the work area changed (None to stay)
+	inline Edge ResolveWorkAreaChange(Edge current, const Geometry::Rect& workArea, const Geometry::Size& screen)
+	{
+		if (current == Edge::Left and !IsFreeEdge(Edge::Left, workArea, screen)) { return Edge::Right; }
+		if (current == Edge::Right and !IsFreeEdge(Edge::Right, workArea, screen)) { return Edge::Left; }
+		return Edge::None;
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	const Geometry::Rect workArea{ 0, 0, 1920, 1040 };
+	const Geometry::Size screen{ 1920, 1080 };
+
+	TabLayout::Edge edge = TabLayout::ResolveWorkAreaChange(TabLayout::Edge::Left, workArea, screen);
+	long left = TabLayout::EdgeLeft(TabLayout::Edge::Right, screen.cx, TabLayout::ExpandedSize.cx);
+
+*/
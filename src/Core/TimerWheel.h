@@ -0,0 +1,342 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// Hierarchical timer wheel on a millisecond clock. Four levels of 64 slots
+// cover a 2^24 ms block (about 4.6 hours); later deadlines wait in an
+// overflow list and join the wheel when the clock enters their block.
+// Schedule and Cancel are O(1), and the clock jumps straight to the next
+// occupied slot, so a sleeping owner pays nothing for the time in between.
+//
+// A timer fires anywhere in [deadline, deadline + tolerance]. Its expiry is
+// the last tick of that window on the coarsest power-of-two grid the window
+// is guaranteed to hit, so timers whose windows overlap by the grid land on
+// the same tick and share one wakeup.
+namespace Timing
+{
+	// Handle of a scheduled timer (0 is never handed out)
+	using TimerId = uint64_t;
+	constexpr TimerId InvalidTimer = 0;
+	constexpr uint64_t NoWakeup = UINT64_MAX;
+
+	// Tick in [deadline, deadline + tolerance] on the coarsest shared grid
+	inline uint64_t CoalesceDeadline(uint64_t deadlineMs, uint32_t toleranceMs)
+	{
+		if (!toleranceMs) { return deadlineMs; }
+
+		uint64_t grid = 1;
+		while (grid * 2 <= uint64_t(toleranceMs) + 1) { grid *= 2; }
+
+		// Round the latest tick down; a window of `grid` ticks always contains a multiple of it
+		return (deadlineMs + toleranceMs) / grid * grid;
+	}
+
+	class TimerWheel
+	{
+	public:
+		static constexpr uint32_t SlotBits = 6;
+		static constexpr uint32_t SlotCount = 1u << SlotBits;
+		static constexpr uint32_t LevelCount = 4;
+		static constexpr uint32_t BlockBits = SlotBits * LevelCount;
+
+	private:
+		static constexpr uint32_t Nil = UINT32_MAX;
+
+		enum class NodeState : uint8_t
+		{
+			Free,
+			Linked,      // In a slot list
+			Due          // Taken off the wheel, about to fire
+		};
+
+		struct Node
+		{
+			uint64_t deadlineMs{};       // Requested time
+			uint64_t expiryMs{};         // Coalesced firing tick
+			uint32_t toleranceMs{};
+			uint32_t periodMs{};         // 0 for one-shot timers
+			uint32_t tag{};              // Owner's timer identifier
+			uint32_t generation{ 1 };    // Bumped on free, so stale ids miss
+			uint32_t prev{ Nil };
+			uint32_t next{ Nil };
+			uint8_t level{};             // LevelCount for the overflow list
+			uint8_t slot{};
+			NodeState state{};
+		};
+
+		struct DueTimer
+		{
+			uint32_t index{};
+			uint32_t generation{};
+		};
+
+		uint64_t nowMs{};                                    // Wheel clock
+		std::vector<Node> nodes{};
+		std::vector<uint32_t> freeNodes{};
+		std::array<std::array<uint32_t, SlotCount>, LevelCount> slots{};
+		std::array<uint64_t, LevelCount> occupied{};         // Bit per non-empty slot
+		uint32_t overflow{ Nil };                            // Timers beyond the current block
+		std::vector<DueTimer> dueTimers{};                   // Reused by Advance
+		size_t count{};
+
+	private:
+		static TimerId MakeId(uint32_t index, uint32_t generation)
+		{
+			return (uint64_t(generation) << 32) | uint64_t(index + 1);
+		}
+
+		Node* Find(TimerId id)
+		{
+			const uint32_t index = uint32_t(id & 0xffffffffu) - 1;
+			if (!id or index >= nodes.size()) { return nullptr; }
+
+			Node& node = nodes[index];
+			if (node.generation != uint32_t(id >> 32) or node.state == NodeState::Free) { return nullptr; }
+			return &node;
+		}
+
+		uint32_t& GetHead(uint32_t level, uint32_t slot)
+		{
+			return level < LevelCount ? slots[level][slot] : overflow;
+		}
+
+		uint32_t GetHead(uint32_t level, uint32_t slot) const
+		{
+			return level < LevelCount ? slots[level][slot] : overflow;
+		}
+
+		// Puts a node in the slot of the highest 6-bit group where its expiry differs from the clock
+		void Link(uint32_t index)
+		{
+			Node& node = nodes[index];
+			const uint64_t expiry = std::max(node.expiryMs, nowMs);
+			const uint64_t difference = expiry ^ nowMs;
+
+			uint32_t level{};
+			uint32_t slot{};
+			if (difference >> BlockBits) {
+				level = LevelCount;
+			}
+			else {
+				while (difference >> (SlotBits * (level + 1))) { ++level; }
+				slot = uint32_t(expiry >> (SlotBits * level)) & (SlotCount - 1);
+				occupied[level] |= 1ull << slot;
+			}
+
+			uint32_t& head = GetHead(level, slot);
+			node.level = uint8_t(level);
+			node.slot = uint8_t(slot);
+			node.prev = Nil;
+			node.next = head;
+			node.state = NodeState::Linked;
+
+			if (node.next != Nil) { nodes[node.next].prev = index; }
+			head = index;
+		}
+
+		void Unlink(uint32_t index)
+		{
+			Node& node = nodes[index];
+			if (node.prev != Nil) {
+				nodes[node.prev].next = node.next;
+			}
+			else {
+				GetHead(node.level, node.slot) = node.next;
+				if (node.next == Nil and node.level < LevelCount) { occupied[node.level] &= ~(1ull << node.slot); }
+			}
+			if (node.next != Nil) { nodes[node.next].prev = node.prev; }
+
+			node.prev = node.next = Nil;
+			node.state = NodeState::Due;
+		}
+
+		void Release(uint32_t index)
+		{
+			Node& node = nodes[index];
+			node.state = NodeState::Free;
+			++node.generation;
+			freeNodes.push_back(index);
+			--count;
+		}
+
+		// First occupied slot at or after the clock's digit on the lowest non-empty level
+		bool FindNextSlot(uint32_t* pLevel, uint32_t* pSlot) const
+		{
+			for (uint32_t level{}; level < LevelCount; ++level) {
+				if (!occupied[level]) { continue; }
+
+				const uint32_t digit = uint32_t(nowMs >> (SlotBits * level)) & (SlotCount - 1);
+				const uint64_t ahead = occupied[level] & (~0ull << digit);
+				if (!ahead) { continue; }
+
+				uint32_t slot{};
+				while (!(ahead & (1ull << slot))) { ++slot; }
+				*pLevel = level;
+				*pSlot = slot;
+				return true;
+			}
+
+			*pLevel = LevelCount;
+			*pSlot = 0;
+			return overflow != Nil;
+		}
+
+		// Clock value at which a slot's timers need attention
+		uint64_t GetSlotStart(uint32_t level, uint32_t slot) const
+		{
+			if (level == LevelCount) { return ((nowMs >> BlockBits) + 1) << BlockBits; }
+
+			const uint32_t shift = SlotBits * level;
+			const uint64_t upper = nowMs >> (shift + SlotBits) << (shift + SlotBits);
+			return std::max(nowMs, upper | (uint64_t(slot) << shift));
+		}
+
+	public:
+		explicit TimerWheel(uint64_t startMs = 0) :
+			nowMs{ startMs }
+		{
+			for (auto& level : slots) { level.fill(Nil); }
+		}
+
+		// --- Scheduling ---
+
+		/// Starts a timer; repeats every `periodMs` when non-zero
+		TimerId Schedule(uint32_t tag, uint64_t deadlineMs, uint32_t toleranceMs, uint32_t periodMs = 0)
+		{
+			uint32_t index{};
+			if (!freeNodes.empty()) {
+				index = freeNodes.back();
+				freeNodes.pop_back();
+			}
+			else {
+				index = uint32_t(nodes.size());
+				nodes.emplace_back();
+			}
+
+			Node& node = nodes[index];
+			node.deadlineMs = std::max(deadlineMs, nowMs);
+			node.expiryMs = CoalesceDeadline(node.deadlineMs, toleranceMs);
+			node.toleranceMs = toleranceMs;
+			node.periodMs = periodMs;
+			node.tag = tag;
+			Link(index);
+
+			++count;
+			return MakeId(index, node.generation);
+		}
+
+		/// Stops a timer; false if it already fired or was cancelled
+		bool Cancel(TimerId id)
+		{
+			Node* pNode = Find(id);
+			if (!pNode) { return false; }
+
+			const uint32_t index = uint32_t(pNode - nodes.data());
+			if (pNode->state == NodeState::Linked) { Unlink(index); }
+			Release(index);
+			return true;
+		}
+
+		/// Checks if a timer is still going to fire
+		bool IsPending(TimerId id) const
+		{
+			return const_cast<TimerWheel*>(this)->Find(id) != nullptr;
+		}
+
+		// --- Time ---
+
+		/// Earliest expiry of all timers, or NoWakeup
+		uint64_t GetNextWakeup() const
+		{
+			uint32_t level{}, slot{};
+			if (!FindNextSlot(&level, &slot)) { return NoWakeup; }
+
+			uint64_t wakeupMs = NoWakeup;
+			for (uint32_t index = GetHead(level, slot); index != Nil; index = nodes[index].next) {
+				wakeupMs = std::min(wakeupMs, nodes[index].expiryMs);
+			}
+			return std::max(wakeupMs, nowMs);
+		}
+
+		/// Moves the clock to `targetMs` and calls `fire(tag, id)` for every due timer
+		template <typename FireFn>
+		size_t Advance(uint64_t targetMs, FireFn&& fire)
+		{
+			size_t fired{};
+
+			for (;;) {
+				uint32_t level{}, slot{};
+				if (!FindNextSlot(&level, &slot) or GetSlotStart(level, slot) > targetMs) {
+					nowMs = std::max(nowMs, targetMs);
+					return fired;
+				}
+				nowMs = GetSlotStart(level, slot);
+
+				// Take the slot off the wheel; due timers fire, the rest move down a level
+				dueTimers.clear();
+				for (uint32_t index = GetHead(level, slot); index != Nil; ) {
+					const uint32_t next = nodes[index].next;
+					Unlink(index);
+					if (nodes[index].expiryMs <= nowMs) {
+						dueTimers.push_back({ index, nodes[index].generation });
+					}
+					else {
+						Link(index);
+					}
+					index = next;
+				}
+
+				// Callbacks may schedule and cancel, including timers in this batch
+				for (size_t i{}; i < dueTimers.size(); ++i) {
+					const DueTimer due = dueTimers[i];
+					Node& node = nodes[due.index];
+					if (node.generation != due.generation or node.state != NodeState::Due) { continue; }
+
+					const uint32_t tag = node.tag;
+					const TimerId id = MakeId(due.index, due.generation);
+					if (node.periodMs) {
+						// Stay on the original beat; periods missed before `targetMs` fire once
+						const uint64_t missed = (targetMs - node.deadlineMs) / node.periodMs;
+						node.deadlineMs += (missed + 1) * node.periodMs;
+						node.expiryMs = CoalesceDeadline(node.deadlineMs, node.toleranceMs);
+						Link(due.index);
+					}
+					else {
+						Release(due.index);
+					}
+
+					++fired;
+					fire(tag, id);
+				}
+			}
+		}
+
+		uint64_t GetTime() const { return nowMs; }
+		size_t GetCount() const { return count; }
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	Timing::TimerWheel wheel{ nowMs };
+	Timing::TimerId id = wheel.Schedule(IDT_KEEP_ON_TOP, nowMs + 5000, 500, 5000);
+
+	// Sleep until wheel.GetNextWakeup(), then:
+	wheel.Advance(nowMs, [](uint32_t tag, Timing::TimerId) {
+		// Dispatch by tag
+	});
+
+	wheel.Cancel(id);
+
+*/
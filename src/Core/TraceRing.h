@@ -0,0 +1,379 @@
+#pragma once
+
+// Standard library headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+
+// Fixed-size binary trace ring placed in caller-provided (shared) memory.
+// Any number of producers, in any process mapping the block, append records
+// without locks; a single consumer drains them in order. A full ring drops
+// the new record and counts it instead of blocking the producer. Producers
+// append only while the consumer has the ring enabled, and a slot whose
+// producer died between claiming and publishing it is skipped after a few
+// drain passes instead of stalling the ring for good. A skipped producer that
+// was only paused never publishes; if it was paused inside its copy, the slot
+// counts it as a stale writer and the consumer drops whatever the slot holds
+// until that writer has left, so its late bytes never reach the sink.
+namespace Trace
+{
+	constexpr uint32_t Magic = 0x52545454;    // 'TTTR'
+	constexpr uint32_t Version = 3;
+	constexpr size_t CacheLine = 64;
+
+	// Component that produced a record
+	enum class Source : uint16_t
+	{
+		TabTap,       // TabTap main window
+		CbtHook,      // CBT hook procedure inside osk.exe
+		OskMain,      // Subclassed OSKMainClass procedure
+		DirectUI,     // Subclassed DirectUIHWND procedure
+		Count
+	};
+
+	// One trace event (fixed size, no pointers)
+	struct Record
+	{
+		uint64_t time{};        // Caller clock ticks (system-wide on the producer side)
+		uint32_t processId{};
+		uint32_t threadId{};
+		uint16_t source{};      // Trace::Source
+		uint16_t flags{};       // Reserved
+		uint32_t message{};     // Window message or hook code
+		uint64_t wParam{};
+		uint64_t lParam{};
+	};
+
+	// Ring bookkeeping at the start of the block
+	struct Header
+	{
+		uint32_t magic{};
+		uint32_t version{};
+		uint32_t capacity{};    // Slot count (power of two)
+		uint32_t recordSize{};
+		std::atomic<uint32_t> isEnabled{};  // Set by the consumer while it records
+
+		alignas(CacheLine) std::atomic<uint64_t> writeIndex{};   // Next slot to claim
+		alignas(CacheLine) std::atomic<uint64_t> readIndex{};    // Next slot to drain
+		alignas(CacheLine) std::atomic<uint64_t> dropped{};      // Records lost to a full ring
+	};
+
+	// Record slot; `sequence` tells producers and the consumer whose turn it is
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence{};
+		Record record{};
+	};
+
+	// Slot sequence layout: the position in the low bits, then the write state
+	constexpr uint64_t SequencePosition = (uint64_t(1) << 48) - 1;
+	constexpr uint64_t SequenceStaleUnit = uint64_t(1) << 48;      // Skipped writers still copying (8 bits)
+	constexpr uint64_t SequenceStale = uint64_t(0xff) << 48;
+	constexpr uint64_t SequenceOverlapped = uint64_t(1) << 62;     // Contents overlapped a stale writer's copy
+	constexpr uint64_t SequenceWriting = uint64_t(1) << 63;        // Claimed and being copied into
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		"Shared memory atomics must be lock-free");
+
+	// Bytes needed for a ring of `capacity` slots
+	constexpr size_t RequiredBytes(uint32_t capacity)
+	{
+		return sizeof(Header) + size_t(capacity) * sizeof(Slot);
+	}
+
+
+
+	// View over a ring block; does not own the memory
+	class Ring
+	{
+	public:
+		// Drain passes a claimed slot may stay unpublished before it is skipped
+		static constexpr uint32_t StallPasses = 4;
+
+	private:
+		Header* pHeader{};
+		Slot* pSlots{};
+		uint64_t mask{};
+
+		// Consumer side only
+		uint64_t stalledPosition{ UINT64_MAX };  // Read position last found claimed but unpublished
+		uint32_t stalledPasses{};                // Drain passes it has stayed that way
+
+	private:
+		Ring(Header* header, Slot* slots) :
+			pHeader{ header },
+			pSlots{ slots },
+			mask{ uint64_t(header->capacity) - 1 }
+		{}
+
+	public:
+		Ring() = default;
+
+		// Formats a zeroed block as an empty ring (capacity must be a power of two)
+		static Ring Create(void* pMemory, size_t bytes, uint32_t capacity)
+		{
+			if (!pMemory or capacity < 2 or (capacity & (capacity - 1)) or
+				bytes < RequiredBytes(capacity))
+			{
+				return {};
+			}
+
+			Header* header = new (pMemory) Header{};
+			Slot* slots = reinterpret_cast<Slot*>(static_cast<unsigned char*>(pMemory) + sizeof(Header));
+			for (uint32_t i{}; i < capacity; ++i) {
+				new (&slots[i]) Slot{};
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+
+			header->capacity = capacity;
+			header->recordSize = sizeof(Record);
+			header->version = Version;
+			// Publish the magic last so an attaching process never sees a half-built ring
+			std::atomic_thread_fence(std::memory_order_release);
+			header->magic = Magic;
+
+			return { header, slots };
+		}
+
+		// Attaches to a ring formatted by another process
+		static Ring Attach(void* pMemory, size_t bytes)
+		{
+			if (!pMemory or bytes < sizeof(Header)) { return {}; }
+
+			Header* header = static_cast<Header*>(pMemory);
+			if (header->magic != Magic) { return {}; }
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (header->version != Version or header->recordSize != sizeof(Record) or
+				header->capacity < 2 or (header->capacity & (header->capacity - 1)) or
+				bytes < RequiredBytes(header->capacity))
+			{
+				return {};
+			}
+
+			Slot* slots = reinterpret_cast<Slot*>(static_cast<unsigned char*>(pMemory) + sizeof(Header));
+			return { header, slots };
+		}
+
+		bool IsValid() const
+		{
+			return pHeader != nullptr;
+		}
+
+		uint32_t GetCapacity() const
+		{
+			return pHeader ? pHeader->capacity : 0;
+		}
+
+		// Starts or stops accepting records (consumer)
+		void SetEnabled(bool isEnabled)
+		{
+			if (pHeader) { pHeader->isEnabled.store(isEnabled ? 1 : 0, std::memory_order_release); }
+		}
+
+		bool IsEnabled() const
+		{
+			return pHeader and pHeader->isEnabled.load(std::memory_order_relaxed);
+		}
+
+		// Appends a record; returns false if the ring is disabled, if it is
+		// full (counted as a drop), or if the consumer skipped the slot before
+		// the record was published (counted there)
+		bool TryAppend(const Record& record)
+		{
+			if (!IsEnabled()) { return false; }
+
+			uint64_t position = pHeader->writeIndex.load(std::memory_order_relaxed);
+			Slot* pSlot{};
+
+			for (;;) {
+				pSlot = &pSlots[position & mask];
+				const uint64_t sequence = pSlot->sequence.load(std::memory_order_acquire);
+				const int64_t distance = int64_t((sequence & SequencePosition) - position);
+
+				if (distance == 0) {
+					// Slot is free for this position; claim it
+					if (pHeader->writeIndex.compare_exchange_weak(
+						position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (distance < 0) {
+					// Consumer has not released this slot yet: the ring is full
+					pHeader->dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else {
+					// Another producer claimed it; retry with the current index
+					position = pHeader->writeIndex.load(std::memory_order_relaxed);
+				}
+			}
+
+			// Mark the copy as started; a slot the consumer already skipped is left alone
+			uint64_t sequence = pSlot->sequence.load(std::memory_order_relaxed);
+			do {
+				if ((sequence & SequencePosition) != position) { return false; }
+			} while (!pSlot->sequence.compare_exchange_weak(sequence, sequence | SequenceWriting,
+				std::memory_order_acquire, std::memory_order_relaxed));
+
+			pSlot->record = record;
+
+			// Publish unless the consumer gave up on the slot during the copy
+			sequence |= SequenceWriting;
+			for (;;) {
+				if ((sequence & SequencePosition) != position) {
+					LeaveSkippedSlot(*pSlot, position & mask);
+					return false;
+				}
+				if (pSlot->sequence.compare_exchange_weak(sequence, (sequence & ~SequenceWriting) + 1,
+					std::memory_order_release, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+		}
+
+		// Removes the oldest record (single consumer only). Records a stale
+		// writer may have overwritten are dropped and counted instead.
+		bool TryRead(Record* pRecord)
+		{
+			if (!pHeader) { return false; }
+
+			for (;;) {
+				const uint64_t position = pHeader->readIndex.load(std::memory_order_relaxed);
+				Slot& slot = pSlots[position & mask];
+
+				uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+				if ((sequence & (SequencePosition | SequenceWriting)) != position + 1) {
+					return false;  // Empty, or the producer is still writing this slot
+				}
+
+				*pRecord = slot.record;
+
+				// Release the slot to the next lap; the state replaced decides whether the copy is clean
+				while (!slot.sequence.compare_exchange_weak(sequence, (sequence & SequenceStale) | (position + mask + 1),
+					std::memory_order_acq_rel, std::memory_order_acquire))
+				{}
+				pHeader->readIndex.store(position + 1, std::memory_order_relaxed);
+
+				if (!(sequence & (SequenceStale | SequenceOverlapped))) { return true; }
+				pHeader->dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		// Skips the slot at the read position once it has stayed claimed but
+		// unpublished for StallPasses calls; the skipped record counts as a drop
+		bool SkipStalled()
+		{
+			if (!pHeader) { return false; }
+
+			const uint64_t position = pHeader->readIndex.load(std::memory_order_relaxed);
+			Slot& slot = pSlots[position & mask];
+
+			// Only a claimed slot can stall: the write index is past it and the
+			// sequence still says "free for this position", or "being written"
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			if (pHeader->writeIndex.load(std::memory_order_acquire) <= position or
+				(sequence & SequencePosition) != position)
+			{
+				stalledPosition = UINT64_MAX;
+				return false;
+			}
+
+			if (position != stalledPosition) {
+				stalledPosition = position;
+				stalledPasses = 1;
+				return false;
+			}
+			if (++stalledPasses < StallPasses) { return false; }
+
+			// Release the slot to the next lap; a producer that was only paused then
+			// fails to start or publish. One paused inside its copy stays counted in
+			// the slot until it leaves.
+			const bool isWriting = (sequence & SequenceWriting) != 0;
+			if (isWriting and (sequence & SequenceStale) == SequenceStale) { return false; }
+			const uint64_t released = (sequence & SequenceStale) + (isWriting ? SequenceStaleUnit : 0) +
+				position + mask + 1;
+			if (!slot.sequence.compare_exchange_strong(sequence, released,
+				std::memory_order_acq_rel, std::memory_order_relaxed))
+			{
+				return false;
+			}
+			pHeader->readIndex.store(position + 1, std::memory_order_relaxed);
+			pHeader->dropped.fetch_add(1, std::memory_order_relaxed);
+			stalledPosition = UINT64_MAX;
+			return true;
+		}
+
+		// Drains available records into `sink(const Record&)`; returns the count.
+		// Each call is one pass towards skipping a stalled slot.
+		template <typename SinkFunc>
+		size_t Drain(SinkFunc&& sink, size_t maxRecords = SIZE_MAX)
+		{
+			Record record{};
+			size_t count{};
+			do {
+				while (count < maxRecords and TryRead(&record)) {
+					sink(record);
+					++count;
+				}
+			} while (count < maxRecords and SkipStalled());
+			return count;
+		}
+
+		// Discards everything pending and the drop count (consumer, before enabling)
+		void Clear()
+		{
+			Drain([](const Record&) {});
+			TakeDropped();
+		}
+
+		// Returns and clears the number of dropped records
+		uint64_t TakeDropped()
+		{
+			return pHeader ? pHeader->dropped.exchange(0, std::memory_order_relaxed) : 0;
+		}
+
+	private:
+		// A producer the consumer skipped during its copy has finished it. A
+		// record in the slot, published or still being written, may hold some
+		// of its bytes; a free slot is rewritten in full before it is read.
+		void LeaveSkippedSlot(Slot& slot, uint64_t index) const
+		{
+			uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+			uint64_t left{};
+			do {
+				const bool isFree = !(sequence & SequenceWriting) and ((sequence & SequencePosition) & mask) == index;
+				left = (sequence - SequenceStaleUnit) | (isFree ? 0 : SequenceOverlapped);
+			} while (!slot.sequence.compare_exchange_weak(sequence, left,
+				std::memory_order_release, std::memory_order_relaxed));
+		}
+	};
+}
+
+
+
+
+/*
+Usage example:
+
+	// Owner (consumer) process
+	void* pBlock = MapSharedBlock(Trace::RequiredBytes(4096));
+	Trace::Ring ring = Trace::Ring::Create(pBlock, Trace::RequiredBytes(4096), 4096);
+
+	// Consumer, when recording starts
+	ring.Clear();
+	ring.SetEnabled(true);
+
+	// Producer process
+	Trace::Ring ring = Trace::Ring::Attach(pBlock, Trace::RequiredBytes(4096));
+	ring.TryAppend({ Now(), pid, tid, uint16_t(Trace::Source::OskMain), 0, msg, wParam, lParam });
+
+	// Consumer thread
+	ring.Drain([](const Trace::Record& record) { Write(record); });
+
+*/
@@ -0,0 +1,127 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/PointerPredictor.h"
+
+// Windows system headers
+#include <windows.h>
+
+
+
+// Feeds coalesced mouse history into a PointerPredictor during a drag
+class DragPredictor
+{
+private:
+	static constexpr int HistorySize = 64;   // GetMouseMovePointsEx maximum
+
+	PointerPredictor predictor{};            // Portable prediction engine
+	bool isEnabled{};                        // Indicates if a drag is being predicted
+
+private:
+	// Pulls points newer than the last sample, up to the message point, from
+	// the system mouse history
+	void CollectHistory(const POINT& ptMessage, DWORD dwMessageTime)
+	{
+		MOUSEMOVEPOINT mmpCurrent{};
+		mmpCurrent.x = ptMessage.x & 0x0000FFFF;
+		mmpCurrent.y = ptMessage.y & 0x0000FFFF;
+		mmpCurrent.time = dwMessageTime;
+
+		MOUSEMOVEPOINT history[HistorySize]{};
+		int count = GetMouseMovePointsEx(sizeof(MOUSEMOVEPOINT),
+			&mmpCurrent, history, HistorySize, GMMP_USE_DISPLAY_POINTS);
+		// The search needs an exact point and time; time 0 takes the latest move to the point
+		if (count < 0) {
+			mmpCurrent.time = 0;
+			count = GetMouseMovePointsEx(sizeof(MOUSEMOVEPOINT),
+				&mmpCurrent, history, HistorySize, GMMP_USE_DISPLAY_POINTS);
+		}
+
+		// Points come newest first; feed the new ones oldest first
+		const uint32_t lastTime = predictor.GetLastTime();
+		for (int i = count - 1; i >= 0; --i) {
+			if (int32_t(history[i].time - lastTime) <= 0) { continue; }
+
+			// Display points are 16-bit; restore negative multi-monitor coordinates
+			LONG x = history[i].x > 32767 ? history[i].x - 65536 : history[i].x;
+			LONG y = history[i].y > 32767 ? history[i].y - 65536 : history[i].y;
+			predictor.AddSample({ x, y, history[i].time });
+		}
+	}
+
+public:
+	~DragPredictor() = default;
+	DragPredictor() = default;
+	DragPredictor(const DragPredictor&) = delete;
+	DragPredictor& operator=(const DragPredictor&) = delete;
+
+	explicit DragPredictor(const PointerPredictor::Config& config) :
+		predictor{ config }
+	{}
+
+	// Starts predicting a new drag
+	void Enable()
+	{
+		predictor.Reset();
+		isEnabled = true;
+	}
+
+	// Stops predicting
+	void Disable()
+	{
+		predictor.Reset();
+		isEnabled = false;
+	}
+
+	// Checks if a drag is being predicted
+	bool IsEnabled() const
+	{
+		return isEnabled;
+	}
+
+	// Returns the predicted cursor lead to add to a drag position
+	// (call while handling the mouse message of the drag)
+	POINT GetOffset()
+	{
+		if (!isEnabled) { return {}; }
+
+		// Position and input time of the current message; GetTickCount is too
+		// coarse (~15.6 ms) to measure a velocity with
+		const DWORD dwPos = GetMessagePos();
+		const POINT ptMessage{ (short)LOWORD(dwPos), (short)HIWORD(dwPos) };
+		const DWORD dwMessageTime = (DWORD)GetMessageTime();
+
+		CollectHistory(ptMessage, dwMessageTime);
+		predictor.AddSample({ ptMessage.x, ptMessage.y, dwMessageTime });  // Ignored if already collected
+
+		const PointerPredictor::Offset offset = predictor.Predict(dwMessageTime);
+		return { offset.dx, offset.dy };
+	}
+
+};
+
+
+
+
+/*
+Usage example:
+
+	static DragPredictor dragPredictor{};
+
+	case WM_*BUTTONDOWN:
+	{
+		dragPredictor.Enable();
+	}
+
+	case WM_MOUSEMOVE:
+	{
+		const POINT lead = dragPredictor.GetOffset();
+		MoveWindowTo(pt.x + lead.x, pt.y + lead.y);
+	}
+
+	case WM_*BUTTONUP:
+	{
+		dragPredictor.Disable();
+	}
+
+*/
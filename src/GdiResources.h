@@ -0,0 +1,143 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/ResourceLedger.h"
+
+// Windows system headers
+#include <windows.h>
+
+
+
+// Accounted GDI and USER handles; each wrapper frees its handle the way
+// Windows requires and keeps the live count per kind in the ledger
+namespace Gdi
+{
+	namespace Traits
+	{
+		template <typename T, Resources::Kind K>
+		struct Object
+		{
+			using Type = T;
+			static constexpr Resources::Kind kind = K;
+			static Type Invalid() { return NULL; }
+			static void Free(Type hObject) { DeleteObject(hObject); }
+		};
+
+		struct MemoryDC
+		{
+			using Type = HDC;
+			static constexpr Resources::Kind kind = Resources::Kind::DeviceContext;
+			static Type Invalid() { return NULL; }
+			static void Free(Type hdc) { DeleteDC(hdc); }
+		};
+
+		struct Icon
+		{
+			using Type = HICON;
+			static constexpr Resources::Kind kind = Resources::Kind::Icon;
+			static Type Invalid() { return NULL; }
+			static void Free(Type hIcon) { DestroyIcon(hIcon); }
+		};
+
+		struct Window
+		{
+			using Type = HWND;
+			static constexpr Resources::Kind kind = Resources::Kind::Window;
+			static Type Invalid() { return NULL; }
+			static void Free(Type hWnd) { DestroyWindow(hWnd); }
+		};
+	}
+
+	using OwnedDC = Resources::Owned<Traits::MemoryDC>;            // CreateCompatibleDC
+	using OwnedBitmap = Resources::Owned<Traits::Object<HBITMAP, Resources::Kind::Bitmap>>;
+	using OwnedPen = Resources::Owned<Traits::Object<HPEN, Resources::Kind::Pen>>;
+	using OwnedBrush = Resources::Owned<Traits::Object<HBRUSH, Resources::Kind::Brush>>;
+	using OwnedFont = Resources::Owned<Traits::Object<HFONT, Resources::Kind::Font>>;
+	using OwnedIcon = Resources::Owned<Traits::Icon>;              // ExtractIcon, CreateIcon...
+	using OwnedWindow = Resources::Owned<Traits::Window>;          // Windows this code destroys itself
+
+	// Window or screen DC from GetDC, released on scope exit
+	class ScopedWindowDC
+	{
+	private:
+		HWND hWnd{};
+		HDC hdc{};
+
+	public:
+		explicit ScopedWindowDC(HWND hTargetWnd) :
+			hWnd{ hTargetWnd },
+			hdc{ GetDC(hTargetWnd) }
+		{
+			if (hdc) { Resources::GetLedger().OnCreated(Resources::Kind::DeviceContext); }
+		}
+
+		~ScopedWindowDC()
+		{
+			if (hdc) {
+				ReleaseDC(hWnd, hdc);
+				Resources::GetLedger().OnDestroyed(Resources::Kind::DeviceContext);
+			}
+		}
+
+		ScopedWindowDC(const ScopedWindowDC&) = delete;
+		ScopedWindowDC& operator=(const ScopedWindowDC&) = delete;
+
+		HDC Get() const { return hdc; }
+		explicit operator bool() const { return hdc != NULL; }
+	};
+
+	// Selects an object into a DC and restores the previous one on scope exit
+	class ScopedSelect
+	{
+	private:
+		HDC hdc{};
+		HGDIOBJ hOldObject{};
+
+	public:
+		ScopedSelect(HDC hTargetDC, HGDIOBJ hObject) :
+			hdc{ hTargetDC },
+			hOldObject{ SelectObject(hTargetDC, hObject) }
+		{}
+
+		~ScopedSelect()
+		{
+			if (hOldObject and hOldObject != HGDI_ERROR) { SelectObject(hdc, hOldObject); }
+		}
+
+		ScopedSelect(const ScopedSelect&) = delete;
+		ScopedSelect& operator=(const ScopedSelect&) = delete;
+	};
+
+	// Process-wide object counts, including handles the wrappers never see
+	struct GuiCounts
+	{
+		DWORD gdiObjects{};
+		DWORD userObjects{};
+	};
+
+	inline GuiCounts GetGuiCounts()
+	{
+		return {
+			GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS),
+			GetGuiResources(GetCurrentProcess(), GR_USEROBJECTS)
+		};
+	}
+}
+
+
+
+
+/*
+Usage example:
+
+	Gdi::ScopedWindowDC screenDC{ NULL };
+	Gdi::OwnedDC memoryDC{ CreateCompatibleDC(screenDC.Get()) };
+	Gdi::OwnedPen pen{ CreatePen(PS_SOLID, 1, RGB(255, 0, 0)) };
+	if (!memoryDC or !pen) { return false; }
+
+	Gdi::ScopedSelect selectPen{ memoryDC.Get(), pen.Get() };
+	Rectangle(memoryDC.Get(), 0, 0, 10, 10);
+
+	// Everything is deselected, freed and uncounted in reverse order here
+
+*/
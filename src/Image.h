@@ -1,96 +1,96 @@
-// Auto-generated from: TabTap.png
-#pragma once
-
-constexpr unsigned char PNG_DATA[] = {
-0x89,0x50,0x4e,0x47,0x0d,0x0a,0x1a,0x0a,0x00,0x00,0x00,0x0d,0x49,0x48,0x44,0x52,
-0x00,0x00,0x00,0x1c,0x00,0x00,0x00,0x5f,0x08,0x06,0x00,0x00,0x00,0xfb,0xc1,0xa7,
-0x56,0x00,0x00,0x00,0x01,0x73,0x52,0x47,0x42,0x00,0xae,0xce,0x1c,0xe9,0x00,0x00,
-0x00,0x04,0x67,0x41,0x4d,0x41,0x00,0x00,0xb1,0x8f,0x0b,0xfc,0x61,0x05,0x00,0x00,
-0x00,0x09,0x70,0x48,0x59,0x73,0x00,0x00,0x0e,0xc1,0x00,0x00,0x0e,0xc1,0x01,0xb8,
-0x91,0x6b,0xed,0x00,0x00,0x00,0x18,0x74,0x45,0x58,0x74,0x53,0x6f,0x66,0x74,0x77,
-0x61,0x72,0x65,0x00,0x50,0x61,0x69,0x6e,0x74,0x2e,0x4e,0x45,0x54,0x20,0x35,0x2e,
-0x31,0x2e,0x34,0x12,0xdf,0xa6,0x83,0x00,0x00,0x00,0xb6,0x65,0x58,0x49,0x66,0x49,
-0x49,0x2a,0x00,0x08,0x00,0x00,0x00,0x05,0x00,0x1a,0x01,0x05,0x00,0x01,0x00,0x00,
-0x00,0x4a,0x00,0x00,0x00,0x1b,0x01,0x05,0x00,0x01,0x00,0x00,0x00,0x52,0x00,0x00,
-0x00,0x28,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x31,0x01,0x02,
-0x00,0x10,0x00,0x00,0x00,0x5a,0x00,0x00,0x00,0x69,0x87,0x04,0x00,0x01,0x00,0x00,
-0x00,0x6a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xd9,0x76,0x01,0x00,0xe8,0x03,0x00,
-0x00,0xd9,0x76,0x01,0x00,0xe8,0x03,0x00,0x00,0x50,0x61,0x69,0x6e,0x74,0x2e,0x4e,
-0x45,0x54,0x20,0x35,0x2e,0x31,0x2e,0x34,0x00,0x03,0x00,0x00,0x90,0x07,0x00,0x04,
-0x00,0x00,0x00,0x30,0x32,0x33,0x30,0x01,0xa0,0x03,0x00,0x01,0x00,0x00,0x00,0x01,
-0x00,0x00,0x00,0x05,0xa0,0x04,0x00,0x01,0x00,0x00,0x00,0x94,0x00,0x00,0x00,0x00,
-0x00,0x00,0x00,0x02,0x00,0x01,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x52,0x39,0x38,
-0x00,0x02,0x00,0x07,0x00,0x04,0x00,0x00,0x00,0x30,0x31,0x30,0x30,0x00,0x00,0x00,
-0x00,0x99,0x1b,0xf3,0xb7,0x8c,0x29,0xf2,0x22,0x00,0x00,0x04,0x46,0x49,0x44,0x41,
-0x54,0x68,0x43,0xed,0x9a,0x5d,0x6e,0xd3,0x40,0x10,0xc7,0xc7,0x4e,0xdb,0x34,0x89,
-0xfa,0x99,0xf6,0x05,0x54,0xe0,0x05,0x1e,0x11,0x02,0x21,0x50,0x5f,0x81,0x47,0xee,
-0xd0,0x63,0xf4,0x08,0x3d,0x46,0x4f,0x00,0x5c,0x82,0x22,0x71,0x00,0x28,0xe1,0x53,
-0x40,0x69,0x05,0x14,0x68,0xa0,0x25,0x4d,0x52,0x9b,0x99,0xf5,0x4c,0xb2,0x76,0x1c,
-0x7b,0x53,0x32,0x16,0xaa,0xf8,0x55,0xff,0xec,0x87,0x57,0xf9,0x7b,0xd6,0xde,0xe9,
-0xda,0x8a,0x07,0x00,0x21,0x4a,0x13,0xf2,0xe8,0xe1,0x05,0x41,0xc8,0x86,0x51,0x41,
-0x9f,0xa6,0x26,0xbd,0x5c,0x9e,0x86,0xb7,0xcd,0xdf,0x70,0x65,0xb1,0xc6,0xad,0xc8,
-0xd8,0x6b,0x7c,0xfc,0x3e,0xf0,0x95,0x5e,0xec,0x9c,0x4e,0x4f,0x58,0x99,0x32,0xe5,
-0xd7,0xc3,0x23,0x58,0x5d,0x59,0xa6,0xaa,0xe7,0x97,0x4a,0x1e,0x24,0xe5,0xfb,0xe3,
-0x51,0xe9,0xb8,0x03,0xc7,0xed,0x13,0x63,0x2a,0xf8,0x5c,0xaa,0x51,0x0d,0x03,0x98,
-0x9e,0x2e,0x43,0xe3,0xdb,0x21,0x35,0x43,0xdf,0x5c,0x24,0x4d,0x21,0x13,0xdd,0x00,
-0xe0,0xa8,0x69,0xea,0xea,0x11,0x12,0x15,0xf4,0x5d,0x98,0x9f,0x37,0x75,0x7d,0x43,
-0x8c,0x12,0x2f,0x27,0xde,0x1b,0x25,0xd3,0x2c,0x24,0x42,0x32,0x0d,0x79,0x7a,0x8b,
-0x31,0x24,0x78,0xa9,0x15,0x67,0x18,0x05,0x58,0xa0,0x21,0x3b,0xe2,0xb2,0xe0,0xba,
-0x96,0x98,0xb0,0xe8,0x29,0x95,0x6c,0xe9,0xa7,0x9d,0xd4,0x38,0xd5,0xaf,0x44,0x14,
-0x16,0xa1,0x78,0x7a,0xb8,0x3e,0x2c,0xff,0xbf,0xe7,0xe0,0xb0,0x0d,0x9f,0x7f,0x1c,
-0x71,0xab,0xff,0x9f,0x67,0x71,0xb1,0x02,0xf5,0xca,0x34,0x26,0x01,0xec,0x19,0xa7,
-0xe6,0x6a,0x53,0x58,0xe2,0xd4,0xb1,0xc8,0x8f,0x24,0x51,0xf9,0x14,0xa0,0x04,0x29,
-0xf5,0x61,0xca,0x1b,0x93,0x05,0x99,0x9a,0x72,0x6b,0x6b,0xcb,0x8c,0x5c,0x5d,0x5d,
-0x05,0xac,0x9b,0xce,0x61,0xe4,0x8d,0xa1,0xe3,0x64,0xfc,0x72,0xe7,0x3b,0xf7,0x08,
-0x1e,0xd4,0xeb,0x3c,0xa5,0xdc,0x33,0x56,0x06,0x83,0xa5,0x19,0x88,0x62,0x9c,0x68,
-0x34,0x1a,0xa6,0x42,0xd8,0xf5,0x61,0xb8,0x8c,0x21,0xc4,0x94,0xae,0x27,0x21,0xe7,
-0xa0,0xbe,0x2c,0xc8,0xd8,0x88,0xdb,0x3a,0x53,0x6a,0x49,0x50,0x35,0xec,0x85,0xd4,
-0x2f,0x20,0x60,0x4b,0xc5,0x29,0x4d,0x38,0x32,0x2a,0x86,0xb8,0x65,0xb2,0x7c,0xe2,
-0x8e,0x13,0xdb,0xdb,0xdb,0x5c,0x05,0xb0,0xeb,0xc3,0x70,0x19,0x43,0x58,0x41,0x19,
-0xa4,0x6d,0x67,0x9d,0xb1,0x40,0x0b,0xff,0xd9,0xfb,0x6f,0xa6,0x2e,0x4b,0x82,0x98,
-0x5f,0xaa,0xc1,0xb9,0x2a,0x2e,0x7c,0x3b,0x35,0x25,0x45,0xa4,0xf5,0x0f,0x53,0x12,
-0xbb,0xab,0x17,0xa1,0xa4,0xb6,0x34,0x5c,0xd2,0x9d,0x8d,0xa4,0xb6,0xe7,0x1f,0x38,
-0x42,0x16,0x31,0x83,0x11,0x9e,0xa7,0x08,0xb9,0xad,0x42,0x5a,0x24,0xde,0xe6,0xe6,
-0xe6,0xd0,0x08,0xd7,0xd6,0xd6,0x00,0x8f,0x73,0x2b,0x1f,0x1a,0x4f,0x11,0x6e,0x5b,
-0x11,0x46,0x78,0x18,0x61,0x55,0x2f,0x42,0x7b,0x2a,0xed,0x1a,0xa1,0x38,0xa5,0x6c,
-0x1b,0x77,0xd7,0x32,0x64,0x87,0x78,0x61,0xd0,0x31,0xe4,0xa8,0xb8,0x88,0x51,0xc0,
-0x35,0x44,0xc8,0x9c,0xb3,0x80,0xe2,0x35,0x64,0x12,0x21,0x7a,0xeb,0xeb,0xeb,0x43,
-0x97,0xc5,0xc6,0xc6,0x06,0xe0,0x71,0x6e,0xe5,0x43,0xe3,0x69,0x59,0xbc,0xfe,0xf4,
-0x83,0x7b,0x18,0x8c,0xae,0xba,0x50,0x81,0x73,0x95,0xb2,0xf1,0x1f,0x6a,0x78,0x1a,
-0x8c,0xe1,0xee,0x01,0xb7,0xa2,0x00,0x49,0xd3,0x6c,0x18,0xcb,0xa5,0x84,0xdd,0x4e,
-0xca,0xe5,0x38,0x41,0x06,0x74,0xad,0x48,0xc6,0x90,0x3e,0x98,0x58,0x2e,0x75,0xd9,
-0x06,0xba,0x6c,0x13,0xdf,0xed,0xf5,0x23,0x14,0xca,0xf3,0x1c,0x21,0xb7,0x0b,0x23,
-0xb6,0x4d,0x24,0xf2,0xb6,0x81,0x4e,0xdb,0x44,0x2b,0x0c,0x6b,0x36,0x0d,0x2a,0x11,
-0xe2,0x03,0x8b,0x51,0xc9,0xf3,0xb1,0x8c,0x24,0x28,0x19,0x46,0xa2,0x9b,0x45,0x24,
-0xa8,0x18,0xe2,0x73,0x14,0xff,0x91,0x59,0x14,0xad,0xa0,0x3a,0xa5,0x91,0x8a,0x88,
-0x90,0x4d,0x8c,0x7a,0xb1,0x46,0xc4,0xb6,0x89,0x44,0xde,0x36,0xd0,0x69,0x9b,0xd8,
-0x5b,0xd9,0x56,0x68,0x0c,0xf5,0xf4,0x53,0xc4,0x18,0xa0,0x85,0xbf,0xb7,0x6f,0x5e,
-0x55,0xc6,0x08,0x6b,0x93,0x83,0xa9,0x2d,0x4d,0x66,0x70,0x4a,0x7f,0x9a,0x84,0xd8,
-0x94,0xb2,0x84,0xcc,0x6d,0x22,0x31,0xca,0x56,0x51,0x52,0xdb,0xce,0xfe,0x4f,0xee,
-0x41,0xe8,0x44,0xd0,0xd1,0xaf,0x95,0xf5,0x52,0x5b,0xab,0x7d,0x62,0x5e,0x3d,0xb7,
-0xa9,0xec,0x04,0xb1,0xd7,0xd0,0x99,0xdb,0x44,0x62,0x94,0xad,0xa2,0x6c,0x13,0x9f,
-0xbe,0xd8,0xc5,0x96,0x17,0xdd,0x1c,0xf4,0xe1,0x85,0x70,0xe1,0x62,0x5d,0x2f,0xc2,
-0xaf,0xcd,0x16,0x7c,0x69,0xfe,0x86,0x7d,0xd2,0x4f,0x2a,0x5b,0x7c,0x44,0x69,0x1d,
-0x66,0xa1,0x62,0xd8,0x3d,0x09,0xe0,0x04,0x45,0xa5,0x48,0x50,0x31,0x0c,0xf0,0xfb,
-0x93,0x12,0x54,0x0c,0xed,0xb5,0x29,0x12,0x06,0x52,0x5b,0x1a,0xae,0x4f,0xbd,0x2e,
-0x50,0x0e,0xc8,0x5c,0x16,0xa3,0x42,0xd1,0x3c,0x7c,0xfc,0x8a,0x5b,0x7d,0x6e,0xdf,
-0xb8,0x90,0x9e,0xda,0x88,0x64,0x9f,0xab,0x5c,0x18,0x48,0x6d,0xa3,0xa4,0xb2,0x24,
-0x92,0xda,0x32,0x23,0xe4,0x76,0x61,0x0c,0xa4,0xb6,0x51,0x9f,0x7a,0x6d,0x24,0xb5,
-0xfd,0x53,0x11,0xfe,0x37,0x1c,0x3b,0x67,0xdf,0x30,0x35,0x97,0x8e,0x33,0x77,0x0a,
-0x92,0x89,0x0a,0xcb,0xa5,0xb7,0xae,0xaf,0x44,0x6f,0xa2,0x68,0x80,0xab,0x88,0xb4,
-0x7e,0x91,0x0b,0xb9,0xdb,0x44,0x9b,0xbc,0x3c,0x9b,0x95,0x4b,0xef,0xde,0xbc,0x08,
-0xb3,0xe5,0xa9,0xe2,0x6e,0x9a,0x0a,0x3d,0xd5,0x20,0xb9,0xdb,0x44,0x9b,0xbc,0x3c,
-0x9b,0x95,0x4b,0xef,0xdf,0xba,0x04,0x93,0x93,0x93,0x67,0x78,0x1d,0x7e,0xee,0x44,
-0xbb,0xef,0x33,0x12,0x21,0x6e,0xed,0x93,0x5a,0x9e,0x28,0xf2,0xa7,0x11,0x48,0xab,
-0xab,0x38,0xa5,0xf2,0x98,0x6d,0xff,0x09,0x4e,0xfb,0x52,0x1b,0xa7,0xf1,0xd6,0x03,
-0x68,0x12,0x95,0x5c,0xfa,0xe8,0xc9,0xe0,0x3a,0xbc,0x73,0x6d,0x05,0x66,0x47,0xcd,
-0xa5,0x2e,0x7a,0xb3,0x7b,0x80,0x25,0x19,0xc7,0x25,0x78,0x0f,0x1e,0xbf,0xb4,0x9a,
-0x3a,0x74,0x50,0xf7,0xae,0x9e,0x87,0xc5,0x99,0x6a,0x71,0x77,0xe9,0x4e,0xf3,0xd8,
-0x94,0x85,0x18,0x2e,0x2d,0xcf,0x40,0x99,0x7f,0xe3,0xa6,0x6e,0x38,0x87,0x66,0x73,
-0x5e,0x57,0x7e,0xc1,0x67,0xbd,0x57,0x54,0xe0,0xf2,0xa5,0x25,0x98,0xf3,0xbb,0x30,
-0x5b,0x5f,0xe0,0x1e,0x74,0xfc,0x75,0xd4,0x3a,0xd5,0x4d,0x13,0x64,0x2c,0xb6,0xe3,
-0x4e,0x17,0xf6,0x7e,0xb5,0xcd,0x34,0x0e,0xfc,0x36,0x11,0xa5,0x7d,0x97,0x5a,0x67,
-0x06,0xf0,0x07,0x5d,0x6f,0xaa,0x31,0xf6,0xcf,0x81,0x73,0x00,0x00,0x00,0x00,0x49,
-0x45,0x4e,0x44,0xae,0x42,0x60,0x82,
-};
-constexpr size_t PNG_DATA_SIZE = 1431;
+// Auto-generated from: TabTap.png
+#pragma once
+
+constexpr unsigned char PNG_DATA[] = {
+0x89,0x50,0x4e,0x47,0x0d,0x0a,0x1a,0x0a,0x00,0x00,0x00,0x0d,0x49,0x48,0x44,0x52,
+0x00,0x00,0x00,0x1c,0x00,0x00,0x00,0x5f,0x08,0x06,0x00,0x00,0x00,0xfb,0xc1,0xa7,
+0x56,0x00,0x00,0x00,0x01,0x73,0x52,0x47,0x42,0x00,0xae,0xce,0x1c,0xe9,0x00,0x00,
+0x00,0x04,0x67,0x41,0x4d,0x41,0x00,0x00,0xb1,0x8f,0x0b,0xfc,0x61,0x05,0x00,0x00,
+0x00,0x09,0x70,0x48,0x59,0x73,0x00,0x00,0x0e,0xc1,0x00,0x00,0x0e,0xc1,0x01,0xb8,
+0x91,0x6b,0xed,0x00,0x00,0x00,0x18,0x74,0x45,0x58,0x74,0x53,0x6f,0x66,0x74,0x77,
+0x61,0x72,0x65,0x00,0x50,0x61,0x69,0x6e,0x74,0x2e,0x4e,0x45,0x54,0x20,0x35,0x2e,
+0x31,0x2e,0x34,0x12,0xdf,0xa6,0x83,0x00,0x00,0x00,0xb6,0x65,0x58,0x49,0x66,0x49,
+0x49,0x2a,0x00,0x08,0x00,0x00,0x00,0x05,0x00,0x1a,0x01,0x05,0x00,0x01,0x00,0x00,
+0x00,0x4a,0x00,0x00,0x00,0x1b,0x01,0x05,0x00,0x01,0x00,0x00,0x00,0x52,0x00,0x00,
+0x00,0x28,0x01,0x03,0x00,0x01,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x31,0x01,0x02,
+0x00,0x10,0x00,0x00,0x00,0x5a,0x00,0x00,0x00,0x69,0x87,0x04,0x00,0x01,0x00,0x00,
+0x00,0x6a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xd9,0x76,0x01,0x00,0xe8,0x03,0x00,
+0x00,0xd9,0x76,0x01,0x00,0xe8,0x03,0x00,0x00,0x50,0x61,0x69,0x6e,0x74,0x2e,0x4e,
+0x45,0x54,0x20,0x35,0x2e,0x31,0x2e,0x34,0x00,0x03,0x00,0x00,0x90,0x07,0x00,0x04,
+0x00,0x00,0x00,0x30,0x32,0x33,0x30,0x01,0xa0,0x03,0x00,0x01,0x00,0x00,0x00,0x01,
+0x00,0x00,0x00,0x05,0xa0,0x04,0x00,0x01,0x00,0x00,0x00,0x94,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x02,0x00,0x01,0x00,0x02,0x00,0x04,0x00,0x00,0x00,0x52,0x39,0x38,
+0x00,0x02,0x00,0x07,0x00,0x04,0x00,0x00,0x00,0x30,0x31,0x30,0x30,0x00,0x00,0x00,
+0x00,0x99,0x1b,0xf3,0xb7,0x8c,0x29,0xf2,0x22,0x00,0x00,0x04,0x46,0x49,0x44,0x41,
+0x54,0x68,0x43,0xed,0x9a,0x5d,0x6e,0xd3,0x40,0x10,0xc7,0xc7,0x4e,0xdb,0x34,0x89,
+0xfa,0x99,0xf6,0x05,0x54,0xe0,0x05,0x1e,0x11,0x02,0x21,0x50,0x5f,0x81,0x47,0xee,
+0xd0,0x63,0xf4,0x08,0x3d,0x46,0x4f,0x00,0x5c,0x82,0x22,0x71,0x00,0x28,0xe1,0x53,
+0x40,0x69,0x05,0x14,0x68,0xa0,0x25,0x4d,0x52,0x9b,0x99,0xf5,0x4c,0xb2,0x76,0x1c,
+0x7b,0x53,0x32,0x16,0xaa,0xf8,0x55,0xff,0xec,0x87,0x57,0xf9,0x7b,0xd6,0xde,0xe9,
+0xda,0x8a,0x07,0x00,0x21,0x4a,0x13,0xf2,0xe8,0xe1,0x05,0x41,0xc8,0x86,0x51,0x41,
+0x9f,0xa6,0x26,0xbd,0x5c,0x9e,0x86,0xb7,0xcd,0xdf,0x70,0x65,0xb1,0xc6,0xad,0xc8,
+0xd8,0x6b,0x7c,0xfc,0x3e,0xf0,0x95,0x5e,0xec,0x9c,0x4e,0x4f,0x58,0x99,0x32,0xe5,
+0xd7,0xc3,0x23,0x58,0x5d,0x59,0xa6,0xaa,0xe7,0x97,0x4a,0x1e,0x24,0xe5,0xfb,0xe3,
+0x51,0xe9,0xb8,0x03,0xc7,0xed,0x13,0x63,0x2a,0xf8,0x5c,0xaa,0x51,0x0d,0x03,0x98,
+0x9e,0x2e,0x43,0xe3,0xdb,0x21,0x35,0x43,0xdf,0x5c,0x24,0x4d,0x21,0x13,0xdd,0x00,
+0xe0,0xa8,0x69,0xea,0xea,0x11,0x12,0x15,0xf4,0x5d,0x98,0x9f,0x37,0x75,0x7d,0x43,
+0x8c,0x12,0x2f,0x27,0xde,0x1b,0x25,0xd3,0x2c,0x24,0x42,0x32,0x0d,0x79,0x7a,0x8b,
+0x31,0x24,0x78,0xa9,0x15,0x67,0x18,0x05,0x58,0xa0,0x21,0x3b,0xe2,0xb2,0xe0,0xba,
+0x96,0x98,0xb0,0xe8,0x29,0x95,0x6c,0xe9,0xa7,0x9d,0xd4,0x38,0xd5,0xaf,0x44,0x14,
+0x16,0xa1,0x78,0x7a,0xb8,0x3e,0x2c,0xff,0xbf,0xe7,0xe0,0xb0,0x0d,0x9f,0x7f,0x1c,
+0x71,0xab,0xff,0x9f,0x67,0x71,0xb1,0x02,0xf5,0xca,0x34,0x26,0x01,0xec,0x19,0xa7,
+0xe6,0x6a,0x53,0x58,0xe2,0xd4,0xb1,0xc8,0x8f,0x24,0x51,0xf9,0x14,0xa0,0x04,0x29,
+0xf5,0x61,0xca,0x1b,0x93,0x05,0x99,0x9a,0x72,0x6b,0x6b,0xcb,0x8c,0x5c,0x5d,0x5d,
+0x05,0xac,0x9b,0xce,0x61,0xe4,0x8d,0xa1,0xe3,0x64,0xfc,0x72,0xe7,0x3b,0xf7,0x08,
+0x1e,0xd4,0xeb,0x3c,0xa5,0xdc,0x33,0x56,0x06,0x83,0xa5,0x19,0x88,0x62,0x9c,0x68,
+0x34,0x1a,0xa6,0x42,0xd8,0xf5,0x61,0xb8,0x8c,0x21,0xc4,0x94,0xae,0x27,0x21,0xe7,
+0xa0,0xbe,0x2c,0xc8,0xd8,0x88,0xdb,0x3a,0x53,0x6a,0x49,0x50,0x35,0xec,0x85,0xd4,
+0x2f,0x20,0x60,0x4b,0xc5,0x29,0x4d,0x38,0x32,0x2a,0x86,0xb8,0x65,0xb2,0x7c,0xe2,
+0x8e,0x13,0xdb,0xdb,0xdb,0x5c,0x05,0xb0,0xeb,0xc3,0x70,0x19,0x43,0x58,0x41,0x19,
+0xa4,0x6d,0x67,0x9d,0xb1,0x40,0x0b,0xff,0xd9,0xfb,0x6f,0xa6,0x2e,0x4b,0x82,0x98,
+0x5f,0xaa,0xc1,0xb9,0x2a,0x2e,0x7c,0x3b,0x35,0x25,0x45,0xa4,0xf5,0x0f,0x53,0x12,
+0xbb,0xab,0x17,0xa1,0xa4,0xb6,0x34,0x5c,0xd2,0x9d,0x8d,0xa4,0xb6,0xe7,0x1f,0x38,
+0x42,0x16,0x31,0x83,0x11,0x9e,0xa7,0x08,0xb9,0xad,0x42,0x5a,0x24,0xde,0xe6,0xe6,
+0xe6,0xd0,0x08,0xd7,0xd6,0xd6,0x00,0x8f,0x73,0x2b,0x1f,0x1a,0x4f,0x11,0x6e,0x5b,
+0x11,0x46,0x78,0x18,0x61,0x55,0x2f,0x42,0x7b,0x2a,0xed,0x1a,0xa1,0x38,0xa5,0x6c,
+0x1b,0x77,0xd7,0x32,0x64,0x87,0x78,0x61,0xd0,0x31,0xe4,0xa8,0xb8,0x88,0x51,0xc0,
+0x35,0x44,0xc8,0x9c,0xb3,0x80,0xe2,0x35,0x64,0x12,0x21,0x7a,0xeb,0xeb,0xeb,0x43,
+0x97,0xc5,0xc6,0xc6,0x06,0xe0,0x71,0x6e,0xe5,0x43,0xe3,0x69,0x59,0xbc,0xfe,0xf4,
+0x83,0x7b,0x18,0x8c,0xae,0xba,0x50,0x81,0x73,0x95,0xb2,0xf1,0x1f,0x6a,0x78,0x1a,
+0x8c,0xe1,0xee,0x01,0xb7,0xa2,0x00,0x49,0xd3,0x6c,0x18,0xcb,0xa5,0x84,0xdd,0x4e,
+0xca,0xe5,0x38,0x41,0x06,0x74,0xad,0x48,0xc6,0x90,0x3e,0x98,0x58,0x2e,0x75,0xd9,
+0x06,0xba,0x6c,0x13,0xdf,0xed,0xf5,0x23,0x14,0xca,0xf3,0x1c,0x21,0xb7,0x0b,0x23,
+0xb6,0x4d,0x24,0xf2,0xb6,0x81,0x4e,0xdb,0x44,0x2b,0x0c,0x6b,0x36,0x0d,0x2a,0x11,
+0xe2,0x03,0x8b,0x51,0xc9,0xf3,0xb1,0x8c,0x24,0x28,0x19,0x46,0xa2,0x9b,0x45,0x24,
+0xa8,0x18,0xe2,0x73,0x14,0xff,0x91,0x59,0x14,0xad,0xa0,0x3a,0xa5,0x91,0x8a,0x88,
+0x90,0x4d,0x8c,0x7a,0xb1,0x46,0xc4,0xb6,0x89,0x44,0xde,0x36,0xd0,0x69,0x9b,0xd8,
+0x5b,0xd9,0x56,0x68,0x0c,0xf5,0xf4,0x53,0xc4,0x18,0xa0,0x85,0xbf,0xb7,0x6f,0x5e,
+0x55,0xc6,0x08,0x6b,0x93,0x83,0xa9,0x2d,0x4d,0x66,0x70,0x4a,0x7f,0x9a,0x84,0xd8,
+0x94,0xb2,0x84,0xcc,0x6d,0x22,0x31,0xca,0x56,0x51,0x52,0xdb,0xce,0xfe,0x4f,0xee,
+0x41,0xe8,0x44,0xd0,0xd1,0xaf,0x95,0xf5,0x52,0x5b,0xab,0x7d,0x62,0x5e,0x3d,0xb7,
+0xa9,0xec,0x04,0xb1,0xd7,0xd0,0x99,0xdb,0x44,0x62,0x94,0xad,0xa2,0x6c,0x13,0x9f,
+0xbe,0xd8,0xc5,0x96,0x17,0xdd,0x1c,0xf4,0xe1,0x85,0x70,0xe1,0x62,0x5d,0x2f,0xc2,
+0xaf,0xcd,0x16,0x7c,0x69,0xfe,0x86,0x7d,0xd2,0x4f,0x2a,0x5b,0x7c,0x44,0x69,0x1d,
+0x66,0xa1,0x62,0xd8,0x3d,0x09,0xe0,0x04,0x45,0xa5,0x48,0x50,0x31,0x0c,0xf0,0xfb,
+0x93,0x12,0x54,0x0c,0xed,0xb5,0x29,0x12,0x06,0x52,0x5b,0x1a,0xae,0x4f,0xbd,0x2e,
+0x50,0x0e,0xc8,0x5c,0x16,0xa3,0x42,0xd1,0x3c,0x7c,0xfc,0x8a,0x5b,0x7d,0x6e,0xdf,
+0xb8,0x90,0x9e,0xda,0x88,0x64,0x9f,0xab,0x5c,0x18,0x48,0x6d,0xa3,0xa4,0xb2,0x24,
+0x92,0xda,0x32,0x23,0xe4,0x76,0x61,0x0c,0xa4,0xb6,0x51,0x9f,0x7a,0x6d,0x24,0xb5,
+0xfd,0x53,0x11,0xfe,0x37,0x1c,0x3b,0x67,0xdf,0x30,0x35,0x97,0x8e,0x33,0x77,0x0a,
+0x92,0x89,0x0a,0xcb,0xa5,0xb7,0xae,0xaf,0x44,0x6f,0xa2,0x68,0x80,0xab,0x88,0xb4,
+0x7e,0x91,0x0b,0xb9,0xdb,0x44,0x9b,0xbc,0x3c,0x9b,0x95,0x4b,0xef,0xde,0xbc,0x08,
+0xb3,0xe5,0xa9,0xe2,0x6e,0x9a,0x0a,0x3d,0xd5,0x20,0xb9,0xdb,0x44,0x9b,0xbc,0x3c,
+0x9b,0x95,0x4b,0xef,0xdf,0xba,0x04,0x93,0x93,0x93,0x67,0x78,0x1d,0x7e,0xee,0x44,
+0xbb,0xef,0x33,0x12,0x21,0x6e,0xed,0x93,0x5a,0x9e,0x28,0xf2,0xa7,0x11,0x48,0xab,
+0xab,0x38,0xa5,0xf2,0x98,0x6d,0xff,0x09,0x4e,0xfb,0x52,0x1b,0xa7,0xf1,0xd6,0x03,
+0x68,0x12,0x95,0x5c,0xfa,0xe8,0xc9,0xe0,0x3a,0xbc,0x73,0x6d,0x05,0x66,0x47,0xcd,
+0xa5,0x2e,0x7a,0xb3,0x7b,0x80,0x25,0x19,0xc7,0x25,0x78,0x0f,0x1e,0xbf,0xb4,0x9a,
+0x3a,0x74,0x50,0xf7,0xae,0x9e,0x87,0xc5,0x99,0x6a,0x71,0x77,0xe9,0x4e,0xf3,0xd8,
+0x94,0x85,0x18,0x2e,0x2d,0xcf,0x40,0x99,0x7f,0xe3,0xa6,0x6e,0x38,0x87,0x66,0x73,
+0x5e,0x57,0x7e,0xc1,0x67,0xbd,0x57,0x54,0xe0,0xf2,0xa5,0x25,0x98,0xf3,0xbb,0x30,
+0x5b,0x5f,0xe0,0x1e,0x74,0xfc,0x75,0xd4,0x3a,0xd5,0x4d,0x13,0x64,0x2c,0xb6,0xe3,
+0x4e,0x17,0xf6,0x7e,0xb5,0xcd,0x34,0x0e,0xfc,0x36,0x11,0xa5,0x7d,0x97,0x5a,0x67,
+0x06,0xf0,0x07,0x5d,0x6f,0xaa,0x31,0xf6,0xcf,0x81,0x73,0x00,0x00,0x00,0x00,0x49,
+0x45,0x4e,0x44,0xae,0x42,0x60,0x82,
+};
+constexpr size_t PNG_DATA_SIZE = 1431;
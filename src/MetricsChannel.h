@@ -0,0 +1,117 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/MetricsRegistry.h"
+
+// Windows system headers
+#include <windows.h>
+#include <tchar.h>
+
+
+
+// Shared-memory metrics registry that TabTap and the hook inside osk.exe record into
+class MetricsChannel
+{
+public:
+	static constexpr LPCTSTR MappingName = _T("Local\\TabTapMetrics");
+
+private:
+	HANDLE hMapping{};           // Named file mapping
+	void* pView{};               // Mapped registry block
+	Metrics::Registry registry{};  // Registry view over `pView` (handles point here)
+
+private:
+	bool Map()
+	{
+		pView = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, Metrics::RequiredBytes());
+		if (!pView) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+public:
+	~MetricsChannel() { Close(); }
+	MetricsChannel() = default;
+	MetricsChannel(const MetricsChannel&) = delete;
+	MetricsChannel& operator=(const MetricsChannel&) = delete;
+
+	// Creates the registry (TabTap, before the OSK is started)
+	bool Create()
+	{
+		if (IsOpen()) { return true; }
+
+		constexpr size_t bytes = Metrics::RequiredBytes();
+		hMapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+			0, DWORD(bytes), MappingName);
+		if (!hMapping) { return false; }
+
+		const bool isExisting = (GetLastError() == ERROR_ALREADY_EXISTS);
+		if (!Map()) { return false; }
+
+		registry = isExisting ?
+			Metrics::Registry::Attach(pView, bytes) :
+			Metrics::Registry::Create(pView, bytes);  // Fresh mappings are zeroed
+		if (!registry.IsValid()) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	// Opens the registry created by TabTap (hook side); fails quietly if absent
+	bool Open()
+	{
+		if (IsOpen()) { return true; }
+
+		hMapping = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, MappingName);
+		if (!hMapping) { return false; }
+		if (!Map()) { return false; }
+
+		registry = Metrics::Registry::Attach(pView, Metrics::RequiredBytes());
+		if (!registry.IsValid()) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	// Handles taken from the registry must not be used after this
+	void Close()
+	{
+		registry = {};
+		if (pView) { UnmapViewOfFile(pView); pView = nullptr; }
+		if (hMapping) { CloseHandle(hMapping); hMapping = NULL; }
+	}
+
+	bool IsOpen() const
+	{
+		return registry.IsValid();
+	}
+
+	// Returns the registry (handles keep pointing at this object)
+	Metrics::Registry& GetRegistry()
+	{
+		return registry;
+	}
+};
+
+
+
+
+/*
+Usage example:
+
+	static MetricsChannel metricsChannel{};
+
+	// TabTap (before starting the OSK)
+	metricsChannel.Create();
+
+	// Hook, once inside osk.exe
+	metricsChannel.Open();
+	Metrics::Counter commands = metricsChannel.GetRegistry().AddCounter(
+		"tabtap_hook_commands_total", "Commands handled by the hook");
+	commands.Add();
+
+*/
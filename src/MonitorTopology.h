@@ -0,0 +1,58 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/StateSnapshot.h"
+
+// Windows system headers
+#include <windows.h>
+
+// Standard library headers
+#include <algorithm>
+#include <vector>
+
+
+
+// Monitor rectangles sorted left to right, then top to bottom
+inline std::vector<Geometry::Rect> GetMonitorRects()
+{
+	std::vector<Geometry::Rect> monitors{};
+
+	EnumDisplayMonitors(NULL, NULL,
+		[](HMONITOR hMonitor, HDC, LPRECT, LPARAM lParam) -> BOOL {
+			MONITORINFO info{ sizeof(MONITORINFO) };
+			if (GetMonitorInfo(hMonitor, &info)) {
+				reinterpret_cast<std::vector<Geometry::Rect>*>(lParam)->push_back({
+					info.rcMonitor.left, info.rcMonitor.top,
+					info.rcMonitor.right, info.rcMonitor.bottom
+				});
+			}
+			return TRUE;
+		},
+		reinterpret_cast<LPARAM>(&monitors));
+
+	// Enumeration order is not guaranteed
+	std::sort(monitors.begin(), monitors.end(),
+		[](const Geometry::Rect& a, const Geometry::Rect& b) {
+			return a.left != b.left ? a.left < b.left : a.top < b.top;
+		});
+
+	return monitors;
+}
+
+// Identifies the current monitor layout (same value in TabTap and the hook)
+inline uint64_t GetMonitorTopologyId()
+{
+	const std::vector<Geometry::Rect> monitors = GetMonitorRects();
+	return Snapshot::HashTopology(monitors.data(), monitors.size());
+}
+
+
+
+
+/*
+Usage example:
+
+	const Snapshot::Placement* pPlacement =
+		Snapshot::FindPlacement(state, GetMonitorTopologyId());
+
+*/
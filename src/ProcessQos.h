@@ -0,0 +1,57 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/PowerPolicy.h"
+
+// Windows system headers
+#include <windows.h>
+
+
+
+// Applies a Power::Qos level to the current process
+inline bool ApplyProcessQos(Power::Qos qos)
+{
+	// EcoQoS throttles execution speed; the other levels opt out explicitly
+	PROCESS_POWER_THROTTLING_STATE state{};
+	state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+	state.ControlMask = PROCESS_POWER_THROTTLING_EXECUTION_SPEED;
+	state.StateMask = (qos == Power::Qos::Eco) ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+
+	BOOL bThrottled = SetProcessInformation(GetCurrentProcess(),
+		ProcessPowerThrottling, &state, sizeof(state));
+
+	DWORD dwPriorityClass =
+		qos == Power::Qos::Eco  ? IDLE_PRIORITY_CLASS :
+		qos == Power::Qos::High ? ABOVE_NORMAL_PRIORITY_CLASS :
+		NORMAL_PRIORITY_CLASS;
+
+	BOOL bPriority = SetPriorityClass(GetCurrentProcess(), dwPriorityClass);
+
+	return bThrottled and bPriority;
+}
+
+// Total user and kernel CPU time of the current process in milliseconds
+inline uint64_t GetProcessCpuMs()
+{
+	FILETIME ftCreation{}, ftExit{}, ftKernel{}, ftUser{};
+	if (!GetProcessTimes(GetCurrentProcess(), &ftCreation, &ftExit, &ftKernel, &ftUser)) {
+		return 0;
+	}
+
+	ULARGE_INTEGER kernel{ ftKernel.dwLowDateTime, ftKernel.dwHighDateTime };
+	ULARGE_INTEGER user{ ftUser.dwLowDateTime, ftUser.dwHighDateTime };
+	return (kernel.QuadPart + user.QuadPart) / 10000;  // 100 ns units
+}
+
+
+
+
+/*
+Usage example:
+
+	Power::Decision decision{};
+	if (policy.TakeChange(&decision)) {
+		ApplyProcessQos(decision.qos);
+	}
+
+*/
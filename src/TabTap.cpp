@@ -1,1700 +1,3654 @@
-// Implementation-specific headers
-#include "TabTap.h"
-#include "resource.h"
-#include "UIComponents.h"
-#include "CustomIncludes/WinApi/MessageBoxNotifier.h"
-#include "CustomIncludes/WinApi/ThemeManager.h"
-#include "CustomIncludes/WinApi/WindowDragger.h"
-#include "CustomIncludes/WinApi/MouseTracker.h"
-#include "CustomIncludes/WinApi/WorkAreaManager.h"
-#include "CustomIncludes/WinApi/RegistryManager.h"
-
-// Default headers
-#include <mutex>
-#include <algorithm>
-
-// Windows system headers
-#include <Windows.h>
-#include <windowsx.h>  // For GET_X_LPARAM, GET_Y_LPARAM
-#include <PathCch.h>
-
-// Library links
-#pragma comment(lib, "Pathcch.lib")
-
-
-
-namespace Config
-{
-	// Application identity
-	constexpr LPCTSTR ApplicationName = _T("TabTap");
-	constexpr LPCTSTR MainWindowClass = _T("TabTapMainClass");
-
-	// Registry paths
-	namespace Registry
-	{
-		constexpr LPCTSTR ApplicationSettings = _T("Software\\Empurple\\TabTap");
-		constexpr LPCTSTR AutoRun             = _T("Software\\Microsoft\\Windows\\CurrentVersion\\Run");
-		constexpr LPCTSTR OSKSettings         = _T("Software\\Microsoft\\Osk");
-	}
-
-	// On-Screen Keyboard configuration
-	namespace OSK
-	{
-		constexpr LPCTSTR WindowClass = _T("OSKMainClass");
-		constexpr LPCTSTR DefaultPath = _T("%WINDIR%\\System32\\osk.exe");
-	}
-}
-
-
-
-// Main Application Window Manager (Singleton)
-class MainWindow
-{
-public:
-	// --- Window display states ---
-	enum class ExpansionState
-	{
-		Collapsed,     // Minimized/narrow state
-		Expanded       // Full-width state
-	};
-
-	// --- Registry management ---
-	struct Registry
-	{
-		// Query the autorun setting
-		static DWORD GetAutostartValue(bool*);
-		// Explicitly set or clear the value
-		static DWORD SetAutostartValue(bool);
-		// Flip value
-		static DWORD ToggleAutostartValue(bool* = nullptr);
-	};
-
-private:
-	// --- Size presets ---
-	const SIZE collapsedSize = { 7, 95 };
-	const SIZE expandedSize = { 28, 95 };
-
-	// --- Runtime MainWindow::ExpansionState Variables ---
-	HWND hMainWnd{};          // Main window handle
-	RECT rcMainWnd{};         // Current window rectangle
-	ExpansionState expansionState{};  // Current expansion state
-	ScreenEdge edgeSide{};    // ScreenEdge where window is snapped
-
-private:
-	// --- Construction Control ---
-	/// Prevent instantiation, copying, and assignment
-	~MainWindow() = default;
-	MainWindow() = default;
-	MainWindow(const MainWindow&) = delete;
-	MainWindow& operator=(const MainWindow&) = delete;
-
-public:
-	// --- Singleton access ---
-	static MainWindow& Instance();
-
-	// --- Window state management ---
-	/// Updates the window's stored rectangle (call after position/size changes)
-	static void UpdateWndRect();
-	/// Returns the current window rectangle
-	static const RECT& GetRect();
-	/// Returns the window size for a given state (Collapsed/Expanded)
-	static const SIZE& GetSize(const MainWindow::ExpansionState&);
-	/// Returns the current window size (based on current state)
-	static const SIZE& GetSize();
-
-	// --- ScreenEdge (Screen Side) Management ---
-	/// Gets which screen edge the window is attached to (Left/Right)
-	static ScreenEdge GetSnapEdge();
-	/// Move window to specified edge (Left/Right)
-	static bool SetSnapEdge(const ScreenEdge&);
-	/// Toggles between Left/Right edges
-	static bool ToggleSnapEdge();
-	/// Checks if window is on specified edge
-	static bool IsSnapEdge(const ScreenEdge&);
-	/// 
-	static bool IsValidSnapEdge(const ScreenEdge&);
-
-	// --- Expansion MainWindow::ExpansionState Management ---
-	/// Gets current expansion state (Collapsed/Expanded)
-	static MainWindow::ExpansionState GetExpansionState();
-	/// Sets window to specified state (with proper sizing)
-	static void SetExpansionState(const MainWindow::ExpansionState&);
-	/// Toggles between Collapsed/Expanded states
-	static void ToggleExpansionState();
-	/// Checks if window is in specified state
-	static bool IsExpansionState(const MainWindow::ExpansionState&);
-
-	// --- Position Management ---
-	/// Constrains a point to stay within work area boundaries
-	static POINT ClampPoint(const POINT&);
-	/// Moves window to specified point (clamped to work area)
-	static bool SetPosition(const POINT&);
-	/// Bring window to top layer
-	static void EnforceTopmost();
-
-	// --- Window handle management ---
-	/// Sets the HWND for the main window
-	static void SetHandle(HWND);
-	/// Gets the current window handle
-	static HWND GetHandle();
-};
-
-
-// On-Screen Keyboard Window Manager (Singleton)
-class OSKWindow
-{
-private:
-	// --- Runtime MainWindow::ExpansionState Variables ---
-	HWND hOskWnd{};         // Handle to the OSK window
-	RECT rcWndRect{};       // Current window rectangle
-	SIZE wndSize{};         // Current window dimensions
-
-private:
-	// --- Construction Control ---
-	/// Prevent instantiation, copying, and assignment
-	OSKWindow() = default;
-	~OSKWindow() = default;
-	OSKWindow(const OSKWindow&) = delete;
-	OSKWindow& operator=(const OSKWindow&) = delete;
-
-public:
-	// --- Registry management ---
-	struct Registry
-	{
-		// Query the 'Dock' setting
-		static DWORD GetDockModeValue(bool*);
-		// Explicitly set or clear the value
-		static DWORD SetDockModeValue(bool);
-		// Flip value
-		static DWORD ToggleDockModeValue(bool* = nullptr);
-	};
-
-public:
-	// --- Singleton access ---
-	static OSKWindow& Instance();
-
-	// --- Window Management ---
-	/// Updates the stored window rectangle
-	static void UpdateWndRect();
-	/// Returns the current window rectangle
-	static const RECT& GetRect();
-	/// Returns the current window dimensions
-	static const SIZE& GetSize();
-
-	// --- Window Handle Management  ---
-	/// Sets the OSK window handle
-	static void SetHandle(HWND hWnd);
-	/// Gets the current OSK window handle
-	static HWND GetHandle();
-
-	// --- MainWindow::ExpansionState Management  ---
-	static DWORD ToggleDockMode();
-};
-
-
-// Drawing Context Manager
-class DrawContext
-{
-private:
-	HWND m_hWnd;
-	// --- Component Instances ---
-	GDIPlusData* pGdiPlus{};          // GDI+ manager instance for image handling
-	BlinkData* pBlinker{};            // Blink effect data
-	AnimationData* pAnimator{};       // Animation control data
-	EdgeSnapData* pSnapper{};         // ScreenEdge-snapping control data
-	WindowDragger* pDragger{};        // Drag operation data
-
-	// --- Operation MainWindow::ExpansionState ---
-	Result result{};                  // Operation result storage
-
-private:
-	// --- Internal Methods ---
-	Result SetResult(Result);
-	Result InitializeComponents();
-
-public:
-	// --- Lifecycle Management ---
-	~DrawContext();
-	DrawContext(HWND);
-	DrawContext(const DrawContext&) = delete;
-	DrawContext& operator=(const DrawContext&) = delete;
-
-	// --- Component Access ---
-	GDIPlusData* GdiPlus()     const { return pGdiPlus; };
-	BlinkData* Blinker()       const { return pBlinker; };
-	AnimationData* Animator()  const { return pAnimator; };
-	WindowDragger* Dragger()   const { return pDragger; };
-	EdgeSnapData* Snapper()    const { return pSnapper; };
-
-	// --- Drawing Operations ---
-	Result DrawImageOnLayeredWindow();
-
-	// --- Status Handling ---
-	Result GetResult() const;
-};
-
-
-
-// --- MainWindow ---
-
-MainWindow& MainWindow::Instance()
-{
-	static MainWindow instance{};
-	return instance;
-}
-
-void MainWindow::UpdateWndRect()  // Update after changes
-{
-	if (!Instance().hMainWnd) { return; }
-
-	GetWindowRect(
-		Instance().hMainWnd, &Instance().rcMainWnd
-	);
-}
-
-const RECT& MainWindow::GetRect()
-{
-	return Instance().rcMainWnd;
-}
-
-const SIZE& MainWindow::GetSize(const ExpansionState& state)
-{
-	return (state == MainWindow::ExpansionState::Collapsed)
-		? Instance().collapsedSize
-		: Instance().expandedSize;
-}
-
-const SIZE& MainWindow::GetSize()
-{
-	return GetSize(GetExpansionState());
-}
-
-ScreenEdge MainWindow::GetSnapEdge()
-{
-	return Instance().edgeSide;
-}
-
-bool MainWindow::SetSnapEdge(const ScreenEdge& edge)
-{
-	if (!IsValidSnapEdge(edge)) { return false; }
-
-	if (Instance().hMainWnd) {
-		const auto [cx, cy] = GetSize();
-		const LONG x = (edge == ScreenEdge::Right)
-			? GetSystemMetrics(SM_CXSCREEN) - cx
-			: 0;
-
-		POINT pt = ClampPoint({
-			x, Instance().rcMainWnd.top
-			});
-
-		SetWindowPos(
-			Instance().hMainWnd, nullptr,
-			pt.x, pt.y,
-			cx, cy,
-			SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
-		);
-	}
-
-	Instance().edgeSide = edge;
-	UpdateWndRect();
-
-	return true;
-}
-
-bool MainWindow::ToggleSnapEdge()
-{
-	return SetSnapEdge(GetSnapEdge() == ScreenEdge::Left
-		? ScreenEdge::Right
-		: ScreenEdge::Left
-	);
-}
-
-bool MainWindow::IsSnapEdge(const ScreenEdge& edge)
-{
-	return edge == GetSnapEdge();
-}
-
-bool MainWindow::IsValidSnapEdge(const ScreenEdge& edge)
-{
-	if (edge != ScreenEdge::Left and edge != ScreenEdge::Right) {
-		return false;
-	}
-	if (!WorkAreaManager::IsFreeEdge(edge)) {
-		return false;
-	}
-
-	return true;
-}
-
-MainWindow::ExpansionState MainWindow::GetExpansionState()
-{
-	return Instance().expansionState;
-}
-
-void MainWindow::SetExpansionState(const ExpansionState& state)
-{
-	const auto& size = (state == MainWindow::ExpansionState::Expanded)
-		? Instance().expandedSize
-		: Instance().collapsedSize;
-
-	const LONG screenWidth = GetSystemMetrics(SM_CXSCREEN);
-	const LONG x = (GetSnapEdge() == ScreenEdge::Right)
-		? screenWidth - size.cx
-		: 0;
-
-	if (Instance().hMainWnd) {
-		SetWindowPos(Instance().hMainWnd, nullptr,
-			x, Instance().rcMainWnd.top,
-			size.cx, size.cy,
-			SWP_NOZORDER | SWP_NOACTIVATE
-		);
-	}
-	Instance().expansionState = state;
-	UpdateWndRect();
-}
-
-void MainWindow::ToggleExpansionState()
-{
-	SetExpansionState(GetExpansionState() == MainWindow::ExpansionState::Collapsed
-		? MainWindow::ExpansionState::Expanded
-		: MainWindow::ExpansionState::Collapsed
-	);
-}
-
-bool MainWindow::IsExpansionState(const MainWindow::ExpansionState& state)
-{
-	return state == GetExpansionState();
-}
-
-POINT MainWindow::ClampPoint(const POINT& point)
-{
-	return {
-		// X-axis constraint
-		std::clamp(
-			point.x,
-			WorkAreaManager::GetWorkArea().left,
-			WorkAreaManager::GetWorkArea().right - GetSize().cx
-		),
-			// Y-axis constraint
-			std::clamp(
-				point.y,
-				WorkAreaManager::GetWorkArea().top,
-				WorkAreaManager::GetWorkArea().bottom - GetSize().cy
-			)
-	};
-}
-
-bool MainWindow::SetPosition(const POINT& point)
-{
-	// Clamp top position
-	LONG newTop = ClampPoint({ point }).y;
-
-	// Update window rectangle manually
-	Instance().rcMainWnd.top = newTop;
-	Instance().rcMainWnd.bottom = newTop + GetSize().cy;
-
-	return SetWindowPos(
-		Instance().hMainWnd, NULL,
-		GetRect().left, GetRect().top,
-		0, 0,
-		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
-	);
-}
-
-void MainWindow::EnforceTopmost()
-{
-	SetWindowPos(
-		Instance().hMainWnd, HWND_TOPMOST,
-		0, 0, 0, 0,
-		SWP_NOSIZE | SWP_NOMOVE | SWP_NOACTIVATE
-	);
-}
-
-void MainWindow::SetHandle(HWND hWnd)
-{
-	Instance().hMainWnd = hWnd;
-}
-
-HWND MainWindow::GetHandle()
-{
-	return Instance().hMainWnd;
-}
-
-
-// --- MainWindow::Registry ---
-
-DWORD MainWindow::Registry::GetAutostartValue(bool* pRetVal)
-{
-	// Check if autostart is enabled in the registry
-	DWORD dwResult =
-		RegistryManager{
-			false, Config::Registry::AutoRun
-		}.QueryValue(Config::ApplicationName);
-
-	if (dwResult == ERROR_SUCCESS) {
-		*pRetVal = true;
-	}
-	else if (dwResult != ERROR_FILE_NOT_FOUND) {
-		return dwResult;
-	}
-	else { *pRetVal = false; }
-
-	return ERROR_SUCCESS;
-}
-
-DWORD MainWindow::Registry::SetAutostartValue(bool enable)
-{
-	if (enable) {
-		TCHAR pathBuffer[MAX_PATH + 2] = { _T('"') };
-		DWORD len = GetModuleFileName(nullptr, pathBuffer + 1, MAX_PATH);
-		if (!len or len >= MAX_PATH) {
-			return ERROR_INSUFFICIENT_BUFFER;
-		}
-		pathBuffer[len + 1] = _T('"');
-
-		return
-			RegistryManager{
-				false, Config::Registry::AutoRun
-			}.WriteString(Config::ApplicationName, pathBuffer);
-	}
-	else {
-		return
-			RegistryManager{
-				false, Config::Registry::AutoRun
-			}.RemoveValue(Config::ApplicationName);
-	}
-}
-
-DWORD MainWindow::Registry::ToggleAutostartValue(bool* pRetVal)
-{
-	bool isAutostartEnabled{};
-	DWORD dwResult;
-
-	// Check if autostart is enabled in the registry
-	dwResult = GetAutostartValue(&isAutostartEnabled);
-	if (dwResult != ERROR_SUCCESS) {
-		return dwResult;
-	}
-
-	dwResult = SetAutostartValue(!isAutostartEnabled);
-	if (pRetVal and dwResult == ERROR_SUCCESS) {
-		*pRetVal = !isAutostartEnabled;
-	}
-
-	return dwResult;
-}
-
-
-
-// --- OSKWindow ---
-
-OSKWindow& OSKWindow::Instance()
-{
-	static OSKWindow instance{};
-	return instance;
-}
-
-void OSKWindow::UpdateWndRect()
-{
-	GetWindowRect(
-		Instance().hOskWnd, &Instance().rcWndRect
-	);
-
-	Instance().wndSize = {
-		Instance().rcWndRect.right - Instance().rcWndRect.left,
-		Instance().rcWndRect.bottom - Instance().rcWndRect.top
-	};
-}
-
-const RECT& OSKWindow::GetRect()
-{
-	return Instance().rcWndRect;
-}
-
-const SIZE& OSKWindow::GetSize()
-{
-	return Instance().wndSize;
-}
-
-void OSKWindow::SetHandle(HWND hWnd)
-{
-	Instance().hOskWnd = hWnd;
-}
-
-HWND OSKWindow::GetHandle()
-{
-	return Instance().hOskWnd;
-}
-
-DWORD OSKWindow::ToggleDockMode()
-{
-	bool isDockMode{};
-	DWORD dwResult = Registry::ToggleDockModeValue(&isDockMode);
-	if (dwResult != ERROR_SUCCESS) {
-		return dwResult;
-	}
-
-	UINT msgID = isDockMode ? ID_APP_DOCKMODE : ID_APP_REGULARMODE;
-	PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
-		MAKEWPARAM(msgID, 0), (LPARAM)MainWindow::GetHandle());
-
-	return dwResult;
-}
-
-
-// --- OSKWindow::Registry ---
-
-DWORD OSKWindow::Registry::GetDockModeValue(bool* pRetVal)
-{
-	// Check if 'Dock' is enabled in the registry
-	DWORD dwData;
-	DWORD dwResult = 
-		RegistryManager{
-			false, Config::Registry::OSKSettings
-		}.ReadDWORD(_T("Dock"), &dwData);
-		
-	if (dwResult == ERROR_SUCCESS) {
-		*pRetVal = (dwData == 1);
-	}
-
-	return dwResult;
-}
-
-DWORD OSKWindow::Registry::SetDockModeValue(bool enable)
-{
-	DWORD newVal = enable ? 1 : 0;
-
-	return
-		RegistryManager{
-			false, Config::Registry::OSKSettings
-		}.WriteDWORD(_T("Dock"), newVal);
-}
-
-DWORD OSKWindow::Registry::ToggleDockModeValue(bool* pRetVal)
-{
-	bool isDockEnabled{};
-	DWORD dwResult;
-
-	// Check if 'Dock' is enabled in the registry
-	dwResult = GetDockModeValue(&isDockEnabled);
-	if (dwResult != ERROR_SUCCESS) {
-		return dwResult;
-	}
-
-	dwResult = SetDockModeValue(!isDockEnabled);
-	if (pRetVal and dwResult == ERROR_SUCCESS) {
-		*pRetVal = !isDockEnabled;
-	}
-	
-	return dwResult;
-}
-
-
-
-// --- DrawContext ---
-
-Result DrawContext::SetResult(Result res)
-{
-	result = std::move(res);
-	return std::move(res);
-}
-
-Result DrawContext::InitializeComponents()
-{
-	pGdiPlus = new GDIPlusData{};
-	if (!GdiPlus()->GetResult().success) {
-		return SetResult(
-			GdiPlus()->GetResult());
-	}
-
-	pDragger = new WindowDragger{};
-	pSnapper = new EdgeSnapData{};
-	pAnimator = new AnimationData{};
-	pBlinker = new BlinkData{};
-
-	return {};
-}
-
-DrawContext::~DrawContext()
-{
-	delete Snapper();
-	delete Dragger();
-	delete Animator();
-	delete Blinker();
-	delete GdiPlus();
-}
-
-DrawContext::DrawContext(HWND hWnd) :
-	m_hWnd{ hWnd }
-{
-	InitializeComponents();
-}
-
-Result DrawContext::DrawImageOnLayeredWindow()
-{
-	HDC hdcScreen{};
-	HDC hdcMem{};
-	HBITMAP hBitmap{};
-	HBITMAP hOldBmp{}; // No cleanup needed
-	Gdiplus::Graphics* pGraphics{};
-
-	auto cleanup = [&]() {
-		if (pGraphics) {
-			delete pGraphics; // Delete GDI+ Graphics object
-		}
-		if (hdcMem) {
-			if (hOldBmp) { // Select original bitmap back if needed
-				SelectObject(hdcMem, hOldBmp);
-			}
-			if (hBitmap) { // Delete the DIB section we created
-				DeleteObject(hBitmap);
-			}
-			DeleteDC(hdcMem); // Delete the memory DC
-		}
-		if (hdcScreen) {
-			ReleaseDC(NULL, hdcScreen); // Release the screen DC
-		}
-		};
-
-	// --- Get required resources and check for errors ---
-
-	SIZE mainSize = MainWindow::GetSize();
-	hdcScreen = GetDC(NULL);
-	if (!hdcScreen) {
-		// No resources allocated yet, so just return
-		return SetResult({ GetLastError(),
-			_T("Failed to get Screen DC") });
-	}
-
-	hdcMem = CreateCompatibleDC(hdcScreen);
-	if (!hdcMem) {
-		DWORD lastError = GetLastError();
-		cleanup(); // Cleans up hdcScreen
-		return SetResult({ lastError,
-			_T("Failed to create memory DC") });
-	}
-
-	// --- Create DIB Section ---
-
-	BITMAPINFO bmi{};
-	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-	bmi.bmiHeader.biWidth = mainSize.cx;
-	bmi.bmiHeader.biHeight = -mainSize.cy; // Negative height for top-down bitmap
-	bmi.bmiHeader.biPlanes = 1;
-	bmi.bmiHeader.biBitCount = 32;
-	bmi.bmiHeader.biCompression = BI_RGB;
-
-	PVOID pvBits{};  // Not used directly here, but required by CreateDIBSection
-	hBitmap = CreateDIBSection(hdcMem, &bmi, DIB_RGB_COLORS, &pvBits, NULL, 0);
-	if (!hBitmap) {
-		DWORD lastError = GetLastError();
-		cleanup(); // Cleans up hdcMem, hdcScreen
-		return SetResult({ lastError,
-			_T("Failed to create DIB section") });
-	}
-
-	hOldBmp = (HBITMAP)SelectObject(hdcMem, hBitmap);
-	if (!hOldBmp || hOldBmp == HGDI_ERROR) {
-		DWORD lastError = GetLastError();
-		// Note: hBitmap is already selected, cleanup needs to handle it
-		hOldBmp = nullptr; // Prevent SelectObject(hdcMem, hOldBmp) in cleanup
-		cleanup(); // Cleans up hBitmap, hdcMem, hdcScreen
-		return SetResult({ lastError,
-			_T("Failed to select bitmap into memory DC") });
-	}
-
-	// --- GDI+ Operations ---
-
-	pGraphics = new Gdiplus::Graphics(hdcMem);
-	Gdiplus::Status status = pGraphics->GetLastStatus();
-	if (status != Gdiplus::Ok) {
-		delete pGraphics; // Manually delete graphics before cleanup call
-		pGraphics = nullptr; // Prevent double deletion in cleanup
-		cleanup(); // Cleans up hOldBmp/hBitmap, hdcMem, hdcScreen
-		return SetResult({ status,
-			_T("Failed to initialize GDI+ Graphics") });
-	}
-
-	// Set rendering quality
-	pGraphics->SetCompositingMode(Gdiplus::CompositingModeSourceOver);
-	pGraphics->SetCompositingQuality(Gdiplus::CompositingQualityHighQuality);
-	pGraphics->SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
-	pGraphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
-
-	// Clear with full transparency
-	pGraphics->Clear(Gdiplus::Color(0, 0, 0, 0));
-
-	// --- Prepare for Drawing ---
-
-	if (!GdiPlus() || !GdiPlus()->GetImage() || !Blinker()) {
-		cleanup();
-		return SetResult({ 0,
-			_T("Invalid MainWindow::eState"), _T("Required GDI+ or Blink data is missing") });
-	}
-
-	INT srcLeft = (MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded))
-		? 0
-		: GdiPlus()->GetImage()->GetWidth() - mainSize.cx;
-
-	// Select attributes based on blink state
-	Gdiplus::ImageAttributes* pAttributes = GdiPlus()->GetImageAttributes();
-	GdiPlus()->ApplyColorMatrix(Blinker()->GetActiveColorMatrix());
-
-	// Destination rectangle calculation
-	Gdiplus::Rect destRect = (MainWindow::IsSnapEdge(ScreenEdge::Right))
-		? Gdiplus::Rect(mainSize.cx, 0, -mainSize.cx, mainSize.cy)  // Flipped horizontally
-		: Gdiplus::Rect(0, 0, mainSize.cx, mainSize.cy);  // Normal
-
-	// --- Draw the image ---
-
-	status = pGraphics->DrawImage(
-		GdiPlus()->GetImage(),
-		destRect,
-		srcLeft, 0,                // Source X, Y
-		mainSize.cx, mainSize.cy,  // Source Width, Height
-		Gdiplus::UnitPixel,
-		pAttributes
-	);
-
-	if (status != Gdiplus::Ok) {
-		cleanup(); // Cleans up graphics, hOldBmp/hBitmap, hdcMem, hdcScreen
-		return SetResult({ status,
-			_T("GDI+ DrawImage failed") });
-	}
-
-	// --- Update Layered Window ---
-
-	BLENDFUNCTION blendFunc = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-	POINT ptSrc = { 0, 0 }; // Source point in the memory DC (usually 0,0)
-	POINT ptDst = { MainWindow::GetRect().left, MainWindow::GetRect().top }; // Destination point on screen
-
-	HWND hWndMain = MainWindow::GetHandle();
-	if (!hWndMain) {
-		cleanup();
-		return SetResult({ 0,
-			_T("Invalid Window"), _T("Main window handle is null") });
-	}
-
-	BOOL bSuccess = UpdateLayeredWindow(
-		hWndMain,
-		hdcScreen,    // Use screen DC for destination context
-		&ptDst,       // Screen position to update window to
-		&mainSize,    // Size of the window
-		hdcMem,       // Source DC with the bitmap content
-		&ptSrc,       // Point in the source DC to start copying from
-		0,            // Color key (not used with AC_SRC_ALPHA)
-		&blendFunc,   // Blending function
-		ULW_ALPHA     // Use alpha channel for blending
-	);
-
-	if (!bSuccess) {
-		DWORD lastError = GetLastError();
-		cleanup(); // Cleans up graphics, hOldBmp/hBitmap, hdcMem, hdcScreen
-		return SetResult({ lastError,
-			_T("Update layered window failed") });
-	}
-
-	cleanup();
-	return {};
-}
-
-Result DrawContext::GetResult() const
-{
-	return result;
-}
-
-
-
-// Snap adapter for main window, handles edge-snapping logic
-struct MainSnapAdapter : public ISnapAdapter
-{
-	HWND GetTargetWindow() const override
-	{
-		return MainWindow::GetHandle();
-	}
-
-	ScreenEdge GetSnapEdge() const override
-	{
-		return MainWindow::GetSnapEdge();
-	}
-
-	bool IsValidSnapEdge(const ScreenEdge& edge) const override
-	{
-		return MainWindow::IsValidSnapEdge(edge);
-	}
-
-	void OnSnapSuccess(const ScreenEdge& edge, const POINT& pos) override
-	{
-		MainWindow::SetSnapEdge(edge);
-		MainWindow::SetPosition(pos);
-	}
-
-	void OnSnapRejected(const ScreenEdge&, const POINT&) override
-	{
-		HWND hWnd = MainWindow::GetHandle();
-		if (hWnd) {
-			DrawContext* pContext = (DrawContext*)GetWindowLongPtr(hWnd, GWLP_USERDATA);
-			if (pContext) {
-				pContext->Blinker()->Enable(hWnd, IDT_BLINK_TIMER);
-			}
-		}
-	}
-
-	void OnSnapEdgeNone(const POINT& pos) override
-	{
-		HWND hWnd = MainWindow::GetHandle();
-		if (hWnd) {
-			DrawContext* pContext = (DrawContext*)GetWindowLongPtr(hWnd, GWLP_USERDATA);
-			if (pContext->Snapper()->IsPreviewEnabled()) {
-				MainWindow::SetPosition(pos);
-			}
-		}
-	}
-};
-
-// System tray setup adapter
-struct TraySetupAdapter : public ITrayAdapter
-{
-	HICON GetIconResource()
-	{
-		TCHAR szBuffer[MAX_PATH];
-		// Expand path to on-screen keyboard
-		if (!ExpandEnvironmentStrings(Config::OSK::DefaultPath, szBuffer, MAX_PATH)) {
-			return NULL;
-		}
-
-		HICON trayIcon = ExtractIcon(NULL, szBuffer, 0);  // First icon in the EXE
-		if (!trayIcon) { return NULL; }
-
-		return trayIcon;
-	}
-
-	Result SetupTrayIcon(NOTIFYICONDATA& trayData) override
-	{
-		trayData.hIcon = GetIconResource();                 // Specifies the icon to display in the tray (paired with NIF_ICON)
-		if (!trayData.hIcon) {
-			return { GetLastError(),
-				_T("Failed to load tray icon") };
-		}
-
-		_tcscpy_s(trayData.szTip, Config::ApplicationName);  // Sets the tooltip text (paired with NIF_TIP)
-		trayData.cbSize = sizeof(NOTIFYICONDATA);            // Specifies the size of the structure, required by Shell_NotifyIcon
-		trayData.hWnd = MainWindow::GetHandle();             // Associates the tray icon with a window to receive callback messages
-		trayData.uID = IDI_NOTIFY_ICON;                      // A unique identifier for the tray icon
-		trayData.uCallbackMessage = WM_APP_TRAYICON;         // Defines the custom message
-		trayData.uFlags =
-			NIF_ICON |      // The tray icon
-			NIF_MESSAGE |   // Event handling
-			NIF_TIP |       // Tooltip text
-			NIF_SHOWTIP;    // Ensures the tooltip appears when hovering (Windows 10/11 enhancement)
-
-		// Required for Windows 10/11
-		trayData.dwState = NIS_SHAREDICON;                   // Indicates the icon is shared and shouldnt be deleted when the notification is removed
-		trayData.dwStateMask = NIS_SHAREDICON;               // Specifies which state bits to modify
-
-		// First add the icon to the tray
-		if (!Shell_NotifyIcon(NIM_ADD, &trayData)) {         // Adds the tray icon to the system tray
-			return { GetLastError(),
-				_T("Failed to initialize tray icon") };
-		}
-		// Set version AFTER adding
-		trayData.uVersion = NOTIFYICON_VERSION;              // Sets the tray icon version
-
-		if (!Shell_NotifyIcon(NIM_SETVERSION, &trayData)) {
-			return { GetLastError(),
-				_T("Failed to set notify icon version") };
-		}
-
-		return {};
-
-	}
-
-	Result CreateTrayMenu(HMENU& hMenu) override
-	{
-		hMenu = CreatePopupMenu();
-		if (!hMenu) {
-			return { ERROR_OUTOFMEMORY,
-				_T("Tray Menu memory allocation failed") };
-		}
-
-		bool isAutostartEnabled{};
-		DWORD dwResult;
-
-		// Check if autostart is enabled in the registry
-		dwResult = MainWindow::Registry::GetAutostartValue(&isAutostartEnabled);
-		if (dwResult != ERROR_SUCCESS) {
-			return { dwResult,
-			_T("Failed to get Main registry data") };
-		}
-		
-		bool isDockModeEnabled{};
-		DWORD dwValue{};
-
-		// Check if `dock` mode is enabled in the registry
-		dwResult = OSKWindow::Registry::GetDockModeValue(&isDockModeEnabled);
-		if (dwResult != ERROR_SUCCESS) {
-			return { dwResult,
-				_T("Failed to get OSK registry data") };
-		}
-
-		AppendMenu(hMenu, MF_STRING | (isAutostartEnabled ? MF_CHECKED : 0), IDM_TRAY_AUTOSTART, _T("Autostart"));
-		AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
-		AppendMenu(hMenu, MF_STRING | (isDockModeEnabled ? MF_CHECKED : 0), IDM_TRAY_DOCKMODE, _T("Forced Dock mode"));
-		AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
-		AppendMenu(hMenu, MF_STRING, IDM_TRAY_EXIT, _T("Exit"));
-
-		return {};
-	}
-};
-
-
-
-// Forward declarations
-LRESULT CALLBACK WindowProc(HWND, UINT, WPARAM, LPARAM);
-
-
-// Synchronizes position with main application window
-void SyncOskPositionWithMain()
-{
-	OSKWindow::UpdateWndRect();
-
-	const RECT& oskRect = OSKWindow::GetRect();
-	const SIZE& oskSize = OSKWindow::GetSize();
-	const RECT& mainRect = MainWindow::GetRect();
-	const SIZE& mainSize = MainWindow::GetSize();
-
-
-	LONG targetTop = mainRect.top - (oskSize.cy - mainSize.cy) / 2;
-
-	DWORD clampedTop =
-		std::clamp(
-			targetTop,
-			WorkAreaManager::GetWorkArea().top,
-			WorkAreaManager::GetWorkArea().bottom - oskSize.cy
-		);
-
-	SetWindowPos(
-		OSKWindow::GetHandle(), NULL,
-		oskRect.left, clampedTop,
-		0, 0,
-		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
-	);
-}
-
-// Create Window
-HWND CreateLayeredWindow(HINSTANCE hInstance)
-{
-	POINT pt{};
-	const auto [cx, cy] = MainWindow::GetSize();
-
-	WorkAreaManager::Refresh();
-
-	// Adjust window X position
-	if (WorkAreaManager::IsFreeEdge(ScreenEdge::Left)) {
-		MainWindow::SetSnapEdge(ScreenEdge::Left);
-		pt.x = WorkAreaManager::GetWorkArea().left;
-	}
-	else {
-		MainWindow::SetSnapEdge(ScreenEdge::Right);
-		pt.x = WorkAreaManager::GetWorkArea().right - cx;
-	}
-
-	// Adjust position according on-screen keyboard
-	OSKWindow::UpdateWndRect();
-
-	LONG oskWndHeight = OSKWindow::GetRect().bottom - OSKWindow::GetRect().top;
-	pt.y = OSKWindow::GetRect().top + (oskWndHeight - cy) / 2;
-
-	pt = MainWindow::ClampPoint(pt);
-
-	return
-		CreateWindowEx(
-			WS_EX_TOPMOST | WS_EX_LAYERED | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
-			Config::MainWindowClass,
-			Config::ApplicationName,
-			WS_POPUP,
-			pt.x, pt.y,
-			cx, cy,
-			NULL, NULL, hInstance, NULL
-		);
-}
-
-// Register Window Class
-ATOM RegisterWindowClass(HINSTANCE hInstance, WNDCLASSEX* wcex)
-{
-	wcex->cbSize = sizeof(WNDCLASSEX);
-	wcex->lpfnWndProc = WindowProc;                  // Window procedure
-	wcex->hInstance = hInstance;                     // App instance
-	wcex->lpszClassName = Config::MainWindowClass;   // Class name
-	wcex->hCursor = LoadCursor(NULL, IDC_ARROW);     // Cursor
-	wcex->hbrBackground = (HBRUSH)GetStockObject(NULL_BRUSH);            // Background
-	//wcex.hIconSm = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_MAIN_ICON));  // Icon
-	wcex->style = CS_HREDRAW | CS_VREDRAW | CS_DBLCLKS;
-
-	return RegisterClassEx(wcex);
-}
-
-// Creates a process to launch the On-Screen Keyboard (OSK) application
-BOOL CreateOSKProcess(STARTUPINFO* pStartupInfo, PROCESS_INFORMATION* pProcessInfo)
-{
-	TCHAR szBuffer[MAX_PATH];
-	pStartupInfo->cb = sizeof(STARTUPINFO);
-	pStartupInfo->dwFlags = STARTF_USESHOWWINDOW;
-	pStartupInfo->wShowWindow = SW_HIDE;
-
-	// Expand path to on-screen keyboard
-	if (!ExpandEnvironmentStrings(Config::OSK::DefaultPath, szBuffer, MAX_PATH)) {
-		return FALSE;
-	}
-
-	// Create OSK Process
-	return CreateProcess(
-		szBuffer,
-		NULL, NULL, NULL,
-		FALSE,
-		NULL, NULL, NULL,
-		pStartupInfo, pProcessInfo);
-}
-
-// Loads a dynamic-link library
-BOOL LoadHookDll(HMODULE* hDll)
-{
-	TCHAR szBuffer[MAX_PATH];
-	if (!GetCurrentDirectory(MAX_PATH, szBuffer)) { return FALSE; }
-
-	HRESULT hResult = PathCchCombine(szBuffer, MAX_PATH, szBuffer, _T("CBTHook.dll"));
-	if (!SUCCEEDED(hResult)) { return FALSE; }
-
-	*hDll = LoadLibrary(szBuffer);
-	if (!*hDll) { return FALSE; }
-
-	return TRUE;
-}
-
-
-
-// Window procedure
-LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg,
-	WPARAM wParam, LPARAM lParam)
-{
-	static MouseTracker mouseTracker{ hWnd };
-	static DrawContext* pDrawContext{};
-	static TrayManager* pTray;
-
-
-	switch (uMsg)
-	{
-
-	case WM_TIMER:
-	{
-		if (wParam == IDT_KEEP_ON_TOP) {
-			MainWindow::EnforceTopmost();
-			return 0;
-		}
-
-		if (wParam == IDT_BLINK_TIMER) {
-			pDrawContext->Blinker()->Update();
-			pDrawContext->DrawImageOnLayeredWindow();
-			return 0;
-		}
-
-		break;
-	}
-
-	case WM_SETCURSOR:
-	{
-		SetCursor(LoadCursor(NULL, IDC_ARROW));
-		break;
-	}
-
-	case WM_MOUSEACTIVATE:
-	{
-		return MA_NOACTIVATE; // Prevent window activation on mouse click
-	}
-
-	case WM_MOUSEMOVE:
-	{
-		auto DragCallback = [&hWnd](const POINT& pt, nullptr_t) {
-			return MainWindow::SetPosition(pt);
-			};
-		
-		if (!pDrawContext->Dragger()->OnMouseMove(DragCallback, nullptr) and 
-			!pDrawContext->Snapper()->OnMouseMove() and
-			MainWindow::IsExpansionState(MainWindow::ExpansionState::Collapsed)
-			) {
-			MainWindow::ToggleExpansionState();
-			pDrawContext->DrawImageOnLayeredWindow();
-		}
-
-		mouseTracker.OnMouseMove();
-
-		break;
-	}
-
-	case WM_MOUSEWHEEL:
-	{
-		int delta = GET_WHEEL_DELTA_WPARAM(wParam);
-		PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
-			MAKEWPARAM(ID_APP_FADE, delta > 0),
-			0
-		);
-
-		break;
-	}
-
-	case WM_LBUTTONDOWN:
-	{
-		// Update work area to avoid taskbar during drag
-		WorkAreaManager::Refresh();
-
-		pDrawContext->Snapper()->Enable(new MainSnapAdapter{});
-		SetCapture(hWnd);
-
-		return 0;
-	}
-
-	case WM_LBUTTONUP:
-	{
-		if (pDrawContext->Snapper()->IsEnabled()) {
-			ReleaseCapture();
-			bool isPreview = pDrawContext->Snapper()->IsPreviewEnabled();
-			pDrawContext->Snapper()->Disable();
-
-			if (isPreview) {
-				pDrawContext->DrawImageOnLayeredWindow();
-				return 0;
-			}
-		}
-
-		HWND hOskWnd = OSKWindow::GetHandle();
-		if (IsWindowVisible(hOskWnd)) {
-			PostMessage(hOskWnd, WM_CLOSE, 0, 0);
-		}
-		else {
-			SyncOskPositionWithMain();
-			ShowWindowAsync(hOskWnd, SW_RESTORE); // Restore OSK
-		}
-		break;
-	}
-
-	case WM_RBUTTONDOWN:
-	{
-		// Update work area to avoid taskbar during drag
-		WorkAreaManager::Refresh();
-
-		// Start drag operation
-		pDrawContext->Dragger()->Enable(hWnd);
-
-		break;
-	}
-
-	case WM_RBUTTONUP:
-	{
-		// Stop drag operation
-		pDrawContext->Dragger()->Disable();
-		ReleaseCapture();
-
-		break;
-	}
-
-	case WM_RBUTTONDBLCLK:
-	{
-		if (IsWindowVisible(OSKWindow::GetHandle())) {
-			// Start the animation loop
-			PostMessage(
-				hWnd,
-				WM_APP_CUSTOM_MESSAGE,
-				MAKEWPARAM(ID_APP_SYNC_Y_POSITION, 0),
-				(LPARAM)hWnd
-			);
-		}
-		break;
-	}
-
-	case WM_MBUTTONDOWN:
-	{
-		break;
-	}
-
-	case WM_MBUTTONUP:
-	{
-		SendMessage(hWnd, WM_LBUTTONUP, wParam, lParam);
-		break;
-	}
-
-	case WM_MOUSELEAVE:
-	{
-		mouseTracker.OnMouseLeave();
-
-		if (!pDrawContext->Dragger()->IsEnabled() and !pDrawContext->Snapper()->IsEnabled())
-		{
-			if (MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded)) {
-				MainWindow::SetExpansionState(MainWindow::ExpansionState::Collapsed);
-
-				pDrawContext->DrawImageOnLayeredWindow();
-			}
-		}
-		break;
-	}
-
-	case WM_APP_TRAYICON:
-	{
-		if (lParam == WM_LBUTTONUP) {
-			SendMessage(hWnd, WM_LBUTTONUP, 0, 0);
-		}
-		else if (lParam == WM_RBUTTONUP) {
-			pTray->HandleTrayRightClick();
-		}
-
-		break;
-	}
-
-	case WM_COMMAND:
-	{
-		WORD wNotificationCode = HIWORD(wParam);
-		WORD wCommandId = LOWORD(wParam);
-
-		if (wNotificationCode == 0) {  // Menu/accelerator
-			if (wCommandId == IDM_TRAY_DOCKMODE) {
-				DWORD dwResult = OSKWindow::ToggleDockMode();
-				if (dwResult != ERROR_SUCCESS) {
-					MessageBoxNotifier{
-						{ _T("Registry Error") },
-						{ _T("Failed to get OSK registry data." EOL_ "%lu"), dwResult }
-					}.ShowError(hWnd);
-					return 1;
-				}
-			}
-
-			else if (wCommandId == IDM_TRAY_AUTOSTART) {
-				DWORD dwResult = MainWindow::Registry::ToggleAutostartValue();
-				if (dwResult != ERROR_SUCCESS) {
-					MessageBoxNotifier{
-						{ _T("Registry Error") },
-						{ _T("Failed to get Main registry data." EOL_ "%lu"), dwResult }
-					}.ShowError(hWnd);
-					return 1;
-				}
-			}
-
-			else if (wCommandId == IDM_TRAY_EXIT) {
-				PostMessage(hWnd, WM_CLOSE, 0, 0);
-			}
-		}
-
-		else if (wNotificationCode == 1) {}  // Accelerator (rarely used explicitly)
-
-		else {}  // Control notification
-
-		break;
-	}
-
-	case WM_APP_CUSTOM_MESSAGE:
-	{
-		WORD wCommandId = LOWORD(wParam);
-
-		if (wCommandId == ID_APP_SYNC_Y_POSITION) {
-			OSKWindow::UpdateWndRect();
-
-			const RECT& oskRect = OSKWindow::GetRect();
-			const SIZE& oskSize = OSKWindow::GetSize();
-			const SIZE& mainSize = MainWindow::GetSize();
-			const RECT& workArea = WorkAreaManager::GetWorkArea();
-
-			LONG targetY = oskRect.top + (oskSize.cy - mainSize.cy) / 2;
-			const LONG clampedY =
-				std::clamp(targetY, workArea.top, workArea.bottom - mainSize.cy
-				);
-
-			POINT ptCursor;
-			GetCursorPos(&ptCursor);
-
-			// Collapse the main window if the cursor moves away
-			if (ptCursor.y < clampedY or
-				ptCursor.y > clampedY + mainSize.cy)
-			{
-				SendMessage(hWnd, WM_MOUSELEAVE, 0, 0);
-			}
-
-			const POINT ptTarget{
-				MainWindow::GetRect().left,  // No changes
-				clampedY
-			};
-
-			// Start animation with reference to target window position
-			pDrawContext->Animator()->Enable(
-				MainWindow::GetHandle(), ptTarget);
-
-			if (pDrawContext->Animator()->IsEnabled()) {
-				PostMessage(hWnd, WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_ANIMATION, 0), 0);
-			}
-
-			return 0;
-		}
-
-		if (wCommandId == ID_APP_ANIMATION) {
-			bool bContinue = pDrawContext->Animator()->Update();
-			if (bContinue) {  // Animation needs to continue
-				PostMessage(hWnd, WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_ANIMATION, 0), 0);
-			}
-			else {
-				MainWindow::UpdateWndRect();
-			}
-
-			return 0;
-		}
-
-		return 1;
-	}
-
-	case WM_CREATE:
-	{
-		// Store the main window handle
-		MainWindow::SetHandle(hWnd);
-
-		// Update window position
-		MainWindow::UpdateWndRect();
-
-		// Create the drawing context
-		pDrawContext = new DrawContext{ hWnd };
-		
-		Result result = pDrawContext->GetResult();
-		if (!result) {
-			MessageBoxNotifier{
-				{ result.header },
-				{ _T("%s" EOL_ "%lu"), result.message, result.errorValue }
-			}.ShowError(hWnd);
-			return -1;
-		}
-
-		// Store the drawing context in window user data
-		SetWindowLongPtr(hWnd, GWLP_USERDATA, (LONG_PTR)pDrawContext);
-
-		// Create the tray icon manager
-		pTray = new TrayManager(new TraySetupAdapter{});
-
-		result = pTray->GetResult();
-		if (!result) {
-			MessageBoxNotifier{
-				{ result.header },
-				{ _T("%s" EOL_ "%lu"), result.message, result.errorValue }
-			}.ShowError(hWnd);
-			return -1;
-		}
-
-		// Keep window always on top
-		SetTimer(hWnd, IDT_KEEP_ON_TOP, 5000, NULL); // 5 sec interval
-
-		// Apply system theme
-		if (!ThemeManager::FollowSystemTheme(hWnd)) {
-			MessageBoxNotifier{
-				{ _T("Theme Error") },
-				{ _T("Failed to apply system theme." EOL_ "%lu"), GetLastError() }
-			}.ShowWarning(hWnd);
-		}
-
-		// Explicitly show the window
-		ShowWindow(hWnd, SW_SHOW);
-		// Draw content on the layered window
-		pDrawContext->DrawImageOnLayeredWindow();
-
-		return 0;
-	}
-
-	case WM_DESTROY:
-	{
-		// Move then Close OSK to store position correctly
-		ShowWindow(OSKWindow::GetHandle(), SW_HIDE);
-		SyncOskPositionWithMain();
-		PostMessage(OSKWindow::GetHandle(), WM_CLOSE, 0, (LPARAM)TRUE);
-
-		// Kill timers
-		KillTimer(hWnd, IDT_KEEP_ON_TOP);
-		KillTimer(hWnd, IDT_BLINK_TIMER);
-
-		// Clean up tray manager object
-		delete pTray;
-
-		// Clean up drawing context object
-		delete pDrawContext;
-
-		PostQuitMessage(0);
-		return 0;
-	}
-
-	case WM_SETTINGCHANGE:
-	{
-		// Check if the setting change is related to the system theme
-		if (lParam and CompareStringOrdinal(reinterpret_cast<LPCWCH>(lParam),
-			-1, _T("ImmersiveColorSet"), -1, TRUE) == CSTR_EQUAL)
-		{
-			// Re-apply the correct theme based on current system setting
-			ThemeManager::FollowSystemTheme(hWnd);
-			break;
-		}
-
-		// Update information about the usable screen area
-		WorkAreaManager::Refresh();
-
-		// Lambda function to update window position, enable blinker, and redraw
-		auto UpdatePosition = [&](ScreenEdge edge) {
-			MainWindow::SetSnapEdge(edge);
-			pDrawContext->Blinker()->Enable(hWnd, IDT_BLINK_TIMER);
-			pDrawContext->DrawImageOnLayeredWindow();
-			};
-
-		// Determine if we need to switch sides
-		if (MainWindow::IsSnapEdge(ScreenEdge::Left) and
-			!WorkAreaManager::IsFreeEdge(ScreenEdge::Left))
-		{
-			UpdatePosition(ScreenEdge::Right);
-		}
-		else if (MainWindow::IsSnapEdge(ScreenEdge::Right) and
-			!WorkAreaManager::IsFreeEdge(ScreenEdge::Right))
-		{
-			UpdatePosition(ScreenEdge::Left);
-		}
-		else {
-			const RECT& rect = MainWindow::GetRect();
-			auto [cx, cy] = MainWindow::ClampPoint({
-				rect.left, rect.top });
-
-			// Update position if clamping changed the top coordinate
-			if (rect.top != cy) {
-				UpdatePosition(MainWindow::GetSnapEdge());
-			}
-		}
-		break;
-	}
-
-	default: break;
-	}
-
-	return DefWindowProc(hWnd, uMsg, wParam, lParam);
-}
-
-
-
-
-// Main Entry Point
-INT WINAPI WinMain(
-	_In_ HINSTANCE hInstance,
-	_In_opt_ HINSTANCE hPrevInstance,
-	_In_ LPSTR lpCmdLine,
-	_In_ INT nCmdShow)
-{
-	HWND hWnd{};
-
-	// Check if program is already running
-	if (hWnd = FindWindow(Config::MainWindowClass, NULL)) {
-		PostMessage(hWnd, WM_LBUTTONUP, 0, 0);
-		return ERROR_ALREADY_EXISTS;
-	}
-
-	// Close OSK if open
-	if (hWnd = FindWindow(Config::OSK::WindowClass, NULL)) {
-		SendMessage(hWnd, WM_CLOSE, 0, (LPARAM)TRUE);  // lParam forces custom close
-	}
-
-	HMODULE hDll{};
-
-#ifndef _DEBUG
-	if (!LoadHookDll(&hDll)) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to load the DLL." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		return -1;
-	}
-
-	// Function pointer types for the exported functions
-	typedef BOOL(*UninstallHookFunc)();
-	typedef BOOL(*InstallHookFunc)(DWORD);
-
-	UninstallHookFunc UninstallHook = (UninstallHookFunc)GetProcAddress(hDll, "UninstallHook");
-	InstallHookFunc InstallHook = (InstallHookFunc)GetProcAddress(hDll, "InstallHook");
-
-	if (!UninstallHook or !InstallHook) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("The specified procedure could not be found." EOL_ "%lu"), ERROR_PROC_NOT_FOUND }
-		}.ShowError(hWnd);
-		FreeLibrary(hDll);
-		return -1;
-	}
-#endif
-
-	STARTUPINFO startupInfo{};
-	PROCESS_INFORMATION processInfo{};
-	WNDCLASSEX wcex{};
-	HANDLE hEvent{};
-	DWORD waitResult{};
-
-#ifndef _DEBUG
-	// Create OSK Process
-	if (!CreateOSKProcess(&startupInfo, &processInfo)) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Unable to create OSK window." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-	if (!processInfo.hProcess) { goto CLEANUP; } // warnings C6387
-
-	waitResult = WaitForInputIdle(processInfo.hProcess, 3000);
-	if (waitResult == WAIT_TIMEOUT) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-	if (waitResult == WAIT_FAILED) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-
-	// Hook Inject
-	// ==============================
-
-	// Create a manual-reset event that starts unsignaled
-	if (!(hEvent = CreateEvent(NULL, TRUE, FALSE, _T("OSKLoadEvent")))) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to create event." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	// Inject hook
-	if (!InstallHook(processInfo.dwThreadId)) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to install the Windows hook procedure." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	// Wait for the event to be signaled
-	waitResult = WaitForSingleObject(hEvent, 3000);
-	if (waitResult == WAIT_TIMEOUT) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-	if (waitResult == WAIT_FAILED) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	// CBTHook.dll confirmed successful injection; Safe to close the event
-	if (!CloseHandle(hEvent)) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to close event." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		hEvent = {};
-		goto CLEANUP;
-	}
-	hEvent = {};
-
-	// Unload hook
-	if (!UninstallHook()) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to remove the Windows hook." EOL_ "%lu"), ERROR_HOOK_NOT_INSTALLED }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	// Store OSK handle globally
-	if (!(hWnd = FindWindow(Config::OSK::WindowClass, NULL))) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to find the window." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	OSKWindow::SetHandle(hWnd);
-
-	// Unload library
-	FreeLibrary(hDll);
-	hDll = {};
-#endif
-
-	if (!ThemeManager::EnableThemeSupport()) {
-		MessageBoxNotifier{
-			{ _T("Theme Error") },
-			{ _T("Failed to enable theme support." EOL_ "%lu"), GetLastError() }
-		}.ShowWarning(hWnd);
-	}
-
-	if (!RegisterWindowClass(hInstance, &wcex)) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Unable to register window class." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-	hWnd = CreateLayeredWindow(hInstance);
-	if (!hWnd) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Unable to create window." EOL_ "%lu"), GetLastError() }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-
-
-	MSG msg;
-	while (GetMessage(&msg, NULL, 0, 0))
-	{
-		TranslateMessage(&msg);
-		DispatchMessage(&msg);
-	}
-
-#ifndef _DEBUG
-	waitResult = WaitForSingleObject(processInfo.hProcess, 3000);
-	if (waitResult == WAIT_TIMEOUT) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-	if (waitResult == WAIT_FAILED) {
-		MessageBoxNotifier{
-			{ _T("System Error") },
-			{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
-		}.ShowError(hWnd);
-		goto CLEANUP;
-	}
-#endif
-
-CLEANUP:
-	WNDCLASSEX existingWc{ sizeof(WNDCLASSEX) };
-	BOOL isRegistered = GetClassInfoEx(wcex.hInstance, Config::MainWindowClass, &existingWc);
-	if (isRegistered) { UnregisterClass(Config::MainWindowClass, GetModuleHandle(NULL)); }
-	if (hEvent) { CloseHandle(hEvent); }
-	if (hDll) { FreeLibrary(hDll); }
-	if (processInfo.hProcess) { CloseHandle(processInfo.hProcess); }
-	if (processInfo.hThread) { CloseHandle(processInfo.hThread); }
-	ThemeManager::DisableThemeSupport();
-
-	return 0;
-}
-
-
-
+// Implementation-specific headers
+#include "TabTap.h"
+#include "resource.h"
+#include "UIComponents.h"
+#include "ProcessQos.h"
+#include "MonitorTopology.h"
+#include "AppPaths.h"
+#include "CustomIncludes/WinApi/MessageBoxNotifier.h"
+#include "CustomIncludes/WinApi/ThemeManager.h"
+#include "CustomIncludes/WinApi/WindowDragger.h"
+#include "CustomIncludes/WinApi/MouseTracker.h"
+#include "CustomIncludes/WinApi/WorkAreaManager.h"
+#include "CustomIncludes/WinApi/RegistryManager.h"
+#include "Core/GroupLayout.h"
+#include "Core/MessageProfiler.h"
+#include "Core/AsyncLogger.h"
+#include "Core/ReplayFormat.h"
+#include "Core/GestureRecognizer.h"
+#include "Core/OskAttach.h"
+#include "Core/SettingChange.h"
+
+// Default headers
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <string>
+
+// Windows system headers
+#include <Windows.h>
+#include <windowsx.h>  // For GET_X_LPARAM, GET_Y_LPARAM
+#include <PathCch.h>
+#include <TlHelp32.h>
+
+// Library links
+#pragma comment(lib, "Pathcch.lib")
+
+
+
+namespace Config
+{
+	// Application identity
+	constexpr LPCTSTR ApplicationName = _T("TabTap");
+	constexpr LPCTSTR MainWindowClass = _T("TabTapMainClass");
+
+	// Registry paths
+	namespace Registry
+	{
+		constexpr LPCTSTR ApplicationSettings = _T("Software\\Empurple\\TabTap");
+		constexpr LPCTSTR AutoRun             = _T("Software\\Microsoft\\Windows\\CurrentVersion\\Run");
+		constexpr LPCTSTR OSKSettings         = _T("Software\\Microsoft\\Osk");
+	}
+
+	// On-Screen Keyboard configuration
+	namespace OSK
+	{
+		constexpr LPCTSTR WindowClass = _T("OSKMainClass");
+		constexpr LPCTSTR DefaultPath = _T("%WINDIR%\\System32\\osk.exe");
+		constexpr LPCTSTR HookModule  = _T("CBTHook.dll");
+		constexpr UINT PingTimeoutMs  = 500;   // A hung OSK is closed rather than adopted
+	}
+}
+
+
+// Metrics registry shared with the hook; exported to TabTap.metrics and
+// \\.\pipe\TabTapMetrics (declared early: the window classes record into it)
+namespace Telemetry
+{
+	MetricsChannel Channel{};            // Created before the OSK starts
+	MetricsExporter Exporter{};          // File and pipe export thread
+
+	Metrics::Counter RegistryReads{};
+	Metrics::Counter RegistryWrites{};
+	Metrics::Counter RegistryErrors{};   // Failures other than a missing value
+	Metrics::Counter WindowMoves{};
+	Metrics::Counter WindowMoveErrors{};
+	Metrics::Counter HookCommands{};     // Commands posted to the hook
+	Metrics::Histogram OskAttachTime{};     // Running OSK reconnected or injected (ms)
+	Metrics::Histogram OskColdStartTime{};  // osk.exe started and hooked (ms)
+	Metrics::Counter SettingChanges{};      // WM_SETTINGCHANGE received
+	Metrics::Counter SettingsIgnored{};     // ...for settings the tab does not read
+	Metrics::Counter SettingPasses{};       // Re-layouts run for settled bursts
+
+	// Counts a registry call; returns its result
+	inline DWORD CountRegistryCall(const Metrics::Counter& calls, DWORD dwResult)
+	{
+		calls.Add();
+		if (dwResult != ERROR_SUCCESS and dwResult != ERROR_FILE_NOT_FOUND) { RegistryErrors.Add(); }
+		return dwResult;
+	}
+
+	// Counts window moves; returns whether they succeeded
+	inline bool CountWindowMove(bool isMoved, UINT moves = 1)
+	{
+		WindowMoves.Add(moves);
+		if (!isMoved) { WindowMoveErrors.Add(); }
+		return isMoved;
+	}
+}
+
+
+
+// Main Application Window Manager (Singleton)
+class MainWindow
+{
+public:
+	// --- Window display states ---
+	enum class ExpansionState
+	{
+		Collapsed,     // Minimized/narrow state
+		Expanded       // Full-width state
+	};
+
+	// --- Registry management ---
+	struct Registry
+	{
+		// Query the autorun setting
+		static DWORD GetAutostartValue(bool*);
+		// Explicitly set or clear the value
+		static DWORD SetAutostartValue(bool);
+		// Flip value
+		static DWORD ToggleAutostartValue(bool* = nullptr);
+		// Query the linked drag setting
+		static DWORD GetLinkedDragValue(bool*);
+		// Explicitly set or clear the value
+		static DWORD SetLinkedDragValue(bool);
+		// Flip value
+		static DWORD ToggleLinkedDragValue(bool* = nullptr);
+		// Query the trace recording setting
+		static DWORD GetTraceValue(bool*);
+		// Explicitly set or clear the value
+		static DWORD SetTraceValue(bool);
+		// Flip value
+		static DWORD ToggleTraceValue(bool* = nullptr);
+		// Query the auto-show setting
+		static DWORD GetAutoShowValue(bool*);
+		// Explicitly set or clear the value
+		static DWORD SetAutoShowValue(bool);
+		// Flip value
+		static DWORD ToggleAutoShowValue(bool* = nullptr);
+	};
+
+private:
+	// --- Size presets ---
+	const SIZE collapsedSize = { TabLayout::CollapsedSize.cx, TabLayout::CollapsedSize.cy };
+	const SIZE expandedSize = { TabLayout::ExpandedSize.cx, TabLayout::ExpandedSize.cy };
+
+	// --- Runtime MainWindow::ExpansionState Variables ---
+	HWND hMainWnd{};          // Main window handle
+	RECT rcMainWnd{};         // Current window rectangle
+	ExpansionState expansionState{};  // Current expansion state
+	ScreenEdge edgeSide{};    // ScreenEdge where window is snapped
+	bool isLinkedDrag{};      // Vertical drag moves the OSK along with the tab
+	GroupLayout::MoveCounter moveCounter{};  // Window moves per drag frame
+
+private:
+	// --- Construction Control ---
+	/// Prevent instantiation, copying, and assignment
+	~MainWindow() = default;
+	MainWindow() = default;
+	MainWindow(const MainWindow&) = delete;
+	MainWindow& operator=(const MainWindow&) = delete;
+
+public:
+	// --- Singleton access ---
+	static MainWindow& Instance();
+
+	// --- Window state management ---
+	/// Updates the window's stored rectangle (call after position/size changes)
+	static void UpdateWndRect();
+	/// Returns the current window rectangle
+	static const RECT& GetRect();
+	/// Returns the window size for a given state (Collapsed/Expanded)
+	static const SIZE& GetSize(const MainWindow::ExpansionState&);
+	/// Returns the current window size (based on current state)
+	static const SIZE& GetSize();
+
+	// --- ScreenEdge (Screen Side) Management ---
+	/// Gets which screen edge the window is attached to (Left/Right)
+	static ScreenEdge GetSnapEdge();
+	/// Move window to specified edge (Left/Right)
+	static bool SetSnapEdge(const ScreenEdge&);
+	/// Toggles between Left/Right edges
+	static bool ToggleSnapEdge();
+	/// Checks if window is on specified edge
+	static bool IsSnapEdge(const ScreenEdge&);
+	/// 
+	static bool IsValidSnapEdge(const ScreenEdge&);
+
+	// --- Expansion MainWindow::ExpansionState Management ---
+	/// Gets current expansion state (Collapsed/Expanded)
+	static MainWindow::ExpansionState GetExpansionState();
+	/// Sets window to specified state (with proper sizing)
+	static void SetExpansionState(const MainWindow::ExpansionState&);
+	/// Toggles between Collapsed/Expanded states
+	static void ToggleExpansionState();
+	/// Checks if window is in specified state
+	static bool IsExpansionState(const MainWindow::ExpansionState&);
+
+	// --- Position Management ---
+	/// Constrains a point to stay within work area boundaries
+	static POINT ClampPoint(const POINT&);
+	/// Moves window to specified point (clamped to work area)
+	static bool SetPosition(const POINT&);
+	/// Moves window and the visible OSK together in one batched update
+	static bool SetGroupPosition(const POINT&);
+	/// Moves window, or the tab and OSK group in linked drag mode
+	static bool SetDragPosition(const POINT&);
+	/// Enables or disables linked drag mode
+	static void SetLinkedDrag(bool);
+	/// Checks if linked drag mode is enabled
+	static bool IsLinkedDrag();
+	/// Returns and clears the drag move statistics
+	static GroupLayout::MoveCounter TakeMoveStats();
+	/// Bring window to top layer
+	static void EnforceTopmost();
+
+	// --- Window handle management ---
+	/// Sets the HWND for the main window
+	static void SetHandle(HWND);
+	/// Gets the current window handle
+	static HWND GetHandle();
+};
+
+
+// On-Screen Keyboard Window Manager (Singleton)
+class OSKWindow
+{
+private:
+	// --- Runtime MainWindow::ExpansionState Variables ---
+	HWND hOskWnd{};         // Handle to the OSK window
+	RECT rcWndRect{};       // Current window rectangle
+	SIZE wndSize{};         // Current window dimensions
+	std::atomic<bool> isDockMode{};  // Forced dock state (registry copy)
+	PTP_WORK pDockModeWork{};        // Persists `isDockMode` off the UI thread
+
+private:
+	// --- Internal Methods ---
+	/// Thread pool callback writing the dock state to the registry
+	static VOID CALLBACK PersistDockMode(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK);
+
+private:
+	// --- Construction Control ---
+	/// Prevent instantiation, copying, and assignment
+	OSKWindow() = default;
+	~OSKWindow() = default;
+	OSKWindow(const OSKWindow&) = delete;
+	OSKWindow& operator=(const OSKWindow&) = delete;
+
+public:
+	// --- Registry management ---
+	struct Registry
+	{
+		// Query the 'Dock' setting
+		static DWORD GetDockModeValue(bool*);
+		// Explicitly set or clear the value
+		static DWORD SetDockModeValue(bool);
+	};
+
+public:
+	// --- Singleton access ---
+	static OSKWindow& Instance();
+
+	// --- Window Management ---
+	/// Updates the stored window rectangle
+	static void UpdateWndRect();
+	/// Returns the current window rectangle
+	static const RECT& GetRect();
+	/// Returns the current window dimensions
+	static const SIZE& GetSize();
+
+	// --- Window Handle Management  ---
+	/// Sets the OSK window handle
+	static void SetHandle(HWND hWnd);
+	/// Gets the current OSK window handle
+	static HWND GetHandle();
+
+	// --- Dock Mode Management  ---
+	/// Reads the dock state from the registry (off if unavailable)
+	static DWORD LoadDockMode();
+	/// Sets the cached dock state without reading the registry
+	static void SeedDockMode(bool);
+	/// Checks if forced dock mode is on
+	static bool IsDockMode();
+	/// Switches the OSK immediately and persists the new state in the background
+	static DWORD ToggleDockMode();
+	/// Waits for a pending registry write (call before exit)
+	static void FlushDockMode();
+};
+
+
+// Drawing Context Manager
+class DrawContext
+{
+private:
+	HWND m_hWnd;
+	// --- Component Instances ---
+	GDIPlusData* pGdiPlus{};          // GDI+ manager instance for image handling
+	EffectData* pEffector{};          // Keyframe effect data
+	AnimationData* pAnimator{};       // Animation control data
+	EdgeSnapData* pSnapper{};         // ScreenEdge-snapping control data
+	WindowDragger* pDragger{};        // Drag operation data
+	SkinData* pSkin{};                // Optional memory-mapped skin
+	LayoutIndicator* pIndicator{};    // Keyboard layout code over the tab
+	Render::IBackend* pRenderer{};    // Tab window renderer
+	Render::BackendKind rendererKind{};
+
+	// --- Operation MainWindow::ExpansionState ---
+	Result result{};                  // Operation result storage
+
+	// --- Metrics ---
+	Metrics::Counter drawCount{};     // Tab redraws
+	Metrics::Counter drawErrors{};    // Redraws that failed
+	Metrics::Histogram drawTime{};    // Redraw time (us)
+
+private:
+	// --- Internal Methods ---
+	Result SetResult(Result);
+	Result InitializeComponents();
+	Skin::State GetSkinState() const;
+	Result DrawSkinOnLayeredWindow();
+	Result DrawImageFrame();
+
+public:
+	// --- Lifecycle Management ---
+	~DrawContext();
+	DrawContext(HWND, Render::BackendKind);
+	DrawContext(const DrawContext&) = delete;
+	DrawContext& operator=(const DrawContext&) = delete;
+
+	// --- Component Access ---
+	GDIPlusData* GdiPlus()     const { return pGdiPlus; };
+	EffectData* Effector()     const { return pEffector; };
+	AnimationData* Animator()  const { return pAnimator; };
+	WindowDragger* Dragger()   const { return pDragger; };
+	EdgeSnapData* Snapper()    const { return pSnapper; };
+	SkinData* Skinner()        const { return pSkin; };
+	LayoutIndicator* Indicator() const { return pIndicator; };
+	Render::IBackend* Renderer() const { return pRenderer; };
+
+	// --- Drawing Operations ---
+	Result DrawImageOnLayeredWindow();
+
+	// --- Metrics ---
+	/// Registers the draw metrics and those of the components
+	void RegisterMetrics(Metrics::Registry&);
+
+	// --- Status Handling ---
+	Result GetResult() const;
+};
+
+
+
+// --- MainWindow ---
+
+MainWindow& MainWindow::Instance()
+{
+	static MainWindow instance{};
+	return instance;
+}
+
+void MainWindow::UpdateWndRect()  // Update after changes
+{
+	if (!Instance().hMainWnd) { return; }
+
+	GetWindowRect(
+		Instance().hMainWnd, &Instance().rcMainWnd
+	);
+}
+
+const RECT& MainWindow::GetRect()
+{
+	return Instance().rcMainWnd;
+}
+
+const SIZE& MainWindow::GetSize(const ExpansionState& state)
+{
+	return (state == MainWindow::ExpansionState::Collapsed)
+		? Instance().collapsedSize
+		: Instance().expandedSize;
+}
+
+const SIZE& MainWindow::GetSize()
+{
+	return GetSize(GetExpansionState());
+}
+
+ScreenEdge MainWindow::GetSnapEdge()
+{
+	return Instance().edgeSide;
+}
+
+bool MainWindow::SetSnapEdge(const ScreenEdge& edge)
+{
+	if (!IsValidSnapEdge(edge)) { return false; }
+
+	if (Instance().hMainWnd) {
+		const auto [cx, cy] = GetSize();
+		const LONG x = TabLayout::EdgeLeft(
+			ToLayoutEdge(edge), GetSystemMetrics(SM_CXSCREEN), cx);
+
+		POINT pt = ClampPoint({
+			x, Instance().rcMainWnd.top
+			});
+
+		const BOOL bMoved = SetWindowPos(
+			Instance().hMainWnd, nullptr,
+			pt.x, pt.y,
+			cx, cy,
+			SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+		);
+		Telemetry::CountWindowMove(bMoved != FALSE);
+	}
+
+	Instance().edgeSide = edge;
+	UpdateWndRect();
+
+	return true;
+}
+
+bool MainWindow::ToggleSnapEdge()
+{
+	return SetSnapEdge(GetSnapEdge() == ScreenEdge::Left
+		? ScreenEdge::Right
+		: ScreenEdge::Left
+	);
+}
+
+bool MainWindow::IsSnapEdge(const ScreenEdge& edge)
+{
+	return edge == GetSnapEdge();
+}
+
+bool MainWindow::IsValidSnapEdge(const ScreenEdge& edge)
+{
+	if (edge != ScreenEdge::Left and edge != ScreenEdge::Right) {
+		return false;
+	}
+	if (!WorkAreaManager::IsFreeEdge(edge)) {
+		return false;
+	}
+
+	return true;
+}
+
+MainWindow::ExpansionState MainWindow::GetExpansionState()
+{
+	return Instance().expansionState;
+}
+
+void MainWindow::SetExpansionState(const ExpansionState& state)
+{
+	const auto& size = (state == MainWindow::ExpansionState::Expanded)
+		? Instance().expandedSize
+		: Instance().collapsedSize;
+
+	const LONG x = TabLayout::EdgeLeft(
+		ToLayoutEdge(GetSnapEdge()), GetSystemMetrics(SM_CXSCREEN), size.cx);
+
+	if (Instance().hMainWnd) {
+		const BOOL bMoved = SetWindowPos(Instance().hMainWnd, nullptr,
+			x, Instance().rcMainWnd.top,
+			size.cx, size.cy,
+			SWP_NOZORDER | SWP_NOACTIVATE
+		);
+		Telemetry::CountWindowMove(bMoved != FALSE);
+	}
+	Instance().expansionState = state;
+	UpdateWndRect();
+}
+
+void MainWindow::ToggleExpansionState()
+{
+	SetExpansionState(GetExpansionState() == MainWindow::ExpansionState::Collapsed
+		? MainWindow::ExpansionState::Expanded
+		: MainWindow::ExpansionState::Collapsed
+	);
+}
+
+bool MainWindow::IsExpansionState(const MainWindow::ExpansionState& state)
+{
+	return state == GetExpansionState();
+}
+
+POINT MainWindow::ClampPoint(const POINT& point)
+{
+	return ToPoint(TabLayout::ClampPoint(
+		ToGeometry(point),
+		ToGeometry(GetSize()),
+		ToGeometry(WorkAreaManager::GetWorkArea())
+	));
+}
+
+bool MainWindow::SetPosition(const POINT& point)
+{
+	// Clamp top position
+	LONG newTop = ClampPoint({ point }).y;
+
+	// Update window rectangle manually
+	Instance().rcMainWnd.top = newTop;
+	Instance().rcMainWnd.bottom = newTop + GetSize().cy;
+
+	const BOOL bMoved = SetWindowPos(
+		Instance().hMainWnd, NULL,
+		GetRect().left, GetRect().top,
+		0, 0,
+		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+	);
+	return Telemetry::CountWindowMove(bMoved != FALSE);
+}
+
+bool MainWindow::SetGroupPosition(const POINT& point)
+{
+	HWND hOskWnd = OSKWindow::GetHandle();
+	OSKWindow::UpdateWndRect();
+
+	const GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag(
+		ToGeometry(point),
+		ToGeometry(GetRect()),
+		ToGeometry(OSKWindow::GetRect()),
+		ToGeometry(WorkAreaManager::GetWorkArea()),
+		IsWindowVisible(hOskWnd) != FALSE
+	);
+
+	const UINT moves = (placement.moveTab ? 1 : 0) + (placement.moveOsk ? 1 : 0);
+	if (!moves) { return true; }
+
+	// Both windows land in the same compositor frame
+	HDWP hDwp = BeginDeferWindowPos(moves);
+	if (!hDwp) { return Telemetry::CountWindowMove(false, moves); }
+
+	const UINT flags = SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE;
+	if (placement.moveTab and hDwp) {
+		hDwp = DeferWindowPos(hDwp, Instance().hMainWnd, NULL,
+			placement.tab.x, placement.tab.y, 0, 0, flags);
+	}
+	if (placement.moveOsk and hDwp) {
+		hDwp = DeferWindowPos(hDwp, hOskWnd, NULL,
+			placement.osk.x, placement.osk.y, 0, 0, flags);
+	}
+	if (!hDwp or !EndDeferWindowPos(hDwp)) { return Telemetry::CountWindowMove(false, moves); }
+	Telemetry::CountWindowMove(true, moves);
+
+	// Update window rectangle manually
+	Instance().rcMainWnd.top = placement.tab.y;
+	Instance().rcMainWnd.bottom = placement.tab.y + GetSize().cy;
+	Instance().moveCounter.RecordFrame(moves);
+
+	return true;
+}
+
+bool MainWindow::SetDragPosition(const POINT& point)
+{
+	if (IsLinkedDrag()) { return SetGroupPosition(point); }
+
+	bool bResult = SetPosition(point);
+	if (bResult) { Instance().moveCounter.RecordFrame(1); }
+	return bResult;
+}
+
+void MainWindow::SetLinkedDrag(bool enable)
+{
+	Instance().isLinkedDrag = enable;
+}
+
+bool MainWindow::IsLinkedDrag()
+{
+	return Instance().isLinkedDrag;
+}
+
+GroupLayout::MoveCounter MainWindow::TakeMoveStats()
+{
+	GroupLayout::MoveCounter stats = Instance().moveCounter;
+	Instance().moveCounter.Reset();
+	return stats;
+}
+
+void MainWindow::EnforceTopmost()
+{
+	SetWindowPos(
+		Instance().hMainWnd, HWND_TOPMOST,
+		0, 0, 0, 0,
+		SWP_NOSIZE | SWP_NOMOVE | SWP_NOACTIVATE
+	);
+}
+
+void MainWindow::SetHandle(HWND hWnd)
+{
+	Instance().hMainWnd = hWnd;
+}
+
+HWND MainWindow::GetHandle()
+{
+	return Instance().hMainWnd;
+}
+
+
+// --- MainWindow::Registry ---
+
+DWORD MainWindow::Registry::GetAutostartValue(bool* pRetVal)
+{
+	// Check if autostart is enabled in the registry
+	DWORD dwResult = Telemetry::CountRegistryCall(Telemetry::RegistryReads,
+		RegistryManager{
+			false, Config::Registry::AutoRun
+		}.QueryValue(Config::ApplicationName));
+
+	if (dwResult == ERROR_SUCCESS) {
+		*pRetVal = true;
+	}
+	else if (dwResult != ERROR_FILE_NOT_FOUND) {
+		return dwResult;
+	}
+	else { *pRetVal = false; }
+
+	return ERROR_SUCCESS;
+}
+
+DWORD MainWindow::Registry::SetAutostartValue(bool enable)
+{
+	if (enable) {
+		TCHAR pathBuffer[MAX_PATH + 2] = { _T('"') };
+		DWORD len = GetModuleFileName(nullptr, pathBuffer + 1, MAX_PATH);
+		if (!len or len >= MAX_PATH) {
+			return ERROR_INSUFFICIENT_BUFFER;
+		}
+		pathBuffer[len + 1] = _T('"');
+
+		return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+			RegistryManager{
+				false, Config::Registry::AutoRun
+			}.WriteString(Config::ApplicationName, pathBuffer));
+	}
+	else {
+		return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+			RegistryManager{
+				false, Config::Registry::AutoRun
+			}.RemoveValue(Config::ApplicationName));
+	}
+}
+
+DWORD MainWindow::Registry::GetLinkedDragValue(bool* pRetVal)
+{
+	DWORD dwData{};
+	DWORD dwResult = Telemetry::CountRegistryCall(Telemetry::RegistryReads,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.ReadDWORD(_T("LinkedDrag"), &dwData));
+
+	if (dwResult == ERROR_SUCCESS) {
+		*pRetVal = (dwData == 1);
+	}
+	else if (dwResult == ERROR_FILE_NOT_FOUND) {
+		*pRetVal = false;  // Off unless enabled from the tray menu
+		return ERROR_SUCCESS;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::SetLinkedDragValue(bool enable)
+{
+	return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.WriteDWORD(_T("LinkedDrag"), enable ? 1 : 0));
+}
+
+DWORD MainWindow::Registry::ToggleLinkedDragValue(bool* pRetVal)
+{
+	bool isLinkedDragEnabled{};
+	DWORD dwResult;
+
+	dwResult = GetLinkedDragValue(&isLinkedDragEnabled);
+	if (dwResult != ERROR_SUCCESS) {
+		return dwResult;
+	}
+
+	dwResult = SetLinkedDragValue(!isLinkedDragEnabled);
+	if (pRetVal and dwResult == ERROR_SUCCESS) {
+		*pRetVal = !isLinkedDragEnabled;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::GetTraceValue(bool* pRetVal)
+{
+	DWORD dwData{};
+	DWORD dwResult = Telemetry::CountRegistryCall(Telemetry::RegistryReads,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.ReadDWORD(_T("TraceRecording"), &dwData));
+
+	if (dwResult == ERROR_SUCCESS) {
+		*pRetVal = (dwData == 1);
+	}
+	else if (dwResult == ERROR_FILE_NOT_FOUND) {
+		*pRetVal = false;  // Off unless enabled from the tray menu
+		return ERROR_SUCCESS;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::SetTraceValue(bool enable)
+{
+	return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.WriteDWORD(_T("TraceRecording"), enable ? 1 : 0));
+}
+
+DWORD MainWindow::Registry::ToggleTraceValue(bool* pRetVal)
+{
+	bool isTraceEnabled{};
+	DWORD dwResult;
+
+	dwResult = GetTraceValue(&isTraceEnabled);
+	if (dwResult != ERROR_SUCCESS) {
+		return dwResult;
+	}
+
+	dwResult = SetTraceValue(!isTraceEnabled);
+	if (pRetVal and dwResult == ERROR_SUCCESS) {
+		*pRetVal = !isTraceEnabled;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::GetAutoShowValue(bool* pRetVal)
+{
+	DWORD dwData{};
+	DWORD dwResult = Telemetry::CountRegistryCall(Telemetry::RegistryReads,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.ReadDWORD(_T("AutoShow"), &dwData));
+
+	if (dwResult == ERROR_SUCCESS) {
+		*pRetVal = (dwData == 1);
+	}
+	else if (dwResult == ERROR_FILE_NOT_FOUND) {
+		*pRetVal = false;  // Off unless enabled from the tray menu
+		return ERROR_SUCCESS;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::SetAutoShowValue(bool enable)
+{
+	return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+		RegistryManager{
+			false, Config::Registry::ApplicationSettings
+		}.WriteDWORD(_T("AutoShow"), enable ? 1 : 0));
+}
+
+DWORD MainWindow::Registry::ToggleAutoShowValue(bool* pRetVal)
+{
+	bool isAutoShowEnabled{};
+	DWORD dwResult;
+
+	dwResult = GetAutoShowValue(&isAutoShowEnabled);
+	if (dwResult != ERROR_SUCCESS) {
+		return dwResult;
+	}
+
+	dwResult = SetAutoShowValue(!isAutoShowEnabled);
+	if (pRetVal and dwResult == ERROR_SUCCESS) {
+		*pRetVal = !isAutoShowEnabled;
+	}
+
+	return dwResult;
+}
+
+DWORD MainWindow::Registry::ToggleAutostartValue(bool* pRetVal)
+{
+	bool isAutostartEnabled{};
+	DWORD dwResult;
+
+	// Check if autostart is enabled in the registry
+	dwResult = GetAutostartValue(&isAutostartEnabled);
+	if (dwResult != ERROR_SUCCESS) {
+		return dwResult;
+	}
+
+	dwResult = SetAutostartValue(!isAutostartEnabled);
+	if (pRetVal and dwResult == ERROR_SUCCESS) {
+		*pRetVal = !isAutostartEnabled;
+	}
+
+	return dwResult;
+}
+
+
+
+// --- OSKWindow ---
+
+OSKWindow& OSKWindow::Instance()
+{
+	static OSKWindow instance{};
+	return instance;
+}
+
+void OSKWindow::UpdateWndRect()
+{
+	GetWindowRect(
+		Instance().hOskWnd, &Instance().rcWndRect
+	);
+
+	Instance().wndSize = {
+		Instance().rcWndRect.right - Instance().rcWndRect.left,
+		Instance().rcWndRect.bottom - Instance().rcWndRect.top
+	};
+}
+
+const RECT& OSKWindow::GetRect()
+{
+	return Instance().rcWndRect;
+}
+
+const SIZE& OSKWindow::GetSize()
+{
+	return Instance().wndSize;
+}
+
+void OSKWindow::SetHandle(HWND hWnd)
+{
+	Instance().hOskWnd = hWnd;
+}
+
+HWND OSKWindow::GetHandle()
+{
+	return Instance().hOskWnd;
+}
+
+VOID CALLBACK OSKWindow::PersistDockMode(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK)
+{
+	// Coalesced: writes whatever state is current when the callback runs
+	DWORD dwResult = Registry::SetDockModeValue(IsDockMode());
+	if (dwResult != ERROR_SUCCESS) {
+		PostMessage(MainWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
+			MAKEWPARAM(ID_APP_SETTINGS_ERROR, 0), (LPARAM)dwResult);
+	}
+}
+
+DWORD OSKWindow::LoadDockMode()
+{
+	bool isDockModeEnabled{};
+	DWORD dwResult = Registry::GetDockModeValue(&isDockModeEnabled);
+	Instance().isDockMode = (dwResult == ERROR_SUCCESS) and isDockModeEnabled;
+	return dwResult;
+}
+
+void OSKWindow::SeedDockMode(bool enable)
+{
+	Instance().isDockMode = enable;
+}
+
+bool OSKWindow::IsDockMode()
+{
+	return Instance().isDockMode;
+}
+
+DWORD OSKWindow::ToggleDockMode()
+{
+	OSKWindow& self = Instance();
+	if (!self.pDockModeWork) {
+		self.pDockModeWork = CreateThreadpoolWork(PersistDockMode, nullptr, nullptr);
+		if (!self.pDockModeWork) { return GetLastError(); }
+	}
+
+	const bool isDockModeEnabled = !self.isDockMode;
+	self.isDockMode = isDockModeEnabled;
+
+	// Switch first; the registry write must not delay the visible change
+	UINT msgID = isDockModeEnabled ? ID_APP_DOCKMODE : ID_APP_REGULARMODE;
+	PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
+		MAKEWPARAM(msgID, 0), (LPARAM)MainWindow::GetHandle());
+	Telemetry::HookCommands.Add();
+
+	SubmitThreadpoolWork(self.pDockModeWork);
+	return ERROR_SUCCESS;
+}
+
+void OSKWindow::FlushDockMode()
+{
+	OSKWindow& self = Instance();
+	if (!self.pDockModeWork) { return; }
+
+	WaitForThreadpoolWorkCallbacks(self.pDockModeWork, FALSE);
+	CloseThreadpoolWork(self.pDockModeWork);
+	self.pDockModeWork = nullptr;
+}
+
+
+// --- OSKWindow::Registry ---
+
+DWORD OSKWindow::Registry::GetDockModeValue(bool* pRetVal)
+{
+	// Check if 'Dock' is enabled in the registry
+	DWORD dwData;
+	DWORD dwResult = Telemetry::CountRegistryCall(Telemetry::RegistryReads,
+		RegistryManager{
+			false, Config::Registry::OSKSettings
+		}.ReadDWORD(_T("Dock"), &dwData));
+		
+	if (dwResult == ERROR_SUCCESS) {
+		*pRetVal = (dwData == 1);
+	}
+
+	return dwResult;
+}
+
+DWORD OSKWindow::Registry::SetDockModeValue(bool enable)
+{
+	DWORD newVal = enable ? 1 : 0;
+
+	return Telemetry::CountRegistryCall(Telemetry::RegistryWrites,
+		RegistryManager{
+			false, Config::Registry::OSKSettings
+		}.WriteDWORD(_T("Dock"), newVal));
+}
+
+
+
+// --- DrawContext ---
+
+Result DrawContext::SetResult(Result res)
+{
+	result = std::move(res);
+	return std::move(res);
+}
+
+Result DrawContext::InitializeComponents()
+{
+	pGdiPlus = new GDIPlusData{};
+	if (!GdiPlus()->GetResult().success) {
+		return SetResult(
+			GdiPlus()->GetResult());
+	}
+
+	pRenderer = CreateRenderBackend(rendererKind, m_hWnd);
+	pDragger = new WindowDragger{};
+	pSnapper = new EdgeSnapData{ rendererKind };
+	pAnimator = new AnimationData{};
+	pEffector = new EffectData{};
+	pSkin = new SkinData{};
+	pIndicator = new LayoutIndicator{};
+
+	// Prefer a packed multi-state skin when present (optional feature)
+	TCHAR szBuffer[MAX_PATH]{};
+	if (GetAppFilePath(_T("TabTap.skin"), szBuffer, MAX_PATH) and
+		GetFileAttributes(szBuffer) != INVALID_FILE_ATTRIBUTES)
+	{
+		Skinner()->Load(szBuffer);
+	}
+
+	// Pick up edits of TabTap.png without restarting (optional feature)
+	GdiPlus()->EnableHotReload(m_hWnd, WM_APP_CUSTOM_MESSAGE,
+		MAKEWPARAM(ID_APP_SKIN_RELOADED, 0));
+
+	return {};
+}
+
+DrawContext::~DrawContext()
+{
+	delete Snapper();
+	delete Dragger();
+	delete Animator();
+	delete Effector();
+	delete Skinner();
+	delete Indicator();
+	delete Renderer();  // Before GDI+ shuts down
+	delete GdiPlus();
+}
+
+DrawContext::DrawContext(HWND hWnd, Render::BackendKind kind) :
+	m_hWnd{ hWnd },
+	rendererKind{ kind }
+{
+	InitializeComponents();
+}
+
+Skin::State DrawContext::GetSkinState() const
+{
+	if (Effector()->IsHighlighted()) { return Skin::State::SnapRejected; }
+	if (Dragger()->IsEnabled() or Snapper()->IsPreviewEnabled()) { return Skin::State::Dragging; }
+	if (Snapper()->IsEnabled()) { return Skin::State::Pressed; }
+	if (MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded)) { return Skin::State::Hover; }
+	if (IsWindowVisible(OSKWindow::GetHandle())) { return Skin::State::OskVisible; }
+
+	return Skin::State::Idle;
+}
+
+Result DrawContext::DrawSkinOnLayeredWindow()
+{
+	const SIZE mainSize = MainWindow::GetSize();
+	const bool isMirrored = MainWindow::IsSnapEdge(ScreenEdge::Right);
+
+	Skinner()->SetDpi(GetDpiForWindow(m_hWnd));
+
+	Skin::Frame frame{};
+	HBITMAP hBitmap = Skinner()->GetFrameBitmap(GetSkinState(), isMirrored, &frame);
+	if (!hBitmap) {
+		return SetResult({ ERROR_INVALID_DATA,
+			_T("Skin Error"), _T("No skin frame for the current state") });
+	}
+	if (frame.width < mainSize.cx or frame.height < mainSize.cy) {
+		return SetResult({ ERROR_INVALID_DATA,
+			_T("Skin Error"), _T("Skin frame is smaller than the window") });
+	}
+
+	Gdi::ScopedWindowDC hdcScreen{ NULL };
+	if (!hdcScreen) {
+		return SetResult({ GetLastError(),
+			_T("Failed to get Screen DC") });
+	}
+
+	Gdi::OwnedDC hdcMem{ CreateCompatibleDC(hdcScreen.Get()) };
+	if (!hdcMem) {
+		return SetResult({ GetLastError(),
+			_T("Failed to create memory DC") });
+	}
+
+	Gdi::ScopedSelect selectBitmap{ hdcMem.Get(), hBitmap };
+
+	// Collapsed state shows the outer strip, which is on the left once mirrored
+	const bool isExpanded = MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded);
+	POINT ptSrc = {
+		(isExpanded == isMirrored) ? frame.width - mainSize.cx : 0,
+		0
+	};
+	POINT ptDst = { MainWindow::GetRect().left, MainWindow::GetRect().top };
+	SIZE szWnd = mainSize;
+	BLENDFUNCTION blendFunc = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+
+	BOOL bSuccess = UpdateLayeredWindow(
+		MainWindow::GetHandle(), hdcScreen.Get(),
+		&ptDst, &szWnd,
+		hdcMem.Get(), &ptSrc,
+		0, &blendFunc, ULW_ALPHA
+	);
+
+	if (!bSuccess) {
+		return SetResult({ GetLastError(),
+			_T("Update layered window failed") });
+	}
+
+	return {};
+}
+
+Result DrawContext::DrawImageOnLayeredWindow()
+{
+	Metrics::ScopedTimer timer{ drawTime };
+	drawCount.Add();
+
+	Result drawResult = DrawImageFrame();
+	if (!drawResult) { drawErrors.Add(); }
+	return drawResult;
+}
+
+Result DrawContext::DrawImageFrame()
+{
+	// Packed skin frames need no GDI+ work; fall back to the PNG on failure
+	if (Skinner() and Skinner()->IsLoaded() and DrawSkinOnLayeredWindow()) {
+		return {};
+	}
+
+	// Hold the current frame for the whole draw; a reload swaps in the next one
+	uint64_t imageGeneration{};
+	std::shared_ptr<Gdiplus::Bitmap> spImage = GdiPlus() ? GdiPlus()->GetImage(&imageGeneration) : nullptr;
+
+	if (!spImage || !Effector() || !Renderer()) {
+		return SetResult({ 0,
+			_T("Invalid MainWindow::eState"), _T("Required GDI+ or effect data is missing") });
+	}
+
+	// Read the premultiplied pixels in place (same format, no conversion)
+	Gdiplus::Rect rcImage(0, 0, (INT)spImage->GetWidth(), (INT)spImage->GetHeight());
+	Gdiplus::BitmapData bitmapData{};
+	Gdiplus::Status status = spImage->LockBits(&rcImage,
+		Gdiplus::ImageLockModeRead, PixelFormat32bppPARGB, &bitmapData);
+	if (status != Gdiplus::Ok) {
+		return SetResult({ status,
+			_T("Failed to lock image bits") });
+	}
+
+	const SIZE mainSize = MainWindow::GetSize();
+	const Render::ImageView image{
+		(const Render::Pixel*)bitmapData.Scan0,
+		(long)bitmapData.Width, (long)bitmapData.Height,
+		bitmapData.Stride / (long)sizeof(Render::Pixel)
+	};
+
+	// Effect frames are pre-rendered, so the backend only copies pixels
+	const Render::Layer layer = Render::MakeTabLayer(
+		Effector()->GetFrame(image, imageGeneration),
+		ToGeometry(mainSize),
+		MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded),
+		MainWindow::IsSnapEdge(ScreenEdge::Right),
+		nullptr);
+
+	// --- Draw the image ---
+
+	const bool isComposed = Renderer()->CreateSurface(ToGeometry(mainSize)) and Renderer()->Compose(layer);
+	spImage->UnlockBits(&bitmapData);
+
+	if (!isComposed) {
+		return SetResult({ Renderer()->GetErrorCode(),
+			_T("Failed to compose the tab frame") });
+	}
+
+	// Layout code from the glyph atlas; a failure only loses the code
+	if (Indicator()) {
+		Indicator()->Draw(*Renderer(), ToGeometry(mainSize), GetDpiForWindow(m_hWnd));
+	}
+
+	// --- Update Layered Window ---
+
+	if (!Renderer()->Present({ MainWindow::GetRect().left, MainWindow::GetRect().top }, 0xff)) {
+		return SetResult({ Renderer()->GetErrorCode(),
+			_T("Update layered window failed") });
+	}
+
+	return {};
+}
+
+void DrawContext::RegisterMetrics(Metrics::Registry& registry)
+{
+	drawCount = registry.AddCounter("tabtap_redraws_total", "Tab redraws");
+	drawErrors = registry.AddCounter("tabtap_redraw_errors_total", "Tab redraws that failed");
+	drawTime = registry.AddHistogram("tabtap_redraw_us", "Tab redraw time in microseconds",
+		{ 50, 100, 250, 500, 1000, 2500, 5000, 10000 });
+
+	if (Effector()) { Effector()->RegisterMetrics(registry); }
+	if (Animator()) { Animator()->RegisterMetrics(registry); }
+	if (Snapper()) { Snapper()->RegisterMetrics(registry); }
+	if (Indicator()) { Indicator()->RegisterMetrics(registry); }
+}
+
+Result DrawContext::GetResult() const
+{
+	return result;
+}
+
+
+
+// Always-on release log (decode with tools/LogDecoder)
+namespace AppLog
+{
+	Logging::AsyncLogger Logger{};
+}
+
+
+// Trace ring shared with the hook inside osk.exe
+namespace Tracing
+{
+	TraceChannel Channel{};      // Created before the OSK starts
+	TraceRecorder Recorder{};    // Drains the ring while recording is enabled
+}
+
+// Keyboard auto-show over focused text fields (tray setting)
+namespace FocusTracking
+{
+	FocusWatcher Watcher{};      // Runs while auto-show is enabled
+}
+
+// Input session for the offline Replay tool (started with --record)
+namespace Recording
+{
+	bool IsRequested{};          // Set from the command line
+	Replay::Writer Session{};    // Open while recording
+}
+
+// Handle soak run (--soak): a GDI or USER leak ends TabTap with an error
+namespace Soak
+{
+	bool IsRequested{};          // Set from the command line
+	int ExitCode{};              // TabTap exit code (WM_QUIT wParam)
+	constexpr int LeakExitCode = 3;
+}
+
+// WM_SETTINGCHANGE bursts merged into one pass once they settle
+namespace SettingChanges
+{
+	Settings::Coalescer Pending{};
+}
+
+// Tab and snap preview renderer (--renderer=gdiplus|dib)
+namespace Rendering
+{
+	Render::BackendKind Kind{ Render::BackendKind::GdiPlus };
+}
+
+// Built-in keyboard window instead of osk.exe (--keyboard=builtin)
+namespace BuiltinOsk
+{
+	bool IsRequested{};          // --keyboard=builtin: no osk.exe and no hook
+	BuiltinKeyboard* pKeyboard{};  // Stands in for the OSK window
+}
+
+// All tab timers share one waitable timer, served by the message loop
+namespace Scheduling
+{
+	TimerScheduler Timers{};
+}
+
+// Tab and OSK placement restored at the next start
+namespace SessionState
+{
+	StateStore Store{};          // TabTap.state next to the executable
+}
+
+// Touch and pen contact on the tab (WM_POINTER, no mouse emulation)
+namespace Touch
+{
+	Gestures::Recognizer Gestures{};
+	POINT ptDragOrigin{};        // Tab position when a touch drag started
+}
+
+// OSK process TabTap waits for at exit (SYNCHRONIZE); replaced after a restart
+namespace OskProcess
+{
+	HANDLE hProcess{};           // Owned here once the OSK is hooked
+}
+
+
+
+// Snap adapter for main window, handles edge-snapping logic
+struct MainSnapAdapter : public ISnapAdapter
+{
+	HWND GetTargetWindow() const override
+	{
+		return MainWindow::GetHandle();
+	}
+
+	ScreenEdge GetSnapEdge() const override
+	{
+		return MainWindow::GetSnapEdge();
+	}
+
+	bool IsValidSnapEdge(const ScreenEdge& edge) const override
+	{
+		return MainWindow::IsValidSnapEdge(edge);
+	}
+
+	void OnSnapSuccess(const ScreenEdge& edge, const POINT& pos) override
+	{
+		MainWindow::SetSnapEdge(edge);
+		MainWindow::SetPosition(pos);
+	}
+
+	void OnSnapRejected(const ScreenEdge&, const POINT&) override
+	{
+		HWND hWnd = MainWindow::GetHandle();
+		if (hWnd) {
+			DrawContext* pContext = (DrawContext*)GetWindowLongPtr(hWnd, GWLP_USERDATA);
+			if (pContext) {
+				pContext->Effector()->Enable(&Scheduling::Timers, IDT_EFFECT_TIMER, Effects::Blink);
+			}
+		}
+	}
+
+	void OnSnapEdgeNone(const POINT& pos) override
+	{
+		HWND hWnd = MainWindow::GetHandle();
+		if (hWnd) {
+			DrawContext* pContext = (DrawContext*)GetWindowLongPtr(hWnd, GWLP_USERDATA);
+			if (pContext->Snapper()->IsPreviewEnabled()) {
+				MainWindow::SetPosition(pos);
+			}
+		}
+	}
+};
+
+// System tray setup adapter
+struct TraySetupAdapter : public ITrayAdapter
+{
+	HICON GetIconResource()
+	{
+		TCHAR szBuffer[MAX_PATH];
+		// Expand path to on-screen keyboard
+		if (!ExpandEnvironmentStrings(Config::OSK::DefaultPath, szBuffer, MAX_PATH)) {
+			return NULL;
+		}
+
+		HICON trayIcon = ExtractIcon(NULL, szBuffer, 0);  // First icon in the EXE
+		if (!trayIcon) { return NULL; }
+
+		return trayIcon;
+	}
+
+	Result SetupTrayIcon(NOTIFYICONDATA& trayData) override
+	{
+		trayData.hIcon = GetIconResource();                 // Specifies the icon to display in the tray (paired with NIF_ICON)
+		if (!trayData.hIcon) {
+			return { GetLastError(),
+				_T("Failed to load tray icon") };
+		}
+
+		_tcscpy_s(trayData.szTip, Config::ApplicationName);  // Sets the tooltip text (paired with NIF_TIP)
+		trayData.cbSize = sizeof(NOTIFYICONDATA);            // Specifies the size of the structure, required by Shell_NotifyIcon
+		trayData.hWnd = MainWindow::GetHandle();             // Associates the tray icon with a window to receive callback messages
+		trayData.uID = IDI_NOTIFY_ICON;                      // A unique identifier for the tray icon
+		trayData.uCallbackMessage = WM_APP_TRAYICON;         // Defines the custom message
+		trayData.uFlags =
+			NIF_ICON |      // The tray icon
+			NIF_MESSAGE |   // Event handling
+			NIF_TIP |       // Tooltip text
+			NIF_SHOWTIP;    // Ensures the tooltip appears when hovering (Windows 10/11 enhancement)
+
+		// Required for Windows 10/11
+		trayData.dwState = NIS_SHAREDICON;                   // Indicates the icon is shared and shouldnt be deleted when the notification is removed
+		trayData.dwStateMask = NIS_SHAREDICON;               // Specifies which state bits to modify
+
+		// First add the icon to the tray
+		if (!Shell_NotifyIcon(NIM_ADD, &trayData)) {         // Adds the tray icon to the system tray
+			return { GetLastError(),
+				_T("Failed to initialize tray icon") };
+		}
+		// Set version AFTER adding
+		trayData.uVersion = NOTIFYICON_VERSION;              // Sets the tray icon version
+
+		if (!Shell_NotifyIcon(NIM_SETVERSION, &trayData)) {
+			return { GetLastError(),
+				_T("Failed to set notify icon version") };
+		}
+
+		return {};
+
+	}
+
+	Result CreateTrayMenu(HMENU& hMenu) override
+	{
+		hMenu = CreatePopupMenu();
+		if (!hMenu) {
+			return { ERROR_OUTOFMEMORY,
+				_T("Tray Menu memory allocation failed") };
+		}
+
+		bool isAutostartEnabled{};
+		DWORD dwResult;
+
+		// Check if autostart is enabled in the registry
+		dwResult = MainWindow::Registry::GetAutostartValue(&isAutostartEnabled);
+		if (dwResult != ERROR_SUCCESS) {
+			return { dwResult,
+			_T("Failed to get Main registry data") };
+		}
+		
+		// Cached copy; a background registry write may still be pending
+		bool isDockModeEnabled = OSKWindow::IsDockMode();
+
+		AppendMenu(hMenu, MF_STRING | (isAutostartEnabled ? MF_CHECKED : 0), IDM_TRAY_AUTOSTART, _T("Autostart"));
+		AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
+		AppendMenu(hMenu, MF_STRING | (isDockModeEnabled ? MF_CHECKED : 0), IDM_TRAY_DOCKMODE, _T("Forced Dock mode"));
+		AppendMenu(hMenu, MF_STRING | (MainWindow::IsLinkedDrag() ? MF_CHECKED : 0), IDM_TRAY_LINKEDDRAG, _T("Linked drag"));
+		AppendMenu(hMenu, MF_STRING | (FocusTracking::Watcher.IsRunning() ? MF_CHECKED : 0), IDM_TRAY_AUTOSHOW, _T("Show for text fields"));
+		AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
+		AppendMenu(hMenu, MF_STRING | (Tracing::Recorder.IsRunning() ? MF_CHECKED : 0), IDM_TRAY_TRACE, _T("Record trace"));
+#ifdef TABTAP_PROFILE
+		AppendMenu(hMenu, MF_STRING, IDM_TRAY_PROFILE_DUMP, _T("Dump handler profile"));
+#endif // TABTAP_PROFILE
+		AppendMenu(hMenu, MF_STRING, IDM_TRAY_EXIT, _T("Exit"));
+
+		return {};
+	}
+};
+
+
+
+// Forward declarations
+LRESULT CALLBACK WindowProc(HWND, UINT, WPARAM, LPARAM);
+
+
+// Window procedure handler profile (TABTAP_PROFILE builds only)
+namespace Profile
+{
+	constexpr Profiling::Key Keys[] = {
+		{ WM_TIMER, IDT_KEEP_ON_TOP,                       "WM_TIMER/KEEP_ON_TOP" },
+		{ WM_TIMER, IDT_EFFECT_TIMER,                      "WM_TIMER/EFFECT" },
+		{ WM_TIMER, IDT_ANIMATION_TIMER,                   "WM_TIMER/ANIMATION" },
+		{ WM_TIMER, IDT_POWER_REPORT,                      "WM_TIMER/POWER_REPORT" },
+		{ WM_TIMER, IDT_LONG_PRESS,                        "WM_TIMER/LONG_PRESS" },
+		{ WM_TIMER, IDT_OSK_RESTART,                       "WM_TIMER/OSK_RESTART" },
+		{ WM_TIMER, IDT_HANDLE_SAMPLE,                     "WM_TIMER/HANDLE_SAMPLE" },
+		{ WM_TIMER, IDT_SETTINGS_SETTLE,                   "WM_TIMER/SETTINGS_SETTLE" },
+		{ WM_TIMER, IDT_CARET_FRAME,                       "WM_TIMER/CARET_FRAME" },
+		{ WM_SETCURSOR, 0,                                 "WM_SETCURSOR" },
+		{ WM_MOUSEACTIVATE, 0,                             "WM_MOUSEACTIVATE" },
+		{ WM_MOUSEMOVE, 0,                                 "WM_MOUSEMOVE" },
+		{ WM_MOUSEWHEEL, 0,                                "WM_MOUSEWHEEL" },
+		{ WM_LBUTTONDOWN, 0,                               "WM_LBUTTONDOWN" },
+		{ WM_LBUTTONUP, 0,                                 "WM_LBUTTONUP" },
+		{ WM_RBUTTONDOWN, 0,                               "WM_RBUTTONDOWN" },
+		{ WM_RBUTTONUP, 0,                                 "WM_RBUTTONUP" },
+		{ WM_RBUTTONDBLCLK, 0,                             "WM_RBUTTONDBLCLK" },
+		{ WM_MBUTTONDOWN, 0,                               "WM_MBUTTONDOWN" },
+		{ WM_MBUTTONUP, 0,                                 "WM_MBUTTONUP" },
+		{ WM_MOUSELEAVE, 0,                                "WM_MOUSELEAVE" },
+		{ WM_POINTERACTIVATE, 0,                           "WM_POINTERACTIVATE" },
+		{ WM_POINTERDOWN, 0,                               "WM_POINTERDOWN" },
+		{ WM_POINTERUPDATE, 0,                             "WM_POINTERUPDATE" },
+		{ WM_POINTERUP, 0,                                 "WM_POINTERUP" },
+		{ WM_POINTERCAPTURECHANGED, 0,                     "WM_POINTERCAPTURECHANGED" },
+		{ WM_APP_TRAYICON, 0,                              "WM_APP_TRAYICON" },
+		{ WM_APP_APPBAR, 0,                                "WM_APP_APPBAR" },
+		{ WM_COMMAND, IDM_TRAY_DOCKMODE,                   "WM_COMMAND/DOCKMODE" },
+		{ WM_COMMAND, IDM_TRAY_AUTOSTART,                  "WM_COMMAND/AUTOSTART" },
+		{ WM_COMMAND, IDM_TRAY_LINKEDDRAG,                 "WM_COMMAND/LINKEDDRAG" },
+		{ WM_COMMAND, IDM_TRAY_PROFILE_DUMP,               "WM_COMMAND/PROFILE_DUMP" },
+		{ WM_COMMAND, IDM_TRAY_TRACE,                      "WM_COMMAND/TRACE" },
+		{ WM_COMMAND, IDM_TRAY_AUTOSHOW,                   "WM_COMMAND/AUTOSHOW" },
+		{ WM_COMMAND, IDM_TRAY_EXIT,                       "WM_COMMAND/EXIT" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_SYNC_Y_POSITION,   "CUSTOM/SYNC_Y_POSITION" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_SKIN_RELOADED,     "CUSTOM/SKIN_RELOADED" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_SETTINGS_ERROR,    "CUSTOM/SETTINGS_ERROR" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_OSK_EXITED,        "CUSTOM/OSK_EXITED" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_OSK_RESTARTED,     "CUSTOM/OSK_RESTARTED" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_LAYOUT_CHANGED,    "CUSTOM/LAYOUT_CHANGED" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_AUTO_SHOW,         "CUSTOM/AUTO_SHOW" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_CARET_MOVED,       "CUSTOM/CARET_MOVED" },
+		{ WM_CREATE, 0,                                    "WM_CREATE" },
+		{ WM_DESTROY, 0,                                   "WM_DESTROY" },
+		{ WM_SETTINGCHANGE, 0,                             "WM_SETTINGCHANGE" },
+		{ WM_POWERBROADCAST, 0,                            "WM_POWERBROADCAST" },
+		{ WM_WTSSESSION_CHANGE, 0,                         "WM_WTSSESSION_CHANGE" },
+	};
+
+#ifdef TABTAP_PROFILE
+	Profiling::MessageProfiler<std::size(Keys)> Table{ Keys };
+#endif // TABTAP_PROFILE
+}
+
+#define PROFILE_WNDPROC(message, command) \
+	PROFILE_HANDLER(Profile::Table, Profile::Keys, message, command)
+
+
+// Starts or stops recording the shared trace ring to TabTap.trace.log
+void SetTraceRecording(bool enable)
+{
+	if (!enable) {
+		Tracing::Recorder.Stop();
+		return;
+	}
+
+	TCHAR szBuffer[MAX_PATH];
+	if (!TraceRecorder::GetTracePath(szBuffer, MAX_PATH)) { return; }
+
+	Tracing::Recorder.Start(Tracing::Channel, szBuffer);
+}
+
+// Starts or stops showing the OSK for focused text fields
+void SetAutoShow(HWND hWnd, bool enable)
+{
+	if (!enable) {
+		FocusTracking::Watcher.Stop();
+		return;
+	}
+
+	if (HWND hOskWnd = OSKWindow::GetHandle()) {
+		DWORD dwProcessId{};
+		GetWindowThreadProcessId(hOskWnd, &dwProcessId);
+		FocusTracking::Watcher.SetKeyboardProcess(dwProcessId);
+	}
+
+	if (!FocusTracking::Watcher.Start(hWnd, WM_APP_CUSTOM_MESSAGE, ID_APP_AUTO_SHOW)) {
+		LOG_WARNING(AppLog::Logger, "Failed to subscribe to UI Automation focus changes");
+	}
+}
+
+// Captures the tab and OSK placement for the current monitor layout
+void RememberSessionState()
+{
+	Snapshot::State state = SessionState::Store.Get();
+	state.edge = uint8_t(ToLayoutEdge(MainWindow::GetSnapEdge()));
+	state.isDockMode = OSKWindow::IsDockMode();
+
+	Snapshot::Placement placement{};
+	placement.topology = GetMonitorTopologyId();
+	placement.tabTop = MainWindow::GetRect().top;
+
+	HWND hOskWnd = OSKWindow::GetHandle();
+	RECT rcOsk{};
+	if (hOskWnd and GetWindowRect(hOskWnd, &rcOsk)) {
+		placement.oskLeft = rcOsk.left;
+		placement.oskTop = rcOsk.top;
+
+		BYTE alpha{};
+		DWORD dwFlags{};
+		if (GetLayeredWindowAttributes(hOskWnd, NULL, &alpha, &dwFlags) and (dwFlags & LWA_ALPHA)) {
+			state.opacity = alpha;
+		}
+		else if (BuiltinOsk::pKeyboard) {
+			// Presented with UpdateLayeredWindow, so the alpha is only known to the keyboard
+			state.opacity = BuiltinOsk::pKeyboard->GetOpacity();
+		}
+	}
+	else if (const Snapshot::Placement* pOld = Snapshot::FindPlacement(state, placement.topology)) {
+		// Keep the last known OSK position
+		placement.oskLeft = pOld->oskLeft;
+		placement.oskTop = pOld->oskTop;
+	}
+
+	Snapshot::StorePlacement(&state, placement);
+	SessionState::Store.Update(state);
+}
+
+// Starts writing TabTap.replay next to the executable
+void StartReplayRecording(DrawContext* pContext)
+{
+	const std::filesystem::path path = GetAppFilePath(_T("TabTap.replay"));
+
+	if (!Recording::Session.Open(path,
+		ToGeometry(MainWindow::GetRect()),
+		uint8_t(ToLayoutEdge(MainWindow::GetSnapEdge())),
+		MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded),
+		MainWindow::IsLinkedDrag(),
+		pContext->Skinner()->IsLoaded()))
+	{
+		LOG_WARNING(AppLog::Logger, "Failed to open the replay session file");
+		return;
+	}
+	LOG_INFO(AppLog::Logger, "Recording replay session");
+}
+
+// Appends a tab window message to the replay session
+void RecordReplayEvent(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	Replay::Message message{};
+	uint8_t detail{};
+
+	switch (uMsg)
+	{
+	case WM_MOUSEMOVE:       message = Replay::Message::MouseMove; break;
+	case WM_MOUSELEAVE:      message = Replay::Message::MouseLeave; break;
+	case WM_LBUTTONDOWN:     message = Replay::Message::LButtonDown; break;
+	case WM_LBUTTONUP:       message = Replay::Message::LButtonUp; break;
+	case WM_RBUTTONDOWN:     message = Replay::Message::RButtonDown; break;
+	case WM_RBUTTONUP:       message = Replay::Message::RButtonUp; break;
+	case WM_RBUTTONDBLCLK:   message = Replay::Message::RButtonDblClk; break;
+	case WM_MBUTTONDOWN:     message = Replay::Message::MButtonDown; break;
+	case WM_MBUTTONUP:       message = Replay::Message::MButtonUp; break;
+	case WM_SETTINGCHANGE:
+	{
+		message = Replay::Message::SettingChange;
+		const uint8_t changes = Settings::Classify(uint32_t(wParam), reinterpret_cast<LPCWSTR>(lParam));
+		detail = uint8_t((changes & Settings::ChangeTheme) ? Replay::SettingKind::Theme
+			: (changes & Settings::ChangeLayout) ? Replay::SettingKind::WorkArea
+			: Replay::SettingKind::Ignored);
+		break;
+	}
+	case WM_APP_CUSTOM_MESSAGE:
+	{
+		// Animation steps are regenerated by the replay itself
+		if (LOWORD(wParam) != ID_APP_SYNC_Y_POSITION) { return; }
+		message = Replay::Message::SyncPosition;
+		break;
+	}
+	default: return;
+	}
+
+	// Mouse moves only read state; everything else may act on a changed environment
+	if (message != Replay::Message::MouseMove) {
+		Replay::Environment env{};
+		RECT rcWorkArea{};
+		SystemParametersInfo(SPI_GETWORKAREA, 0, &rcWorkArea, 0);
+		env.workArea = ToGeometry(rcWorkArea);
+		env.screen = GetScreenSize();
+
+		HWND hOskWnd = OSKWindow::GetHandle();
+		RECT rcOsk{};
+		if (hOskWnd and GetWindowRect(hOskWnd, &rcOsk)) {
+			env.oskRect = ToGeometry(rcOsk);
+		}
+		env.isOskVisible = hOskWnd and IsWindowVisible(hOskWnd);
+
+		Recording::Session.WriteEnvironment(env);
+	}
+
+	POINT ptCursor{};
+	GetCursorPos(&ptCursor);
+	Recording::Session.WriteEvent(message, ToGeometry(ptCursor), detail);
+}
+
+// Arms the timer for the pending setting pass
+void ScheduleSettingPass(uint64_t nowMs)
+{
+	const uint64_t deadlineMs = SettingChanges::Pending.GetDeadline();
+	if (deadlineMs == Settings::NoDeadline) { return; }
+
+	const UINT delayMs = UINT(deadlineMs > nowMs ? deadlineMs - nowMs : 0);
+	Scheduling::Timers.Set(IDT_SETTINGS_SETTLE, delayMs, delayMs / 5, false);
+}
+
+// Runs the theme and layout pass a settled WM_SETTINGCHANGE burst asked for
+void ApplySettingChanges(HWND hWnd, DrawContext* pContext, PowerMonitor* pPower)
+{
+	const uint64_t nowMs = TimerScheduler::GetTimeMs();
+	uint32_t merged{};
+	const uint8_t changes = SettingChanges::Pending.Take(nowMs, &merged);
+	if (!changes) {
+		// Woken before the deadline
+		ScheduleSettingPass(nowMs);
+		return;
+	}
+	Telemetry::SettingPasses.Add();
+	LOG_INFO(AppLog::Logger, "Setting changes applied: {} merged, theme {}, layout {}",
+		merged, (changes & Settings::ChangeTheme) != 0, (changes & Settings::ChangeLayout) != 0);
+
+	// Re-apply the correct theme based on current system setting
+	if (changes & Settings::ChangeTheme) {
+		ThemeManager::FollowSystemTheme(hWnd);
+	}
+	if (!(changes & Settings::ChangeLayout)) { return; }
+
+	// Update information about the usable screen area
+	WorkAreaManager::Refresh();
+
+	// Lambda function to update window position, start the blink effect, and redraw
+	auto UpdatePosition = [&](ScreenEdge edge) {
+		MainWindow::SetSnapEdge(edge);
+		if (pPower->GetDecision().allowPeriodic) {
+			pContext->Effector()->Enable(&Scheduling::Timers, IDT_EFFECT_TIMER, Effects::Blink);
+		}
+		pContext->DrawImageOnLayeredWindow();
+		RememberSessionState();
+		};
+
+	// Determine if we need to switch sides
+	const TabLayout::Edge newEdge = TabLayout::ResolveWorkAreaChange(
+		ToLayoutEdge(MainWindow::GetSnapEdge()),
+		ToGeometry(WorkAreaManager::GetWorkArea()),
+		GetScreenSize());
+
+	if (newEdge != TabLayout::Edge::None) {
+		UpdatePosition(ToScreenEdge(newEdge));
+	}
+	else {
+		const RECT& rect = MainWindow::GetRect();
+		auto [cx, cy] = MainWindow::ClampPoint({
+			rect.left, rect.top });
+
+		// Update position if clamping changed the top coordinate
+		if (rect.top != cy) {
+			UpdatePosition(MainWindow::GetSnapEdge());
+		}
+	}
+}
+
+// Keyboard layout of the window the OSK types into
+HKL GetForegroundLayout()
+{
+	return GetKeyboardLayout(GetWindowThreadProcessId(GetForegroundWindow(), nullptr));
+}
+
+// Wakeup and CPU usage report period, and how late it may run to share a wakeup
+constexpr UINT PowerReportMs = 60 * 60 * 1000;
+constexpr UINT PowerReportToleranceMs = 60 * 1000;
+
+// GDI/USER object sampling; soak runs sample faster and budget the counts
+constexpr UINT HandleSampleMs = 60 * 1000;
+constexpr UINT SoakSampleMs = 5 * 1000;
+constexpr UINT SoakWarmupMs = 2 * 60 * 1000;   // Caches and the first menus settle
+constexpr int64_t SoakBudgetSlack = 32;        // Objects allowed over the warmup count
+
+// Samples the object counts; logs a leak and ends a soak run that has one
+void SampleHandles(HWND hWnd, HandleMonitor* pHandles)
+{
+	const HandleMonitor::Report report = pHandles->Sample(TimerScheduler::GetTimeMs());
+	if (report.isLeakFound) {
+		LOG_ERROR(AppLog::Logger, "Handle leak: {} GDI ({}/h), {} USER ({}/h) objects",
+			report.counts.gdiObjects, report.gdiPerHour, report.counts.userObjects, report.userPerHour);
+	}
+	if (!pHandles->IsSoak()) { return; }
+
+	if (report.isLeakFound or report.isOverBudget) {
+		LOG_ERROR(AppLog::Logger, "Soak run failed: {} GDI, {} USER objects, over budget {}",
+			report.counts.gdiObjects, report.counts.userObjects, report.isOverBudget);
+		Soak::ExitCode = Soak::LeakExitCode;
+		DestroyWindow(hWnd);
+	}
+}
+
+// Applies a changed power decision to timers, effects and process QoS
+void ApplyPowerPolicy(HWND hWnd, DrawContext* pContext, PowerMonitor* pPower)
+{
+	const bool wasHidden = pPower->GetDecision().isHidden;
+
+	Power::Decision decision{};
+	if (!pPower->TakeChange(&decision)) { return; }
+
+	// Topmost refresh stops entirely while nobody can see the window
+	if (decision.keepOnTopMs) {
+		Scheduling::Timers.Set(IDT_KEEP_ON_TOP, decision.keepOnTopMs, decision.keepOnTopMs / 10, true);
+	}
+	else {
+		Scheduling::Timers.Kill(IDT_KEEP_ON_TOP);
+	}
+
+	if (!decision.allowPeriodic) {
+		// Drop the remaining effect frames
+		if (pContext->Effector()->IsEnabled()) {
+			pContext->Effector()->Disable();
+			pContext->DrawImageOnLayeredWindow();
+		}
+
+		// Skip the rest of an animation instead of stepping it unseen
+		if (pContext->Animator()->IsEnabled()) {
+			pContext->Animator()->Finish();
+			Scheduling::Timers.Kill(IDT_ANIMATION_TIMER);
+			MainWindow::UpdateWndRect();
+			pPower->EndActivity(Power::Activity::Animation);
+		}
+	}
+
+	// Step aside for fullscreen apps: DWM no longer composites the overlay
+	if (decision.isHidden != wasHidden) {
+		if (decision.isHidden) {
+			ShowWindow(hWnd, SW_HIDE);
+			Scheduling::Timers.Kill(IDT_POWER_REPORT);
+		}
+		else {
+			ShowWindow(hWnd, SW_SHOWNA);
+			MainWindow::EnforceTopmost();
+			pContext->DrawImageOnLayeredWindow();
+			Scheduling::Timers.Set(IDT_POWER_REPORT, PowerReportMs, PowerReportToleranceMs, true);
+		}
+	}
+
+	ApplyProcessQos(decision.qos);
+
+	LOG_INFO(AppLog::Logger, "Power policy: visible {}, hidden {}, periodic {}, topmost {} ms, qos {}",
+		decision.isVisible, decision.isHidden, decision.allowPeriodic, decision.keepOnTopMs, (uint32_t)decision.qos);
+}
+
+// Logs wakeups and CPU time normalized per hour
+void LogUsageReport(PowerMonitor* pPower)
+{
+	const Power::UsageMeter::Report report = pPower->TakeUsageReport();
+	LOG_INFO(AppLog::Logger, "Usage: {} wakeups in {} ms ({} wakeups/h, {} CPU ms/h)",
+		report.wakeups, report.elapsedMs, report.wakeupsPerHour, report.cpuMsPerHour);
+}
+
+// Carries out a recognized touch gesture with the same logic as the mouse path
+void ApplyGesture(HWND hWnd, DrawContext* pContext, PowerMonitor* pPower, TrayManager* pTray,
+	const Gestures::Action& action)
+{
+	switch (action.kind)
+	{
+	case Gestures::ActionKind::Tap:
+		// Same as a click: toggle the keyboard
+		SendMessage(hWnd, WM_LBUTTONUP, 0, 0);
+		break;
+
+	case Gestures::ActionKind::DragStart:
+		// Update work area to avoid taskbar during drag
+		WorkAreaManager::Refresh();
+		Touch::ptDragOrigin = { MainWindow::GetRect().left, MainWindow::GetRect().top };
+		pPower->BeginActivity(Power::Activity::Drag);
+		ApplyPowerPolicy(hWnd, pContext, pPower);
+		[[fallthrough]];
+
+	case Gestures::ActionKind::DragMove:
+		// Vertical drag; the tab stays on its edge
+		MainWindow::SetDragPosition({ Touch::ptDragOrigin.x, Touch::ptDragOrigin.y + action.offset.y });
+		break;
+
+	case Gestures::ActionKind::DragEnd:
+		pPower->EndActivity(Power::Activity::Drag);
+		ApplyPowerPolicy(hWnd, pContext, pPower);
+		RememberSessionState();
+		break;
+
+	case Gestures::ActionKind::LongPress:
+		pTray->ShowMenuAt({ action.pt.x, action.pt.y });
+		break;
+
+	case Gestures::ActionKind::Flick:
+	{
+		// Toward the screen edge collapses the tab, away from it expands it (touch has no hover)
+		const bool isTowardEdge = MainWindow::IsSnapEdge(ScreenEdge::Right) ? action.offset.x > 0 : action.offset.x < 0;
+		MainWindow::SetExpansionState(isTowardEdge
+			? MainWindow::ExpansionState::Collapsed
+			: MainWindow::ExpansionState::Expanded);
+		pContext->DrawImageOnLayeredWindow();
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+// Feeds a touch or pen message to the gesture recognizer; false for mouse pointers
+bool OnTabPointer(HWND hWnd, DrawContext* pContext, PowerMonitor* pPower, TrayManager* pTray,
+	Gestures::PointerPhase phase, WPARAM wParam)
+{
+	const UINT32 pointerId = GET_POINTERID_WPARAM(wParam);
+
+	POINTER_INFO info{};
+	if (GetPointerInfo(pointerId, &info)) {
+		if (info.pointerType != PT_TOUCH and info.pointerType != PT_PEN) { return false; }
+		if (info.pointerFlags & POINTER_FLAG_CANCELED) { phase = Gestures::PointerPhase::Cancel; }
+	}
+	else if (phase != Gestures::PointerPhase::Cancel) {
+		return false;
+	}
+	else {
+		info.dwTime = GetTickCount();  // Capture loss carries no pointer data
+	}
+
+	const Gestures::Action action = Touch::Gestures.OnPointer({ phase, pointerId,
+		{ info.ptPixelLocation.x, info.ptPixelLocation.y }, info.dwTime });
+
+	// The long press timer only runs while the contact holds still
+	if (phase == Gestures::PointerPhase::Down and Touch::Gestures.IsActive()) {
+		Scheduling::Timers.Set(IDT_LONG_PRESS, Touch::Gestures.GetLongPressDelay(), 0, false);
+	}
+	else if (action.kind != Gestures::ActionKind::None or !Touch::Gestures.IsActive()) {
+		Scheduling::Timers.Kill(IDT_LONG_PRESS);
+	}
+
+	ApplyGesture(hWnd, pContext, pPower, pTray, action);
+	return true;
+}
+
+// OSK position for the text being typed: centred on the tab unless that
+// covers the caret (or the focused field when the app draws its own caret)
+OskPlacement::Placement SolveOskPlacement(bool isCaretAware)
+{
+	OSKWindow::UpdateWndRect();
+
+	OskPlacement::Input input{};
+	input.osk = ToGeometry(OSKWindow::GetRect());
+	input.tab = ToGeometry(MainWindow::GetRect());
+	input.workArea = ToGeometry(WorkAreaManager::GetWorkArea());
+
+	RECT rcCaret{};
+	if (isCaretAware and
+		(CaretTracker::GetCaretRect(&rcCaret) or FocusTracking::Watcher.GetFocusRect(&rcCaret)))
+	{
+		input.caret = ToGeometry(rcCaret);
+	}
+	return OskPlacement::Solve(input);
+}
+
+// Synchronizes position with main application window (clear of the caret unless told otherwise)
+void SyncOskPositionWithMain(bool isCaretAware = true)
+{
+	const OskPlacement::Placement placement = SolveOskPlacement(isCaretAware);
+
+	const BOOL bMoved = SetWindowPos(
+		OSKWindow::GetHandle(), NULL,
+		placement.osk.x, placement.osk.y,
+		0, 0,
+		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+	);
+	Telemetry::CountWindowMove(bMoved != FALSE);
+}
+
+// Moves the visible OSK off the caret (or back home) through the animation, once per frame
+void FollowCaret(HWND hWnd, DrawContext* pContext, PowerMonitor* pPower, CaretTracker* pCaret)
+{
+	const uint64_t nowMs = TimerScheduler::GetTimeMs();
+	if (!pCaret->Take(nowMs)) {
+		if (pCaret->IsPending()) {
+			Scheduling::Timers.Set(IDT_CARET_FRAME, pCaret->GetDelay(nowMs), 0, false);
+		}
+		return;
+	}
+
+	// The hooks only run while the keyboard is up
+	HWND hOskWnd = OSKWindow::GetHandle();
+	if (!hOskWnd or !IsWindowVisible(hOskWnd)) {
+		pCaret->Stop();
+		return;
+	}
+
+	// Animating unseen is wasted work
+	if (!pPower->GetDecision().allowPeriodic) { return; }
+
+	// A running animation (this one or the tab's) finishes first; look again after it
+	if (pContext->Animator()->IsEnabled()) {
+		pCaret->Post();
+		return;
+	}
+
+	const OskPlacement::Placement placement = SolveOskPlacement(true);
+	if (!placement.isMoved) { return; }
+
+	pContext->Animator()->Enable(hOskWnd, ToPoint(placement.osk));
+	if (pContext->Animator()->IsEnabled()) {
+		pPower->BeginActivity(Power::Activity::Animation);
+		ApplyPowerPolicy(hWnd, pContext, pPower);
+		Scheduling::Timers.Set(IDT_ANIMATION_TIMER, TabLayout::AnimationFrameMs, 0, true);
+	}
+}
+
+// Create Window
+HWND CreateLayeredWindow(HINSTANCE hInstance)
+{
+	POINT pt{};
+	const auto [cx, cy] = MainWindow::GetSize();
+
+	WorkAreaManager::Refresh();
+
+	// Last placement for this monitor layout, if any
+	const Snapshot::State& state = SessionState::Store.Get();
+	const Snapshot::Placement* pPlacement = SessionState::Store.IsLoaded()
+		? Snapshot::FindPlacement(state, GetMonitorTopologyId())
+		: nullptr;
+	const ScreenEdge savedEdge = ToScreenEdge(TabLayout::Edge(state.edge));
+
+	// Adjust window X position
+	if (pPlacement and MainWindow::IsValidSnapEdge(savedEdge)) {
+		MainWindow::SetSnapEdge(savedEdge);
+		pt.x = (savedEdge == ScreenEdge::Left)
+			? WorkAreaManager::GetWorkArea().left
+			: WorkAreaManager::GetWorkArea().right - cx;
+	}
+	else if (WorkAreaManager::IsFreeEdge(ScreenEdge::Left)) {
+		MainWindow::SetSnapEdge(ScreenEdge::Left);
+		pt.x = WorkAreaManager::GetWorkArea().left;
+	}
+	else {
+		MainWindow::SetSnapEdge(ScreenEdge::Right);
+		pt.x = WorkAreaManager::GetWorkArea().right - cx;
+	}
+
+	// Adjust position according to the snapshot or the on-screen keyboard
+	if (pPlacement) {
+		pt.y = pPlacement->tabTop;
+	}
+	else {
+		OSKWindow::UpdateWndRect();
+
+		LONG oskWndHeight = OSKWindow::GetRect().bottom - OSKWindow::GetRect().top;
+		pt.y = OSKWindow::GetRect().top + (oskWndHeight - cy) / 2;
+	}
+
+	pt = MainWindow::ClampPoint(pt);
+
+	return
+		CreateWindowEx(
+			WS_EX_TOPMOST | WS_EX_LAYERED | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+			Config::MainWindowClass,
+			Config::ApplicationName,
+			WS_POPUP,
+			pt.x, pt.y,
+			cx, cy,
+			NULL, NULL, hInstance, NULL
+		);
+}
+
+// Register Window Class
+ATOM RegisterWindowClass(HINSTANCE hInstance, WNDCLASSEX* wcex)
+{
+	wcex->cbSize = sizeof(WNDCLASSEX);
+	wcex->lpfnWndProc = WindowProc;                  // Window procedure
+	wcex->hInstance = hInstance;                     // App instance
+	wcex->lpszClassName = Config::MainWindowClass;   // Class name
+	wcex->hCursor = LoadCursor(NULL, IDC_ARROW);     // Cursor
+	wcex->hbrBackground = (HBRUSH)GetStockObject(NULL_BRUSH);            // Background
+	//wcex.hIconSm = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_MAIN_ICON));  // Icon
+	wcex->style = CS_HREDRAW | CS_VREDRAW | CS_DBLCLKS;
+
+	return RegisterClassEx(wcex);
+}
+
+// Window procedure of the built-in keyboard: pointer input, and the commands
+// the hook answers inside osk.exe
+LRESULT CALLBACK KeyboardWindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	BuiltinKeyboard* pKeyboard = BuiltinOsk::pKeyboard;
+	if (!pKeyboard) { return DefWindowProc(hWnd, uMsg, wParam, lParam); }
+
+	const POINT pt{ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
+
+	switch (uMsg)
+	{
+	case WM_MOUSEACTIVATE:
+	{
+		// Focus stays in the window being typed into
+		return MA_NOACTIVATE;
+	}
+
+	case WM_LBUTTONDOWN:
+	{
+		if (pKeyboard->IsOnCloseBox(pt)) { return 0; }  // Hides on button up
+
+		// Keys type; the caption strip and the gaps move the window
+		if (pKeyboard->OnPointerDown(pt)) {
+			SetCapture(hWnd);
+		}
+		else {
+			pKeyboard->BeginDrag();
+		}
+		return 0;
+	}
+
+	case WM_LBUTTONUP:
+	{
+		const bool isCaptured = GetCapture() == hWnd;
+		pKeyboard->EndDrag();
+		pKeyboard->OnPointerUp();
+		if (isCaptured) {
+			ReleaseCapture();
+		}
+		else if (pKeyboard->IsOnCloseBox(pt)) {
+			ShowWindow(hWnd, SW_HIDE);
+		}
+		return 0;
+	}
+
+	case WM_MOUSEMOVE:
+	{
+		pKeyboard->Drag();
+		return 0;
+	}
+
+	case WM_CAPTURECHANGED:
+	{
+		pKeyboard->EndDrag();
+		pKeyboard->OnPointerUp();
+		return 0;
+	}
+
+	case WM_MBUTTONDOWN:
+	{
+		// Middle click on the close box puts the keyboard back next to the tab, as on the 'X' of osk.exe
+		if (pKeyboard->IsOnCloseBox(pt)) {
+			PostMessage(MainWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
+				MAKEWPARAM(ID_APP_SYNC_Y_POSITION, 0), (LPARAM)hWnd);
+			return 0;
+		}
+		pKeyboard->BeginDrag();
+		return 0;
+	}
+
+	case WM_RBUTTONDOWN:
+	{
+		// Right and middle drag move the window from anywhere
+		pKeyboard->BeginDrag();
+		return 0;
+	}
+
+	case WM_MBUTTONUP:
+	case WM_RBUTTONUP:
+	{
+		const bool isDragging = pKeyboard->IsDragging();
+		pKeyboard->EndDrag();
+		if (!isDragging and pKeyboard->IsOnCloseBox(pt)) {
+			ShowWindow(hWnd, SW_HIDE);
+		}
+		return 0;
+	}
+
+	case WM_MBUTTONDBLCLK:
+	case WM_RBUTTONDBLCLK:
+	{
+		ShowWindow(hWnd, SW_HIDE);
+		return 0;
+	}
+
+	case WM_SHOWWINDOW:
+	{
+		// A layered window shows nothing until it is drawn
+		if (wParam) { pKeyboard->Draw(); }
+		break;
+	}
+
+	case WM_DPICHANGED:
+	{
+		pKeyboard->Draw();
+		return 0;
+	}
+
+	case WM_CLOSE:
+	{
+		// Closing hides; the window itself goes with the keyboard object
+		ShowWindow(hWnd, SW_HIDE);
+		return 0;
+	}
+
+	case WM_APP_CUSTOM_MESSAGE:
+	{
+		const WORD wCommandId = LOWORD(wParam);
+
+		if (wCommandId == ID_APP_DOCKMODE or wCommandId == ID_APP_REGULARMODE) {
+			pKeyboard->SetDockMode(wCommandId == ID_APP_DOCKMODE);
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_FADE) {
+			pKeyboard->Fade(HIWORD(wParam) != 0);
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_HOOK_PING) {
+			return OskAttach::MakeHookReply(OskAttach::HookVersion);
+		}
+
+		if (wCommandId == ID_APP_RECONNECT) {
+			return 0;  // Same process; nothing to reopen
+		}
+
+		return 1;
+	}
+
+	default: break;
+	}
+
+	return DefWindowProc(hWnd, uMsg, wParam, lParam);
+}
+
+// Creates the built-in keyboard from TabTap.keys, or from the default table without one;
+// returns the error of the failed call (ERROR_SUCCESS once BuiltinOsk::pKeyboard is set)
+DWORD CreateBuiltinKeyboard(HINSTANCE hInstance, const std::filesystem::path& tablePath)
+{
+	std::string table{};
+	if (std::ifstream file{ tablePath, std::ios::binary }) {
+		table.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+	}
+
+	KeyLayout::Layout layout{};
+	const KeyLayout::Status status = KeyLayout::Parse(table.empty() ? KeyLayout::DefaultTable : table.c_str(), &layout);
+	if (status != KeyLayout::Status::Ok) {
+		LOG_WARNING(AppLog::Logger, "Keyboard table: {}; using the default", KeyLayout::GetStatusName(status));
+		KeyLayout::Parse(KeyLayout::DefaultTable, &layout);
+	}
+	LOG_INFO(AppLog::Logger, "Keyboard table: {} keys in {} rows{}", layout.keyCount, layout.rowCount,
+		table.empty() ? " (default)" : "");
+
+	BuiltinKeyboard* pKeyboard = new BuiltinKeyboard{ Rendering::Kind };
+	BuiltinOsk::pKeyboard = pKeyboard;
+	if (!pKeyboard->Create(hInstance, KeyboardWindowProc, layout)) {
+		// Before the cleanup, which may set another error
+		const DWORD dwError = GetLastError();
+		BuiltinOsk::pKeyboard = nullptr;
+		delete pKeyboard;
+		return dwError != ERROR_SUCCESS ? dwError : ERROR_INVALID_WINDOW_HANDLE;
+	}
+
+	// Restore what the hook would have restored inside osk.exe
+	if (SessionState::Store.IsLoaded()) {
+		const Snapshot::State& state = SessionState::Store.Get();
+		pKeyboard->SetOpacity(state.opacity);
+		if (const Snapshot::Placement* pPlacement = Snapshot::FindPlacement(state, GetMonitorTopologyId())) {
+			SetWindowPos(pKeyboard->GetHandle(), NULL, pPlacement->oskLeft, pPlacement->oskTop, 0, 0,
+				SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+		}
+	}
+	return ERROR_SUCCESS;
+}
+
+// Creates a process to launch the On-Screen Keyboard (OSK) application
+BOOL CreateOSKProcess(STARTUPINFO* pStartupInfo, PROCESS_INFORMATION* pProcessInfo)
+{
+	TCHAR szBuffer[MAX_PATH];
+	pStartupInfo->cb = sizeof(STARTUPINFO);
+	pStartupInfo->dwFlags = STARTF_USESHOWWINDOW;
+	pStartupInfo->wShowWindow = SW_HIDE;
+
+	// Expand path to on-screen keyboard
+	if (!ExpandEnvironmentStrings(Config::OSK::DefaultPath, szBuffer, MAX_PATH)) {
+		return FALSE;
+	}
+
+	// Create OSK Process
+	return CreateProcess(
+		szBuffer,
+		NULL, NULL, NULL,
+		FALSE,
+		NULL, NULL, NULL,
+		pStartupInfo, pProcessInfo);
+}
+
+// Loads a dynamic-link library
+BOOL LoadHookDll(HMODULE* hDll)
+{
+	TCHAR szBuffer[MAX_PATH];
+	if (!GetAppFilePath(Config::OSK::HookModule, szBuffer, MAX_PATH)) { return FALSE; }
+
+	*hDll = LoadLibrary(szBuffer);
+	if (!*hDll) { return FALSE; }
+
+	return TRUE;
+}
+
+// Checks if a module is loaded in another process (FALSE if it cannot be inspected)
+BOOL IsModuleLoaded(DWORD dwProcessId, LPCTSTR pszModule)
+{
+	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, dwProcessId);
+	if (hSnapshot == INVALID_HANDLE_VALUE) { return FALSE; }
+
+	MODULEENTRY32 entry{ sizeof(MODULEENTRY32) };
+	BOOL isFound{};
+	for (BOOL isNext = Module32First(hSnapshot, &entry); isNext and !isFound; isNext = Module32Next(hSnapshot, &entry)) {
+		isFound = _tcsicmp(entry.szModule, pszModule) == 0;
+	}
+
+	CloseHandle(hSnapshot);
+	return isFound;
+}
+
+// Looks for a running OSK and asks its window whether the hook is inside
+OskAttach::Probe ProbeRunningOSK(HWND* phOskWnd)
+{
+	OskAttach::Probe probe{};
+	*phOskWnd = FindWindow(Config::OSK::WindowClass, NULL);
+	if (!*phOskWnd) { return probe; }
+	probe.isWindowFound = true;
+
+	DWORD dwProcessId{};
+	GetWindowThreadProcessId(*phOskWnd, &dwProcessId);
+	probe.isModuleLoaded = IsModuleLoaded(dwProcessId, Config::OSK::HookModule);
+
+	// Only the subclassed window answers; osk.exe itself returns 0
+	DWORD_PTR reply{};
+	probe.isResponding = SendMessageTimeout(*phOskWnd, WM_APP_CUSTOM_MESSAGE,
+		MAKEWPARAM(ID_APP_HOOK_PING, 0), 0, SMTO_ABORTIFHUNG | SMTO_BLOCK,
+		Config::OSK::PingTimeoutMs, &reply) != 0;
+	probe.hookReply = uint32_t(reply);
+
+	return probe;
+}
+
+// Fills the process information of a running OSK as if TabTap had started it
+BOOL OpenOSKProcess(HWND hOskWnd, PROCESS_INFORMATION* pProcessInfo)
+{
+	pProcessInfo->dwThreadId = GetWindowThreadProcessId(hOskWnd, &pProcessInfo->dwProcessId);
+	if (!pProcessInfo->dwThreadId) { return FALSE; }
+
+	pProcessInfo->hProcess = OpenProcess(SYNCHRONIZE, FALSE, pProcessInfo->dwProcessId);
+	return pProcessInfo->hProcess != NULL;
+}
+
+// Closes a running OSK for real and waits until it is gone
+BOOL CloseRunningOSK(HWND hOskWnd, DWORD dwTimeoutMs)
+{
+	DWORD dwProcessId{};
+	GetWindowThreadProcessId(hOskWnd, &dwProcessId);
+	HANDLE hProcess = OpenProcess(SYNCHRONIZE, FALSE, dwProcessId);
+
+	// Posted, so a hung OSK cannot block TabTap
+	PostMessage(hOskWnd, WM_CLOSE, 0, (LPARAM)TRUE);  // lParam forces custom close
+
+	if (hProcess) {
+		const DWORD waitResult = WaitForSingleObject(hProcess, dwTimeoutMs);
+		CloseHandle(hProcess);
+		return waitResult == WAIT_OBJECT_0;
+	}
+
+	// No access to the process; osk.exe is single-instance, so wait for the window
+	for (ULONGLONG deadline = GetTickCount64() + dwTimeoutMs; IsWindow(hOskWnd); ) {
+		if (GetTickCount64() >= deadline) { return FALSE; }
+		Sleep(50);
+	}
+	return TRUE;
+}
+
+// Starts and hooks a new OSK after the old one exited; the hook puts it at
+// its last position and opacity from TabTap.state. Runs in the thread pool
+// (it waits up to 6 s) and returns the process id, or 0 on failure.
+DWORD LaunchHookedOSK()
+{
+	HMODULE hDll{};
+	if (!LoadHookDll(&hDll)) {
+		LOG_WARNING(AppLog::Logger, "Failed to load the DLL: {}", GetLastError());
+		return 0;
+	}
+
+	typedef BOOL(*UninstallHookFunc)();
+	typedef BOOL(*InstallHookFunc)(DWORD);
+
+	UninstallHookFunc UninstallHook = (UninstallHookFunc)GetProcAddress(hDll, "UninstallHook");
+	InstallHookFunc InstallHook = (InstallHookFunc)GetProcAddress(hDll, "InstallHook");
+
+	STARTUPINFO startupInfo{};
+	PROCESS_INFORMATION processInfo{};
+	HANDLE hEvent{};
+	BOOL isHooked{};
+
+	// Same sequence as the cold start in WinMain, without the error dialogs
+	if (UninstallHook and InstallHook and CreateOSKProcess(&startupInfo, &processInfo) and
+		processInfo.hProcess and WaitForInputIdle(processInfo.hProcess, 3000) == 0 and
+		(hEvent = CreateEvent(NULL, TRUE, FALSE, _T("OSKLoadEvent")))) {
+		if (InstallHook(processInfo.dwThreadId)) {
+			isHooked = WaitForSingleObject(hEvent, 3000) == WAIT_OBJECT_0;
+			UninstallHook();
+		}
+	}
+
+	if (!isHooked) {
+		LOG_WARNING(AppLog::Logger, "Failed to restart the OSK: {}", GetLastError());
+		// An unhooked OSK would block the next attempt (osk.exe is single-instance)
+		if (processInfo.hProcess) { TerminateProcess(processInfo.hProcess, ERROR_CANCELLED); }
+	}
+
+	if (hEvent) { CloseHandle(hEvent); }
+	if (processInfo.hProcess) { CloseHandle(processInfo.hProcess); }
+	if (processInfo.hThread) { CloseHandle(processInfo.hThread); }
+	FreeLibrary(hDll);
+
+	return isHooked ? processInfo.dwProcessId : 0;
+}
+
+// Takes over the OSK a restart brought up; false if it is not usable
+bool AdoptRestartedOSK(HWND hWnd, DWORD dwProcessId)
+{
+	HWND hOskWnd{};
+	if (!dwProcessId or !(hOskWnd = FindWindow(Config::OSK::WindowClass, NULL))) { return false; }
+
+	// LaunchHookedOSK closed its handles; the exited process's handle is stale
+	HANDLE hProcess = OpenProcess(SYNCHRONIZE, FALSE, dwProcessId);
+	if (!hProcess) { return false; }
+	if (OskProcess::hProcess) { CloseHandle(OskProcess::hProcess); }
+	OskProcess::hProcess = hProcess;
+
+	OSKWindow::SetHandle(hOskWnd);
+	PostMessage(hOskWnd, WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_RECONNECT, 0), (LPARAM)hWnd);
+	return true;
+}
+
+// Arms the OSK restart timer, or logs that the OSK stays down (a tap on the
+// tab or the tray icon asks for it again)
+void ScheduleOskRestart(const Supervision::Decision& decision)
+{
+	if (decision.verdict == Supervision::Verdict::GiveUp) {
+		LOG_ERROR(AppLog::Logger, "The OSK keeps exiting; stopped restarting it after {} attempts", decision.attempt);
+		return;
+	}
+
+	LOG_INFO(AppLog::Logger, "Restarting the OSK in {} ms (attempt {})", decision.delayMs, decision.attempt);
+	Scheduling::Timers.Set(IDT_OSK_RESTART, UINT(decision.delayMs), UINT(decision.delayMs / 10), false);
+}
+
+
+
+// Window procedure
+LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg,
+	WPARAM wParam, LPARAM lParam)
+{
+	static MouseTracker mouseTracker{ hWnd };
+	static DragPredictor dragPredictor{};
+	static DrawContext* pDrawContext{};
+	static TrayManager* pTray;
+	static PowerMonitor* pPower{};
+	static FullscreenMonitor* pFullscreen{};
+	static ProcessSupervisor* pSupervisor{};
+	static HandleMonitor* pHandles{};
+	static CaretTracker* pCaret{};
+
+	Replay::NestingGuard nesting{};
+	Tracing::Channel.Append(Trace::Source::TabTap, uMsg, wParam, lParam);
+	if (Recording::Session.IsOpen()) {
+		RecordReplayEvent(uMsg, wParam, lParam);
+	}
+
+	switch (uMsg)
+	{
+
+	case WM_TIMER:
+	{
+		if (wParam == IDT_KEEP_ON_TOP) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_KEEP_ON_TOP);
+			pPower->RecordWakeup();
+			MainWindow::EnforceTopmost();
+			return 0;
+		}
+
+		if (wParam == IDT_EFFECT_TIMER) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_EFFECT_TIMER);
+			pPower->RecordWakeup();
+			if (pDrawContext->Effector()->Update()) {
+				pDrawContext->DrawImageOnLayeredWindow();
+			}
+			return 0;
+		}
+
+		if (wParam == IDT_ANIMATION_TIMER) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_ANIMATION_TIMER);
+			pPower->RecordWakeup();
+			bool bContinue = pDrawContext->Animator()->Update();
+			if (!bContinue) {  // Destination reached
+				Scheduling::Timers.Kill(IDT_ANIMATION_TIMER);
+				MainWindow::UpdateWndRect();
+				pPower->EndActivity(Power::Activity::Animation);
+				ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+				RememberSessionState();
+			}
+			return 0;
+		}
+
+		if (wParam == IDT_LONG_PRESS) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_LONG_PRESS);
+			ApplyGesture(hWnd, pDrawContext, pPower, pTray, Touch::Gestures.OnTimer(GetTickCount()));
+			return 0;
+		}
+
+		if (wParam == IDT_POWER_REPORT) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_POWER_REPORT);
+			LogUsageReport(pPower);
+			return 0;
+		}
+
+		if (wParam == IDT_SETTINGS_SETTLE) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_SETTINGS_SETTLE);
+			ApplySettingChanges(hWnd, pDrawContext, pPower);
+			return 0;
+		}
+
+		if (wParam == IDT_CARET_FRAME) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_CARET_FRAME);
+			FollowCaret(hWnd, pDrawContext, pPower, pCaret);
+			return 0;
+		}
+
+		if (wParam == IDT_HANDLE_SAMPLE) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_HANDLE_SAMPLE);
+			SampleHandles(hWnd, pHandles);
+			return 0;
+		}
+
+		if (wParam == IDT_OSK_RESTART) {
+			PROFILE_WNDPROC(WM_TIMER, IDT_OSK_RESTART);
+			// The hook reads the placement from the file
+			SessionState::Store.Flush();
+			// Launch and hook off the UI thread; ID_APP_OSK_RESTARTED brings the result
+			if (!pSupervisor->BeginRestart(LaunchHookedOSK)) {
+				LOG_WARNING(AppLog::Logger, "Failed to start the OSK restart: {}", GetLastError());
+				ScheduleOskRestart(pSupervisor->OnRestartFailed());
+			}
+			return 0;
+		}
+
+		break;
+	}
+
+	case WM_SETCURSOR:
+	{
+		PROFILE_WNDPROC(WM_SETCURSOR, 0);
+		SetCursor(LoadCursor(NULL, IDC_ARROW));
+		break;
+	}
+
+	case WM_MOUSEACTIVATE:
+	{
+		PROFILE_WNDPROC(WM_MOUSEACTIVATE, 0);
+		return MA_NOACTIVATE; // Prevent window activation on mouse click
+	}
+
+	case WM_MOUSEMOVE:
+	{
+		PROFILE_WNDPROC(WM_MOUSEMOVE, 0);
+		auto DragCallback = [&hWnd](const POINT& pt, nullptr_t) {
+			// Place the tab where the cursor will be when the frame is shown
+			const POINT lead = dragPredictor.GetOffset();
+			return MainWindow::SetDragPosition({ pt.x + lead.x, pt.y + lead.y });
+			};
+		
+		if (!pDrawContext->Dragger()->OnMouseMove(DragCallback, nullptr) and 
+			!pDrawContext->Snapper()->OnMouseMove() and
+			MainWindow::IsExpansionState(MainWindow::ExpansionState::Collapsed)
+			) {
+			MainWindow::ToggleExpansionState();
+			// The collapsed tab is too narrow for the code; catch switches made meanwhile
+			pDrawContext->Indicator()->SetLayout(GetForegroundLayout());
+			pDrawContext->DrawImageOnLayeredWindow();
+		}
+
+		mouseTracker.OnMouseMove();
+
+		break;
+	}
+
+	case WM_MOUSEWHEEL:
+	{
+		PROFILE_WNDPROC(WM_MOUSEWHEEL, 0);
+		int delta = GET_WHEEL_DELTA_WPARAM(wParam);
+		PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
+			MAKEWPARAM(ID_APP_FADE, delta > 0),
+			0
+		);
+		Telemetry::HookCommands.Add();
+
+		break;
+	}
+
+	case WM_LBUTTONDOWN:
+	{
+		PROFILE_WNDPROC(WM_LBUTTONDOWN, 0);
+		// Update work area to avoid taskbar during drag
+		WorkAreaManager::Refresh();
+
+		pDrawContext->Snapper()->Enable(new MainSnapAdapter{});
+		SetCapture(hWnd);
+
+		pPower->BeginActivity(Power::Activity::Snap);
+		ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+
+		// Skins provide a pressed frame
+		if (pDrawContext->Skinner()->IsLoaded()) {
+			pDrawContext->DrawImageOnLayeredWindow();
+		}
+
+		return 0;
+	}
+
+	case WM_LBUTTONUP:
+	{
+		PROFILE_WNDPROC(WM_LBUTTONUP, 0);
+		pPower->EndActivity(Power::Activity::Snap);
+		ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+
+		if (pDrawContext->Snapper()->IsEnabled()) {
+			ReleaseCapture();
+			bool isPreview = pDrawContext->Snapper()->IsPreviewEnabled();
+			pDrawContext->Snapper()->Disable();
+
+			if (isPreview) {
+				pDrawContext->DrawImageOnLayeredWindow();
+				return 0;
+			}
+
+			// Leave the pressed frame
+			if (pDrawContext->Skinner()->IsLoaded()) {
+				pDrawContext->DrawImageOnLayeredWindow();
+			}
+		}
+
+		HWND hOskWnd = OSKWindow::GetHandle();
+#ifndef _DEBUG
+		if (!hOskWnd and !BuiltinOsk::pKeyboard) {
+			// The OSK is down: a pending restart brings it back; after a give-up the tap asks again
+			if (!pSupervisor->IsRecovering() and !pSupervisor->IsRestarting()) {
+				LOG_INFO(AppLog::Logger, "Restarting the OSK on request");
+				ScheduleOskRestart(pSupervisor->Retry());
+			}
+			break;
+		}
+#endif
+
+		const bool isVisible = IsWindowVisible(hOskWnd);
+		if (isVisible) {
+			PostMessage(hOskWnd, WM_CLOSE, 0, 0);
+			pCaret->Stop();
+		}
+		else {
+			SyncOskPositionWithMain();
+			ShowWindowAsync(hOskWnd, SW_RESTORE); // Restore OSK
+			pCaret->Start();
+		}
+		// A keyboard opened by hand stays; one closed by hand stays closed for this field
+		FocusTracking::Watcher.OnUserToggle(!isVisible);
+		RememberSessionState();
+		break;
+	}
+
+	case WM_RBUTTONDOWN:
+	{
+		PROFILE_WNDPROC(WM_RBUTTONDOWN, 0);
+		// Update work area to avoid taskbar during drag
+		WorkAreaManager::Refresh();
+
+		// Start drag operation
+		pDrawContext->Dragger()->Enable(hWnd);
+		dragPredictor.Enable();
+		pPower->BeginActivity(Power::Activity::Drag);
+		ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+
+		// Skins provide a dragging frame
+		if (pDrawContext->Skinner()->IsLoaded()) {
+			pDrawContext->DrawImageOnLayeredWindow();
+		}
+
+		break;
+	}
+
+	case WM_RBUTTONUP:
+	{
+		PROFILE_WNDPROC(WM_RBUTTONUP, 0);
+		// Stop drag operation
+		pDrawContext->Dragger()->Disable();
+		dragPredictor.Disable();
+		ReleaseCapture();
+		pPower->EndActivity(Power::Activity::Drag);
+		ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+		RememberSessionState();
+
+#ifdef _DEBUG
+		// Report batched window moves for the finished drag
+		GroupLayout::MoveCounter stats = MainWindow::TakeMoveStats();
+		if (stats.GetFrameCount()) {
+			TCHAR szBuffer[128];
+			_stprintf_s(szBuffer, _T("Drag: %llu frames, %llu moves, %.2f moves/frame, max %u" EOL_),
+				stats.GetFrameCount(), stats.GetMoveCount(),
+				stats.GetMovesPerFrame(), stats.GetMaxMovesPerFrame());
+			OutputDebugString(szBuffer);
+		}
+#endif // _DEBUG
+
+		if (pDrawContext->Skinner()->IsLoaded()) {
+			pDrawContext->DrawImageOnLayeredWindow();
+		}
+
+		break;
+	}
+
+	case WM_RBUTTONDBLCLK:
+	{
+		PROFILE_WNDPROC(WM_RBUTTONDBLCLK, 0);
+		if (IsWindowVisible(OSKWindow::GetHandle())) {
+			// Start the animation loop
+			PostMessage(
+				hWnd,
+				WM_APP_CUSTOM_MESSAGE,
+				MAKEWPARAM(ID_APP_SYNC_Y_POSITION, 0),
+				(LPARAM)hWnd
+			);
+		}
+		break;
+	}
+
+	case WM_MBUTTONDOWN:
+	{
+		PROFILE_WNDPROC(WM_MBUTTONDOWN, 0);
+		break;
+	}
+
+	case WM_MBUTTONUP:
+	{
+		PROFILE_WNDPROC(WM_MBUTTONUP, 0);
+		SendMessage(hWnd, WM_LBUTTONUP, wParam, lParam);
+		break;
+	}
+
+	case WM_MOUSELEAVE:
+	{
+		PROFILE_WNDPROC(WM_MOUSELEAVE, 0);
+		mouseTracker.OnMouseLeave();
+
+		if (!pDrawContext->Dragger()->IsEnabled() and !pDrawContext->Snapper()->IsEnabled())
+		{
+			if (MainWindow::IsExpansionState(MainWindow::ExpansionState::Expanded)) {
+				MainWindow::SetExpansionState(MainWindow::ExpansionState::Collapsed);
+
+				pDrawContext->DrawImageOnLayeredWindow();
+			}
+		}
+		break;
+	}
+
+	case WM_POINTERACTIVATE:
+	{
+		PROFILE_WNDPROC(WM_POINTERACTIVATE, 0);
+		return PA_NOACTIVATE; // Prevent window activation on touch
+	}
+
+	// Touch and pen go straight to the gesture recognizer; handling them here
+	// suppresses the delayed mouse emulation. Mouse pointers fall through.
+	case WM_POINTERDOWN:
+	{
+		PROFILE_WNDPROC(WM_POINTERDOWN, 0);
+		if (OnTabPointer(hWnd, pDrawContext, pPower, pTray, Gestures::PointerPhase::Down, wParam)) { return 0; }
+		break;
+	}
+
+	case WM_POINTERUPDATE:
+	{
+		PROFILE_WNDPROC(WM_POINTERUPDATE, 0);
+		if (OnTabPointer(hWnd, pDrawContext, pPower, pTray, Gestures::PointerPhase::Update, wParam)) { return 0; }
+		break;
+	}
+
+	case WM_POINTERUP:
+	{
+		PROFILE_WNDPROC(WM_POINTERUP, 0);
+		if (OnTabPointer(hWnd, pDrawContext, pPower, pTray, Gestures::PointerPhase::Up, wParam)) { return 0; }
+		break;
+	}
+
+	case WM_POINTERCAPTURECHANGED:
+	{
+		PROFILE_WNDPROC(WM_POINTERCAPTURECHANGED, 0);
+		OnTabPointer(hWnd, pDrawContext, pPower, pTray, Gestures::PointerPhase::Cancel, wParam);
+		break;
+	}
+
+	case WM_APP_TRAYICON:
+	{
+		PROFILE_WNDPROC(WM_APP_TRAYICON, 0);
+		if (lParam == WM_LBUTTONUP) {
+			SendMessage(hWnd, WM_LBUTTONUP, 0, 0);
+		}
+		else if (lParam == WM_RBUTTONUP) {
+			pTray->HandleTrayRightClick();
+		}
+
+		break;
+	}
+
+	case WM_COMMAND:
+	{
+		WORD wNotificationCode = HIWORD(wParam);
+		WORD wCommandId = LOWORD(wParam);
+
+		if (wNotificationCode == 0) {  // Menu/accelerator
+			if (wCommandId == IDM_TRAY_DOCKMODE) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_DOCKMODE);
+				DWORD dwResult = OSKWindow::ToggleDockMode();
+				if (dwResult != ERROR_SUCCESS) {
+					LOG_ERROR(AppLog::Logger, "Failed to queue OSK registry write: {}", dwResult);
+					MessageBoxNotifier{
+						{ _T("System Error") },
+						{ _T("Failed to queue OSK registry write." EOL_ "%lu"), dwResult }
+					}.ShowError(hWnd);
+					return 1;
+				}
+				RememberSessionState();
+			}
+
+			else if (wCommandId == IDM_TRAY_AUTOSTART) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_AUTOSTART);
+				DWORD dwResult = MainWindow::Registry::ToggleAutostartValue();
+				if (dwResult != ERROR_SUCCESS) {
+					MessageBoxNotifier{
+						{ _T("Registry Error") },
+						{ _T("Failed to get Main registry data." EOL_ "%lu"), dwResult }
+					}.ShowError(hWnd);
+					return 1;
+				}
+			}
+
+			else if (wCommandId == IDM_TRAY_LINKEDDRAG) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_LINKEDDRAG);
+				bool isLinkedDrag{};
+				DWORD dwResult = MainWindow::Registry::ToggleLinkedDragValue(&isLinkedDrag);
+				if (dwResult != ERROR_SUCCESS) {
+					MessageBoxNotifier{
+						{ _T("Registry Error") },
+						{ _T("Failed to get Main registry data." EOL_ "%lu"), dwResult }
+					}.ShowError(hWnd);
+					return 1;
+				}
+				MainWindow::SetLinkedDrag(isLinkedDrag);
+			}
+
+			else if (wCommandId == IDM_TRAY_TRACE) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_TRACE);
+				bool isTraceEnabled{};
+				DWORD dwResult = MainWindow::Registry::ToggleTraceValue(&isTraceEnabled);
+				if (dwResult != ERROR_SUCCESS) {
+					MessageBoxNotifier{
+						{ _T("Registry Error") },
+						{ _T("Failed to get Main registry data." EOL_ "%lu"), dwResult }
+					}.ShowError(hWnd);
+					return 1;
+				}
+				SetTraceRecording(isTraceEnabled);
+			}
+
+			else if (wCommandId == IDM_TRAY_AUTOSHOW) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_AUTOSHOW);
+				bool isAutoShow{};
+				DWORD dwResult = MainWindow::Registry::ToggleAutoShowValue(&isAutoShow);
+				if (dwResult != ERROR_SUCCESS) {
+					MessageBoxNotifier{
+						{ _T("Registry Error") },
+						{ _T("Failed to get Main registry data." EOL_ "%lu"), dwResult }
+					}.ShowError(hWnd);
+					return 1;
+				}
+				SetAutoShow(hWnd, isAutoShow);
+			}
+
+#ifdef TABTAP_PROFILE
+			else if (wCommandId == IDM_TRAY_PROFILE_DUMP) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_PROFILE_DUMP);
+				OutputDebugStringA(Profile::Table.Format("TabTap WindowProc").c_str());
+
+				// The hook dumps its own table inside osk.exe
+				PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE,
+					MAKEWPARAM(ID_APP_PROFILE_DUMP, 0), 0);
+			}
+#endif // TABTAP_PROFILE
+
+			else if (wCommandId == IDM_TRAY_EXIT) {
+				PROFILE_WNDPROC(WM_COMMAND, IDM_TRAY_EXIT);
+				PostMessage(hWnd, WM_CLOSE, 0, 0);
+			}
+		}
+
+		else if (wNotificationCode == 1) {}  // Accelerator (rarely used explicitly)
+
+		else {}  // Control notification
+
+		break;
+	}
+
+	case WM_APP_CUSTOM_MESSAGE:
+	{
+		WORD wCommandId = LOWORD(wParam);
+
+		if (wCommandId == ID_APP_SYNC_Y_POSITION) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_SYNC_Y_POSITION);
+			OSKWindow::UpdateWndRect();
+
+			const SIZE& mainSize = MainWindow::GetSize();
+			const LONG clampedY = TabLayout::SyncTop(
+				ToGeometry(OSKWindow::GetRect()),
+				mainSize.cy,
+				ToGeometry(WorkAreaManager::GetWorkArea()));
+
+			POINT ptCursor;
+			GetCursorPos(&ptCursor);
+
+			// Collapse the main window if the cursor moves away
+			if (ptCursor.y < clampedY or
+				ptCursor.y > clampedY + mainSize.cy)
+			{
+				SendMessage(hWnd, WM_MOUSELEAVE, 0, 0);
+			}
+
+			const POINT ptTarget{
+				MainWindow::GetRect().left,  // No changes
+				clampedY
+			};
+
+			// Animating unseen is wasted work; jump straight to the target instead
+			if (!pPower->GetDecision().allowPeriodic) {
+				MainWindow::SetPosition(ptTarget);
+				return 0;
+			}
+
+			// Start animation with reference to target window position
+			pDrawContext->Animator()->Enable(
+				MainWindow::GetHandle(), ptTarget);
+
+			if (pDrawContext->Animator()->IsEnabled()) {
+				pPower->BeginActivity(Power::Activity::Animation);
+				ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+				Scheduling::Timers.Set(IDT_ANIMATION_TIMER, TabLayout::AnimationFrameMs, 0, true);
+			}
+
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_SKIN_RELOADED) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_SKIN_RELOADED);
+			// New image frame was published by the reloader thread
+			pDrawContext->DrawImageOnLayeredWindow();
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_SETTINGS_ERROR) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_SETTINGS_ERROR);
+			// Background registry write failed (lParam is the error code)
+			LOG_ERROR(AppLog::Logger, "Failed to set OSK registry data: {}", (DWORD)lParam);
+			MessageBoxNotifier{
+				{ _T("Registry Error") },
+				{ _T("Failed to set OSK registry data." EOL_ "%lu"), (DWORD)lParam }
+			}.ShowError(hWnd);
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_LAYOUT_CHANGED) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_LAYOUT_CHANGED);
+			// The hook switched layouts on a wheel turn (lParam is the new layout)
+			if (pDrawContext->Indicator()->SetLayout((HKL)lParam) and IsWindowVisible(hWnd)) {
+				pDrawContext->DrawImageOnLayeredWindow();
+			}
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_AUTO_SHOW) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_AUTO_SHOW);
+			// Focus settled on a text field (HIWORD 1) or left text (HIWORD 0)
+			HWND hOskWnd = OSKWindow::GetHandle();
+			if (!hOskWnd or pFullscreen->IsActive()) { return 0; }
+
+			const bool isShow = HIWORD(wParam) != 0;
+			if (isShow and !IsWindowVisible(hOskWnd)) {
+				SyncOskPositionWithMain();
+				ShowWindowAsync(hOskWnd, SW_RESTORE);
+				pCaret->Start();
+			}
+			else if (!isShow and IsWindowVisible(hOskWnd)) {
+				PostMessage(hOskWnd, WM_CLOSE, 0, 0);
+				pCaret->Stop();
+			}
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_CARET_MOVED) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_CARET_MOVED);
+			// The caret moved or focus changed; read it on the next frame
+			Scheduling::Timers.Set(IDT_CARET_FRAME, pCaret->GetDelay(TimerScheduler::GetTimeMs()), 0, false);
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_OSK_EXITED) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_OSK_EXITED);
+			// Posted from the thread pool (lParam is the exit code)
+			LOG_WARNING(AppLog::Logger, "OSK process exited unexpectedly: {}", (DWORD)lParam);
+			OSKWindow::SetHandle(NULL);
+			ScheduleOskRestart(pSupervisor->OnExited());
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_OSK_RESTARTED) {
+			PROFILE_WNDPROC(WM_APP_CUSTOM_MESSAGE, ID_APP_OSK_RESTARTED);
+			// Posted from the thread pool (lParam is the process id, 0 on failure)
+			const DWORD dwProcessId = (DWORD)lParam;
+			uint64_t recoveryMs{};
+			if (AdoptRestartedOSK(hWnd, dwProcessId) and pSupervisor->Watch(dwProcessId, &recoveryMs)) {
+				LOG_INFO(AppLog::Logger, "OSK process {} recovered in {} ms", dwProcessId, recoveryMs);
+				FocusTracking::Watcher.SetKeyboardProcess(dwProcessId);
+			}
+			else {
+				ScheduleOskRestart(pSupervisor->OnRestartFailed());
+			}
+			return 0;
+		}
+
+		return 1;
+	}
+
+	case WM_CREATE:
+	{
+		PROFILE_WNDPROC(WM_CREATE, 0);
+		// Store the main window handle
+		MainWindow::SetHandle(hWnd);
+
+		// Timers set from here on arrive as WM_TIMER
+		if (!Scheduling::Timers.Attach(hWnd)) {
+			LOG_ERROR(AppLog::Logger, "Failed to create the scheduler timer: {}", GetLastError());
+		}
+
+		// Long press is a gesture here, not an emulated right click
+		BOOL isFeedbackEnabled = FALSE;
+		SetWindowFeedbackSetting(hWnd, FEEDBACK_TOUCH_PRESSANDHOLD, 0, sizeof(isFeedbackEnabled), &isFeedbackEnabled);
+		SetWindowFeedbackSetting(hWnd, FEEDBACK_TOUCH_RIGHTTAP, 0, sizeof(isFeedbackEnabled), &isFeedbackEnabled);
+
+		// Update window position
+		MainWindow::UpdateWndRect();
+
+		// Create the drawing context
+		pDrawContext = new DrawContext{ hWnd, Rendering::Kind };
+		
+		Result result = pDrawContext->GetResult();
+		if (!result) {
+			LOG_ERROR(AppLog::Logger, "{}: {} ({})", result.header, result.message, result.errorValue);
+			MessageBoxNotifier{
+				{ result.header },
+				{ _T("%s" EOL_ "%lu"), result.message, result.errorValue }
+			}.ShowError(hWnd);
+			return -1;
+		}
+
+		// Store the drawing context in window user data
+		SetWindowLongPtr(hWnd, GWLP_USERDATA, (LONG_PTR)pDrawContext);
+		pDrawContext->RegisterMetrics(Telemetry::Channel.GetRegistry());
+		pDrawContext->Indicator()->SetLayout(GetForegroundLayout());
+
+		// Create the tray icon manager
+		pTray = new TrayManager(new TraySetupAdapter{});
+
+		result = pTray->GetResult();
+		if (!result) {
+			LOG_ERROR(AppLog::Logger, "{}: {} ({})", result.header, result.message, result.errorValue);
+			MessageBoxNotifier{
+				{ result.header },
+				{ _T("%s" EOL_ "%lu"), result.message, result.errorValue }
+			}.ShowError(hWnd);
+			return -1;
+		}
+
+		pTray->RegisterMetrics(Telemetry::Channel.GetRegistry());
+
+		// Restore linked drag preference (off if unavailable)
+		bool isLinkedDrag{};
+		if (MainWindow::Registry::GetLinkedDragValue(&isLinkedDrag) == ERROR_SUCCESS) {
+			MainWindow::SetLinkedDrag(isLinkedDrag);
+		}
+
+		// Cache the OSK dock state (toggles never read the registry)
+		if (SessionState::Store.IsLoaded()) {
+			OSKWindow::SeedDockMode(SessionState::Store.Get().isDockMode != 0);
+		}
+		else {
+			OSKWindow::LoadDockMode();
+		}
+
+		// The built-in keyboard draws the dock state osk.exe would have kept
+		if (BuiltinOsk::pKeyboard) {
+			BuiltinOsk::pKeyboard->SetDockMode(OSKWindow::IsDockMode());
+			BuiltinOsk::pKeyboard->RegisterMetrics(Telemetry::Channel.GetRegistry());
+		}
+
+		// Resume trace recording if it was left on
+		bool isTraceEnabled{};
+		if (MainWindow::Registry::GetTraceValue(&isTraceEnabled) == ERROR_SUCCESS) {
+			SetTraceRecording(isTraceEnabled);
+		}
+
+		// Track display, power and session state; starts the topmost timer
+		pPower = new PowerMonitor{ hWnd };
+		ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+
+		// Hourly wakeup and CPU usage report
+		Scheduling::Timers.Set(IDT_POWER_REPORT, PowerReportMs, PowerReportToleranceMs, true);
+
+		// Apply system theme
+		if (!ThemeManager::FollowSystemTheme(hWnd)) {
+			MessageBoxNotifier{
+				{ _T("Theme Error") },
+				{ _T("Failed to apply system theme." EOL_ "%lu"), GetLastError() }
+			}.ShowWarning(hWnd);
+		}
+
+		// Explicitly show the window
+		ShowWindow(hWnd, SW_SHOW);
+		// Draw content on the layered window
+		pDrawContext->DrawImageOnLayeredWindow();
+
+		// Hide at once if started over a fullscreen app
+		pFullscreen = new FullscreenMonitor{ hWnd, WM_APP_APPBAR };
+		if (pFullscreen->Refresh()) {
+			pPower->SetFullscreen(pFullscreen->IsActive());
+			ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+		}
+
+		if (Recording::IsRequested) {
+			StartReplayRecording(pDrawContext);
+		}
+
+		// Notice when osk.exe dies and bring it back (no OSK in debug builds, none to watch when built in)
+		pSupervisor = new ProcessSupervisor{ hWnd, WM_APP_CUSTOM_MESSAGE,
+			MAKEWPARAM(ID_APP_OSK_EXITED, 0), MAKEWPARAM(ID_APP_OSK_RESTARTED, 0) };
+		pSupervisor->RegisterMetrics(Telemetry::Channel.GetRegistry());
+		if (HWND hOskWnd = BuiltinOsk::pKeyboard ? NULL : OSKWindow::GetHandle()) {
+			DWORD dwProcessId{};
+			GetWindowThreadProcessId(hOskWnd, &dwProcessId);
+			if (!pSupervisor->Watch(dwProcessId)) {
+				LOG_WARNING(AppLog::Logger, "Failed to supervise the OSK process: {}", GetLastError());
+			}
+		}
+
+		// Show the OSK for focused text fields if enabled
+		FocusTracking::Watcher.RegisterMetrics(Telemetry::Channel.GetRegistry());
+		bool isAutoShow{};
+		if (MainWindow::Registry::GetAutoShowValue(&isAutoShow) == ERROR_SUCCESS) {
+			SetAutoShow(hWnd, isAutoShow);
+		}
+
+		// Keep the OSK clear of the caret while it is up
+		pCaret = new CaretTracker{ hWnd, WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_CARET_MOVED, 0) };
+		pCaret->RegisterMetrics(Telemetry::Channel.GetRegistry());
+		if (IsWindowVisible(OSKWindow::GetHandle())) { pCaret->Start(); }
+
+		// Watch the GDI and USER object counts; the first sample is the trend's start
+		pHandles = Soak::IsRequested
+			? new HandleMonitor{ {}, true, SoakWarmupMs, SoakBudgetSlack }
+			: new HandleMonitor{ {}, false };
+		pHandles->RegisterMetrics(Telemetry::Channel.GetRegistry());
+		pHandles->Sample(TimerScheduler::GetTimeMs());
+		Scheduling::Timers.Set(IDT_HANDLE_SAMPLE,
+			Soak::IsRequested ? SoakSampleMs : HandleSampleMs,
+			Soak::IsRequested ? SoakSampleMs / 10 : HandleSampleMs / 6, true);
+
+		return 0;
+	}
+
+	case WM_DESTROY:
+	{
+		PROFILE_WNDPROC(WM_DESTROY, 0);
+		// This exit is intended; no restart
+		delete pSupervisor;
+		pSupervisor = nullptr;
+
+		// No more focus decisions or caret updates
+		SetAutoShow(hWnd, false);
+		delete pCaret;
+		pCaret = nullptr;
+
+		// Move then Close OSK to store position correctly (where the tab puts it, not the caret)
+		ShowWindow(OSKWindow::GetHandle(), SW_HIDE);
+		SyncOskPositionWithMain(false);
+		RememberSessionState();
+		PostMessage(OSKWindow::GetHandle(), WM_CLOSE, 0, (LPARAM)TRUE);
+
+		// Kill timers
+		Scheduling::Timers.Detach();
+
+		// Unregister the app bar and the foreground hook
+		delete pFullscreen;
+		pFullscreen = nullptr;
+
+		// Report usage since the last hourly report
+		if (pPower) {
+			LogUsageReport(pPower);
+			delete pPower;
+			pPower = nullptr;
+		}
+
+		// Clean up tray manager object
+		delete pTray;
+
+		// Flush the trace file and the replay session
+		SetTraceRecording(false);
+		Recording::Session.Close();
+
+		// Finish pending dock state and session snapshot writes
+		OSKWindow::FlushDockMode();
+		SessionState::Store.Flush();
+
+		// Clean up drawing context object
+		delete pDrawContext;
+
+		delete pHandles;
+		pHandles = nullptr;
+
+		PostQuitMessage(Soak::ExitCode);
+		return 0;
+	}
+
+	case WM_SETTINGCHANGE:
+	{
+		PROFILE_WNDPROC(WM_SETTINGCHANGE, 0);
+		// Theme switches, logons and display changes send dozens of these;
+		// the ones the tab reads are merged into one pass after the burst
+		Telemetry::SettingChanges.Add();
+		const uint64_t nowMs = TimerScheduler::GetTimeMs();
+		const uint8_t changes = Settings::Classify(uint32_t(wParam), reinterpret_cast<LPCWSTR>(lParam));
+		if (SettingChanges::Pending.Add(changes, nowMs)) {
+			ScheduleSettingPass(nowMs);
+		}
+		else {
+			Telemetry::SettingsIgnored.Add();
+		}
+		break;
+	}
+
+	case WM_APP_APPBAR:
+	{
+		PROFILE_WNDPROC(WM_APP_APPBAR, 0);
+		// A fullscreen app opened or closed, or the foreground window changed
+		if (pFullscreen and pFullscreen->OnNotify(wParam) and pFullscreen->Refresh()) {
+			LOG_INFO(AppLog::Logger, "Fullscreen state: {}",
+				Fullscreen::GetReasonName(pFullscreen->GetReason()));
+			pPower->SetFullscreen(pFullscreen->IsActive());
+			ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+		}
+		return 0;
+	}
+
+	case WM_POWERBROADCAST:
+	{
+		PROFILE_WNDPROC(WM_POWERBROADCAST, 0);
+		// Display state, power source and battery saver changes
+		if (pPower and pPower->OnPowerBroadcast(wParam, lParam)) {
+			ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+		}
+		return TRUE;
+	}
+
+	case WM_WTSSESSION_CHANGE:
+	{
+		PROFILE_WNDPROC(WM_WTSSESSION_CHANGE, 0);
+		// Workstation lock and unlock
+		if (pPower and pPower->OnSessionChange(wParam)) {
+			ApplyPowerPolicy(hWnd, pDrawContext, pPower);
+		}
+		return 0;
+	}
+
+	default: break;
+	}
+
+	return DefWindowProc(hWnd, uMsg, wParam, lParam);
+}
+
+
+
+
+// Main Entry Point
+INT WINAPI WinMain(
+	_In_ HINSTANCE hInstance,
+	_In_opt_ HINSTANCE hPrevInstance,
+	_In_ LPSTR lpCmdLine,
+	_In_ INT nCmdShow)
+{
+	HWND hWnd{};
+
+	// Check if program is already running
+	if (hWnd = FindWindow(Config::MainWindowClass, NULL)) {
+		PostMessage(hWnd, WM_LBUTTONUP, 0, 0);
+		return ERROR_ALREADY_EXISTS;
+	}
+
+#ifdef _DEBUG
+	// Close OSK if open (release builds adopt a running one instead)
+	if (hWnd = FindWindow(Config::OSK::WindowClass, NULL)) {
+		SendMessage(hWnd, WM_CLOSE, 0, (LPARAM)TRUE);  // lParam forces custom close
+	}
+#endif
+
+	// Start the release log next to the executable
+	AppLog::Logger.Start(GetAppFilePath(_T("TabTap.log")));
+	LOG_INFO(AppLog::Logger, "TabTap started, process {}", GetCurrentProcessId());
+
+	// Read the last session state so windows start in their final positions
+	const Snapshot::Status stateStatus =
+		SessionState::Store.Load(GetAppFilePath(_T("TabTap.state")));
+	LOG_INFO(AppLog::Logger, "Session state: {}", Snapshot::GetStatusName(stateStatus));
+
+	// Record tab input for the Replay tool
+	Recording::IsRequested = lpCmdLine and strstr(lpCmdLine, "--record") != nullptr;
+	// Fail on GDI/USER object growth (automated soak runs)
+	Soak::IsRequested = lpCmdLine and strstr(lpCmdLine, "--soak") != nullptr;
+
+	// Pick the renderer; headless shows nothing and is left to the tools
+	if (LPCSTR pszRenderer = lpCmdLine ? strstr(lpCmdLine, "--renderer=") : nullptr) {
+		pszRenderer += strlen("--renderer=");
+		char szName[16]{};
+		for (size_t i{}; i + 1 < std::size(szName) and pszRenderer[i] and pszRenderer[i] != ' '; ++i) {
+			szName[i] = pszRenderer[i];
+		}
+
+		Render::BackendKind kind{};
+		if (Render::ParseBackendName(szName, &kind) and kind != Render::BackendKind::Headless) {
+			Rendering::Kind = kind;
+		}
+	}
+	LOG_INFO(AppLog::Logger, "Renderer: {}", Render::GetBackendName(Rendering::Kind));
+
+	// Draw the keyboard in-process instead of hooking osk.exe
+	BuiltinOsk::IsRequested = lpCmdLine and strstr(lpCmdLine, "--keyboard=builtin") != nullptr;
+	LOG_INFO(AppLog::Logger, "Keyboard: {}", BuiltinOsk::IsRequested ? "builtin" : "osk.exe");
+
+	HMODULE hDll{};
+
+#ifndef _DEBUG
+	if (!LoadHookDll(&hDll)) {
+		const DWORD dwError = GetLastError();
+		LOG_ERROR(AppLog::Logger, "Failed to load the DLL: {}", dwError);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("Failed to load the DLL." EOL_ "%lu"), dwError }
+		}.ShowError(hWnd);
+		return -1;
+	}
+
+	// Function pointer types for the exported functions
+	typedef BOOL(*UninstallHookFunc)();
+	typedef BOOL(*InstallHookFunc)(DWORD);
+
+	UninstallHookFunc UninstallHook = (UninstallHookFunc)GetProcAddress(hDll, "UninstallHook");
+	InstallHookFunc InstallHook = (InstallHookFunc)GetProcAddress(hDll, "InstallHook");
+	InstallHookFunc AdoptHook = (InstallHookFunc)GetProcAddress(hDll, "AdoptHook");  // Optional
+
+	if (!UninstallHook or !InstallHook) {
+		LOG_ERROR(AppLog::Logger, "The specified procedure could not be found: {}", ERROR_PROC_NOT_FOUND);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("The specified procedure could not be found." EOL_ "%lu"), ERROR_PROC_NOT_FOUND }
+		}.ShowError(hWnd);
+		FreeLibrary(hDll);
+		return -1;
+	}
+#endif
+
+	STARTUPINFO startupInfo{};
+	PROCESS_INFORMATION processInfo{};
+	WNDCLASSEX wcex{};
+	HANDLE hEvent{};
+	DWORD waitResult{};
+	HWND hOskWnd{};
+	OskAttach::Planner attach{};
+	OskAttach::Step attachStep{};
+	INT exitCode{};
+
+	// Create the trace ring before the hook looks for it (tracing is optional)
+	Tracing::Channel.Create();
+
+	// Same for the metrics registry; without it every handle records nothing
+	if (Telemetry::Channel.Create()) {
+		Metrics::Registry& registry = Telemetry::Channel.GetRegistry();
+		Telemetry::RegistryReads = registry.AddCounter("tabtap_registry_reads_total", "Registry values read");
+		Telemetry::RegistryWrites = registry.AddCounter("tabtap_registry_writes_total", "Registry values written or removed");
+		Telemetry::RegistryErrors = registry.AddCounter("tabtap_registry_errors_total", "Registry calls that failed");
+		Telemetry::WindowMoves = registry.AddCounter("tabtap_window_moves_total", "Tab and OSK window moves");
+		Telemetry::WindowMoveErrors = registry.AddCounter("tabtap_window_move_errors_total", "Failed SetWindowPos calls");
+		Telemetry::HookCommands = registry.AddCounter("tabtap_hook_commands_posted_total", "Commands posted to the hook");
+		Telemetry::OskAttachTime = registry.AddHistogram("tabtap_osk_attach_ms",
+			"Time to reconnect to or inject into a running OSK", { 10, 25, 50, 100, 250, 500, 1000, 3000 });
+		Telemetry::OskColdStartTime = registry.AddHistogram("tabtap_osk_cold_start_ms",
+			"Time to start and hook a new OSK", { 250, 500, 1000, 1500, 2000, 3000, 4500, 6000 });
+		Telemetry::SettingChanges = registry.AddCounter("tabtap_setting_changes_total", "WM_SETTINGCHANGE notifications received");
+		Telemetry::SettingsIgnored = registry.AddCounter("tabtap_setting_changes_ignored_total", "Setting changes the tab does not depend on");
+		Telemetry::SettingPasses = registry.AddCounter("tabtap_setting_passes_total", "Theme and layout passes run for settled setting bursts");
+
+		Telemetry::Exporter.Start(Telemetry::Channel, GetAppFilePath(_T("TabTap.metrics")));
+	}
+	else {
+		LOG_WARNING(AppLog::Logger, "Failed to create the metrics registry: {}", GetLastError());
+	}
+
+	// The built-in keyboard is its own window; there is no osk.exe to attach to
+	if (BuiltinOsk::IsRequested) {
+		const DWORD dwError = CreateBuiltinKeyboard(hInstance, GetAppFilePath(_T("TabTap.keys")));
+		if (dwError != ERROR_SUCCESS) {
+			LOG_ERROR(AppLog::Logger, "Unable to create the keyboard window: {}", dwError);
+			MessageBoxNotifier{
+				{ _T("System Error") },
+				{ _T("Unable to create the keyboard window." EOL_ "%lu"), dwError }
+			}.ShowError(hWnd);
+			goto CLEANUP;
+		}
+		OSKWindow::SetHandle(BuiltinOsk::pKeyboard->GetHandle());
+		LOG_INFO(AppLog::Logger, "Built-in keyboard ready");
+
+		// The hook is only needed inside osk.exe
+		if (hDll) {
+			FreeLibrary(hDll);
+			hDll = {};
+		}
+		goto KEYBOARD_READY;
+	}
+
+#ifndef _DEBUG
+	// Attach to a running OSK where possible; start a new one otherwise
+	{
+		const OskAttach::Probe probe = ProbeRunningOSK(&hOskWnd);
+		attachStep = attach.Begin(probe, GetTickCount());
+		LOG_INFO(AppLog::Logger, "OSK probe: window {}, responding {}, hook loaded {}, reply {}; {}",
+			probe.isWindowFound, probe.isResponding, probe.isModuleLoaded, probe.hookReply,
+			OskAttach::GetStepName(attachStep));
+	}
+
+	while (!attach.IsFinished()) {
+		bool isSucceeded{};
+
+		switch (attachStep)
+		{
+		case OskAttach::Step::Reconnect:
+		{
+			// The hook is pinned in osk.exe and its windows are subclassed
+			isSucceeded = OpenOSKProcess(hOskWnd, &processInfo);
+			break;
+		}
+
+		case OskAttach::Step::Inject:
+		{
+			if (!AdoptHook or !OpenOSKProcess(hOskWnd, &processInfo)) { break; }
+
+			if (!(hEvent = CreateEvent(NULL, TRUE, FALSE, _T("OSKLoadEvent")))) {
+				LOG_WARNING(AppLog::Logger, "Failed to create event: {}", GetLastError());
+				break;
+			}
+
+			// The hook runs on the next message the OSK thread retrieves
+			if (AdoptHook(processInfo.dwThreadId)) {
+				PostThreadMessage(processInfo.dwThreadId, WM_NULL, 0, 0);
+				isSucceeded = WaitForSingleObject(hEvent, 3000) == WAIT_OBJECT_0;
+				UninstallHook();
+			}
+			CloseHandle(hEvent);
+			hEvent = {};
+
+			if (!isSucceeded) {
+				LOG_WARNING(AppLog::Logger, "Failed to inject into the running OSK: {}", GetLastError());
+				CloseHandle(processInfo.hProcess);
+				processInfo = {};
+			}
+			break;
+		}
+
+		case OskAttach::Step::Close:
+		{
+			if (!CloseRunningOSK(hOskWnd, 3000)) {
+				LOG_ERROR(AppLog::Logger, "Failed to close the running OSK: {}", WAIT_TIMEOUT);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to close the running OSK." EOL_ "%lu"), WAIT_TIMEOUT }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+			isSucceeded = true;
+			break;
+		}
+
+		case OskAttach::Step::Launch:
+		{
+			// Create OSK Process
+			if (!CreateOSKProcess(&startupInfo, &processInfo)) {
+				const DWORD dwError = GetLastError();
+				LOG_ERROR(AppLog::Logger, "Unable to create OSK window: {}", dwError);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Unable to create OSK window." EOL_ "%lu"), dwError }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+			if (!processInfo.hProcess) { goto CLEANUP; } // warnings C6387
+
+			waitResult = WaitForInputIdle(processInfo.hProcess, 3000);
+			if (waitResult == WAIT_TIMEOUT) {
+				LOG_ERROR(AppLog::Logger, "The wait time-out interval elapsed: {}", WAIT_TIMEOUT);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+			if (waitResult == WAIT_FAILED) {
+				LOG_ERROR(AppLog::Logger, "Failed to wait for the process: {}", WAIT_FAILED);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+
+			isSucceeded = true;
+			break;
+		}
+
+		case OskAttach::Step::Hook:
+		{
+			// Hook Inject
+			// ==============================
+
+			// Create a manual-reset event that starts unsignaled
+			if (!(hEvent = CreateEvent(NULL, TRUE, FALSE, _T("OSKLoadEvent")))) {
+				const DWORD dwError = GetLastError();
+				LOG_ERROR(AppLog::Logger, "Failed to create event: {}", dwError);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to create event." EOL_ "%lu"), dwError }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+
+			// Inject hook
+			if (!InstallHook(processInfo.dwThreadId)) {
+				const DWORD dwError = GetLastError();
+				LOG_ERROR(AppLog::Logger, "Failed to install the Windows hook procedure: {}", dwError);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to install the Windows hook procedure." EOL_ "%lu"), dwError }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+
+			// Wait for the event to be signaled
+			waitResult = WaitForSingleObject(hEvent, 3000);
+			if (waitResult == WAIT_TIMEOUT) {
+				LOG_ERROR(AppLog::Logger, "The wait time-out interval elapsed: {}", WAIT_TIMEOUT);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+			if (waitResult == WAIT_FAILED) {
+				LOG_ERROR(AppLog::Logger, "Failed to wait for the process: {}", WAIT_FAILED);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+
+			// CBTHook.dll confirmed successful injection; Safe to close the event
+			if (!CloseHandle(hEvent)) {
+				const DWORD dwError = GetLastError();
+				LOG_ERROR(AppLog::Logger, "Failed to close event: {}", dwError);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to close event." EOL_ "%lu"), dwError }
+				}.ShowError(hWnd);
+				hEvent = {};
+				goto CLEANUP;
+			}
+			hEvent = {};
+
+			// Unload hook
+			if (!UninstallHook()) {
+				LOG_ERROR(AppLog::Logger, "Failed to remove the Windows hook: {}", ERROR_HOOK_NOT_INSTALLED);
+				MessageBoxNotifier{
+					{ _T("System Error") },
+					{ _T("Failed to remove the Windows hook." EOL_ "%lu"), ERROR_HOOK_NOT_INSTALLED }
+				}.ShowError(hWnd);
+				goto CLEANUP;
+			}
+			isSucceeded = true;
+			break;
+		}
+
+		default: break;
+		}
+
+		attachStep = attach.Advance(isSucceeded, GetTickCount());
+	}
+
+	if (attachStep == OskAttach::Step::Failed) {
+		LOG_ERROR(AppLog::Logger, "Unable to attach to the OSK: {}", attach.FormatPath());
+		goto CLEANUP;
+	}
+
+	// Startup-time comparison: attaches land in one histogram, cold starts in the other
+	if (attach.GetMode() == OskAttach::Mode::ColdStarted) {
+		Telemetry::OskColdStartTime.Observe(attach.GetTotalMs());
+	}
+	else {
+		Telemetry::OskAttachTime.Observe(attach.GetTotalMs());
+	}
+	LOG_INFO(AppLog::Logger, "OSK {} in {} ms{} ({})", OskAttach::GetModeName(attach.GetMode()),
+		attach.GetTotalMs(), attach.IsFallback() ? " after a failed attach" : "", attach.FormatPath());
+
+	// Store OSK handle globally
+	if (!(hWnd = FindWindow(Config::OSK::WindowClass, NULL))) {
+		const DWORD dwError = GetLastError();
+		LOG_ERROR(AppLog::Logger, "Failed to find the window: {}", dwError);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("Failed to find the window." EOL_ "%lu"), dwError }
+		}.ShowError(hWnd);
+		goto CLEANUP;
+	}
+
+	OSKWindow::SetHandle(hWnd);
+	LOG_INFO(AppLog::Logger, "OSK process {} hooked", processInfo.dwProcessId);
+
+	// The window procedure swaps it for the new process after a restart
+	OskProcess::hProcess = processInfo.hProcess;
+	processInfo.hProcess = NULL;
+
+	// Unload library
+	FreeLibrary(hDll);
+	hDll = {};
+#endif
+
+KEYBOARD_READY:
+	if (!ThemeManager::EnableThemeSupport()) {
+		const DWORD dwError = GetLastError();
+		LOG_WARNING(AppLog::Logger, "Failed to enable theme support: {}", dwError);
+		MessageBoxNotifier{
+			{ _T("Theme Error") },
+			{ _T("Failed to enable theme support." EOL_ "%lu"), dwError }
+		}.ShowWarning(hWnd);
+	}
+
+	if (!RegisterWindowClass(hInstance, &wcex)) {
+		const DWORD dwError = GetLastError();
+		LOG_ERROR(AppLog::Logger, "Unable to register window class: {}", dwError);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("Unable to register window class." EOL_ "%lu"), dwError }
+		}.ShowError(hWnd);
+		goto CLEANUP;
+	}
+
+	hWnd = CreateLayeredWindow(hInstance);
+	if (!hWnd) {
+		const DWORD dwError = GetLastError();
+		LOG_ERROR(AppLog::Logger, "Unable to create window: {}", dwError);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("Unable to create window." EOL_ "%lu"), dwError }
+		}.ShowError(hWnd);
+		goto CLEANUP;
+	}
+
+#ifndef _DEBUG
+	// Point the hook at this window; an adopted OSK still knows the previous one
+	PostMessage(OSKWindow::GetHandle(), WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_RECONNECT, 0), (LPARAM)hWnd);
+#endif
+
+
+	// One wait serves both input and the timer scheduler
+	for (bool isRunning = true; isRunning; )
+	{
+		HANDLE hTimer = Scheduling::Timers.GetHandle();
+		const DWORD wait = MsgWaitForMultipleObjectsEx(hTimer ? 1 : 0, &hTimer,
+			INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		if (hTimer and wait == WAIT_OBJECT_0) {
+			Scheduling::Timers.Run();
+		}
+
+		MSG msg;
+		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		{
+			if (msg.message == WM_QUIT) {
+				exitCode = (INT)msg.wParam;
+				isRunning = false;
+				break;
+			}
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+
+#ifndef _DEBUG
+	// The built-in keyboard has no process to wait for
+	waitResult = OskProcess::hProcess ? WaitForSingleObject(OskProcess::hProcess, 3000) : WAIT_OBJECT_0;
+	if (waitResult == WAIT_TIMEOUT) {
+		LOG_ERROR(AppLog::Logger, "The wait time-out interval elapsed: {}", WAIT_TIMEOUT);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("The wait time-out interval elapsed." EOL_ "%lu"), WAIT_TIMEOUT }
+		}.ShowError(hWnd);
+		goto CLEANUP;
+	}
+	if (waitResult == WAIT_FAILED) {
+		LOG_ERROR(AppLog::Logger, "Failed to wait for the process: {}", WAIT_FAILED);
+		MessageBoxNotifier{
+			{ _T("System Error") },
+			{ _T("Failed to wait for the process." EOL_ "%lu"), WAIT_FAILED }
+		}.ShowError(hWnd);
+		goto CLEANUP;
+	}
+#endif
+
+CLEANUP:
+	WNDCLASSEX existingWc{ sizeof(WNDCLASSEX) };
+	BOOL isRegistered = GetClassInfoEx(wcex.hInstance, Config::MainWindowClass, &existingWc);
+	if (isRegistered) { UnregisterClass(Config::MainWindowClass, GetModuleHandle(NULL)); }
+	if (hEvent) { CloseHandle(hEvent); }
+	if (hDll) { FreeLibrary(hDll); }
+	if (processInfo.hProcess) { CloseHandle(processInfo.hProcess); }
+	if (processInfo.hThread) { CloseHandle(processInfo.hThread); }
+	if (OskProcess::hProcess) { CloseHandle(OskProcess::hProcess); }
+	OskProcess::hProcess = NULL;
+	delete BuiltinOsk::pKeyboard;
+	BuiltinOsk::pKeyboard = nullptr;
+	ThemeManager::DisableThemeSupport();
+	Telemetry::Exporter.Stop();
+
+	// Write out everything logged so far
+	LOG_INFO(AppLog::Logger, "TabTap exiting with {}", exitCode);
+	AppLog::Logger.Stop();
+
+	return exitCode;
+}
+
+
+
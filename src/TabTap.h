@@ -1,37 +1,58 @@
-#pragma once
-
-// Define end-of-line marker
-#ifndef EOL_
-#define EOL_ "\r\n"
-#endif // EOL_
-
-
-// Custom window message IDs
-#define WM_APP_TRAYICON             (WM_APP + 1)  // Custom tray icon notification message
-#define WM_APP_CUSTOM_MESSAGE       (WM_APP + 2)  // Custom message
-
-
-// Icons, menu items, and control identifiers
-#define IDI_NOTIFY_ICON				(1000 + 1)
-#define IDT_KEEP_ON_TOP             (1000 + 2)
-#define IDT_ANIMATION_TIMER         (1000 + 3)
-#define IDT_BLINK_TIMER             (1000 + 4)
-
-
-// Command identifiers for the notification area context menu
-#define IDM_TRAY_DOCKMODE           (2000 + 1)
-#define IDM_TRAY_AUTOSTART          (2000 + 2)
-#define IDM_TRAY_EXIT               (2000 + 3)
-#define IDM_TRAY_SEPARATOR          (2000 + 4)
-
-
-// Custom command IDs (LOWORD)
-#define ID_APP_ANIMATION            (3000 + 1)
-#define ID_APP_SYNC_Y_POSITION      (3000 + 2)
-#define ID_APP_DIRECTUI_READY       (3000 + 3)
-#define ID_APP_DOCKMODE             (3000 + 4)
-#define ID_APP_REGULARMODE          (3000 + 5)
-#define ID_APP_FADE                 (3000 + 6)
-
-
-
+#pragma once
+
+// Define end-of-line marker
+#ifndef EOL_
+#define EOL_ "\r\n"
+#endif // EOL_
+
+
+// Custom window message IDs
+#define WM_APP_TRAYICON             (WM_APP + 1)  // Custom tray icon notification message
+#define WM_APP_CUSTOM_MESSAGE       (WM_APP + 2)  // Custom message
+#define WM_APP_APPBAR               (WM_APP + 3)  // App bar and foreground notifications
+
+
+// Icons, menu items, and control identifiers
+#define IDI_NOTIFY_ICON				(1000 + 1)
+#define IDT_KEEP_ON_TOP             (1000 + 2)
+#define IDT_ANIMATION_TIMER         (1000 + 3)
+#define IDT_EFFECT_TIMER            (1000 + 4)
+#define IDT_POWER_REPORT            (1000 + 5)
+#define IDT_LONG_PRESS              (1000 + 6)
+#define IDT_OSK_RESTART             (1000 + 7)
+#define IDT_HANDLE_SAMPLE           (1000 + 8)
+#define IDT_SETTINGS_SETTLE         (1000 + 9)
+#define IDT_CARET_FRAME             (1000 + 10)
+
+
+// Command identifiers for the notification area context menu
+#define IDM_TRAY_DOCKMODE           (2000 + 1)
+#define IDM_TRAY_AUTOSTART          (2000 + 2)
+#define IDM_TRAY_EXIT               (2000 + 3)
+#define IDM_TRAY_SEPARATOR          (2000 + 4)
+#define IDM_TRAY_LINKEDDRAG         (2000 + 5)
+#define IDM_TRAY_PROFILE_DUMP       (2000 + 6)
+#define IDM_TRAY_TRACE              (2000 + 7)
+#define IDM_TRAY_AUTOSHOW           (2000 + 8)
+
+
+// Custom command IDs (LOWORD)
+#define ID_APP_ANIMATION            (3000 + 1)
+#define ID_APP_SYNC_Y_POSITION      (3000 + 2)
+#define ID_APP_DIRECTUI_READY       (3000 + 3)
+#define ID_APP_DOCKMODE             (3000 + 4)
+#define ID_APP_REGULARMODE          (3000 + 5)
+#define ID_APP_FADE                 (3000 + 6)
+#define ID_APP_SKIN_RELOADED        (3000 + 7)
+#define ID_APP_PROFILE_DUMP         (3000 + 8)
+#define ID_APP_SETTINGS_ERROR       (3000 + 9)
+#define ID_APP_HOOK_PING            (3000 + 10)
+#define ID_APP_RECONNECT            (3000 + 11)
+#define ID_APP_OSK_EXITED           (3000 + 12)
+#define ID_APP_LAYOUT_CHANGED       (3000 + 13)
+#define ID_APP_AUTO_SHOW            (3000 + 14)
+#define ID_APP_CARET_MOVED          (3000 + 15)
+#define ID_APP_OSK_RESTARTED        (3000 + 16)
+
+
+
@@ -0,0 +1,135 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/TraceRing.h"
+
+// Windows system headers
+#include <windows.h>
+#include <tchar.h>
+
+
+
+// Shared-memory trace ring connecting the hook inside osk.exe with TabTap
+class TraceChannel
+{
+public:
+	static constexpr LPCTSTR MappingName = _T("Local\\TabTapTraceRing");
+	static constexpr uint32_t Capacity = 4096;   // Records (~200 KB)
+
+private:
+	HANDLE hMapping{};           // Named file mapping
+	void* pView{};               // Mapped ring block
+	Trace::Ring ring{};          // Ring view over `pView`
+
+private:
+	bool Map()
+	{
+		pView = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, Trace::RequiredBytes(Capacity));
+		if (!pView) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+public:
+	~TraceChannel() { Close(); }
+	TraceChannel() = default;
+	TraceChannel(const TraceChannel&) = delete;
+	TraceChannel& operator=(const TraceChannel&) = delete;
+
+	// Creates the ring (TabTap, before the OSK is started)
+	bool Create()
+	{
+		if (IsOpen()) { return true; }
+
+		constexpr size_t bytes = Trace::RequiredBytes(Capacity);
+		hMapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+			0, DWORD(bytes), MappingName);
+		if (!hMapping) { return false; }
+
+		const bool isExisting = (GetLastError() == ERROR_ALREADY_EXISTS);
+		if (!Map()) { return false; }
+
+		ring = isExisting ?
+			Trace::Ring::Attach(pView, bytes) :
+			Trace::Ring::Create(pView, bytes, Capacity);  // Fresh mappings are zeroed
+		if (!ring.IsValid()) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	// Opens the ring created by TabTap (hook side); fails quietly if absent
+	bool Open()
+	{
+		if (IsOpen()) { return true; }
+
+		hMapping = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, MappingName);
+		if (!hMapping) { return false; }
+		if (!Map()) { return false; }
+
+		ring = Trace::Ring::Attach(pView, Trace::RequiredBytes(Capacity));
+		if (!ring.IsValid()) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void Close()
+	{
+		ring = {};
+		if (pView) { UnmapViewOfFile(pView); pView = nullptr; }
+		if (hMapping) { CloseHandle(hMapping); hMapping = NULL; }
+	}
+
+	bool IsOpen() const
+	{
+		return ring.IsValid();
+	}
+
+	// Appends one event stamped with the system-wide performance counter
+	// (nothing while no recording is running)
+	void Append(Trace::Source source, UINT message, WPARAM wParam, LPARAM lParam)
+	{
+		if (!ring.IsEnabled()) { return; }
+
+		LARGE_INTEGER counter{};
+		QueryPerformanceCounter(&counter);
+
+		Trace::Record record{};
+		record.time = uint64_t(counter.QuadPart);
+		record.processId = GetCurrentProcessId();
+		record.threadId = GetCurrentThreadId();
+		record.source = uint16_t(source);
+		record.message = message;
+		record.wParam = uint64_t(wParam);
+		record.lParam = uint64_t(lParam);
+		ring.TryAppend(record);
+	}
+
+	// Returns the ring (the consumer drains it)
+	Trace::Ring& GetRing()
+	{
+		return ring;
+	}
+};
+
+
+
+
+/*
+Usage example:
+
+	static TraceChannel traceChannel{};
+
+	// TabTap (before starting the OSK)
+	traceChannel.Create();
+
+	// Hook, once inside osk.exe
+	traceChannel.Open();
+	traceChannel.Append(Trace::Source::OskMain, msg, wParam, lParam);
+
+*/
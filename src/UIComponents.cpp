@@ -1,873 +1,2971 @@
-// Implementation-specific headers
-#include "UIComponents.h"
-#include "Image.h"
-
-// Default headers
-#include <algorithm>
-
-// Windows headers
-#include <Shlwapi.h>
-#include <PathCch.h>
-
-// Library links
-#pragma comment(lib, "gdiplus.lib")
-#pragma comment(lib, "Shlwapi.lib")
-#pragma comment(lib, "Pathcch.lib")
-
-
-
-// --- GDIPlusData ---
-
-Result GDIPlusData::SetResult(Result res)
-{
-	result = std::move(res);
-	return std::move(res);
-}
-
-Result GDIPlusData::InitializeGDIPlus()
-{
-	if (!result) { return result; }
-	if (pToken) {
-		return SetResult({ Gdiplus::Status::Aborted,
-			_T("GDI+ already initialized") });
-	}
-
-	Gdiplus::GdiplusStartupInput gdiInput; // GDI+ startup parameters
-	Gdiplus::Status gdiStatus = GdiplusStartup(&pToken, &gdiInput, nullptr);
-
-	if (gdiStatus != Gdiplus::Ok) {
-		return SetResult({ gdiStatus,
-			_T("GDI+ initialization failed") });
-	}
-
-	return {};
-}
-
-void GDIPlusData::ShutdownGDIPlus()
-{
-	// Shutdown GDI+
-	if (pToken) { Gdiplus::GdiplusShutdown(pToken); }
-	// Ensures GDI+ remains active until all objects are destroyed
-}
-
-GDIPlusData::~GDIPlusData()
-{
-	FreeImageAttributes();
-	FreeImageResource();
-	ShutdownGDIPlus();
-}
-
-GDIPlusData::GDIPlusData()
-{
-	InitializeGDIPlus();
-	if (!result) { return; }
-
-	LoadApplicationImage();
-	if (!result) { return; }
-
-	CreateImageAttributes();
-	if (!result) { return; }
-}
-
-Result GDIPlusData::LoadImageFile(LPCTSTR cszImagePath)
-{
-	// Attempt to load the image
-	delete pImage;
-	pImage = new Gdiplus::Image(cszImagePath);
-
-	// Check if allocation failed
-	if (!pImage) {
-		return SetResult({ ERROR_OUTOFMEMORY,
-			_T("Image memory allocation failed") });
-	}
-
-	// Check image status
-	if (pImage->GetLastStatus() != Gdiplus::Ok) {
-		Gdiplus::Status status = pImage->GetLastStatus();
-		delete pImage;
-		pImage = nullptr;
-		return SetResult({ status,
-			_T("Image loading failed") });
-	}
-
-	return {};
-}
-
-Result GDIPlusData::LoadImageByteArray()
-{
-	// Clean up existing image
-	delete pImage;
-
-	// Create memory stream from embedded data
-	IStream* stream = SHCreateMemStream(PNG_DATA, PNG_DATA_SIZE);
-	if (!stream) {
-		return SetResult({ ERROR_INVALID_DATA,
-			_T("Failed to create memory stream") });
-	}
-
-	// Load image from memory stream
-	pImage = new Gdiplus::Bitmap(stream);
-	stream->Release();  // Release COM object when done
-
-	// Check allocation
-	if (!pImage) {
-		return SetResult({ ERROR_OUTOFMEMORY,
-			_T("Image memory allocation failed") });
-	}
-
-	// Check loading status
-	Gdiplus::Status status = pImage->GetLastStatus();
-	if (status != Gdiplus::Ok) {
-		delete pImage;
-		pImage = nullptr;
-		return SetResult({ status,
-			_T("Failed to load image from memory") });
-	}
-
-	return {};
-}
-
-Result GDIPlusData::LoadApplicationImage()
-{
-	if (!result) { return result; }
-
-	TCHAR szBuffer[MAX_PATH]{}; // Buffer for the file path
-
-	// Get current directory
-	if (!GetCurrentDirectory(MAX_PATH, szBuffer)) {
-		return SetResult({ GetLastError(),
-			_T("Failed to get image directory") });
-	}
-
-	// Combine paths to form full image path
-	if (FAILED(PathCchCombine(szBuffer, MAX_PATH, szBuffer, _T("TabTap.png")))) {
-		return SetResult({ GetLastError(),
-			_T("Failed to get image path") });
-	}
-
-	// Verify file existence
-	if (GetFileAttributes(szBuffer) == INVALID_FILE_ATTRIBUTES) {
-		return LoadImageByteArray();
-	}
-
-	return LoadImageFile(szBuffer);
-}
-
-void GDIPlusData::FreeImageResource()
-{
-	delete pImage; // Free the image resource
-}
-
-Gdiplus::Image* GDIPlusData::GetImage() const
-{
-	return pImage;
-}
-
-Result GDIPlusData::CreateImageAttributes()
-{
-	delete pImageAttributes;
-	pImageAttributes = new Gdiplus::ImageAttributes;
-
-	if (!pImageAttributes) {
-		return SetResult({ ERROR_OUTOFMEMORY,
-			_T("Image Attributes memory allocation failed") });
-	}
-
-	Gdiplus::Status status = pImageAttributes->GetLastStatus();
-	if (status != Gdiplus::Ok) {
-		delete pImageAttributes;
-		pImageAttributes = nullptr;
-		return SetResult({ status,
-			_T("Image Attributes failed") });
-	}
-
-	return {};
-}
-
-void GDIPlusData::FreeImageAttributes()
-{
-	delete pImageAttributes; // Free the image attribute resource
-	pImageAttributes = nullptr;
-}
-
-Gdiplus::ImageAttributes* GDIPlusData::GetImageAttributes() const
-{
-	return pImageAttributes;
-}
-
-Result GDIPlusData::ApplyColorMatrix(Gdiplus::ColorMatrix* pColorMatrix)
-{
-	if (!pImageAttributes || !pColorMatrix) {
-		return SetResult({ ERROR_INVALID_PARAMETER,
-			_T("Invalid parameters for color matrix") });
-	}
-
-	pImageAttributes->SetColorMatrix(pColorMatrix);
-
-	Gdiplus::Status status = pImageAttributes->GetLastStatus();
-	if (status != Gdiplus::Ok) {
-		return SetResult({ status,
-			_T("Image Attributes color matrix error") });
-	}
-
-	return {};
-}
-
-Result GDIPlusData::GetResult() const
-{
-	return result;
-}
-
-
-
-// --- TrayIconManager ---
-
-Result TrayManager::SetResult(Result res)
-{
-	result = std::move(res);
-	return std::move(res);
-}
-
-TrayManager::~TrayManager()
-{
-	DeleteTrayIcon();
-	FreeIconResource();
-	DestroyTrayMenu();
-	delete pTrayAdapter;
-}
-
-TrayManager::TrayManager(ITrayAdapter* pAdapter)
-{
-	if (!pAdapter) { return; }
-
-	pTrayAdapter = pAdapter;
-	SetupTrayIcon();
-}
-
-Result TrayManager::SetupTrayIcon()
-{
-	Result result = pTrayAdapter->SetupTrayIcon(trayData);
-	if (!result) { return SetResult(result); }
-
-	if (!trayData.hWnd) {
-		return SetResult({ 1001,
-			_T("Invalid Handle"), _T("Window handle is null") });
-	}
-
-	return {};
-}
-
-void TrayManager::DeleteTrayIcon()
-{
-	Shell_NotifyIcon(NIM_DELETE, &trayData);
-}
-
-void TrayManager::GetIconResource(HICON hIcon)
-{
-	if (trayData.hIcon) { DestroyIcon(trayData.hIcon); }
-	trayData.hIcon = hIcon;
-}
-
-void TrayManager::FreeIconResource()
-{
-	if (trayData.hIcon) { DestroyIcon(trayData.hIcon); }
-	trayData.hIcon = NULL;
-}
-
-Result TrayManager::CreateTrayMenu()
-{
-	return SetResult(pTrayAdapter->CreateTrayMenu(hTrayMenu));
-}
-
-Result TrayManager::DestroyTrayMenu()
-{
-	if (hTrayMenu) {
-		if (!DestroyMenu(hTrayMenu)) {
-			return SetResult({ GetLastError(),
-				_T("Failed to destroy pop-up menu") });
-		}
-		hTrayMenu = NULL;
-	}
-
-	return {};
-}
-
-Result TrayManager::TrackTrayMenu()
-{
-	if (!hTrayMenu) {
-		return SetResult({ 1002,
-			_T("Invalid Handle"), _T("Menu handle is null") });
-	}
-
-	BOOL bResult{};
-	POINT ptCursor{};
-
-	bResult = GetCursorPos(&ptCursor);
-	if (!bResult) {
-		DWORD dwErr = GetLastError();
-		return SetResult({ dwErr,
-			_T("Failed to get cursor position") });
-	}
-
-	bResult = SetForegroundWindow(trayData.hWnd);
-	if (!bResult) {
-		DWORD dwErr = GetLastError();
-		return SetResult({ dwErr,
-			_T("Failed to set foreground window") });
-	}
-
-	bResult = TrackPopupMenu(
-		hTrayMenu,
-		TPM_LEFTBUTTON,
-		ptCursor.x, ptCursor.y,
-		0, trayData.hWnd, NULL
-	);
-	if (!bResult) {
-		DWORD dwErr = GetLastError();
-		return SetResult({ dwErr,
-			_T("Failed to track popup menu") });
-	}
-
-	return {};
-}
-
-Result TrayManager::HandleTrayRightClick()
-{
-	if (!CreateTrayMenu() or
-		!TrackTrayMenu() or
-		!DestroyTrayMenu())
-	{
-		return result;
-	}
-
-	return {};
-}
-
-Result TrayManager::GetResult() const
-{
-	return result;
-}
-
-void TrayManager::ClearResult()
-{
-	result = {};
-}
-
-
-
-// --- EdgeSnapping ---
-
-Result EdgeSnapData::SetResult(Result res)
-{
-	result = std::move(res);
-	return std::move(res);
-}
-
-void EdgeSnapData::CreatePreviewWindow()
-{
-	static LPCTSTR PREVIEW_CLASS = _T("EdgeSnapPreviewClass");
-	// Register window class once
-	static bool registered{};
-
-	if (!registered) {
-		WNDCLASSEX wc = { sizeof(WNDCLASSEX) };
-		wc.lpfnWndProc = DefWindowProc;
-		wc.hInstance = GetModuleHandle(nullptr);
-		wc.lpszClassName = PREVIEW_CLASS;
-		RegisterClassEx(&wc);
-		registered = true;
-	}
-
-	hPreviewWnd = CreateWindowEx(
-		WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOPMOST | WS_EX_NOACTIVATE,
-		PREVIEW_CLASS,
-		nullptr,
-		WS_POPUP,
-		0, 0, 0, 0,
-		nullptr, nullptr,
-		GetModuleHandle(nullptr), nullptr
-	);
-}
-
-void EdgeSnapData::UpdatePreviewWindow()
-{
-	// Calculate preview area based on edge
-	const RECT& workArea = WorkAreaManager::GetWorkArea();
-	RECT previewRect;
-
-	switch (snapEdge)
-	{
-	case ScreenEdge::Left:
-	{
-		previewRect = { workArea.left, workArea.top,
-						workArea.left + PreviewSize, workArea.bottom };
-		break;
-	}
-	case ScreenEdge::Right:
-	{
-		previewRect = { workArea.right - PreviewSize, workArea.top,
-						workArea.right, workArea.bottom };
-		break;
-	}
-	case ScreenEdge::Top:
-	{
-		previewRect = { workArea.left, workArea.top,
-						workArea.right, workArea.top + PreviewSize };
-		break;
-	}
-	case ScreenEdge::Bottom:
-	{
-		previewRect = { workArea.left, workArea.bottom - PreviewSize,
-						workArea.right, workArea.bottom };
-		break;
-	}
-	default:
-	{
-		const POINT relativePos = dragTracker.GetRelativePosition();
-
-		previewRect = {
-			rcTargetRect.left + relativePos.x,
-			rcTargetRect.top + relativePos.y,
-			rcTargetRect.right + relativePos.x,
-			rcTargetRect.bottom + relativePos.y
-		};
-		break;
-	}
-	}
-
-	// Position and show preview window
-	SetWindowPos(
-		hPreviewWnd, HWND_TOPMOST,
-		previewRect.left,
-		previewRect.top,
-		previewRect.right - previewRect.left,
-		previewRect.bottom - previewRect.top,
-		SWP_NOZORDER | SWP_NOACTIVATE
-	);
-
-	DrawPreview();
-	ShowWindow(hPreviewWnd, SW_SHOWNOACTIVATE);
-}
-
-Result EdgeSnapData::DrawPreview()
-{
-	// Declare all GDI resources
-	HDC hdcScreen{};
-	HDC hdcMem{};
-	HBITMAP hBmp{};
-	HPEN hPen{};
-	HBRUSH hBrush{};
-	HGDIOBJ hOldBmp{};
-	HGDIOBJ hOldPen{};
-	HGDIOBJ hOldBrush{};
-
-	// Setup cleanup lambda to release resources
-	auto cleanup = [&]() {
-		if (hdcMem) {
-			if (hOldPen) SelectObject(hdcMem, hOldPen);
-			if (hOldBrush) SelectObject(hdcMem, hOldBrush);
-			if (hOldBmp) SelectObject(hdcMem, hOldBmp);
-		}
-		if (hBmp) DeleteObject(hBmp);
-		if (hPen) DeleteObject(hPen);
-		if (hBrush) DeleteObject(hBrush);
-		if (hdcMem) DeleteDC(hdcMem);
-		if (hdcScreen) ReleaseDC(nullptr, hdcScreen);
-		};
-
-	// Validate preview window handle
-	if (!hPreviewWnd || !IsWindow(hPreviewWnd)) {
-		return SetResult({ ERROR_INVALID_HANDLE,
-			_T("Window Error"), _T("Preview window handle is invalid") });
-	}
-
-	// Retrieve window dimensions
-	RECT rect;
-	if (!GetWindowRect(hPreviewWnd, &rect)) {
-		return SetResult({ GetLastError(),
-			_T("Failed to get window dimensions") });
-	}
-
-	int width = rect.right - rect.left;
-	int height = rect.bottom - rect.top;
-	if (width <= 0 || height <= 0) {
-		return SetResult({ 1,
-			_T("Invalid Size"), _T("Window has non-positive dimensions") });
-	}
-
-	// Obtain screen DC and create compatible DC
-	hdcScreen = GetDC(nullptr);
-	if (!hdcScreen) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to acquire screen DC") });
-	}
-
-	hdcMem = CreateCompatibleDC(hdcScreen);
-	if (!hdcMem) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to create memory DC") });
-	}
-
-	// Create DIB section for the bitmap
-	BITMAPINFO bmi = { {
-		sizeof(BITMAPINFOHEADER),
-		width,
-		-height, // Top-down
-		1,
-		32,
-		BI_RGB
-	} };
-	void* pvBits{};
-	hBmp = CreateDIBSection(hdcMem, &bmi, DIB_RGB_COLORS, &pvBits, nullptr, 0);
-	if (!hBmp) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to create DIB section") });
-	}
-
-	hOldBmp = SelectObject(hdcMem, hBmp);
-	memset(pvBits, 0, width * height * 4); // Clear to transparent
-
-	// Create and select drawing tools
-	hPen = CreatePen(PS_INSIDEFRAME, PreviewFrameSize, RGB(0, 120, 215));
-	if (!hPen) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to create pen") });
-	}
-	hOldPen = SelectObject(hdcMem, hPen);
-	BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-
-	if (IsSnapEdge(ScreenEdge::None)) {
-		hOldBrush = SelectObject(hdcMem, GetStockObject(NULL_BRUSH));
-	}
-	else {
-		if (pSnapAdapter->IsValidSnapEdge(GetSnapEdge())) {
-			hBrush = CreateSolidBrush(RGB(0, 120, 215));
-		}
-		else {
-			hBrush = CreateSolidBrush(RGB(215, 0, 0));
-		}
-
-		if (!hBrush) {
-			cleanup();
-			return SetResult({ GetLastError(),
-				_T("Failed to create brush") });
-		}
-
-		hOldBrush = SelectObject(hdcMem, hBrush);
-		blend.SourceConstantAlpha = 150;
-	}
-
-	// Draw the preview frame or filled rectangle
-	if (!Rectangle(hdcMem, 0, 0, width, height)) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to draw preview rectangle") });
-	}
-
-	// Update the layered window with the new bitmap
-	POINT ptPos{ rect.left, rect.top };
-	SIZE szWnd{ width, height };
-	POINT ptSrc{};
-	if (!UpdateLayeredWindow(hPreviewWnd, nullptr, &ptPos, &szWnd,
-		hdcMem, &ptSrc, 0, &blend, ULW_ALPHA)) {
-		cleanup();
-		return SetResult({ GetLastError(),
-			_T("Failed to update layered window") });
-	}
-
-	cleanup();
-	return {};
-}
-
-EdgeSnapData::~EdgeSnapData()
-{
-	if (hPreviewWnd) {
-		DestroyWindow(hPreviewWnd);
-	}
-	if (pSnapAdapter) {
-		delete pSnapAdapter;
-	}
-}
-
-EdgeSnapData::EdgeSnapData() {}
-
-ScreenEdge EdgeSnapData::GetSnapEdge() const
-{
-	return snapEdge;
-}
-
-bool EdgeSnapData::IsSnapEdge(const ScreenEdge& edge)
-{
-	return edge == GetSnapEdge();
-}
-
-bool EdgeSnapData::Enable(ISnapAdapter* pAdapter)
-{
-	if (!pAdapter) { return false; }
-
-	HWND hTargetWnd = pAdapter->GetTargetWindow();
-	if (!hTargetWnd) { return false; }
-
-	GetWindowRect(hTargetWnd, &rcTargetRect);
-	dragTracker.BeginDrag();
-	pSnapAdapter = pAdapter;
-	isEnabled = true;
-
-	// Update work area to avoid taskbar during snap
-	WorkAreaManager::Refresh();
-
-	return true;
-}
-
-void EdgeSnapData::Disable()
-{
-	const POINT relativePos = dragTracker.GetRelativePosition();
-	POINT ptDest = {
-		rcTargetRect.left + relativePos.x,
-		rcTargetRect.top + relativePos.y
-	};
-
-	if (IsSnapEdge(ScreenEdge::None)) {
-		pSnapAdapter->OnSnapEdgeNone(ptDest);
-	}
-	else if (pSnapAdapter->IsValidSnapEdge(GetSnapEdge())) {
-		pSnapAdapter->OnSnapSuccess(
-			GetSnapEdge(), ptDest
-		);
-	}
-	else {
-		pSnapAdapter->OnSnapRejected(
-			GetSnapEdge(), ptDest
-		);
-	}
-
-	if (hPreviewWnd) {
-		DestroyWindow(hPreviewWnd);
-		hPreviewWnd = nullptr;
-	}
-	if (pSnapAdapter) {
-		delete pSnapAdapter;
-		pSnapAdapter = nullptr;
-	}
-	isEnabled = false;
-	isPreviewEnabled = false;
-	snapEdge = ScreenEdge::None;
-	rcTargetRect = {};
-	dragTracker.EndDrag();
-}
-
-bool EdgeSnapData::IsEnabled() const
-{
-	return isEnabled;
-}
-
-bool EdgeSnapData::IsPreviewEnabled() const
-{
-	return isPreviewEnabled;
-}
-
-bool EdgeSnapData::OnMouseMove()
-{
-	if (isEnabled) {
-		dragTracker.Update();
-		const POINT& cursorPos = dragTracker.GetCursorPosition();
-
-		if (isPreviewEnabled) {
-			// Determine snap edge based on cursor position
-			const RECT& workArea = WorkAreaManager::GetWorkArea();
-			snapEdge = ScreenEdge::None;
-
-			if (cursorPos.x <= workArea.left + SnapMargin) { snapEdge = ScreenEdge::Left; }
-			else if (cursorPos.x >= workArea.right - SnapMargin) { snapEdge = ScreenEdge::Right; }
-			else if (cursorPos.y <= workArea.top + SnapMargin) { snapEdge = ScreenEdge::Top; }
-			else if (cursorPos.y >= workArea.bottom - SnapMargin) { snapEdge = ScreenEdge::Bottom; }
-			if (snapEdge == pSnapAdapter->GetSnapEdge()) { snapEdge = ScreenEdge::None; }
-
-			UpdatePreviewWindow();
-		}
-		// Enable preview only if cursor leaves the window
-		else if (!PtInRect(&rcTargetRect, cursorPos)) {
-			if (!hPreviewWnd) { CreatePreviewWindow(); }
-			isPreviewEnabled = true;
-		}
-
-		return true;
-	}
-	return false;
-}
-
-
-
-// --- AnimationData ---
-
-AnimationData::~AnimationData() {}
-
-AnimationData::AnimationData() {}
-
-bool AnimationData::Enable(HWND hWnd, const POINT& ptDest)
-{
-	if (isEnabled) { return false; }
-
-	// Update work area to avoid taskbar
-	WorkAreaManager::Refresh();
-
-	RECT targetRect;
-	if (!GetWindowRect(hWnd, &targetRect)) { return false; }
-
-	ptCurrentPoint = { targetRect.left, targetRect.top };
-	ptTargetPoint = {
-		// X-axis clamp
-		std::clamp(
-			ptDest.x,
-			WorkAreaManager::GetWorkArea().left,
-			WorkAreaManager::GetWorkArea().right - (targetRect.right - targetRect.left)
-		),
-			// Y-axis clamp
-			std::clamp(
-				ptDest.y,
-				WorkAreaManager::GetWorkArea().top,
-				WorkAreaManager::GetWorkArea().bottom - (targetRect.bottom - targetRect.top)
-			)
-	};
-	hAnimatedWnd = hWnd;
-	isEnabled = true;
-
-	return true;
-}
-
-void AnimationData::Disable()
-{
-	isEnabled = false;
-	hAnimatedWnd = NULL;
-	ptCurrentPoint = {};
-	ptTargetPoint = {};
-}
-
-bool AnimationData::IsEnabled() const
-{
-	return isEnabled;
-}
-
-bool AnimationData::Update()
-{
-	if (!isEnabled or !hAnimatedWnd) { return false; }
-
-	// Calculate remaining distance for BOTH axes
-	const POINT ptRemaining = {
-		ptTargetPoint.x - ptCurrentPoint.x,
-		ptTargetPoint.y - ptCurrentPoint.y
-	};
-
-	// Check if animation is complete (both axes)
-	if (ptRemaining.x == 0 and ptRemaining.y == 0) {
-		Disable();
-		return false;
-	}
-
-	ptCurrentPoint.x += std::clamp<LONG>(ptRemaining.x, -pixelByStep, pixelByStep);
-	ptCurrentPoint.y += std::clamp<LONG>(ptRemaining.y, -pixelByStep, pixelByStep);
-
-	// Move the window to the new position
-	SetWindowPos(
-		hAnimatedWnd, NULL,
-		ptCurrentPoint.x, ptCurrentPoint.y,
-		0, 0,
-		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
-	);
-
-	// Continue if either axis hasn't reached target
-	return true;
-}
-
-
-
-// --- BlinkData ---
-
-void BlinkData::InitializeColorMatrices()
-{
-	// Initialize normalMatrix to identity matrix (no color adjustment)
-	normalMatrix = { {
-		{1.0f, 0.0f, 0.0f, 0.0f, 0.0f},  // Red channel
-		{0.0f, 1.0f, 0.0f, 0.0f, 0.0f},  // Green channel
-		{0.0f, 0.0f, 1.0f, 0.0f, 0.0f},  // Blue channel
-		{0.0f, 0.0f, 0.0f, 1.0f, 0.0f},  // Alpha channel
-		{0.0f, 0.0f, 0.0f, 0.0f, 1.0f}   // Translations
-	} };
-
-	// Copy normalMatrix to blinkMatrix as a starting point
-	blinkMatrix = normalMatrix;
-
-	// Set translation values for blink effect (adds color tint)
-	blinkMatrix.m[4][0] = GetRValue(defBlinkColor) / 255.0f * defIntensity; // Red component
-	blinkMatrix.m[4][1] = GetGValue(defBlinkColor) / 255.0f * defIntensity; // Green component
-	blinkMatrix.m[4][2] = GetBValue(defBlinkColor) / 255.0f * defIntensity; // Blue component
-}
-
-BlinkData::~BlinkData()
-{
-	if (isEnabled) { Disable(); }
-}
-
-BlinkData::BlinkData()
-{
-	InitializeColorMatrices();
-}
-
-bool BlinkData::Enable(HWND hWnd, const UINT& timerId)
-{
-	blinkStartTime = GetTickCount();
-
-	if (isEnabled) { return false; }
-
-	hTargetWnd = hWnd;
-	uTimerID = timerId;
-	isEnabled = true;
-	isBlinkState = true;
-	SetTimer(hTargetWnd, timerId, defInterval, NULL);
-
-	return true;
-}
-
-void BlinkData::Disable()
-{
-	KillTimer(hTargetWnd, uTimerID);
-	uTimerID = {};
-	hTargetWnd = NULL;
-	isEnabled = false;
-	isBlinkState = false;
-}
-
-bool BlinkData::IsEnabled() const
-{
-	return isEnabled;
-}
-
-bool BlinkData::Update()
-{
-	if (IsElapsed()) {
-		Disable();
-		return false;
-	}
-
-	isBlinkState = !isBlinkState;
-	return true;
-}
-
-bool BlinkData::IsElapsed()
-{
-	return GetTickCount() >= (blinkStartTime + defDuration);
-}
-
-Gdiplus::ColorMatrix* BlinkData::GetActiveColorMatrix()
-{
-	return isBlinkState
-		? &blinkMatrix
-		: &normalMatrix;
-}
-
-
-
+// Implementation-specific headers
+#include "UIComponents.h"
+#include "Image.h"
+#include "ProcessQos.h"
+#include "MonitorTopology.h"
+#include "AppPaths.h"
+
+// Default headers
+#include <algorithm>
+#include <cstdio>
+#include <cinttypes>
+#include <cstring>
+#include <iterator>
+
+// Windows headers
+#include <Shlwapi.h>
+#include <PathCch.h>
+#include <WtsApi32.h>
+#include <dwmapi.h>
+
+// Library links
+#pragma comment(lib, "gdiplus.lib")
+#pragma comment(lib, "Shlwapi.lib")
+#pragma comment(lib, "Pathcch.lib")
+#pragma comment(lib, "Wtsapi32.lib")
+#pragma comment(lib, "Dwmapi.lib")
+#pragma comment(lib, "Ole32.lib")
+#pragma comment(lib, "OleAut32.lib")
+
+
+
+// --- DirectoryWatcher ---
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+	Stop();
+	if (hStopEvent) { CloseHandle(hStopEvent); }
+}
+
+DirectoryWatcher::DirectoryWatcher()
+{
+	// Manual-reset event, signaled on Stop
+	hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+}
+
+bool DirectoryWatcher::Start(const std::filesystem::path& directory, ChangeCallback callback)
+{
+	if (!hStopEvent or !callback or IsRunning()) { return false; }
+
+	HANDLE hChange = FindFirstChangeNotification(
+		directory.c_str(),
+		FALSE,  // Only the directory itself
+		FILE_NOTIFY_CHANGE_FILE_NAME |
+		FILE_NOTIFY_CHANGE_SIZE |
+		FILE_NOTIFY_CHANGE_LAST_WRITE
+	);
+	if (hChange == INVALID_HANDLE_VALUE) { return false; }
+
+	ResetEvent(hStopEvent);
+
+	watcher = std::thread{ [hChange, hStop = hStopEvent, callback]() {
+		const HANDLE handles[] = { hStop, hChange };
+
+		while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1) {
+			callback();
+			if (!FindNextChangeNotification(hChange)) { break; }
+		}
+
+		FindCloseChangeNotification(hChange);
+	} };
+
+	return true;
+}
+
+void DirectoryWatcher::Stop()
+{
+	if (!IsRunning()) { return; }
+
+	SetEvent(hStopEvent);
+	watcher.join();
+}
+
+bool DirectoryWatcher::IsRunning() const
+{
+	return watcher.joinable();
+}
+
+
+
+// --- TraceRecorder ---
+
+TraceRecorder::~TraceRecorder()
+{
+	Stop();
+	if (hStopEvent) { CloseHandle(hStopEvent); }
+}
+
+TraceRecorder::TraceRecorder()
+{
+	// Manual-reset event, signaled on Stop
+	hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+}
+
+void TraceRecorder::DrainRing(Trace::Ring& ring, RotatingFile& file, LONGLONG origin, double ticksPerMs)
+{
+	static constexpr const char* SourceNames[] = { "tabtap", "cbt", "oskmain", "directui" };
+	static_assert(std::size(SourceNames) == size_t(Trace::Source::Count), "Source name missing");
+
+	char line[160];
+
+	ring.Drain([&](const Trace::Record& record) {
+		const char* source = record.source < std::size(SourceNames) ?
+			SourceNames[record.source] : "unknown";
+
+		// Milliseconds relative to recorder start; records from before it are negative
+		const double timeMs = double(LONGLONG(record.time) - origin) / ticksPerMs;
+
+		const int length = std::snprintf(line, sizeof(line),
+			"%12.3f %6" PRIu32 " %6" PRIu32 " %-8s 0x%04" PRIX32 " 0x%016" PRIX64 " 0x%016" PRIX64 "\r\n",
+			timeMs, record.processId, record.threadId, source,
+			record.message, record.wParam, record.lParam);
+		if (length > 0) { file.Write(line, std::min(size_t(length), sizeof(line) - 1)); }
+		});
+
+	if (const uint64_t dropped = ring.TakeDropped()) {
+		const int length = std::snprintf(line, sizeof(line),
+			"%12s dropped %" PRIu64 " records\r\n", "-", dropped);
+		if (length > 0) { file.Write(line, std::min(size_t(length), sizeof(line) - 1)); }
+	}
+}
+
+bool TraceRecorder::Start(TraceChannel& channel, const std::filesystem::path& filePath)
+{
+	if (!hStopEvent or !channel.IsOpen() or IsRunning()) { return false; }
+
+	LARGE_INTEGER frequency{}, origin{};
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&origin);
+
+	ResetEvent(hStopEvent);
+
+	// Records from before this recording (a previous one's stragglers) are not part of it
+	Trace::Ring& ring = channel.GetRing();
+	ring.Clear();
+	ring.SetEnabled(true);
+	pRing = &ring;
+
+	drainer = std::thread{ [&ring, hStop = hStopEvent, filePath,
+		origin = origin.QuadPart, ticksPerMs = double(frequency.QuadPart) / 1000.0]() {
+		RotatingFile file{};
+		if (!file.Open(filePath, MaxFileBytes, KeepFiles)) {
+			ring.SetEnabled(false);
+			return;
+		}
+
+		file.Write("        time    pid    tid source   msg    wParam             lParam\r\n");
+
+		// Drain on a fixed period; the final pass runs after Stop is signaled
+		DWORD waitResult{};
+		do {
+			waitResult = WaitForSingleObject(hStop, DrainIntervalMs);
+			DrainRing(ring, file, origin, ticksPerMs);
+			file.Flush();
+		} while (waitResult == WAIT_TIMEOUT);
+
+		file.Close();
+	} };
+
+	return true;
+}
+
+void TraceRecorder::Stop()
+{
+	if (!IsRunning()) { return; }
+
+	// Producers stop appending; the drainer's final pass picks up what is already in
+	pRing->SetEnabled(false);
+	SetEvent(hStopEvent);
+	drainer.join();
+	pRing = nullptr;
+}
+
+bool TraceRecorder::IsRunning() const
+{
+	return drainer.joinable();
+}
+
+Result TraceRecorder::GetTracePath(LPTSTR szBuffer, size_t cchBuffer)
+{
+	// Next to the executable, whatever the working directory
+	if (!GetAppFilePath(_T("TabTap.trace.log"), szBuffer, cchBuffer)) {
+		return { GetLastError(),
+			_T("Failed to get trace path") };
+	}
+
+	return {};
+}
+
+
+
+// --- MetricsExporter ---
+
+MetricsExporter::~MetricsExporter()
+{
+	Stop();
+	if (hStopEvent) { CloseHandle(hStopEvent); }
+}
+
+MetricsExporter::MetricsExporter()
+{
+	// Manual-reset event, signaled on Stop
+	hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+}
+
+bool MetricsExporter::WriteSnapshotFile(const std::filesystem::path& filePath, const std::string& text)
+{
+	std::filesystem::path tempPath = filePath;
+	tempPath += ".tmp";
+	{
+		std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+		if (!file) { return false; }
+		file.write(text.data(), std::streamsize(text.size()));
+		file.flush();
+		if (!file) { return false; }
+	}
+
+	// Readers see the previous or the new snapshot, never half of one
+	std::error_code ec{};
+	std::filesystem::rename(tempPath, filePath, ec);
+	if (ec) {
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+	return true;
+}
+
+bool MetricsExporter::ListenForClient(HANDLE hPipe, OVERLAPPED* pOverlapped)
+{
+	ResetEvent(pOverlapped->hEvent);
+	if (ConnectNamedPipe(hPipe, pOverlapped)) { return true; }
+
+	switch (GetLastError())
+	{
+	case ERROR_IO_PENDING:
+		return true;
+	case ERROR_PIPE_CONNECTED:
+		// Connected between CreateNamedPipe and ConnectNamedPipe
+		SetEvent(pOverlapped->hEvent);
+		return true;
+	default:
+		return false;
+	}
+}
+
+void MetricsExporter::ServeClient(HANDLE hPipe, OVERLAPPED* pOverlapped, const std::string& text)
+{
+	// Completes an overlapped call, cancelling it after the client timeout
+	const auto complete = [hPipe, pOverlapped](BOOL bStarted) {
+		if (!bStarted and GetLastError() != ERROR_IO_PENDING) { return false; }
+		if (WaitForSingleObject(pOverlapped->hEvent, ClientTimeoutMs) != WAIT_OBJECT_0) {
+			CancelIoEx(hPipe, pOverlapped);
+		}
+		DWORD dwBytes{};
+		return GetOverlappedResult(hPipe, pOverlapped, &dwBytes, TRUE) != FALSE;
+		};
+
+	if (complete(WriteFile(hPipe, text.data(), DWORD(text.size()), NULL, pOverlapped))) {
+		// Disconnecting discards unread data; wait for the client to close its end
+		char byte{};
+		complete(ReadFile(hPipe, &byte, 1, NULL, pOverlapped));
+	}
+
+	DisconnectNamedPipe(hPipe);
+}
+
+bool MetricsExporter::Start(MetricsChannel& channel, const std::filesystem::path& filePath)
+{
+	if (!hStopEvent or !channel.IsOpen() or IsRunning()) { return false; }
+
+	// One local instance; a second TabTap keeps its file export only
+	HANDLE hPipe = CreateNamedPipe(PipeName,
+		PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+		PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+		1, PipeBufferBytes, 0, 0, NULL);
+
+	ResetEvent(hStopEvent);
+
+	exporter = std::thread{ [&registry = channel.GetRegistry(), hStop = hStopEvent, hPipe, filePath]() {
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		bool isListening = hPipe != INVALID_HANDLE_VALUE and overlapped.hEvent and
+			ListenForClient(hPipe, &overlapped);
+
+		const HANDLE handles[] = { hStop, overlapped.hEvent };
+		ULONGLONG nextExportMs = GetTickCount64();
+
+		for (;;) {
+			const ULONGLONG nowMs = GetTickCount64();
+			if (nowMs >= nextExportMs) {
+				WriteSnapshotFile(filePath, Metrics::FormatText(registry.TakeSnapshot()));
+				nextExportMs = nowMs + ExportIntervalMs;
+			}
+
+			const DWORD waitResult = WaitForMultipleObjects(isListening ? 2 : 1, handles, FALSE,
+				DWORD(nextExportMs - nowMs));
+			if (waitResult == WAIT_OBJECT_0 or waitResult == WAIT_FAILED) { break; }
+
+			if (waitResult == WAIT_OBJECT_0 + 1) {
+				ServeClient(hPipe, &overlapped, Metrics::FormatText(registry.TakeSnapshot()));
+				isListening = ListenForClient(hPipe, &overlapped);
+			}
+		}
+
+		// Final snapshot for the session
+		WriteSnapshotFile(filePath, Metrics::FormatText(registry.TakeSnapshot()));
+
+		if (hPipe != INVALID_HANDLE_VALUE) {
+			CancelIoEx(hPipe, &overlapped);
+			DWORD dwBytes{};
+			GetOverlappedResult(hPipe, &overlapped, &dwBytes, TRUE);
+			CloseHandle(hPipe);
+		}
+		if (overlapped.hEvent) { CloseHandle(overlapped.hEvent); }
+	} };
+
+	return true;
+}
+
+void MetricsExporter::Stop()
+{
+	if (!IsRunning()) { return; }
+
+	SetEvent(hStopEvent);
+	exporter.join();
+}
+
+bool MetricsExporter::IsRunning() const
+{
+	return exporter.joinable();
+}
+
+
+
+// --- StateStore ---
+
+StateStore::~StateStore()
+{
+	Flush();
+}
+
+Snapshot::Status StateStore::Load(const std::filesystem::path& filePath)
+{
+	path = filePath;
+
+	Snapshot::State loaded{};
+	const Snapshot::Status status = Snapshot::Load(path, &loaded);
+	if (status == Snapshot::Status::Ok) { state = loaded; }
+	isLoaded = (status == Snapshot::Status::Ok);
+
+	return status;
+}
+
+bool StateStore::IsLoaded() const
+{
+	return isLoaded;
+}
+
+const Snapshot::State& StateStore::Get() const
+{
+	return state;
+}
+
+bool StateStore::Update(const Snapshot::State& newState)
+{
+	if (path.empty()) { return false; }
+	if (!std::memcmp(&state, &newState, sizeof(Snapshot::State))) { return true; }
+
+	if (!pSaveWork) {
+		pSaveWork = CreateThreadpoolWork(SaveWork, this, nullptr);
+		if (!pSaveWork) { return false; }
+	}
+
+	state = newState;
+	{
+		std::lock_guard<std::mutex> lock{ pendingMutex };
+		pending = newState;
+	}
+
+	SubmitThreadpoolWork(pSaveWork);
+	return true;
+}
+
+void StateStore::Flush()
+{
+	if (!pSaveWork) { return; }
+
+	WaitForThreadpoolWorkCallbacks(pSaveWork, FALSE);
+	CloseThreadpoolWork(pSaveWork);
+	pSaveWork = nullptr;
+}
+
+VOID CALLBACK StateStore::SaveWork(PTP_CALLBACK_INSTANCE, PVOID pContext, PTP_WORK)
+{
+	StateStore* pStore = static_cast<StateStore*>(pContext);
+
+	// Coalesced: writes whatever state is current when the callback runs
+	std::lock_guard<std::mutex> saveLock{ pStore->saveMutex };
+	Snapshot::State snapshot{};
+	{
+		std::lock_guard<std::mutex> lock{ pStore->pendingMutex };
+		snapshot = pStore->pending;
+	}
+
+	Snapshot::Save(pStore->path, snapshot);
+}
+
+
+
+// --- PowerMonitor ---
+
+PowerMonitor::~PowerMonitor()
+{
+	if (hDisplayNotify) { UnregisterPowerSettingNotification(hDisplayNotify); }
+	if (hSourceNotify) { UnregisterPowerSettingNotification(hSourceNotify); }
+	if (hSaverNotify) { UnregisterPowerSettingNotification(hSaverNotify); }
+	if (isSessionRegistered) { WTSUnRegisterSessionNotification(hNotifyWnd); }
+}
+
+PowerMonitor::PowerMonitor(HWND hWnd) :
+	hNotifyWnd{ hWnd }
+{
+	// Each registration immediately delivers the current value
+	hDisplayNotify = RegisterPowerSettingNotification(hWnd,
+		&GUID_CONSOLE_DISPLAY_STATE, DEVICE_NOTIFY_WINDOW_HANDLE);
+	hSourceNotify = RegisterPowerSettingNotification(hWnd,
+		&GUID_ACDC_POWER_SOURCE, DEVICE_NOTIFY_WINDOW_HANDLE);
+	hSaverNotify = RegisterPowerSettingNotification(hWnd,
+		&GUID_POWER_SAVING_STATUS, DEVICE_NOTIFY_WINDOW_HANDLE);
+	isSessionRegistered = WTSRegisterSessionNotification(hWnd, NOTIFY_FOR_THIS_SESSION);
+
+	usage.Reset(GetTickCount64(), GetProcessCpuMs());
+}
+
+bool PowerMonitor::OnPowerBroadcast(WPARAM wParam, LPARAM lParam)
+{
+	if (wParam != PBT_POWERSETTINGCHANGE or !lParam) { return false; }
+
+	const POWERBROADCAST_SETTING* pSetting = (const POWERBROADCAST_SETTING*)lParam;
+	if (pSetting->DataLength < sizeof(DWORD)) { return false; }
+	const DWORD dwValue = *(const DWORD*)pSetting->Data;
+
+	if (IsEqualGUID(pSetting->PowerSetting, GUID_CONSOLE_DISPLAY_STATE)) {
+		policy.SetDisplayOn(dwValue != 0);  // 0 = off, 1 = on, 2 = dimmed
+		return true;
+	}
+	if (IsEqualGUID(pSetting->PowerSetting, GUID_ACDC_POWER_SOURCE)) {
+		policy.SetOnBattery(dwValue != PoAc);
+		return true;
+	}
+	if (IsEqualGUID(pSetting->PowerSetting, GUID_POWER_SAVING_STATUS)) {
+		policy.SetBatterySaver(dwValue != 0);
+		return true;
+	}
+	return false;
+}
+
+bool PowerMonitor::OnSessionChange(WPARAM wParam)
+{
+	if (wParam == WTS_SESSION_LOCK) {
+		policy.SetSessionLocked(true);
+		return true;
+	}
+	if (wParam == WTS_SESSION_UNLOCK) {
+		policy.SetSessionLocked(false);
+		return true;
+	}
+	return false;
+}
+
+void PowerMonitor::SetFullscreen(bool isFullscreen)
+{
+	policy.SetFullscreen(isFullscreen);
+}
+
+void PowerMonitor::BeginActivity(Power::Activity activity)
+{
+	policy.BeginActivity(activity);
+}
+
+void PowerMonitor::EndActivity(Power::Activity activity)
+{
+	policy.EndActivity(activity);
+}
+
+bool PowerMonitor::TakeChange(Power::Decision* pDecision)
+{
+	return policy.TakeChange(pDecision);
+}
+
+const Power::Decision& PowerMonitor::GetDecision() const
+{
+	return policy.GetApplied();
+}
+
+void PowerMonitor::RecordWakeup()
+{
+	usage.RecordWakeup();
+}
+
+Power::UsageMeter::Report PowerMonitor::TakeUsageReport()
+{
+	const ULONGLONG now = GetTickCount64();
+	const uint64_t cpuMs = GetProcessCpuMs();
+
+	Power::UsageMeter::Report report = usage.GetReport(now, cpuMs);
+	usage.Reset(now, cpuMs);
+	return report;
+}
+
+
+
+// --- FullscreenMonitor ---
+
+FullscreenMonitor* FullscreenMonitor::pInstance{};
+
+FullscreenMonitor::~FullscreenMonitor()
+{
+	if (hForegroundHook) { UnhookWinEvent(hForegroundHook); }
+	if (isAppBarRegistered) {
+		APPBARDATA abd{ sizeof(APPBARDATA) };
+		abd.hWnd = hNotifyWnd;
+		SHAppBarMessage(ABM_REMOVE, &abd);
+	}
+	if (pInstance == this) { pInstance = nullptr; }
+}
+
+FullscreenMonitor::FullscreenMonitor(HWND hWnd, UINT uMessage) :
+	hNotifyWnd{ hWnd },
+	uNotifyMessage{ uMessage }
+{
+	pInstance = this;
+
+	// Registered without ABM_SETPOS, so no screen space is reserved;
+	// the shell still sends ABN_FULLSCREENAPP
+	APPBARDATA abd{ sizeof(APPBARDATA) };
+	abd.hWnd = hWnd;
+	abd.uCallbackMessage = uMessage;
+	isAppBarRegistered = SHAppBarMessage(ABM_NEW, &abd) != FALSE;
+
+	hForegroundHook = SetWinEventHook(
+		EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+		NULL, OnForegroundEvent, 0, 0,
+		WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+}
+
+void CALLBACK FullscreenMonitor::OnForegroundEvent(HWINEVENTHOOK, DWORD, HWND hWnd,
+	LONG idObject, LONG, DWORD, DWORD)
+{
+	if (!pInstance or !hWnd or idObject != OBJID_WINDOW) { return; }
+	PostMessage(pInstance->hNotifyWnd, pInstance->uNotifyMessage, ForegroundChanged, 0);
+}
+
+Fullscreen::Window FullscreenMonitor::DescribeWindow(HWND hWnd, HWND hForeground)
+{
+	Fullscreen::Window window{};
+
+	RECT rc{};
+	GetWindowRect(hWnd, &rc);
+	window.bounds = ToGeometry(rc);
+	window.isVisible = IsWindowVisible(hWnd) != FALSE;
+	window.isForeground = hWnd == hForeground;
+
+	BOOL isCloaked{};
+	window.isCloaked = SUCCEEDED(DwmGetWindowAttribute(hWnd, DWMWA_CLOAKED, &isCloaked, sizeof(isCloaked))) and isCloaked;
+
+	const LONG_PTR style = GetWindowLongPtr(hWnd, GWL_STYLE);
+	window.isBordered = (style & WS_CAPTION) == WS_CAPTION or (style & WS_THICKFRAME);
+
+	TCHAR szClassName[64]{};
+	GetClassName(hWnd, szClassName, (int)std::size(szClassName));
+
+	static constexpr LPCTSTR OwnClasses[] = { _T("TabTapMainClass"), _T("OSKMainClass") };
+	static constexpr LPCTSTR ShellClasses[] = {
+		_T("Progman"), _T("WorkerW"), _T("Shell_TrayWnd"), _T("Shell_SecondaryTrayWnd")
+	};
+	for (LPCTSTR name : OwnClasses) {
+		if (_tcscmp(szClassName, name) == 0) { window.kind = Fullscreen::WindowKind::Own; }
+	}
+	for (LPCTSTR name : ShellClasses) {
+		if (_tcscmp(szClassName, name) == 0) { window.kind = Fullscreen::WindowKind::Shell; }
+	}
+	return window;
+}
+
+bool FullscreenMonitor::OnNotify(WPARAM wParam) const
+{
+	return wParam == ABN_FULLSCREENAPP or wParam == ForegroundChanged;
+}
+
+bool FullscreenMonitor::Refresh()
+{
+	QUERY_USER_NOTIFICATION_STATE quns{};
+	if (FAILED(SHQueryUserNotificationState(&quns))) { quns = QUNS_ACCEPTS_NOTIFICATIONS; }
+
+	// Collect windows topmost first until the front window is known
+	struct Collector
+	{
+		HWND hForeground{};
+		std::vector<Fullscreen::Window> windows{};
+	} collector{ GetForegroundWindow() };
+
+	EnumWindows([](HWND hWnd, LPARAM lParam) -> BOOL {
+		Collector* pCollector = reinterpret_cast<Collector*>(lParam);
+		if (hWnd != pCollector->hForeground and !IsWindowVisible(hWnd)) { return TRUE; }
+
+		pCollector->windows.push_back(DescribeWindow(hWnd, pCollector->hForeground));
+		return !Fullscreen::FindFrontWindow(pCollector->windows.data(), pCollector->windows.size());
+		}, reinterpret_cast<LPARAM>(&collector));
+
+	const std::vector<Geometry::Rect> monitors = GetMonitorRects();
+
+	const Fullscreen::Reason newReason = Fullscreen::Detect(
+		Fullscreen::NotificationState(quns),
+		collector.windows.data(), collector.windows.size(),
+		monitors.data(), monitors.size());
+
+	if (newReason == reason) { return false; }
+	reason = newReason;
+	return true;
+}
+
+Fullscreen::Reason FullscreenMonitor::GetReason() const
+{
+	return reason;
+}
+
+bool FullscreenMonitor::IsActive() const
+{
+	return reason != Fullscreen::Reason::None;
+}
+
+
+
+// --- ProcessSupervisor ---
+
+ProcessSupervisor::~ProcessSupervisor()
+{
+	Stop();
+
+	// A launch in flight finishes first; its result is posted to a closing window
+	if (pRestartWork) {
+		WaitForThreadpoolWorkCallbacks(pRestartWork, FALSE);
+		CloseThreadpoolWork(pRestartWork);
+		pRestartWork = nullptr;
+	}
+}
+
+ProcessSupervisor::ProcessSupervisor(HWND hWnd, UINT uMessage, WPARAM wExitParam, WPARAM wRestartParam) :
+	hNotifyWnd{ hWnd },
+	uNotifyMessage{ uMessage },
+	wExitParam{ wExitParam },
+	wRestartParam{ wRestartParam }
+{}
+
+bool ProcessSupervisor::Watch(DWORD dwProcessId, uint64_t* pRecoveryMs)
+{
+	Stop();
+	isRestarting = false;
+
+	hProcess = OpenProcess(SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, dwProcessId);
+	if (!hProcess) {
+		hProcess = OpenProcess(SYNCHRONIZE, FALSE, dwProcessId);  // Exit code unknown
+		if (!hProcess) { return false; }
+	}
+
+	pWait = CreateThreadpoolWait(OnProcessExit, this, nullptr);
+	if (!pWait) {
+		CloseHandle(hProcess);
+		hProcess = NULL;
+		return false;
+	}
+	SetThreadpoolWait(pWait, hProcess, nullptr);
+
+	const bool isRestart = policy.IsRecovering();
+	const uint64_t recoveryMs = policy.OnStarted(TimerScheduler::GetTimeMs());
+	if (isRestart) {
+		restartCount.Add();
+		recoveryTime.Observe(recoveryMs);
+	}
+	if (pRecoveryMs) { *pRecoveryMs = recoveryMs; }
+	return true;
+}
+
+void ProcessSupervisor::Stop()
+{
+	if (pWait) {
+		SetThreadpoolWait(pWait, NULL, nullptr);
+		WaitForThreadpoolWaitCallbacks(pWait, TRUE);
+		CloseThreadpoolWait(pWait);
+		pWait = nullptr;
+	}
+	if (hProcess) {
+		CloseHandle(hProcess);
+		hProcess = NULL;
+	}
+}
+
+bool ProcessSupervisor::IsWatching() const
+{
+	return pWait != nullptr;
+}
+
+VOID CALLBACK ProcessSupervisor::OnProcessExit(PTP_CALLBACK_INSTANCE, PVOID pContext, PTP_WAIT, TP_WAIT_RESULT)
+{
+	ProcessSupervisor* pSupervisor = static_cast<ProcessSupervisor*>(pContext);
+
+	DWORD dwExitCode{};
+	GetExitCodeProcess(pSupervisor->hProcess, &dwExitCode);
+	PostMessage(pSupervisor->hNotifyWnd, pSupervisor->uNotifyMessage,
+		pSupervisor->wExitParam, (LPARAM)dwExitCode);
+}
+
+bool ProcessSupervisor::BeginRestart(LaunchFunc launch)
+{
+	if (isRestarting or !launch) { return false; }
+
+	if (!pRestartWork) {
+		pRestartWork = CreateThreadpoolWork(OnRestartWork, this, nullptr);
+		if (!pRestartWork) { return false; }
+	}
+
+	pfnLaunch = launch;
+	isRestarting = true;
+	SubmitThreadpoolWork(pRestartWork);
+	return true;
+}
+
+bool ProcessSupervisor::IsRestarting() const
+{
+	return isRestarting;
+}
+
+VOID CALLBACK ProcessSupervisor::OnRestartWork(PTP_CALLBACK_INSTANCE, PVOID pContext, PTP_WORK)
+{
+	ProcessSupervisor* pSupervisor = static_cast<ProcessSupervisor*>(pContext);
+
+	const DWORD dwProcessId = pSupervisor->pfnLaunch();
+	PostMessage(pSupervisor->hNotifyWnd, pSupervisor->uNotifyMessage,
+		pSupervisor->wRestartParam, (LPARAM)dwProcessId);
+}
+
+Supervision::Decision ProcessSupervisor::OnExited()
+{
+	Stop();
+	exitCount.Add();
+	return policy.OnExited(TimerScheduler::GetTimeMs());
+}
+
+Supervision::Decision ProcessSupervisor::OnRestartFailed()
+{
+	isRestarting = false;
+	return policy.OnRestartFailed(TimerScheduler::GetTimeMs());
+}
+
+Supervision::Decision ProcessSupervisor::Retry()
+{
+	// Counts as a fresh exit, so the recovery time runs from the request
+	policy.Reset();
+	return policy.OnExited(TimerScheduler::GetTimeMs());
+}
+
+bool ProcessSupervisor::IsRecovering() const
+{
+	return policy.IsRecovering();
+}
+
+void ProcessSupervisor::RegisterMetrics(Metrics::Registry& registry)
+{
+	exitCount = registry.AddCounter("tabtap_osk_exits_total", "Unexpected OSK process exits");
+	restartCount = registry.AddCounter("tabtap_osk_restarts_total", "OSK processes restarted after an exit");
+	recoveryTime = registry.AddHistogram("tabtap_osk_recovery_ms",
+		"Time from an OSK exit to a hooked OSK again", { 250, 500, 1000, 2000, 5000, 10000, 30000, 60000 });
+}
+
+
+
+// --- HandleMonitor ---
+
+HandleMonitor::HandleMonitor(const Resources::TrendDetector::Config& trend, bool isSoakRun,
+	uint64_t warmupMs, int64_t budgetSlack) :
+	gdiTrend{ trend },
+	userTrend{ trend },
+	gdiBudget{ warmupMs, budgetSlack },
+	userBudget{ warmupMs, budgetSlack },
+	isSoak{ isSoakRun }
+{}
+
+HandleMonitor::Report HandleMonitor::Sample(uint64_t nowMs)
+{
+	Report report{};
+	report.counts = Gdi::GetGuiCounts();
+
+	gdiTrend.Add(nowMs, report.counts.gdiObjects);
+	userTrend.Add(nowMs, report.counts.userObjects);
+	report.gdiPerHour = gdiTrend.GetSlopePerHour();
+	report.userPerHour = userTrend.GetSlopePerHour();
+
+	// Report each rise once; it may be reported again after it levels off
+	const bool isGdiLeak = gdiTrend.IsLeaking();
+	const bool isUserLeak = userTrend.IsLeaking();
+	report.isLeakFound = (isGdiLeak and !isGdiLeaking) or (isUserLeak and !isUserLeaking);
+	isGdiLeaking = isGdiLeak;
+	isUserLeaking = isUserLeak;
+	if (report.isLeakFound) { leakCount.Add(); }
+
+	if (isSoak) {
+		// Both budgets see every sample so both baselines are taken together
+		const bool isGdiWithin = gdiBudget.Check(nowMs, report.counts.gdiObjects);
+		const bool isUserWithin = userBudget.Check(nowMs, report.counts.userObjects);
+		report.isOverBudget = !isGdiWithin or !isUserWithin;
+	}
+
+	gdiObjects.Set(report.counts.gdiObjects);
+	userObjects.Set(report.counts.userObjects);
+	const Resources::Ledger& ledger = Resources::GetLedger();
+	for (size_t i{}; i < size_t(Resources::Kind::Count); ++i) {
+		liveHandles[i].Set(ledger.GetLive(Resources::Kind(i)));
+	}
+
+	return report;
+}
+
+bool HandleMonitor::IsSoak() const
+{
+	return isSoak;
+}
+
+void HandleMonitor::RegisterMetrics(Metrics::Registry& registry)
+{
+	static constexpr const char* LiveNames[] = {
+		"tabtap_live_dc_handles",
+		"tabtap_live_bitmap_handles",
+		"tabtap_live_pen_handles",
+		"tabtap_live_brush_handles",
+		"tabtap_live_font_handles",
+		"tabtap_live_icon_handles",
+		"tabtap_live_window_handles",
+	};
+	static_assert(std::size(LiveNames) == size_t(Resources::Kind::Count));
+
+	gdiObjects = registry.AddGauge("tabtap_gdi_objects", "GDI objects held by TabTap");
+	userObjects = registry.AddGauge("tabtap_user_objects", "USER objects held by TabTap");
+	for (size_t i{}; i < size_t(Resources::Kind::Count); ++i) {
+		liveHandles[i] = registry.AddGauge(LiveNames[i], "Handles of one kind owned by TabTap wrappers");
+	}
+	leakCount = registry.AddCounter("tabtap_handle_leaks_total", "Steady GDI or USER object rises reported as leaks");
+}
+
+
+
+// --- FocusWatcher ---
+
+// Forwards focus changes to the watcher; UI Automation calls it on its own threads
+class FocusWatcher::EventHandler : public IUIAutomationFocusChangedEventHandler
+{
+private:
+	std::atomic<ULONG> refCount{ 1 };
+	FocusWatcher* pWatcher{};
+
+public:
+	explicit EventHandler(FocusWatcher* pOwner) :
+		pWatcher{ pOwner }
+	{}
+
+	ULONG STDMETHODCALLTYPE AddRef() override
+	{
+		return ++refCount;
+	}
+
+	ULONG STDMETHODCALLTYPE Release() override
+	{
+		const ULONG count = --refCount;
+		if (!count) { delete this; }
+		return count;
+	}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppInterface) override
+	{
+		if (riid == __uuidof(IUnknown) or riid == __uuidof(IUIAutomationFocusChangedEventHandler)) {
+			*ppInterface = static_cast<IUIAutomationFocusChangedEventHandler*>(this);
+			AddRef();
+			return S_OK;
+		}
+		*ppInterface = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	HRESULT STDMETHODCALLTYPE HandleFocusChangedEvent(IUIAutomationElement* pSender) override
+	{
+		if (pSender) { pWatcher->OnFocusChanged(pSender); }
+		return S_OK;
+	}
+};
+
+FocusWatcher::~FocusWatcher()
+{
+	Stop();
+	if (hStopEvent) { CloseHandle(hStopEvent); }
+	if (hWakeEvent) { CloseHandle(hWakeEvent); }
+}
+
+FocusWatcher::FocusWatcher()
+{
+	// Manual-reset event, signaled on Stop
+	hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	// Auto-reset event, signaled per focus event
+	hWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+bool FocusWatcher::Start(HWND hWnd, UINT uMessage, WORD wCommand)
+{
+	if (!hStopEvent or !hWakeEvent or IsRunning()) { return false; }
+
+	hNotifyWnd = hWnd;
+	uNotifyMessage = uMessage;
+	wNotifyCommand = wCommand;
+	ResetEvent(hStopEvent);
+	{
+		// Focus from before this run decides nothing
+		std::lock_guard<std::mutex> lock{ policyMutex };
+		policy = AutoShow::Policy{ policy.GetConfig() };
+		cache.Clear();
+		rcFocus = {};
+	}
+
+	// The client lives on its own thread; wait until it has subscribed
+	std::promise<HRESULT> started{};
+	std::future<HRESULT> result = started.get_future();
+	watcher = std::thread{ [this, started = std::move(started)]() mutable { Run(&started); } };
+
+	if (FAILED(result.get())) {
+		watcher.join();
+		return false;
+	}
+	return true;
+}
+
+void FocusWatcher::Stop()
+{
+	if (!IsRunning()) { return; }
+
+	SetEvent(hStopEvent);
+	watcher.join();
+}
+
+bool FocusWatcher::IsRunning() const
+{
+	return watcher.joinable();
+}
+
+void FocusWatcher::Run(std::promise<HRESULT>* pStarted)
+{
+	// Event handlers run on UI Automation threads, never on a window's thread
+	HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+	if (FAILED(hr)) {
+		pStarted->set_value(hr);
+		return;
+	}
+
+	IUIAutomation* pAutomation{};
+	IUIAutomationCacheRequest* pRequest{};
+	EventHandler* pHandler = new EventHandler{ this };
+
+	hr = CoCreateInstance(__uuidof(CUIAutomation), NULL, CLSCTX_INPROC_SERVER,
+		__uuidof(IUIAutomation), reinterpret_cast<void**>(&pAutomation));
+	if (SUCCEEDED(hr)) { hr = pAutomation->CreateCacheRequest(&pRequest); }
+
+	// Everything the classifier reads arrives with the event instead of a call per property
+	static constexpr PROPERTYID CachedProperties[] = {
+		UIA_RuntimeIdPropertyId,
+		UIA_ProcessIdPropertyId,
+		UIA_ControlTypePropertyId,
+		UIA_IsValuePatternAvailablePropertyId,
+		UIA_IsTextPatternAvailablePropertyId,
+		UIA_ValueIsReadOnlyPropertyId,
+		UIA_BoundingRectanglePropertyId,
+	};
+	for (PROPERTYID propertyId : CachedProperties) {
+		if (SUCCEEDED(hr)) { hr = pRequest->AddProperty(propertyId); }
+	}
+	if (SUCCEEDED(hr)) { hr = pAutomation->AddFocusChangedEventHandler(pRequest, pHandler); }
+
+	const bool isSubscribed = SUCCEEDED(hr);
+	pStarted->set_value(hr);
+
+	const HANDLE handles[] = { hStopEvent, hWakeEvent };
+	while (isSubscribed) {
+		const uint64_t nowMs = TimerScheduler::GetTimeMs();
+		AutoShow::Action action{};
+		uint64_t deadlineMs{};
+		{
+			std::lock_guard<std::mutex> lock{ policyMutex };
+			action = policy.Take(nowMs);
+			deadlineMs = policy.GetDeadline();
+		}
+
+		if (action == AutoShow::Action::Show) {
+			showCount.Add();
+			PostMessage(hNotifyWnd, uNotifyMessage, MAKEWPARAM(wNotifyCommand, 1), 0);
+		}
+		else if (action == AutoShow::Action::Hide) {
+			hideCount.Add();
+			PostMessage(hNotifyWnd, uNotifyMessage, MAKEWPARAM(wNotifyCommand, 0), 0);
+		}
+
+		// Sleep until the next focus event or the pending decision
+		const DWORD timeoutMs = deadlineMs == AutoShow::NoDeadline ? INFINITE
+			: DWORD(std::min<uint64_t>(deadlineMs > nowMs ? deadlineMs - nowMs : 0, INFINITE - 1));
+		if (WaitForMultipleObjects(2, handles, FALSE, timeoutMs) == WAIT_OBJECT_0) { break; }
+	}
+
+	// Waits for handlers still running
+	if (isSubscribed) { pAutomation->RemoveFocusChangedEventHandler(pHandler); }
+
+	pHandler->Release();
+	if (pRequest) { pRequest->Release(); }
+	if (pAutomation) { pAutomation->Release(); }
+	CoUninitialize();
+}
+
+void FocusWatcher::OnFocusChanged(IUIAutomationElement* pElement)
+{
+	focusCount.Add();
+	const uint64_t nowMs = TimerScheduler::GetTimeMs();
+
+	// Runtime identifiers are unique among the elements present
+	uint64_t key{};
+	VARIANT runtimeId;
+	VariantInit(&runtimeId);
+	if (SUCCEEDED(pElement->GetCachedPropertyValue(UIA_RuntimeIdPropertyId, &runtimeId)) and
+		runtimeId.vt == (VT_ARRAY | VT_I4))
+	{
+		LONG lower{}, upper{};
+		void* pData{};
+		SafeArrayGetLBound(runtimeId.parray, 1, &lower);
+		SafeArrayGetUBound(runtimeId.parray, 1, &upper);
+		if (upper >= lower and SUCCEEDED(SafeArrayAccessData(runtimeId.parray, &pData))) {
+			key = AutoShow::HashRuntimeId(static_cast<const int32_t*>(pData), size_t(upper - lower + 1));
+			SafeArrayUnaccessData(runtimeId.parray);
+		}
+	}
+	VariantClear(&runtimeId);
+
+	AutoShow::Element element{};
+	bool isKnown{};
+	if (key) {
+		std::lock_guard<std::mutex> lock{ policyMutex };
+		isKnown = cache.Find(key, nowMs, &element);
+	}
+
+	if (isKnown) {
+		cacheHits.Add();
+	}
+	else {
+		// Outside the lock: a provider without cached values is asked across processes
+		cacheMisses.Add();
+		element = DescribeElement(pElement);
+	}
+
+	// Where the field is matters for placement only; it is read with every event
+	const AutoShow::Target target = AutoShow::Classify(element);
+	RECT rcBounds{};
+	if (target == AutoShow::Target::Text) {
+		pElement->get_CachedBoundingRectangle(&rcBounds);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ policyMutex };
+		if (key and !isKnown) { cache.Store(key, element, nowMs); }
+		policy.OnFocus(target, key, nowMs);
+		if (target != AutoShow::Target::Ignored) { rcFocus = rcBounds; }
+	}
+	SetEvent(hWakeEvent);
+}
+
+AutoShow::Element FocusWatcher::DescribeElement(IUIAutomationElement* pElement) const
+{
+	// Cached values came with the event; some providers leave them empty
+	auto ReadBool = [pElement](PROPERTYID propertyId) {
+		VARIANT value;
+		VariantInit(&value);
+		if (FAILED(pElement->GetCachedPropertyValue(propertyId, &value)) or value.vt != VT_BOOL) {
+			VariantClear(&value);
+			pElement->GetCurrentPropertyValue(propertyId, &value);
+		}
+		const bool isSet = value.vt == VT_BOOL and value.boolVal != VARIANT_FALSE;
+		VariantClear(&value);
+		return isSet;
+		};
+
+	AutoShow::Element element{};
+
+	int processId{};
+	if (FAILED(pElement->get_CachedProcessId(&processId))) {
+		pElement->get_CurrentProcessId(&processId);
+	}
+	if (DWORD(processId) == GetCurrentProcessId() or DWORD(processId) == keyboardProcessId.load()) {
+		element.traits |= AutoShow::TraitOwnWindow;
+		return element;
+	}
+
+	CONTROLTYPEID controlType{};
+	if (FAILED(pElement->get_CachedControlType(&controlType))) {
+		pElement->get_CurrentControlType(&controlType);
+	}
+	element.controlType = controlType;
+
+	// Only the text-taking control types need their patterns
+	if (controlType == UIA_EditControlTypeId or controlType == UIA_DocumentControlTypeId or
+		controlType == UIA_ComboBoxControlTypeId)
+	{
+		if (ReadBool(UIA_IsValuePatternAvailablePropertyId)) { element.traits |= AutoShow::TraitValuePattern; }
+		if (ReadBool(UIA_IsTextPatternAvailablePropertyId)) { element.traits |= AutoShow::TraitTextPattern; }
+		if ((element.traits & AutoShow::TraitValuePattern) and ReadBool(UIA_ValueIsReadOnlyPropertyId)) {
+			element.traits |= AutoShow::TraitReadOnly;
+		}
+	}
+
+	return element;
+}
+
+void FocusWatcher::SetKeyboardProcess(DWORD dwProcessId)
+{
+	keyboardProcessId.store(dwProcessId);
+}
+
+void FocusWatcher::OnUserToggle(bool isVisible)
+{
+	std::lock_guard<std::mutex> lock{ policyMutex };
+	policy.OnUserToggle(isVisible);
+}
+
+bool FocusWatcher::GetFocusRect(RECT* pRect)
+{
+	std::lock_guard<std::mutex> lock{ policyMutex };
+	if (!IsRunning() or IsRectEmpty(&rcFocus)) { return false; }
+	*pRect = rcFocus;
+	return true;
+}
+
+void FocusWatcher::RegisterMetrics(Metrics::Registry& registry)
+{
+	focusCount = registry.AddCounter("tabtap_focus_events_total", "UI Automation focus changes received");
+	cacheHits = registry.AddCounter("tabtap_focus_cache_hits_total", "Focused elements answered from the element cache");
+	cacheMisses = registry.AddCounter("tabtap_focus_cache_misses_total", "Focused elements looked up in their process");
+	showCount = registry.AddCounter("tabtap_auto_shows_total", "Keyboard shows posted for a focused text field");
+	hideCount = registry.AddCounter("tabtap_auto_hides_total", "Keyboard hides posted after focus left text");
+}
+
+
+
+// --- CaretTracker ---
+
+CaretTracker* CaretTracker::pInstance{};
+
+CaretTracker::~CaretTracker()
+{
+	Stop();
+	if (pInstance == this) { pInstance = nullptr; }
+}
+
+CaretTracker::CaretTracker(HWND hWnd, UINT uMessage, WPARAM wParam) :
+	hNotifyWnd{ hWnd },
+	uNotifyMessage{ uMessage },
+	wNotifyParam{ wParam }
+{
+	pInstance = this;
+}
+
+bool CaretTracker::Start()
+{
+	if (IsRunning()) { return true; }
+
+	// Caret moves arrive as location changes of OBJID_CARET; a focus change
+	// may put the caret somewhere else before it moves
+	hCaretHook = SetWinEventHook(
+		EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE,
+		NULL, OnCaretEvent, 0, 0,
+		WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+	hFocusHook = SetWinEventHook(
+		EVENT_OBJECT_FOCUS, EVENT_OBJECT_FOCUS,
+		NULL, OnCaretEvent, 0, 0,
+		WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+
+	if (!hCaretHook or !hFocusHook) {
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+void CaretTracker::Stop()
+{
+	if (hCaretHook) { UnhookWinEvent(hCaretHook); }
+	if (hFocusHook) { UnhookWinEvent(hFocusHook); }
+	hCaretHook = NULL;
+	hFocusHook = NULL;
+}
+
+bool CaretTracker::IsRunning() const
+{
+	return hCaretHook != NULL;
+}
+
+void CALLBACK CaretTracker::OnCaretEvent(HWINEVENTHOOK, DWORD dwEvent, HWND,
+	LONG idObject, LONG, DWORD, DWORD)
+{
+	if (!pInstance) { return; }
+	// Location changes also come for every window and the mouse cursor
+	if (dwEvent == EVENT_OBJECT_LOCATIONCHANGE and idObject != OBJID_CARET) { return; }
+
+	pInstance->eventCount.Add();
+	pInstance->Post();
+}
+
+void CaretTracker::Post()
+{
+	if (throttle.Post()) {
+		PostMessage(hNotifyWnd, uNotifyMessage, wNotifyParam, 0);
+	}
+}
+
+uint32_t CaretTracker::GetDelay(uint64_t nowMs) const
+{
+	return throttle.GetDelay(nowMs);
+}
+
+bool CaretTracker::Take(uint64_t nowMs)
+{
+	if (!throttle.Take(nowMs)) { return false; }
+	updateCount.Add();
+	return true;
+}
+
+bool CaretTracker::IsPending() const
+{
+	return throttle.IsPending();
+}
+
+bool CaretTracker::GetCaretRect(RECT* pRect)
+{
+	// The OSK never takes activation, so the caret belongs to the foreground thread
+	const DWORD dwThreadId = GetWindowThreadProcessId(GetForegroundWindow(), NULL);
+	GUITHREADINFO info{ sizeof(GUITHREADINFO) };
+	if (!dwThreadId or !GetGUIThreadInfo(dwThreadId, &info) or !info.hwndCaret) { return false; }
+
+	RECT rcCaret = info.rcCaret;
+	if (rcCaret.bottom <= rcCaret.top) { return false; }
+	// Carets are often 1 px wide or narrower
+	if (rcCaret.right <= rcCaret.left) { rcCaret.right = rcCaret.left + 1; }
+
+	MapWindowPoints(info.hwndCaret, NULL, reinterpret_cast<POINT*>(&rcCaret), 2);
+	*pRect = rcCaret;
+	return true;
+}
+
+void CaretTracker::RegisterMetrics(Metrics::Registry& registry)
+{
+	eventCount = registry.AddCounter("tabtap_caret_events_total", "Caret moves and focus changes seen while the OSK is up");
+	updateCount = registry.AddCounter("tabtap_caret_updates_total", "Frames that read the caret and placed the OSK");
+}
+
+
+
+// --- TimerScheduler ---
+
+TimerScheduler::~TimerScheduler()
+{
+	Detach();
+	if (hTimer) { CloseHandle(hTimer); }
+}
+
+uint64_t TimerScheduler::GetTimeMs()
+{
+	// GetTickCount64 moves in 16 ms steps, too coarse for animation frames
+	static const LONGLONG frequency = [] {
+		LARGE_INTEGER value{};
+		QueryPerformanceFrequency(&value);
+		return value.QuadPart;
+		}();
+
+	LARGE_INTEGER counter{};
+	QueryPerformanceCounter(&counter);
+	return uint64_t(counter.QuadPart / frequency * 1000 + counter.QuadPart % frequency * 1000 / frequency);
+}
+
+bool TimerScheduler::Attach(HWND hWnd)
+{
+	hTargetWnd = hWnd;
+	if (hTimer) { return true; }
+
+	// High resolution where supported (Windows 10 1803+), else the system tick
+	hTimer = CreateWaitableTimerEx(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!hTimer) { hTimer = CreateWaitableTimerEx(NULL, NULL, 0, TIMER_ALL_ACCESS); }
+
+	wheel = Timing::TimerWheel{ GetTimeMs() };
+	return hTimer != NULL;
+}
+
+void TimerScheduler::Detach()
+{
+	for (const Entry& entry : entries) { wheel.Cancel(entry.timer); }
+	entries.clear();
+	Arm();
+	hTargetWnd = NULL;
+}
+
+std::vector<TimerScheduler::Entry>::iterator TimerScheduler::Find(UINT id)
+{
+	return std::find_if(entries.begin(), entries.end(),
+		[id](const Entry& entry) { return entry.id == id; });
+}
+
+void TimerScheduler::Arm()
+{
+	if (!hTimer) { return; }
+
+	const uint64_t wakeupMs = wheel.GetNextWakeup();
+	if (wakeupMs == armedMs) { return; }
+	armedMs = wakeupMs;
+
+	// Nothing scheduled: the process sleeps until input arrives
+	if (wakeupMs == Timing::NoWakeup) {
+		CancelWaitableTimer(hTimer);
+		return;
+	}
+
+	const uint64_t nowMs = GetTimeMs();
+	LARGE_INTEGER dueTime{};
+	dueTime.QuadPart = -LONGLONG(wakeupMs > nowMs ? wakeupMs - nowMs : 0) * 10000;  // Relative, 100 ns units
+	if (!dueTime.QuadPart) { dueTime.QuadPart = -1; }
+	SetWaitableTimerEx(hTimer, &dueTime, 0, NULL, NULL, NULL, 0);
+}
+
+bool TimerScheduler::Set(UINT id, UINT delayMs, UINT toleranceMs, bool isRepeating)
+{
+	if (!hTimer) { return false; }
+
+	auto it = Find(id);
+	if (it == entries.end()) {
+		it = entries.insert(entries.end(), { id, Timing::InvalidTimer });
+	}
+	else {
+		wheel.Cancel(it->timer);
+	}
+
+	it->timer = wheel.Schedule(id, GetTimeMs() + delayMs, toleranceMs, isRepeating ? std::max(delayMs, 1u) : 0);
+	Arm();
+	return true;
+}
+
+void TimerScheduler::Kill(UINT id)
+{
+	auto it = Find(id);
+	if (it == entries.end()) { return; }
+
+	wheel.Cancel(it->timer);
+	entries.erase(it);
+	Arm();
+}
+
+bool TimerScheduler::IsSet(UINT id) const
+{
+	return std::any_of(entries.begin(), entries.end(),
+		[id](const Entry& entry) { return entry.id == id; });
+}
+
+HANDLE TimerScheduler::GetHandle() const
+{
+	return hTimer;
+}
+
+void TimerScheduler::Run()
+{
+	armedMs = Timing::NoWakeup;  // The synchronization timer reset itself
+
+	wheel.Advance(GetTimeMs(), [this](uint32_t tag, Timing::TimerId timer) {
+		// A one-shot timer is gone before its handler runs, so the handler may set it again
+		if (!wheel.IsPending(timer)) {
+			auto it = Find(tag);
+			if (it != entries.end() and it->timer == timer) { entries.erase(it); }
+		}
+		SendMessage(hTargetWnd, WM_TIMER, tag, 0);
+		});
+
+	Arm();
+}
+
+
+
+// --- LayeredBackend ---
+
+LayeredBackend::~LayeredBackend()
+{
+	FreeSurface();
+}
+
+LayeredBackend::LayeredBackend(HWND hWnd) :
+	hTargetWnd{ hWnd }
+{}
+
+bool LayeredBackend::Fail(DWORD dwCode)
+{
+	dwError = dwCode ? dwCode : ERROR_GEN_FAILURE;
+	return false;
+}
+
+void LayeredBackend::FreeSurface()
+{
+	if (hdcMem and hOldBmp) { SelectObject(hdcMem.Get(), hOldBmp); }
+
+	hdcMem.Reset();
+	hBitmap.Reset();
+	hOldBmp = NULL;
+	surface = {};
+}
+
+bool LayeredBackend::CreateSurface(const Geometry::Size& size)
+{
+	if (hBitmap and size.cx == surface.width and size.cy == surface.height) { return true; }
+	FreeSurface();
+
+	if (size.cx <= 0 or size.cy <= 0) { return Fail(ERROR_INVALID_PARAMETER); }
+
+	hdcMem.Reset(CreateCompatibleDC(NULL));
+	if (!hdcMem) { return Fail(GetLastError()); }
+
+	BITMAPINFO bmi{};
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = size.cx;
+	bmi.bmiHeader.biHeight = -size.cy; // Negative height for top-down bitmap
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	PVOID pvBits{};
+	hBitmap.Reset(CreateDIBSection(hdcMem.Get(), &bmi, DIB_RGB_COLORS, &pvBits, NULL, 0));
+	if (!hBitmap) {
+		const DWORD dwLastError = GetLastError();
+		FreeSurface();
+		return Fail(dwLastError);
+	}
+
+	hOldBmp = SelectObject(hdcMem.Get(), hBitmap.Get());
+	surface = { (Render::Pixel*)pvBits, size.cx, size.cy, size.cx };
+	return true;
+}
+
+bool LayeredBackend::Present(const Geometry::Point& pt, uint8_t opacity)
+{
+	if (!hBitmap) { return Fail(ERROR_INVALID_HANDLE); }
+
+	POINT ptDst = { pt.x, pt.y };
+	SIZE szWnd = { surface.width, surface.height };
+	POINT ptSrc{};
+	BLENDFUNCTION blendFunc = { AC_SRC_OVER, 0, opacity, AC_SRC_ALPHA };
+
+	if (!UpdateLayeredWindow(hTargetWnd, NULL, &ptDst, &szWnd,
+		hdcMem.Get(), &ptSrc, 0, &blendFunc, ULW_ALPHA))
+	{
+		return Fail(GetLastError());
+	}
+	return true;
+}
+
+bool LayeredBackend::BlendMask(const Render::MaskView& mask, const Geometry::Point& at, Render::Pixel color)
+{
+	if (!hBitmap) { return Fail(ERROR_INVALID_HANDLE); }
+
+	// Finish pending GDI work on the bitmap before writing its bits
+	GdiFlush();
+	Render::BlendMask(surface, mask, at, color);
+	return true;
+}
+
+uint32_t LayeredBackend::GetErrorCode() const
+{
+	return dwError;
+}
+
+
+// --- GdiPlusBackend ---
+
+bool GdiPlusBackend::Compose(const Render::Layer& layer)
+{
+	if (!hBitmap) { return Fail(ERROR_INVALID_HANDLE); }
+
+	if (layer.kind == Render::LayerKind::Rectangle) {
+		// GDI pen and brush, as the snap preview always drew
+		std::memset(surface.pPixels, 0, size_t(surface.width) * surface.height * sizeof(Render::Pixel));
+
+		const COLORREF frameColor = RGB((layer.frameColor >> 16) & 0xff, (layer.frameColor >> 8) & 0xff, layer.frameColor & 0xff);
+		const COLORREF fillColor = RGB((layer.fillColor >> 16) & 0xff, (layer.fillColor >> 8) & 0xff, layer.fillColor & 0xff);
+
+		Gdi::OwnedPen pen{ CreatePen(PS_INSIDEFRAME, layer.frameThickness, frameColor) };
+		Gdi::OwnedBrush brush{ layer.isHollow ? NULL : CreateSolidBrush(fillColor) };
+		if (!pen or (!layer.isHollow and !brush)) {
+			return Fail(GetLastError());
+		}
+
+		Gdi::ScopedSelect selectPen{ hdcMem.Get(), pen.Get() };
+		Gdi::ScopedSelect selectBrush{ hdcMem.Get(), brush ? (HGDIOBJ)brush.Get() : GetStockObject(NULL_BRUSH) };
+		const BOOL bDrawn = Rectangle(hdcMem.Get(), 0, 0, surface.width, surface.height);
+
+		return bDrawn ? true : Fail(GetLastError());
+	}
+
+	Gdiplus::Graphics graphics{ hdcMem.Get() };
+	Gdiplus::Status status = graphics.GetLastStatus();
+	if (status != Gdiplus::Ok) { return Fail(status); }
+
+	// Set rendering quality
+	graphics.SetCompositingMode(Gdiplus::CompositingModeSourceOver);
+	graphics.SetCompositingQuality(Gdiplus::CompositingQualityHighQuality);
+	graphics.SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
+	graphics.SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
+
+	// Clear with full transparency
+	graphics.Clear(Gdiplus::Color(0, 0, 0, 0));
+
+	// Wrap the premultiplied pixels without copying them
+	const Render::ImageView& image = layer.image;
+	Gdiplus::Bitmap source{ (INT)image.width, (INT)image.height, (INT)(image.stride * sizeof(Render::Pixel)),
+		PixelFormat32bppPARGB, (BYTE*)image.pPixels };
+
+	static_assert(sizeof(Render::ColorMatrix) == sizeof(Gdiplus::ColorMatrix), "ColorMatrix layout mismatch");
+	const Render::ColorMatrix* pMatrix = layer.pMatrix ? layer.pMatrix : &Render::IdentityMatrix;
+	attributes.SetColorMatrix((const Gdiplus::ColorMatrix*)pMatrix);
+
+	// Destination rectangle calculation
+	const Gdiplus::Rect destRect = layer.isMirrored
+		? Gdiplus::Rect(surface.width, 0, -surface.width, surface.height)  // Flipped horizontally
+		: Gdiplus::Rect(0, 0, surface.width, surface.height);  // Normal
+
+	status = graphics.DrawImage(
+		&source,
+		destRect,
+		layer.srcLeft, 0,                  // Source X, Y
+		surface.width, surface.height,     // Source Width, Height
+		Gdiplus::UnitPixel,
+		&attributes
+	);
+	return status == Gdiplus::Ok ? true : Fail(status);
+}
+
+
+// --- DibBackend ---
+
+bool DibBackend::Compose(const Render::Layer& layer)
+{
+	if (!hBitmap) { return Fail(ERROR_INVALID_HANDLE); }
+
+	// Finish pending GDI work on the bitmap before writing its bits
+	GdiFlush();
+	Render::Compose(surface, layer);
+	return true;
+}
+
+
+Render::IBackend* CreateRenderBackend(Render::BackendKind kind, HWND hWnd)
+{
+	switch (kind)
+	{
+	case Render::BackendKind::Dib:        return new DibBackend{ hWnd };
+	case Render::BackendKind::Headless:   return new Render::HeadlessBackend{};
+	default:                              return new GdiPlusBackend{ hWnd };
+	}
+}
+
+bool RasterizeGlyphAtlas(Glyphs::Atlas& atlas, uint32_t dpi, long cellHeightAt96)
+{
+	// Cell height includes the font's internal leading; no character is twice as wide
+	const long cellHeight = MulDiv(cellHeightAt96, (int)dpi, USER_DEFAULT_SCREEN_DPI);
+	const long cellWidth = cellHeight * 2;
+
+	Gdi::OwnedDC hdc{ CreateCompatibleDC(NULL) };
+	if (!hdc) { return false; }
+
+	BITMAPINFO bmi{};
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = cellWidth;
+	bmi.bmiHeader.biHeight = -cellHeight; // Negative height for top-down bitmap
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	PVOID pvBits{};
+	Gdi::OwnedBitmap bitmap{ CreateDIBSection(hdc.Get(), &bmi, DIB_RGB_COLORS, &pvBits, NULL, 0) };
+	Gdi::OwnedFont font{ CreateFont(cellHeight, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+		OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_SWISS, _T("Segoe UI")) };
+	if (!bitmap or !font) { return false; }
+
+	Gdi::ScopedSelect selectBitmap{ hdc.Get(), bitmap.Get() };
+	Gdi::ScopedSelect selectFont{ hdc.Get(), font.Get() };
+	SetTextColor(hdc.Get(), RGB(255, 255, 255));
+	SetBkMode(hdc.Get(), TRANSPARENT);
+
+	const Render::Pixel* pCell = (const Render::Pixel*)pvBits;
+	return atlas.Build(dpi, cellHeight, [&](char ch, long height, Glyphs::Bitmap* pBitmap) {
+		SIZE extent{};
+		if (!GetTextExtentPoint32A(hdc.Get(), &ch, 1, &extent)) { return false; }
+
+		// White on black with grey-scale anti-aliasing: the green channel is the coverage
+		GdiFlush();
+		std::memset(pvBits, 0, size_t(cellWidth) * size_t(height) * sizeof(Render::Pixel));
+		if (!TextOutA(hdc.Get(), 0, 0, &ch, 1)) { return false; }
+		GdiFlush();
+
+		pBitmap->width = std::min<long>(extent.cx, cellWidth);
+		pBitmap->advance = extent.cx;
+		pBitmap->coverage.resize(size_t(pBitmap->width) * size_t(height));
+		for (long y{}; y < height; ++y) {
+			const Render::Pixel* pRow = pCell + size_t(y) * size_t(cellWidth);
+			uint8_t* pCoverage = pBitmap->coverage.data() + size_t(y) * size_t(pBitmap->width);
+			for (long x{}; x < pBitmap->width; ++x) {
+				pCoverage[x] = uint8_t((pRow[x] >> 8) & 0xff);
+			}
+		}
+		return true;
+		});
+}
+
+
+
+// --- LayoutIndicator ---
+
+bool LayoutIndicator::BuildAtlas(uint32_t dpi)
+{
+	const bool isBuilt = RasterizeGlyphAtlas(atlas, dpi, 12);
+	if (isBuilt) { atlasBuilds.Add(); }
+	return isBuilt;
+}
+
+bool LayoutIndicator::SetLayout(HKL hNewLayout)
+{
+	if (hNewLayout == hLayout) { return false; }
+	hLayout = hNewLayout;
+
+	// The low word of a layout handle is its input language
+	TCHAR szName[LOCALE_NAME_MAX_LENGTH]{};
+	char szAscii[LOCALE_NAME_MAX_LENGTH]{};
+	const LCID lcid = MAKELCID(LOWORD((UINT_PTR)hNewLayout), SORT_DEFAULT);
+	if (hNewLayout and GetLocaleInfo(lcid, LOCALE_SISO639LANGNAME, szName, LOCALE_NAME_MAX_LENGTH)) {
+		for (size_t i{}; i + 1 < std::size(szAscii) and szName[i]; ++i) {
+			szAscii[i] = szName[i] < 0x80 ? char(szName[i]) : '?';
+		}
+	}
+
+	char newCode[Glyphs::MaxLabelChars + 1]{};
+	Glyphs::FormatLayoutCode(szAscii, newCode);
+	if (std::strcmp(newCode, code) == 0) { return false; }
+
+	std::memcpy(code, newCode, sizeof(code));
+	layoutChanges.Add();
+	return true;
+}
+
+const char* LayoutIndicator::GetCode() const
+{
+	return code;
+}
+
+bool LayoutIndicator::Draw(Render::IBackend& backend, const Geometry::Size& frame, uint32_t dpi)
+{
+	if (!code[0]) { return true; }
+	if ((!atlas.IsBuilt() or atlas.GetDpi() != dpi) and !BuildAtlas(dpi)) { return false; }
+
+	label.Update(atlas, code);
+	if (label.IsEmpty()) { return true; }
+
+	const long margin = std::max(1, MulDiv(1, (int)dpi, USER_DEFAULT_SCREEN_DPI));
+	Geometry::Point at{};
+	if (!Glyphs::PlaceLabel(frame, label.GetSize(), margin, &at)) { return true; }
+
+	// A soft shadow keeps the code readable on light skins
+	return backend.BlendMask(label.GetMask(), { at.x + margin, at.y + margin }, 0x80000000u) and
+		backend.BlendMask(label.GetMask(), at, Render::MakeOpaque(255, 255, 255));
+}
+
+void LayoutIndicator::RegisterMetrics(Metrics::Registry& registry)
+{
+	atlasBuilds = registry.AddCounter("tabtap_glyph_atlas_builds_total", "Glyph atlases rasterised for the layout indicator");
+	layoutChanges = registry.AddCounter("tabtap_layout_changes_total", "Keyboard layout codes shown on the tab");
+}
+
+
+
+// --- BuiltinKeyboard ---
+
+BuiltinKeyboard::~BuiltinKeyboard()
+{
+	// The window goes first; its last messages may still draw
+	hKeyboardWnd.Reset();
+	delete pRenderer;
+}
+
+BuiltinKeyboard::BuiltinKeyboard(Render::BackendKind kind) :
+	rendererKind{ kind }
+{}
+
+bool BuiltinKeyboard::Create(HINSTANCE hInstance, WNDPROC pfnWndProc, const KeyLayout::Layout& keys)
+{
+	WNDCLASSEX wc{ sizeof(WNDCLASSEX) };
+	wc.style = CS_DBLCLKS;
+	wc.lpfnWndProc = pfnWndProc;
+	wc.hInstance = hInstance;
+	wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wc.lpszClassName = WindowClass;
+	if (!RegisterClassEx(&wc) and GetLastError() != ERROR_CLASS_ALREADY_EXISTS) { return false; }
+
+	hKeyboardWnd.Reset(CreateWindowEx(
+		WS_EX_NOACTIVATE | WS_EX_TOPMOST | WS_EX_TOOLWINDOW | WS_EX_LAYERED,
+		WindowClass,
+		_T("TabTap Keyboard"),
+		WS_POPUP,
+		0, 0, 0, 0,
+		nullptr, nullptr,
+		hInstance, nullptr
+	));
+	if (!hKeyboardWnd) { return false; }
+
+	layout = keys;
+	pRenderer = CreateRenderBackend(rendererKind, hKeyboardWnd.Get());
+	Arrange(GetDpiForWindow(hKeyboardWnd.Get()));
+
+	// Bottom centre of the primary work area until the tab places it
+	RECT rcWork{};
+	SystemParametersInfo(SPI_GETWORKAREA, 0, &rcWork, 0);
+	SetWindowPos(hKeyboardWnd.Get(), NULL,
+		(rcWork.left + rcWork.right - size.cx) / 2, rcWork.bottom - size.cy,
+		size.cx, size.cy,
+		SWP_NOZORDER | SWP_NOACTIVATE
+	);
+	return true;
+}
+
+HWND BuiltinKeyboard::GetHandle() const
+{
+	return hKeyboardWnd.Get();
+}
+
+void BuiltinKeyboard::Arrange(uint32_t newDpi)
+{
+	dpi = newDpi;
+	const long keySize = MulDiv(KeySize, (int)dpi, USER_DEFAULT_SCREEN_DPI);
+	const long caption = isDockMode ? 0 : MulDiv(CaptionHeight, (int)dpi, USER_DEFAULT_SCREEN_DPI);
+	const long gap = std::max(1, MulDiv(KeyGap, (int)dpi, USER_DEFAULT_SCREEN_DPI));
+
+	size = {
+		long(layout.rowUnits) * keySize / KeyLayout::UnitsPerKey,
+		long(layout.rowCount) * keySize + caption
+	};
+	arrangement.Build(layout, { 0, caption, size.cx, size.cy }, gap);
+
+	if (atlas.GetDpi() != dpi) { RasterizeGlyphAtlas(atlas, dpi, LabelHeight); }
+	frames.Invalidate();
+}
+
+bool BuiltinKeyboard::ReadLabel(const KeyLayout::Key& key, bool isShifted,
+	char (&label)[KeyLayout::MaxLabelChars + 1]) const
+{
+	BYTE keyState[256]{};
+	if (isShifted) { keyState[VK_SHIFT] = 0x80; }
+
+	// Flag 4 leaves dead keys pending in the keyboard state alone
+	WCHAR szChars[4]{};
+	const UINT scanCode = MapVirtualKeyEx(key.vk, MAPVK_VK_TO_VSC, hLabelLayout);
+	const int count = ToUnicodeEx(key.vk, scanCode, keyState, szChars, (int)std::size(szChars), 4, hLabelLayout);
+
+	// The atlas only holds ASCII; other characters leave the key blank
+	if (count != 1 or szChars[0] < 0x20 or szChars[0] >= 0x80) { return false; }
+	label[0] = char(szChars[0]);
+	return true;
+}
+
+Geometry::Rect BuiltinKeyboard::GetCloseBox() const
+{
+	if (isDockMode) { return {}; }
+
+	const long caption = arrangement.GetBounds().top;
+	return { size.cx - 2 * caption, 0, size.cx, caption };
+}
+
+bool BuiltinKeyboard::Draw()
+{
+	if (!hKeyboardWnd or !pRenderer) { return false; }
+
+	const uint32_t windowDpi = GetDpiForWindow(hKeyboardWnd.Get());
+	if (windowDpi != dpi) { Arrange(windowDpi); }
+
+	// Labels follow the layout of the window being typed into
+	const HKL hForegroundLayout = GetKeyboardLayout(GetWindowThreadProcessId(GetForegroundWindow(), NULL));
+	if (hForegroundLayout != hLabelLayout) {
+		hLabelLayout = hForegroundLayout;
+		frames.Invalidate();
+	}
+
+	const uint64_t paints = frames.GetPaintCount();
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Image;
+	layer.image = frames.Get(size, latch.GetMask(), layout, arrangement, atlas, palette,
+		[this](const KeyLayout::Key& key, bool isShifted, char (&label)[KeyLayout::MaxLabelChars + 1]) {
+			return ReadLabel(key, isShifted, label);
+		});
+	if (frames.GetPaintCount() != paints) { framePaints.Add(); }
+	if (!layer.image.pPixels) { return false; }
+
+	if (!pRenderer->CreateSurface(size) or !pRenderer->Compose(layer)) { return false; }
+
+	if (pressedKey >= 0) {
+		const Geometry::Rect rect = arrangement.GetKeyRect(size_t(pressedKey));
+		if (!pRenderer->BlendMask(frames.GetKeyMask(rect), rect.TopLeft(), 0x60606060u)) { return false; }
+	}
+
+	const Geometry::Rect closeBox = GetCloseBox();
+	if (const Glyphs::Glyph* pGlyph = closeBox.IsEmpty() ? nullptr : atlas.Find('X')) {
+		const Geometry::Point at{
+			closeBox.left + (closeBox.Width() - pGlyph->width) / 2,
+			closeBox.top + (closeBox.Height() - atlas.GetHeight()) / 2
+		};
+		if (!pRenderer->BlendMask(atlas.GetMask(*pGlyph), at, palette.label)) { return false; }
+	}
+
+	RECT rcWnd{};
+	GetWindowRect(hKeyboardWnd.Get(), &rcWnd);
+	return pRenderer->Present({ rcWnd.left, rcWnd.top }, opacity);
+}
+
+bool BuiltinKeyboard::OnPointerDown(POINT pt)
+{
+	const int index = arrangement.HitTest({ pt.x, pt.y });
+	if (index < 0) { return false; }
+
+	{
+		Metrics::ScopedTimer timer{ injectTime };
+
+		KeyLayout::KeyEvent events[KeyLayout::MaxEvents]{};
+		const size_t count = latch.Press(layout.keys[index], events);
+
+		INPUT inputs[KeyLayout::MaxEvents]{};
+		for (size_t i{}; i < count; ++i) {
+			inputs[i].type = INPUT_KEYBOARD;
+			inputs[i].ki.wVk = events[i].vk;
+			inputs[i].ki.wScan = (WORD)MapVirtualKeyEx(events[i].vk, MAPVK_VK_TO_VSC, hLabelLayout);
+			inputs[i].ki.dwFlags = (events[i].isUp ? KEYEVENTF_KEYUP : 0) |
+				(events[i].isExtended ? KEYEVENTF_EXTENDEDKEY : 0);
+		}
+
+		// One call keeps the latched modifiers and the key together in the input stream
+		if (count and SendInput((UINT)count, inputs, sizeof(INPUT)) != count) {
+			injectErrors.Add();
+		}
+	}
+
+	keyPresses.Add();
+	pressedKey = index;
+	Draw();
+	return true;
+}
+
+void BuiltinKeyboard::OnPointerUp()
+{
+	if (pressedKey < 0) { return; }
+
+	pressedKey = -1;
+	Draw();
+}
+
+bool BuiltinKeyboard::IsOnCloseBox(POINT pt) const
+{
+	return GetCloseBox().Contains({ pt.x, pt.y });
+}
+
+void BuiltinKeyboard::BeginDrag()
+{
+	RECT rcWnd{};
+	POINT ptCursor{};
+	if (!GetWindowRect(hKeyboardWnd.Get(), &rcWnd) or !GetCursorPos(&ptCursor)) { return; }
+
+	ptDragOffset = { ptCursor.x - rcWnd.left, ptCursor.y - rcWnd.top };
+	isDragging = true;
+	SetCapture(hKeyboardWnd.Get());
+}
+
+void BuiltinKeyboard::Drag()
+{
+	POINT ptCursor{};
+	if (!isDragging or !GetCursorPos(&ptCursor)) { return; }
+
+	SetWindowPos(hKeyboardWnd.Get(), NULL,
+		ptCursor.x - ptDragOffset.x, ptCursor.y - ptDragOffset.y,
+		0, 0,
+		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+	);
+}
+
+void BuiltinKeyboard::EndDrag()
+{
+	if (!isDragging) { return; }
+
+	isDragging = false;
+	if (GetCapture() == hKeyboardWnd.Get()) { ReleaseCapture(); }
+}
+
+bool BuiltinKeyboard::IsDragging() const
+{
+	return isDragging;
+}
+
+void BuiltinKeyboard::Fade(bool isIncrease)
+{
+	opacity = isIncrease
+		? BYTE(std::min(0xff, opacity + OpacityStep))
+		: BYTE(std::max<int>(MinOpacity, opacity - OpacityStep));
+	if (IsWindowVisible(hKeyboardWnd.Get())) { Draw(); }
+}
+
+void BuiltinKeyboard::SetOpacity(BYTE value)
+{
+	opacity = std::max(MinOpacity, value);
+}
+
+BYTE BuiltinKeyboard::GetOpacity() const
+{
+	return opacity;
+}
+
+void BuiltinKeyboard::SetDockMode(bool enable)
+{
+	if (enable == isDockMode) { return; }
+
+	isDockMode = enable;
+	dpi = 0;  // Re-lay out with or without the caption strip on the next draw
+	if (IsWindowVisible(hKeyboardWnd.Get())) { Draw(); }
+}
+
+void BuiltinKeyboard::RegisterMetrics(Metrics::Registry& registry)
+{
+	keyPresses = registry.AddCounter("tabtap_keyboard_presses_total", "Keys pressed on the built-in keyboard");
+	injectErrors = registry.AddCounter("tabtap_keyboard_inject_errors_total", "Key presses SendInput did not fully inject");
+	framePaints = registry.AddCounter("tabtap_keyboard_frame_paints_total", "Built-in keyboard frames painted into the cache");
+	injectTime = registry.AddHistogram("tabtap_keyboard_inject_us",
+		"Built-in keyboard pointer down to SendInput return", { 50, 100, 250, 500, 1000, 2500, 5000, 10000 });
+}
+
+
+
+// --- GDIPlusData ---
+
+Result GDIPlusData::SetResult(Result res)
+{
+	result = std::move(res);
+	return std::move(res);
+}
+
+Result GDIPlusData::InitializeGDIPlus()
+{
+	if (!result) { return result; }
+	if (pToken) {
+		return SetResult({ Gdiplus::Status::Aborted,
+			_T("GDI+ already initialized") });
+	}
+
+	Gdiplus::GdiplusStartupInput gdiInput; // GDI+ startup parameters
+	Gdiplus::Status gdiStatus = GdiplusStartup(&pToken, &gdiInput, nullptr);
+
+	if (gdiStatus != Gdiplus::Ok) {
+		return SetResult({ gdiStatus,
+			_T("GDI+ initialization failed") });
+	}
+
+	return {};
+}
+
+void GDIPlusData::ShutdownGDIPlus()
+{
+	// Shutdown GDI+
+	if (pToken) { Gdiplus::GdiplusShutdown(pToken); }
+	// Ensures GDI+ remains active until all objects are destroyed
+}
+
+GDIPlusData::~GDIPlusData()
+{
+	DisableHotReload();
+	FreeImageResource();
+	ShutdownGDIPlus();
+}
+
+GDIPlusData::GDIPlusData()
+{
+	InitializeGDIPlus();
+	if (!result) { return; }
+
+	LoadApplicationImage();
+	if (!result) { return; }
+}
+
+std::shared_ptr<Gdiplus::Bitmap> GDIPlusData::DecodeImageStream(IStream* pStream, Gdiplus::Status* pStatus)
+{
+	// Decode the source image
+	Gdiplus::Bitmap source{ pStream };
+	*pStatus = source.GetLastStatus();
+	if (*pStatus != Gdiplus::Ok) { return nullptr; }
+
+	const UINT width = source.GetWidth();
+	const UINT height = source.GetHeight();
+	if (!width or !height) {
+		*pStatus = Gdiplus::Status::InvalidParameter;
+		return nullptr;
+	}
+
+	// Pre-render into a premultiplied bitmap detached from the stream
+	auto spFrame = std::make_shared<Gdiplus::Bitmap>(
+		(INT)width, (INT)height, PixelFormat32bppPARGB);
+	*pStatus = spFrame->GetLastStatus();
+	if (*pStatus != Gdiplus::Ok) { return nullptr; }
+
+	Gdiplus::Graphics graphics{ spFrame.get() };
+	graphics.SetCompositingMode(Gdiplus::CompositingModeSourceCopy);
+	*pStatus = graphics.DrawImage(&source, 0, 0, (INT)width, (INT)height);
+	if (*pStatus != Gdiplus::Ok) { return nullptr; }
+
+	return spFrame;
+}
+
+std::shared_ptr<Gdiplus::Bitmap> GDIPlusData::DecodeImageFile(LPCTSTR cszImagePath, Gdiplus::Status* pStatus)
+{
+	*pStatus = Gdiplus::Status::FileNotFound;
+
+	// Read the whole file so GDI+ does not keep it locked
+	HANDLE hFile = CreateFile(cszImagePath, GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) { return nullptr; }
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(hFile, &fileSize) or
+		fileSize.QuadPart <= 0 or fileSize.QuadPart > MAXDWORD)
+	{
+		CloseHandle(hFile);
+		return nullptr;
+	}
+
+	std::unique_ptr<BYTE[]> buffer{ new BYTE[(size_t)fileSize.QuadPart] };
+	DWORD dwBytesRead{};
+	BOOL bResult = ReadFile(hFile, buffer.get(), (DWORD)fileSize.QuadPart, &dwBytesRead, NULL);
+	CloseHandle(hFile);
+
+	if (!bResult or dwBytesRead != (DWORD)fileSize.QuadPart) { return nullptr; }
+
+	// Create memory stream from the file data
+	IStream* stream = SHCreateMemStream(buffer.get(), dwBytesRead);
+	if (!stream) {
+		*pStatus = Gdiplus::Status::OutOfMemory;
+		return nullptr;
+	}
+
+	std::shared_ptr<Gdiplus::Bitmap> spFrame = DecodeImageStream(stream, pStatus);
+	stream->Release();  // Release COM object when done
+
+	return spFrame;
+}
+
+Result GDIPlusData::GetApplicationImagePath(LPTSTR szBuffer, size_t cchBuffer)
+{
+	// Next to the executable, whatever the working directory
+	if (!GetAppFilePath(_T("TabTap.png"), szBuffer, cchBuffer)) {
+		return { GetLastError(),
+			_T("Failed to get image path") };
+	}
+
+	return {};
+}
+
+Result GDIPlusData::LoadImageFile(LPCTSTR cszImagePath)
+{
+	Gdiplus::Status status{};
+	std::shared_ptr<Gdiplus::Bitmap> spFrame = DecodeImageFile(cszImagePath, &status);
+
+	// Check image status
+	if (!spFrame) {
+		return SetResult({ status,
+			_T("Image loading failed") });
+	}
+
+	imageFrames.Publish(std::move(spFrame));
+	return {};
+}
+
+Result GDIPlusData::LoadImageByteArray()
+{
+	// Create memory stream from embedded data
+	IStream* stream = SHCreateMemStream(PNG_DATA, PNG_DATA_SIZE);
+	if (!stream) {
+		return SetResult({ ERROR_INVALID_DATA,
+			_T("Failed to create memory stream") });
+	}
+
+	// Load image from memory stream
+	Gdiplus::Status status{};
+	std::shared_ptr<Gdiplus::Bitmap> spFrame = DecodeImageStream(stream, &status);
+	stream->Release();  // Release COM object when done
+
+	// Check loading status
+	if (!spFrame) {
+		return SetResult({ status,
+			_T("Failed to load image from memory") });
+	}
+
+	imageFrames.Publish(std::move(spFrame));
+	return {};
+}
+
+Result GDIPlusData::LoadApplicationImage()
+{
+	if (!result) { return result; }
+
+	TCHAR szBuffer[MAX_PATH]{}; // Buffer for the file path
+
+	Result pathResult = GetApplicationImagePath(szBuffer, MAX_PATH);
+	if (!pathResult) { return SetResult(pathResult); }
+
+	// Verify file existence
+	if (GetFileAttributes(szBuffer) == INVALID_FILE_ATTRIBUTES) {
+		return LoadImageByteArray();
+	}
+
+	return LoadImageFile(szBuffer);
+}
+
+void GDIPlusData::FreeImageResource()
+{
+	imageFrames.Reset(); // Free the image resource
+}
+
+std::shared_ptr<Gdiplus::Bitmap> GDIPlusData::GetImage(uint64_t* pGeneration) const
+{
+	return imageFrames.Acquire(pGeneration);
+}
+
+Result GDIPlusData::EnableHotReload(HWND hNotifyWnd, UINT uMsg, WPARAM wParam)
+{
+	if (spReloader) { return {}; }
+
+	TCHAR szBuffer[MAX_PATH]{}; // Buffer for the file path
+
+	Result pathResult = GetApplicationImagePath(szBuffer, MAX_PATH);
+	if (!pathResult) { return pathResult; }
+
+	spReloader = std::make_unique<SkinReloader<Gdiplus::Bitmap>>(imageFrames, std::make_unique<DirectoryWatcher>());
+
+	bool bStarted = spReloader->Start(szBuffer,
+		// Decode on the reloader thread; invalid files return null
+		[](const std::filesystem::path& path) {
+			Gdiplus::Status status{};
+			return DecodeImageFile(path.c_str(), &status);
+		},
+		// Redraw with the new frame on the UI thread
+		[hNotifyWnd, uMsg, wParam](bool isSwapped) {
+			if (isSwapped) { PostMessage(hNotifyWnd, uMsg, wParam, 0); }
+		}
+	);
+
+	if (!bStarted) {
+		DisableHotReload();
+		return { ERROR_INVALID_HANDLE,
+			_T("Failed to watch image directory") };
+	}
+
+	return {};
+}
+
+void GDIPlusData::DisableHotReload()
+{
+	spReloader.reset();  // Joins the watcher and decoder threads
+}
+
+Result GDIPlusData::GetResult() const
+{
+	return result;
+}
+
+
+
+// --- SkinData ---
+
+Result SkinData::SetResult(Result res)
+{
+	result = std::move(res);
+	return std::move(res);
+}
+
+SkinData::~SkinData()
+{
+	Unload();
+}
+
+SkinData::SkinData() {}
+
+Result SkinData::Load(LPCTSTR cszSkinPath)
+{
+	Unload();
+	result = {};
+
+	hFile = CreateFile(cszSkinPath, GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		hFile = NULL;
+		return SetResult({ GetLastError(),
+			_T("Failed to open skin file") });
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(hFile, &fileSize) or
+		fileSize.QuadPart < (LONGLONG)sizeof(Skin::Header) or
+		fileSize.QuadPart > MAXDWORD)
+	{
+		Unload();
+		return SetResult({ ERROR_INVALID_DATA,
+			_T("Invalid skin file size") });
+	}
+
+	hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMapping) {
+		DWORD dwErr = GetLastError();
+		Unload();
+		return SetResult({ dwErr,
+			_T("Failed to map skin file") });
+	}
+
+	pMappedView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!pMappedView) {
+		DWORD dwErr = GetLastError();
+		Unload();
+		return SetResult({ dwErr,
+			_T("Failed to map skin file view") });
+	}
+
+	// Validation only walks the header and frame table; pixels stay untouched
+	view = Skin::View{ pMappedView, (size_t)fileSize.QuadPart };
+	if (!view.IsValid()) {
+		Unload();
+		return SetResult({ ERROR_INVALID_DATA,
+			_T("Skin Error"), _T("Skin file is malformed") });
+	}
+
+	return {};
+}
+
+void SkinData::Unload()
+{
+	FreeFrameBitmaps();
+	view = {};
+	frameTable = {};
+
+	if (pMappedView) { UnmapViewOfFile(pMappedView); }
+	if (hMapping) { CloseHandle(hMapping); }
+	if (hFile) { CloseHandle(hFile); }
+	pMappedView = nullptr;
+	hMapping = NULL;
+	hFile = NULL;
+}
+
+bool SkinData::IsLoaded() const
+{
+	return view.IsValid();
+}
+
+void SkinData::FreeFrameBitmaps()
+{
+	for (auto& row : frameBitmaps) {
+		for (Gdi::OwnedBitmap& bitmap : row) {
+			bitmap.Reset();
+		}
+	}
+}
+
+void SkinData::SetDpi(UINT dpi)
+{
+	if (!IsLoaded() or frameTable.GetDpi() == dpi) { return; }
+
+	FreeFrameBitmaps();
+	frameTable.Build(view, (uint16_t)dpi);
+}
+
+HBITMAP SkinData::CreateFrameBitmap(const Skin::Frame& frame, bool isMirrored)
+{
+	BITMAPINFO bmi{};
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = frame.width;
+	bmi.bmiHeader.biHeight = -(LONG)frame.height; // Top-down, as stored
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	// The frame is copied once: backing the DIB with the file mapping itself
+	// would need the skin file opened for writing
+	PVOID pvBits{};
+	HBITMAP hBitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &pvBits, NULL, 0);
+	if (!hBitmap) {
+		SetResult({ GetLastError(),
+			_T("Failed to create skin frame bitmap") });
+		return NULL;
+	}
+
+	// Pixels are already premultiplied; flip only for skins without a mirrored set
+	const bool needsFlip = isMirrored and !(frame.flags & Skin::FrameMirrored);
+	const size_t rowSize = (size_t)frame.width * 4;
+
+	for (UINT y{}; y < frame.height; ++y) {
+		const BYTE* src = frame.pixels + (size_t)y * frame.stride;
+		BYTE* dst = (BYTE*)pvBits + y * rowSize;
+
+		if (!needsFlip) {
+			memcpy(dst, src, rowSize);
+			continue;
+		}
+		for (UINT x{}; x < frame.width; ++x) {
+			memcpy(dst + x * 4, src + (frame.width - 1 - x) * 4, 4);
+		}
+	}
+
+	return hBitmap;
+}
+
+HBITMAP SkinData::GetFrameBitmap(Skin::State state, bool isMirrored, Skin::Frame* pFrame)
+{
+	if (!IsLoaded() or !frameTable.GetDpi()) { return NULL; }
+
+	const Skin::Frame& frame = frameTable.Get(state, isMirrored);
+	if (!frame) { return NULL; }
+
+	// Each state is materialized once per DPI; later switches reuse it
+	Gdi::OwnedBitmap& bitmap = frameBitmaps[isMirrored ? 1 : 0][size_t(state)];
+	if (!bitmap) { bitmap.Reset(CreateFrameBitmap(frame, isMirrored)); }
+
+	if (pFrame) {
+		*pFrame = frame;
+		// Report the orientation actually stored in the bitmap
+		if (isMirrored) { pFrame->flags |= Skin::FrameMirrored; }
+	}
+
+	return bitmap.Get();
+}
+
+Result SkinData::GetResult() const
+{
+	return result;
+}
+
+
+
+// --- TrayIconManager ---
+
+Result TrayManager::SetResult(Result res)
+{
+	result = std::move(res);
+	return std::move(res);
+}
+
+TrayManager::~TrayManager()
+{
+	DeleteTrayIcon();
+	FreeIconResource();
+	DestroyTrayMenu();
+	delete pTrayAdapter;
+}
+
+TrayManager::TrayManager(ITrayAdapter* pAdapter)
+{
+	if (!pAdapter) { return; }
+
+	pTrayAdapter = pAdapter;
+	SetupTrayIcon();
+}
+
+Result TrayManager::SetupTrayIcon()
+{
+	Result result = pTrayAdapter->SetupTrayIcon(trayData);
+	if (trayData.hIcon != trayIcon.Get()) { trayIcon.Reset(trayData.hIcon); }
+	if (!result) { return SetResult(result); }
+
+	if (!trayData.hWnd) {
+		return SetResult({ 1001,
+			_T("Invalid Handle"), _T("Window handle is null") });
+	}
+
+	return {};
+}
+
+void TrayManager::DeleteTrayIcon()
+{
+	Shell_NotifyIcon(NIM_DELETE, &trayData);
+}
+
+void TrayManager::GetIconResource(HICON hIcon)
+{
+	trayIcon.Reset(hIcon);
+	trayData.hIcon = trayIcon.Get();
+}
+
+void TrayManager::FreeIconResource()
+{
+	trayIcon.Reset();
+	trayData.hIcon = NULL;
+}
+
+Result TrayManager::CreateTrayMenu()
+{
+	return SetResult(pTrayAdapter->CreateTrayMenu(hTrayMenu));
+}
+
+Result TrayManager::DestroyTrayMenu()
+{
+	if (hTrayMenu) {
+		if (!DestroyMenu(hTrayMenu)) {
+			return SetResult({ GetLastError(),
+				_T("Failed to destroy pop-up menu") });
+		}
+		hTrayMenu = NULL;
+	}
+
+	return {};
+}
+
+Result TrayManager::TrackTrayMenu(const POINT& ptAnchor)
+{
+	if (!hTrayMenu) {
+		return SetResult({ 1002,
+			_T("Invalid Handle"), _T("Menu handle is null") });
+	}
+
+	BOOL bResult{};
+
+	bResult = SetForegroundWindow(trayData.hWnd);
+	if (!bResult) {
+		DWORD dwErr = GetLastError();
+		return SetResult({ dwErr,
+			_T("Failed to set foreground window") });
+	}
+
+	bResult = TrackPopupMenu(
+		hTrayMenu,
+		TPM_LEFTBUTTON,
+		ptAnchor.x, ptAnchor.y,
+		0, trayData.hWnd, NULL
+	);
+	if (!bResult) {
+		DWORD dwErr = GetLastError();
+		return SetResult({ dwErr,
+			_T("Failed to track popup menu") });
+	}
+
+	return {};
+}
+
+Result TrayManager::HandleTrayRightClick()
+{
+	POINT ptCursor{};
+	if (!GetCursorPos(&ptCursor)) {
+		DWORD dwErr = GetLastError();
+		return SetResult({ dwErr,
+			_T("Failed to get cursor position") });
+	}
+
+	return ShowMenuAt(ptCursor);
+}
+
+Result TrayManager::ShowMenuAt(const POINT& ptAnchor)
+{
+	menuCount.Add();
+	if (!CreateTrayMenu() or
+		!TrackTrayMenu(ptAnchor) or
+		!DestroyTrayMenu())
+	{
+		menuErrors.Add();
+		return result;
+	}
+
+	return {};
+}
+
+void TrayManager::RegisterMetrics(Metrics::Registry& registry)
+{
+	menuCount = registry.AddCounter("tabtap_tray_menus_total", "Tray menus shown");
+	menuErrors = registry.AddCounter("tabtap_tray_menu_errors_total", "Tray menus that failed to show");
+}
+
+Result TrayManager::GetResult() const
+{
+	return result;
+}
+
+void TrayManager::ClearResult()
+{
+	result = {};
+}
+
+
+
+// --- EdgeSnapping ---
+
+Result EdgeSnapData::SetResult(Result res)
+{
+	result = std::move(res);
+	return std::move(res);
+}
+
+void EdgeSnapData::CreatePreviewWindow()
+{
+	static LPCTSTR PREVIEW_CLASS = _T("EdgeSnapPreviewClass");
+	// Register window class once
+	static bool registered{};
+
+	if (!registered) {
+		WNDCLASSEX wc = { sizeof(WNDCLASSEX) };
+		wc.lpfnWndProc = DefWindowProc;
+		wc.hInstance = GetModuleHandle(nullptr);
+		wc.lpszClassName = PREVIEW_CLASS;
+		RegisterClassEx(&wc);
+		registered = true;
+	}
+
+	hPreviewWnd.Reset(CreateWindowEx(
+		WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOPMOST | WS_EX_NOACTIVATE,
+		PREVIEW_CLASS,
+		nullptr,
+		WS_POPUP,
+		0, 0, 0, 0,
+		nullptr, nullptr,
+		GetModuleHandle(nullptr), nullptr
+	));
+
+	// The renderer belongs to the window it presents to
+	delete pRenderer;
+	pRenderer = nullptr;
+	if (hPreviewWnd) {
+		pRenderer = CreateRenderBackend(rendererKind, hPreviewWnd.Get());
+	}
+}
+
+void EdgeSnapData::UpdatePreviewWindow()
+{
+	// Calculate preview area based on edge
+	const RECT& workArea = WorkAreaManager::GetWorkArea();
+	RECT previewRect;
+
+	switch (snapEdge)
+	{
+	case ScreenEdge::Left:
+	{
+		previewRect = { workArea.left, workArea.top,
+						workArea.left + PreviewSize, workArea.bottom };
+		break;
+	}
+	case ScreenEdge::Right:
+	{
+		previewRect = { workArea.right - PreviewSize, workArea.top,
+						workArea.right, workArea.bottom };
+		break;
+	}
+	case ScreenEdge::Top:
+	{
+		previewRect = { workArea.left, workArea.top,
+						workArea.right, workArea.top + PreviewSize };
+		break;
+	}
+	case ScreenEdge::Bottom:
+	{
+		previewRect = { workArea.left, workArea.bottom - PreviewSize,
+						workArea.right, workArea.bottom };
+		break;
+	}
+	default:
+	{
+		const POINT relativePos = dragTracker.GetRelativePosition();
+		const POINT lead = dragPredictor.GetOffset();
+
+		previewRect = {
+			rcTargetRect.left + relativePos.x + lead.x,
+			rcTargetRect.top + relativePos.y + lead.y,
+			rcTargetRect.right + relativePos.x + lead.x,
+			rcTargetRect.bottom + relativePos.y + lead.y
+		};
+		break;
+	}
+	}
+
+	// Position and show preview window
+	SetWindowPos(
+		hPreviewWnd.Get(), HWND_TOPMOST,
+		previewRect.left,
+		previewRect.top,
+		previewRect.right - previewRect.left,
+		previewRect.bottom - previewRect.top,
+		SWP_NOZORDER | SWP_NOACTIVATE
+	);
+
+	DrawPreview();
+	ShowWindow(hPreviewWnd.Get(), SW_SHOWNOACTIVATE);
+}
+
+Result EdgeSnapData::DrawPreview()
+{
+	// Validate preview window handle
+	if (!hPreviewWnd || !IsWindow(hPreviewWnd.Get()) || !pRenderer) {
+		return SetResult({ ERROR_INVALID_HANDLE,
+			_T("Window Error"), _T("Preview window handle is invalid") });
+	}
+
+	// Retrieve window dimensions
+	RECT rect;
+	if (!GetWindowRect(hPreviewWnd.Get(), &rect)) {
+		return SetResult({ GetLastError(),
+			_T("Failed to get window dimensions") });
+	}
+
+	int width = rect.right - rect.left;
+	int height = rect.bottom - rect.top;
+	if (width <= 0 || height <= 0) {
+		return SetResult({ 1,
+			_T("Invalid Size"), _T("Window has non-positive dimensions") });
+	}
+
+	// Frame while dragging freely, filled once an edge is selected
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	layer.frameColor = ToGdiPixel(RGB(0, 120, 215));
+	layer.frameThickness = PreviewFrameSize;
+	uint8_t opacity = 255;
+
+	if (IsSnapEdge(ScreenEdge::None)) {
+		layer.isHollow = true;
+	}
+	else {
+		layer.fillColor = pSnapAdapter->IsValidSnapEdge(GetSnapEdge())
+			? ToGdiPixel(RGB(0, 120, 215))
+			: ToGdiPixel(RGB(215, 0, 0));
+		opacity = 150;
+	}
+
+	if (!pRenderer->CreateSurface({ width, height }) or !pRenderer->Compose(layer)) {
+		return SetResult({ pRenderer->GetErrorCode(),
+			_T("Failed to draw preview rectangle") });
+	}
+
+	// Update the layered window with the new bitmap
+	if (!pRenderer->Present({ rect.left, rect.top }, opacity)) {
+		return SetResult({ pRenderer->GetErrorCode(),
+			_T("Failed to update layered window") });
+	}
+
+	previewDraws.Add();
+	return {};
+}
+
+EdgeSnapData::~EdgeSnapData()
+{
+	delete pRenderer;
+	hPreviewWnd.Reset();
+	if (pSnapAdapter) {
+		delete pSnapAdapter;
+	}
+}
+
+EdgeSnapData::EdgeSnapData(Render::BackendKind kind) :
+	rendererKind{ kind }
+{}
+
+ScreenEdge EdgeSnapData::GetSnapEdge() const
+{
+	return snapEdge;
+}
+
+bool EdgeSnapData::IsSnapEdge(const ScreenEdge& edge)
+{
+	return edge == GetSnapEdge();
+}
+
+bool EdgeSnapData::Enable(ISnapAdapter* pAdapter)
+{
+	if (!pAdapter) { return false; }
+
+	HWND hTargetWnd = pAdapter->GetTargetWindow();
+	if (!hTargetWnd) { return false; }
+
+	GetWindowRect(hTargetWnd, &rcTargetRect);
+	dragTracker.BeginDrag();
+	dragPredictor.Enable();
+	pSnapAdapter = pAdapter;
+	isEnabled = true;
+
+	// Update work area to avoid taskbar during snap
+	WorkAreaManager::Refresh();
+
+	return true;
+}
+
+void EdgeSnapData::Disable()
+{
+	const POINT relativePos = dragTracker.GetRelativePosition();
+	POINT ptDest = {
+		rcTargetRect.left + relativePos.x,
+		rcTargetRect.top + relativePos.y
+	};
+
+	if (IsSnapEdge(ScreenEdge::None)) {
+		pSnapAdapter->OnSnapEdgeNone(ptDest);
+	}
+	else if (pSnapAdapter->IsValidSnapEdge(GetSnapEdge())) {
+		snapCount.Add();
+		pSnapAdapter->OnSnapSuccess(
+			GetSnapEdge(), ptDest
+		);
+	}
+	else {
+		rejectCount.Add();
+		pSnapAdapter->OnSnapRejected(
+			GetSnapEdge(), ptDest
+		);
+	}
+
+	delete pRenderer;
+	pRenderer = nullptr;
+	hPreviewWnd.Reset();
+	if (pSnapAdapter) {
+		delete pSnapAdapter;
+		pSnapAdapter = nullptr;
+	}
+	isEnabled = false;
+	isPreviewEnabled = false;
+	snapEdge = ScreenEdge::None;
+	rcTargetRect = {};
+	dragTracker.EndDrag();
+	dragPredictor.Disable();
+}
+
+bool EdgeSnapData::IsEnabled() const
+{
+	return isEnabled;
+}
+
+bool EdgeSnapData::IsPreviewEnabled() const
+{
+	return isPreviewEnabled;
+}
+
+bool EdgeSnapData::OnMouseMove()
+{
+	if (isEnabled) {
+		dragTracker.Update();
+		const POINT& cursorPos = dragTracker.GetCursorPosition();
+
+		if (isPreviewEnabled) {
+			// Determine snap edge based on cursor position
+			snapEdge = ToScreenEdge(TabLayout::DetectSnapEdge(
+				ToGeometry(cursorPos),
+				ToGeometry(WorkAreaManager::GetWorkArea()),
+				ToLayoutEdge(pSnapAdapter->GetSnapEdge())));
+
+			UpdatePreviewWindow();
+		}
+		// Enable preview only if cursor leaves the window
+		else if (!PtInRect(&rcTargetRect, cursorPos)) {
+			if (!hPreviewWnd) { CreatePreviewWindow(); }
+			isPreviewEnabled = true;
+		}
+
+		return true;
+	}
+	return false;
+}
+
+void EdgeSnapData::RegisterMetrics(Metrics::Registry& registry)
+{
+	snapCount = registry.AddCounter("tabtap_snaps_total", "Drags dropped on a valid edge");
+	rejectCount = registry.AddCounter("tabtap_snap_rejects_total", "Drags dropped on a rejected edge");
+	previewDraws = registry.AddCounter("tabtap_snap_preview_draws_total", "Snap preview frames drawn");
+}
+
+
+
+// --- AnimationData ---
+
+AnimationData::~AnimationData() {}
+
+AnimationData::AnimationData() {}
+
+bool AnimationData::Enable(HWND hWnd, const POINT& ptDest)
+{
+	if (isEnabled) { return false; }
+
+	// Update work area to avoid taskbar
+	WorkAreaManager::Refresh();
+
+	RECT targetRect;
+	if (!GetWindowRect(hWnd, &targetRect)) { return false; }
+
+	ptCurrentPoint = { targetRect.left, targetRect.top };
+	ptTargetPoint = ToPoint(TabLayout::ClampPoint(
+		ToGeometry(ptDest),
+		ToGeometry(targetRect).GetSize(),
+		ToGeometry(WorkAreaManager::GetWorkArea())
+	));
+	hAnimatedWnd = hWnd;
+	isEnabled = true;
+	animationCount.Add();
+
+	return true;
+}
+
+void AnimationData::Disable()
+{
+	isEnabled = false;
+	hAnimatedWnd = NULL;
+	ptCurrentPoint = {};
+	ptTargetPoint = {};
+}
+
+void AnimationData::Finish()
+{
+	if (!isEnabled or !hAnimatedWnd) { return; }
+
+	SetWindowPos(
+		hAnimatedWnd, NULL,
+		ptTargetPoint.x, ptTargetPoint.y,
+		0, 0,
+		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+	);
+	Disable();
+}
+
+bool AnimationData::IsEnabled() const
+{
+	return isEnabled;
+}
+
+bool AnimationData::Update()
+{
+	if (!isEnabled or !hAnimatedWnd) { return false; }
+
+	// Calculate remaining distance for BOTH axes
+	const POINT ptRemaining = {
+		ptTargetPoint.x - ptCurrentPoint.x,
+		ptTargetPoint.y - ptCurrentPoint.y
+	};
+
+	// Check if animation is complete (both axes)
+	if (ptRemaining.x == 0 and ptRemaining.y == 0) {
+		Disable();
+		return false;
+	}
+
+	ptCurrentPoint = ToPoint(TabLayout::StepToward(
+		ToGeometry(ptCurrentPoint), ToGeometry(ptTargetPoint)));
+
+	// Move the window to the new position
+	const BOOL bMoved = SetWindowPos(
+		hAnimatedWnd, NULL,
+		ptCurrentPoint.x, ptCurrentPoint.y,
+		0, 0,
+		SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+	);
+	stepCount.Add();
+	if (!bMoved) { moveErrors.Add(); }
+
+	// Continue if either axis hasn't reached target
+	return true;
+}
+
+void AnimationData::RegisterMetrics(Metrics::Registry& registry)
+{
+	animationCount = registry.AddCounter("tabtap_animations_total", "Window animations started");
+	stepCount = registry.AddCounter("tabtap_animation_steps_total", "Window moves made by animations");
+	moveErrors = registry.AddCounter("tabtap_window_move_errors_total", "Failed SetWindowPos calls");
+}
+
+
+
+// --- EffectData ---
+
+EffectData::~EffectData()
+{
+	if (IsEnabled()) { Disable(); }
+}
+
+bool EffectData::Enable(TimerScheduler* pTimers, const UINT& timerId, const Effects::Effect& effect)
+{
+	// A new trigger restarts the effect from its first frame
+	if (IsEnabled() and (pScheduler != pTimers or uTimerID != timerId)) { Disable(); }
+
+	pScheduler = pTimers;
+	uTimerID = timerId;
+	const uint64_t now = TimerScheduler::GetTimeMs();
+	player.Start(effect, now);
+	effectCount.Add();
+
+	return pScheduler->Set(uTimerID, player.GetDelayMs(now), defTolerance, false);
+}
+
+void EffectData::Disable()
+{
+	if (pScheduler) { pScheduler->Kill(uTimerID); }
+	uTimerID = {};
+	pScheduler = nullptr;
+	player.Stop();
+	frames.Clear();     // Idle tabs keep no effect frames
+}
+
+bool EffectData::IsEnabled() const
+{
+	return player.IsPlaying();
+}
+
+bool EffectData::Update()
+{
+	const uint64_t now = TimerScheduler::GetTimeMs();
+	const bool isChanged = player.Advance(now);
+
+	// Sleep until the next frame; no timer at all once the effect is over
+	if (player.IsPlaying()) {
+		pScheduler->Set(uTimerID, player.GetDelayMs(now), defTolerance, false);
+	}
+	else {
+		Disable();
+	}
+
+	if (isChanged) { frameCount.Add(); }
+	return isChanged;
+}
+
+bool EffectData::IsHighlighted() const
+{
+	return player.GetSample().tint != 0;
+}
+
+Render::ImageView EffectData::GetFrame(const Render::ImageView& source, uint64_t sourceId)
+{
+	const Effects::Effect* pEffect = player.GetEffect();
+	if (!pEffect) { return source; }
+
+	// First frame of a run or of a reloaded image: render every frame up front
+	if (!frames.IsBound(sourceId)) {
+		frames.Prerender(*pEffect, source, sourceId);
+	}
+	return frames.Get(source, sourceId, player.GetSample(), pEffect->tintColor);
+}
+
+const Effects::FrameCache& EffectData::GetFrameCache() const
+{
+	return frames;
+}
+
+void EffectData::RegisterMetrics(Metrics::Registry& registry)
+{
+	effectCount = registry.AddCounter("tabtap_effects_total", "Tab effects started (blink runs)");
+	frameCount = registry.AddCounter("tabtap_effect_frames_total", "Effect frames that changed the tab");
+}
+
+
+
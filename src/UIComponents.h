@@ -1,357 +1,1222 @@
-#pragma once
-
-// Implementation-specific headers
-#include "CustomIncludes/WinApi/WorkAreaManager.h"
-#include "CustomIncludes/WinApi/DragTracker.h"
-
-// Windows headers
-#include <windows.h>
-#include <tchar.h>
-#include <gdiplus.h>
-
-
-
-// Represent the result of an operation
-struct Result
-{
-public:
-	// Enumerates types of errors for Result struct
-	enum class ErrorType
-	{
-		None,          // No error (success)
-		SystemError,   // System error from GetLastError()
-		GDIPlusError,  // GDI+ error from Status codes
-		CustomError    // User-defined error
-	};
-
-public:
-	bool success{};                  // True if successful, false if failed
-	ErrorType errorType{};           // Specifies the type of error (or None if operation was successful)
-	DWORD errorValue;                // Error code (system, GDI+ etc.)
-	LPCTSTR message{};               // Stores a custom error message for CustomError
-	LPCTSTR header{};                // Error header
-
-	// Default constructor for a successful result
-	Result() :
-		success(true),
-		errorType(ErrorType::None),
-		errorValue(0),
-		header(_T("Success")),
-		message(_T(""))
-	{}
-
-	// Constructor for system error with error code and optional message
-	Result(DWORD dwErrCode, LPCTSTR cszMsg = _T("")) :
-		success(false),
-		errorType(ErrorType::SystemError),
-		errorValue(dwErrCode),
-		header(_T("System Error")),
-		message(cszMsg)
-	{}
-
-	// Constructor for GDI+ error with status code and optional message
-	Result(Gdiplus::Status eStatus, LPCTSTR cszMsg = _T("")) :
-		success(false),
-		errorType(ErrorType::GDIPlusError),
-		errorValue(static_cast<DWORD>(eStatus)),
-		header(_T("GDI+ Error")),
-		message(cszMsg)
-	{}
-
-	// Constructor for custom error with a user-defined message
-	Result(DWORD dwErrCode, LPCTSTR cszHeader, LPCTSTR cszMsg) :
-		success(false),
-		errorType(ErrorType::CustomError),
-		errorValue(dwErrCode),
-		header(cszHeader),
-		message(cszMsg)
-	{}
-
-	// Explicit contextual conversion
-	explicit operator bool() const noexcept
-	{
-		return success;
-	}
-
-};
-
-
-// GDI+ Resource Manager
-class GDIPlusData
-{
-private:
-	// --- Member Variables ---
-	ULONG_PTR pToken{};           // GDI+ initialization token
-	Gdiplus::Image* pImage{};     // Loaded image resource
-	Gdiplus::ImageAttributes* pImageAttributes{};  // Image effects processor
-	Result result{};              // Operation result storage
-
-private:
-	// --- Internal Methods ---
-	/// Sets the internal result state
-	Result SetResult(Result);
-	/// Initializes GDI+ subsystem
-	Result InitializeGDIPlus();
-	/// Shuts down GDI+ subsystem
-	void ShutdownGDIPlus();
-
-public:
-	// --- Lifecycle Management ---
-	~GDIPlusData();
-	GDIPlusData();
-	GDIPlusData(const GDIPlusData&) = delete;
-	GDIPlusData& operator=(const GDIPlusData&) = delete;
-
-	// --- Image Resource Management ---
-	/// Loads image from file
-	Result LoadImageFile(LPCTSTR);
-	/// Loads image from byte array in memory
-	Result LoadImageByteArray();
-	/// Loads application image using the configured source method
-	Result LoadApplicationImage();
-	/// Releases loaded image resources
-	void FreeImageResource();
-	/// Gets pointer to loaded image
-	Gdiplus::Image* GetImage() const;
-
-	// --- Image Effects Management ---
-	/// Creates image attributes for effect processing
-	Result CreateImageAttributes();
-	/// Releases image attributes resources
-	void FreeImageAttributes();
-	/// Gets pointer to image attributes (null if none created)
-	Gdiplus::ImageAttributes* GetImageAttributes() const;
-	/// Applies color transformation matrix to image
-	Result ApplyColorMatrix(Gdiplus::ColorMatrix*);
-
-	// --- Result Management ---
-	/// Gets the last operation result
-	Result GetResult() const;
-};
-
-
-// Interface for system tray adapter
-struct ITrayAdapter
-{
-	// Sets up the tray icon
-	virtual Result SetupTrayIcon(NOTIFYICONDATA&) = 0;
-	// Creates the tray menu
-	virtual Result CreateTrayMenu(HMENU&) = 0;
-};
-
-
-// System Tray Icon Manager
-class TrayManager
-{
-private:
-	// --- Member Variables ---
-	ITrayAdapter* pTrayAdapter{};      // Tray adapter interface 
-	NOTIFYICONDATA trayData{};         // Data for the system tray icon
-	HMENU hTrayMenu{};                 // Context menu handle
-	Result result{};                   // Operation result storage
-
-private:
-	// --- Internal Methods ---
-	/// Sets the internal result state
-	Result SetResult(Result);
-
-public:
-	// --- Lifecycle Management ---
-	~TrayManager();
-	explicit TrayManager(ITrayAdapter*);
-
-	// --- Tray Icon Operations ---
-	/// Creates and displays the system tray icon
-	Result SetupTrayIcon();
-	/// Removes the system tray icon
-	void DeleteTrayIcon();
-	/// Loads the icon resource from executable
-	void GetIconResource(HICON);
-	/// Releases the loaded icon resource
-	void FreeIconResource();
-
-	// --- Menu Operations ---
-	/// Creates the tray context menu
-	Result CreateTrayMenu();
-	/// Destroys the tray context menu
-	Result DestroyTrayMenu();
-	/// Displays and tracks the tray context menu
-	Result TrackTrayMenu();
-
-	// --- Interaction Handling ---
-	/// Handles right-click events on the tray icon
-	Result HandleTrayRightClick();
-
-	// --- Result Management ---
-	/// Gets the last operation result
-	Result GetResult() const;
-	/// Clears the stored result
-	void ClearResult();
-};
-
-
-// Interface for edge-snapping adapters
-struct ISnapAdapter
-{
-	// Returns target window handle for snapping
-	virtual HWND GetTargetWindow() const = 0;
-	// Gets current snapped edge
-	virtual ScreenEdge GetSnapEdge() const = 0;
-	// Checks if edge is valid for snapping
-	virtual bool IsValidSnapEdge(const ScreenEdge&) const = 0;
-	// Handles successful edge snap with edge and position
-	virtual void OnSnapSuccess(const ScreenEdge&, const POINT&) = 0;
-	// Handles rejected snap attempt
-	virtual void OnSnapRejected(const ScreenEdge&, const POINT&) = 0;
-	// Updates position when no snap occurs
-	virtual void OnSnapEdgeNone(const POINT&) = 0;
-	// Default virtual destructor
-	virtual ~ISnapAdapter() = default;
-};
-
-
-// ScreenEdge-Snapping Controller
-class EdgeSnapData
-{
-private:
-	// --- Configuration Constants ---
-	const int SnapMargin{ 50 };        // Distance in pixels from edge to trigger snapping preview
-	const int PreviewFrameSize{ 4 };   // Thickness of preview frame
-	const int PreviewSize{ 30 };       // Size of snapping preview indicator
-
-	// --- Member Variables ---
-	ISnapAdapter* pSnapAdapter{};      // Snap adapter interface
-	DragTracker dragTracker{};         // Handles core drag tracking 
-	HWND hPreviewWnd{};                // Preview window handle
-	RECT rcTargetRect{};               // Preview window coordinates
-	bool isEnabled{};                  // Indicates if edge-snapping is active
-	bool isPreviewEnabled{};           // Indicates if edge-snapping is triggered
-	ScreenEdge snapEdge{ ScreenEdge::None };       // Current edge to snap to
-	Result result{};                   // Operation result storage
-
-private:
-	// --- Internal Methods ---
-	/// Sets the operation result
-	Result SetResult(Result);
-	/// Creates the visual preview window
-	void CreatePreviewWindow();
-	/// Updates preview window position and appearance
-	void UpdatePreviewWindow();
-	/// Renders the preview graphics
-	Result DrawPreview();
-
-public:
-	// --- Lifecycle Management ---
-	~EdgeSnapData();
-	EdgeSnapData();
-	EdgeSnapData(const EdgeSnapData&) = delete;
-	EdgeSnapData& operator=(const EdgeSnapData&) = delete;
-
-	// --- Snapping Control ---
-	/// Enables edge-snapping behavior
-	bool Enable(ISnapAdapter*);
-	/// Disables edge-snapping behavior
-	void Disable();
-	/// Checks if snapping is active
-	bool IsEnabled() const;
-	/// Checks if snapping is active
-	bool IsPreviewEnabled() const;
-
-	// --- ScreenEdge Detection ---
-	/// Gets currently detected snap edge
-	ScreenEdge GetSnapEdge() const;
-	/// Checks if specific edge is being snapped to
-	bool IsSnapEdge(const ScreenEdge&);
-
-	// --- Drag Operations ---
-	/// Updates snapping state based on current cursor position
-	bool OnMouseMove();
-};
-
-
-// Window Animation Controller
-class AnimationData
-{
-private:
-	// --- Animation Configuration ---
-	const LONG pixelByStep{ 1 };      // Pixels to move per animation step
-
-	// --- Animation State ---
-	HWND hAnimatedWnd{};              // Handle to window being animated
-	bool isEnabled{};                 // Indicates if an animation is currently active
-	POINT ptCurrentPoint{};           // Current window left-top coordinates
-	POINT ptTargetPoint{};            // Destination coordinates (screen space)
-
-public:
-	// --- Lifecycle Management ---
-	~AnimationData();
-	AnimationData();
-	AnimationData(const AnimationData&) = delete;
-	AnimationData& operator=(const AnimationData&) = delete;
-
-	// --- Animation Control ---
-	/// Starts new animation sequence
-	bool Enable(HWND, const POINT&);
-	/// Stops current animation
-	void Disable();
-	/// Checks if animation is currently running
-	bool IsEnabled() const;
-	/// Updates animation state
-	bool Update();
-};
-
-
-// Visual Blink Effect Controller
-class BlinkData
-{
-private:
-	// --- Configuration Constants ---
-	const COLORREF defBlinkColor{ RGB(255, 255, 0) };  // Color used for the blink effect
-	const float defIntensity{ 0.9f };                  // Intensity of the blink color tint (0.0 to 1.0)
-	const UINT defInterval{ 400 };                     // Blink interval in milliseconds
-	const DWORD defDuration{ 3000 };                   // Total duration of the blink effect in milliseconds
-
-	// --- Effect State ---
-	HWND hTargetWnd{};                     // Handle to window receiving blink effect
-	bool isEnabled{};                      // Indicates if the blink effect is active
-	bool isBlinkState{};                   // Current blink phase (on/off)
-	DWORD blinkStartTime{};                // Timestamp when blinking started
-
-	// --- Color Transformations ---
-	Gdiplus::ColorMatrix normalMatrix{};   // Identity matrix (normal state)
-	Gdiplus::ColorMatrix blinkMatrix{};    // Tinted matrix (blink state)
-
-	// ID of timer for blink effect
-	UINT uTimerID{};
-
-private:
-	// --- Internal Methods ---
-	void InitializeColorMatrices();
-
-public:
-	// --- Lifecycle Management ---
-	~BlinkData();
-	BlinkData();
-	BlinkData(const BlinkData&) = delete;
-	BlinkData& operator=(const BlinkData&) = delete;
-
-	// --- Effect Control ---
-	/// Starts blink effect on specified window
-	bool Enable(HWND, const UINT&);
-	/// Stops blink effect
-	void Disable();
-	/// Checks if effect is currently active
-	bool IsEnabled() const;
-
-	// --- Effect Processing ---
-	/// Updates effect state (call periodically)
-	bool Update();
-	/// Checks if total duration has elapsed
-	bool IsElapsed();
-
-	/// Gets current color transformation matrix
-	Gdiplus::ColorMatrix* GetActiveColorMatrix();
-};
-
-
-
+#pragma once
+
+// Implementation-specific headers
+#include "CustomIncludes/WinApi/WorkAreaManager.h"
+#include "CustomIncludes/WinApi/DragTracker.h"
+#include "DragPredictor.h"
+#include "TraceChannel.h"
+#include "MetricsChannel.h"
+#include "GdiResources.h"
+#include "Core/DirectoryWatcher.h"
+#include "Core/FrameSwapper.h"
+#include "Core/SkinReloader.h"
+#include "Core/SkinFormat.h"
+#include "Core/Geometry.h"
+#include "Core/TabLayout.h"
+#include "Core/RotatingFile.h"
+#include "Core/PowerPolicy.h"
+#include "Core/StateSnapshot.h"
+#include "Core/FullscreenDetector.h"
+#include "Core/RenderBackend.h"
+#include "Core/GlyphAtlas.h"
+#include "Core/EffectEngine.h"
+#include "Core/TimerWheel.h"
+#include "Core/RestartPolicy.h"
+#include "Core/AutoShow.h"
+#include "Core/OskPlacement.h"
+#include "Core/KeyLayout.h"
+
+// Default headers
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Windows headers
+#include <windows.h>
+#include <tchar.h>
+#include <gdiplus.h>
+#include <UIAutomation.h>
+
+
+
+// Represent the result of an operation
+struct Result
+{
+public:
+	// Enumerates types of errors for Result struct
+	enum class ErrorType
+	{
+		None,          // No error (success)
+		SystemError,   // System error from GetLastError()
+		GDIPlusError,  // GDI+ error from Status codes
+		CustomError    // User-defined error
+	};
+
+public:
+	bool success{};                  // True if successful, false if failed
+	ErrorType errorType{};           // Specifies the type of error (or None if operation was successful)
+	DWORD errorValue;                // Error code (system, GDI+ etc.)
+	LPCTSTR message{};               // Stores a custom error message for CustomError
+	LPCTSTR header{};                // Error header
+
+	// Default constructor for a successful result
+	Result() :
+		success(true),
+		errorType(ErrorType::None),
+		errorValue(0),
+		header(_T("Success")),
+		message(_T(""))
+	{}
+
+	// Constructor for system error with error code and optional message
+	Result(DWORD dwErrCode, LPCTSTR cszMsg = _T("")) :
+		success(false),
+		errorType(ErrorType::SystemError),
+		errorValue(dwErrCode),
+		header(_T("System Error")),
+		message(cszMsg)
+	{}
+
+	// Constructor for GDI+ error with status code and optional message
+	Result(Gdiplus::Status eStatus, LPCTSTR cszMsg = _T("")) :
+		success(false),
+		errorType(ErrorType::GDIPlusError),
+		errorValue(static_cast<DWORD>(eStatus)),
+		header(_T("GDI+ Error")),
+		message(cszMsg)
+	{}
+
+	// Constructor for custom error with a user-defined message
+	Result(DWORD dwErrCode, LPCTSTR cszHeader, LPCTSTR cszMsg) :
+		success(false),
+		errorType(ErrorType::CustomError),
+		errorValue(dwErrCode),
+		header(cszHeader),
+		message(cszMsg)
+	{}
+
+	// Explicit contextual conversion
+	explicit operator bool() const noexcept
+	{
+		return success;
+	}
+
+};
+
+
+// Conversions between Win32 and portable geometry
+inline Geometry::Rect ToGeometry(const RECT& rc) { return { rc.left, rc.top, rc.right, rc.bottom }; }
+inline Geometry::Point ToGeometry(const POINT& pt) { return { pt.x, pt.y }; }
+inline Geometry::Size ToGeometry(const SIZE& size) { return { size.cx, size.cy }; }
+inline RECT ToRect(const Geometry::Rect& rc) { return { rc.left, rc.top, rc.right, rc.bottom }; }
+inline POINT ToPoint(const Geometry::Point& pt) { return { pt.x, pt.y }; }
+inline Geometry::Size GetScreenSize() { return { GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) }; }
+
+// Conversions between ScreenEdge and the portable layout edge
+static_assert(int(ScreenEdge::Bottom) == int(TabLayout::Edge::Bottom), "Edge order mismatch");
+inline TabLayout::Edge ToLayoutEdge(const ScreenEdge& edge) { return TabLayout::Edge(edge); }
+inline ScreenEdge ToScreenEdge(TabLayout::Edge edge) { return ScreenEdge(edge); }
+
+
+// Win32 directory change notification source
+class DirectoryWatcher : public IDirectoryWatcher
+{
+private:
+	// --- Member Variables ---
+	HANDLE hStopEvent{};               // Signals the watcher thread to exit
+	std::thread watcher{};             // Thread waiting on change notifications
+
+public:
+	// --- Lifecycle Management ---
+	~DirectoryWatcher() override;
+	DirectoryWatcher();
+	DirectoryWatcher(const DirectoryWatcher&) = delete;
+	DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+	// --- Watch Control ---
+	/// Starts watching the directory for file writes, renames and size changes
+	bool Start(const std::filesystem::path&, ChangeCallback) override;
+	/// Stops watching and joins the watcher thread
+	void Stop() override;
+	/// Checks if the watcher thread is running
+	bool IsRunning() const override;
+};
+
+
+// Drains the shared trace ring into a rolling log file
+class TraceRecorder
+{
+private:
+	// --- Configuration Constants ---
+	static constexpr DWORD DrainIntervalMs = 50;            // Ring drain period
+	static constexpr uint64_t MaxFileBytes = 1024 * 1024;  // Rotation size
+	static constexpr unsigned KeepFiles = 3;                // Rotated copies kept
+
+	// --- Member Variables ---
+	HANDLE hStopEvent{};               // Signals the drain thread to exit
+	std::thread drainer{};             // Thread writing records to the file
+	Trace::Ring* pRing{};              // Ring being recorded, disabled again on Stop
+
+	// --- Internal Methods ---
+	/// Writes all pending records and the drop count to the file
+	static void DrainRing(Trace::Ring&, RotatingFile&, LONGLONG origin, double ticksPerMs);
+
+public:
+	// --- Lifecycle Management ---
+	~TraceRecorder();
+	TraceRecorder();
+	TraceRecorder(const TraceRecorder&) = delete;
+	TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+	// --- Recording Control ---
+	/// Starts draining the channel into the file (timestamps relative to now)
+	bool Start(TraceChannel&, const std::filesystem::path&);
+	/// Drains what is left, closes the file and joins the thread
+	void Stop();
+	/// Checks if the drain thread is running
+	bool IsRunning() const;
+	/// Returns the trace file path next to the application image
+	static Result GetTracePath(LPTSTR, size_t);
+};
+
+
+// Publishes metrics snapshots: periodically to a file and to each client of
+// a local named pipe, both from one export thread
+class MetricsExporter
+{
+public:
+	static constexpr LPCTSTR PipeName = _T("\\\\.\\pipe\\TabTapMetrics");
+
+private:
+	// --- Configuration Constants ---
+	static constexpr DWORD ExportIntervalMs = 60 * 1000;   // File snapshot period
+	static constexpr DWORD ClientTimeoutMs = 1000;          // Longest wait on a pipe client
+	static constexpr DWORD PipeBufferBytes = 64 * 1024;    // Holds a whole snapshot
+
+	// --- Member Variables ---
+	HANDLE hStopEvent{};               // Signals the export thread to exit
+	std::thread exporter{};            // Thread writing the file and serving the pipe
+
+	// --- Internal Methods ---
+	/// Replaces the file with a snapshot (atomic rename)
+	static bool WriteSnapshotFile(const std::filesystem::path&, const std::string&);
+	/// Starts waiting for a pipe client; false if the pipe is unusable
+	static bool ListenForClient(HANDLE hPipe, OVERLAPPED*);
+	/// Sends a snapshot to the connected client and disconnects it
+	static void ServeClient(HANDLE hPipe, OVERLAPPED*, const std::string&);
+
+public:
+	// --- Lifecycle Management ---
+	~MetricsExporter();
+	MetricsExporter();
+	MetricsExporter(const MetricsExporter&) = delete;
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+	// --- Export Control ---
+	/// Starts exporting the channel's registry to the file and the pipe
+	bool Start(MetricsChannel&, const std::filesystem::path&);
+	/// Writes a final snapshot and joins the thread
+	void Stop();
+	/// Checks if the export thread is running
+	bool IsRunning() const;
+};
+
+
+// Session state snapshot persisted off the UI thread
+class StateStore
+{
+private:
+	// --- Member Variables ---
+	std::filesystem::path path{};      // Snapshot file
+	Snapshot::State state{};           // UI thread copy
+	Snapshot::State pending{};         // Latest state for the writer
+	std::mutex pendingMutex{};         // Guards `pending`
+	std::mutex saveMutex{};            // Serializes overlapping callbacks
+	PTP_WORK pSaveWork{};              // Writes `pending` with atomic replacement
+	bool isLoaded{};                   // `state` came from the file
+
+	// --- Internal Methods ---
+	/// Thread pool callback writing the pending snapshot
+	static VOID CALLBACK SaveWork(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK);
+
+public:
+	// --- Lifecycle Management ---
+	~StateStore();
+	StateStore() = default;
+	StateStore(const StateStore&) = delete;
+	StateStore& operator=(const StateStore&) = delete;
+
+	// --- Snapshot Access ---
+	/// Reads the snapshot file; defaults are kept unless it is valid
+	Snapshot::Status Load(const std::filesystem::path&);
+	/// Checks if a valid snapshot was read
+	bool IsLoaded() const;
+	/// Returns the current state
+	const Snapshot::State& Get() const;
+	/// Replaces the state and schedules a write if it changed
+	bool Update(const Snapshot::State&);
+	/// Waits for a pending write (call before exit)
+	void Flush();
+};
+
+
+// Feeds display, power source, battery saver and session notifications
+// into the power policy and accounts self-scheduled wakeups
+class PowerMonitor
+{
+private:
+	// --- Member Variables ---
+	HWND hNotifyWnd{};                 // Window receiving the notifications
+	HPOWERNOTIFY hDisplayNotify{};     // GUID_CONSOLE_DISPLAY_STATE
+	HPOWERNOTIFY hSourceNotify{};      // GUID_ACDC_POWER_SOURCE
+	HPOWERNOTIFY hSaverNotify{};       // GUID_POWER_SAVING_STATUS
+	bool isSessionRegistered{};        // WTS session notifications active
+	Power::PowerPolicy policy{};       // Portable decision engine
+	Power::UsageMeter usage{};         // Wakeups and CPU time since the last report
+
+public:
+	// --- Lifecycle Management ---
+	~PowerMonitor();
+	PowerMonitor(HWND);
+	PowerMonitor(const PowerMonitor&) = delete;
+	PowerMonitor& operator=(const PowerMonitor&) = delete;
+
+	// --- Notification Handling ---
+	/// Handles WM_POWERBROADCAST; returns true if an input changed
+	bool OnPowerBroadcast(WPARAM, LPARAM);
+	/// Handles WM_WTSSESSION_CHANGE; returns true if an input changed
+	bool OnSessionChange(WPARAM);
+	/// Sets whether a fullscreen app or presentation is in front
+	void SetFullscreen(bool);
+
+	// --- Activity Tracking ---
+	/// Marks the start of a drag or animation
+	void BeginActivity(Power::Activity);
+	/// Marks its end
+	void EndActivity(Power::Activity);
+
+	// --- Policy Access ---
+	/// Returns true with the new decision if it changed since the last call
+	bool TakeChange(Power::Decision*);
+	/// Returns the decision currently in effect
+	const Power::Decision& GetDecision() const;
+
+	// --- Usage Accounting ---
+	/// Counts one timer tick or posted loop message
+	void RecordWakeup();
+	/// Returns usage since the last report and starts a new window
+	Power::UsageMeter::Report TakeUsageReport();
+};
+
+
+// Watches for fullscreen apps and presentations without polling: the shell
+// reports fullscreen changes to a registered app bar and a WinEvent hook
+// reports foreground changes; each one triggers a single evaluation
+class FullscreenMonitor
+{
+public:
+	static constexpr WPARAM ForegroundChanged = 0x100;  // wParam posted with the app bar message
+
+private:
+	// --- Member Variables ---
+	HWND hNotifyWnd{};                 // App bar window receiving the notifications
+	UINT uNotifyMessage{};             // App bar callback message
+	HWINEVENTHOOK hForegroundHook{};   // EVENT_SYSTEM_FOREGROUND hook
+	bool isAppBarRegistered{};
+	Fullscreen::Reason reason{};       // Last evaluation
+	static FullscreenMonitor* pInstance;  // WinEvent callbacks carry no context
+
+private:
+	// --- Internal Methods ---
+	/// Posts a foreground change to the notification window
+	static void CALLBACK OnForegroundEvent(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD);
+	/// Describes a top-level window for the detector
+	static Fullscreen::Window DescribeWindow(HWND, HWND hForeground);
+
+public:
+	// --- Lifecycle Management ---
+	~FullscreenMonitor();
+	FullscreenMonitor(HWND, UINT uMessage);
+	FullscreenMonitor(const FullscreenMonitor&) = delete;
+	FullscreenMonitor& operator=(const FullscreenMonitor&) = delete;
+
+	// --- Notification Handling ---
+	/// Handles the app bar message; returns true if the state must be re-evaluated
+	bool OnNotify(WPARAM) const;
+	/// Re-evaluates the screen; returns true if the result changed
+	bool Refresh();
+
+	// --- State Access ---
+	/// Returns why the tab gives way (Reason::None if it does not)
+	Fullscreen::Reason GetReason() const;
+	/// Checks if a fullscreen app or presentation is in front
+	bool IsActive() const;
+};
+
+
+// Waits for a process in the thread pool and posts its exit code to a window;
+// the restart policy decides when the window should start it again. The
+// restart itself (launch and readiness waits) also runs in the thread pool
+// and posts the new process id back.
+class ProcessSupervisor
+{
+public:
+	/// Starts the process and waits until it is usable; returns its id, or 0
+	using LaunchFunc = DWORD(*)();
+
+private:
+	// --- Member Variables ---
+	HWND hNotifyWnd{};                 // Window receiving the notifications
+	UINT uNotifyMessage{};             // Message posted on exit and after a restart
+	WPARAM wExitParam{};               // Its wParam on exit (lParam is the exit code)
+	WPARAM wRestartParam{};            // Its wParam after a restart (lParam is the process id, 0 on failure)
+	HANDLE hProcess{};                 // Supervised process (SYNCHRONIZE)
+	PTP_WAIT pWait{};                  // Thread pool wait on `hProcess`
+	PTP_WORK pRestartWork{};           // Thread pool work running `pfnLaunch`
+	LaunchFunc pfnLaunch{};            // Restart of the current BeginRestart
+	bool isRestarting{};               // Restart work submitted, result not handled yet
+	Supervision::RestartPolicy policy{};
+
+	Metrics::Counter exitCount{};      // Unexpected exits
+	Metrics::Counter restartCount{};   // Processes brought back
+	Metrics::Histogram recoveryTime{}; // Exit to running again (ms)
+
+private:
+	// --- Internal Methods ---
+	/// Thread pool callback; runs once per Watch
+	static VOID CALLBACK OnProcessExit(PTP_CALLBACK_INSTANCE, PVOID, PTP_WAIT, TP_WAIT_RESULT);
+	/// Thread pool callback; runs once per BeginRestart
+	static VOID CALLBACK OnRestartWork(PTP_CALLBACK_INSTANCE, PVOID, PTP_WORK);
+
+public:
+	// --- Lifecycle Management ---
+	~ProcessSupervisor();
+	ProcessSupervisor(HWND, UINT uMessage, WPARAM wExitParam, WPARAM wRestartParam);
+	ProcessSupervisor(const ProcessSupervisor&) = delete;
+	ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+
+	// --- Supervision Control ---
+	/// Starts waiting on a process; returns the recovery time in ms if it replaces a dead one
+	bool Watch(DWORD dwProcessId, uint64_t* pRecoveryMs = nullptr);
+	/// Stops waiting without a notification (intended exit)
+	void Stop();
+	/// Checks if a process is being waited on
+	bool IsWatching() const;
+
+	// --- Restart ---
+	/// Runs a launch in the thread pool; its result arrives as the restart message
+	bool BeginRestart(LaunchFunc);
+	/// Checks if a launch is running in the thread pool
+	bool IsRestarting() const;
+
+	// --- Restart Policy ---
+	/// Handles the exit notification; returns when to restart
+	Supervision::Decision OnExited();
+	/// Handles a restart that failed; returns when to try again
+	Supervision::Decision OnRestartFailed();
+	/// Allows restarts again after a give-up (the user asked for the process); returns when to restart
+	Supervision::Decision Retry();
+	/// Checks if the process is down and a restart is pending
+	bool IsRecovering() const;
+
+	// --- Metrics ---
+	/// Registers the exit, restart and recovery metrics
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Samples the process GDI and USER object counts and watches them for the
+// steady rise of a leak. Normal runs only report it; a soak run also holds
+// both counts to a budget taken after the warmup.
+class HandleMonitor
+{
+public:
+	struct Report
+	{
+		Gdi::GuiCounts counts{};       // Process-wide counts at this sample
+		double gdiPerHour{};           // Fitted GDI trend (objects per hour)
+		double userPerHour{};          // Fitted USER trend
+		bool isLeakFound{};            // A trend turned into a leak at this sample
+		bool isOverBudget{};           // Soak run: a count left its budget
+	};
+
+private:
+	// --- Member Variables ---
+	Resources::TrendDetector gdiTrend{};
+	Resources::TrendDetector userTrend{};
+	Resources::Budget gdiBudget{};
+	Resources::Budget userBudget{};
+	bool isSoak{};                     // Budgets are enforced
+	bool isGdiLeaking{};               // Reported once per rise
+	bool isUserLeaking{};
+
+	Metrics::Gauge gdiObjects{};       // GetGuiResources(GR_GDIOBJECTS)
+	Metrics::Gauge userObjects{};      // GetGuiResources(GR_USEROBJECTS)
+	Metrics::Gauge liveHandles[size_t(Resources::Kind::Count)]{};  // Ledger, per kind
+	Metrics::Counter leakCount{};      // Rises reported as leaks
+
+public:
+	// --- Lifecycle Management ---
+	HandleMonitor(const Resources::TrendDetector::Config&, bool isSoakRun,
+		uint64_t warmupMs = 0, int64_t budgetSlack = 0);
+
+	// --- Sampling ---
+	/// Takes a sample at `nowMs` and updates the metrics
+	Report Sample(uint64_t nowMs);
+	/// Checks if budgets are enforced
+	bool IsSoak() const;
+
+	// --- Metrics ---
+	/// Registers the object count, live handle and leak metrics
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Auto-shows the keyboard over editable fields: a dedicated thread subscribes
+// to UI Automation focus changes, and only the policy's settled show and hide
+// decisions are posted to the window, so focus storms never reach its thread
+class FocusWatcher
+{
+private:
+	class EventHandler;                // IUIAutomationFocusChangedEventHandler
+
+	// --- Member Variables ---
+	HWND hNotifyWnd{};                 // Window receiving the decisions
+	UINT uNotifyMessage{};             // Message posted per decision
+	WORD wNotifyCommand{};             // Its LOWORD(wParam); HIWORD is 1 to show, 0 to hide
+	HANDLE hStopEvent{};               // Signals the watcher thread to exit
+	HANDLE hWakeEvent{};               // A focus event moved the decision deadline
+	std::thread watcher{};             // Thread owning the UI Automation client
+	std::mutex policyMutex{};          // Guards the policy and cache (event and watcher threads)
+	AutoShow::Policy policy{};
+	AutoShow::ElementCache cache{};
+	RECT rcFocus{};                    // Focused text field (empty otherwise); guarded as well
+	std::atomic<DWORD> keyboardProcessId{};  // osk.exe; focus inside it is ignored
+
+	Metrics::Counter focusCount{};     // Focus-changed events received
+	Metrics::Counter cacheHits{};      // Elements answered from the cache
+	Metrics::Counter cacheMisses{};    // Elements looked up in their process
+	Metrics::Counter showCount{};      // Show decisions posted
+	Metrics::Counter hideCount{};      // Hide decisions posted
+
+private:
+	// --- Internal Methods ---
+	/// Watcher thread: subscribes, then posts decisions as they fall due
+	void Run(std::promise<HRESULT>*);
+	/// Event thread: classifies the focused element and feeds the policy
+	void OnFocusChanged(IUIAutomationElement*);
+	/// Reads the control type and patterns of an element (cached values first)
+	AutoShow::Element DescribeElement(IUIAutomationElement*) const;
+
+public:
+	// --- Lifecycle Management ---
+	~FocusWatcher();
+	FocusWatcher();
+	FocusWatcher(const FocusWatcher&) = delete;
+	FocusWatcher& operator=(const FocusWatcher&) = delete;
+
+	// --- Watch Control ---
+	/// Subscribes to focus changes; decisions arrive as `uMessage` with MAKEWPARAM(wCommand, show)
+	bool Start(HWND, UINT uMessage, WORD wCommand);
+	/// Unsubscribes and joins the watcher thread
+	void Stop();
+	/// Checks if the watcher thread is running
+	bool IsRunning() const;
+
+	// --- Policy Input ---
+	/// Sets the keyboard process, whose own focus changes are ignored
+	void SetKeyboardProcess(DWORD);
+	/// Records a show or hide by the user (tab tap)
+	void OnUserToggle(bool isVisible);
+
+	// --- Focus Access ---
+	/// Gets the bounds of the focused text field as of its focus event; false if none
+	bool GetFocusRect(RECT*);
+
+	// --- Metrics ---
+	/// Registers the focus event, cache and decision metrics
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Follows the caret while the OSK is up: a WinEvent hook notes caret moves
+// and focus changes, and at most one notification per frame is posted to
+// the window, which reads the caret and places the OSK
+class CaretTracker
+{
+public:
+	static constexpr uint32_t FrameMs = 16;  // Fastest caret update rate
+
+private:
+	// --- Member Variables ---
+	HWND hNotifyWnd{};                 // Window receiving the notifications
+	UINT uNotifyMessage{};             // Message posted when an update is pending
+	WPARAM wNotifyParam{};             // Its wParam
+	HWINEVENTHOOK hCaretHook{};        // EVENT_OBJECT_LOCATIONCHANGE (caret only)
+	HWINEVENTHOOK hFocusHook{};        // EVENT_OBJECT_FOCUS
+	OskPlacement::FrameThrottle throttle{ FrameMs };
+	static CaretTracker* pInstance;    // WinEvent callbacks carry no context
+
+	Metrics::Counter eventCount{};     // Caret and focus events received
+	Metrics::Counter updateCount{};    // Frames that read the caret
+
+private:
+	// --- Internal Methods ---
+	/// Notes a caret move or focus change
+	static void CALLBACK OnCaretEvent(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD);
+
+public:
+	// --- Lifecycle Management ---
+	~CaretTracker();
+	CaretTracker(HWND, UINT uMessage, WPARAM wParam);
+	CaretTracker(const CaretTracker&) = delete;
+	CaretTracker& operator=(const CaretTracker&) = delete;
+
+	// --- Tracking Control ---
+	/// Installs the hooks (while the OSK is visible)
+	bool Start();
+	/// Removes the hooks
+	void Stop();
+	/// Checks if the hooks are installed
+	bool IsRunning() const;
+
+	// --- Frame Throttling ---
+	/// Requests an update; posts the notification unless one is pending
+	void Post();
+	/// Returns how long the pending update must still wait (0 when due)
+	uint32_t GetDelay(uint64_t nowMs) const;
+	/// Takes the pending update once a frame has passed since the last one
+	bool Take(uint64_t nowMs);
+	/// Checks if an update is pending
+	bool IsPending() const;
+
+	// --- Caret Access ---
+	/// Gets the caret of the foreground thread in screen coordinates; false if it has none
+	static bool GetCaretRect(RECT*);
+
+	// --- Metrics ---
+	/// Registers the caret event and update counters
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Runs all periodic work of a window from one waitable timer. Set and Kill
+// mirror SetTimer and KillTimer; due timers reach the window as WM_TIMER, so
+// the handlers stay where they are. The message loop waits on GetHandle().
+class TimerScheduler
+{
+private:
+	struct Entry
+	{
+		UINT id{};                     // Window timer identifier (WM_TIMER wParam)
+		Timing::TimerId timer{};       // Wheel timer
+	};
+
+	// --- Member Variables ---
+	HWND hTargetWnd{};                 // Window receiving WM_TIMER
+	HANDLE hTimer{};                   // Waitable timer armed for the next wakeup
+	Timing::TimerWheel wheel{};
+	std::vector<Entry> entries{};
+	uint64_t armedMs{ Timing::NoWakeup };  // Wakeup the waitable timer is set for
+
+private:
+	// --- Internal Methods ---
+	/// Points the waitable timer at the next wakeup, or cancels it
+	void Arm();
+	/// Finds the entry of a window timer
+	std::vector<Entry>::iterator Find(UINT);
+
+public:
+	// --- Lifecycle Management ---
+	~TimerScheduler();
+	TimerScheduler() = default;
+	TimerScheduler(const TimerScheduler&) = delete;
+	TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+	/// Creates the waitable timer and sends due timers to the given window
+	bool Attach(HWND);
+	/// Stops all timers
+	void Detach();
+
+	// --- Timer Control ---
+	/// Starts or restarts a timer; fires once unless `isRepeating`
+	bool Set(UINT id, UINT delayMs, UINT toleranceMs, bool isRepeating);
+	/// Stops a timer
+	void Kill(UINT id);
+	/// Checks if a timer is pending
+	bool IsSet(UINT id) const;
+
+	// --- Message Loop ---
+	/// Gets the handle to wait on (NULL before Attach)
+	HANDLE GetHandle() const;
+	/// Fires the due timers; call when the handle is signaled
+	void Run();
+
+	/// Milliseconds on the performance counter (the scheduler clock)
+	static uint64_t GetTimeMs();
+};
+
+
+// Render backend for a layered window: one DIB section and memory DC kept
+// while the size is unchanged, presented with UpdateLayeredWindow
+class LayeredBackend : public Render::IBackend
+{
+protected:
+	// --- Member Variables ---
+	HWND hTargetWnd{};                 // Layered window being drawn
+	Gdi::OwnedDC hdcMem{};             // Memory DC holding the DIB section
+	Gdi::OwnedBitmap hBitmap{};        // Top-down 32-bit DIB section
+	HGDIOBJ hOldBmp{};                 // Bitmap originally selected in hdcMem
+	Render::SurfaceView surface{};     // DIB section bits
+	DWORD dwError{};                   // Last failure
+
+protected:
+	// --- Internal Methods ---
+	/// Stores the error and returns false
+	bool Fail(DWORD);
+	/// Releases the DIB section and memory DC
+	void FreeSurface();
+
+public:
+	// --- Lifecycle Management ---
+	~LayeredBackend() override;
+	explicit LayeredBackend(HWND);
+	LayeredBackend(const LayeredBackend&) = delete;
+	LayeredBackend& operator=(const LayeredBackend&) = delete;
+
+	// --- Render::IBackend ---
+	bool CreateSurface(const Geometry::Size&) override;
+	bool BlendMask(const Render::MaskView&, const Geometry::Point&, Render::Pixel) override;
+	bool Present(const Geometry::Point&, uint8_t) override;
+	uint32_t GetErrorCode() const override;
+};
+
+
+// Composes with GDI+ (images) and GDI (rectangles), as TabTap always did
+class GdiPlusBackend : public LayeredBackend
+{
+private:
+	Gdiplus::ImageAttributes attributes{};   // Colour matrix for tab effects
+
+public:
+	explicit GdiPlusBackend(HWND hWnd) : LayeredBackend{ hWnd } {}
+
+	// --- Render::IBackend ---
+	Render::BackendKind GetKind() const override { return Render::BackendKind::GdiPlus; }
+	bool Compose(const Render::Layer&) override;
+};
+
+
+// Composes with the portable software compositor straight into the DIB bits
+class DibBackend : public LayeredBackend
+{
+public:
+	explicit DibBackend(HWND hWnd) : LayeredBackend{ hWnd } {}
+
+	// --- Render::IBackend ---
+	Render::BackendKind GetKind() const override { return Render::BackendKind::Dib; }
+	bool Compose(const Render::Layer&) override;
+};
+
+
+/// Creates the backend of the given kind for a layered window
+Render::IBackend* CreateRenderBackend(Render::BackendKind, HWND);
+
+/// Converts a GDI colour to the pixel GDI writes into a 32-bit DIB (alpha byte 0)
+inline Render::Pixel ToGdiPixel(COLORREF color)
+{
+	return (Render::Pixel(GetRValue(color)) << 16) | (Render::Pixel(GetGValue(color)) << 8) |
+		Render::Pixel(GetBValue(color));
+}
+
+/// Rasterises the glyph atlas character set with the UI font (`cellHeight` at 96 DPI)
+bool RasterizeGlyphAtlas(Glyphs::Atlas&, uint32_t dpi, long cellHeight);
+
+
+// Shows the active keyboard layout's code ("EN", "DE") on the tab. GDI
+// rasterises the characters once per DPI into a glyph atlas; a layout
+// change only lays the new code out from it, and each redraw blends one
+// small mask over the composed frame.
+class LayoutIndicator
+{
+private:
+	// --- Member Variables ---
+	Glyphs::Atlas atlas{};             // Characters at the last drawn DPI
+	Glyphs::Label label{};             // Current code laid out from the atlas
+	char code[Glyphs::MaxLabelChars + 1]{};  // Layout code, empty when unknown
+	HKL hLayout{};                     // Layout the code belongs to
+
+	Metrics::Counter atlasBuilds{};    // Atlas rasterisations (one per DPI change)
+	Metrics::Counter layoutChanges{};  // Codes changed on the tab
+
+private:
+	// --- Internal Methods ---
+	/// Rasterises the character set with the tab font at a DPI
+	bool BuildAtlas(uint32_t dpi);
+
+public:
+	// --- Layout ---
+	/// Sets the active layout; returns true if the code on the tab changed
+	bool SetLayout(HKL);
+	/// Returns the code shown on the tab
+	const char* GetCode() const;
+
+	// --- Drawing ---
+	/// Blends the code centred over the composed frame (nothing if it does not fit)
+	bool Draw(Render::IBackend&, const Geometry::Size& frame, uint32_t dpi);
+
+	// --- Metrics ---
+	/// Registers the atlas and layout change counters
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Keyboard drawn by TabTap itself, in place of osk.exe. A layered tool
+// window that never takes focus: keys come from a layout table, a frame is
+// cached per modifier latch state, and a press sends its key events with a
+// single SendInput call. The owner's window procedure feeds it the commands
+// the hook answers inside osk.exe, so the tab drives both the same way.
+class BuiltinKeyboard
+{
+public:
+	static constexpr LPCTSTR WindowClass = _T("TabTapKeyboardClass");
+	static constexpr long KeySize = 44;          // Key pitch at 96 DPI
+	static constexpr long KeyGap = 3;
+	static constexpr long CaptionHeight = 20;    // Drag strip with the close box (regular mode)
+	static constexpr long LabelHeight = 14;
+	static constexpr BYTE MinOpacity = 0x20;     // Fade limits and step of the hook
+	static constexpr BYTE OpacityStep = 0x10;
+
+private:
+	// --- Member Variables ---
+	Gdi::OwnedWindow hKeyboardWnd{};   // Keyboard window
+	Render::BackendKind rendererKind{};
+	Render::IBackend* pRenderer{};     // Created with the window
+	KeyLayout::Layout layout{};
+	KeyLayout::Arrangement arrangement{};
+	KeyLayout::ModifierLatch latch{};
+	KeyLayout::FrameCache frames{};
+	KeyLayout::Palette palette{};
+	Glyphs::Atlas atlas{};             // Label characters at `dpi`
+	HKL hLabelLayout{};                // System layout the labels were read from
+	Geometry::Size size{};             // Window size at `dpi`
+	uint32_t dpi{};                    // DPI the keys were laid out for (0 to redo)
+	int pressedKey{ -1 };              // Key drawn pressed, or -1
+	BYTE opacity{ 0xff };
+	bool isDockMode{};                 // No caption strip
+	bool isDragging{};
+	POINT ptDragOffset{};              // Cursor position in the window while dragging
+
+	Metrics::Counter keyPresses{};     // Keys pressed, latches included
+	Metrics::Counter injectErrors{};   // SendInput calls that were blocked or cut short
+	Metrics::Counter framePaints{};    // Frames painted into the cache
+	Metrics::Histogram injectTime{};   // Pointer down to SendInput return (us)
+
+private:
+	// --- Internal Methods ---
+	/// Lays the keys out for a DPI and the dock state
+	void Arrange(uint32_t);
+	/// Reads the character a key types in the label layout; false if it has none to show
+	bool ReadLabel(const KeyLayout::Key&, bool isShifted, char (&)[KeyLayout::MaxLabelChars + 1]) const;
+	/// Returns the close box in client coordinates (empty in dock mode)
+	Geometry::Rect GetCloseBox() const;
+
+public:
+	// --- Lifecycle Management ---
+	~BuiltinKeyboard();
+	explicit BuiltinKeyboard(Render::BackendKind);
+	BuiltinKeyboard(const BuiltinKeyboard&) = delete;
+	BuiltinKeyboard& operator=(const BuiltinKeyboard&) = delete;
+
+	// --- Window ---
+	/// Creates the hidden keyboard window; `pfnWndProc` handles its messages
+	bool Create(HINSTANCE, WNDPROC, const KeyLayout::Layout&);
+	/// Gets the keyboard window handle
+	HWND GetHandle() const;
+	/// Draws the cached frame and the pressed key at the window position
+	bool Draw();
+
+	// --- Pointer Input ---
+	/// Presses the key under a client point and injects it; false if there is none
+	bool OnPointerDown(POINT);
+	/// Releases the pressed key
+	void OnPointerUp();
+	/// Checks if a client point is on the close box
+	bool IsOnCloseBox(POINT) const;
+	/// Starts moving the window with the cursor
+	void BeginDrag();
+	/// Follows the cursor while dragging
+	void Drag();
+	/// Stops moving the window
+	void EndDrag();
+	/// Checks if the window is being moved
+	bool IsDragging() const;
+
+	// --- Hook Commands ---
+	/// Steps the opacity up or down like the hook's fade
+	void Fade(bool isIncrease);
+	/// Sets the opacity (restored session)
+	void SetOpacity(BYTE);
+	/// Returns the current opacity
+	BYTE GetOpacity() const;
+	/// Drops or restores the caption strip
+	void SetDockMode(bool);
+
+	// --- Metrics ---
+	/// Registers the key press, injection and frame metrics
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// GDI+ Resource Manager
+class GDIPlusData
+{
+private:
+	// --- Member Variables ---
+	ULONG_PTR pToken{};           // GDI+ initialization token
+	FrameSwapper<Gdiplus::Bitmap> imageFrames{};   // Pre-rendered image, swapped on reload
+	std::unique_ptr<SkinReloader<Gdiplus::Bitmap>> spReloader{};  // Background image reloader
+	Result result{};              // Operation result storage
+
+private:
+	// --- Internal Methods ---
+	/// Sets the internal result state
+	Result SetResult(Result);
+	/// Initializes GDI+ subsystem
+	Result InitializeGDIPlus();
+	/// Shuts down GDI+ subsystem
+	void ShutdownGDIPlus();
+	/// Decodes a stream into a detached, premultiplied bitmap
+	static std::shared_ptr<Gdiplus::Bitmap> DecodeImageStream(IStream*, Gdiplus::Status*);
+	/// Reads and decodes an image file without keeping it locked
+	static std::shared_ptr<Gdiplus::Bitmap> DecodeImageFile(LPCTSTR, Gdiplus::Status*);
+
+public:
+	// --- Lifecycle Management ---
+	~GDIPlusData();
+	GDIPlusData();
+	GDIPlusData(const GDIPlusData&) = delete;
+	GDIPlusData& operator=(const GDIPlusData&) = delete;
+
+	// --- Image Resource Management ---
+	/// Builds the full path of the application image
+	static Result GetApplicationImagePath(LPTSTR, size_t);
+	/// Loads image from file
+	Result LoadImageFile(LPCTSTR);
+	/// Loads image from byte array in memory
+	Result LoadImageByteArray();
+	/// Loads application image using the configured source method
+	Result LoadApplicationImage();
+	/// Releases loaded image resources
+	void FreeImageResource();
+	/// Gets a snapshot of the loaded image (valid while held) and its load generation
+	std::shared_ptr<Gdiplus::Bitmap> GetImage(uint64_t* pGeneration = nullptr) const;
+
+	// --- Image Hot-Reload ---
+	/// Watches the application image and posts the given message on swap
+	Result EnableHotReload(HWND, UINT, WPARAM);
+	/// Stops watching the application image
+	void DisableHotReload();
+
+	// --- Result Management ---
+	/// Gets the last operation result
+	Result GetResult() const;
+};
+
+
+// Memory-mapped tab skin container
+class SkinData
+{
+private:
+	// --- Member Variables ---
+	HANDLE hFile{};                    // Skin file handle
+	HANDLE hMapping{};                 // Read-only file mapping
+	const void* pMappedView{};         // Mapped file contents
+	Skin::View view{};                 // Validated reader over the mapping
+	Skin::FrameTable frameTable{};     // Frames resolved for the current DPI
+	Gdi::OwnedBitmap frameBitmaps[2][size_t(Skin::State::Count)]{};  // Lazily filled DIBs [mirrored][state]
+	Result result{};                   // Operation result storage
+
+private:
+	// --- Internal Methods ---
+	/// Sets the internal result state
+	Result SetResult(Result);
+	/// Releases cached frame bitmaps
+	void FreeFrameBitmaps();
+	/// Creates a DIB holding the frame, flipping it if the skin has no mirrored set
+	HBITMAP CreateFrameBitmap(const Skin::Frame&, bool);
+
+public:
+	// --- Lifecycle Management ---
+	~SkinData();
+	SkinData();
+	SkinData(const SkinData&) = delete;
+	SkinData& operator=(const SkinData&) = delete;
+
+	// --- Skin Resource Management ---
+	/// Maps and validates a skin file
+	Result Load(LPCTSTR);
+	/// Unmaps the skin file
+	void Unload();
+	/// Checks if a valid skin is mapped
+	bool IsLoaded() const;
+
+	// --- Frame Access ---
+	/// Resolves frames for a DPI (no-op if unchanged)
+	void SetDpi(UINT);
+	/// Gets the bitmap and frame info for a state
+	HBITMAP GetFrameBitmap(Skin::State, bool, Skin::Frame*);
+
+	// --- Result Management ---
+	/// Gets the last operation result
+	Result GetResult() const;
+};
+
+
+// Interface for system tray adapter
+struct ITrayAdapter
+{
+	// Sets up the tray icon
+	virtual Result SetupTrayIcon(NOTIFYICONDATA&) = 0;
+	// Creates the tray menu
+	virtual Result CreateTrayMenu(HMENU&) = 0;
+};
+
+
+// System Tray Icon Manager
+class TrayManager
+{
+private:
+	// --- Member Variables ---
+	ITrayAdapter* pTrayAdapter{};      // Tray adapter interface 
+	NOTIFYICONDATA trayData{};         // Data for the system tray icon
+	Gdi::OwnedIcon trayIcon{};         // Owns trayData.hIcon
+	HMENU hTrayMenu{};                 // Context menu handle
+	Result result{};                   // Operation result storage
+	Metrics::Counter menuCount{};      // Menus shown
+	Metrics::Counter menuErrors{};     // Menus that failed to show
+
+private:
+	// --- Internal Methods ---
+	/// Sets the internal result state
+	Result SetResult(Result);
+
+public:
+	// --- Lifecycle Management ---
+	~TrayManager();
+	explicit TrayManager(ITrayAdapter*);
+
+	// --- Tray Icon Operations ---
+	/// Creates and displays the system tray icon
+	Result SetupTrayIcon();
+	/// Removes the system tray icon
+	void DeleteTrayIcon();
+	/// Loads the icon resource from executable
+	void GetIconResource(HICON);
+	/// Releases the loaded icon resource
+	void FreeIconResource();
+
+	// --- Menu Operations ---
+	/// Creates the tray context menu
+	Result CreateTrayMenu();
+	/// Destroys the tray context menu
+	Result DestroyTrayMenu();
+	/// Displays and tracks the tray context menu at a screen point
+	Result TrackTrayMenu(const POINT&);
+
+	// --- Interaction Handling ---
+	/// Handles right-click events on the tray icon
+	Result HandleTrayRightClick();
+	/// Shows the tray menu at a screen point (touch long press on the tab)
+	Result ShowMenuAt(const POINT&);
+
+	// --- Metrics ---
+	/// Registers the menu counters
+	void RegisterMetrics(Metrics::Registry&);
+
+	// --- Result Management ---
+	/// Gets the last operation result
+	Result GetResult() const;
+	/// Clears the stored result
+	void ClearResult();
+};
+
+
+// Interface for edge-snapping adapters
+struct ISnapAdapter
+{
+	// Returns target window handle for snapping
+	virtual HWND GetTargetWindow() const = 0;
+	// Gets current snapped edge
+	virtual ScreenEdge GetSnapEdge() const = 0;
+	// Checks if edge is valid for snapping
+	virtual bool IsValidSnapEdge(const ScreenEdge&) const = 0;
+	// Handles successful edge snap with edge and position
+	virtual void OnSnapSuccess(const ScreenEdge&, const POINT&) = 0;
+	// Handles rejected snap attempt
+	virtual void OnSnapRejected(const ScreenEdge&, const POINT&) = 0;
+	// Updates position when no snap occurs
+	virtual void OnSnapEdgeNone(const POINT&) = 0;
+	// Default virtual destructor
+	virtual ~ISnapAdapter() = default;
+};
+
+
+// ScreenEdge-Snapping Controller
+class EdgeSnapData
+{
+private:
+	// --- Configuration Constants ---
+	const int PreviewFrameSize{ 4 };   // Thickness of preview frame
+	const int PreviewSize{ 30 };       // Size of snapping preview indicator
+
+	// --- Member Variables ---
+	ISnapAdapter* pSnapAdapter{};      // Snap adapter interface
+	DragTracker dragTracker{};         // Handles core drag tracking 
+	DragPredictor dragPredictor{};     // Leads the preview ahead of the cursor
+	Gdi::OwnedWindow hPreviewWnd{};    // Preview window handle
+	Render::BackendKind rendererKind{};            // Backend used for the preview
+	Render::IBackend* pRenderer{};     // Preview renderer (created with the window)
+	RECT rcTargetRect{};               // Preview window coordinates
+	bool isEnabled{};                  // Indicates if edge-snapping is active
+	bool isPreviewEnabled{};           // Indicates if edge-snapping is triggered
+	ScreenEdge snapEdge{ ScreenEdge::None };       // Current edge to snap to
+	Result result{};                   // Operation result storage
+	Metrics::Counter snapCount{};      // Drops on a valid edge
+	Metrics::Counter rejectCount{};    // Drops on a rejected edge
+	Metrics::Counter previewDraws{};   // Preview frames drawn
+
+private:
+	// --- Internal Methods ---
+	/// Sets the operation result
+	Result SetResult(Result);
+	/// Creates the visual preview window
+	void CreatePreviewWindow();
+	/// Updates preview window position and appearance
+	void UpdatePreviewWindow();
+	/// Renders the preview graphics
+	Result DrawPreview();
+
+public:
+	// --- Lifecycle Management ---
+	~EdgeSnapData();
+	explicit EdgeSnapData(Render::BackendKind);
+	EdgeSnapData(const EdgeSnapData&) = delete;
+	EdgeSnapData& operator=(const EdgeSnapData&) = delete;
+
+	// --- Snapping Control ---
+	/// Enables edge-snapping behavior
+	bool Enable(ISnapAdapter*);
+	/// Disables edge-snapping behavior
+	void Disable();
+	/// Checks if snapping is active
+	bool IsEnabled() const;
+	/// Checks if snapping is active
+	bool IsPreviewEnabled() const;
+
+	// --- ScreenEdge Detection ---
+	/// Gets currently detected snap edge
+	ScreenEdge GetSnapEdge() const;
+	/// Checks if specific edge is being snapped to
+	bool IsSnapEdge(const ScreenEdge&);
+
+	// --- Drag Operations ---
+	/// Updates snapping state based on current cursor position
+	bool OnMouseMove();
+
+	// --- Metrics ---
+	/// Registers the snap and preview counters
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Window Animation Controller
+class AnimationData
+{
+private:
+	// --- Animation State ---
+	HWND hAnimatedWnd{};              // Handle to window being animated
+	bool isEnabled{};                 // Indicates if an animation is currently active
+	POINT ptCurrentPoint{};           // Current window left-top coordinates
+	POINT ptTargetPoint{};            // Destination coordinates (screen space)
+
+	// --- Metrics ---
+	Metrics::Counter animationCount{};    // Animations started
+	Metrics::Counter stepCount{};         // Window moves made by animations
+	Metrics::Counter moveErrors{};        // Failed SetWindowPos calls
+
+public:
+	// --- Lifecycle Management ---
+	~AnimationData();
+	AnimationData();
+	AnimationData(const AnimationData&) = delete;
+	AnimationData& operator=(const AnimationData&) = delete;
+
+	// --- Animation Control ---
+	/// Starts new animation sequence
+	bool Enable(HWND, const POINT&);
+	/// Stops current animation
+	void Disable();
+	/// Jumps straight to the destination and stops
+	void Finish();
+	/// Checks if animation is currently running
+	bool IsEnabled() const;
+	/// Updates animation state
+	bool Update();
+
+	// --- Metrics ---
+	/// Registers the animation counters
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+// Keyframe Effect Controller (tint, alpha and pulse effects on the tab)
+class EffectData
+{
+private:
+	// --- Configuration Constants ---
+	const UINT defTolerance{ 10 };         // Frame lateness allowed to share a wakeup (ms)
+
+	// --- Effect State ---
+	TimerScheduler* pScheduler{};          // Scheduler delivering the frame timer
+	UINT uTimerID{};                       // Timer armed for the next frame only
+	Effects::Player player{};              // Position in the playing effect
+	Effects::FrameCache frames{};          // Frames rendered once per effect run
+	Metrics::Counter effectCount{};        // Effects started (blink runs)
+	Metrics::Counter frameCount{};         // Frames that changed the tab
+
+public:
+	// --- Lifecycle Management ---
+	~EffectData();
+	EffectData() = default;
+	EffectData(const EffectData&) = delete;
+	EffectData& operator=(const EffectData&) = delete;
+
+	// --- Effect Control ---
+	/// Starts (or restarts) an effect on the scheduler's window
+	bool Enable(TimerScheduler*, const UINT&, const Effects::Effect&);
+	/// Stops the effect and its timer
+	void Disable();
+	/// Checks if an effect is currently playing
+	bool IsEnabled() const;
+
+	// --- Effect Processing ---
+	/// Advances to the current frame and re-arms the timer; true if a redraw is due
+	bool Update();
+	/// Checks if the effect currently tints the tab
+	bool IsHighlighted() const;
+	/// Gets the source image as the current frame shows it
+	Render::ImageView GetFrame(const Render::ImageView&, uint64_t sourceId);
+	/// Gets the frame cache (hit and miss counts)
+	const Effects::FrameCache& GetFrameCache() const;
+
+	// --- Metrics ---
+	/// Registers the effect counters
+	void RegisterMetrics(Metrics::Registry&);
+};
+
+
+
@@ -1,708 +1,1071 @@
-// Implementation-specific headers
-#include "CustomIncludes/WinApi/MessageBoxNotifier.h"
-#include "CustomIncludes/WinApi/Debouncer.h"
-#include "CustomIncludes/WinApi/WindowDragger.h"
-#include "CustomIncludes/WinApi/MouseTracker.h"
-#include "CustomIncludes/WinApi/DoubleClickHelper.h"
-
-// Windows system headers
-#include <windows.h>
-#include <windowsx.h>  // For GET_X_LPARAM, GET_Y_LPARAM
-#include <tchar.h>
-
-#ifdef _DEBUG
-#include "CustomIncludes/WinApi/LogManager.h"
-#endif
-
-
-
-// Custom window message IDs
-#define WM_APP_CUSTOM_MESSAGE       (WM_APP + 2)
-
-// Custom command IDs (LOWORD)
-#define ID_APP_ANIMATION            (3000 + 1)
-#define ID_APP_SYNC_Y_POSITION      (3000 + 2)
-#define ID_APP_DIRECTUI_READY       (3000 + 3)
-#define ID_APP_DOCKMODE             (3000 + 4)
-#define ID_APP_REGULARMODE          (3000 + 5)
-#define ID_APP_FADE                 (3000 + 6)
-
-
-
-namespace
-{
-	// Store globals
-	HINSTANCE g_hInstance  = NULL;  // DLL instance
-	HHOOK g_hHook          = NULL;  // CBT hook handle
-	HWND g_hTabTapMainWnd  = NULL;  // TabTapMainClass handle
-	HWND g_hDirectUIWnd    = NULL;  // DirectUIHWnd handle
-	HWND g_hOSKMainWnd     = NULL;  // OSKMainClass handle
-
-	LPCTSTR g_oskExecPath  = _T("%WINDIR%\\System32\\osk.exe");  // Default path to the on-screen keyboard executable
-
-	WNDPROC g_origOSKMainWndProc  = NULL;  // Original OSKMainClass window procedure
-	WNDPROC g_origDirectUIWndProc = NULL;  // Original DirectUIHWND window procedure
-}
-
-
-
-// Forward declarations
-LRESULT CALLBACK CBTProc(INT, WPARAM, LPARAM);
-
-
-
-extern "C" __declspec(dllexport)
-BOOL UninstallHook()
-{
-	if (!g_hHook) {
-#ifdef _DEBUG
-		LogManager::WriteLog(_T("No hook to remove."));
-#endif // _DEBUG
-		return FALSE;
-	}
-	if (!UnhookWindowsHookEx(g_hHook)) {
-#ifdef _DEBUG
-		LogManager::WriteLog(_T("Failed to remove hook: %lu"), GetLastError());
-#endif // _DEBUG
-		return FALSE;
-	}
-	g_hHook = NULL;
-
-	return TRUE;
-}
-
-extern "C" __declspec(dllexport)
-BOOL InstallHook(DWORD threadId)
-{
-	g_hHook = SetWindowsHookEx(
-		WH_CBT,
-		CBTProc,
-		g_hInstance,
-		threadId
-	);
-
-	if (!g_hHook) {
-#ifdef _DEBUG
-		LogManager::WriteLog(_T("Failed to set windows hook: %lu"), GetLastError());
-#endif // _DEBUG
-		return FALSE;
-	}
-	return TRUE;
-}
-
-
-BOOL APIENTRY DllMain(
-	HINSTANCE hInstance,
-	DWORD dwReason,
-	LPVOID lpReserved)
-{
-	switch (dwReason)
-	{
-	case DLL_PROCESS_ATTACH:
-	{
-		g_hInstance = hInstance;
-		DisableThreadLibraryCalls(hInstance);  // Optional
-		break;
-	}
-	case DLL_PROCESS_DETACH:
-	{
-		if (g_hHook != NULL) {
-			UnhookWindowsHookEx(g_hHook);
-			g_hHook = NULL;
-		}
-		break;
-	}
-	case DLL_THREAD_ATTACH:
-	case DLL_THREAD_DETACH:
-	default:
-		break;
-	}
-	return TRUE;
-}
-
-
-LRESULT CALLBACK DirectUIWndProc(
-	HWND hWnd,
-	UINT msg,
-	WPARAM wParam,
-	LPARAM lParam)
-{
-	DoubleClickHelper::ProcessMessage(msg, lParam);
-
-	switch (msg)
-	{
-
-	case WM_MOUSEWHEEL:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_MOUSEWHEEL, wParam, lParam);
-		return 0;
-	}
-
-	case WM_RBUTTONDOWN:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_RBUTTONDOWN, wParam, lParam);
-		return 0;
-	}
-
-	case WM_RBUTTONUP:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_RBUTTONUP, wParam, lParam);
-		return 0;
-	}
-
-	case WM_RBUTTONDBLCLK:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_RBUTTONDBLCLK, wParam, lParam);
-		return 0;
-	}
-
-	case WM_MBUTTONDOWN:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_MBUTTONDOWN, wParam, lParam);
-		return 0;
-	}
-
-	case WM_MBUTTONUP:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_MBUTTONUP, wParam, lParam);
-		return 0;
-	}
-
-	case WM_MBUTTONDBLCLK:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_MBUTTONDBLCLK, wParam, lParam);
-		return 0;
-	}
-
-	case WM_MOUSEMOVE:
-	{
-		// Forward event to the parent window
-		PostMessage(g_hOSKMainWnd, WM_MOUSEMOVE, wParam, lParam);
-		break;
-	}
-
-	default: break;
-	}
-
-	return CallWindowProc(g_origDirectUIWndProc, hWnd, msg, wParam, lParam);
-}
-
-
-LRESULT CALLBACK OSKMainWndProc(
-	HWND hWnd,
-	UINT msg,
-	WPARAM wParam,
-	LPARAM lParam)
-{
-	static WindowDragger windowDragger{};
-	static MouseTracker mouseTracker{ hWnd };
-	static Debouncer mouseWheelDebounce{ 100 };
-
-
-	switch (msg)
-	{
-	case WM_MOUSEMOVE:
-	{
-		mouseTracker.OnMouseMove();
-
-		windowDragger.OnMouseMove(
-			[&hWnd](const POINT& pt, nullptr_t) {
-				return SetWindowPos(
-					hWnd,
-					NULL,  // No change in Z-order relative to other windows
-					pt.x, pt.y,
-					0, 0,  // No change in size
-					SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
-				) != 0;
-			},
-			nullptr
-		);
-
-		return 0;
-	}
-
-	case WM_MOUSELEAVE:
-	{
-		mouseTracker.OnMouseLeave();
-		return 0;
-	}
-
-	case WM_MOUSEWHEEL:
-	{
-		if (!mouseWheelDebounce.ShouldProcess()) { return 0; }
-
-		int delta = GET_WHEEL_DELTA_WPARAM(wParam);
-		bool forward = delta > 0;
-
-		// Get installed keyboard layouts
-		int layoutCount = GetKeyboardLayoutList(0, nullptr);
-		if (layoutCount <= 1) {
-			return 0;
-		}  // No need to switch if <=1 layout
-
-		HKL* layouts = new HKL[layoutCount];
-		GetKeyboardLayoutList(layoutCount, layouts);
-
-		// Find current layout position
-		HWND hForegroundWnd = GetForegroundWindow();
-		DWORD threadProcessId = GetWindowThreadProcessId(hForegroundWnd, nullptr);
-		HKL current = GetKeyboardLayout(threadProcessId);
-		int currentIndex = -1;
-		for (int i{}; i < layoutCount; ++i) {
-			if (layouts[i] == current) {
-				currentIndex = i;
-				break;
-			}
-		}
-
-		if (currentIndex == -1) {
-			delete[] layouts;
-			return 0;
-		}
-
-		// Calculate new index with boundary checks
-		int newIndex = forward ? currentIndex + 1 : currentIndex - 1;
-		if (newIndex < 0 or newIndex >= layoutCount) {
-			delete[] layouts;
-			return 0;  // Stop at boundaries
-		}
-
-		// System-wide activation
-		HKL newLayout = layouts[newIndex];
-		ActivateKeyboardLayout(newLayout, KLF_ACTIVATE);
-
-		// Update taskbar and all applications
-		PostMessage(HWND_BROADCAST, WM_INPUTLANGCHANGE, 0, (LPARAM)newLayout);
-		PostMessage(hForegroundWnd, WM_INPUTLANGCHANGEREQUEST, INPUTLANGCHANGE_SYSCHARSET, (LPARAM)newLayout);
-
-		delete[] layouts;
-		return 0;
-	}
-
-	case WM_STYLECHANGING:
-	{
-		if (wParam == GWL_STYLE) {
-			// Forced frame for `Dock` mode
-			//((STYLESTRUCT*)lParam)->styleNew |= WS_THICKFRAME;
-		}
-		break;
-	}
-
-	case WM_WINDOWPOSCHANGING:
-	{
-		// Prevent changing the size and position when enabling `Dock` mode
-		if (((PWINDOWPOS)lParam)->cx == GetSystemMetrics(SM_CXSCREEN)) {
-			((PWINDOWPOS)lParam)->flags = (NULL
-				| SWP_NOSIZE
-				| SWP_NOMOVE
-				| SWP_NOACTIVATE
-				| SWP_NOSENDCHANGING
-				);
-			return 0;
-		}
-		break;
-	}
-
-	case WM_NCMBUTTONDOWN:
-	{
-		// Repositioning the First App on middle button down of the 'X'
-		if (wParam == HTCLOSE) {
-			PostMessage(
-				g_hTabTapMainWnd,
-				WM_APP_CUSTOM_MESSAGE,
-				MAKEWPARAM(ID_APP_SYNC_Y_POSITION, 0),
-				(LPARAM)hWnd
-			);
-			return 0;
-		}
-
-		if (wParam == HTSYSMENU) {
-			// TODO
-			return 0;
-		}
-
-		// In general, it simulates a middle click in the client zone
-		PostMessage(hWnd, WM_MBUTTONDOWN, wParam, lParam); // Drag trigger
-		return 0;
-	}
-
-	case WM_NCMBUTTONUP:
-	{
-		// Hiding the OSK on middle button up of the 'X'
-		if (wParam == HTCLOSE) {
-			ShowWindow(hWnd, SW_HIDE);
-			return 0;  // Prevent default behavior
-		}
-		break;
-	}
-
-	case WM_MBUTTONDOWN:
-	{
-		// Drag begin
-		if (!windowDragger.Enable(hWnd)) {
-			MessageBoxNotifier{
-				{ _T("Drag Error") },
-				{ _T("Failed to start drag operation. %s"),
-					ErrorMessageConverter(GetLastError()) }
-			}.ShowError(hWnd);
-			return 1;
-		}
-		return 0;
-	}
-
-	case WM_MBUTTONUP:
-	{
-		// Drag end
-		if (!windowDragger.Disable()) {
-			MessageBoxNotifier{
-				{ _T("Drag Error") },
-				{ _T("Failed to finish drag operation. %s"),
-					ErrorMessageConverter(GetLastError()) }
-			}.ShowError(hWnd);
-			return 1;
-		}
-		return 0;
-	}
-
-	case WM_MBUTTONDBLCLK:
-	{
-		ShowWindow(hWnd, SW_HIDE);
-		return 0;
-	}
-
-	case WM_RBUTTONDOWN:
-	{
-		// Act as middle button
-		PostMessage(hWnd, WM_MBUTTONDOWN, wParam, lParam);
-		return 0;
-	}
-
-	case WM_RBUTTONUP:
-	{
-		// Act as middle button
-		PostMessage(hWnd, WM_MBUTTONUP, wParam, lParam);
-		return 0;
-	}
-
-	case WM_RBUTTONDBLCLK:
-	{
-		// Act as middle button
-		PostMessage(hWnd, WM_MBUTTONDBLCLK, wParam, lParam);
-		return 0;
-	}
-
-	case WM_CLOSE:
-	{
-		// Change the 'X' buttons behavior from 'Close' to 'Hide' and use lParam to indicate a real 'Close' event
-		if ((BOOL)lParam == TRUE) { // Abuse lParam for custom behavior
-			break;
-		}
-		ShowWindow(hWnd, SW_HIDE);
-		return 0; // Message handled
-	}
-
-	case WM_APP_CUSTOM_MESSAGE:
-	{
-		WORD wCommandId = LOWORD(wParam);
-
-		if (wCommandId == ID_APP_DIRECTUI_READY) {
-			if (!g_hDirectUIWnd) { break; }
-
-			// Store the original window procedure.
-			g_origDirectUIWndProc = reinterpret_cast<WNDPROC>(
-				GetWindowLongPtr(g_hDirectUIWnd, GWLP_WNDPROC)
-			);
-
-			// Subclass DirectUIHWND
-			SetWindowLongPtr(
-				g_hDirectUIWnd,
-				GWLP_WNDPROC,
-				(LONG_PTR)DirectUIWndProc
-			);
-			return 0;
-		}
-
-		if (wCommandId == ID_APP_DOCKMODE) {
-			ShowWindow(hWnd, SW_HIDE);
-			LONG_PTR style = (NULL
-				//| WS_VISIBLE
-				| WS_CLIPSIBLINGS
-				| WS_CLIPCHILDREN
-				| WS_SYSMENU
-				//| WS_MINIMIZEBOX
-				);
-			SetWindowLongPtr(hWnd, GWL_STYLE, style);
-
-			LONG_PTR exstyle = (NULL
-				| WS_EX_NOACTIVATE
-				| WS_EX_LAYERED
-				//| WS_EX_APPWINDOW
-				| WS_EX_WINDOWEDGE
-				| WS_EX_TOOLWINDOW
-				| WS_EX_TOPMOST
-				);
-			SetWindowLongPtr(hWnd, GWL_EXSTYLE, exstyle);
-
-			ShowWindow(hWnd, SW_SHOW);
-			return 0;
-		}
-
-		if (wCommandId == ID_APP_REGULARMODE) {
-			ShowWindow(hWnd, SW_HIDE);
-
-			LONG_PTR style = (NULL
-				//| WS_VISIBLE
-				| WS_CLIPSIBLINGS
-				| WS_CLIPCHILDREN
-				| WS_BORDER
-				| WS_DLGFRAME
-				| WS_SYSMENU
-				| WS_THICKFRAME
-				//| WS_MINIMIZEBOX
-				);
-			SetWindowLongPtr(hWnd, GWL_STYLE, style);
-
-			LONG_PTR exstyle = (NULL
-				| WS_EX_NOACTIVATE
-				| WS_EX_LAYERED
-				//| WS_EX_APPWINDOW
-				| WS_EX_TOPMOST
-				);
-			SetWindowLongPtr(hWnd, GWL_EXSTYLE, exstyle);
-
-			ShowWindow(hWnd, SW_SHOW);
-			return 0;
-		}
-
-		if (wCommandId == ID_APP_FADE) {
-			static BYTE opaque = 0xff;
-			static const BYTE MaxOpaque = 0xff;
-			static const BYTE MinOpaque = 0x20;
-
-			bool isIncrease = HIWORD(wParam);
-
-			if (isIncrease and opaque < MaxOpaque) {
-				opaque += 0x10;
-			}
-			else if (!isIncrease and opaque > MinOpaque) {
-				opaque -= 0x10;
-			}
-
-			SetLayeredWindowAttributes(
-				hWnd, 0,
-				opaque,
-				LWA_ALPHA
-			);
-
-			return 0;
-		}
-		return 1;
-	}
-
-	case WM_DESTROY:
-	{
-		break;
-	}
-
-	default: break;
-	}
-
-	return CallWindowProc(g_origOSKMainWndProc, hWnd, msg, wParam, lParam);
-}
-
-
-LRESULT CALLBACK CBTProc(
-	INT nCode,
-	WPARAM wParam,
-	LPARAM lParam)
-{
-	if (nCode < 0) {
-		return CallNextHookEx(g_hHook, nCode, wParam, lParam);
-	}
-
-	switch (nCode)
-	{
-
-	case HCBT_CREATEWND:
-	{
-		HWND hWnd = (HWND)wParam;
-		TCHAR szClassName[MAX_PATH]{};
-		// Retrieve the window class name
-		if (!GetClassName(hWnd, szClassName, sizeof(szClassName) / sizeof(TCHAR))) {
-			break;
-		}
-
-		if (wcscmp(szClassName, _T("DirectUIHWND")) == 0) {
-			// Store handle as global
-			g_hDirectUIWnd = hWnd;
-
-			// Notify that proc can be subclassed now
-			PostMessage(
-				g_hOSKMainWnd,
-				WM_APP_CUSTOM_MESSAGE,
-				MAKEWPARAM(ID_APP_DIRECTUI_READY, 0),
-				(LPARAM)hWnd
-			);
-
-
-			// Open the named event created by the first app
-			HANDLE hEvent = OpenEvent(EVENT_MODIFY_STATE, FALSE, _T("OSKLoadEvent"));
-			if (hEvent != NULL) {
-				// Signal the event indicating that this app has finished loading
-				SetEvent(hEvent);
-				CloseHandle(hEvent);
-			}
-		}
-		return 0;
-	}
-
-	case HCBT_ACTIVATE:
-	{
-		HWND hWnd = (HWND)wParam;
-		TCHAR szClassName[MAX_PATH]{};
-		// Retrieve the window class name
-		if (!GetClassName(hWnd, szClassName, sizeof(szClassName) / sizeof(TCHAR))) {
-			break;
-		}
-
-		if (_tcscmp(szClassName, _T("OSKMainClass")) == 0) {
-			static BOOL bProcessed{}; // To process only once
-			if (bProcessed) {
-				break;
-			}
-			bProcessed = TRUE;
-
-
-			// Store the original window procedure
-			g_origOSKMainWndProc = (WNDPROC)GetWindowLongPtr(
-				hWnd,
-				GWLP_WNDPROC
-			);
-			// Replace original procedure
-			SetWindowLongPtr(
-				hWnd,
-				GWLP_WNDPROC,
-				(LONG_PTR)OSKMainWndProc
-			);
-
-			// Remove `Minimize` box
-			LONG_PTR style = GetWindowLongPtr(hWnd, GWL_STYLE);
-			style &= ~WS_MINIMIZEBOX;
-			SetWindowLongPtr(hWnd, GWL_STYLE, style);
-
-			// Remove from Taskbar
-			LONG_PTR exstyle = GetWindowLongPtr(hWnd, GWL_EXSTYLE);
-			exstyle &= ~WS_EX_APPWINDOW;
-			SetWindowLongPtr(hWnd, GWL_EXSTYLE, exstyle);
-
-			// Edit `System Menu`
-			HMENU hSysMenu = GetSystemMenu(hWnd, FALSE);
-			DeleteMenu(hSysMenu, SC_RESTORE, MF_BYCOMMAND);
-			DeleteMenu(hSysMenu, SC_MINIMIZE, MF_BYCOMMAND);
-			DeleteMenu(hSysMenu, SC_MAXIMIZE, MF_BYCOMMAND);
-
-			// Apply style changes
-			SetWindowPos(hWnd, NULL, 0, 0, 0, 0,
-				SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
-
-
-			// Store the first app handle as global
-			g_hTabTapMainWnd = FindWindow(_T("TabTapMainClass"), NULL);
-
-			// Store the main handle as global
-			g_hOSKMainWnd = hWnd;
-
-			// Show after changes
-			ShowWindowAsync(hWnd, SW_SHOW); // `SW_SHOWNA` causes flickering
-
-			// Increment DLL reference count
-			HMODULE hMod;
-			if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, (LPCWSTR)OSKMainWndProc, &hMod)) {
-				TCHAR pathBuffer[MAX_PATH];
-				GetModuleFileName(hMod, pathBuffer, MAX_PATH);
-				LoadLibrary(pathBuffer);
-			}
-
-#ifdef _DEBUG
-			// Set log path
-			LogManager::SetDirectory(_T("C:\\"));  // Picked OSK path by default
-#endif // _DEBUG
-
-		}
-		return 0;
-	}
-
-	//Keeping the hook active and dropping focus here doesnt work either
-	/*
-	case HCBT_SETFOCUS:
-	{
-		return 1;
-	}
-	*/
-	default: break;
-	}
-
-	return CallNextHookEx(g_hHook, nCode, wParam, lParam);
-}
-
-
-
-
-
-
-
-/*
-	//=========================
-	// Dock
-	//=========================
-
-	0x160A0000  GWL_STYLE
-	----------
-	0x10000000  WS_VISIBLE
-	0x04000000  WS_CLIPSIBLINGS
-	0x02000000  WS_CLIPCHILDREN
-	0x00080000  WS_SYSMENU
-	0x00020000  WS_MINIMIZEBOX
-
-
-	0x080C0188  GWL_EXSTYLE
-	----------
-	0x08000000  WS_EX_NOACTIVATE
-	0x00080000  WS_EX_LAYERED
-	0x00040000  WS_EX_APPWINDOW
-	0x00000100  WS_EX_WINDOWEDGE
-	0x00000080  WS_EX_TOOLWINDOW
-	0x00000008  WS_EX_TOPMOST
-*/
-/*
-	//=========================
-	// Regular
-	//=========================
-
-	0x16CE0000  GWL_STYLE
-	----------
-	0x10000000  WS_VISIBLE
-	0x04000000  WS_CLIPSIBLINGS
-	0x02000000  WS_CLIPCHILDREN
-	0x00800000  WS_BORDER
-	0x00400000  WS_DLGFRAME
-	0x00080000  WS_SYSMENU
-	0x00040000  WS_THICKFRAME
-	0x00020000  WS_MINIMIZEBOX
-
-
-	0x080C0008  GWL_EXSTYLE
-	----------
-	0x08000000  WS_EX_NOACTIVATE
-	0x00080000  WS_EX_LAYERED
-	0x00040000  WS_EX_APPWINDOW
-	0x00000008  WS_EX_TOPMOST
-*/
-
+// Implementation-specific headers
+#include "CustomIncludes/WinApi/MessageBoxNotifier.h"
+#include "CustomIncludes/WinApi/Debouncer.h"
+#include "CustomIncludes/WinApi/WindowDragger.h"
+#include "CustomIncludes/WinApi/MouseTracker.h"
+#include "CustomIncludes/WinApi/DoubleClickHelper.h"
+#include "DragPredictor.h"
+#include "TraceChannel.h"
+#include "MetricsChannel.h"
+#include "ProcessQos.h"
+#include "MonitorTopology.h"
+#include "AppPaths.h"
+#include "Core/AsyncLogger.h"
+#include "Core/MessageProfiler.h"
+#include "Core/OskAttach.h"
+
+// Windows system headers
+#include <windows.h>
+#include <windowsx.h>  // For GET_X_LPARAM, GET_Y_LPARAM
+#include <tchar.h>
+
+// Standard library headers
+#include <iterator>
+
+
+
+// Custom window message IDs
+#define WM_APP_CUSTOM_MESSAGE       (WM_APP + 2)
+
+// Custom command IDs (LOWORD)
+#define ID_APP_ANIMATION            (3000 + 1)
+#define ID_APP_SYNC_Y_POSITION      (3000 + 2)
+#define ID_APP_DIRECTUI_READY       (3000 + 3)
+#define ID_APP_DOCKMODE             (3000 + 4)
+#define ID_APP_REGULARMODE          (3000 + 5)
+#define ID_APP_FADE                 (3000 + 6)
+#define ID_APP_SKIN_RELOADED        (3000 + 7)
+#define ID_APP_PROFILE_DUMP         (3000 + 8)
+#define ID_APP_SETTINGS_ERROR       (3000 + 9)
+#define ID_APP_HOOK_PING            (3000 + 10)
+#define ID_APP_RECONNECT            (3000 + 11)
+#define ID_APP_OSK_EXITED           (3000 + 12)
+#define ID_APP_LAYOUT_CHANGED       (3000 + 13)
+#define ID_APP_AUTO_SHOW            (3000 + 14)
+#define ID_APP_CARET_MOVED          (3000 + 15)
+#define ID_APP_OSK_RESTARTED        (3000 + 16)
+
+
+
+namespace
+{
+	// Store globals
+	HINSTANCE g_hInstance  = NULL;  // DLL instance
+	HHOOK g_hHook          = NULL;  // CBT hook handle
+	HWND g_hTabTapMainWnd  = NULL;  // TabTapMainClass handle
+	HWND g_hDirectUIWnd    = NULL;  // DirectUIHWnd handle
+	HWND g_hOSKMainWnd     = NULL;  // OSKMainClass handle
+
+	LPCTSTR g_oskExecPath  = _T("%WINDIR%\\System32\\osk.exe");  // Default path to the on-screen keyboard executable
+
+	WNDPROC g_origOSKMainWndProc  = NULL;  // Original OSKMainClass window procedure
+	WNDPROC g_origDirectUIWndProc = NULL;  // Original DirectUIHWND window procedure
+
+	TraceChannel g_traceChannel{};         // Trace ring shared with TabTap
+	MetricsChannel g_metricsChannel{};     // Metrics registry shared with TabTap
+	Logging::AsyncLogger g_log{};          // Hook log (started inside osk.exe)
+
+	// osk.exe stays at normal scheduling while visible and idle
+	Power::PowerPolicy g_power{ { 5000, 15000, Power::Qos::Normal, Power::Qos::High } };
+
+	BYTE g_opacity = 0xff;                 // OSK layered window alpha (ID_APP_FADE)
+
+	// Hook metrics (inert until the registry is opened)
+	Metrics::Counter g_commandCount{};     // TabTap commands handled
+	Metrics::Histogram g_commandDelay{};   // Time those commands waited in the queue (ms)
+	Metrics::Histogram g_styleSwitch{};    // Dock/regular switch time (us)
+	Metrics::Counter g_slowStyleSwitch{};  // Switches over StyleSwitchBudgetUs
+	Metrics::Counter g_syncCount{};        // Position syncs posted to TabTap
+}
+
+
+
+// Forward declarations
+LRESULT CALLBACK CBTProc(INT, WPARAM, LPARAM);
+LRESULT CALLBACK GetMsgProc(INT, WPARAM, LPARAM);
+LRESULT CALLBACK OSKMainWndProc(HWND, UINT, WPARAM, LPARAM);
+
+
+
+// Subclassed window procedure handler profiles (TABTAP_PROFILE builds only)
+namespace Profile
+{
+	constexpr Profiling::Key OSKMainKeys[] = {
+		{ WM_MOUSEMOVE, 0,                                 "WM_MOUSEMOVE" },
+		{ WM_MOUSELEAVE, 0,                                "WM_MOUSELEAVE" },
+		{ WM_MOUSEWHEEL, 0,                                "WM_MOUSEWHEEL" },
+		{ WM_STYLECHANGING, 0,                             "WM_STYLECHANGING" },
+		{ WM_WINDOWPOSCHANGING, 0,                         "WM_WINDOWPOSCHANGING" },
+		{ WM_NCMBUTTONDOWN, 0,                             "WM_NCMBUTTONDOWN" },
+		{ WM_NCMBUTTONUP, 0,                               "WM_NCMBUTTONUP" },
+		{ WM_MBUTTONDOWN, 0,                               "WM_MBUTTONDOWN" },
+		{ WM_MBUTTONUP, 0,                                 "WM_MBUTTONUP" },
+		{ WM_MBUTTONDBLCLK, 0,                             "WM_MBUTTONDBLCLK" },
+		{ WM_RBUTTONDOWN, 0,                               "WM_RBUTTONDOWN" },
+		{ WM_RBUTTONUP, 0,                                 "WM_RBUTTONUP" },
+		{ WM_RBUTTONDBLCLK, 0,                             "WM_RBUTTONDBLCLK" },
+		{ WM_CLOSE, 0,                                     "WM_CLOSE" },
+		{ WM_SHOWWINDOW, 0,                                "WM_SHOWWINDOW" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_DIRECTUI_READY,    "CUSTOM/DIRECTUI_READY" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_DOCKMODE,          "CUSTOM/DOCKMODE" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_REGULARMODE,       "CUSTOM/REGULARMODE" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_FADE,              "CUSTOM/FADE" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_PROFILE_DUMP,      "CUSTOM/PROFILE_DUMP" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_HOOK_PING,         "CUSTOM/HOOK_PING" },
+		{ WM_APP_CUSTOM_MESSAGE, ID_APP_RECONNECT,         "CUSTOM/RECONNECT" },
+		{ WM_DESTROY, 0,                                   "WM_DESTROY" },
+	};
+
+	constexpr Profiling::Key DirectUIKeys[] = {
+		{ WM_MOUSEWHEEL, 0,                                "WM_MOUSEWHEEL" },
+		{ WM_RBUTTONDOWN, 0,                               "WM_RBUTTONDOWN" },
+		{ WM_RBUTTONUP, 0,                                 "WM_RBUTTONUP" },
+		{ WM_RBUTTONDBLCLK, 0,                             "WM_RBUTTONDBLCLK" },
+		{ WM_MBUTTONDOWN, 0,                               "WM_MBUTTONDOWN" },
+		{ WM_MBUTTONUP, 0,                                 "WM_MBUTTONUP" },
+		{ WM_MBUTTONDBLCLK, 0,                             "WM_MBUTTONDBLCLK" },
+		{ WM_MOUSEMOVE, 0,                                 "WM_MOUSEMOVE" },
+	};
+
+#ifdef TABTAP_PROFILE
+	Profiling::MessageProfiler<std::size(OSKMainKeys)> OSKMainTable{ OSKMainKeys };
+	Profiling::MessageProfiler<std::size(DirectUIKeys)> DirectUITable{ DirectUIKeys };
+#endif // TABTAP_PROFILE
+}
+
+#define PROFILE_OSKMAIN(message, command) \
+	PROFILE_HANDLER(Profile::OSKMainTable, Profile::OSKMainKeys, message, command)
+#define PROFILE_DIRECTUI(message, command) \
+	PROFILE_HANDLER(Profile::DirectUITable, Profile::DirectUIKeys, message, command)
+
+
+// Applies a changed hook power decision to the osk.exe process
+void ApplyHookPower()
+{
+	Power::Decision decision{};
+	if (g_power.TakeChange(&decision)) {
+		ApplyProcessQos(decision.qos);
+		LOG_DEBUG(g_log, "OSK qos {}", decision.qos);
+	}
+}
+
+// Moves the still hidden OSK to its last position for this monitor layout
+// and restores its opacity from the session state written by TabTap
+void RestoreOskPlacement(HWND hWnd)
+{
+	Snapshot::State state{};
+	const Snapshot::Status status = Snapshot::Load(GetAppFilePath(_T("TabTap.state")), &state);
+	if (status != Snapshot::Status::Ok) {
+		LOG_INFO(g_log, "Session state: {}", Snapshot::GetStatusName(status));
+		return;
+	}
+
+	if (const Snapshot::Placement* pPlacement = Snapshot::FindPlacement(state, GetMonitorTopologyId())) {
+		SetWindowPos(hWnd, NULL, pPlacement->oskLeft, pPlacement->oskTop, 0, 0,
+			SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+		LOG_INFO(g_log, "Restored OSK at {}, {}", pPlacement->oskLeft, pPlacement->oskTop);
+	}
+
+	g_opacity = state.opacity;
+	if (g_opacity < 0xff and (GetWindowLongPtr(hWnd, GWL_EXSTYLE) & WS_EX_LAYERED)) {
+		SetLayeredWindowAttributes(hWnd, 0, g_opacity, LWA_ALPHA);
+	}
+}
+
+
+
+// Precomputed OSKMainClass styles for the forced dock and regular modes
+struct StyleProfile
+{
+	LONG_PTR style;
+	LONG_PTR exStyle;
+};
+
+namespace StyleProfiles
+{
+	constexpr StyleProfile Dock{
+		(NULL
+			//| WS_VISIBLE  // Kept from the current window state
+			| WS_CLIPSIBLINGS
+			| WS_CLIPCHILDREN
+			| WS_SYSMENU
+			//| WS_MINIMIZEBOX
+			),
+		(NULL
+			| WS_EX_NOACTIVATE
+			| WS_EX_LAYERED
+			//| WS_EX_APPWINDOW
+			| WS_EX_WINDOWEDGE
+			| WS_EX_TOOLWINDOW
+			| WS_EX_TOPMOST
+			)
+	};
+
+	constexpr StyleProfile Regular{
+		(NULL
+			//| WS_VISIBLE  // Kept from the current window state
+			| WS_CLIPSIBLINGS
+			| WS_CLIPCHILDREN
+			| WS_BORDER
+			| WS_DLGFRAME
+			| WS_SYSMENU
+			| WS_THICKFRAME
+			//| WS_MINIMIZEBOX
+			),
+		(NULL
+			| WS_EX_NOACTIVATE
+			| WS_EX_LAYERED
+			//| WS_EX_APPWINDOW
+			| WS_EX_TOPMOST
+			)
+	};
+}
+
+// Attaches to the TabTap metrics registry and registers the hook metrics
+void OpenHookMetrics()
+{
+	if (!g_metricsChannel.Open()) { return; }
+
+	Metrics::Registry& registry = g_metricsChannel.GetRegistry();
+	g_commandCount = registry.AddCounter("tabtap_hook_commands_total", "Commands handled by the hook");
+	g_commandDelay = registry.AddHistogram("tabtap_hook_command_delay_ms",
+		"Time from posting a command to the hook handling it", { 1, 2, 5, 10, 20, 50, 100, 250 });
+	g_styleSwitch = registry.AddHistogram("tabtap_hook_style_switch_us",
+		"OSK dock/regular switch time in microseconds", { 500, 1000, 2500, 5000, 10000, 25000, 50000 });
+	g_slowStyleSwitch = registry.AddCounter("tabtap_hook_style_switch_slow_total",
+		"OSK dock/regular switches that took longer than one frame");
+	g_syncCount = registry.AddCounter("tabtap_hook_sync_requests_total", "Position syncs requested from the OSK");
+}
+
+// Counts a command from TabTap and how long it was queued (round trip to the handler)
+void CountHookCommand()
+{
+	g_commandCount.Add();
+	g_commandDelay.Observe(DWORD(GetTickCount() - DWORD(GetMessageTime())));
+}
+
+// A switch is meant to land within one 60 Hz frame
+constexpr LONGLONG StyleSwitchBudgetUs = 16667;
+
+// Applies a style profile in a single frame transition (no hide/show cycle,
+// so the OSK keeps its layout). A hidden OSK is shown by the same transition,
+// as the old hide/show switch did. Returns the switch time in microseconds.
+LONGLONG ApplyStyleProfile(HWND hWnd, const StyleProfile& profile)
+{
+	LARGE_INTEGER frequency{}, start{}, end{};
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+
+	const LONG_PTR visible = GetWindowLongPtr(hWnd, GWL_STYLE) & WS_VISIBLE;
+	SetWindowLongPtr(hWnd, GWL_EXSTYLE, profile.exStyle);
+	SetWindowLongPtr(hWnd, GWL_STYLE, profile.style | visible);
+
+	// Recalculate the frame, show, and repaint once, synchronously
+	SetWindowPos(hWnd, HWND_TOPMOST, 0, 0, 0, 0,
+		SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_FRAMECHANGED | SWP_SHOWWINDOW);
+	UpdateWindow(hWnd);
+
+	QueryPerformanceCounter(&end);
+	return (end.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart;
+}
+
+// Switches the OSK mode and checks the switch against the frame budget
+void SwitchOskMode(HWND hWnd, const StyleProfile& profile, const char* pszMode)
+{
+	const LONGLONG elapsedUs = ApplyStyleProfile(hWnd, profile);
+	g_styleSwitch.Observe(uint64_t(elapsedUs));
+
+	if (elapsedUs > StyleSwitchBudgetUs) {
+		g_slowStyleSwitch.Add();
+		LOG_WARNING(g_log, "Switched OSK to {} mode in {} us, over the {} us frame budget",
+			pszMode, elapsedUs, StyleSwitchBudgetUs);
+		return;
+	}
+	LOG_INFO(g_log, "Switched OSK to {} mode in {} us", pszMode, elapsedUs);
+}
+
+// Attaches to the TabTap trace ring and metrics (retried on reconnect)
+void OpenSharedChannels()
+{
+	g_traceChannel.Open();
+	if (!g_metricsChannel.IsOpen()) {
+		OpenHookMetrics();
+	}
+}
+
+// Tells the waiting TabTap that the OSK windows are hooked
+void SignalLoadEvent()
+{
+	// Open the named event created by the first app
+	HANDLE hEvent = OpenEvent(EVENT_MODIFY_STATE, FALSE, _T("OSKLoadEvent"));
+	if (hEvent != NULL) {
+		// Signal the event indicating that this app has finished loading
+		SetEvent(hEvent);
+		CloseHandle(hEvent);
+	}
+}
+
+// Subclasses OSKMainClass, trims its frame and pins the DLL in osk.exe.
+// A freshly created window is also shown at its restored position; an
+// adopted one keeps its place and visibility.
+void AdoptOSKMainWindow(HWND hWnd, bool isCreated)
+{
+	if (g_origOSKMainWndProc) { return; }  // To process only once
+
+	// Store the original window procedure
+	g_origOSKMainWndProc = (WNDPROC)GetWindowLongPtr(
+		hWnd,
+		GWLP_WNDPROC
+	);
+	// Replace original procedure
+	SetWindowLongPtr(
+		hWnd,
+		GWLP_WNDPROC,
+		(LONG_PTR)OSKMainWndProc
+	);
+
+	// Remove `Minimize` box
+	LONG_PTR style = GetWindowLongPtr(hWnd, GWL_STYLE);
+	style &= ~WS_MINIMIZEBOX;
+	SetWindowLongPtr(hWnd, GWL_STYLE, style);
+
+	// Remove from Taskbar
+	LONG_PTR exstyle = GetWindowLongPtr(hWnd, GWL_EXSTYLE);
+	exstyle &= ~WS_EX_APPWINDOW;
+	SetWindowLongPtr(hWnd, GWL_EXSTYLE, exstyle);
+
+	// Edit `System Menu`
+	HMENU hSysMenu = GetSystemMenu(hWnd, FALSE);
+	DeleteMenu(hSysMenu, SC_RESTORE, MF_BYCOMMAND);
+	DeleteMenu(hSysMenu, SC_MINIMIZE, MF_BYCOMMAND);
+	DeleteMenu(hSysMenu, SC_MAXIMIZE, MF_BYCOMMAND);
+
+	// Apply style changes
+	SetWindowPos(hWnd, NULL, 0, 0, 0, 0,
+		SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_FRAMECHANGED);
+
+
+	// Store the first app handle as global
+	g_hTabTapMainWnd = FindWindow(_T("TabTapMainClass"), NULL);
+
+	// Store the main handle as global
+	g_hOSKMainWnd = hWnd;
+
+	// Show after changes
+	if (isCreated) {
+		ShowWindowAsync(hWnd, SW_SHOW); // `SW_SHOWNA` causes flickering
+	}
+
+	// Increment DLL reference count
+	HMODULE hMod;
+	if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, (LPCWSTR)OSKMainWndProc, &hMod)) {
+		TCHAR pathBuffer[MAX_PATH];
+		GetModuleFileName(hMod, pathBuffer, MAX_PATH);
+		LoadLibrary(pathBuffer);
+	}
+
+	// Start the hook log next to the DLL
+	if (g_log.Start(GetAppFilePath(_T("TabTap.hook.log")))) {
+		LOG_INFO(g_log, "Hook {} OSK process {}", isCreated ? "attached to" : "adopted", GetCurrentProcessId());
+	}
+
+	// The show above is queued, so the OSK appears at the restored position
+	if (isCreated) {
+		RestoreOskPlacement(hWnd);
+	}
+}
+
+
+
+extern "C" __declspec(dllexport)
+BOOL UninstallHook()
+{
+	if (!g_hHook) {
+		LOG_WARNING(g_log, "No hook to remove");
+		return FALSE;
+	}
+	if (!UnhookWindowsHookEx(g_hHook)) {
+		LOG_ERROR(g_log, "Failed to remove hook: {}", GetLastError());
+		return FALSE;
+	}
+	g_hHook = NULL;
+
+	return TRUE;
+}
+
+extern "C" __declspec(dllexport)
+BOOL InstallHook(DWORD threadId)
+{
+	g_hHook = SetWindowsHookEx(
+		WH_CBT,
+		CBTProc,
+		g_hInstance,
+		threadId
+	);
+
+	if (!g_hHook) {
+		LOG_ERROR(g_log, "Failed to set windows hook: {}", GetLastError());
+		return FALSE;
+	}
+	return TRUE;
+}
+
+// Hooks an OSK thread that is already running; the first message it
+// retrieves (post WM_NULL) adopts its windows. Removed with UninstallHook.
+extern "C" __declspec(dllexport)
+BOOL AdoptHook(DWORD threadId)
+{
+	g_hHook = SetWindowsHookEx(
+		WH_GETMESSAGE,
+		GetMsgProc,
+		g_hInstance,
+		threadId
+	);
+
+	if (!g_hHook) {
+		LOG_ERROR(g_log, "Failed to set windows hook: {}", GetLastError());
+		return FALSE;
+	}
+	return TRUE;
+}
+
+
+BOOL APIENTRY DllMain(
+	HINSTANCE hInstance,
+	DWORD dwReason,
+	LPVOID lpReserved)
+{
+	switch (dwReason)
+	{
+	case DLL_PROCESS_ATTACH:
+	{
+		g_hInstance = hInstance;
+		DisableThreadLibraryCalls(hInstance);  // Optional
+		break;
+	}
+	case DLL_PROCESS_DETACH:
+	{
+		if (g_hHook != NULL) {
+			UnhookWindowsHookEx(g_hHook);
+			g_hHook = NULL;
+		}
+		break;
+	}
+	case DLL_THREAD_ATTACH:
+	case DLL_THREAD_DETACH:
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+
+LRESULT CALLBACK DirectUIWndProc(
+	HWND hWnd,
+	UINT msg,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	g_traceChannel.Append(Trace::Source::DirectUI, msg, wParam, lParam);
+	DoubleClickHelper::ProcessMessage(msg, lParam);
+
+	switch (msg)
+	{
+
+	case WM_MOUSEWHEEL:
+	{
+		PROFILE_DIRECTUI(WM_MOUSEWHEEL, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_MOUSEWHEEL, wParam, lParam);
+		return 0;
+	}
+
+	case WM_RBUTTONDOWN:
+	{
+		PROFILE_DIRECTUI(WM_RBUTTONDOWN, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_RBUTTONDOWN, wParam, lParam);
+		return 0;
+	}
+
+	case WM_RBUTTONUP:
+	{
+		PROFILE_DIRECTUI(WM_RBUTTONUP, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_RBUTTONUP, wParam, lParam);
+		return 0;
+	}
+
+	case WM_RBUTTONDBLCLK:
+	{
+		PROFILE_DIRECTUI(WM_RBUTTONDBLCLK, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_RBUTTONDBLCLK, wParam, lParam);
+		return 0;
+	}
+
+	case WM_MBUTTONDOWN:
+	{
+		PROFILE_DIRECTUI(WM_MBUTTONDOWN, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_MBUTTONDOWN, wParam, lParam);
+		return 0;
+	}
+
+	case WM_MBUTTONUP:
+	{
+		PROFILE_DIRECTUI(WM_MBUTTONUP, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_MBUTTONUP, wParam, lParam);
+		return 0;
+	}
+
+	case WM_MBUTTONDBLCLK:
+	{
+		PROFILE_DIRECTUI(WM_MBUTTONDBLCLK, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_MBUTTONDBLCLK, wParam, lParam);
+		return 0;
+	}
+
+	case WM_MOUSEMOVE:
+	{
+		PROFILE_DIRECTUI(WM_MOUSEMOVE, 0);
+		// Forward event to the parent window
+		PostMessage(g_hOSKMainWnd, WM_MOUSEMOVE, wParam, lParam);
+		break;
+	}
+
+	default: break;
+	}
+
+	return CallWindowProc(g_origDirectUIWndProc, hWnd, msg, wParam, lParam);
+}
+
+
+LRESULT CALLBACK OSKMainWndProc(
+	HWND hWnd,
+	UINT msg,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	static WindowDragger windowDragger{};
+	static DragPredictor dragPredictor{};
+	static MouseTracker mouseTracker{ hWnd };
+	static Debouncer mouseWheelDebounce{ 100 };
+
+	g_traceChannel.Append(Trace::Source::OskMain, msg, wParam, lParam);
+
+	switch (msg)
+	{
+	case WM_MOUSEMOVE:
+	{
+		PROFILE_OSKMAIN(WM_MOUSEMOVE, 0);
+		mouseTracker.OnMouseMove();
+
+		windowDragger.OnMouseMove(
+			[&hWnd](const POINT& pt, nullptr_t) {
+				// Lead the pointer to hide compositor latency
+				const POINT lead = dragPredictor.GetOffset();
+				return SetWindowPos(
+					hWnd,
+					NULL,  // No change in Z-order relative to other windows
+					pt.x + lead.x, pt.y + lead.y,
+					0, 0,  // No change in size
+					SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE
+				) != 0;
+			},
+			nullptr
+		);
+
+		return 0;
+	}
+
+	case WM_MOUSELEAVE:
+	{
+		PROFILE_OSKMAIN(WM_MOUSELEAVE, 0);
+		mouseTracker.OnMouseLeave();
+		return 0;
+	}
+
+	case WM_MOUSEWHEEL:
+	{
+		PROFILE_OSKMAIN(WM_MOUSEWHEEL, 0);
+		if (!mouseWheelDebounce.ShouldProcess()) { return 0; }
+
+		int delta = GET_WHEEL_DELTA_WPARAM(wParam);
+		bool forward = delta > 0;
+
+		// Get installed keyboard layouts
+		int layoutCount = GetKeyboardLayoutList(0, nullptr);
+		if (layoutCount <= 1) {
+			return 0;
+		}  // No need to switch if <=1 layout
+
+		HKL* layouts = new HKL[layoutCount];
+		GetKeyboardLayoutList(layoutCount, layouts);
+
+		// Find current layout position
+		HWND hForegroundWnd = GetForegroundWindow();
+		DWORD threadProcessId = GetWindowThreadProcessId(hForegroundWnd, nullptr);
+		HKL current = GetKeyboardLayout(threadProcessId);
+		int currentIndex = -1;
+		for (int i{}; i < layoutCount; ++i) {
+			if (layouts[i] == current) {
+				currentIndex = i;
+				break;
+			}
+		}
+
+		if (currentIndex == -1) {
+			delete[] layouts;
+			return 0;
+		}
+
+		// Calculate new index with boundary checks
+		int newIndex = forward ? currentIndex + 1 : currentIndex - 1;
+		if (newIndex < 0 or newIndex >= layoutCount) {
+			delete[] layouts;
+			return 0;  // Stop at boundaries
+		}
+
+		// System-wide activation
+		HKL newLayout = layouts[newIndex];
+		ActivateKeyboardLayout(newLayout, KLF_ACTIVATE);
+
+		// Update taskbar and all applications
+		PostMessage(HWND_BROADCAST, WM_INPUTLANGCHANGE, 0, (LPARAM)newLayout);
+		PostMessage(hForegroundWnd, WM_INPUTLANGCHANGEREQUEST, INPUTLANGCHANGE_SYSCHARSET, (LPARAM)newLayout);
+
+		// Show the new layout on the tab
+		PostMessage(g_hTabTapMainWnd, WM_APP_CUSTOM_MESSAGE, MAKEWPARAM(ID_APP_LAYOUT_CHANGED, 0), (LPARAM)newLayout);
+
+		delete[] layouts;
+		return 0;
+	}
+
+	case WM_STYLECHANGING:
+	{
+		PROFILE_OSKMAIN(WM_STYLECHANGING, 0);
+		if (wParam == GWL_STYLE) {
+			// Forced frame for `Dock` mode
+			//((STYLESTRUCT*)lParam)->styleNew |= WS_THICKFRAME;
+		}
+		break;
+	}
+
+	case WM_WINDOWPOSCHANGING:
+	{
+		PROFILE_OSKMAIN(WM_WINDOWPOSCHANGING, 0);
+		// Prevent changing the size and position when enabling `Dock` mode
+		if (((PWINDOWPOS)lParam)->cx == GetSystemMetrics(SM_CXSCREEN)) {
+			((PWINDOWPOS)lParam)->flags = (NULL
+				| SWP_NOSIZE
+				| SWP_NOMOVE
+				| SWP_NOACTIVATE
+				| SWP_NOSENDCHANGING
+				);
+			return 0;
+		}
+		break;
+	}
+
+	case WM_NCMBUTTONDOWN:
+	{
+		PROFILE_OSKMAIN(WM_NCMBUTTONDOWN, 0);
+		// Repositioning the First App on middle button down of the 'X'
+		if (wParam == HTCLOSE) {
+			PostMessage(
+				g_hTabTapMainWnd,
+				WM_APP_CUSTOM_MESSAGE,
+				MAKEWPARAM(ID_APP_SYNC_Y_POSITION, 0),
+				(LPARAM)hWnd
+			);
+			g_syncCount.Add();
+			return 0;
+		}
+
+		if (wParam == HTSYSMENU) {
+			// TODO
+			return 0;
+		}
+
+		// In general, it simulates a middle click in the client zone
+		PostMessage(hWnd, WM_MBUTTONDOWN, wParam, lParam); // Drag trigger
+		return 0;
+	}
+
+	case WM_NCMBUTTONUP:
+	{
+		PROFILE_OSKMAIN(WM_NCMBUTTONUP, 0);
+		// Hiding the OSK on middle button up of the 'X'
+		if (wParam == HTCLOSE) {
+			ShowWindow(hWnd, SW_HIDE);
+			return 0;  // Prevent default behavior
+		}
+		break;
+	}
+
+	case WM_MBUTTONDOWN:
+	{
+		PROFILE_OSKMAIN(WM_MBUTTONDOWN, 0);
+		// Drag begin
+		dragPredictor.Enable();
+		g_power.BeginActivity(Power::Activity::Drag);
+		ApplyHookPower();
+		if (!windowDragger.Enable(hWnd)) {
+			MessageBoxNotifier{
+				{ _T("Drag Error") },
+				{ _T("Failed to start drag operation. %s"),
+					ErrorMessageConverter(GetLastError()) }
+			}.ShowError(hWnd);
+			return 1;
+		}
+		return 0;
+	}
+
+	case WM_MBUTTONUP:
+	{
+		PROFILE_OSKMAIN(WM_MBUTTONUP, 0);
+		// Drag end
+		dragPredictor.Disable();
+		g_power.EndActivity(Power::Activity::Drag);
+		ApplyHookPower();
+		if (!windowDragger.Disable()) {
+			MessageBoxNotifier{
+				{ _T("Drag Error") },
+				{ _T("Failed to finish drag operation. %s"),
+					ErrorMessageConverter(GetLastError()) }
+			}.ShowError(hWnd);
+			return 1;
+		}
+		return 0;
+	}
+
+	case WM_MBUTTONDBLCLK:
+	{
+		PROFILE_OSKMAIN(WM_MBUTTONDBLCLK, 0);
+		ShowWindow(hWnd, SW_HIDE);
+		return 0;
+	}
+
+	case WM_RBUTTONDOWN:
+	{
+		PROFILE_OSKMAIN(WM_RBUTTONDOWN, 0);
+		// Act as middle button
+		PostMessage(hWnd, WM_MBUTTONDOWN, wParam, lParam);
+		return 0;
+	}
+
+	case WM_RBUTTONUP:
+	{
+		PROFILE_OSKMAIN(WM_RBUTTONUP, 0);
+		// Act as middle button
+		PostMessage(hWnd, WM_MBUTTONUP, wParam, lParam);
+		return 0;
+	}
+
+	case WM_RBUTTONDBLCLK:
+	{
+		PROFILE_OSKMAIN(WM_RBUTTONDBLCLK, 0);
+		// Act as middle button
+		PostMessage(hWnd, WM_MBUTTONDBLCLK, wParam, lParam);
+		return 0;
+	}
+
+	case WM_CLOSE:
+	{
+		PROFILE_OSKMAIN(WM_CLOSE, 0);
+		// Change the 'X' buttons behavior from 'Close' to 'Hide' and use lParam to indicate a real 'Close' event
+		if ((BOOL)lParam == TRUE) { // Abuse lParam for custom behavior
+			break;
+		}
+		ShowWindow(hWnd, SW_HIDE);
+		return 0; // Message handled
+	}
+
+	case WM_APP_CUSTOM_MESSAGE:
+	{
+		WORD wCommandId = LOWORD(wParam);
+
+		if (wCommandId == ID_APP_DIRECTUI_READY) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_DIRECTUI_READY);
+			if (!g_hDirectUIWnd) {
+				LOG_WARNING(g_log, "DirectUIHWND ready without a handle");
+				break;
+			}
+			if ((WNDPROC)GetWindowLongPtr(g_hDirectUIWnd, GWLP_WNDPROC) == DirectUIWndProc) {
+				return 0; // Already subclassed (adopted OSK)
+			}
+
+			// Store the original window procedure.
+			g_origDirectUIWndProc = reinterpret_cast<WNDPROC>(
+				GetWindowLongPtr(g_hDirectUIWnd, GWLP_WNDPROC)
+			);
+
+			// Subclass DirectUIHWND
+			SetWindowLongPtr(
+				g_hDirectUIWnd,
+				GWLP_WNDPROC,
+				(LONG_PTR)DirectUIWndProc
+			);
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_DOCKMODE) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_DOCKMODE);
+			CountHookCommand();
+			SwitchOskMode(hWnd, StyleProfiles::Dock, "dock");
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_REGULARMODE) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_REGULARMODE);
+			CountHookCommand();
+			SwitchOskMode(hWnd, StyleProfiles::Regular, "regular");
+			return 0;
+		}
+
+		if (wCommandId == ID_APP_FADE) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_FADE);
+			CountHookCommand();
+			static const BYTE MaxOpaque = 0xff;
+			static const BYTE MinOpaque = 0x20;
+
+			bool isIncrease = HIWORD(wParam);
+
+			if (isIncrease and g_opacity < MaxOpaque) {
+				g_opacity += 0x10;
+			}
+			else if (!isIncrease and g_opacity > MinOpaque) {
+				g_opacity -= 0x10;
+			}
+
+			SetLayeredWindowAttributes(
+				hWnd, 0,
+				g_opacity,
+				LWA_ALPHA
+			);
+
+			return 0;
+		}
+		if (wCommandId == ID_APP_HOOK_PING) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_HOOK_PING);
+			// Lets a starting TabTap reconnect instead of restarting osk.exe
+			return OskAttach::MakeHookReply(OskAttach::HookVersion);
+		}
+
+		if (wCommandId == ID_APP_RECONNECT) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_RECONNECT);
+			// A new TabTap instance took over; its channels may be new as well
+			g_hTabTapMainWnd = (HWND)lParam;
+			OpenSharedChannels();
+			LOG_INFO(g_log, "Reconnected to TabTap window {}", (UINT_PTR)lParam);
+			return 0;
+		}
+
+#ifdef TABTAP_PROFILE
+		if (wCommandId == ID_APP_PROFILE_DUMP) {
+			PROFILE_OSKMAIN(WM_APP_CUSTOM_MESSAGE, ID_APP_PROFILE_DUMP);
+			OutputDebugStringA(Profile::OSKMainTable.Format("Hook OSKMainWndProc").c_str());
+			OutputDebugStringA(Profile::DirectUITable.Format("Hook DirectUIWndProc").c_str());
+			return 0;
+		}
+#endif // TABTAP_PROFILE
+
+		return 1;
+	}
+
+	case WM_SHOWWINDOW:
+	{
+		PROFILE_OSKMAIN(WM_SHOWWINDOW, 0);
+		// Hidden keyboard drops to EcoQoS
+		g_power.SetWindowShown(wParam != FALSE);
+		ApplyHookPower();
+		break;
+	}
+
+	case WM_DESTROY:
+	{
+		PROFILE_OSKMAIN(WM_DESTROY, 0);
+		// Write out the hook log while the process can still run threads
+		LOG_INFO(g_log, "OSK window destroyed");
+		g_log.Stop();
+		break;
+	}
+
+	default: break;
+	}
+
+	return CallWindowProc(g_origOSKMainWndProc, hWnd, msg, wParam, lParam);
+}
+
+
+LRESULT CALLBACK CBTProc(
+	INT nCode,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	if (nCode < 0) {
+		return CallNextHookEx(g_hHook, nCode, wParam, lParam);
+	}
+
+	static BOOL bTraceOpened{}; // Attach to the TabTap trace ring and metrics once
+	if (!bTraceOpened) {
+		bTraceOpened = TRUE;
+		OpenSharedChannels();
+	}
+	g_traceChannel.Append(Trace::Source::CbtHook, nCode, wParam, lParam);
+
+	switch (nCode)
+	{
+
+	case HCBT_CREATEWND:
+	{
+		HWND hWnd = (HWND)wParam;
+		TCHAR szClassName[MAX_PATH]{};
+		// Retrieve the window class name
+		if (!GetClassName(hWnd, szClassName, sizeof(szClassName) / sizeof(TCHAR))) {
+			break;
+		}
+
+		if (wcscmp(szClassName, _T("DirectUIHWND")) == 0) {
+			// Store handle as global
+			g_hDirectUIWnd = hWnd;
+
+			// Notify that proc can be subclassed now
+			PostMessage(
+				g_hOSKMainWnd,
+				WM_APP_CUSTOM_MESSAGE,
+				MAKEWPARAM(ID_APP_DIRECTUI_READY, 0),
+				(LPARAM)hWnd
+			);
+
+			SignalLoadEvent();
+		}
+		return 0;
+	}
+
+	case HCBT_ACTIVATE:
+	{
+		HWND hWnd = (HWND)wParam;
+		TCHAR szClassName[MAX_PATH]{};
+		// Retrieve the window class name
+		if (!GetClassName(hWnd, szClassName, sizeof(szClassName) / sizeof(TCHAR))) {
+			break;
+		}
+
+		if (_tcscmp(szClassName, _T("OSKMainClass")) == 0) {
+			if (g_origOSKMainWndProc) { // To process only once
+				break;
+			}
+			AdoptOSKMainWindow(hWnd, true);
+		}
+		return 0;
+	}
+
+	//Keeping the hook active and dropping focus here doesnt work either
+	/*
+	case HCBT_SETFOCUS:
+	{
+		return 1;
+	}
+	*/
+	default: break;
+	}
+
+	return CallNextHookEx(g_hHook, nCode, wParam, lParam);
+}
+
+
+LRESULT CALLBACK GetMsgProc(
+	INT nCode,
+	WPARAM wParam,
+	LPARAM lParam)
+{
+	if (nCode != HC_ACTION or g_origOSKMainWndProc) {
+		return CallNextHookEx(g_hHook, nCode, wParam, lParam);
+	}
+
+	// Running inside the OSK thread; its windows exist already
+	HWND hWnd = FindWindow(_T("OSKMainClass"), NULL);
+	if (!hWnd or GetWindowThreadProcessId(hWnd, NULL) != GetCurrentThreadId()) {
+		return CallNextHookEx(g_hHook, nCode, wParam, lParam);
+	}
+
+	OpenSharedChannels();
+	AdoptOSKMainWindow(hWnd, false);
+
+	// DirectUIHWND was created before the hook; subclass it the usual way
+	if (HWND hDirectUIWnd = FindWindowEx(hWnd, NULL, _T("DirectUIHWND"), NULL)) {
+		g_hDirectUIWnd = hDirectUIWnd;
+		PostMessage(
+			hWnd,
+			WM_APP_CUSTOM_MESSAGE,
+			MAKEWPARAM(ID_APP_DIRECTUI_READY, 0),
+			(LPARAM)hDirectUIWnd
+		);
+	}
+	else {
+		LOG_WARNING(g_log, "Adopted OSK has no DirectUIHWND");
+	}
+
+	SignalLoadEvent();
+
+	return CallNextHookEx(g_hHook, nCode, wParam, lParam);
+}
+
+
+
+
+
+
+
+/*
+	//=========================
+	// Dock
+	//=========================
+
+	0x160A0000  GWL_STYLE
+	----------
+	0x10000000  WS_VISIBLE
+	0x04000000  WS_CLIPSIBLINGS
+	0x02000000  WS_CLIPCHILDREN
+	0x00080000  WS_SYSMENU
+	0x00020000  WS_MINIMIZEBOX
+
+
+	0x080C0188  GWL_EXSTYLE
+	----------
+	0x08000000  WS_EX_NOACTIVATE
+	0x00080000  WS_EX_LAYERED
+	0x00040000  WS_EX_APPWINDOW
+	0x00000100  WS_EX_WINDOWEDGE
+	0x00000080  WS_EX_TOOLWINDOW
+	0x00000008  WS_EX_TOPMOST
+*/
+/*
+	//=========================
+	// Regular
+	//=========================
+
+	0x16CE0000  GWL_STYLE
+	----------
+	0x10000000  WS_VISIBLE
+	0x04000000  WS_CLIPSIBLINGS
+	0x02000000  WS_CLIPCHILDREN
+	0x00800000  WS_BORDER
+	0x00400000  WS_DLGFRAME
+	0x00080000  WS_SYSMENU
+	0x00040000  WS_THICKFRAME
+	0x00020000  WS_MINIMIZEBOX
+
+
+	0x080C0008  GWL_EXSTYLE
+	----------
+	0x08000000  WS_EX_NOACTIVATE
+	0x00080000  WS_EX_LAYERED
+	0x00040000  WS_EX_APPWINDOW
+	0x00000008  WS_EX_TOPMOST
+*/
+
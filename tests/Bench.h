@@ -0,0 +1,65 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <utility>
+
+
+
+// Timing helper for the benchmarks: runs a body `iterations` times per
+// round and reports the best round per operation, which is the figure the
+// commit log quotes. Pass `--quick` to cut the rounds for a smoke run.
+namespace Bench
+{
+	inline uint32_t Rounds{ 5 };
+
+	/// Keeps a value alive so the optimiser cannot drop the work producing it
+	template <typename T>
+	inline void Keep(const T& value)
+	{
+#if defined(__GNUC__) or defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static const void* volatile pSink{};
+		pSink = &value;
+#endif
+	}
+
+	/// Reads `--quick` from the command line
+	inline void Init(int argc, char** argv)
+	{
+		for (int i{ 1 }; i < argc; ++i) {
+			if (std::string_view{ argv[i] } == "--quick") { Rounds = 1; }
+		}
+	}
+
+	/// Times `body(i)` for i in [0, iterations) after an untimed `setup()` per
+	/// round and prints the best time per call
+	template <typename Setup, typename Body>
+	inline double Run(const char* pszName, uint64_t iterations, Setup&& setup, Body&& body)
+	{
+		double bestNs{ 1e300 };
+		for (uint32_t round{}; round < Rounds; ++round) {
+			setup();
+			const auto start = std::chrono::steady_clock::now();
+			for (uint64_t i{}; i < iterations; ++i) { body(i); }
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			bestNs = std::min(bestNs, std::chrono::duration<double, std::nano>(elapsed).count() / double(iterations));
+		}
+
+		if (bestNs >= 1e6) { std::printf("%-40s %10.2f ms\n", pszName, bestNs / 1e6); }
+		else if (bestNs >= 1e3) { std::printf("%-40s %10.2f us\n", pszName, bestNs / 1e3); }
+		else { std::printf("%-40s %10.2f ns\n", pszName, bestNs); }
+		return bestNs;
+	}
+
+	template <typename Body>
+	inline double Run(const char* pszName, uint64_t iterations, Body&& body)
+	{
+		return Run(pszName, iterations, []() {}, std::forward<Body>(body));
+	}
+}
@@ -0,0 +1,109 @@
+// Cost of a log call on the calling thread: LOG_INFO into the thread buffer,
+// alone and next to three other logging threads, against the synchronous
+// LogManager::WriteLog path the hook used before (lock, format, two writes
+// and a flush to disk per call, here as mutex, snprintf, write and fsync).
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/AsyncLogger.h"
+
+// Standard library headers
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Platform headers
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+	// LogManager::WriteLog__ without the Windows types
+	class SyncLog
+	{
+	private:
+		std::mutex mutex{};
+		int fd{ -1 };
+		char message[255]{};
+		bool isFlushing{};
+
+	public:
+		SyncLog(const std::filesystem::path& path, bool flush) :
+			fd{ open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644) },
+			isFlushing{ flush }
+		{}
+
+		~SyncLog() { if (fd >= 0) { close(fd); } }
+
+		template <typename... ArgTy>
+		bool Write(const char* format, ArgTy... args)
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			const int length = std::snprintf(message, sizeof(message), format, args...);
+			if (length < 0) { return false; }
+			bool isWritten = write(fd, message, size_t(length)) == length and write(fd, "\r\n", 2) == 2;
+			if (isFlushing) { isWritten = isWritten and fsync(fd) == 0; }
+			return isWritten;
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path();
+	const std::filesystem::path asyncPath = directory / "TabTapAsyncLoggerBench.log";
+	const std::filesystem::path syncPath = directory / "TabTapAsyncLoggerBench.sync.log";
+
+	Logging::AsyncLogger logger{};
+	Logging::AsyncLogger::Config config{};
+	config.flushInterval = std::chrono::milliseconds{ 1 };
+	config.maxFileBytes = 64 * 1024 * 1024;
+	if (!logger.Start(asyncPath, config)) { return 1; }
+
+	// Short bursts let the flusher keep up, as the UI thread's log rate does
+	Bench::Run("LOG_INFO", 1000, []() { std::this_thread::sleep_for(std::chrono::milliseconds{ 5 }); },
+		[&](uint64_t i) {
+			LOG_INFO(logger, "Hook message {} for window {}", i, L"OSKMainClass");
+		});
+
+	std::atomic<bool> isRunning{ true };
+	std::vector<std::thread> threads;
+	for (int thread{}; thread < 3; ++thread) {
+		threads.emplace_back([&]() {
+			for (uint64_t i{}; isRunning.load(std::memory_order_relaxed); ++i) {
+				LOG_INFO(logger, "Background {} for window {}", i, L"DirectUIHWND");
+				if (i % 64 == 0) { std::this_thread::yield(); }
+			}
+			});
+	}
+	Bench::Run("LOG_INFO (3 other logging threads)", 1000, []() { std::this_thread::sleep_for(std::chrono::milliseconds{ 5 }); },
+		[&](uint64_t i) {
+			LOG_INFO(logger, "Hook message {} for window {}", i, L"OSKMainClass");
+		});
+	isRunning.store(false);
+	for (std::thread& thread : threads) { thread.join(); }
+	logger.Stop();
+
+	{
+		SyncLog log{ syncPath, true };
+		Bench::Run("LogManager::WriteLog (with flush)", 200, [&](uint64_t i) {
+			Bench::Keep(log.Write("Hook message %llu for window %ls", (unsigned long long)i, L"OSKMainClass"));
+			});
+	}
+	{
+		SyncLog log{ syncPath, false };
+		Bench::Run("LogManager::WriteLog (without flush)", 20000, [&](uint64_t i) {
+			Bench::Keep(log.Write("Hook message %llu for window %ls", (unsigned long long)i, L"OSKMainClass"));
+			});
+	}
+
+	std::error_code ec{};
+	std::filesystem::remove(asyncPath, ec);
+	std::filesystem::remove(syncPath, ec);
+	return 0;
+}
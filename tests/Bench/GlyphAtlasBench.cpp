@@ -0,0 +1,57 @@
+// Layout indicator cost on the expanded tab at 96 DPI: an atlas build per
+// DPI change, a label layout per layout change and two blends (shadow and
+// text) per redraw, as LayoutIndicator::Draw does them.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/GlyphAtlas.h"
+
+namespace
+{
+	// Anti-aliased looking glyphs about as wide as the UI font's at 12 px
+	bool Rasterize(char ch, long cellHeight, Glyphs::Bitmap* pBitmap)
+	{
+		pBitmap->width = ch == ' ' ? 0 : 6 + (ch & 1);
+		pBitmap->advance = pBitmap->width + 1;
+		pBitmap->coverage.resize(size_t(pBitmap->width) * size_t(cellHeight));
+		for (size_t i{}; i < pBitmap->coverage.size(); ++i) { pBitmap->coverage[i] = uint8_t(i * 37 + size_t(ch)); }
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	const Geometry::Size frame{ 28, 95 };
+	Render::HeadlessBackend backend{};
+	backend.CreateSurface(frame);
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	layer.fillColor = Render::MakeOpaque(32, 64, 96);
+	backend.Compose(layer);
+
+	Glyphs::Atlas atlas{};
+	Glyphs::Label label{};
+	const char* const codes[] = { "EN", "DE" };
+
+	auto draw = [&]() {
+		Geometry::Point at{};
+		if (Glyphs::PlaceLabel(frame, label.GetSize(), 1, &at)) {
+			backend.BlendMask(label.GetMask(), { at.x + 1, at.y + 1 }, 0x80000000u);
+			backend.BlendMask(label.GetMask(), at, Render::MakeOpaque(255, 255, 255));
+		}
+	};
+
+	Bench::Run("Atlas::Build", 20000, [&](uint64_t i) { atlas.Build(uint32_t(96 + (i & 1)), 12, Rasterize); });
+
+	atlas.Build(96, 12, Rasterize);
+	Bench::Run("Layout change (Label::Update + redraw)", 1000000, [&](uint64_t i) {
+		label.Update(atlas, codes[i & 1]);
+		draw();
+		});
+	label.Update(atlas, "EN");
+	Bench::Run("Redraw (two blends)", 1000000, [&](uint64_t) { draw(); });
+	Bench::Keep(backend.GetPixels().pPixels[0]);
+	return 0;
+}
@@ -0,0 +1,67 @@
+// Built-in keyboard costs at 660x240: a press from pointer to the event
+// batch (hit-test plus latch), painting a whole frame, and drawing a press
+// over a cached frame.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Harness.h"
+#include "Core/KeyLayout.h"
+
+// Standard library headers
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	KeyLayout::Layout layout{};
+	KeyLayout::Parse(KeyLayout::DefaultTable, &layout);
+	KeyLayout::Arrangement arrangement{};
+	arrangement.Build(layout, { 0, 20, 660, 240 }, 2);
+
+	Glyphs::Atlas atlas{};
+	atlas.Build(96, 12, [](char ch, long cellHeight, Glyphs::Bitmap* pBitmap) {
+		pBitmap->width = ch == ' ' ? 0 : 6;
+		pBitmap->advance = 7;
+		pBitmap->coverage.assign(size_t(pBitmap->width) * size_t(cellHeight), 0xc0);
+		return true;
+		});
+	auto getLabel = [](const KeyLayout::Key& key, bool isShifted, char (&label)[KeyLayout::MaxLabelChars + 1]) {
+		if (key.vk < 0x41 or key.vk > 0x5A) { return false; }
+		label[0] = char(isShifted ? key.vk : key.vk + 0x20);
+		return true;
+	};
+
+	std::vector<Geometry::Point> points(4096);
+	Test::Random random{ 50 };
+	for (Geometry::Point& pt : points) { pt = { long(random.Range(0, 659)), long(random.Range(20, 239)) }; }
+
+	KeyLayout::ModifierLatch latch{};
+	KeyLayout::KeyEvent events[KeyLayout::MaxEvents]{};
+	uint64_t eventCount{};
+	Bench::Run("Press (HitTest + ModifierLatch::Press)", 20000000, [&](uint64_t i) {
+		const int index = arrangement.HitTest(points[i & 4095]);
+		if (index >= 0) { eventCount += latch.Press(layout.keys[index], events); }
+		});
+	Bench::Keep(eventCount);
+
+	const KeyLayout::Palette palette{};
+	KeyLayout::FrameCache frames{};
+	Bench::Run("Frame paint", 500, [&](uint64_t) {
+		frames.Invalidate();
+		Bench::Keep(frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel));
+		});
+
+	Render::HeadlessBackend backend{};
+	backend.CreateSurface({ 660, 240 });
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Image;
+	const Geometry::Rect pressed = arrangement.GetKeyRect(30);
+	Bench::Run("Cached frame + pressed key", 5000, [&](uint64_t) {
+		layer.image = frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+		backend.Compose(layer);
+		backend.BlendMask(frames.GetKeyMask(pressed), pressed.TopLeft(), 0x60606060u);
+		});
+	Bench::Keep(backend.GetPixels().pPixels[0]);
+	return 0;
+}
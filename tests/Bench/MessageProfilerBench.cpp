@@ -0,0 +1,135 @@
+// Cost of PROFILE_HANDLER on a window procedure: the same switch over a
+// typical message mix (mostly WM_MOUSEMOVE, some WM_TIMER commands) with
+// and without a profiled scope per handler. The handlers do a few loads and
+// stores, so the difference is the two clock reads and the slot update.
+
+// Always instrumented here, whatever the build defines
+#define TABTAP_PROFILE
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Harness.h"
+#include "Core/MessageProfiler.h"
+
+// Standard library headers
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t WmMouseMove = 0x0200;
+	constexpr uint32_t WmTimer = 0x0113;
+	constexpr uint32_t WmLButtonDown = 0x0201;
+	constexpr uint32_t IdtBlink = 1;
+	constexpr uint32_t IdtAnimation = 2;
+
+	constexpr Profiling::Key ProfileKeys[] = {
+		{ WmMouseMove, 0, "WM_MOUSEMOVE" },
+		{ WmTimer, IdtBlink, "WM_TIMER/IDT_BLINK" },
+		{ WmTimer, IdtAnimation, "WM_TIMER/IDT_ANIMATION" },
+		{ WmLButtonDown, 0, "WM_LBUTTONDOWN" },
+	};
+	Profiling::MessageProfiler<std::size(ProfileKeys)> g_profiler{ ProfileKeys };
+
+	struct Message
+	{
+		uint32_t message{};
+		uint32_t command{};
+		long x{};
+		long y{};
+	};
+
+	// Window state the handlers touch
+	struct State
+	{
+		long cursorX{};
+		long cursorY{};
+		uint32_t blinks{};
+		uint32_t frames{};
+		uint32_t presses{};
+	};
+
+#if defined(__GNUC__) or defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE __declspec(noinline)
+#endif
+
+	BENCH_NOINLINE long BareProc(State& state, const Message& msg)
+	{
+		switch (msg.message)
+		{
+		case WmMouseMove:
+			state.cursorX = msg.x;
+			state.cursorY = msg.y;
+			return 0;
+		case WmTimer:
+			if (msg.command == IdtBlink) { ++state.blinks; }
+			else if (msg.command == IdtAnimation) { ++state.frames; }
+			return 0;
+		case WmLButtonDown:
+			++state.presses;
+			return 0;
+		}
+		return 1;
+	}
+
+	BENCH_NOINLINE long ProfiledProc(State& state, const Message& msg)
+	{
+		switch (msg.message)
+		{
+		case WmMouseMove:
+		{
+			PROFILE_HANDLER(g_profiler, ProfileKeys, WmMouseMove, 0);
+			state.cursorX = msg.x;
+			state.cursorY = msg.y;
+			return 0;
+		}
+		case WmTimer:
+			if (msg.command == IdtBlink) {
+				PROFILE_HANDLER(g_profiler, ProfileKeys, WmTimer, IdtBlink);
+				++state.blinks;
+			}
+			else if (msg.command == IdtAnimation) {
+				PROFILE_HANDLER(g_profiler, ProfileKeys, WmTimer, IdtAnimation);
+				++state.frames;
+			}
+			return 0;
+		case WmLButtonDown:
+		{
+			PROFILE_HANDLER(g_profiler, ProfileKeys, WmLButtonDown, 0);
+			++state.presses;
+			return 0;
+		}
+		}
+		return 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	// 80% moves, 19% timers, 1% clicks
+	constexpr uint64_t Messages = 1 << 20;
+	std::vector<Message> messages(Messages);
+	Test::Random random{ 30 };
+	for (Message& msg : messages) {
+		const int64_t roll = random.Range(0, 99);
+		if (roll < 80) { msg = { WmMouseMove, 0, long(random.Range(0, 1919)), long(random.Range(0, 1039)) }; }
+		else if (roll < 99) { msg = { WmTimer, roll < 90 ? IdtAnimation : IdtBlink }; }
+		else { msg = { WmLButtonDown }; }
+	}
+
+	State state{};
+	Bench::Run("Bare window procedure", Messages, [&](uint64_t i) {
+		Bench::Keep(BareProc(state, messages[i]));
+		});
+	Bench::Run("Profiled window procedure", Messages, [&](uint64_t i) {
+		Bench::Keep(ProfiledProc(state, messages[i]));
+		});
+	Bench::Run("Record only", 100000000, [&](uint64_t i) {
+		g_profiler.Record(size_t(i & 3), i & 1023);
+		});
+	Bench::Keep(state);
+	return 0;
+}
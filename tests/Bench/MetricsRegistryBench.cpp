@@ -0,0 +1,34 @@
+// Metrics recording and export cost on the recording thread's own shard,
+// with a registry about as full as TabTap's.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/MetricsRegistry.h"
+
+// Standard library headers
+#include <string>
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	alignas(Metrics::CacheLine) static unsigned char block[Metrics::RequiredBytes()]{};
+	static Metrics::Registry registry = Metrics::Registry::Create(block, sizeof(block));
+
+	const Metrics::Counter counter = registry.AddCounter("tabtap_redraws_total", "Tab redraws");
+	const Metrics::Histogram histogram = registry.AddHistogram("tabtap_draw_us", "Tab draw time",
+		{ 50, 100, 250, 500, 1000, 2500, 5000, 10000 });
+	for (int i{}; i < 24; ++i) {
+		registry.AddCounter(("tabtap_counter_" + std::to_string(i) + "_total").c_str(), "Filler").Add(uint64_t(i));
+	}
+	for (int i{}; i < 6; ++i) {
+		registry.AddHistogram(("tabtap_histogram_" + std::to_string(i) + "_us").c_str(), "Filler",
+			{ 100, 1000, 10000, 100000 }).Observe(uint64_t(i) * 1000);
+	}
+
+	Bench::Run("Counter::Add", 100000000, [&](uint64_t) { counter.Add(); });
+	Bench::Run("Histogram::Observe", 20000000, [&](uint64_t i) { histogram.Observe(i & 8191); });
+	Bench::Run("TakeSnapshot", 20000, [&](uint64_t) { Bench::Keep(registry.TakeSnapshot()); });
+	Bench::Run("TakeSnapshot + FormatText", 20000, [&](uint64_t) { Bench::Keep(Metrics::FormatText(registry.TakeSnapshot())); });
+	return 0;
+}
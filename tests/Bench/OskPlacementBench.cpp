@@ -0,0 +1,30 @@
+// One placement solve per caret frame, over 4096 random carets under a
+// 1000x400 OSK beside a tab on the right edge.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Harness.h"
+#include "Core/OskPlacement.h"
+
+// Standard library headers
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	std::vector<OskPlacement::Input> inputs(4096);
+	Test::Random random{ 49 };
+	for (OskPlacement::Input& input : inputs) {
+		input.workArea = { 0, 0, 1920, 1040 };
+		const long oskTop = long(random.Range(0, 639));
+		input.osk = { 500, oskTop, 1500, oskTop + 400 };
+		input.tab = { 1892, 500, 1920, 595 };
+		const long caretLeft = long(random.Range(0, 1899));
+		const long caretTop = long(random.Range(0, 999));
+		input.caret = { caretLeft, caretTop, caretLeft + 2, caretTop + 20 };
+	}
+
+	Bench::Run("Solve", 10000000, [&](uint64_t i) { Bench::Keep(OskPlacement::Solve(inputs[i & 4095])); });
+	return 0;
+}
@@ -0,0 +1,106 @@
+// Frame time on the headless backend: one tab frame as TabWindow::Draw
+// builds it (surface, tab layer, present) expanded, collapsed and mirrored
+// at 96 and 192 DPI, the same frame through a colour matrix (an effect frame
+// that was not prerendered), and the snap preview hollow and filled.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/RenderBackend.h"
+#include "Core/TabLayout.h"
+
+// Standard library headers
+#include <vector>
+
+namespace
+{
+	// Tab strip with a translucent body and an opaque collapsed strip (as Replay draws it)
+	std::vector<Render::Pixel> MakeTabImage(const Geometry::Size& size, long collapsedWidth)
+	{
+		std::vector<Render::Pixel> pixels(size_t(size.cx) * size_t(size.cy));
+		for (long y{}; y < size.cy; ++y) {
+			for (long x{}; x < size.cx; ++x) {
+				const uint32_t a = (x >= size.cx - collapsedWidth) ? 255 : 96 + uint32_t(y * 159 / size.cy);
+				const uint32_t r = uint32_t(x * 9 % 256) * a / 255;
+				const uint32_t g = uint32_t(y * 2 % 256) * a / 255;
+				const uint32_t b = 0xc0 * a / 255;
+				pixels[size_t(y) * size_t(size.cx) + size_t(x)] = (a << 24) | (r << 16) | (g << 8) | b;
+			}
+		}
+		return pixels;
+	}
+
+	Geometry::Size Scale(const Geometry::Size& size, long dpi)
+	{
+		return { size.cx * dpi / 96, size.cy * dpi / 96 };
+	}
+
+	// Half-way through a tint towards blue
+	constexpr Render::ColorMatrix TintMatrix{ {
+		{ 0.5f, 0.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.5f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.5f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.24f, 0.42f, 0.0f, 1.0f }
+	} };
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	Render::HeadlessBackend headless{};
+	Render::IBackend& backend = headless;
+
+	for (long dpi : { 96L, 192L }) {
+		const Geometry::Size expanded = Scale(TabLayout::ExpandedSize, dpi);
+		const Geometry::Size collapsed = Scale(TabLayout::CollapsedSize, dpi);
+		const std::vector<Render::Pixel> pixels = MakeTabImage(expanded, collapsed.cx);
+		const Render::ImageView image{ pixels.data(), expanded.cx, expanded.cy, expanded.cx };
+
+		auto frame = [&](const Geometry::Size& size, bool isExpanded, bool isMirrored, const Render::ColorMatrix* pMatrix) {
+			backend.CreateSurface(size);
+			backend.Compose(Render::MakeTabLayer(image, size, isExpanded, isMirrored, pMatrix));
+			backend.Present({ 1892, 400 }, 0xff);
+		};
+
+		char name[64]{};
+		std::snprintf(name, sizeof(name), "Tab frame, expanded (%ld DPI)", dpi);
+		Bench::Run(name, 20000, [&](uint64_t) { frame(expanded, true, false, nullptr); });
+		std::snprintf(name, sizeof(name), "Tab frame, collapsed (%ld DPI)", dpi);
+		Bench::Run(name, 20000, [&](uint64_t) { frame(collapsed, false, false, nullptr); });
+		std::snprintf(name, sizeof(name), "Tab frame, mirrored (%ld DPI)", dpi);
+		Bench::Run(name, 20000, [&](uint64_t) { frame(expanded, true, true, nullptr); });
+		std::snprintf(name, sizeof(name), "Tab frame, colour matrix (%ld DPI)", dpi);
+		Bench::Run(name, 1000, [&](uint64_t) { frame(expanded, true, false, &TintMatrix); });
+
+		// Alternating sizes reallocates the surface every frame
+		std::snprintf(name, sizeof(name), "Expand/collapse (%ld DPI)", dpi);
+		Bench::Run(name, 20000, [&](uint64_t i) {
+			if (i & 1) { frame(collapsed, false, false, nullptr); }
+			else { frame(expanded, true, false, nullptr); }
+			});
+	}
+
+	// Snap preview over a 400 x 300 area, as EdgeSnapData::DrawPreview draws it
+	Render::Layer preview{};
+	preview.kind = Render::LayerKind::Rectangle;
+	preview.frameColor = Render::MakeOpaque(0, 120, 215);
+	preview.frameThickness = 4;
+	preview.isHollow = true;
+	Bench::Run("Snap preview, hollow (400 x 300)", 1000, [&](uint64_t) {
+		backend.CreateSurface({ 400, 300 });
+		backend.Compose(preview);
+		backend.Present({ 1520, 300 }, 255);
+		});
+	preview.isHollow = false;
+	preview.fillColor = Render::MakeOpaque(0, 120, 215);
+	Bench::Run("Snap preview, filled (400 x 300)", 1000, [&](uint64_t) {
+		backend.CreateSurface({ 400, 300 });
+		backend.Compose(preview);
+		backend.Present({ 1520, 300 }, 150);
+		});
+
+	Bench::Keep(headless.GetPixels().pPixels[0]);
+	Bench::Keep(headless.GetPresentCount());
+	return 0;
+}
@@ -0,0 +1,84 @@
+// Skin load and state switch: validating a packed skin in place, resolving
+// the frame table for a DPI, a state switch through the table, and the one
+// copy of a frame into its DIB when the state is first shown. The skin has
+// every state at 96, 144 and 192 DPI, plain and mirrored (36 frames).
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/SkinFormat.h"
+
+// Standard library headers
+#include <vector>
+
+namespace
+{
+	// Packs frames the way SkinPacker does
+	std::vector<uint8_t> PackSkin()
+	{
+		std::vector<Skin::FrameEntry> entries{};
+		for (uint16_t dpi : { 96, 144, 192 }) {
+			for (size_t state{}; state < size_t(Skin::State::Count); ++state) {
+				for (uint8_t flags : { Skin::FrameNone, Skin::FrameMirrored }) {
+					Skin::FrameEntry entry{};
+					entry.state = uint8_t(state);
+					entry.flags = flags;
+					entry.dpi = dpi;
+					entry.width = uint16_t(28 * dpi / 96);
+					entry.height = uint16_t(95 * dpi / 96);
+					entry.stride = uint32_t(entry.width) * 4;
+					entries.push_back(entry);
+				}
+			}
+		}
+
+		const uint32_t tableOffset = sizeof(Skin::Header);
+		uint32_t offset = tableOffset + uint32_t(entries.size() * sizeof(Skin::FrameEntry));
+		for (Skin::FrameEntry& entry : entries) {
+			offset = (offset + Skin::PixelAlignment - 1) / Skin::PixelAlignment * Skin::PixelAlignment;
+			entry.pixelOffset = offset;
+			offset += entry.stride * entry.height;
+		}
+
+		std::vector<uint8_t> data(offset, 0x80);
+		const Skin::Header header{ Skin::Magic, Skin::Version, sizeof(Skin::Header), offset,
+			uint32_t(entries.size()), tableOffset, 0 };
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::memcpy(data.data() + tableOffset, entries.data(), entries.size() * sizeof(Skin::FrameEntry));
+		return data;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	const std::vector<uint8_t> data = PackSkin();
+	const Skin::View view{ data.data(), data.size() };
+	std::printf("%u frames, %zu bytes\n", view.GetFrameCount(), data.size());
+
+	Bench::Run("View (validate in place)", 1000000, [&](uint64_t) {
+		Bench::Keep(Skin::View{ data.data(), data.size() });
+		});
+
+	Skin::FrameTable table{};
+	Bench::Run("FrameTable::Build", 1000000, [&](uint64_t i) {
+		table.Build(view, (i & 1) ? 144 : 120);
+		Bench::Keep(table);
+		});
+
+	table.Build(view, 144);
+	Bench::Run("State switch (FrameTable::Get)", 100000000, [&](uint64_t i) {
+		Bench::Keep(table.Get(Skin::State(i % size_t(Skin::State::Count)), (i & 8) != 0));
+		});
+
+	// SkinData fills a DIB per state the first time it is shown
+	const Skin::Frame& frame = table.Get(Skin::State::Pressed, false);
+	std::vector<uint8_t> dib(size_t(frame.stride) * frame.height);
+	Bench::Run("First show (copy into the DIB)", 1000000, [&](uint64_t) {
+		for (uint16_t y{}; y < frame.height; ++y) {
+			std::memcpy(dib.data() + size_t(y) * frame.width * 4, frame.pixels + size_t(y) * frame.stride, size_t(frame.width) * 4);
+		}
+		Bench::Keep(dib[0]);
+		});
+	return 0;
+}
@@ -0,0 +1,44 @@
+// Timer wheel insert and cancel cost with a million pending timers.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Harness.h"
+#include "Core/TimerWheel.h"
+
+// Standard library headers
+#include <memory>
+#include <utility>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+	constexpr uint64_t TimerCount = 1000000;
+
+	// Deadlines spread over every level and the overflow list
+	Test::Random random{ 40 };
+	std::vector<uint64_t> deadlines(TimerCount);
+	for (uint64_t& deadline : deadlines) { deadline = uint64_t(random.Range(1, 1ll << 26)); }
+
+	std::unique_ptr<Timing::TimerWheel> spWheel{};
+	std::vector<Timing::TimerId> ids(TimerCount);
+	Bench::Run("Schedule (1M pending)", TimerCount,
+		[&]() { spWheel = std::make_unique<Timing::TimerWheel>(); },
+		[&](uint64_t i) { ids[i] = spWheel->Schedule(uint32_t(i), deadlines[i], 10); });
+
+	auto fill = [&]() {
+		spWheel = std::make_unique<Timing::TimerWheel>();
+		for (uint64_t i{}; i < TimerCount; ++i) { ids[i] = spWheel->Schedule(uint32_t(i), deadlines[i], 10); }
+	};
+	Bench::Run("Cancel in schedule order", TimerCount, fill,
+		[&](uint64_t i) { Bench::Keep(spWheel->Cancel(ids[i])); });
+
+	// Random order touches a cold node on every cancel
+	std::vector<size_t> order(TimerCount);
+	for (size_t i{}; i < TimerCount; ++i) { order[i] = i; }
+	for (size_t i = TimerCount - 1; i > 0; --i) { std::swap(order[i], order[size_t(random.Range(0, int64_t(i)))]); }
+
+	Bench::Run("Cancel in random order", TimerCount, fill,
+		[&](uint64_t i) { Bench::Keep(spWheel->Cancel(ids[order[i]])); });
+	return 0;
+}
@@ -0,0 +1,70 @@
+// Cost of TryAppend on the hooked window procedures: with tracing off (the
+// usual case), into a ring the consumer keeps draining, and against three
+// other producers appending flat out. Records are 40 bytes in a 4096-slot
+// ring, as in TraceChannel.
+
+// Implementation-specific headers
+#include "Bench.h"
+#include "Core/TraceRing.h"
+
+// Standard library headers
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Capacity = 4096;
+
+	Trace::Record MakeRecord(uint64_t i)
+	{
+		Trace::Record record{};
+		record.time = i;
+		record.source = uint16_t(Trace::Source::OskMain);
+		record.message = 0x0200;
+		record.wParam = i;
+		return record;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Bench::Init(argc, argv);
+
+	std::vector<uint64_t> memory(Trace::RequiredBytes(Capacity) / sizeof(uint64_t) + 1);
+	Trace::Ring ring = Trace::Ring::Create(memory.data(), Trace::RequiredBytes(Capacity), Capacity);
+
+	Bench::Run("TryAppend (tracing off)", 100000000, [&](uint64_t i) {
+		Bench::Keep(ring.TryAppend(MakeRecord(i)));
+		});
+
+	ring.SetEnabled(true);
+	Trace::Record record{};
+	Bench::Run("TryAppend + TryRead", 20000000, [&](uint64_t i) {
+		ring.TryAppend(MakeRecord(i));
+		Bench::Keep(ring.TryRead(&record));
+		});
+
+	// Three producers and the consumer run for the rest of the bench
+	std::atomic<bool> isRunning{ true };
+	std::vector<std::thread> threads;
+	for (int producer{}; producer < 3; ++producer) {
+		threads.emplace_back([&]() {
+			Trace::Ring attached = Trace::Ring::Attach(memory.data(), Trace::RequiredBytes(Capacity));
+			for (uint64_t i{}; isRunning.load(std::memory_order_relaxed); ++i) { attached.TryAppend(MakeRecord(i)); }
+			});
+	}
+	threads.emplace_back([&]() {
+		while (isRunning.load(std::memory_order_relaxed)) { ring.Drain([](const Trace::Record& drained) { Bench::Keep(drained); }); }
+		});
+
+	uint64_t appended{};
+	Bench::Run("TryAppend (3 other producers)", 5000000, [&](uint64_t i) {
+		appended += ring.TryAppend(MakeRecord(i));
+		});
+	isRunning.store(false);
+	for (std::thread& thread : threads) { thread.join(); }
+	std::printf("%llu of %llu appended, the rest dropped on a full ring\n",
+		(unsigned long long)appended, 5000000ull * Bench::Rounds);
+	return 0;
+}
@@ -0,0 +1,21 @@
+// Must not compile: the profiled handler's key is missing from the table.
+// Built only by the ProfilerRejectsUnknownKeys test, which expects failure.
+
+#define TABTAP_PROFILE
+
+// Implementation-specific headers
+#include "Core/MessageProfiler.h"
+
+namespace
+{
+	constexpr Profiling::Key Keys[] = {
+		{ 0x0200, 0, "WM_MOUSEMOVE" },
+	};
+	Profiling::MessageProfiler<std::size(Keys)> Table{ Keys };
+}
+
+int main()
+{
+	PROFILE_HANDLER(Table, Keys, 0x0201, 0);
+	return 0;
+}
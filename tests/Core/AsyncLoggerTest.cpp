@@ -0,0 +1,299 @@
+// Asynchronous logger: thread buffer wrap-around and the file it writes.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/AsyncLogger.h"
+
+// Standard library headers
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Logging::ThreadBuffer;
+
+	// Writes one entry of `size` bytes whose argument bytes repeat `fill`
+	bool Put(ThreadBuffer& buffer, uint32_t siteId, size_t size, uint8_t fill)
+	{
+		uint8_t* p = buffer.Reserve(ThreadBuffer::AlignUp(size));
+		if (!p) { return false; }
+
+		const ThreadBuffer::Entry entry{ uint32_t(size), siteId, siteId };
+		std::memcpy(p, &entry, sizeof(entry));
+		std::memset(p + sizeof(entry), fill, size - sizeof(entry));
+		buffer.Commit(ThreadBuffer::AlignUp(size));
+		return true;
+	}
+
+	struct Seen
+	{
+		uint32_t siteId{};
+		size_t length{};
+		bool isIntact{};
+	};
+
+	std::vector<Seen> DrainAll(ThreadBuffer& buffer)
+	{
+		std::vector<Seen> seen;
+		buffer.Drain([&](const ThreadBuffer::Entry& entry, const uint8_t* pArgs, size_t length) {
+			bool isIntact = entry.time == entry.siteId;
+			for (size_t i{}; i < length; ++i) { isIntact = isIntact and pArgs[i] == uint8_t(entry.siteId); }
+			seen.push_back({ entry.siteId, length, isIntact });
+			});
+		return seen;
+	}
+
+	// Moves the buffer's write position to `offset` bytes before the end
+	void AdvanceToTail(ThreadBuffer& buffer, size_t remaining)
+	{
+		const size_t half = ThreadBuffer::Capacity / 2;
+		Put(buffer, 1, half, 1);
+		Put(buffer, 2, half - remaining, 2);
+		DrainAll(buffer);
+	}
+
+	// Records read back from a log file
+	struct FileRecord
+	{
+		uint32_t siteId{};
+		uint32_t threadId{};
+		std::string text{};
+	};
+
+	// Records lost to a full thread buffer, by logger thread id
+	using DropCounts = std::vector<uint64_t>;
+
+	bool ReadLog(const std::filesystem::path& path, std::vector<FileRecord>* pRecords, DropCounts* pDropped)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		const std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+
+		Logging::FileHeader header{};
+		if (data.size() < sizeof(header)) { return false; }
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.magic != Logging::FileMagic) { return false; }
+
+		std::vector<std::string> formats;
+		size_t offset = sizeof(header);
+		while (offset < data.size()) {
+			Logging::ChunkHeader chunk{};
+			if (offset + sizeof(chunk) > data.size()) { return false; }
+			std::memcpy(&chunk, data.data() + offset, sizeof(chunk));
+			const uint8_t* pPayload = data.data() + offset + sizeof(chunk);
+			offset += sizeof(chunk) + chunk.size;
+			if (offset > data.size()) { return false; }
+
+			if (Logging::ChunkType(chunk.type) == Logging::ChunkType::Site) {
+				Logging::SiteChunk site{};
+				std::memcpy(&site, pPayload, sizeof(site));
+				const char* pText = reinterpret_cast<const char*>(pPayload + sizeof(site));
+				formats.resize(std::max<size_t>(formats.size(), site.id));
+				formats[site.id - 1].assign(pText + site.fileLength, site.formatLength);
+			}
+			else if (Logging::ChunkType(chunk.type) == Logging::ChunkType::Record) {
+				Logging::RecordChunk record{};
+				std::memcpy(&record, pPayload, sizeof(record));
+				if (record.siteId == 0 or record.siteId > formats.size()) { return false; }
+
+				FileRecord item{ record.siteId, record.threadId, {} };
+				const std::string& format = formats[record.siteId - 1];
+				if (!Logging::RenderMessage(format.data(), format.size(), pPayload + sizeof(record),
+					chunk.size - sizeof(record), &item.text))
+				{
+					return false;
+				}
+				pRecords->push_back(std::move(item));
+			}
+			else if (Logging::ChunkType(chunk.type) == Logging::ChunkType::Dropped) {
+				Logging::DroppedChunk dropped{};
+				std::memcpy(&dropped, pPayload, sizeof(dropped));
+				pDropped->resize(std::max<size_t>(pDropped->size(), size_t(dropped.threadId) + 1));
+				(*pDropped)[dropped.threadId] += dropped.count;
+			}
+		}
+		return true;
+	}
+
+	uint64_t Total(const DropCounts& dropped)
+	{
+		uint64_t total{};
+		for (uint64_t count : dropped) { total += count; }
+		return total;
+	}
+}
+
+TEST_CASE(ShortTailIsPaddingWithoutAHeader)
+{
+	// 8 bytes left: too short for an Entry, so nothing may be written there
+	ThreadBuffer buffer{ 1 };
+	AdvanceToTail(buffer, 8);
+	REQUIRE(Put(buffer, 3, 40, 3));
+
+	const std::vector<Seen> seen = DrainAll(buffer);
+	REQUIRE(seen.size() == 1);
+	CHECK(seen[0].siteId == 3);
+	CHECK(seen[0].length == 40 - sizeof(ThreadBuffer::Entry));
+	CHECK(seen[0].isIntact);
+	CHECK(buffer.IsEmpty());
+}
+
+TEST_CASE(TailsOfEverySizeWrap)
+{
+	for (size_t remaining{ ThreadBuffer::Alignment }; remaining <= 64; remaining += ThreadBuffer::Alignment) {
+		ThreadBuffer buffer{ 1 };
+		AdvanceToTail(buffer, remaining);
+		REQUIRE(Put(buffer, 3, 70, 3));   // Never fits the tail
+		REQUIRE(Put(buffer, 4, 20, 4));
+
+		const std::vector<Seen> seen = DrainAll(buffer);
+		REQUIRE(seen.size() == 2);
+		CHECK(seen[0].siteId == 3 and seen[0].isIntact);
+		CHECK(seen[1].siteId == 4 and seen[1].isIntact);
+		CHECK(seen[1].length == 20 - sizeof(ThreadBuffer::Entry));
+	}
+}
+
+TEST_CASE(RandomEntriesSurviveWraps)
+{
+	Test::Random random{ 32 };
+	ThreadBuffer buffer{ 1 };
+	uint32_t nextWritten{ 1 }, nextRead{ 1 };
+	uint64_t dropped{};
+	bool isOrdered{ true }, isIntact{ true };
+
+	for (int step{}; step < 200000; ++step) {
+		if (random.Chance(70)) {
+			const size_t size = sizeof(ThreadBuffer::Entry) + size_t(random.Range(0, 600));
+			const uint32_t siteId = nextWritten % 250 + 1;
+			if (Put(buffer, siteId, size, uint8_t(siteId))) { ++nextWritten; }
+			else { ++dropped; }
+		}
+		else {
+			for (const Seen& seen : DrainAll(buffer)) {
+				isOrdered = isOrdered and seen.siteId == nextRead % 250 + 1;
+				isIntact = isIntact and seen.isIntact;
+				++nextRead;
+			}
+		}
+	}
+	for (const Seen& seen : DrainAll(buffer)) {
+		isOrdered = isOrdered and seen.siteId == nextRead % 250 + 1;
+		++nextRead;
+	}
+
+	CHECK(isOrdered);
+	CHECK(isIntact);
+	CHECK(nextRead == nextWritten);
+	CHECK(buffer.TakeDropped() == dropped);
+}
+
+TEST_CASE(FileHoldsEveryRecordExactly)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "TabTapAsyncLoggerTest.log";
+	std::filesystem::remove(path);
+
+	Logging::AsyncLogger logger{};
+	Logging::AsyncLogger::Config config{};
+	config.flushInterval = std::chrono::milliseconds{ 1 };
+	REQUIRE(logger.Start(path, config));
+
+	// Varying lengths move the buffer through every tail size
+	constexpr int Count = 20000;
+	std::thread writer{ [&]() {
+		for (int i{}; i < Count; ++i) {
+			const std::string text(size_t(i % 37), char('a' + i % 26));
+			LOG_INFO(logger, "{} {} {}", i, text, L"wé");
+			if (i % 500 == 0) { std::this_thread::sleep_for(std::chrono::milliseconds{ 2 }); }
+		}
+		} };
+	writer.join();
+	logger.Stop();
+
+	std::vector<FileRecord> records;
+	DropCounts dropped;
+	REQUIRE(ReadLog(path, &records, &dropped));
+	std::filesystem::remove(path);
+
+	// Drops are allowed under pressure, but each call is in the file or counted
+	CHECK(!records.empty());
+	CHECK(records.size() + Total(dropped) == Count);
+	bool isExact{ true };
+	int last{ -1 };
+	for (const FileRecord& record : records) {
+		const int i = std::stoi(record.text);
+		const std::string expected = std::to_string(i) + " " +
+			std::string(size_t(i % 37), char('a' + i % 26)) + " w\xC3\xA9";
+		isExact = isExact and record.text == expected and i > last;
+		last = i;
+	}
+	CHECK(isExact);
+}
+
+TEST_CASE(StopWhileWritersRun)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "TabTapAsyncLoggerStopTest.log";
+	std::filesystem::remove(path);
+
+	Logging::AsyncLogger logger{};
+	Logging::AsyncLogger::Config config{};
+	config.flushInterval = std::chrono::milliseconds{ 1 };
+	REQUIRE(logger.Start(path, config));
+
+	// Each writer logs until it sees the logger stopped. Calls before the one
+	// that saw it were accepted; that last call may or may not have been.
+	constexpr int Writers = 4;
+	std::atomic<int> started{};
+	int lastCall[Writers]{};
+	std::vector<std::thread> writers;
+	for (int writer{}; writer < Writers; ++writer) {
+		writers.emplace_back([&, writer]() {
+			for (int i{};; ++i) {
+				LOG_INFO(logger, "{} {}", writer, i);
+				if (i == 1000) { started.fetch_add(1); }
+				if (!logger.IsRunning()) {
+					lastCall[writer] = i;
+					return;
+				}
+				if (i % 256 == 0) { std::this_thread::yield(); }
+			}
+			});
+	}
+	while (started.load() < Writers) { std::this_thread::yield(); }
+	logger.Stop();
+	for (std::thread& writer : writers) { writer.join(); }
+
+	std::vector<FileRecord> records;
+	DropCounts dropped;
+	REQUIRE(ReadLog(path, &records, &dropped));
+	std::filesystem::remove(path);
+
+	int present[Writers]{};
+	int last[Writers]{ -1, -1, -1, -1 };
+	uint32_t threadIds[Writers]{};
+	bool isOrdered{ true };
+	for (const FileRecord& record : records) {
+		const int writer = std::stoi(record.text);
+		const int i = std::stoi(record.text.substr(record.text.find(' ') + 1));
+		REQUIRE(writer >= 0 and writer < Writers);
+		isOrdered = isOrdered and i > last[writer] and i <= lastCall[writer];
+		last[writer] = i;
+		threadIds[writer] = record.threadId;
+		++present[writer];
+	}
+	CHECK(isOrdered);
+
+	// Every accepted call is in the file or counted as dropped
+	for (int writer{}; writer < Writers; ++writer) {
+		REQUIRE(present[writer] > 0);
+		const uint64_t lost = threadIds[writer] < dropped.size() ? dropped[threadIds[writer]] : 0;
+		const uint64_t accounted = uint64_t(present[writer]) + lost;
+		CHECK(accounted == uint64_t(lastCall[writer]) or accounted == uint64_t(lastCall[writer]) + 1);
+		if (last[writer] == lastCall[writer]) { CHECK(accounted == uint64_t(lastCall[writer]) + 1); }
+	}
+}
@@ -0,0 +1,168 @@
+// Focus classification, the element cache and the show/hide policy.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/AutoShow.h"
+
+using AutoShow::Action;
+using AutoShow::Element;
+using AutoShow::Target;
+
+namespace
+{
+	const Element Edit{ AutoShow::ControlTypeEdit, AutoShow::TraitValuePattern | AutoShow::TraitTextPattern };
+	const Element Button{ 50000, AutoShow::TraitNone };
+}
+
+TEST_CASE(EditableFieldsAreText)
+{
+	using namespace AutoShow;
+	CHECK(Classify(Edit) == Target::Text);
+	CHECK(Classify({ ControlTypeEdit, TraitValuePattern | TraitReadOnly }) == Target::Other);
+	// Password boxes expose no value pattern
+	CHECK(Classify({ ControlTypeEdit, TraitNone }) == Target::Text);
+
+	// Browser pages are read-only documents; rich editors are not
+	CHECK(Classify({ ControlTypeDocument, TraitValuePattern | TraitTextPattern | TraitReadOnly }) == Target::Other);
+	CHECK(Classify({ ControlTypeDocument, TraitValuePattern | TraitTextPattern }) == Target::Text);
+	CHECK(Classify({ ControlTypeDocument, TraitTextPattern }) == Target::Other);
+	CHECK(Classify({ ControlTypeComboBox, TraitValuePattern }) == Target::Text);
+	CHECK(Classify({ ControlTypeComboBox, TraitNone }) == Target::Other);
+
+	CHECK(Classify(Button) == Target::Other);
+	CHECK(Classify({ ControlTypeEdit, TraitValuePattern | TraitOwnWindow }) == Target::Ignored);
+	CHECK(Classify({ 50000, TraitOwnWindow }) == Target::Ignored);
+}
+
+TEST_CASE(RuntimeIdHashCoversEveryPart)
+{
+	const int32_t a[] = { 42, 1, 2 };
+	const int32_t b[] = { 42, 1, 3 };
+	const int32_t c[] = { 42, 1, 2, 0 };
+	CHECK(AutoShow::HashRuntimeId(a, 3) != AutoShow::HashRuntimeId(b, 3));
+	CHECK(AutoShow::HashRuntimeId(a, 3) != AutoShow::HashRuntimeId(c, 4));
+	CHECK(AutoShow::HashRuntimeId(a, 3) == AutoShow::HashRuntimeId(c, 3));
+}
+
+TEST_CASE(CacheEvictsTheLeastRecentlyUsed)
+{
+	AutoShow::ElementCache cache{};
+	Element element{};
+	CHECK(!cache.Find(1, 0, &element));
+
+	for (uint64_t key{ 1 }; key <= AutoShow::ElementCache::Capacity; ++key) { cache.Store(key, Button, 0); }
+	REQUIRE(cache.Find(1, 10, &element));
+	CHECK(element.controlType == Button.controlType);
+
+	// Key 2 is now the oldest use
+	cache.Store(100, Edit, 20);
+	CHECK(!cache.Find(2, 30, &element));
+	CHECK(cache.Find(1, 30, &element));
+	CHECK(cache.Find(100, 30, &element) and element.traits == Edit.traits);
+
+	// Storing a known key replaces its entry in place
+	cache.Store(3, Edit, 40);
+	CHECK(cache.Find(3, 50, &element) and element.controlType == Edit.controlType);
+	CHECK(cache.Find(4, 50, &element) and element.controlType == Button.controlType);
+
+	CHECK(cache.GetHits() == 5);
+	CHECK(cache.GetMisses() == 2);
+
+	cache.Clear();
+	CHECK(!cache.Find(1, 60, &element));
+	CHECK(cache.GetHits() == 0 and cache.GetMisses() == 1);
+}
+
+TEST_CASE(CacheEntriesExpire)
+{
+	AutoShow::ElementCache cache{ { 1000 } };
+	cache.Store(7, Edit, 5000);
+	Element element{};
+	CHECK(cache.Find(7, 6000, &element));
+	CHECK(!cache.Find(7, 6001, &element));
+
+	// Looking again refreshes it
+	cache.Store(7, Edit, 6001);
+	CHECK(cache.Find(7, 7000, &element));
+}
+
+TEST_CASE(FocusMustRestBeforeShowingOrHiding)
+{
+	AutoShow::Policy policy{};
+	CHECK(policy.GetDeadline() == AutoShow::NoDeadline);
+
+	policy.OnFocus(Target::Text, 1, 1000);
+	CHECK(policy.GetDeadline() == 1100);
+	CHECK(policy.Take(1099) == Action::None);
+	CHECK(policy.Take(1100) == Action::Show);
+	CHECK(policy.Take(2000) == Action::None);
+
+	policy.OnFocus(Target::Other, 2, 3000);
+	CHECK(policy.GetDeadline() == 3500);
+	CHECK(policy.Take(3499) == Action::None);
+	CHECK(policy.Take(3500) == Action::Hide);
+
+	// Nothing to hide twice
+	policy.OnFocus(Target::Other, 3, 4000);
+	CHECK(policy.Take(4500) == Action::None);
+
+	// Repeated events for the focused element do not restart the delay
+	AutoShow::Policy repeats{};
+	repeats.OnFocus(Target::Text, 1, 0);
+	repeats.OnFocus(Target::Text, 1, 90);
+	CHECK(repeats.Take(100) == Action::Show);
+}
+
+TEST_CASE(FocusStormPostsNothingUntilItSettles)
+{
+	AutoShow::Policy policy{};
+	policy.OnFocus(Target::Text, 1, 0);
+	REQUIRE(policy.Take(100) == Action::Show);
+
+	// Tabbing through a form every 10 ms
+	for (uint64_t now{ 200 }; now < 500; now += 10) {
+		policy.OnFocus(now % 20 ? Target::Other : Target::Text, 100 + now, now);
+		CHECK(policy.Take(now) == Action::None);
+	}
+
+	// Coming back to the field that had settled leaves nothing to do
+	policy.OnFocus(Target::Text, 1, 500);
+	CHECK(!policy.IsPending());
+	CHECK(policy.Take(2000) == Action::None);
+
+	// Focus on the tab or keyboard itself changes nothing
+	policy.OnFocus(Target::Ignored, 9, 2100);
+	CHECK(!policy.IsPending());
+}
+
+TEST_CASE(UserToggleOverridesFocus)
+{
+	AutoShow::Policy policy{};
+
+	// Closed by hand over a field: stays closed until another field
+	policy.OnFocus(Target::Text, 1, 0);
+	REQUIRE(policy.Take(100) == Action::Show);
+	policy.OnUserToggle(false);
+	policy.OnFocus(Target::Text, 1, 200);
+	CHECK(policy.Take(1000) == Action::None);
+	policy.OnFocus(Target::Text, 2, 1000);
+	CHECK(policy.Take(1100) == Action::Show);
+
+	// Opened by hand: never hidden for focus
+	policy.OnFocus(Target::Other, 3, 2000);
+	CHECK(policy.Take(2500) == Action::Hide);
+	policy.OnUserToggle(true);
+	policy.OnFocus(Target::Other, 4, 3000);
+	CHECK(policy.Take(4000) == Action::None);
+	policy.OnFocus(Target::Text, 5, 4000);
+	CHECK(policy.Take(4100) == Action::Show);
+	policy.OnFocus(Target::Other, 6, 4200);
+	CHECK(policy.Take(5000) == Action::None);
+
+	// Closing it by hand ends the pin
+	policy.OnUserToggle(false);
+	policy.OnFocus(Target::Text, 7, 6000);
+	CHECK(policy.Take(6100) == Action::Show);
+	policy.OnFocus(Target::Other, 8, 6200);
+	CHECK(policy.Take(6700) == Action::Hide);
+}
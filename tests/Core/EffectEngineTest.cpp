@@ -0,0 +1,161 @@
+// Effect tracks, playback timing and the pre-rendered frame cache.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/EffectEngine.h"
+
+// Standard library headers
+#include <vector>
+
+using Effects::Channel;
+using Effects::Interpolation;
+using Effects::Keyframe;
+using Effects::Track;
+
+namespace
+{
+	constexpr Keyframe FadeKeys[] = { { 0, 1.0f }, { 300, 0.0f } };
+	constexpr Track FadeTracks[] = { { Channel::Alpha, Interpolation::Linear, false, FadeKeys, 2 } };
+	constexpr Effects::Effect Fade{ FadeTracks, 1, 300, 30, 0 };
+
+	// Opaque grey image
+	struct Image
+	{
+		long width{}, height{};
+		std::vector<Render::Pixel> pixels{};
+
+		Image(long w, long h) : width{ w }, height{ h }, pixels(size_t(w * h), Render::MakeOpaque(0x80, 0x80, 0x80)) {}
+
+		Render::ImageView View() const { return { pixels.data(), width, height, width }; }
+	};
+
+	Effects::Sample Tinted(uint8_t tint)
+	{
+		Effects::Sample sample{};
+		sample.tint = tint;
+		return sample;
+	}
+}
+
+TEST_CASE(TracksStepInterpolateAndLoop)
+{
+	const Track& blink = Effects::BlinkTracks[0];
+	CHECK(Effects::SampleTrack(blink, 0) == 0.9f);
+	CHECK(Effects::SampleTrack(blink, 399) == 0.9f);
+	CHECK(Effects::SampleTrack(blink, 400) == 0.0f);
+	CHECK(Effects::SampleTrack(blink, 800) == 0.9f);   // Looped back to the start
+	CHECK(Effects::SampleTrack(blink, 1150) == 0.9f);
+
+	const Track& fade = FadeTracks[0];
+	CHECK(Effects::SampleTrack(fade, 150) == 0.5f);
+	CHECK(Effects::SampleTrack(fade, 1000) == 0.0f);    // Held after the last key
+
+	const Effects::Sample sample = Effects::SampleEffect(Fade, 150);
+	CHECK(sample.alpha == Effects::ToByte(0.5f));
+	CHECK(sample.tint == 0 and sample.pulse == 0xff);
+}
+
+TEST_CASE(PlayerFollowsTheFrameGrid)
+{
+	Effects::Player player{};
+	CHECK(!player.Advance(100));
+	CHECK(player.GetDelayMs(100) == 0);
+
+	player.Start(Fade, 1000);
+	CHECK(player.IsPlaying());
+	CHECK(player.GetDelayMs(1000) == 30);
+	CHECK(player.GetDelayMs(1010) == 20);
+
+	// Within the first frame nothing changes
+	CHECK(!player.Advance(1029));
+	CHECK(player.Advance(1030));
+	CHECK(player.GetFrameIndex() == 1);
+	CHECK(player.Advance(1095));
+	CHECK(player.GetFrameIndex() == 3);
+
+	// A clock that stepped back restarts the current run
+	CHECK(player.Advance(900));
+	CHECK(player.GetFrameIndex() == 0);
+
+	CHECK(player.Advance(1200));
+	CHECK(player.Advance(1300));
+	CHECK(!player.IsPlaying());
+	CHECK(player.GetSample().IsNeutral());
+}
+
+TEST_CASE(CacheRendersEachSampleOnce)
+{
+	const Image image{ 8, 4 };
+	Effects::FrameCache cache{};
+
+	// Neutral samples show the source itself
+	CHECK(cache.Get(image.View(), 1, {}, 0xff0000).pPixels == image.pixels.data());
+	CHECK(cache.GetFrameCount() == 0);
+
+	const Render::ImageView first = cache.Get(image.View(), 1, Tinted(0x80), 0xff0000);
+	CHECK(first.pPixels != image.pixels.data());
+	CHECK(cache.Get(image.View(), 1, Tinted(0x80), 0xff0000).pPixels == first.pPixels);
+	CHECK(cache.GetHits() == 1 and cache.GetMisses() == 1);
+
+	// Prerender covers every distinct sample of the effect
+	cache.Prerender(Fade, image.View(), 1);
+	CHECK(cache.IsBound(1));
+	const uint64_t misses = cache.GetMisses();
+	Effects::Player player{};
+	player.Start(Fade, 0);
+	for (uint64_t nowMs{}; player.IsPlaying(); nowMs += 7) {
+		player.Advance(nowMs);
+		cache.Get(image.View(), 1, player.GetSample(), Fade.tintColor);
+	}
+	CHECK(cache.GetMisses() == misses);
+}
+
+TEST_CASE(TintColourIsPartOfTheKey)
+{
+	const Image image{ 4, 4 };
+	Effects::FrameCache cache{};
+
+	const Render::ImageView red = cache.Get(image.View(), 1, Tinted(0xff), 0xff0000);
+	const Render::ImageView blue = cache.Get(image.View(), 1, Tinted(0xff), 0x0000ff);
+	CHECK(red.pPixels != blue.pPixels);
+	CHECK(cache.GetMisses() == 2);
+	CHECK(((red.Row(0)[0] >> 16) & 0xff) == 0xff);
+	CHECK(((blue.Row(0)[0] >> 16) & 0xff) == 0x80);
+	CHECK((blue.Row(0)[0] & 0xff) == 0xff);
+}
+
+TEST_CASE(NewGenerationDropsFramesOfTheSameSize)
+{
+	// A reload that reuses the old image's memory and size
+	Image image{ 4, 4 };
+	Effects::FrameCache cache{};
+	const Render::Pixel before = cache.Get(image.View(), 1, Tinted(0xff), 0xff0000).Row(0)[0];
+
+	image.pixels.assign(image.pixels.size(), Render::MakeOpaque(0, 0xff, 0));
+	const Render::Pixel after = cache.Get(image.View(), 2, Tinted(0xff), 0xff0000).Row(0)[0];
+	CHECK(after != before);
+	CHECK(((after >> 8) & 0xff) == 0xff);
+	CHECK(cache.GetFrameCount() == 1);
+	CHECK(!cache.IsBound(1));
+
+	cache.Clear();
+	CHECK(!cache.IsBound(2));
+	CHECK(cache.GetFrameCount() == 0);
+}
+
+TEST_CASE(CacheKeepsAtMostMaxFrames)
+{
+	const Image image{ 2, 2 };
+	Effects::FrameCache cache{};
+	for (size_t i{ 1 }; i <= Effects::FrameCache::MaxFrames + 8; ++i) {
+		cache.Get(image.View(), 1, Tinted(uint8_t(i)), 0xffff00);
+		REQUIRE(cache.GetFrameCount() <= Effects::FrameCache::MaxFrames);
+	}
+
+	// The oldest frames went first
+	const uint64_t misses = cache.GetMisses();
+	cache.Get(image.View(), 1, Tinted(Effects::FrameCache::MaxFrames + 8), 0xffff00);
+	CHECK(cache.GetMisses() == misses);
+	cache.Get(image.View(), 1, Tinted(1), 0xffff00);
+	CHECK(cache.GetMisses() == misses + 1);
+}
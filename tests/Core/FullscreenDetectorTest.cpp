@@ -0,0 +1,103 @@
+// Fullscreen and presentation detection from the abstract window list.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/FullscreenDetector.h"
+
+// Standard library headers
+#include <iterator>
+
+using Fullscreen::NotificationState;
+using Fullscreen::Reason;
+using Fullscreen::Window;
+using Fullscreen::WindowKind;
+
+namespace
+{
+	const Geometry::Rect Monitors[] = { { 0, 0, 1920, 1080 }, { 1920, 0, 4480, 1440 } };
+
+	Window App(const Geometry::Rect& bounds, bool isForeground, bool isBordered = false)
+	{
+		return { bounds, WindowKind::Normal, true, false, isBordered, isForeground };
+	}
+
+	template <size_t N>
+	Reason Detect(const Window (&windows)[N], NotificationState state = NotificationState::AcceptsNotifications)
+	{
+		return Fullscreen::Detect(state, windows, N, Monitors, std::size(Monitors));
+	}
+}
+
+TEST_CASE(ShellStatesWinOverTheWindowList)
+{
+	const Window windows[] = { App({ 100, 100, 500, 500 }, true) };
+	CHECK(Detect(windows, NotificationState::RunningD3DFullScreen) == Reason::Exclusive);
+	CHECK(Detect(windows, NotificationState::PresentationMode) == Reason::Presentation);
+	CHECK(Detect(windows, NotificationState::Busy) == Reason::Busy);
+	CHECK(Detect(windows, NotificationState::QuietTime) == Reason::None);
+	CHECK(Detect(windows, NotificationState::NotPresent) == Reason::None);
+}
+
+TEST_CASE(BorderlessForegroundCoveringItsMonitor)
+{
+	const Window primary[] = { App({ 0, 0, 1920, 1080 }, true) };
+	CHECK(Detect(primary) == Reason::Covering);
+
+	// The second monitor, overhanging it a little
+	const Window secondary[] = { App({ 1910, -10, 4490, 1450 }, true) };
+	CHECK(Detect(secondary) == Reason::Covering);
+
+	// A maximized window has a frame and does not count
+	const Window maximized[] = { App({ -8, -8, 1928, 1088 }, true, true) };
+	CHECK(Detect(maximized) == Reason::None);
+
+	// Short of the monitor by one pixel
+	const Window smaller[] = { App({ 0, 0, 1920, 1079 }, true) };
+	CHECK(Detect(smaller) == Reason::None);
+}
+
+TEST_CASE(OnlyTheFrontApplicationCounts)
+{
+	// A covering window in the background does not hide the tab
+	const Window background[] = {
+		App({ 100, 100, 500, 500 }, true),
+		App({ 0, 0, 1920, 1080 }, false),
+	};
+	CHECK(Detect(background) == Reason::None);
+
+	// Shell surfaces such as the desktop cover the monitor but are not apps
+	Window desktop = App({ 0, 0, 1920, 1080 }, true);
+	desktop.kind = WindowKind::Shell;
+	const Window shell[] = { desktop };
+	CHECK(Detect(shell) == Reason::None);
+
+	Window cloaked = App({ 0, 0, 1920, 1080 }, true);
+	cloaked.isCloaked = true;
+	const Window hidden[] = { cloaked };
+	CHECK(Detect(hidden) == Reason::None);
+}
+
+TEST_CASE(OwnForegroundLooksBelowItself)
+{
+	// Clicking the tab makes it the foreground; the app underneath decides
+	Window tab = App({ 0, 500, 7, 595 }, true);
+	tab.kind = WindowKind::Own;
+	Window osk = App({ 100, 600, 900, 900 }, false);
+	osk.kind = WindowKind::Own;
+	Window invisible = App({ 0, 0, 1920, 1080 }, false);
+	invisible.isVisible = false;
+
+	const Window windows[] = { tab, osk, invisible, App({ 0, 0, 1920, 1080 }, false) };
+	CHECK(Detect(windows) == Reason::Covering);
+
+	const Window nothingBelow[] = { tab, osk };
+	CHECK(Detect(nothingBelow) == Reason::None);
+}
+
+TEST_CASE(MonitorIsChosenByTheCentre)
+{
+	const Geometry::Rect* pMonitor = Fullscreen::FindMonitor({ 1800, 0, 2200, 100 }, Monitors, std::size(Monitors));
+	REQUIRE(pMonitor != nullptr);
+	CHECK(pMonitor->left == 1920);
+	CHECK(Fullscreen::FindMonitor({ -500, -500, -100, -100 }, Monitors, std::size(Monitors)) == nullptr);
+}
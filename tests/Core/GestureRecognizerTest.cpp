@@ -0,0 +1,140 @@
+// Touch gestures on the tab: tap, drag, long press, flick and extra contacts.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/GestureRecognizer.h"
+
+// Standard library headers
+#include <cstdint>
+#include <vector>
+
+using Gestures::ActionKind;
+using Gestures::PointerPhase;
+using Gestures::Recognizer;
+
+namespace
+{
+	// The tick count wraps during every trace
+	constexpr uint32_t Base = 0xFFFFFF00u;
+
+	struct Step
+	{
+		PointerPhase phase{};
+		long x{}, y{};
+		uint32_t timeMs{};
+	};
+
+	// Feeds a trace, firing the long-press timer at `timerMs` (0: never)
+	std::vector<Gestures::Action> Play(Recognizer& recognizer, const std::vector<Step>& steps, uint32_t timerMs = 0)
+	{
+		std::vector<Gestures::Action> actions{};
+		for (const Step& step : steps) {
+			if (timerMs and int32_t(step.timeMs - timerMs) >= 0) {
+				const Gestures::Action action = recognizer.OnTimer(timerMs);
+				if (action.kind != ActionKind::None) { actions.push_back(action); }
+				timerMs = 0;
+			}
+			const Gestures::Action action = recognizer.OnPointer({ step.phase, 1, { step.x, step.y }, step.timeMs });
+			if (action.kind != ActionKind::None) { actions.push_back(action); }
+		}
+		return actions;
+	}
+}
+
+TEST_CASE(TapIsRecognizedOnRelease)
+{
+	Recognizer recognizer{};
+	const auto actions = Play(recognizer, {
+		{ PointerPhase::Down, 3, 500, Base },
+		{ PointerPhase::Update, 5, 502, Base + 30 },   // Inside the slop
+		{ PointerPhase::Up, 5, 502, Base + 80 },
+	});
+	REQUIRE(actions.size() == 1);
+	CHECK(actions[0].kind == ActionKind::Tap);
+	CHECK(actions[0].timeMs == Base + 80);
+	CHECK(!recognizer.IsActive());
+}
+
+TEST_CASE(VerticalMovementDragsTheTab)
+{
+	Recognizer recognizer{};
+	const auto actions = Play(recognizer, {
+		{ PointerPhase::Down, 3, 500, Base },
+		{ PointerPhase::Update, 4, 505, Base + 8 },
+		{ PointerPhase::Update, 4, 512, Base + 16 },
+		{ PointerPhase::Update, 5, 540, Base + 24 },
+		{ PointerPhase::Up, 5, 560, Base + 40 },
+	});
+	REQUIRE(actions.size() == 3);
+	CHECK(actions[0].kind == ActionKind::DragStart);
+	CHECK(actions[0].offset.y == 12);
+	CHECK(actions[1].kind == ActionKind::DragMove);
+	CHECK(actions[1].offset.y == 40);
+	CHECK(actions[2].kind == ActionKind::DragEnd);
+}
+
+TEST_CASE(HoldingStillIsALongPress)
+{
+	Recognizer recognizer{};
+	const auto actions = Play(recognizer, {
+		{ PointerPhase::Down, 3, 500, Base },
+		{ PointerPhase::Update, 3, 501, Base + 300 },
+		{ PointerPhase::Update, 3, 501, Base + 600 },
+		{ PointerPhase::Up, 3, 501, Base + 900 },      // Consumed: no tap
+	}, Base + recognizer.GetLongPressDelay());
+	REQUIRE(actions.size() == 1);
+	CHECK(actions[0].kind == ActionKind::LongPress);
+	CHECK(actions[0].timeMs == Base + 500);
+
+	// The timer fired too early does nothing; a late release still counts
+	Recognizer late{};
+	CHECK(late.OnPointer({ PointerPhase::Down, 1, { 0, 0 }, Base }).kind == ActionKind::None);
+	CHECK(late.OnTimer(Base + 499).kind == ActionKind::None);
+	CHECK(late.OnPointer({ PointerPhase::Up, 1, { 0, 0 }, Base + 700 }).kind == ActionKind::LongPress);
+}
+
+TEST_CASE(FastSidewaysReleaseIsAFlick)
+{
+	Recognizer recognizer{};
+	const auto actions = Play(recognizer, {
+		{ PointerPhase::Down, 20, 500, Base },
+		{ PointerPhase::Update, 10, 501, Base + 16 },
+		{ PointerPhase::Update, 0, 502, Base + 32 },
+		{ PointerPhase::Up, 0, 502, Base + 50 },
+	});
+	REQUIRE(actions.size() == 1);
+	CHECK(actions[0].kind == ActionKind::Flick);
+	CHECK(actions[0].offset.x == -20);
+
+	// Too slow: nothing
+	CHECK(Play(recognizer, {
+		{ PointerPhase::Down, 20, 500, Base },
+		{ PointerPhase::Update, 0, 501, Base + 16 },
+		{ PointerPhase::Up, 0, 502, Base + 800 },
+	}).empty());
+}
+
+TEST_CASE(OnlyTheFirstContactCounts)
+{
+	Recognizer recognizer{};
+	recognizer.OnPointer({ PointerPhase::Down, 1, { 0, 0 }, 0 });
+	CHECK(recognizer.OnPointer({ PointerPhase::Down, 2, { 5, 5 }, 1 }).kind == ActionKind::None);
+	CHECK(recognizer.OnPointer({ PointerPhase::Up, 2, { 5, 5 }, 2 }).kind == ActionKind::None);
+	CHECK(recognizer.OnPointer({ PointerPhase::Up, 1, { 0, 0 }, 3 }).kind == ActionKind::Tap);
+}
+
+TEST_CASE(CancelEndsADrag)
+{
+	Recognizer recognizer{};
+	Play(recognizer, { { PointerPhase::Down, 3, 500, 0 }, { PointerPhase::Update, 3, 530, 10 } });
+	CHECK(recognizer.IsDragging());
+	CHECK(recognizer.OnPointer({ PointerPhase::Cancel, 1, { 3, 530 }, 20 }).kind == ActionKind::DragEnd);
+	CHECK(!recognizer.IsActive());
+
+	// Cancelling a press is silent, and Reset drops a contact
+	recognizer.OnPointer({ PointerPhase::Down, 1, { 0, 0 }, 30 });
+	CHECK(recognizer.OnPointer({ PointerPhase::Cancel, 1, { 0, 0 }, 40 }).kind == ActionKind::None);
+	recognizer.OnPointer({ PointerPhase::Down, 1, { 0, 0 }, 50 });
+	recognizer.Reset();
+	CHECK(recognizer.OnPointer({ PointerPhase::Up, 1, { 0, 0 }, 60 }).kind == ActionKind::None);
+}
@@ -0,0 +1,212 @@
+// Glyph atlas packing, label layout and the layout code overlay.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/GlyphAtlas.h"
+
+// Standard library headers
+#include <cstring>
+
+namespace
+{
+	// Block glyphs 5 columns wide (space is empty) whose coverage is the character code
+	bool Blocks(char ch, long cellHeight, Glyphs::Bitmap* pBitmap)
+	{
+		pBitmap->width = ch == ' ' ? 0 : 5;
+		pBitmap->advance = 6;
+		pBitmap->coverage.assign(size_t(pBitmap->width) * size_t(cellHeight), uint8_t(ch));
+		return true;
+	}
+
+	// Glyphs wider than their advance, so neighbours overlap by a column
+	bool Wide(char ch, long cellHeight, Glyphs::Bitmap* pBitmap)
+	{
+		pBitmap->width = 4;
+		pBitmap->advance = 3;
+		pBitmap->coverage.assign(size_t(pBitmap->width) * size_t(cellHeight), 0);
+		for (long y{}; y < cellHeight; ++y) {
+			pBitmap->coverage[size_t(y * 4)] = uint8_t(ch);
+			pBitmap->coverage[size_t(y * 4 + 3)] = 0x10;
+		}
+		return true;
+	}
+
+	bool IsCode(const char (&code)[Glyphs::MaxLabelChars + 1], const char* pszExpected)
+	{
+		return std::strcmp(code, pszExpected) == 0;
+	}
+}
+
+TEST_CASE(AtlasPacksEveryCharacterInOneRow)
+{
+	Glyphs::Atlas atlas{};
+	CHECK(!atlas.IsBuilt());
+	CHECK(atlas.Find('A') == nullptr);
+
+	REQUIRE(atlas.Build(96, 12, Blocks));
+	CHECK(atlas.IsBuilt() and atlas.GetDpi() == 96 and atlas.GetHeight() == 12);
+
+	// Space has no columns; every other character follows the previous one
+	const Glyphs::Glyph* pSpace = atlas.Find(' ');
+	REQUIRE(pSpace != nullptr);
+	CHECK(pSpace->width == 0 and pSpace->advance == 6);
+	const Glyphs::Glyph* pA = atlas.Find('A');
+	REQUIRE(pA != nullptr);
+	CHECK(pA->x == 5 * long('A' - '!'));
+
+	const Render::MaskView mask = atlas.GetMask(*pA);
+	CHECK(mask.width == 5 and mask.height == 12);
+	CHECK(mask.Row(0)[0] == 'A' and mask.Row(11)[4] == 'A');
+	CHECK(atlas.GetMask(*atlas.Find('B')).Row(7)[0] == 'B');
+
+	// Lower case and control characters are outside the set
+	CHECK(atlas.Find('a') == nullptr);
+	CHECK(atlas.Find('\n') == nullptr);
+	CHECK(atlas.Find('_') != nullptr);
+}
+
+TEST_CASE(FailedBuildLeavesNoAtlas)
+{
+	Glyphs::Atlas atlas{};
+	REQUIRE(atlas.Build(96, 12, Blocks));
+	const uint32_t generation = atlas.GetGeneration();
+
+	CHECK(!atlas.Build(96, 0, Blocks));
+	CHECK(!atlas.IsBuilt());
+	CHECK(atlas.GetGeneration() != generation);
+
+	CHECK(!atlas.Build(96, 12, [](char ch, long cellHeight, Glyphs::Bitmap* pBitmap) {
+		return ch != 'Q' and Blocks(ch, cellHeight, pBitmap);
+		}));
+	CHECK(!atlas.IsBuilt());
+
+	// Coverage shorter than width x height
+	CHECK(!atlas.Build(96, 12, [](char ch, long cellHeight, Glyphs::Bitmap* pBitmap) {
+		Blocks(ch, cellHeight, pBitmap);
+		if (ch == 'Z') { pBitmap->coverage.pop_back(); }
+		return true;
+		}));
+	CHECK(!atlas.IsBuilt());
+}
+
+TEST_CASE(LabelLaysOutOnlyOnChange)
+{
+	Glyphs::Atlas atlas{};
+	REQUIRE(atlas.Build(96, 12, Blocks));
+
+	Glyphs::Label label{};
+	CHECK(label.Update(atlas, "EN"));
+	CHECK(!label.Update(atlas, "EN"));
+	CHECK(std::strcmp(label.GetText(), "EN") == 0);
+
+	// No spacing after the last glyph, so the mask centres
+	CHECK(label.GetSize() == Geometry::Size{ 11, 12 });
+	const Render::MaskView mask = label.GetMask();
+	CHECK(mask.Row(0)[0] == 'E' and mask.Row(0)[4] == 'E');
+	CHECK(mask.Row(0)[5] == 0);
+	CHECK(mask.Row(11)[6] == 'N' and mask.Row(11)[10] == 'N');
+
+	// Only the first MaxLabelChars count
+	CHECK(label.Update(atlas, "ABCD"));
+	CHECK(std::strcmp(label.GetText(), "ABC") == 0);
+	CHECK(!label.Update(atlas, "ABCX"));
+	CHECK(label.GetSize().cx == 17);
+
+	// A rebuilt atlas lays the same text out again at its height
+	REQUIRE(atlas.Build(144, 18, Blocks));
+	CHECK(label.Update(atlas, "ABC"));
+	CHECK(label.GetSize().cy == 18);
+}
+
+TEST_CASE(LabelSkipsUnknownCharactersAndKeepsOverlaps)
+{
+	Glyphs::Atlas atlas{};
+	REQUIRE(atlas.Build(96, 4, Blocks));
+
+	Glyphs::Label label{};
+	CHECK(label.Update(atlas, "a"));
+	CHECK(label.IsEmpty());
+	CHECK(label.Update(atlas, "  "));
+	CHECK(label.IsEmpty());
+
+	CHECK(label.Update(atlas, "aE"));
+	CHECK(label.GetSize().cx == 5);
+
+	// Spaces move the pen but do not widen the mask past the last glyph
+	CHECK(label.Update(atlas, " E "));
+	CHECK(label.GetSize().cx == 11);
+	CHECK(label.GetMask().Row(0)[6] == 'E');
+
+	// The faint right column of one glyph lies under the next glyph's left column
+	REQUIRE(atlas.Build(96, 4, Wide));
+	CHECK(label.Update(atlas, "AB"));
+	CHECK(label.GetSize().cx == 7);
+	const Render::MaskView mask = label.GetMask();
+	CHECK(mask.Row(2)[0] == 'A');
+	CHECK(mask.Row(2)[3] == 'B');
+	CHECK(mask.Row(2)[6] == 0x10);
+}
+
+TEST_CASE(LabelIsCentredWhenItFits)
+{
+	Geometry::Point at{};
+	REQUIRE(Glyphs::PlaceLabel({ 28, 95 }, { 11, 12 }, 1, &at));
+	CHECK(at == Geometry::Point{ 8, 41 });
+	REQUIRE(Glyphs::PlaceLabel({ 13, 14 }, { 11, 12 }, 1, &at));
+	CHECK(at == Geometry::Point{ 1, 1 });
+
+	// The collapsed strip is too narrow
+	at = { -1, -1 };
+	CHECK(!Glyphs::PlaceLabel({ 7, 95 }, { 11, 12 }, 1, &at));
+	CHECK(!Glyphs::PlaceLabel({ 12, 95 }, { 11, 12 }, 1, &at));
+	CHECK(at == Geometry::Point{ -1, -1 });
+}
+
+TEST_CASE(LayoutCodesFromLanguageNames)
+{
+	char code[Glyphs::MaxLabelChars + 1]{ 'X', 'X', 'X' };
+	Glyphs::FormatLayoutCode("de-CH", code);
+	CHECK(IsCode(code, "DE"));
+	Glyphs::FormatLayoutCode("fil", code);
+	CHECK(IsCode(code, "FIL"));
+	Glyphs::FormatLayoutCode("EN_us", code);
+	CHECK(IsCode(code, "EN"));
+	Glyphs::FormatLayoutCode("abcd", code);
+	CHECK(IsCode(code, "ABC"));
+	Glyphs::FormatLayoutCode("?", code);
+	CHECK(IsCode(code, ""));
+	Glyphs::FormatLayoutCode("", code);
+	CHECK(IsCode(code, ""));
+}
+
+TEST_CASE(CodeIsDrawnOverTheFrame)
+{
+	Glyphs::Atlas atlas{};
+	REQUIRE(atlas.Build(96, 12, [](char ch, long cellHeight, Glyphs::Bitmap* pBitmap) {
+		Blocks(ch, cellHeight, pBitmap);
+		std::memset(pBitmap->coverage.data(), 0xff, pBitmap->coverage.size());
+		return true;
+		}));
+
+	Glyphs::Label label{};
+	label.Update(atlas, "EN");
+
+	Render::HeadlessBackend backend{};
+	REQUIRE(backend.CreateSurface({ 28, 95 }));
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	layer.frameColor = Render::MakeOpaque(0, 0, 255);
+	layer.frameThickness = 14;
+	REQUIRE(backend.Compose(layer));
+
+	Geometry::Point at{};
+	REQUIRE(Glyphs::PlaceLabel({ 28, 95 }, label.GetSize(), 1, &at));
+	REQUIRE(backend.BlendMask(label.GetMask(), at, Render::MakeOpaque(255, 255, 255)));
+
+	const Render::ImageView pixels = backend.GetPixels();
+	CHECK(pixels.Row(at.y)[at.x] == Render::MakeOpaque(255, 255, 255));
+	CHECK(pixels.Row(at.y + 11)[at.x + 10] == Render::MakeOpaque(255, 255, 255));
+	CHECK(pixels.Row(at.y)[at.x + 5] == layer.frameColor);      // Between the letters
+	CHECK(pixels.Row(at.y - 1)[at.x] == layer.frameColor);
+	CHECK(pixels.Row(at.y)[at.x + 11] == layer.frameColor);
+}
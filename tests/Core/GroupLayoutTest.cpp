@@ -0,0 +1,92 @@
+// Linked drag layout of the tab and the OSK, and the move counter.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/GroupLayout.h"
+
+using Geometry::Point;
+using Geometry::Rect;
+
+namespace
+{
+	const Rect WorkArea{ 0, 0, 1920, 1040 };
+	const Rect TabRect{ 1892, 400, 1920, 495 };      // 28 x 95 on the right edge
+	const Rect OskRect{ 900, 300, 1900, 650 };       // 1000 x 350
+}
+
+TEST_CASE(ClampHelpers)
+{
+	CHECK(Geometry::ClampSpan(-5, 10, 0, 100) == 0);
+	CHECK(Geometry::ClampSpan(95, 10, 0, 100) == 90);
+	CHECK(Geometry::ClampSpan(50, 200, 0, 100) == 0);   // Oversized: pinned low
+	CHECK(Geometry::ClampToBounds({ -10, 1000 }, { 28, 95 }, WorkArea) == Point{ 0, 945 });
+	CHECK(Geometry::Intersect({ 0, 0, 10, 10 }, { 20, 20, 30, 30 }).IsEmpty());
+	CHECK(Geometry::Intersect({ 0, 0, 10, 10 }, { 5, 5, 30, 30 }) == Rect{ 5, 5, 10, 10 });
+}
+
+TEST_CASE(TabFollowsAndOskStaysCentred)
+{
+	const GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag({ 1900, 500 }, TabRect, OskRect, WorkArea, true);
+
+	CHECK(placement.tab == Point{ TabRect.left, 500 });
+	CHECK(placement.moveTab);
+	// Centred on the tab, X unchanged
+	CHECK(placement.osk.x == OskRect.left);
+	CHECK(placement.osk.y == GroupLayout::CenteredTop(500, TabRect.Height(), OskRect.Height()));
+	CHECK(placement.moveOsk);
+}
+
+TEST_CASE(BothStayInsideTheWorkArea)
+{
+	Test::Random random{ 28 };
+	for (int i{}; i < 100000; ++i) {
+		const Point requested{ long(random.Range(-500, 2500)), long(random.Range(-500, 1600)) };
+		const GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag(requested, TabRect, OskRect, WorkArea, true);
+
+		REQUIRE(placement.tab.y >= WorkArea.top);
+		REQUIRE(placement.tab.y + TabRect.Height() <= WorkArea.bottom);
+		REQUIRE(placement.osk.y >= WorkArea.top);
+		REQUIRE(placement.osk.y + OskRect.Height() <= WorkArea.bottom);
+		REQUIRE(placement.tab.x == TabRect.left);
+		REQUIRE(placement.moveTab == (placement.tab.y != TabRect.top));
+	}
+}
+
+TEST_CASE(HiddenOrEmptyOskIsLeftAlone)
+{
+	GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag({ 0, 700 }, TabRect, OskRect, WorkArea, false);
+	CHECK(placement.moveTab);
+	CHECK(!placement.moveOsk);
+	CHECK(placement.osk == OskRect.TopLeft());
+
+	placement = GroupLayout::SolveLinkedDrag({ 0, 700 }, TabRect, Rect{}, WorkArea, true);
+	CHECK(!placement.moveOsk);
+}
+
+TEST_CASE(NoMoveWhenNothingChanges)
+{
+	const long centredTop = GroupLayout::CenteredTop(TabRect.top, TabRect.Height(), OskRect.Height());
+	const Rect oskCentred{ OskRect.left, centredTop, OskRect.right, centredTop + OskRect.Height() };
+
+	const GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag({ 0, TabRect.top }, TabRect, oskCentred, WorkArea, true);
+	CHECK(!placement.moveTab);
+	CHECK(!placement.moveOsk);
+}
+
+TEST_CASE(MoveCounterCountsBatches)
+{
+	GroupLayout::MoveCounter counter{};
+	counter.RecordFrame(0);     // Frames without moves do not count
+	counter.RecordFrame(2);
+	counter.RecordFrame(1);
+	counter.RecordFrame(2);
+
+	CHECK(counter.GetFrameCount() == 3);
+	CHECK(counter.GetMoveCount() == 5);
+	CHECK(counter.GetMaxMovesPerFrame() == 2);
+	CHECK(counter.GetMovesPerFrame() > 1.66 and counter.GetMovesPerFrame() < 1.67);
+
+	counter.Reset();
+	CHECK(counter.GetFrameCount() == 0);
+	CHECK(counter.GetMovesPerFrame() == 0.0);
+}
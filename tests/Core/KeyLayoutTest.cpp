@@ -0,0 +1,263 @@
+// Built-in keyboard: layout tables, hit-testing, modifier latches and cached frames.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/KeyLayout.h"
+
+// Standard library headers
+#include <cstring>
+#include <string>
+
+using KeyLayout::Key;
+using KeyLayout::KeyEvent;
+using KeyLayout::Layout;
+using KeyLayout::Status;
+
+namespace
+{
+	Layout ParseDefault()
+	{
+		Layout layout{};
+		KeyLayout::Parse(KeyLayout::DefaultTable, &layout);
+		return layout;
+	}
+
+	const Key& FindKey(const Layout& layout, uint8_t vk)
+	{
+		for (size_t i{}; i < layout.keyCount; ++i) {
+			if (layout.keys[i].vk == vk) { return layout.keys[i]; }
+		}
+		return layout.keys[0];
+	}
+
+	// Reference hit-test: the one slot containing the point, checking that slots never overlap
+	int BruteForceHit(const Layout& layout, const KeyLayout::Arrangement& arrangement, const Geometry::Point& pt)
+	{
+		int hit{ -1 };
+		for (size_t i{}; i < layout.keyCount; ++i) {
+			if (arrangement.GetSlot(i).Contains(pt)) {
+				if (hit >= 0) { return -2; }
+				hit = int(i);
+			}
+		}
+		return hit;
+	}
+
+	bool SolidGlyph(char ch, long cellHeight, Glyphs::Bitmap* pBitmap)
+	{
+		pBitmap->width = ch == ' ' ? 0 : 6;
+		pBitmap->advance = 7;
+		pBitmap->coverage.assign(size_t(pBitmap->width) * size_t(cellHeight), 0xff);
+		return true;
+	}
+}
+
+TEST_CASE(DefaultTableParses)
+{
+	Layout layout{};
+	REQUIRE(KeyLayout::Parse(KeyLayout::DefaultTable, &layout) == Status::Ok);
+	CHECK(layout.rowCount == 5);
+	CHECK(layout.rowUnits == 15 * KeyLayout::UnitsPerKey);
+
+	// Every row is 15 keys wide
+	for (size_t row{}; row < layout.rowCount; ++row) {
+		const Key& last = layout.keys[layout.rowFirst[row + 1] - 1];
+		CHECK(last.left + last.width == layout.rowUnits);
+		CHECK(last.row == row);
+	}
+
+	const Key& shift = FindKey(layout, 0xA0);
+	CHECK(std::strcmp(shift.label, "SHIFT") == 0);
+	CHECK(shift.width == 9 and shift.flags == KeyLayout::KeyModifier);
+	CHECK(FindKey(layout, 0x5B).flags == (KeyLayout::KeyModifier | KeyLayout::KeyExtended));
+	CHECK(FindKey(layout, 0x14).flags == KeyLayout::KeyLock);
+	CHECK(FindKey(layout, 0x41).label[0] == 0);
+}
+
+TEST_CASE(CellsGapsAndComments)
+{
+	Layout layout{};
+	REQUIRE(KeyLayout::Parse("41 00*0.5 42\r\n# comment\n  43*2.25mle=AB \n", &layout) == Status::Ok);
+	CHECK(layout.keyCount == 3 and layout.rowCount == 2);
+
+	// The gap only moves the next key along
+	CHECK(layout.keys[1].vk == 0x42 and layout.keys[1].left == 6);
+	CHECK(layout.keys[2].row == 1 and layout.keys[2].left == 0);
+	CHECK(layout.keys[2].width == 9);
+	CHECK(layout.keys[2].flags == (KeyLayout::KeyModifier | KeyLayout::KeyLock | KeyLayout::KeyExtended));
+	CHECK(std::strcmp(layout.keys[2].label, "AB") == 0);
+	CHECK(layout.rowUnits == 10);
+	CHECK(layout.rowFirst[0] == 0 and layout.rowFirst[1] == 2 and layout.rowFirst[2] == 3);
+}
+
+TEST_CASE(BadTablesLeaveTheLayoutAlone)
+{
+	Layout layout = ParseDefault();
+	const size_t keyCount = layout.keyCount;
+
+	CHECK(KeyLayout::Parse("", &layout) == Status::Empty);
+	CHECK(KeyLayout::Parse("# only a comment\n\n", &layout) == Status::Empty);
+	CHECK(KeyLayout::Parse("00 00*2", &layout) == Status::Empty);
+	CHECK(KeyLayout::Parse("4", &layout) == Status::BadKey);
+	CHECK(KeyLayout::Parse("41x", &layout) == Status::BadKey);
+	CHECK(KeyLayout::Parse("G1", &layout) == Status::BadKey);
+	CHECK(KeyLayout::Parse("41=", &layout) == Status::BadKey);
+	CHECK(KeyLayout::Parse("41*0", &layout) == Status::BadWidth);
+	CHECK(KeyLayout::Parse("41*1.3", &layout) == Status::BadWidth);
+	CHECK(KeyLayout::Parse("41*", &layout) == Status::BadWidth);
+	CHECK(KeyLayout::Parse("41*20 42*12.25", &layout) == Status::BadWidth);
+	CHECK(KeyLayout::Parse("41=TOOLONG", &layout) == Status::LabelTooLong);
+	CHECK(KeyLayout::Parse("41\n41\n41\n41\n41\n41\n41\n41\n41", &layout) == Status::TooManyRows);
+
+	std::string table{};
+	for (size_t i{}; i <= KeyLayout::MaxKeys; ++i) { table += i % 20 == 19 ? "41\n" : "41 "; }
+	CHECK(KeyLayout::Parse(table.c_str(), &layout) == Status::TooManyKeys);
+
+	CHECK(layout.keyCount == keyCount);
+	CHECK(std::strcmp(KeyLayout::GetStatusName(Status::BadWidth), "bad width") == 0);
+}
+
+TEST_CASE(HitTestMatchesBruteForce)
+{
+	const Layout standard = ParseDefault();
+	Layout gapped{};
+	REQUIRE(KeyLayout::Parse("41 00*0.5 42\n43*2.25 00 44*0.25\n45*3", &gapped) == Status::Ok);
+
+	Test::Random random{ 50 };
+	size_t hits{};
+	for (int run{}; run < 2000; ++run) {
+		const Layout& layout = run % 2 ? standard : gapped;
+		const long width = long(random.Range(100, 2099));
+		const long height = long(random.Range(50, 849));
+		const long left = long(random.Range(-150, 149));
+		const long top = long(random.Range(-150, 149));
+
+		KeyLayout::Arrangement arrangement{};
+		arrangement.Build(layout, { left, top, left + width, top + height }, long(random.Range(0, 4)));
+
+		for (int i{}; i < 200; ++i) {
+			const Geometry::Point pt{ left - 5 + long(random.Range(0, width + 9)), top - 5 + long(random.Range(0, height + 9)) };
+			const int hit = arrangement.HitTest(pt);
+			REQUIRE(hit == BruteForceHit(layout, arrangement, pt));
+			if (hit >= 0) {
+				++hits;
+				REQUIRE(arrangement.GetSlot(size_t(hit)).Contains(arrangement.GetKeyRect(size_t(hit)).TopLeft()));
+			}
+		}
+	}
+	CHECK(hits > 200000);
+
+	// Every pixel of a keyboard at its usual size
+	KeyLayout::Arrangement arrangement{};
+	arrangement.Build(standard, { 0, 0, 661, 233 }, 2);
+	for (long y{ -1 }; y <= 233; ++y) {
+		for (long x{ -1 }; x <= 661; ++x) {
+			REQUIRE(arrangement.HitTest({ x, y }) == BruteForceHit(standard, arrangement, { x, y }));
+		}
+	}
+}
+
+TEST_CASE(ModifiersLatchUntilTheNextKey)
+{
+	const Layout layout = ParseDefault();
+	KeyLayout::ModifierLatch latch{};
+	KeyEvent events[KeyLayout::MaxEvents]{};
+
+	REQUIRE(latch.Press(FindKey(layout, 0x41), events) == 2);
+	CHECK(events[0].vk == 0x41 and !events[0].isUp and events[1].isUp);
+
+	CHECK(latch.Press(FindKey(layout, 0xA0), events) == 0);
+	CHECK(latch.Press(FindKey(layout, 0xA2), events) == 0);
+	CHECK(latch.GetMask() == (KeyLayout::ModifierShift | KeyLayout::ModifierCtrl));
+
+	// The key goes out wrapped in the latched modifiers, released in reverse
+	REQUIRE(latch.Press(FindKey(layout, 0x25), events) == 6);
+	CHECK(events[0].vk == 0xA0 and !events[0].isUp);
+	CHECK(events[1].vk == 0xA2 and !events[1].isUp);
+	CHECK(events[2].vk == 0x25 and events[2].isExtended and !events[2].isUp);
+	CHECK(events[3].vk == 0x25 and events[3].isUp);
+	CHECK(events[4].vk == 0xA2 and events[4].isUp);
+	CHECK(events[5].vk == 0xA0 and events[5].isUp);
+	CHECK(latch.GetMask() == KeyLayout::ModifierNone);
+
+	// Tapping a modifier twice releases it
+	latch.Press(FindKey(layout, 0xA0), events);
+	latch.Press(FindKey(layout, 0xA1), events);
+	CHECK(latch.GetMask() == KeyLayout::ModifierNone);
+
+	// A lock key keeps the latches for the key after it
+	latch.Press(FindKey(layout, 0xA5), events);
+	REQUIRE(latch.Press(FindKey(layout, 0x14), events) == 4);
+	CHECK(events[0].vk == 0xA5 and events[0].isExtended);
+	CHECK(latch.GetMask() == KeyLayout::ModifierAlt);
+	latch.Clear();
+	CHECK(latch.GetMask() == KeyLayout::ModifierNone);
+
+	// A modifier flag on an unknown key types it
+	Key odd{};
+	odd.vk = 0x41;
+	odd.flags = KeyLayout::KeyModifier;
+	CHECK(KeyLayout::GetModifier(odd) == KeyLayout::ModifierNone);
+	CHECK(latch.Press(odd, events) == 2);
+}
+
+TEST_CASE(FramesArePaintedOncePerLatchState)
+{
+	const Layout layout = ParseDefault();
+	KeyLayout::Arrangement arrangement{};
+	arrangement.Build(layout, { 0, 20, 660, 240 }, 2);
+	Glyphs::Atlas atlas{};
+	REQUIRE(atlas.Build(96, 12, SolidGlyph));
+
+	const KeyLayout::Palette palette{};
+	size_t lookups{};
+	auto getLabel = [&](const Key& key, bool isShifted, char (&label)[KeyLayout::MaxLabelChars + 1]) {
+		++lookups;
+		if (key.vk < 0x41 or key.vk > 0x5A) { return false; }
+		label[0] = char(isShifted ? key.vk : key.vk + 0x20);
+		return true;
+	};
+
+	KeyLayout::FrameCache frames{};
+	CHECK(!frames.IsCached(KeyLayout::ModifierNone));
+	const Render::ImageView plain = frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	REQUIRE(plain.pPixels != nullptr);
+	CHECK(frames.GetPaintCount() == 1);
+	CHECK(frames.IsCached(KeyLayout::ModifierNone));
+	CHECK(plain.Row(10)[10] == palette.background);
+
+	const uint32_t plainHash = Render::HashPixels(plain);
+	const size_t plainLookups = lookups;
+	frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	CHECK(frames.GetPaintCount() == 1 and lookups == plainLookups);
+
+	// Shift latched: its keys light up
+	const Render::ImageView shifted = frames.Get({ 660, 240 }, KeyLayout::ModifierShift, layout, arrangement, atlas, palette, getLabel);
+	CHECK(frames.GetPaintCount() == 2);
+	CHECK(Render::HashPixels(shifted) != plainHash);
+	size_t shiftIndex{};
+	while (layout.keys[shiftIndex].vk != 0xA0) { ++shiftIndex; }
+	const Geometry::Rect shiftRect = arrangement.GetKeyRect(shiftIndex);
+	CHECK(shifted.Row(shiftRect.top + 1)[shiftRect.left + 1] == palette.latchedKey);
+	CHECK(plain.Row(shiftRect.top + 1)[shiftRect.left + 1] == palette.namedKey);
+
+	// The pressed highlight covers the key
+	const Render::MaskView mask = frames.GetKeyMask(shiftRect);
+	CHECK(mask.width == shiftRect.Width() and mask.height == shiftRect.Height());
+	CHECK(mask.Row(mask.height - 1)[mask.width - 1] == 0xff);
+
+	// New labels, a new atlas or a new size repaint
+	frames.Invalidate();
+	CHECK(!frames.IsCached(KeyLayout::ModifierShift));
+	frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	CHECK(frames.GetPaintCount() == 3);
+	REQUIRE(atlas.Build(144, 18, SolidGlyph));
+	frames.Get({ 660, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	CHECK(frames.GetPaintCount() == 4);
+	frames.Get({ 661, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	CHECK(frames.GetPaintCount() == 5);
+
+	const Render::ImageView none = frames.Get({ 0, 240 }, KeyLayout::ModifierNone, layout, arrangement, atlas, palette, getLabel);
+	CHECK(none.pPixels == nullptr);
+	CHECK(frames.GetPaintCount() == 5);
+}
@@ -0,0 +1,95 @@
+// Log argument encoding and RenderMessage: round trips and malformed blocks.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/AsyncLogger.h"
+
+// Standard library headers
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Encodes arguments the way AsyncLogger::Log does
+	template <typename... ArgTy>
+	std::vector<uint8_t> Encode(const ArgTy&... args)
+	{
+		const Logging::Arg encoded[sizeof...(ArgTy) + 1] = { Logging::Detail::MakeArg(args)... };
+		size_t size{};
+		for (size_t i{}; i < sizeof...(ArgTy); ++i) { size += Logging::Detail::EncodedSize(encoded[i]); }
+
+		std::vector<uint8_t> bytes(size);
+		uint8_t* pOut = bytes.data();
+		for (size_t i{}; i < sizeof...(ArgTy); ++i) { pOut = Logging::Detail::Encode(encoded[i], pOut); }
+		return bytes;
+	}
+
+	bool Render(const std::string& format, const std::vector<uint8_t>& args, std::string* pText)
+	{
+		pText->clear();
+		return Logging::RenderMessage(format.data(), format.size(), args.data(), args.size(), pText);
+	}
+
+	enum class Mode : uint8_t { Off = 3 };
+}
+
+TEST_CASE(ArgumentsRoundTrip)
+{
+	std::string text;
+	REQUIRE(Render("{} {} {} {} {}", Encode(-42, 42u, 1.5, true, Mode::Off), &text));
+	CHECK(text == "-42 42 1.5 1 3");
+
+	REQUIRE(Render("[{}|{}]", Encode("narrow", std::string{ "std" }), &text));
+	CHECK(text == "[narrow|std]");
+
+	// Wide strings arrive as UTF-8, surrogate pairs included
+	REQUIRE(Render("{}", Encode(L"é€\U0001F600"), &text));
+	CHECK(text == "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+	const char* pNull{};
+	REQUIRE(Render("{}", Encode(pNull), &text));
+	CHECK(text == "(null)");
+}
+
+TEST_CASE(LongStringsAreTruncated)
+{
+	std::string text;
+	const std::string longText(Logging::MaxStringBytes + 50, 'x');
+	REQUIRE(Render("{}", Encode(longText), &text));
+	CHECK(text.size() == Logging::MaxStringBytes);
+
+	// Never splits a wide character
+	const std::wstring wide(Logging::MaxStringBytes, L'é');
+	REQUIRE(Render("{}", Encode(wide), &text));
+	CHECK(text.size() == Logging::MaxStringBytes);
+}
+
+TEST_CASE(MissingAndExtraArguments)
+{
+	std::string text;
+	REQUIRE(Render("{} and {}", Encode(1), &text));
+	CHECK(text == "1 and {?}");
+
+	REQUIRE(Render("only {}", Encode(1, 2), &text));
+	CHECK(text == "only 1");
+
+	REQUIRE(Render("{ } {x}", {}, &text));
+	CHECK(text == "{ } {x}");
+}
+
+TEST_CASE(MalformedBlocksAreRejected)
+{
+	std::string text;
+	std::vector<uint8_t> args = Encode(7, "abc");
+
+	// Every cut inside an argument fails rather than over-reading; a cut
+	// between arguments is a missing argument
+	const size_t firstLength = Encode(7).size();
+	for (size_t length{ 1 }; length < args.size(); ++length) {
+		const std::vector<uint8_t> truncated(args.begin(), args.begin() + length);
+		CHECK(Render("{} {}", truncated, &text) == (length == firstLength));
+	}
+
+	args[0] = 0x7F;   // Unknown type
+	CHECK(!Render("{}", args, &text));
+}
@@ -0,0 +1,77 @@
+// Per-message handler profiler: compile-time slots, recording and dumps.
+
+#define TABTAP_PROFILE
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/MessageProfiler.h"
+
+// Standard library headers
+#include <string>
+#include <thread>
+
+namespace
+{
+	constexpr uint32_t WmTimer = 0x0113;
+	constexpr uint32_t WmMouseMove = 0x0200;
+
+	constexpr Profiling::Key Keys[] = {
+		{ WmMouseMove, 0, "WM_MOUSEMOVE" },
+		{ WmTimer, 1,     "WM_TIMER/ONE" },
+		{ WmTimer, 2,     "WM_TIMER/TWO" },
+	};
+	Profiling::MessageProfiler<std::size(Keys)> Table{ Keys };
+
+	// Slots resolve at compile time
+	static_assert(Profiling::IndexOf(Keys, WmMouseMove, 0) == 0, "first key");
+	static_assert(Profiling::IndexOf(Keys, WmTimer, 2) == 2, "command keys");
+	static_assert(Profiling::IndexOf(Keys, WmTimer, 3) == std::size(Keys), "unknown key");
+
+	void HandleTimer()
+	{
+		PROFILE_HANDLER(Table, Keys, WmTimer, 2);
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+	}
+}
+
+TEST_CASE(ScopesRecordIntoTheirSlot)
+{
+	Table.Reset();
+	HandleTimer();
+	HandleTimer();
+	{
+		PROFILE_HANDLER(Table, Keys, WmMouseMove, 0);
+	}
+
+	const Profiling::Stats timer = Table.GetStats(2);
+	CHECK(timer.count == 2);
+	CHECK(timer.totalNs >= 4000000);
+	CHECK(timer.maxNs >= 2000000);
+	CHECK(timer.maxNs <= timer.totalNs);
+	CHECK(Table.GetStats(0).count == 1);
+	CHECK(Table.GetStats(1).count == 0);
+}
+
+TEST_CASE(OutOfRangeSlotsAreIgnored)
+{
+	Table.Reset();
+	Table.Record(std::size(Keys), 100);
+	Table.Record(1000, 100);
+	CHECK(Table.GetStats(std::size(Keys)).count == 0);
+	for (size_t i{}; i < std::size(Keys); ++i) { CHECK(Table.GetStats(i).count == 0); }
+}
+
+TEST_CASE(FormatListsOnlyUsedHandlers)
+{
+	Table.Reset();
+	Table.Record(0, 1500);
+	Table.Record(0, 500);
+
+	const std::string text = Table.Format("Test");
+	CHECK(text.find("Test\n") == 0);
+	CHECK(text.find("WM_MOUSEMOVE") != std::string::npos);
+	CHECK(text.find("WM_TIMER") == std::string::npos);
+	CHECK(text.find("(other)") == std::string::npos);
+	// count 2, total 2.0 us, average 1.00 us, max 1.5 us
+	CHECK(text.find("2          2.0       1.00        1.5") != std::string::npos);
+}
@@ -0,0 +1,157 @@
+// Metrics registry: registration rules, concurrent recording into shards,
+// a second view of the same block, and the Prometheus text output.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/MetricsRegistry.h"
+
+// Standard library headers
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// One block per case: threads cache their shard per block
+	template <int Id>
+	Metrics::Registry& MakeRegistry()
+	{
+		alignas(Metrics::CacheLine) static unsigned char block[Metrics::RequiredBytes()]{};
+		static Metrics::Registry registry = Metrics::Registry::Create(block, sizeof(block));
+		return registry;
+	}
+}
+
+TEST_CASE(RegistrationRules)
+{
+	Metrics::Registry& registry = MakeRegistry<0>();
+	REQUIRE(registry.IsValid());
+
+	const Metrics::Counter counter = registry.AddCounter("tabtap_redraws_total", "Tab redraws");
+	CHECK(counter.IsValid());
+
+	// Same name and kind: the same metric; another kind or a bad name: inert
+	const Metrics::Counter again = registry.AddCounter("tabtap_redraws_total", "Other help");
+	CHECK(again.IsValid());
+	CHECK(!registry.AddGauge("tabtap_redraws_total", "").IsValid());
+	CHECK(!registry.AddCounter("1tabtap", "").IsValid());
+	CHECK(!registry.AddCounter("tabtap-redraws", "").IsValid());
+	CHECK(!registry.AddHistogram("tabtap_h", "", { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 }).IsValid());
+
+	counter.Add(2);
+	again.Add(3);
+	const Metrics::Snapshot snapshot = registry.TakeSnapshot();
+	CHECK(snapshot.metrics.size() == 1);
+	CHECK(snapshot.GetValue(snapshot.Find("tabtap_redraws_total")) == 5);
+	CHECK(snapshot.Find("tabtap_missing") == SIZE_MAX);
+
+	// Inert handles record nothing
+	Metrics::Counter{}.Add();
+	Metrics::Histogram{}.Observe(1);
+	CHECK(!Metrics::Registry::Create(nullptr, 0).IsValid());
+}
+
+TEST_CASE(BlockFillsUpGracefully)
+{
+	Metrics::Registry& registry = MakeRegistry<1>();
+	size_t added{};
+	for (int i{}; i < int(Metrics::MaxMetrics) + 8; ++i) {
+		const std::string name = "tabtap_metric_" + std::to_string(i);
+		added += registry.AddHistogram(name.c_str(), "", { 1, 2, 3 }).IsValid();
+	}
+
+	// Five cells per histogram: the cell table runs out first
+	CHECK(added == Metrics::MaxCells / 5);
+	CHECK(registry.TakeSnapshot().metrics.size() == added);
+}
+
+TEST_CASE(AttachedViewSharesTheBlock)
+{
+	alignas(Metrics::CacheLine) static unsigned char block[Metrics::RequiredBytes()]{};
+	CHECK(!Metrics::Registry::Attach(block, sizeof(block)).IsValid());   // Not formatted yet
+
+	static Metrics::Registry owner = Metrics::Registry::Create(block, sizeof(block));
+	static Metrics::Registry view = Metrics::Registry::Attach(block, sizeof(block));
+	REQUIRE(view.IsValid());
+	CHECK(!Metrics::Registry::Attach(block, sizeof(block) - 1).IsValid());
+
+	view.AddCounter("tabtap_hook_commands_total", "Hook commands").Add(4);
+	const Metrics::Snapshot snapshot = owner.TakeSnapshot();
+	CHECK(snapshot.GetValue(snapshot.Find("tabtap_hook_commands_total")) == 4);
+}
+
+TEST_CASE(ConcurrentWritersAndReader)
+{
+	Metrics::Registry& registry = MakeRegistry<2>();
+	const Metrics::Counter counter = registry.AddCounter("tabtap_events_total", "Events");
+	const Metrics::Histogram histogram = registry.AddHistogram("tabtap_delay_us", "Delay", { 10, 100, 1000 });
+	const Metrics::Gauge gauge = registry.AddGauge("tabtap_last_writer", "Last writer");
+
+	// More threads than shards, so some share the last one
+	constexpr int ThreadCount = 24;
+	constexpr int Iterations = 20000;
+	std::atomic<bool> isDone{};
+	std::atomic<bool> isMonotonic{ true };
+
+	std::thread reader([&]() {
+		uint64_t lastCount{}, lastObservations{};
+		while (!isDone.load()) {
+			const Metrics::Snapshot snapshot = registry.TakeSnapshot();
+			const uint64_t count = snapshot.GetValue(snapshot.Find("tabtap_events_total"));
+			const uint64_t observations = snapshot.GetValue(snapshot.Find("tabtap_delay_us"));
+			if (count < lastCount or observations < lastObservations) { isMonotonic = false; }
+			lastCount = count;
+			lastObservations = observations;
+		}
+	});
+
+	std::vector<std::thread> writers{};
+	for (int t{}; t < ThreadCount; ++t) {
+		writers.emplace_back([&, t]() {
+			for (int i{}; i < Iterations; ++i) {
+				counter.Add();
+				histogram.Observe(uint64_t(i % 2000));
+			}
+			gauge.Set(t);
+		});
+	}
+	for (std::thread& writer : writers) { writer.join(); }
+	isDone = true;
+	reader.join();
+	CHECK(isMonotonic.load());
+
+	const Metrics::Snapshot snapshot = registry.TakeSnapshot();
+	const size_t delay = snapshot.Find("tabtap_delay_us");
+	CHECK(snapshot.GetValue(snapshot.Find("tabtap_events_total")) == uint64_t(ThreadCount) * Iterations);
+	CHECK(snapshot.GetValue(delay) == uint64_t(ThreadCount) * Iterations);
+
+	// i % 2000 over 20000 iterations: 10 rounds of 0..1999
+	uint64_t sum{};
+	for (int i{}; i < Iterations; ++i) { sum += uint64_t(i % 2000); }
+	CHECK(snapshot.GetSum(delay) == sum * ThreadCount);
+	CHECK(snapshot.GetBucket(delay, 0) == uint64_t(ThreadCount) * 10 * 11);
+	CHECK(snapshot.GetBucket(delay, 1) == uint64_t(ThreadCount) * 10 * 90);
+	CHECK(snapshot.GetBucket(delay, 3) == uint64_t(ThreadCount) * 10 * 999);
+	CHECK(snapshot.GetValue(snapshot.Find("tabtap_last_writer")) < uint64_t(ThreadCount));
+}
+
+TEST_CASE(TextFormatIsCumulativeAndEscaped)
+{
+	Metrics::Registry& registry = MakeRegistry<3>();
+	registry.AddCounter("tabtap_taps_total", "Taps").Add(7);
+	registry.AddGauge("tabtap_offset", "Offset").Set(-3);
+	const Metrics::Histogram histogram = registry.AddHistogram("tabtap_draw_us", "Draw \\ time\nsecond line", { 10, 100 });
+	for (uint64_t value : { 5, 50, 60, 500 }) { histogram.Observe(value); }
+
+	const std::string text = Metrics::FormatText(registry.TakeSnapshot());
+	CHECK(text.find("# TYPE tabtap_taps_total counter\ntabtap_taps_total 7\n") != std::string::npos);
+	CHECK(text.find("tabtap_offset -3\n") != std::string::npos);
+	CHECK(text.find("# HELP tabtap_draw_us Draw \\\\ time\\nsecond line\n") != std::string::npos);
+	CHECK(text.find(
+		"tabtap_draw_us_bucket{le=\"10\"} 1\n"
+		"tabtap_draw_us_bucket{le=\"100\"} 3\n"
+		"tabtap_draw_us_bucket{le=\"+Inf\"} 4\n"
+		"tabtap_draw_us_sum 615\n"
+		"tabtap_draw_us_count 4\n") != std::string::npos);
+}
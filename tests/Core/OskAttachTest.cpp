@@ -0,0 +1,136 @@
+// Startup planner for the OSK: reconnect to a hooked OSK, adopt an unhooked
+// one by injection, and the fallbacks to a cold start.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/OskAttach.h"
+
+// Standard library headers
+#include <vector>
+
+using OskAttach::Mode;
+using OskAttach::Planner;
+using OskAttach::Probe;
+using OskAttach::Step;
+
+namespace
+{
+	const Probe Missing{};
+	const Probe Hooked{ true, true, true, OskAttach::MakeHookReply(OskAttach::HookVersion) };
+	const Probe Unhooked{ true, true, false, 0 };
+	const Probe Hung{ true, false, true, 0 };
+
+	// Runs the planner with one outcome per step; returns the steps visited
+	std::vector<Step> Play(Planner& planner, const Probe& probe, std::vector<bool> outcomes)
+	{
+		std::vector<Step> steps{ planner.Begin(probe, 0) };
+		uint32_t nowMs{};
+		for (bool isSucceeded : outcomes) {
+			nowMs += 10;
+			steps.push_back(planner.Advance(isSucceeded, nowMs));
+		}
+		return steps;
+	}
+}
+
+TEST_CASE(HookRepliesCarryTheVersion)
+{
+	CHECK(OskAttach::IsHookReply(OskAttach::MakeHookReply(OskAttach::HookVersion)));
+	CHECK(OskAttach::IsHookReply(OskAttach::MakeHookReply(7)));
+	CHECK(!OskAttach::IsHookReply(0));
+	CHECK(!OskAttach::IsHookReply(1));   // DefWindowProc-style answers
+}
+
+TEST_CASE(NoOskIsACleanColdStart)
+{
+	Planner planner{};
+	CHECK(Play(planner, Missing, { true, true }) == std::vector<Step>{ Step::Launch, Step::Hook, Step::Done });
+	CHECK(planner.GetMode() == Mode::ColdStarted);
+	CHECK(!planner.IsFallback());
+	CHECK(planner.FormatPath() == "launch 10 ms, hook 10 ms");
+}
+
+TEST_CASE(CurrentHookIsReconnected)
+{
+	Planner planner{};
+	CHECK(Play(planner, Hooked, { true }) == std::vector<Step>{ Step::Reconnect, Step::Done });
+	CHECK(planner.GetMode() == Mode::Reconnected);
+	CHECK(planner.GetTotalMs() == 10);
+}
+
+TEST_CASE(FailedReconnectAdoptsByInjection)
+{
+	// The hook answered but its windows could not be taken over
+	Planner planner{};
+	CHECK(Play(planner, Hooked, { false, true }) == std::vector<Step>{ Step::Reconnect, Step::Inject, Step::Done });
+	CHECK(planner.GetMode() == Mode::Injected);
+	CHECK(!planner.IsFallback());
+	CHECK(planner.FormatPath() == "reconnect 10 ms, inject 10 ms");
+}
+
+TEST_CASE(UnhookedOskIsAdopted)
+{
+	Planner planner{};
+	CHECK(Play(planner, Unhooked, { true }) == std::vector<Step>{ Step::Inject, Step::Done });
+	CHECK(planner.GetMode() == Mode::Injected);
+
+	// DLL loaded without a subclassed window: inject adopts the windows too
+	CHECK(planner.Begin({ true, true, true, 0 }, 0) == Step::Inject);
+}
+
+TEST_CASE(FailedAdoptionFallsBackToAColdStart)
+{
+	Planner planner{};
+	CHECK(Play(planner, Hooked, { false, false, true, true, true }) == std::vector<Step>{
+		Step::Reconnect, Step::Inject, Step::Close, Step::Launch, Step::Hook, Step::Done });
+	CHECK(planner.GetMode() == Mode::ColdStarted);
+	CHECK(planner.IsFallback());
+
+	CHECK(Play(planner, Unhooked, { false, false }) == std::vector<Step>{ Step::Inject, Step::Close, Step::Failed });
+	CHECK(planner.GetMode() == Mode::None);
+}
+
+TEST_CASE(HungOrOutdatedOskIsRestarted)
+{
+	Planner planner{};
+	CHECK(Play(planner, Hung, { true, true, true }) == std::vector<Step>{ Step::Close, Step::Launch, Step::Hook, Step::Done });
+	CHECK(!planner.IsFallback());
+
+	const Probe outdated{ true, true, true, OskAttach::MakeHookReply(OskAttach::HookVersion + 1) };
+	CHECK(planner.Begin(outdated, 0) == Step::Close);
+
+	// A finished plan ignores further reports
+	CHECK(Play(planner, Hung, { false, true }) == std::vector<Step>{ Step::Close, Step::Failed, Step::Failed });
+}
+
+TEST_CASE(EveryOutcomeSequenceFinishes)
+{
+	const Probe probes[] = { Missing, Hooked, Unhooked, Hung };
+	for (const Probe& probe : probes) {
+		for (uint32_t outcomes{}; outcomes < (1u << Planner::MaxSteps); ++outcomes) {
+			Planner planner{};
+			Step step = planner.Begin(probe, 0);
+			bool isOskRunning = probe.isWindowFound;
+			size_t steps{};
+			while (!planner.IsFinished()) {
+				REQUIRE(steps < Planner::MaxSteps);
+				// osk.exe is single-instance: never launch beside a running one
+				REQUIRE(!(step == Step::Launch and isOskRunning));
+
+				const bool isSucceeded = (outcomes >> steps) & 1u;
+				if (step == Step::Close and isSucceeded) { isOskRunning = false; }
+				step = planner.Advance(isSucceeded, uint32_t(++steps));
+			}
+			CHECK((planner.GetMode() == Mode::None) == (step == Step::Failed));
+		}
+	}
+}
+
+TEST_CASE(TotalTimeSurvivesTheTickWrap)
+{
+	Planner planner{};
+	CHECK(planner.Begin(Missing, 0xfffffff0u) == Step::Launch);
+	planner.Advance(true, 0x10);
+	planner.Advance(true, 0x20);
+	CHECK(planner.GetTotalMs() == 0x30);
+}
@@ -0,0 +1,169 @@
+// OSK placement around the caret and the caret frame throttle.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/OskPlacement.h"
+
+using Geometry::Rect;
+using OskPlacement::Input;
+using OskPlacement::Placement;
+
+namespace
+{
+	const Rect WorkArea{ 0, 0, 1920, 1040 };
+
+	// OSK right of centre, tab on the right edge
+	Input MakeInput()
+	{
+		Input input{};
+		input.workArea = WorkArea;
+		input.tab = { 1892, 400, 1920, 495 };
+		input.osk = { 900, 300, 1892, 700 };
+		return input;
+	}
+
+	Rect Avoid(const Input& input)
+	{
+		return { input.caret.left - input.margin, input.caret.top - input.margin,
+			input.caret.right + input.margin, input.caret.bottom + input.margin };
+	}
+
+	bool IsInside(const Rect& rect, const Rect& bounds)
+	{
+		return rect.left >= bounds.left and rect.top >= bounds.top and
+			rect.right <= bounds.right and rect.bottom <= bounds.bottom;
+	}
+}
+
+TEST_CASE(HomeWhenTheCaretIsClearOrUnknown)
+{
+	Input input = MakeInput();
+	CHECK(OskPlacement::HomeTop(input) == 400 + (95 - 400) / 2);
+
+	Placement placement = OskPlacement::Solve(input);
+	CHECK(placement.isHome and placement.isMoved);
+	CHECK(placement.osk == Geometry::Point{ 900, OskPlacement::HomeTop(input) });
+
+	input.caret = { 100, 450, 102, 470 };
+	placement = OskPlacement::Solve(input);
+	CHECK(placement.isHome and placement.overlap == 0);
+
+	// Home is clamped into the work area
+	input.tab = { 1892, 0, 1920, 95 };
+	CHECK(OskPlacement::HomeTop(input) == 0);
+	input.tab = { 1892, 945, 1920, 1040 };
+	CHECK(OskPlacement::HomeTop(input) == 640);
+}
+
+TEST_CASE(CoveredCaretMovesTheOskOutOfTheWay)
+{
+	Input input = MakeInput();
+	input.osk = Geometry::MakeRect({ 900, OskPlacement::HomeTop(input) }, { 992, 400 });
+	input.caret = { 1000, 450, 1002, 470 };
+
+	const Placement placement = OskPlacement::Solve(input);
+	CHECK(!placement.isHome and placement.isMoved);
+	CHECK(placement.overlap == 0);
+
+	// Above or below in the same column
+	CHECK(placement.osk.x == 900);
+	const Rect placed = Geometry::MakeRect(placement.osk, input.osk.GetSize());
+	CHECK(placed.bottom <= Avoid(input).top or placed.top >= Avoid(input).bottom);
+}
+
+TEST_CASE(CaretMovingAlongALineMovesNothing)
+{
+	Input input = MakeInput();
+	input.caret = { 1000, 450, 1002, 470 };
+	const Placement first = OskPlacement::Solve(input);
+	REQUIRE(first.overlap == 0);
+
+	input.osk = Geometry::MakeRect(first.osk, input.osk.GetSize());
+	for (long x{ 1000 }; x < 1800; x += 7) {
+		input.caret = { x, 450, x + 2, 470 };
+		const Placement placement = OskPlacement::Solve(input);
+		REQUIRE(!placement.isMoved);
+		REQUIRE(placement.overlap == 0);
+	}
+}
+
+TEST_CASE(SidewaysOnlyWhenTheColumnIsBlocked)
+{
+	// A caret as tall as the work area leaves no room above or below
+	Input input = MakeInput();
+	input.caret = { 1100, 0, 1102, 1040 };
+	input.tab = { 1892, 300, 1920, 395 };
+	input.osk = Geometry::MakeRect({ 1000, OskPlacement::HomeTop(input) }, { 400, 400 });
+
+	const Placement placement = OskPlacement::Solve(input);
+	CHECK(placement.overlap == 0);
+	CHECK(placement.osk.x != 1000);
+	CHECK(placement.osk.y == OskPlacement::HomeTop(input));
+}
+
+TEST_CASE(RandomLayoutsAreNeverWorseThanHome)
+{
+	Test::Random random{ 49 };
+	size_t clear{};
+	for (int i{}; i < 200000; ++i) {
+		Input input{};
+		input.workArea = WorkArea;
+		const long height = long(random.Range(200, 699));
+		const long width = long(random.Range(400, 1399));
+		const long oskTop = long(random.Range(0, 1040 - height - 1));
+		const long oskLeft = long(random.Range(0, 1920 - width - 1));
+		input.osk = { oskLeft, oskTop, oskLeft + width, oskTop + height };
+		const long tabTop = long(random.Range(0, 1040 - 95 - 1));
+		input.tab = { 1892, tabTop, 1920, tabTop + 95 };
+		const long caretLeft = long(random.Range(0, 1899));
+		const long caretTop = long(random.Range(0, 999));
+		input.caret = { caretLeft, caretTop, caretLeft + 2, caretTop + long(random.Range(20, 39)) };
+
+		const Placement placement = OskPlacement::Solve(input);
+		const Rect placed = Geometry::MakeRect(placement.osk, input.osk.GetSize());
+		REQUIRE(IsInside(placed, WorkArea));
+
+		const Rect avoid = Avoid(input);
+		const long overlap = OskPlacement::Detail::OverlapArea(placed, avoid);
+		REQUIRE(overlap == placement.overlap);
+
+		const Rect home = Geometry::MakeRect({ input.osk.left, OskPlacement::HomeTop(input) }, input.osk.GetSize());
+		const long homeOverlap = OskPlacement::Detail::OverlapArea(home, avoid);
+		const long currentOverlap = OskPlacement::Detail::OverlapArea(input.osk, avoid);
+		REQUIRE(overlap <= homeOverlap);
+		REQUIRE(overlap <= currentOverlap);
+
+		// A clear current position is kept unless home is clear too
+		if (!currentOverlap and homeOverlap) { REQUIRE(!placement.isMoved); }
+
+		// Solving again from the result changes nothing for the better
+		Input again = input;
+		again.osk = placed;
+		const Placement next = OskPlacement::Solve(again);
+		REQUIRE(next.overlap <= placement.overlap);
+		if (!placement.overlap) { REQUIRE(!next.isMoved or next.isHome); }
+
+		clear += !placement.overlap;
+	}
+	CHECK(clear > 190000);
+}
+
+TEST_CASE(ThrottleLetsOneUpdateThroughPerFrame)
+{
+	OskPlacement::FrameThrottle throttle{ 16 };
+	CHECK(throttle.GetFrameMs() == 16);
+	CHECK(!throttle.Take(0));
+
+	CHECK(throttle.Post());
+	CHECK(!throttle.Post());
+	CHECK(throttle.IsPending());
+	CHECK(throttle.GetDelay(100) == 0);
+	CHECK(throttle.Take(100));
+	CHECK(!throttle.IsPending());
+
+	CHECK(throttle.Post());
+	CHECK(throttle.GetDelay(105) == 11);
+	CHECK(!throttle.Take(105));
+	CHECK(throttle.Take(116));
+	CHECK(!throttle.Take(200));
+}
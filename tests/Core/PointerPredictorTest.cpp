@@ -0,0 +1,120 @@
+// Pointer prediction: velocity fit, damping, reversal, staleness, the
+// offset cap and wrapping timestamps.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/PointerPredictor.h"
+
+// Standard library headers
+#include <cstdlib>
+
+namespace
+{
+	// Feeds a straight line at `vx`, `vy` pixels per ms, one sample every `stepMs`
+	void FeedLine(PointerPredictor& predictor, uint32_t startMs, int samples, uint32_t stepMs, double vx, double vy)
+	{
+		for (int i{}; i < samples; ++i) {
+			const uint32_t t = startMs + uint32_t(i) * stepMs;
+			predictor.AddSample({ std::lround(vx * i * stepMs), std::lround(vy * i * stepMs), t });
+		}
+	}
+}
+
+TEST_CASE(ConstantVelocityLeadsByTheHorizon)
+{
+	PointerPredictor predictor{};
+	FeedLine(predictor, 1000, 6, 8, 2.0, -1.0);
+
+	// Latest sample at 1040; 16 ms horizon at 2 px/ms and -1 px/ms
+	const PointerPredictor::Offset offset = predictor.Predict(1040);
+	CHECK(offset.dx == 32);
+	CHECK(offset.dy == -16);
+
+	// Older input leads further, until it is stale
+	CHECK(predictor.Predict(1044).dx == 40);
+	CHECK(predictor.Predict(1040 + 41).dx == 0);
+}
+
+TEST_CASE(NeedsEnoughFreshSamples)
+{
+	PointerPredictor predictor{};
+	CHECK(predictor.Predict(0).dx == 0);
+	FeedLine(predictor, 0, 2, 8, 3.0, 0.0);
+	CHECK(predictor.Predict(8).dx == 0);
+
+	// Samples older than the window do not count
+	predictor.Reset();
+	predictor.AddSample({ 0, 0, 0 });
+	predictor.AddSample({ 100, 0, 100 });
+	predictor.AddSample({ 200, 0, 200 });
+	CHECK(predictor.Predict(200).dx == 0);
+}
+
+TEST_CASE(DuplicateAndOutOfOrderTimesAreIgnored)
+{
+	PointerPredictor predictor{};
+	predictor.AddSample({ 0, 0, 10 });
+	predictor.AddSample({ 50, 0, 10 });
+	predictor.AddSample({ 50, 0, 5 });
+	CHECK(predictor.GetLastTime() == 10);
+	predictor.AddSample({ 8, 0, 14 });
+	predictor.AddSample({ 16, 0, 18 });
+	CHECK(predictor.Predict(18).dx == 32);
+}
+
+TEST_CASE(ReversalStopsTheLead)
+{
+	PointerPredictor predictor{};
+	const long xs[]{ 0, 20, 40, 60, 50, 30 };
+	for (int i{}; i < 6; ++i) { predictor.AddSample({ xs[i], 0, uint32_t(i) * 8 }); }
+	CHECK(predictor.Predict(40).dx == 0);
+}
+
+TEST_CASE(DecelerationIsDamped)
+{
+	PointerPredictor steady{};
+	FeedLine(steady, 0, 6, 8, 2.0, 0.0);
+
+	PointerPredictor slowing{};
+	const long xs[]{ 0, 24, 44, 60, 70, 76 };
+	for (int i{}; i < 6; ++i) { slowing.AddSample({ xs[i], 0, uint32_t(i) * 8 }); }
+
+	const long slowLead = slowing.Predict(40).dx;
+	CHECK(slowLead > 0);
+	CHECK(slowLead < steady.Predict(40).dx);
+}
+
+TEST_CASE(OffsetIsCapped)
+{
+	PointerPredictor predictor{};
+	FeedLine(predictor, 0, 6, 8, 30.0, 40.0);
+	const PointerPredictor::Offset offset = predictor.Predict(40);
+	CHECK(std::hypot(double(offset.dx), double(offset.dy)) <= predictor.GetConfig().maxOffset + 1.0);
+	CHECK(offset.dx == 29);
+	CHECK(offset.dy == 38);
+}
+
+TEST_CASE(TimestampsWrap)
+{
+	PointerPredictor predictor{};
+	FeedLine(predictor, 0xFFFFFFF0u, 6, 8, 2.0, 0.0);
+	CHECK(predictor.GetLastTime() == 0xFFFFFFF0u + 40);
+	CHECK(predictor.Predict(0xFFFFFFF0u + 40).dx == 32);
+}
+
+TEST_CASE(PerPointTimesBeatCoarseTicks)
+{
+	// A 1 px/ms drag sampled every 4 ms, stamped once with the input times and
+	// once with a 15.6 ms tick as GetTickCount would give
+	PointerPredictor exact{};
+	PointerPredictor coarse{};
+	for (int i{}; i < 12; ++i) {
+		const uint32_t t = 1000 + uint32_t(i) * 4;
+		exact.AddSample({ long(i) * 4, 0, t });
+		coarse.AddSample({ long(i) * 4, 0, uint32_t(uint32_t(t / 15.625) * 15.625) });
+	}
+
+	CHECK(exact.Predict(1044).dx == 16);
+	// Coarse stamps drop most samples as duplicates and misjudge the lead
+	CHECK(std::abs(coarse.Predict(1044).dx - 16) > 4);
+}
@@ -0,0 +1,109 @@
+// Power and QoS policy decisions and the hourly usage meter.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/PowerPolicy.h"
+
+TEST_CASE(IdleOnAcPower)
+{
+	const Power::Decision decision = Power::PowerPolicy{}.Evaluate();
+	CHECK(decision.isVisible);
+	CHECK(!decision.isHidden);
+	CHECK(decision.allowPeriodic);
+	CHECK(decision.keepOnTopMs == 5000);
+	CHECK(decision.qos == Power::Qos::Eco);
+}
+
+TEST_CASE(UnseenStopsPeriodicWork)
+{
+	auto check = [](void (*apply)(Power::PowerPolicy&)) {
+		Power::PowerPolicy policy{};
+		policy.BeginActivity(Power::Activity::Drag);
+		apply(policy);
+		const Power::Decision decision = policy.Evaluate();
+		return !decision.isVisible and !decision.allowPeriodic and
+			decision.keepOnTopMs == 0 and decision.qos == Power::Qos::Eco;
+	};
+
+	CHECK(check([](Power::PowerPolicy& policy) { policy.SetDisplayOn(false); }));
+	CHECK(check([](Power::PowerPolicy& policy) { policy.SetSessionLocked(true); }));
+	CHECK(check([](Power::PowerPolicy& policy) { policy.SetWindowShown(false); }));
+	CHECK(check([](Power::PowerPolicy& policy) { policy.SetFullscreen(true); }));
+}
+
+TEST_CASE(FullscreenHidesTheWindow)
+{
+	Power::PowerPolicy policy{};
+	policy.SetFullscreen(true);
+	CHECK(policy.Evaluate().isHidden);
+
+	// Only a fullscreen app hides it; a locked session just stops the timers
+	policy.SetFullscreen(false);
+	policy.SetSessionLocked(true);
+	CHECK(!policy.Evaluate().isHidden);
+}
+
+TEST_CASE(BatteryStretchesTheTopmostRefresh)
+{
+	Power::PowerPolicy policy{};
+	policy.SetOnBattery(true);
+	CHECK(policy.Evaluate().keepOnTopMs == 15000);
+
+	policy.SetOnBattery(false);
+	policy.SetBatterySaver(true);
+	CHECK(policy.Evaluate().keepOnTopMs == 15000);
+}
+
+TEST_CASE(ActivitiesRaiseQosUntilTheyEnd)
+{
+	Power::PowerPolicy policy{};
+	policy.BeginActivity(Power::Activity::Drag);
+	policy.BeginActivity(Power::Activity::Animation);
+	CHECK(policy.IsActive());
+	CHECK(policy.Evaluate().qos == Power::Qos::High);
+
+	// Battery saver caps the boost
+	policy.SetBatterySaver(true);
+	CHECK(policy.Evaluate().qos == Power::Qos::Normal);
+
+	policy.EndActivity(Power::Activity::Drag);
+	CHECK(policy.Evaluate().qos == Power::Qos::Normal);
+	policy.EndActivity(Power::Activity::Animation);
+	CHECK(!policy.IsActive());
+	CHECK(policy.Evaluate().qos == Power::Qos::Eco);
+}
+
+TEST_CASE(TakeChangeReportsOnlyChanges)
+{
+	Power::PowerPolicy policy{};
+	Power::Decision decision{};
+	CHECK(policy.TakeChange(&decision));
+	CHECK(!policy.TakeChange(&decision));
+
+	// Inputs that do not change the decision are not reported
+	policy.SetDisplayOn(false);
+	CHECK(policy.TakeChange(&decision));
+	CHECK(!decision.allowPeriodic);
+	policy.SetOnBattery(true);
+	CHECK(!policy.TakeChange(&decision));
+
+	policy.SetDisplayOn(true);
+	CHECK(policy.TakeChange(&decision));
+	CHECK(decision.keepOnTopMs == 15000);
+	CHECK(policy.GetApplied() == decision);
+}
+
+TEST_CASE(UsageIsNormalisedToOneHour)
+{
+	Power::UsageMeter meter{};
+	meter.Reset(1000, 50);
+	for (int i{}; i < 30; ++i) { meter.RecordWakeup(); }
+
+	const Power::UsageMeter::Report report = meter.GetReport(1000 + 1800000, 50 + 120);
+	CHECK(report.elapsedMs == 1800000);
+	CHECK(report.wakeups == 30);
+	CHECK(report.wakeupsPerHour == 60.0);
+	CHECK(report.cpuMsPerHour == 240.0);
+
+	CHECK(meter.GetReport(1000, 50).wakeupsPerHour == 0.0);
+}
@@ -0,0 +1,207 @@
+// Software compositor and the headless backend.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/RenderBackend.h"
+
+// Standard library headers
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using Render::Pixel;
+
+namespace
+{
+	// Image whose pixel value encodes its column and row
+	struct Strip
+	{
+		long width{}, height{};
+		std::vector<Pixel> pixels{};
+
+		Strip(long w, long h) : width{ w }, height{ h }, pixels(size_t(w * h))
+		{
+			for (long y{}; y < h; ++y) {
+				for (long x{}; x < w; ++x) { pixels[size_t(y * w + x)] = 0xff000000u | Pixel(y << 8) | Pixel(x); }
+			}
+		}
+
+		Render::ImageView View() const { return { pixels.data(), width, height, width }; }
+	};
+
+	Pixel At(const Render::ImageView& image, long x, long y) { return image.Row(y)[x]; }
+
+	uint8_t Channel(Pixel pixel, int shift) { return uint8_t(pixel >> shift); }
+}
+
+TEST_CASE(BackendNamesRoundTrip)
+{
+	for (Render::BackendKind kind : { Render::BackendKind::GdiPlus, Render::BackendKind::Dib, Render::BackendKind::Headless }) {
+		Render::BackendKind parsed{};
+		CHECK(Render::ParseBackendName(Render::GetBackendName(kind), &parsed));
+		CHECK(parsed == kind);
+	}
+
+	Render::BackendKind kind = Render::BackendKind::Dib;
+	CHECK(!Render::ParseBackendName("direct2d", &kind));
+	CHECK(kind == Render::BackendKind::Dib);
+}
+
+TEST_CASE(TabLayerPicksTheStripForItsState)
+{
+	const Strip strip{ 28, 4 };
+	Render::HeadlessBackend backend{};
+	REQUIRE(backend.CreateSurface({ 7, 4 }));
+
+	// Collapsed shows the rightmost columns
+	REQUIRE(backend.Compose(Render::MakeTabLayer(strip.View(), { 7, 4 }, false, false, nullptr)));
+	CHECK(At(backend.GetPixels(), 0, 0) == 0xff000000u + 21);
+	CHECK(At(backend.GetPixels(), 6, 3) == 0xff000300u + 27);
+
+	// Mirrored for the right edge
+	REQUIRE(backend.Compose(Render::MakeTabLayer(strip.View(), { 7, 4 }, false, true, nullptr)));
+	CHECK(At(backend.GetPixels(), 0, 0) == 0xff000000u + 27);
+	CHECK(At(backend.GetPixels(), 6, 0) == 0xff000000u + 21);
+
+	REQUIRE(backend.CreateSurface({ 28, 4 }));
+	REQUIRE(backend.Compose(Render::MakeTabLayer(strip.View(), { 28, 4 }, true, false, nullptr)));
+	CHECK(At(backend.GetPixels(), 0, 2) == 0xff000200u);
+}
+
+TEST_CASE(ColourMatrixMatchesTheFloatReference)
+{
+	// Half opacity and a red tint, as the blink effect uses
+	Render::ColorMatrix matrix = Render::IdentityMatrix;
+	matrix.m[3][3] = 0.5f;
+	matrix.m[4][0] = 0.25f;
+	CHECK(!Render::IsIdentity(matrix));
+	CHECK(Render::IsIdentity(Render::IdentityMatrix));
+
+	Test::Random random{ 38 };
+	int maxError{};
+	for (int i{}; i < 10000; ++i) {
+		const uint32_t a = uint32_t(random.Range(0, 255));
+		auto premultiplied = [&]() { return uint32_t(random.Range(0, 255)) * a / 255; };
+		const Pixel pixel = (a << 24) | (premultiplied() << 16) | (premultiplied() << 8) | premultiplied();
+
+		const Pixel out = Render::Detail::TransformPixel(pixel, matrix);
+
+		const double alpha = a / 255.0;
+		const double outAlpha = std::round(alpha * 0.5 * 255.0) / 255.0;
+		for (int shift : { 16, 8, 0 }) {
+			const double straight = a ? std::min(1.0, Channel(pixel, shift) / 255.0 / alpha) : 0.0;
+			const double value = std::min(1.0, straight + (shift == 16 ? 0.25 : 0.0));
+			const int expected = int(std::round(value * outAlpha * 255.0));
+			maxError = std::max(maxError, std::abs(expected - int(Channel(out, shift))));
+		}
+		CHECK(Channel(out, 24) == uint8_t(std::lround(alpha * 0.5 * 255.0)));
+		CHECK(Channel(out, 16) <= Channel(out, 24));   // Still a valid premultiplied pixel
+	}
+	CHECK(maxError <= 1);
+}
+
+TEST_CASE(RectangleFrameAndFill)
+{
+	Render::HeadlessBackend backend{};
+	REQUIRE(backend.CreateSurface({ 10, 8 }));
+
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	layer.frameColor = Render::MakeOpaque(255, 0, 0);
+	layer.fillColor = 0x80000080u;
+	layer.frameThickness = 2;
+	REQUIRE(backend.Compose(layer));
+
+	const Render::ImageView pixels = backend.GetPixels();
+	CHECK(At(pixels, 0, 0) == layer.frameColor);
+	CHECK(At(pixels, 1, 4) == layer.frameColor);
+	CHECK(At(pixels, 9, 7) == layer.frameColor);
+	CHECK(At(pixels, 2, 2) == layer.fillColor);
+	CHECK(At(pixels, 7, 5) == layer.fillColor);
+
+	// A hollow frame leaves the inside transparent, even after a filled one
+	layer.isHollow = true;
+	REQUIRE(backend.Compose(layer));
+	CHECK(At(backend.GetPixels(), 4, 4) == 0);
+	CHECK(At(backend.GetPixels(), 0, 4) == layer.frameColor);
+}
+
+TEST_CASE(ScalePixelRoundsLikeDivision)
+{
+	Test::Random random{ 380 };
+	for (int i{}; i < 100000; ++i) {
+		const Pixel pixel = Pixel(random.Next());
+		const uint32_t factor = uint32_t(random.Range(0, 255));
+		const Pixel scaled = Render::Detail::ScalePixel(pixel, factor);
+		for (int shift : { 24, 16, 8, 0 }) {
+			const int expected = int(std::lround(Channel(pixel, shift) * factor / 255.0));
+			REQUIRE(std::abs(expected - int(Channel(scaled, shift))) <= 1);
+		}
+	}
+	CHECK(Render::Detail::ScalePixel(0xffffffffu, 255) == 0xffffffffu);
+	CHECK(Render::Detail::ScalePixel(0xffffffffu, 0) == 0);
+}
+
+TEST_CASE(MaskBlendsSourceOverAndClips)
+{
+	Render::HeadlessBackend backend{};
+	REQUIRE(backend.CreateSurface({ 4, 4 }));
+
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	layer.frameColor = Render::MakeOpaque(0, 0, 255);
+	layer.frameThickness = 4;
+	REQUIRE(backend.Compose(layer));
+
+	// 3x3 mask placed half off the top-left corner
+	const uint8_t coverage[] = {
+		0xff, 0xff, 0xff,
+		0xff, 0x80, 0x00,
+		0xff, 0x00, 0xff,
+	};
+	const Render::MaskView mask{ coverage, 3, 3, 3 };
+	REQUIRE(backend.BlendMask(mask, { -1, -1 }, Render::MakeOpaque(255, 255, 255)));
+
+	const Render::ImageView pixels = backend.GetPixels();
+	CHECK(At(pixels, 1, 0) == layer.frameColor);            // Zero coverage
+	CHECK(At(pixels, 1, 1) == Render::MakeOpaque(255, 255, 255));
+	CHECK(At(pixels, 3, 3) == layer.frameColor);            // Outside the mask
+
+	// Half coverage mixes the colours
+	const Pixel half = At(pixels, 0, 0);
+	CHECK(Channel(half, 24) == 0xff);
+	CHECK(Channel(half, 16) >= 0x7f and Channel(half, 16) <= 0x81);
+	CHECK(Channel(half, 0) == 0xff);
+
+	// Completely outside: nothing happens
+	REQUIRE(backend.BlendMask(mask, { 10, 10 }, Render::MakeOpaque(0, 255, 0)));
+	REQUIRE(backend.BlendMask(mask, { -5, 0 }, Render::MakeOpaque(0, 255, 0)));
+	CHECK(At(backend.GetPixels(), 3, 3) == layer.frameColor);
+}
+
+TEST_CASE(HeadlessBackendLifecycle)
+{
+	Render::HeadlessBackend backend{};
+	CHECK(backend.GetKind() == Render::BackendKind::Headless);
+
+	// Nothing to draw into before a surface exists
+	Render::Layer layer{};
+	layer.kind = Render::LayerKind::Rectangle;
+	CHECK(!backend.Compose(layer));
+	CHECK(!backend.Present({}, 0xff));
+	CHECK(!backend.CreateSurface({ 0, 10 }));
+
+	REQUIRE(backend.CreateSurface({ 5, 5 }));
+	REQUIRE(backend.Compose(layer));
+	const uint32_t hash = Render::HashPixels(backend.GetPixels());
+	CHECK(backend.Present({ 10, 20 }, 0x40));
+	CHECK(backend.Present({ 11, 21 }, 0x80));
+	CHECK(backend.GetPosition() == Geometry::Point{ 11, 21 });
+	CHECK(backend.GetOpacity() == 0x80);
+	CHECK(backend.GetPresentCount() == 2);
+
+	layer.frameColor = Render::MakeOpaque(1, 2, 3);
+	layer.frameThickness = 1;
+	REQUIRE(backend.Compose(layer));
+	CHECK(Render::HashPixels(backend.GetPixels()) != hash);
+}
@@ -0,0 +1,251 @@
+// Session recorder: what Replay::Writer puts in a file reads back unchanged.
+// The last cases leave ReplayFormatTest.replay behind for the ReplayTool test
+// and DragTrace.replay for the ReplayPrediction test.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/ReplayFormat.h"
+#include "Core/TabLayout.h"
+
+// Standard library headers
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+	struct ReadBack
+	{
+		Replay::FileHeader header{};
+		std::vector<Replay::EventRecord> events{};
+		std::vector<Replay::EnvironmentRecord> environments{};
+		std::vector<Replay::RecordType> order{};
+	};
+
+	bool Read(const std::filesystem::path& path, ReadBack* pFile)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		const std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+		if (data.size() < sizeof(pFile->header)) { return false; }
+		std::memcpy(&pFile->header, data.data(), sizeof(pFile->header));
+
+		size_t offset = sizeof(pFile->header);
+		while (offset < data.size()) {
+			Replay::RecordHeader record{};
+			if (offset + sizeof(record) > data.size()) { return false; }
+			std::memcpy(&record, data.data() + offset, sizeof(record));
+			const uint8_t* pPayload = data.data() + offset + sizeof(record);
+			offset += sizeof(record) + record.size;
+			if (offset > data.size()) { return false; }
+
+			pFile->order.push_back(Replay::RecordType(record.type));
+			if (Replay::RecordType(record.type) == Replay::RecordType::Event) {
+				if (record.size != sizeof(Replay::EventRecord)) { return false; }
+				pFile->events.emplace_back();
+				std::memcpy(&pFile->events.back(), pPayload, record.size);
+			}
+			else if (Replay::RecordType(record.type) == Replay::RecordType::Environment) {
+				if (record.size != sizeof(Replay::EnvironmentRecord)) { return false; }
+				pFile->environments.emplace_back();
+				std::memcpy(&pFile->environments.back(), pPayload, record.size);
+			}
+		}
+		return true;
+	}
+
+	// Appends one record laid out as Replay::Writer does, with a given time
+	template <typename RecordTy>
+	void WriteRecord(std::ofstream& file, Replay::RecordType type, const RecordTy& payload)
+	{
+		const Replay::RecordHeader record{ uint16_t(type), uint16_t(sizeof(payload)) };
+		file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+		file.write(reinterpret_cast<const char*>(&payload), sizeof(payload));
+	}
+
+	// Minimum-jerk profile, the bell-shaped speed of a hand reaching for a point
+	double MinimumJerk(double t)
+	{
+		return t * t * t * (10.0 + t * (-15.0 + t * 6.0));
+	}
+
+	const std::filesystem::path TempPath = std::filesystem::temp_directory_path() / "TabTapReplayFormatTest.replay";
+}
+
+TEST_CASE(HeaderRoundTrips)
+{
+	Replay::Writer writer{};
+	REQUIRE(writer.Open(TempPath, { 0, 400, 7, 495 }, uint8_t(TabLayout::Edge::Right), true, false, true));
+	writer.Close();
+
+	ReadBack file{};
+	REQUIRE(Read(TempPath, &file));
+	CHECK(file.header.magic == Replay::FileMagic);
+	CHECK(file.header.version == Replay::FileVersion);
+	CHECK(Replay::FromRect32(file.header.tabRect) == Geometry::Rect{ 0, 400, 7, 495 });
+	CHECK(file.header.edge == uint8_t(TabLayout::Edge::Right));
+	CHECK(file.header.isExpanded == 1);
+	CHECK(file.header.isLinkedDrag == 0);
+	CHECK(file.header.hasSkin == 1);
+	CHECK(file.order.empty());
+}
+
+TEST_CASE(EnvironmentIsWrittenOnlyWhenItChanges)
+{
+	Replay::Writer writer{};
+	REQUIRE(writer.Open(TempPath, {}, 0, false, false, false));
+
+	Replay::Environment environment{ { 0, 0, 1920, 1040 }, { 100, 600, 900, 900 }, { 1920, 1080 }, true };
+	writer.WriteEnvironment(environment);
+	writer.WriteEvent(Replay::Message::LButtonDown, { 3, 420 });
+	writer.WriteEnvironment(environment);
+	writer.WriteEvent(Replay::Message::LButtonUp, { 3, 420 });
+	environment.workArea.right = 1880;
+	writer.WriteEnvironment(environment);
+	writer.WriteEvent(Replay::Message::SettingChange, { 0, 0 }, uint8_t(Replay::SettingKind::WorkArea));
+	writer.Close();
+
+	ReadBack file{};
+	REQUIRE(Read(TempPath, &file));
+	CHECK(file.order == std::vector<Replay::RecordType>{
+		Replay::RecordType::Environment, Replay::RecordType::Event, Replay::RecordType::Event,
+		Replay::RecordType::Environment, Replay::RecordType::Event });
+
+	REQUIRE(file.environments.size() == 2);
+	CHECK(Replay::FromRect32(file.environments[0].workArea) == Geometry::Rect{ 0, 0, 1920, 1040 });
+	CHECK(Replay::FromRect32(file.environments[0].oskRect) == Geometry::Rect{ 100, 600, 900, 900 });
+	CHECK(file.environments[0].screenWidth == 1920 and file.environments[0].screenHeight == 1080);
+	CHECK(file.environments[0].isOskVisible == 1);
+	CHECK(file.environments[1].workArea.right == 1880);
+
+	REQUIRE(file.events.size() == 3);
+	CHECK(file.events[0].message == uint16_t(Replay::Message::LButtonDown));
+	CHECK(file.events[0].x == 3 and file.events[0].y == 420);
+	CHECK(file.events[2].detail == uint8_t(Replay::SettingKind::WorkArea));
+	CHECK(file.events[0].time <= file.events[1].time and file.events[1].time <= file.events[2].time);
+}
+
+TEST_CASE(EventsCarryTheNestingDepth)
+{
+	Replay::Writer writer{};
+	REQUIRE(writer.Open(TempPath, {}, 0, false, false, false));
+	{
+		Replay::NestingGuard outer{};
+		writer.WriteEvent(Replay::Message::MouseMove, {});
+		{
+			Replay::NestingGuard inner{};
+			writer.WriteEvent(Replay::Message::MouseLeave, {});
+		}
+	}
+	writer.WriteEvent(Replay::Message::MouseMove, {});   // Outside any procedure
+	writer.Close();
+	CHECK(Replay::Depth() == 0);
+
+	ReadBack file{};
+	REQUIRE(Read(TempPath, &file));
+	REQUIRE(file.events.size() == 3);
+	CHECK(file.events[0].depth == 0);
+	CHECK(file.events[1].depth == 1);
+	CHECK(file.events[2].depth == 0);
+	std::filesystem::remove(TempPath);
+}
+
+TEST_CASE(WritesASessionForTheReplayTool)
+{
+	// A drag along the left edge, a click, a linked drag and a work area change
+	Replay::Writer writer{};
+	REQUIRE(writer.Open("ReplayFormatTest.replay", { 0, 400, 7, 495 },
+		uint8_t(TabLayout::Edge::Left), false, true, true));
+
+	Replay::Environment environment{ { 0, 0, 1920, 1040 }, { 100, 600, 900, 900 }, { 1920, 1080 }, false };
+	auto event = [&](Replay::Message message, long x, long y, uint8_t detail = 0) {
+		writer.WriteEnvironment(environment);
+		Replay::NestingGuard nesting{};
+		writer.WriteEvent(message, { x, y }, detail);
+	};
+
+	event(Replay::Message::MouseMove, 3, 420);
+	event(Replay::Message::RButtonDown, 3, 420);
+	for (long i{}; i < 100; ++i) { event(Replay::Message::MouseMove, 3, 420 + i * 2); }
+	event(Replay::Message::RButtonUp, 3, 620);
+	event(Replay::Message::LButtonDown, 3, 620);
+	event(Replay::Message::LButtonUp, 3, 620);
+	event(Replay::Message::SyncPosition, 3, 620);
+	event(Replay::Message::MouseLeave, 600, 600);
+	event(Replay::Message::LButtonDown, 3, 620);
+	for (long i{}; i < 100; ++i) { event(Replay::Message::MouseMove, 3 + i * 20, 620); }
+	event(Replay::Message::LButtonUp, 1990, 620);
+	environment.workArea = { 0, 0, 1880, 1080 };
+	event(Replay::Message::SettingChange, 900, 500, uint8_t(Replay::SettingKind::WorkArea));
+	writer.Close();
+
+	ReadBack file{};
+	REQUIRE(Read("ReplayFormatTest.replay", &file));
+	CHECK(file.events.size() == 210);
+	CHECK(file.environments.size() == 2);
+}
+
+TEST_CASE(WritesADragTraceForThePredictionCheck)
+{
+	// A right-button drag of the tab: down, a pause, back up past the start and
+	// a small correction, sampled like a 125 Hz mouse with a little jitter.
+	// The timestamps are synthetic, which the clock-stamping Writer cannot do.
+	struct Reach { double dx, dy, durationMs, holdMs; };
+	static constexpr Reach reaches[] = {
+		{ 6, 380, 420, 120 }, { -4, -520, 480, 90 }, { 0, 70, 180, 80 }
+	};
+
+	std::ofstream file{ "DragTrace.replay", std::ios::binary | std::ios::trunc };
+	REQUIRE(file.good());
+	Replay::FileHeader header{};
+	header.magic = Replay::FileMagic;
+	header.version = Replay::FileVersion;
+	header.tabRect = Replay::ToRect32({ 0, 400, 7, 495 });
+	header.edge = uint8_t(TabLayout::Edge::Left);
+	header.hasSkin = 1;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	Replay::EnvironmentRecord environment{};
+	environment.workArea = Replay::ToRect32({ 0, 0, 1920, 1040 });
+	environment.oskRect = Replay::ToRect32({ 100, 600, 900, 900 });
+	environment.screenWidth = 1920;
+	environment.screenHeight = 1080;
+	WriteRecord(file, Replay::RecordType::Environment, environment);
+
+	Test::Random random{ 29 };
+	size_t moves{};
+	double timeMs = 1000;
+	double x = 3, y = 420;
+	auto event = [&](Replay::Message message, double atMs) {
+		Replay::EventRecord record{};
+		record.time = uint64_t(atMs * 1e6);
+		record.message = uint16_t(message);
+		record.x = int32_t(std::lround(x));
+		record.y = int32_t(std::lround(y));
+		WriteRecord(file, Replay::RecordType::Event, record);
+	};
+
+	event(Replay::Message::RButtonDown, timeMs);
+	for (const Reach& reach : reaches) {
+		const double startMs = timeMs, startX = x, startY = y;
+		const double endMs = startMs + reach.durationMs + reach.holdMs;
+		while (timeMs + 8 < endMs) {
+			timeMs += 8 + double(random.Range(-1000, 1000)) / 1000.0;
+			const double progress = MinimumJerk(std::min(1.0, (timeMs - startMs) / reach.durationMs));
+			x = startX + reach.dx * progress;
+			y = startY + reach.dy * progress;
+			event(Replay::Message::MouseMove, timeMs);
+			++moves;
+		}
+	}
+	event(Replay::Message::RButtonUp, timeMs + 8);
+	file.close();
+
+	ReadBack trace{};
+	REQUIRE(Read("DragTrace.replay", &trace));
+	CHECK(trace.environments.size() == 1);
+	CHECK(trace.events.size() == moves + 2);
+	CHECK(trace.events.back().y == 420 + 380 - 520 + 70);
+}
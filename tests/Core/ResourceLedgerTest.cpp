@@ -0,0 +1,149 @@
+// Handle owners, the ledger, the leak trend detector and the soak budget.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/ResourceLedger.h"
+
+// Standard library headers
+#include <utility>
+
+using Resources::Kind;
+
+namespace
+{
+	int freedCount{};
+	int lastFreed{};
+
+	// Fake pens: any non-zero int is a handle
+	struct FakePen
+	{
+		using Type = int;
+		static constexpr Kind kind = Kind::Pen;
+		static Type Invalid() { return 0; }
+		static void Free(Type handle) { ++freedCount; lastFreed = handle; }
+	};
+
+	using Pen = Resources::Owned<FakePen>;
+
+	// Samples one minute apart
+	template <typename CountFunc>
+	Resources::TrendDetector Sample(int count, CountFunc countAt, const Resources::TrendDetector::Config& config = {})
+	{
+		Resources::TrendDetector detector{ config };
+		for (int i{}; i < count; ++i) { detector.Add(uint64_t(i) * 60000, countAt(i)); }
+		return detector;
+	}
+}
+
+TEST_CASE(OwnersCountWhatTheyHold)
+{
+	const Resources::Ledger& ledger = Resources::GetLedger();
+	const int64_t live = ledger.GetLive(Kind::Pen);
+	const uint64_t created = ledger.GetCreated(Kind::Pen);
+	const int freed = freedCount;
+	{
+		Pen a{ 5 };
+		CHECK(ledger.GetLive(Kind::Pen) == live + 1);
+
+		// Moving hands the handle over without counting it twice
+		Pen b{ std::move(a) };
+		CHECK(!a and b);
+		CHECK(ledger.GetLive(Kind::Pen) == live + 1);
+
+		Pen c{};
+		c = std::move(b);
+		CHECK(!b and c.Get() == 5);
+		CHECK(ledger.GetLive(Kind::Pen) == live + 1);
+
+		// A failed create is not a handle
+		Pen failed{ 0 };
+		CHECK(!failed);
+		CHECK(ledger.GetLive(Kind::Pen) == live + 1);
+
+		c.Reset(6);
+		CHECK(freedCount == freed + 1 and lastFreed == 5);
+		CHECK(ledger.GetLive(Kind::Pen) == live + 1);
+
+		// Released handles are the caller's problem, not the ledger's
+		CHECK(c.Release() == 6);
+		CHECK(ledger.GetLive(Kind::Pen) == live);
+
+		Pen d{ 7 };
+	}
+	CHECK(freedCount == freed + 2 and lastFreed == 7);
+	CHECK(ledger.GetLive(Kind::Pen) == live);
+	CHECK(ledger.GetCreated(Kind::Pen) == created + 3);
+}
+
+TEST_CASE(LedgerTotalsEveryKind)
+{
+	Resources::Ledger ledger{};
+	ledger.OnCreated(Kind::Bitmap);
+	ledger.OnCreated(Kind::Bitmap);
+	ledger.OnCreated(Kind::Window);
+	ledger.OnDestroyed(Kind::Bitmap);
+	CHECK(ledger.GetLive(Kind::Bitmap) == 1);
+	CHECK(ledger.GetCreated(Kind::Bitmap) == 2);
+	CHECK(ledger.GetTotalLive() == 2);
+
+	for (size_t i{}; i < size_t(Kind::Count); ++i) {
+		CHECK(Resources::GetKindName(Kind(i))[0] != '?');
+	}
+}
+
+TEST_CASE(SteadyRiseIsALeak)
+{
+	// One handle a minute is 60 an hour
+	const Resources::TrendDetector detector = Sample(30, [](int i) { return int64_t(100 + i); });
+	CHECK(detector.GetSlopePerHour() > 59.9 and detector.GetSlopePerHour() < 60.1);
+	CHECK(detector.IsLeaking());
+	CHECK(detector.GetLatest().count == 129);
+
+	// Not before the window is full
+	CHECK(!Sample(29, [](int i) { return int64_t(100 + i); }).IsLeaking());
+
+	// Too slow to matter
+	const Resources::TrendDetector slow = Sample(30, [](int i) { return int64_t(100 + i / 4); });
+	CHECK(!slow.IsLeaking());
+}
+
+TEST_CASE(BurstsAndPlateausAreNotLeaks)
+{
+	CHECK(!Sample(40, [](int) { return int64_t(100); }).IsLeaking());
+
+	// Rises by 50 and falls back every ten minutes
+	const Resources::TrendDetector bursts = Sample(30, [](int i) { return int64_t(i % 10 < 5 ? 100 : 150); });
+	CHECK(!bursts.IsLeaking());
+
+	// A single step up that ends with a dip to the old level
+	const Resources::TrendDetector dip = Sample(30, [](int i) { return int64_t(i == 27 ? 100 : 100 + 2 * i); });
+	CHECK(!dip.IsLeaking());
+}
+
+TEST_CASE(WindowSlidesOverOldSamples)
+{
+	// An early climb that has levelled off leaves the window once it is old
+	Resources::TrendDetector detector{};
+	for (int i{}; i < 100; ++i) {
+		detector.Add(uint64_t(i) * 60000, i < 30 ? 100 + i : 130);
+		if (i == 29) { CHECK(detector.IsLeaking()); }
+	}
+	CHECK(!detector.IsLeaking());
+	CHECK(detector.GetSampleCount() == Resources::TrendDetector::MaxSamples);
+	CHECK(detector.GetLatest().timeMs == 99 * 60000);
+}
+
+TEST_CASE(BudgetStartsAfterTheWarmup)
+{
+	Resources::Budget budget{ 1000, 5 };
+	CHECK(budget.Check(0, 50));
+	CHECK(budget.Check(500, 900));
+	CHECK(!budget.IsBaselined());
+
+	CHECK(budget.Check(1000, 100));
+	CHECK(budget.IsBaselined());
+	CHECK(budget.GetBaseline() == 100 and budget.GetLimit() == 105);
+	CHECK(budget.Check(2000, 105));
+	CHECK(!budget.Check(3000, 106));
+	CHECK(budget.Check(4000, 90));
+}
@@ -0,0 +1,116 @@
+// OSK restart policy on a fake clock: backoff, healthy runs, crash loops
+// and the retry after a give-up.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/RestartPolicy.h"
+
+using Supervision::Decision;
+using Supervision::RestartPolicy;
+using Supervision::Verdict;
+
+TEST_CASE(RestartsBackOffExponentially)
+{
+	RestartPolicy policy{};
+	uint64_t nowMs{ 1000 };
+	policy.OnStarted(nowMs);
+
+	// Each restart comes straight back up and dies again at once
+	const uint64_t expected[] = { 250, 500, 1000, 2000, 4000 };
+	for (uint64_t delayMs : expected) {
+		const Decision decision = policy.OnExited(nowMs += 10);
+		CHECK(decision.verdict == Verdict::Restart);
+		CHECK(decision.delayMs == delayMs);
+		CHECK(policy.IsRecovering());
+		policy.OnStarted(nowMs += decision.delayMs);
+		CHECK(!policy.IsRecovering());
+	}
+	CHECK(policy.GetAttempt() == 5);
+}
+
+TEST_CASE(BackoffStopsAtTheCeiling)
+{
+	RestartPolicy::Config config{};
+	config.maxBurstRestarts = 16;
+	config.burstWindowMs = 1;           // Every restart is outside the window
+	RestartPolicy policy{ config };
+
+	uint64_t nowMs{};
+	Decision decision{};
+	for (int i{}; i < 40; ++i) {
+		decision = policy.OnRestartFailed(nowMs += 100000);
+		REQUIRE(decision.verdict == Verdict::Restart);
+		REQUIRE(decision.delayMs <= config.maxDelayMs);
+	}
+	CHECK(decision.delayMs == config.maxDelayMs);
+	CHECK(decision.attempt == 40);
+}
+
+TEST_CASE(HealthyUptimeResetsTheBackoff)
+{
+	RestartPolicy policy{};
+	policy.OnStarted(0);
+	policy.OnExited(10);
+	policy.OnStarted(300);
+	CHECK(policy.OnExited(400).delayMs == 500);
+
+	// Up for a minute: the next crash restarts quickly again
+	policy.OnStarted(1000);
+	const Decision decision = policy.OnExited(1000 + policy.GetConfig().healthyUptimeMs);
+	CHECK(decision.delayMs == 250);
+	CHECK(decision.attempt == 1);
+}
+
+TEST_CASE(RecoveryTimeRunsFromTheFirstExit)
+{
+	RestartPolicy policy{};
+	CHECK(policy.OnStarted(0) == 0);     // First start is not a recovery
+
+	policy.OnExited(5000);
+	policy.OnRestartFailed(5300);
+	policy.OnRestartFailed(5900);
+	CHECK(policy.IsRecovering());
+	CHECK(policy.OnStarted(7000) == 2000);
+}
+
+TEST_CASE(CrashLoopGivesUpUntilRetried)
+{
+	RestartPolicy policy{};
+	uint64_t nowMs{};
+	policy.OnStarted(nowMs);
+
+	const uint32_t limit = policy.GetConfig().maxBurstRestarts;
+	for (uint32_t i{}; i < limit; ++i) {
+		REQUIRE(policy.OnRestartFailed(nowMs += 1000).verdict == Verdict::Restart);
+	}
+	const Decision decision = policy.OnRestartFailed(nowMs += 1000);
+	CHECK(decision.verdict == Verdict::GiveUp);
+	CHECK(policy.IsGivenUp());
+	CHECK(!policy.IsRecovering());
+
+	// Stays down, even much later, until someone asks for it
+	CHECK(policy.OnExited(nowMs += 3600000).verdict == Verdict::GiveUp);
+	CHECK(policy.OnRestartFailed(nowMs).verdict == Verdict::GiveUp);
+
+	// The retry a tap makes: reset, then treat it as a fresh exit
+	policy.Reset();
+	CHECK(!policy.IsGivenUp());
+	const Decision retry = policy.OnExited(nowMs);
+	CHECK(retry.verdict == Verdict::Restart);
+	CHECK(retry.delayMs == policy.GetConfig().initialDelayMs);
+	CHECK(policy.IsRecovering());
+	CHECK(policy.GetConfig().maxBurstRestarts == limit);   // Config survives the reset
+}
+
+TEST_CASE(OldRestartsLeaveTheWindow)
+{
+	RestartPolicy policy{};
+	const RestartPolicy::Config& config = policy.GetConfig();
+	uint64_t nowMs{};
+
+	// Spread just wider than the window: never a crash loop
+	const uint64_t spacing = config.burstWindowMs / (config.maxBurstRestarts - 1) + 1;
+	for (int i{}; i < 100; ++i) {
+		REQUIRE(policy.OnRestartFailed(nowMs += spacing).verdict == Verdict::Restart);
+	}
+}
@@ -0,0 +1,112 @@
+// WM_SETTINGCHANGE classification and the burst coalescer.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/SettingChange.h"
+
+using Settings::Classify;
+
+namespace
+{
+	constexpr uint32_t SpiSetDeskWallpaper = 0x0014;
+	constexpr uint32_t SpiSetNonClientMetrics = 0x002A;
+}
+
+TEST_CASE(ThemeAndTaskbarAreasAreKept)
+{
+	CHECK(Classify(0, "ImmersiveColorSet") == Settings::ChangeTheme);
+	CHECK(Classify(0, L"immersivecolorset") == Settings::ChangeTheme);
+	CHECK(Classify(SpiSetNonClientMetrics, L"IMMERSIVECOLORSET") == Settings::ChangeTheme);
+	CHECK(Classify(0, L"TraySettings") == Settings::ChangeLayout);
+	CHECK(Classify(Settings::SpiSetWorkArea, L"") == Settings::ChangeLayout);
+	CHECK(Classify<wchar_t>(Settings::SpiSetWorkArea, nullptr) == Settings::ChangeLayout);
+}
+
+TEST_CASE(BareBroadcastMayBeAnything)
+{
+	CHECK(Classify<wchar_t>(0, nullptr) == Settings::ChangeLayout);
+	CHECK(Classify(0, L"") == Settings::ChangeLayout);
+}
+
+TEST_CASE(OtherSettingsAreIgnored)
+{
+	CHECK(Classify(0, L"Policy") == Settings::ChangeNone);
+	CHECK(Classify(0, L"intl") == Settings::ChangeNone);
+	CHECK(Classify(0, L"Environment") == Settings::ChangeNone);
+	CHECK(Classify<wchar_t>(SpiSetDeskWallpaper, nullptr) == Settings::ChangeNone);
+
+	// Prefixes and extensions of a kept area are other areas
+	CHECK(Classify(0, L"TraySetting") == Settings::ChangeNone);
+	CHECK(Classify(0, L"TraySettings2") == Settings::ChangeNone);
+	CHECK(Classify(0, L"ImmersiveColor") == Settings::ChangeNone);
+}
+
+TEST_CASE(QuietTimeEndsABurst)
+{
+	Settings::Coalescer coalescer{};
+	CHECK(!coalescer.IsPending());
+	CHECK(coalescer.GetDeadline() == Settings::NoDeadline);
+	CHECK(!coalescer.Add(Settings::ChangeNone, 0));
+	CHECK(!coalescer.IsPending());
+
+	// Each notification pushes the deadline 250 ms past itself
+	CHECK(coalescer.Add(Settings::ChangeLayout, 1000));
+	CHECK(coalescer.GetDeadline() == 1250);
+	CHECK(coalescer.Add(Settings::ChangeLayout, 1100));
+	CHECK(coalescer.Add(Settings::ChangeTheme, 1200));
+	CHECK(coalescer.GetDeadline() == 1450);
+
+	CHECK(coalescer.Take(1449) == Settings::ChangeNone);
+	CHECK(coalescer.IsPending());
+
+	uint32_t merged{};
+	CHECK(coalescer.Take(1450, &merged) == (Settings::ChangeLayout | Settings::ChangeTheme));
+	CHECK(merged == 3);
+	CHECK(!coalescer.IsPending());
+	CHECK(coalescer.Take(5000) == Settings::ChangeNone);
+
+	// The next burst starts its own window
+	CHECK(coalescer.Add(Settings::ChangeTheme, 9000));
+	CHECK(coalescer.GetDeadline() == 9250);
+	CHECK(coalescer.Take(9250, &merged) == Settings::ChangeTheme);
+	CHECK(merged == 1);
+}
+
+TEST_CASE(SteadyStreamIsCappedAfterTheFirstNotification)
+{
+	Settings::Coalescer coalescer{};
+
+	// One notification every 100 ms never goes quiet for 250 ms
+	uint64_t passAt{};
+	uint32_t merged{};
+	for (uint64_t now{}; now <= 5000; now += 100) {
+		if (coalescer.Take(now, &merged)) {
+			passAt = now;
+			break;
+		}
+		coalescer.Add(Settings::ChangeLayout, now);
+	}
+	CHECK(passAt == 2000);
+	CHECK(merged == 20);
+
+	Settings::Coalescer tight{ { 50, 120 } };
+	tight.Add(Settings::ChangeLayout, 0);
+	tight.Add(Settings::ChangeLayout, 40);
+	tight.Add(Settings::ChangeLayout, 80);
+	CHECK(tight.GetDeadline() == 120);
+	CHECK(tight.GetConfig().settleMs == 50);
+}
+
+TEST_CASE(FlushTakesChangesEarly)
+{
+	Settings::Coalescer coalescer{};
+	coalescer.Add(Settings::ChangeLayout, 100);
+	coalescer.Add(Settings::ChangeLayout, 120);
+
+	uint32_t merged{};
+	CHECK(coalescer.Flush(&merged) == Settings::ChangeLayout);
+	CHECK(merged == 2);
+	CHECK(!coalescer.IsPending());
+	CHECK(coalescer.Flush(&merged) == Settings::ChangeNone);
+	CHECK(merged == 0);
+}
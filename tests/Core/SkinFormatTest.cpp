@@ -0,0 +1,167 @@
+// Skin container validation, frame lookup and the per-DPI frame table.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/SkinFormat.h"
+
+// Standard library headers
+#include <vector>
+
+namespace
+{
+	struct FrameSpec
+	{
+		Skin::State state{};
+		uint16_t dpi{ 96 };
+		bool isMirrored{};
+		uint16_t width{ 4 };
+		uint16_t height{ 2 };
+	};
+
+	// Packs frames the way SkinPacker does; each pixel holds its frame index
+	std::vector<uint8_t> Pack(const std::vector<FrameSpec>& specs)
+	{
+		const uint32_t tableOffset = sizeof(Skin::Header);
+		uint32_t offset = tableOffset + uint32_t(specs.size() * sizeof(Skin::FrameEntry));
+
+		std::vector<Skin::FrameEntry> entries{};
+		for (const FrameSpec& spec : specs) {
+			offset = (offset + Skin::PixelAlignment - 1) / Skin::PixelAlignment * Skin::PixelAlignment;
+			Skin::FrameEntry entry{};
+			entry.state = uint8_t(spec.state);
+			entry.flags = spec.isMirrored ? Skin::FrameMirrored : Skin::FrameNone;
+			entry.dpi = spec.dpi;
+			entry.width = spec.width;
+			entry.height = spec.height;
+			entry.stride = uint32_t(spec.width) * 4;
+			entry.pixelOffset = offset;
+			entries.push_back(entry);
+			offset += entry.stride * spec.height;
+		}
+
+		std::vector<uint8_t> data(offset);
+		Skin::Header header{ Skin::Magic, Skin::Version, sizeof(Skin::Header), offset,
+			uint32_t(specs.size()), tableOffset, 0 };
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::memcpy(data.data() + tableOffset, entries.data(), entries.size() * sizeof(Skin::FrameEntry));
+		for (size_t i{}; i < entries.size(); ++i) {
+			std::memset(data.data() + entries[i].pixelOffset, int(i), entries[i].stride * entries[i].height);
+		}
+		return data;
+	}
+
+	Skin::View MakeView(const std::vector<uint8_t>& data)
+	{
+		return Skin::View{ data.data(), data.size() };
+	}
+}
+
+TEST_CASE(ValidatesHeaderAndFrames)
+{
+	std::vector<uint8_t> data = Pack({ { Skin::State::Idle } });
+	CHECK(MakeView(data).IsValid());
+	CHECK(MakeView(data).GetFrameCount() == 1);
+
+	CHECK(Skin::View{}.GetStatus() == Skin::Status::TooSmall);
+	CHECK(Skin::View(data.data(), 10).GetStatus() == Skin::Status::TooSmall);
+
+	std::vector<uint8_t> bad = data;
+	bad[0] ^= 0xFF;
+	CHECK(MakeView(bad).GetStatus() == Skin::Status::BadMagic);
+
+	// Size in the header must match the mapping
+	bad = data;
+	bad.push_back(0);
+	CHECK(MakeView(bad).GetStatus() == Skin::Status::BadHeader);
+
+	// Pixels past the end of the file
+	bad = data;
+	Skin::FrameEntry entry{};
+	std::memcpy(&entry, bad.data() + sizeof(Skin::Header), sizeof(entry));
+	entry.height = 100;
+	std::memcpy(bad.data() + sizeof(Skin::Header), &entry, sizeof(entry));
+	CHECK(MakeView(bad).GetStatus() == Skin::Status::BadFrame);
+
+	// Misaligned pixels
+	bad = data;
+	entry.height = 2;
+	entry.pixelOffset += 4;
+	std::memcpy(bad.data() + sizeof(Skin::Header), &entry, sizeof(entry));
+	CHECK(MakeView(bad).GetStatus() == Skin::Status::BadFrame);
+}
+
+TEST_CASE(TruncationsNeverReadPastTheMapping)
+{
+	std::vector<uint8_t> data = Pack({ { Skin::State::Idle }, { Skin::State::Hover, 144 } });
+	for (size_t size{}; size < data.size(); ++size) {
+		// A copy sized exactly, so ASan catches any overread
+		std::vector<uint8_t> cut(data.begin(), data.begin() + ptrdiff_t(size));
+		CHECK(!Skin::View(cut.data(), cut.size()).IsValid());
+	}
+}
+
+TEST_CASE(FramesPointIntoTheMapping)
+{
+	std::vector<uint8_t> data = Pack({ { Skin::State::Idle }, { Skin::State::Pressed } });
+	Skin::View view = MakeView(data);
+	Skin::Frame frame = view.GetFrame(1);
+	REQUIRE(frame);
+	CHECK(frame.pixels == data.data() + frame.pixelOffset);
+	CHECK(frame.pixels[0] == 1);
+	CHECK(frame.state == Skin::State::Pressed);
+	CHECK(!view.GetFrame(2));
+}
+
+TEST_CASE(FindPrefersExactThenHigherDpi)
+{
+	std::vector<uint8_t> data = Pack({
+		{ Skin::State::Idle, 96 },
+		{ Skin::State::Idle, 144 },
+		{ Skin::State::Idle, 192 },
+		{ Skin::State::Hover, 120 },
+	});
+	Skin::View view = MakeView(data);
+
+	CHECK(view.Find(Skin::State::Idle, 144).index == 1);
+	CHECK(view.Find(Skin::State::Idle, 120).index == 1);
+	CHECK(view.Find(Skin::State::Idle, 240).index == 2);
+	CHECK(view.Find(Skin::State::Hover, 96).index == 3);
+
+	// Missing states fall back to Idle; FindState does not
+	CHECK(view.Find(Skin::State::Dragging, 96).index == 0);
+	CHECK(!view.FindState(Skin::State::Dragging, 96));
+}
+
+TEST_CASE(MirroredTablePrefersTheRequestedState)
+{
+	// Idle is packed mirrored, Pressed only unmirrored
+	std::vector<uint8_t> data = Pack({
+		{ Skin::State::Idle, 96, false },
+		{ Skin::State::Idle, 96, true },
+		{ Skin::State::Pressed, 96, false },
+	});
+	Skin::FrameTable table{};
+	table.Build(MakeView(data), 96);
+
+	CHECK(table.GetDpi() == 96);
+	CHECK(table.Get(Skin::State::Idle, false).index == 0);
+	CHECK(table.Get(Skin::State::Idle, true).index == 1);
+	// The unmirrored Pressed frame (flipped when drawn), not the mirrored Idle
+	CHECK(table.Get(Skin::State::Pressed, true).index == 2);
+	CHECK(table.Get(Skin::State::Pressed, false).index == 2);
+	// States with no frame at all use Idle in the matching orientation
+	CHECK(table.Get(Skin::State::Hover, true).index == 1);
+	CHECK(table.Get(Skin::State::Hover, false).index == 0);
+}
+
+TEST_CASE(MirroredTableFallsBackToUnmirroredIdle)
+{
+	std::vector<uint8_t> data = Pack({ { Skin::State::Idle, 96, false } });
+	Skin::FrameTable table{};
+	table.Build(MakeView(data), 96);
+
+	for (size_t state{}; state < size_t(Skin::State::Count); ++state) {
+		CHECK(table.Get(Skin::State(state), true).index == 0);
+		CHECK(table.Get(Skin::State(state), false).index == 0);
+	}
+}
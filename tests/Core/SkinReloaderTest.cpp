@@ -0,0 +1,244 @@
+// SkinReloader and FrameSwapper against a real directory: the inotify
+// watcher on Linux, and a manual watcher for the cases that need exact
+// control over when notifications arrive.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/SkinReloader.h"
+#include "Support/InotifyWatcher.h"
+
+// Standard library headers
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+namespace
+{
+	// Watcher the test fires by hand
+	class ManualWatcher : public IDirectoryWatcher
+	{
+	public:
+		ChangeCallback callback{};
+		bool isStarted{};
+
+		bool Start(const fs::path&, ChangeCallback cb) override
+		{
+			callback = std::move(cb);
+			isStarted = true;
+			return true;
+		}
+		void Stop() override { isStarted = false; }
+		bool IsRunning() const override { return isStarted; }
+		void Fire() { if (callback) { callback(); } }
+	};
+
+	// Fresh directory per case, removed with its files
+	struct TempDir
+	{
+		fs::path path{};
+
+		explicit TempDir(const char* pszName)
+		{
+			path = fs::temp_directory_path() / (std::string{ "tabtap_" } + pszName + "_" + std::to_string(getpid()));
+			fs::remove_all(path);
+			fs::create_directories(path);
+		}
+		~TempDir()
+		{
+			std::error_code ec{};
+			fs::remove_all(path, ec);
+		}
+	};
+
+	void WriteFile(const fs::path& path, const std::string& text)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		file << text;
+	}
+
+	// "Decodes" a file: its text, or null when it says "bad"
+	std::shared_ptr<std::string> DecodeText(const fs::path& path, std::atomic<int>* pDecodes)
+	{
+		++*pDecodes;
+		std::ifstream file{ path, std::ios::binary };
+		auto spText = std::make_shared<std::string>(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+		return *spText == "bad" ? nullptr : spText;
+	}
+
+	template <typename Pred>
+	bool WaitFor(Pred pred, std::chrono::milliseconds timeout = 3000ms)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+		while (!pred()) {
+			if (std::chrono::steady_clock::now() > deadline) { return false; }
+			std::this_thread::sleep_for(5ms);
+		}
+		return true;
+	}
+}
+
+TEST_CASE(FrameSwapperPublishesWholeSets)
+{
+	FrameSwapper<std::string> frames{};
+	CHECK(frames.IsEmpty());
+
+	frames.Publish(std::make_shared<std::string>("one"));
+	std::shared_ptr<std::string> spHeld = frames.Acquire();
+	frames.Publish(std::make_shared<std::string>("two"));
+
+	// A reader keeps its snapshot after a swap
+	CHECK(*spHeld == "one");
+	CHECK(*frames.Acquire() == "two");
+
+	frames.Reset();
+	CHECK(frames.IsEmpty());
+}
+
+TEST_CASE(FrameSwapperNumbersEveryPublish)
+{
+	FrameSwapper<std::string> frames{};
+	uint64_t generation{ 99 };
+	CHECK(!frames.Acquire(&generation));
+	CHECK(generation == 0);
+
+	// Same address, new load: the generation still tells them apart
+	auto spFrames = std::make_shared<std::string>("one");
+	frames.Publish(spFrames);
+	uint64_t first{};
+	CHECK(frames.Acquire(&first) == spFrames);
+	frames.Publish(spFrames);
+	uint64_t second{};
+	CHECK(frames.Acquire(&second) == spFrames);
+	CHECK(first != 0 and second > first);
+
+	frames.Reset();
+	frames.Publish(std::make_shared<std::string>("two"));
+	CHECK(*frames.Acquire(&generation) == "two");
+	CHECK(generation > second);
+}
+
+TEST_CASE(StartFailsWithoutWatcherOrDecoder)
+{
+	FrameSwapper<std::string> frames{};
+	SkinReloader<std::string> noWatcher{ frames, nullptr };
+	CHECK(!noWatcher.Start("x/TabTap.png", [](const fs::path&) { return std::make_shared<std::string>(); }));
+
+	SkinReloader<std::string> noDecoder{ frames, std::make_unique<ManualWatcher>() };
+	CHECK(!noDecoder.Start("x/TabTap.png", {}));
+	CHECK(!noDecoder.IsRunning());
+}
+
+TEST_CASE(BurstDecodesOnceAfterSettling)
+{
+	TempDir dir{ "burst" };
+	const fs::path file = dir.path / "TabTap.png";
+	WriteFile(file, "v1");
+
+	auto spWatcher = std::make_unique<ManualWatcher>();
+	ManualWatcher* pWatcher = spWatcher.get();
+	FrameSwapper<std::string> frames{};
+	std::atomic<int> decodes{};
+	std::atomic<int> swaps{};
+
+	SkinReloader<std::string> reloader{ frames, std::move(spWatcher), 50ms };
+	REQUIRE(reloader.Start(file,
+		[&decodes](const fs::path& path) { return DecodeText(path, &decodes); },
+		[&swaps](bool isSwapped) { if (isSwapped) { ++swaps; } }));
+
+	// The file present at start counts as loaded
+	pWatcher->Fire();
+	std::this_thread::sleep_for(150ms);
+	CHECK(decodes == 0);
+
+	// A save in several steps is one reload
+	for (int i{}; i < 5; ++i) {
+		WriteFile(file, "v2-" + std::to_string(i));
+		pWatcher->Fire();
+		std::this_thread::sleep_for(10ms);
+	}
+	CHECK(WaitFor([&] { return swaps == 1; }));
+	std::this_thread::sleep_for(150ms);
+	CHECK(decodes == 1);
+	CHECK(*frames.Acquire() == "v2-4");
+
+	reloader.Stop();
+	CHECK(!reloader.IsRunning());
+}
+
+TEST_CASE(InvalidFileKeepsLastGoodFrame)
+{
+	TempDir dir{ "invalid" };
+	const fs::path file = dir.path / "TabTap.png";
+	WriteFile(file, "good");
+
+	auto spWatcher = std::make_unique<ManualWatcher>();
+	ManualWatcher* pWatcher = spWatcher.get();
+	FrameSwapper<std::string> frames{};
+	frames.Publish(std::make_shared<std::string>("good"));
+	std::atomic<int> decodes{};
+	std::atomic<int> rejects{};
+
+	SkinReloader<std::string> reloader{ frames, std::move(spWatcher), 20ms };
+	REQUIRE(reloader.Start(file,
+		[&decodes](const fs::path& path) { return DecodeText(path, &decodes); },
+		[&rejects](bool isSwapped) { if (!isSwapped) { ++rejects; } }));
+
+	WriteFile(file, "bad");
+	pWatcher->Fire();
+	CHECK(WaitFor([&] { return rejects == 1; }));
+	CHECK(*frames.Acquire() == "good");
+}
+
+TEST_CASE(InotifyReloadsOnSave)
+{
+	TempDir dir{ "inotify" };
+	const fs::path file = dir.path / "TabTap.png";
+	WriteFile(file, "first");
+
+	FrameSwapper<std::string> frames{};
+	std::atomic<int> decodes{};
+	SkinReloader<std::string> reloader{ frames, std::make_unique<InotifyWatcher>(), 30ms };
+	REQUIRE(reloader.Start(file, [&decodes](const fs::path& path) { return DecodeText(path, &decodes); }));
+
+	// Unrelated files in the directory change nothing
+	WriteFile(dir.path / "notes.txt", "x");
+	std::this_thread::sleep_for(150ms);
+	CHECK(decodes == 0);
+	CHECK(frames.IsEmpty());
+
+	WriteFile(file, "second, longer");
+	CHECK(WaitFor([&] { auto sp = frames.Acquire(); return sp and *sp == "second, longer"; }));
+
+	// Replacing the file by rename, as editors do
+	WriteFile(dir.path / "TabTap.tmp", "third");
+	fs::rename(dir.path / "TabTap.tmp", file);
+	CHECK(WaitFor([&] { auto sp = frames.Acquire(); return sp and *sp == "third"; }));
+}
+
+TEST_CASE(StopJoinsAndRestartIsRefusedWhileRunning)
+{
+	TempDir dir{ "stop" };
+	const fs::path file = dir.path / "TabTap.png";
+	WriteFile(file, "a");
+
+	FrameSwapper<std::string> frames{};
+	std::atomic<int> decodes{};
+	auto decoder = [&decodes](const fs::path& path) { return DecodeText(path, &decodes); };
+
+	SkinReloader<std::string> reloader{ frames, std::make_unique<InotifyWatcher>(), 10ms };
+	REQUIRE(reloader.Start(file, decoder));
+	CHECK(reloader.IsRunning());
+	CHECK(!reloader.Start(file, decoder));
+
+	reloader.Stop();
+	CHECK(!reloader.IsRunning());
+
+	// Nothing is decoded once stopped
+	WriteFile(file, "after stop");
+	std::this_thread::sleep_for(100ms);
+	CHECK(decodes == 0);
+}
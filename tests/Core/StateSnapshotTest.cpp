@@ -0,0 +1,131 @@
+// Session state snapshot: file round trip, damaged files and placement slots.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/StateSnapshot.h"
+
+// Standard library headers
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	const std::filesystem::path TempPath = std::filesystem::temp_directory_path() / "TabTapStateSnapshotTest.state";
+
+	bool WriteBytes(const uint8_t* pData, size_t length)
+	{
+		std::ofstream file{ TempPath, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(pData), std::streamsize(length));
+		return bool(file);
+	}
+
+	bool operator==(const Snapshot::Placement& a, const Snapshot::Placement& b)
+	{
+		return a.topology == b.topology and a.tabTop == b.tabTop and
+			a.oskLeft == b.oskLeft and a.oskTop == b.oskTop and a.stamp == b.stamp;
+	}
+}
+
+TEST_CASE(SaveAndLoadRoundTrip)
+{
+	Snapshot::State state{};
+	state.edge = 2;
+	state.opacity = 0x80;
+	state.isDockMode = 1;
+	Snapshot::StorePlacement(&state, { 11, 400, 100, 600 });
+	Snapshot::StorePlacement(&state, { 22, 300, 0, 700 });
+
+	REQUIRE(Snapshot::Save(TempPath, state));
+	CHECK(!std::filesystem::exists(std::filesystem::path{ TempPath }.concat(".tmp")));
+
+	Snapshot::State loaded{};
+	REQUIRE(Snapshot::Load(TempPath, &loaded) == Snapshot::Status::Ok);
+	CHECK(loaded.edge == 2 and loaded.opacity == 0x80 and loaded.isDockMode == 1);
+	CHECK(loaded.stamp == state.stamp);
+	for (size_t i{}; i < Snapshot::MaxTopologies; ++i) {
+		CHECK(loaded.placements[i] == state.placements[i]);
+	}
+	std::filesystem::remove(TempPath);
+}
+
+TEST_CASE(DamagedFilesAreRejected)
+{
+	Snapshot::State state{};
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::Missing);
+
+	Snapshot::StorePlacement(&state, { 11, 400, 100, 600 });
+	auto image = Snapshot::Encode(state);
+
+	REQUIRE(WriteBytes(image.data(), sizeof(Snapshot::FileHeader) - 1));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::TooSmall);
+
+	REQUIRE(WriteBytes(image.data(), image.size() - 1));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::BadSize);
+
+	// A longer file is not this version's snapshot either
+	uint8_t longer[Snapshot::FileBytes + 4]{};
+	std::memcpy(longer, image.data(), image.size());
+	REQUIRE(WriteBytes(longer, sizeof(longer)));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::BadSize);
+
+	auto torn = image;
+	torn[sizeof(Snapshot::FileHeader) + 5] ^= 0x40;
+	REQUIRE(WriteBytes(torn.data(), torn.size()));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::BadChecksum);
+
+	auto newer = image;
+	newer[4] = uint8_t(Snapshot::FileVersion + 1);
+	REQUIRE(WriteBytes(newer.data(), newer.size()));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::UnsupportedVersion);
+
+	auto foreign = image;
+	foreign[0] ^= 0xFF;
+	REQUIRE(WriteBytes(foreign.data(), foreign.size()));
+	CHECK(Snapshot::Load(TempPath, &state) == Snapshot::Status::BadMagic);
+
+	std::filesystem::remove(TempPath);
+}
+
+TEST_CASE(PlacementsEvictTheLeastRecentlyUsed)
+{
+	Snapshot::State state{};
+	for (uint64_t topology{ 1 }; topology <= Snapshot::MaxTopologies; ++topology) {
+		Snapshot::StorePlacement(&state, { topology, int32_t(topology), 0, 0 });
+	}
+
+	// Touch topology 1 so topology 2 becomes the oldest
+	Snapshot::StorePlacement(&state, { 1, 100, 0, 0 });
+	Snapshot::StorePlacement(&state, { 99, 9, 0, 0 });
+
+	CHECK(Snapshot::FindPlacement(state, 2) == nullptr);
+	REQUIRE(Snapshot::FindPlacement(state, 1) != nullptr);
+	CHECK(Snapshot::FindPlacement(state, 1)->tabTop == 100);
+	REQUIRE(Snapshot::FindPlacement(state, 99) != nullptr);
+	CHECK(Snapshot::FindPlacement(state, 3) != nullptr);
+}
+
+TEST_CASE(UnchangedNewestPlacementKeepsTheState)
+{
+	Snapshot::State state{};
+	Snapshot::StorePlacement(&state, { 5, 10, 20, 30 });
+	const auto before = Snapshot::Encode(state);
+
+	Snapshot::StorePlacement(&state, { 5, 10, 20, 30 });
+	CHECK(Snapshot::Encode(state) == before);
+
+	Snapshot::StorePlacement(&state, { 5, 11, 20, 30 });
+	CHECK(!(Snapshot::Encode(state) == before));
+}
+
+TEST_CASE(TopologyHashDependsOnEveryMonitor)
+{
+	const Geometry::Rect one[] = { { 0, 0, 1920, 1080 } };
+	const Geometry::Rect two[] = { { 0, 0, 1920, 1080 }, { 1920, 0, 3840, 1080 } };
+	const Geometry::Rect moved[] = { { 0, 0, 1920, 1080 }, { 1920, 100, 3840, 1180 } };
+
+	CHECK(Snapshot::HashTopology(one, 1) == Snapshot::HashTopology(two, 1));
+	CHECK(Snapshot::HashTopology(one, 1) != Snapshot::HashTopology(two, 2));
+	CHECK(Snapshot::HashTopology(two, 2) != Snapshot::HashTopology(moved, 2));
+	CHECK(Snapshot::HashTopology(nullptr, 0) != 0);
+}
@@ -0,0 +1,86 @@
+// Tab placement arithmetic shared by TabTap and the replay harness.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/TabLayout.h"
+
+// Standard library headers
+#include <algorithm>
+#include <cstdlib>
+
+using TabLayout::Edge;
+
+namespace
+{
+	const Geometry::Size Screen{ 1920, 1080 };
+	const Geometry::Rect FullArea{ 0, 0, 1920, 1080 };
+	const Geometry::Rect BottomTaskbar{ 0, 0, 1920, 1040 };
+	const Geometry::Rect LeftTaskbar{ 60, 0, 1920, 1080 };
+}
+
+TEST_CASE(FreeEdgesFollowTheTaskbar)
+{
+	CHECK(TabLayout::IsFreeEdge(Edge::Left, BottomTaskbar, Screen));
+	CHECK(TabLayout::IsFreeEdge(Edge::Right, BottomTaskbar, Screen));
+	CHECK(TabLayout::IsFreeEdge(Edge::Top, BottomTaskbar, Screen));
+	CHECK(!TabLayout::IsFreeEdge(Edge::Bottom, BottomTaskbar, Screen));
+	CHECK(!TabLayout::IsFreeEdge(Edge::Left, LeftTaskbar, Screen));
+	CHECK(!TabLayout::IsFreeEdge(Edge::None, FullArea, Screen));
+}
+
+TEST_CASE(WorkAreaChangeMovesOffAnOccupiedSide)
+{
+	CHECK(TabLayout::ResolveWorkAreaChange(Edge::Left, LeftTaskbar, Screen) == Edge::Right);
+	CHECK(TabLayout::ResolveWorkAreaChange(Edge::Right, { 0, 0, 1860, 1080 }, Screen) == Edge::Left);
+	CHECK(TabLayout::ResolveWorkAreaChange(Edge::Left, BottomTaskbar, Screen) == Edge::None);
+	CHECK(TabLayout::ResolveWorkAreaChange(Edge::Top, { 0, 40, 1920, 1080 }, Screen) == Edge::None);
+
+	CHECK(TabLayout::EdgeLeft(Edge::Right, Screen.cx, TabLayout::ExpandedSize.cx) == 1920 - 28);
+	CHECK(TabLayout::EdgeLeft(Edge::Left, Screen.cx, TabLayout::ExpandedSize.cx) == 0);
+}
+
+TEST_CASE(SnapEdgeNeedsTheMargin)
+{
+	const long margin = TabLayout::SnapMargin;
+	CHECK(TabLayout::DetectSnapEdge({ margin, 500 }, FullArea, Edge::Right) == Edge::Left);
+	CHECK(TabLayout::DetectSnapEdge({ margin + 1, 500 }, FullArea, Edge::Right) == Edge::None);
+	CHECK(TabLayout::DetectSnapEdge({ 1920 - margin, 500 }, FullArea, Edge::Left) == Edge::Right);
+	CHECK(TabLayout::DetectSnapEdge({ 900, 1040 - margin }, BottomTaskbar, Edge::Left) == Edge::Bottom);
+	CHECK(TabLayout::DetectSnapEdge({ 900, 10 }, FullArea, Edge::Left) == Edge::Top);
+
+	// The current edge is not a new snap target
+	CHECK(TabLayout::DetectSnapEdge({ 10, 500 }, FullArea, Edge::Left) == Edge::None);
+}
+
+TEST_CASE(SyncCentresAndClamps)
+{
+	const long height = TabLayout::CollapsedSize.cy;
+	CHECK(TabLayout::SyncTop({ 100, 600, 900, 900 }, height, BottomTaskbar) == 600 + (300 - height) / 2);
+	CHECK(TabLayout::SyncTop({ 100, 1000, 900, 1300 }, height, BottomTaskbar) == 1040 - height);
+	CHECK(TabLayout::SyncTop({ 100, -300, 900, 0 }, height, BottomTaskbar) == 0);
+
+	const Geometry::Rect tab{ 0, 500, 7, 595 };
+	CHECK(TabLayout::OskSyncTop(tab, 300, BottomTaskbar) == 500 + (95 - 300) / 2);
+	CHECK(TabLayout::OskSyncTop({ 0, 1000, 7, 1095 }, 300, BottomTaskbar) == 1040 - 300);
+}
+
+TEST_CASE(AnimationReachesTheTargetInBoundedSteps)
+{
+	Test::Random random{ 35 };
+	for (int run{}; run < 1000; ++run) {
+		Geometry::Point current{ long(random.Range(-500, 2500)), long(random.Range(-500, 1500)) };
+		const Geometry::Point target{ long(random.Range(0, 1920)), long(random.Range(0, 1080)) };
+		const long distance = std::max(std::abs(target.x - current.x), std::abs(target.y - current.y));
+
+		long steps{};
+		while (!(current == target) and steps <= distance) {
+			const Geometry::Point next = TabLayout::StepToward(current, target);
+			REQUIRE(std::abs(next.x - current.x) <= TabLayout::AnimationStep);
+			REQUIRE(std::abs(next.y - current.y) <= TabLayout::AnimationStep);
+			current = next;
+			++steps;
+		}
+		REQUIRE(current == target);
+		CHECK(steps == (distance + TabLayout::AnimationStep - 1) / TabLayout::AnimationStep);
+	}
+}
@@ -0,0 +1,206 @@
+// Timer wheel: coalescing, overflow blocks, callbacks that reschedule, and a
+// long random run against a plain reference model.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/TimerWheel.h"
+
+// Standard library headers
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using Timing::TimerId;
+using Timing::TimerWheel;
+
+namespace
+{
+	constexpr uint64_t Block = 1ull << TimerWheel::BlockBits;
+
+	// What the wheel should know about one timer
+	struct Expected
+	{
+		uint32_t tag{};
+		uint64_t deadlineMs{};
+		uint32_t toleranceMs{};
+		uint32_t periodMs{};
+
+		uint64_t GetExpiry() const { return Timing::CoalesceDeadline(deadlineMs, toleranceMs); }
+	};
+}
+
+TEST_CASE(CoalescedTickStaysInsideTheWindow)
+{
+	CHECK(Timing::CoalesceDeadline(1234, 0) == 1234);
+	CHECK(Timing::CoalesceDeadline(1000, 500) == 1500 / 256 * 256);
+
+	Test::Random random{ 40 };
+	for (int i{}; i < 100000; ++i) {
+		const uint64_t deadline = uint64_t(random.Range(0, 1ll << 40));
+		const uint32_t tolerance = uint32_t(random.Range(0, 70000));
+		const uint64_t expiry = Timing::CoalesceDeadline(deadline, tolerance);
+		REQUIRE(expiry >= deadline);
+		REQUIRE(expiry <= deadline + tolerance);
+	}
+
+	// Windows overlapping by the grid share one tick
+	CHECK(Timing::CoalesceDeadline(5000, 500) == Timing::CoalesceDeadline(5100, 400));
+}
+
+TEST_CASE(TimersFireAtTheirExpiry)
+{
+	TimerWheel wheel{ 100 };
+	const TimerId early = wheel.Schedule(1, 150, 0);
+	wheel.Schedule(2, 150 + Block * 3, 0);    // Waits in the overflow list
+	wheel.Schedule(3, 90, 0);                 // Already due
+	CHECK(wheel.GetCount() == 3);
+	CHECK(wheel.GetNextWakeup() == 100);
+
+	std::vector<uint32_t> tags{};
+	std::vector<uint64_t> times{};
+	auto fire = [&](uint32_t tag, TimerId) { tags.push_back(tag); times.push_back(wheel.GetTime()); };
+
+	CHECK(wheel.Advance(149, fire) == 1);
+	CHECK(wheel.GetNextWakeup() == 150);
+	CHECK(wheel.IsPending(early));
+	CHECK(wheel.Advance(Block * 3, fire) == 1);
+	CHECK(!wheel.IsPending(early));
+	CHECK(wheel.GetNextWakeup() == 150 + Block * 3);
+	CHECK(wheel.Advance(Block * 4, fire) == 1);
+
+	CHECK(tags == std::vector<uint32_t>{ 3, 1, 2 });
+	CHECK(times == std::vector<uint64_t>{ 100, 150, 150 + Block * 3 });
+	CHECK(wheel.GetCount() == 0);
+	CHECK(wheel.GetNextWakeup() == Timing::NoWakeup);
+}
+
+TEST_CASE(StaleIdsMiss)
+{
+	TimerWheel wheel{};
+	const TimerId id = wheel.Schedule(1, 10, 0);
+	CHECK(wheel.Cancel(id));
+	CHECK(!wheel.Cancel(id));
+	CHECK(!wheel.Cancel(Timing::InvalidTimer));
+
+	// The node is reused with a new generation
+	const TimerId reused = wheel.Schedule(2, 10, 0);
+	CHECK(reused != id);
+	CHECK(!wheel.IsPending(id));
+	CHECK(wheel.IsPending(reused));
+}
+
+TEST_CASE(PeriodicTimersKeepTheirBeat)
+{
+	TimerWheel wheel{};
+	const TimerId id = wheel.Schedule(7, 100, 0, 100);
+
+	std::vector<uint64_t> times{};
+	auto fire = [&](uint32_t, TimerId) { times.push_back(wheel.GetTime()); };
+	for (uint64_t targetMs : { 150, 250, 350 }) { wheel.Advance(targetMs, fire); }
+	CHECK(times == std::vector<uint64_t>{ 100, 200, 300 });
+
+	// A long sleep fires the missed periods once
+	CHECK(wheel.Advance(10000, fire) == 1);
+	CHECK(wheel.GetNextWakeup() == 10100);
+	CHECK(wheel.Cancel(id));
+}
+
+TEST_CASE(CallbacksMayCancelAndSchedule)
+{
+	TimerWheel wheel{};
+	const TimerId first = wheel.Schedule(1, 50, 0);
+	const TimerId second = wheel.Schedule(2, 50, 0);
+
+	std::vector<uint32_t> tags{};
+	wheel.Advance(50, [&](uint32_t tag, TimerId) {
+		tags.push_back(tag);
+		// Whichever fires first cancels the other and starts a follow-up
+		if (tags.size() == 1) {
+			CHECK(wheel.Cancel(tag == 1 ? second : first));
+			wheel.Schedule(3, 60, 0);
+		}
+	});
+	wheel.Advance(100, [&](uint32_t tag, TimerId) { tags.push_back(tag); });
+
+	CHECK(tags.size() == 2);
+	CHECK(tags.back() == 3);
+	CHECK(wheel.GetCount() == 0);
+}
+
+TEST_CASE(RandomRunMatchesTheReferenceModel)
+{
+	Test::Random random{ 200000 };
+	TimerWheel wheel{ 1000 };
+	std::unordered_map<TimerId, Expected> expected{};
+	std::vector<TimerId> ids{};      // Every id handed out; cancels pick recent ones, live or stale
+	size_t fired{};
+	bool isValid{ true };
+
+	auto schedule = [&]() {
+		const uint64_t nowMs = wheel.GetTime();
+		Expected timer{};
+		timer.tag = uint32_t(random.Next());
+		timer.deadlineMs = random.Chance(5) ? nowMs + uint64_t(random.Range(0, int64_t(Block) * 3)) :
+			random.Chance(5) ? nowMs - uint64_t(random.Range(0, 100)) : nowMs + uint64_t(random.Range(0, 5000));
+		timer.toleranceMs = random.Chance(30) ? 0 : uint32_t(random.Range(0, 2000));
+		timer.periodMs = random.Chance(10) ? uint32_t(random.Range(1, 20000)) : 0;
+
+		const TimerId id = wheel.Schedule(timer.tag, timer.deadlineMs, timer.toleranceMs, timer.periodMs);
+		timer.deadlineMs = std::max(timer.deadlineMs, nowMs);
+		isValid &= expected.emplace(id, timer).second;
+		ids.push_back(id);
+	};
+
+	auto cancel = [&]() {
+		if (ids.empty()) { return; }
+		const int64_t window = std::min<int64_t>(int64_t(ids.size()), 2000);
+		const TimerId id = ids[ids.size() - 1 - size_t(random.Range(0, window - 1))];
+		isValid &= wheel.Cancel(id) == (expected.erase(id) == 1);
+	};
+
+	for (int op{}; op < 200000 and isValid; ++op) {
+		const int64_t choice = random.Range(0, 99);
+		if (choice < 50) {
+			if (expected.size() < 1000) { schedule(); }
+		}
+		else if (choice < 75) { cancel(); }
+		else {
+			// Never late: nothing expires before the reported wakeup
+			uint64_t earliest = Timing::NoWakeup;
+			for (const auto& entry : expected) { earliest = std::min(earliest, entry.second.GetExpiry()); }
+			const uint64_t wakeup = wheel.GetNextWakeup();
+			REQUIRE(wakeup == (expected.empty() ? Timing::NoWakeup : std::max(earliest, wheel.GetTime())));
+
+			const uint64_t targetMs = wheel.GetTime() + uint64_t(random.Chance(3) ? random.Range(0, int64_t(Block) * 2) : random.Range(0, 3000));
+			wheel.Advance(targetMs, [&](uint32_t tag, TimerId id) {
+				++fired;
+				auto it = expected.find(id);
+				if (it == expected.end()) { isValid = false; return; }
+
+				// Fires exactly on its coalesced tick
+				Expected& timer = it->second;
+				isValid &= tag == timer.tag;
+				isValid &= wheel.GetTime() == timer.GetExpiry();
+				isValid &= wheel.GetTime() <= targetMs;
+				if (timer.periodMs) {
+					timer.deadlineMs += ((targetMs - timer.deadlineMs) / timer.periodMs + 1) * timer.periodMs;
+				}
+				else {
+					expected.erase(it);
+				}
+
+				// Callbacks change the wheel too
+				if (random.Chance(5)) { cancel(); }
+				if (random.Chance(5) and expected.size() < 1000) { schedule(); }
+			});
+
+			// Nothing was missed
+			for (const auto& entry : expected) { isValid &= entry.second.GetExpiry() > wheel.GetTime(); }
+			isValid &= wheel.GetTime() == targetMs;
+		}
+		isValid &= wheel.GetCount() == expected.size();
+	}
+
+	CHECK(isValid);
+	CHECK(fired > 10000);
+}
@@ -0,0 +1,326 @@
+// Cross-process trace ring: ordering, drops, the enabled flag and recovery
+// from a producer that claimed a slot and never published it, or was paused
+// inside its copy.
+
+// Implementation-specific headers
+#include "Harness.h"
+#include "Core/TraceRing.h"
+
+// Standard library headers
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Platform headers
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+	constexpr uint32_t Capacity = 64;
+
+	// Zeroed, suitably aligned block as a fresh mapping would be
+	struct Block
+	{
+		std::vector<uint64_t> memory = std::vector<uint64_t>(Trace::RequiredBytes(Capacity) / sizeof(uint64_t) + 1);
+		Trace::Ring ring = Trace::Ring::Create(memory.data(), Trace::RequiredBytes(Capacity), Capacity);
+	};
+
+	Trace::Record MakeRecord(uint32_t producer, uint64_t value)
+	{
+		Trace::Record record{};
+		record.threadId = producer;
+		record.wParam = value;
+		return record;
+	}
+
+	size_t DrainAll(Trace::Ring& ring, std::vector<Trace::Record>* pRecords = nullptr)
+	{
+		return ring.Drain([&](const Trace::Record& record) {
+			if (pRecords) { pRecords->push_back(record); }
+			});
+	}
+}
+
+TEST_CASE(AttachChecksTheFormat)
+{
+	Block block;
+	REQUIRE(block.ring.IsValid());
+	CHECK(Trace::Ring::Attach(block.memory.data(), Trace::RequiredBytes(Capacity)).IsValid());
+	CHECK(!Trace::Ring::Attach(block.memory.data(), sizeof(Trace::Header) - 1).IsValid());
+
+	reinterpret_cast<Trace::Header*>(block.memory.data())->version = Trace::Version - 1;
+	CHECK(!Trace::Ring::Attach(block.memory.data(), Trace::RequiredBytes(Capacity)).IsValid());
+}
+
+TEST_CASE(DisabledRingTakesNothing)
+{
+	Block block;
+	CHECK(!block.ring.IsEnabled());
+	CHECK(!block.ring.TryAppend(MakeRecord(1, 1)));
+	CHECK(DrainAll(block.ring) == 0);
+	CHECK(block.ring.TakeDropped() == 0);
+
+	// The flag lives in the block, so every attached view sees it
+	Trace::Ring producer = Trace::Ring::Attach(block.memory.data(), Trace::RequiredBytes(Capacity));
+	block.ring.SetEnabled(true);
+	CHECK(producer.IsEnabled());
+	CHECK(producer.TryAppend(MakeRecord(1, 1)));
+	block.ring.SetEnabled(false);
+	CHECK(!producer.TryAppend(MakeRecord(1, 2)));
+	CHECK(DrainAll(block.ring) == 1);
+}
+
+TEST_CASE(FullRingDropsAndCounts)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	for (uint64_t i{}; i < Capacity + 10; ++i) {
+		CHECK(block.ring.TryAppend(MakeRecord(1, i)) == (i < Capacity));
+	}
+	CHECK(block.ring.TakeDropped() == 10);
+	CHECK(block.ring.TakeDropped() == 0);
+
+	std::vector<Trace::Record> records;
+	CHECK(DrainAll(block.ring, &records) == Capacity);
+	for (uint64_t i{}; i < records.size(); ++i) { CHECK(records[i].wParam == i); }
+}
+
+TEST_CASE(ClearDiscardsStaleRecords)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	for (uint64_t i{}; i < Capacity + 3; ++i) { block.ring.TryAppend(MakeRecord(1, i)); }
+
+	block.ring.Clear();
+	CHECK(DrainAll(block.ring) == 0);
+	CHECK(block.ring.TakeDropped() == 0);
+
+	CHECK(block.ring.TryAppend(MakeRecord(1, 42)));
+	std::vector<Trace::Record> records;
+	REQUIRE(DrainAll(block.ring, &records) == 1);
+	CHECK(records[0].wParam == 42);
+}
+
+TEST_CASE(UnpublishedSlotIsSkippedAfterStallPasses)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	Trace::Header* pHeader = reinterpret_cast<Trace::Header*>(block.memory.data());
+
+	CHECK(block.ring.TryAppend(MakeRecord(1, 0)));
+	// A producer claims the next slot and dies before publishing it
+	pHeader->writeIndex.fetch_add(1);
+	CHECK(block.ring.TryAppend(MakeRecord(1, 2)));
+
+	std::vector<Trace::Record> records;
+	CHECK(DrainAll(block.ring, &records) == 1);
+	for (uint32_t pass{ 1 }; pass < Trace::Ring::StallPasses - 1; ++pass) {
+		CHECK(DrainAll(block.ring, &records) == 0);
+	}
+	CHECK(block.ring.TakeDropped() == 0);
+
+	// The last pass gives up on the slot and carries on behind it
+	CHECK(DrainAll(block.ring, &records) == 1);
+	REQUIRE(records.size() == 2);
+	CHECK(records[1].wParam == 2);
+	CHECK(block.ring.TakeDropped() == 1);
+
+	// The skipped slot is usable on the next lap
+	for (uint64_t i{}; i < Capacity; ++i) { CHECK(block.ring.TryAppend(MakeRecord(1, i))); }
+	CHECK(DrainAll(block.ring) == Capacity);
+}
+
+TEST_CASE(LateProducerLosesASkippedSlot)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	Trace::Header* pHeader = reinterpret_cast<Trace::Header*>(block.memory.data());
+	Trace::Slot* pSlots = reinterpret_cast<Trace::Slot*>(pHeader + 1);
+
+	// Claimed but unpublished: the consumer skips it
+	pHeader->writeIndex.fetch_add(1);
+	for (uint32_t pass{}; pass < Trace::Ring::StallPasses; ++pass) { DrainAll(block.ring); }
+	CHECK(pHeader->readIndex.load() == 1);
+
+	// The stalled producer wakes up; its publish must not resurrect the slot
+	uint64_t expected = 0;
+	CHECK(!pSlots[0].sequence.compare_exchange_strong(expected, 1));
+	CHECK(DrainAll(block.ring) == 0);
+}
+
+TEST_CASE(WriterSkippedMidCopyNeverTearsARecord)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	Trace::Header* pHeader = reinterpret_cast<Trace::Header*>(block.memory.data());
+	Trace::Slot* pSlots = reinterpret_cast<Trace::Slot*>(pHeader + 1);
+
+	// A producer claims slot 0, starts its copy and is paused half way
+	pHeader->writeIndex.fetch_add(1);
+	pSlots[0].sequence.fetch_or(Trace::SequenceWriting);
+	pSlots[0].record.wParam = 0xdead;
+	for (uint32_t pass{}; pass < Trace::Ring::StallPasses; ++pass) { DrainAll(block.ring); }
+	CHECK(pHeader->readIndex.load() == 1);
+	CHECK(block.ring.TakeDropped() == 1);
+
+	// The next lap reuses the slot while the paused copy may still land in it
+	for (uint64_t i{ 1 }; i <= Capacity; ++i) { REQUIRE(block.ring.TryAppend(MakeRecord(1, i))); }
+	pSlots[0].record.lParam = 0xdead;
+	std::vector<Trace::Record> records;
+	CHECK(DrainAll(block.ring, &records) == Capacity - 1);
+	CHECK(block.ring.TakeDropped() == 1);
+	for (const Trace::Record& record : records) { CHECK(record.lParam == 0); }
+
+	// Still inside its copy a lap later: the slot's record is dropped again
+	for (uint64_t i{}; i < Capacity; ++i) { REQUIRE(block.ring.TryAppend(MakeRecord(1, 100 + i))); }
+	records.clear();
+	CHECK(DrainAll(block.ring, &records) == Capacity - 1);
+	CHECK(block.ring.TakeDropped() == 1);
+	CHECK(records.back().wParam == 100 + Capacity - 2);
+
+	// The writer finishes its copy over the next lap's published record, finds
+	// the slot skipped and leaves: that record is dropped, later ones are clean
+	for (uint64_t i{}; i < Capacity; ++i) { REQUIRE(block.ring.TryAppend(MakeRecord(1, 300 + i))); }
+	const uint64_t sequence = pSlots[0].sequence.load();
+	REQUIRE((sequence & Trace::SequencePosition) == 3 * Capacity + 1);
+	REQUIRE((sequence & Trace::SequenceStale) == Trace::SequenceStaleUnit);
+	pSlots[0].record.lParam = 0xdead;
+	pSlots[0].sequence.store((sequence - Trace::SequenceStaleUnit) | Trace::SequenceOverlapped);
+	records.clear();
+	CHECK(DrainAll(block.ring, &records) == Capacity - 1);
+	CHECK(block.ring.TakeDropped() == 1);
+	for (const Trace::Record& record : records) { CHECK(record.lParam == 0); }
+
+	for (uint64_t i{}; i < Capacity; ++i) { REQUIRE(block.ring.TryAppend(MakeRecord(1, 400 + i))); }
+	records.clear();
+	CHECK(DrainAll(block.ring, &records) == Capacity);
+	CHECK(records.back().wParam == 400 + Capacity - 1);
+	CHECK(block.ring.TakeDropped() == 0);
+	CHECK((pSlots[0].sequence.load() & (Trace::SequenceStale | Trace::SequenceOverlapped)) == 0);
+}
+
+TEST_CASE(SlowProducerIsNotSkippedEarly)
+{
+	Block block;
+	block.ring.SetEnabled(true);
+	Trace::Header* pHeader = reinterpret_cast<Trace::Header*>(block.memory.data());
+	Trace::Slot* pSlots = reinterpret_cast<Trace::Slot*>(pHeader + 1);
+
+	pHeader->writeIndex.fetch_add(1);
+	for (uint32_t pass{ 1 }; pass < Trace::Ring::StallPasses; ++pass) { DrainAll(block.ring); }
+
+	// Publishes just before the consumer would give up
+	pSlots[0].record = MakeRecord(1, 7);
+	pSlots[0].sequence.store(1);
+
+	std::vector<Trace::Record> records;
+	REQUIRE(DrainAll(block.ring, &records) == 1);
+	CHECK(records[0].wParam == 7);
+	CHECK(block.ring.TakeDropped() == 0);
+}
+
+TEST_CASE(ConcurrentProducersKeepPerProducerOrder)
+{
+	constexpr uint32_t Producers = 4;
+	constexpr uint64_t PerProducer = 50000;
+
+	Block block;
+	block.ring.SetEnabled(true);
+
+	std::atomic<uint32_t> running{ Producers };
+	std::vector<std::thread> threads;
+	for (uint32_t producer{}; producer < Producers; ++producer) {
+		threads.emplace_back([&, producer]() {
+			Trace::Ring ring = Trace::Ring::Attach(block.memory.data(), Trace::RequiredBytes(Capacity));
+			for (uint64_t i{}; i < PerProducer; ++i) { ring.TryAppend(MakeRecord(producer, i)); }
+			running.fetch_sub(1);
+			});
+	}
+
+	std::vector<int64_t> last(Producers, -1);
+	uint64_t received{};
+	bool isOrdered{ true };
+	auto consume = [&](const Trace::Record& record) {
+		if (record.threadId >= Producers or int64_t(record.wParam) <= last[record.threadId]) {
+			isOrdered = false;
+			return;
+		}
+		last[record.threadId] = int64_t(record.wParam);
+		++received;
+	};
+	while (running.load() > 0) { block.ring.Drain(consume); }
+	for (std::thread& thread : threads) { thread.join(); }
+	block.ring.Drain(consume);
+
+	CHECK(isOrdered);
+	CHECK(received + block.ring.TakeDropped() == Producers * PerProducer);
+}
+
+TEST_CASE(ForkedProducersShareTheMapping)
+{
+	constexpr uint32_t Producers = 4;
+	constexpr uint64_t PerProducer = 20000;
+
+	// A shared anonymous mapping is zeroed, like the named section TabTap creates
+	constexpr size_t Bytes = Trace::RequiredBytes(Capacity);
+	void* pBlock = mmap(nullptr, Bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	REQUIRE(pBlock != MAP_FAILED);
+	Trace::Ring ring = Trace::Ring::Create(pBlock, Bytes, Capacity);
+	REQUIRE(ring.IsValid());
+	ring.SetEnabled(true);
+
+	std::vector<pid_t> children;
+	for (uint32_t producer{}; producer < Producers; ++producer) {
+		const pid_t pid = fork();
+		REQUIRE(pid >= 0);
+		if (pid == 0) {
+			Trace::Ring child = Trace::Ring::Attach(pBlock, Bytes);
+			if (!child.IsValid()) { _exit(1); }
+			for (uint64_t i{}; i < PerProducer; ++i) {
+				Trace::Record record = MakeRecord(producer, i);
+				record.processId = uint32_t(getpid());
+				record.lParam = ~i;
+				record.message = producer * 7 + 1;
+				// Back off from a full ring so the consumer keeps up with some of them
+				if (!child.TryAppend(record)) { sched_yield(); }
+			}
+			_exit(0);
+		}
+		children.push_back(pid);
+	}
+
+	std::vector<int64_t> last(Producers, -1);
+	uint64_t received{};
+	bool isOrdered{ true };
+	bool isWhole{ true };
+	auto consume = [&](const Trace::Record& record) {
+		if (record.threadId >= Producers or int64_t(record.wParam) <= last[record.threadId]) {
+			isOrdered = false;
+			return;
+		}
+		isWhole = isWhole and record.lParam == ~record.wParam and
+			record.message == record.threadId * 7 + 1 and record.processId == uint32_t(children[record.threadId]);
+		last[record.threadId] = int64_t(record.wParam);
+		++received;
+	};
+
+	size_t running = children.size();
+	while (running) {
+		ring.Drain(consume);
+		int status{};
+		while (running and waitpid(-1, &status, WNOHANG) > 0) {
+			CHECK(WIFEXITED(status) and WEXITSTATUS(status) == 0);
+			--running;
+		}
+	}
+	ring.Drain(consume);
+
+	CHECK(isOrdered);
+	CHECK(isWhole);
+	CHECK(received > 0);
+	CHECK(received + ring.TakeDropped() == Producers * PerProducer);
+	munmap(pBlock, Bytes);
+}
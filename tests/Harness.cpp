@@ -0,0 +1,41 @@
+// Implementation-specific headers
+#include "Harness.h"
+
+
+
+namespace
+{
+	int checkFailures{};
+}
+
+std::vector<Test::Case>& Test::GetCases()
+{
+	static std::vector<Case> cases{};
+	return cases;
+}
+
+bool Test::Check(bool isPassed, const char* pszExpr, const char* pszFile, int line)
+{
+	if (!isPassed) {
+		++checkFailures;
+		std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", pszFile, line, pszExpr);
+	}
+	return isPassed;
+}
+
+int main()
+{
+	int failedCases{};
+
+	for (const Test::Case& testCase : Test::GetCases()) {
+		const int failuresBefore = checkFailures;
+		testCase.run();
+
+		const bool isPassed = checkFailures == failuresBefore;
+		if (!isPassed) { ++failedCases; }
+		std::printf("[%s] %s\n", isPassed ? " OK " : "FAIL", testCase.pszName);
+	}
+
+	std::printf("%zu cases, %d failed\n", Test::GetCases().size(), failedCases);
+	return failedCases ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Standard library headers
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+
+
+// Minimal test harness for the portable Core headers.
+// TEST_CASE registers a function that main (Harness.cpp) runs in file
+// order; CHECK records a failure and carries on, REQUIRE returns from the
+// case. A test executable exits non-zero if any check failed.
+namespace Test
+{
+	using CaseFunc = void (*)();
+
+	struct Case
+	{
+		const char* pszName{};
+		CaseFunc run{};
+	};
+
+	std::vector<Case>& GetCases();
+
+	struct Registrar
+	{
+		Registrar(const char* pszName, CaseFunc run) { GetCases().push_back({ pszName, run }); }
+	};
+
+	/// Records the outcome of a check; returns `isPassed`
+	bool Check(bool isPassed, const char* pszExpr, const char* pszFile, int line);
+
+	/// Small deterministic generator (xorshift64*) so failures reproduce
+	class Random
+	{
+	private:
+		uint64_t state;
+
+	public:
+		explicit Random(uint64_t seed = 0x9E3779B97F4A7C15ull) :
+			state{ seed ? seed : 1 }
+		{}
+
+		uint64_t Next()
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 2685821657736338717ull;
+		}
+
+		/// Uniform in [low, high]
+		int64_t Range(int64_t low, int64_t high)
+		{
+			return low + int64_t(Next() % uint64_t(high - low + 1));
+		}
+
+		bool Chance(uint32_t percent) { return Next() % 100 < percent; }
+	};
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const Test::Registrar name##Registrar{ #name, name }; \
+	static void name()
+
+// Variadic so braced initialisers with commas need no extra parentheses
+#define CHECK(...) Test::Check(bool(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+#define REQUIRE(...) do { if (!CHECK(__VA_ARGS__)) { return; } } while (false)
@@ -0,0 +1,91 @@
+#pragma once
+
+// Implementation-specific headers
+#include "Core/DirectoryWatcher.h"
+
+// Standard library headers
+#include <atomic>
+#include <thread>
+
+// Linux system headers
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+
+// inotify-backed IDirectoryWatcher, the Linux counterpart of the Win32
+// DirectoryWatcher in UIComponents. Reports the same kinds of change
+// (file name, size and last write) so SkinReloader sees the same bursts.
+class InotifyWatcher : public IDirectoryWatcher
+{
+private:
+	int notifyFd{ -1 };
+	int stopFd{ -1 };                  // eventfd that wakes the thread to exit
+	std::thread worker{};
+	std::atomic<bool> isRunning{};
+
+private:
+	void WatchLoop(ChangeCallback callback)
+	{
+		alignas(inotify_event) char buffer[4096];
+		pollfd fds[2]{ { notifyFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+
+		while (poll(fds, 2, -1) >= 0) {
+			if (fds[1].revents) { return; }
+			if (!(fds[0].revents & POLLIN)) { continue; }
+
+			// One callback per read; the reloader only needs to know something changed
+			if (read(notifyFd, buffer, sizeof(buffer)) > 0) { callback(); }
+		}
+	}
+
+public:
+	~InotifyWatcher() override
+	{
+		Stop();
+	}
+
+	InotifyWatcher() = default;
+	InotifyWatcher(const InotifyWatcher&) = delete;
+	InotifyWatcher& operator=(const InotifyWatcher&) = delete;
+
+	bool Start(const std::filesystem::path& directory, ChangeCallback callback) override
+	{
+		if (isRunning or !callback) { return false; }
+
+		notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (notifyFd < 0 or stopFd < 0 or
+			inotify_add_watch(notifyFd, directory.c_str(),
+				IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM) < 0) {
+			Stop();
+			return false;
+		}
+
+		isRunning = true;
+		worker = std::thread{ &InotifyWatcher::WatchLoop, this, std::move(callback) };
+		return true;
+	}
+
+	void Stop() override
+	{
+		if (stopFd >= 0) {
+			const uint64_t one{ 1 };
+			(void)!write(stopFd, &one, sizeof(one));
+		}
+		if (worker.joinable()) { worker.join(); }
+
+		if (notifyFd >= 0) { close(notifyFd); }
+		if (stopFd >= 0) { close(stopFd); }
+		notifyFd = -1;
+		stopFd = -1;
+		isRunning = false;
+	}
+
+	bool IsRunning() const override
+	{
+		return isRunning;
+	}
+};
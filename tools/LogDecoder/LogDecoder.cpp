@@ -0,0 +1,183 @@
+// Decodes binary TabTap logs written by Logging::AsyncLogger into text.
+//
+//   LogDecoder <file.log> [...]
+//
+// Rotated copies (TabTap.log.1, ...) are separate files; pass them oldest
+// first to read a continuous history. Each line shows the wall-clock time,
+// logger thread index, level, source location and the formatted message.
+
+// Implementation-specific headers
+#include "../../src/Core/LogFormat.h"
+
+// Standard library headers
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace
+{
+	struct SiteInfo
+	{
+		Logging::Level level{};
+		std::string file{};
+		uint32_t line{};
+		std::string format{};
+	};
+
+	template <typename ValueTy>
+	bool ReadStruct(const std::vector<uint8_t>& data, size_t offset, ValueTy* pValue)
+	{
+		if (offset + sizeof(ValueTy) > data.size()) { return false; }
+		std::memcpy(pValue, data.data() + offset, sizeof(ValueTy));
+		return true;
+	}
+
+	// Strips the directory from a compile-time __FILE__ path
+	std::string BaseName(const std::string& path)
+	{
+		const size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? path : path.substr(slash + 1);
+	}
+
+	// Formats steady-clock nanoseconds as local wall-clock time
+	std::string FormatTime(const Logging::FileHeader& header, uint64_t steadyNs)
+	{
+		const int64_t wallNs = header.wallOriginNs + int64_t(steadyNs - header.steadyOriginNs);
+		const std::time_t seconds = std::time_t(wallNs / 1000000000);
+		const long micros = long((wallNs % 1000000000) / 1000);
+
+		std::tm local{};
+#ifdef _WIN32
+		localtime_s(&local, &seconds);
+#else
+		localtime_r(&seconds, &local);
+#endif
+		char text[48];
+		const size_t length = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+		std::snprintf(text + length, sizeof(text) - length, ".%06ld", micros);
+		return text;
+	}
+
+	bool DecodeFile(const char* path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot open\n", path);
+			return false;
+		}
+		const std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+
+		Logging::FileHeader header{};
+		if (!ReadStruct(data, 0, &header) or header.magic != Logging::FileMagic) {
+			std::fprintf(stderr, "%s: not a TabTap log\n", path);
+			return false;
+		}
+		if (header.version != Logging::FileVersion) {
+			std::fprintf(stderr, "%s: unsupported version %u\n", path, header.version);
+			return false;
+		}
+
+		std::unordered_map<uint32_t, SiteInfo> sites{};
+		size_t offset = sizeof(header);
+
+		while (offset < data.size()) {
+			Logging::ChunkHeader chunk{};
+			if (!ReadStruct(data, offset, &chunk) or
+				offset + sizeof(chunk) + chunk.size > data.size())
+			{
+				std::fprintf(stderr, "%s: truncated at offset %zu\n", path, offset);
+				return false;
+			}
+
+			const size_t payload = offset + sizeof(chunk);
+			offset = payload + chunk.size;
+
+			switch (Logging::ChunkType(chunk.type))
+			{
+			case Logging::ChunkType::Site:
+			{
+				Logging::SiteChunk site{};
+				if (!ReadStruct(data, payload, &site) or
+					sizeof(site) + site.fileLength + site.formatLength > chunk.size)
+				{
+					break;
+				}
+				const char* pText = reinterpret_cast<const char*>(data.data() + payload + sizeof(site));
+				sites[site.id] = {
+					Logging::Level(site.level),
+					BaseName({ pText, site.fileLength }),
+					site.line,
+					{ pText + site.fileLength, site.formatLength }
+				};
+				break;
+			}
+
+			case Logging::ChunkType::Record:
+			{
+				Logging::RecordChunk record{};
+				if (chunk.size < sizeof(record) or !ReadStruct(data, payload, &record)) { break; }
+
+				const auto it = sites.find(record.siteId);
+				const uint8_t* pArgs = data.data() + payload + sizeof(record);
+				const size_t argsLength = chunk.size - sizeof(record);
+
+				std::string message{};
+				if (it == sites.end()) {
+					message = "<unknown site " + std::to_string(record.siteId) + ">";
+				}
+				else if (!Logging::RenderMessage(it->second.format.data(), it->second.format.size(),
+					pArgs, argsLength, &message))
+				{
+					message += " <malformed arguments>";
+				}
+
+				std::printf("%s [%2u] %-5s %s:%u  %s\n",
+					FormatTime(header, record.time).c_str(),
+					record.threadId,
+					it == sites.end() ? "?" : Logging::GetLevelName(it->second.level),
+					it == sites.end() ? "?" : it->second.file.c_str(),
+					it == sites.end() ? 0u : it->second.line,
+					message.c_str());
+				break;
+			}
+
+			case Logging::ChunkType::Dropped:
+			{
+				Logging::DroppedChunk dropped{};
+				if (chunk.size < sizeof(dropped) or !ReadStruct(data, payload, &dropped)) { break; }
+				std::printf("%26s [%2u] dropped %llu records (thread buffer full)\n",
+					"", dropped.threadId, (unsigned long long)dropped.count);
+				break;
+			}
+
+			default:
+				break;  // Unknown chunk types from newer writers are skipped
+			}
+		}
+
+		return true;
+	}
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::fprintf(stderr, "Usage: LogDecoder <file.log> [...]\n");
+		return 2;
+	}
+
+	int exitCode = 0;
+	for (int i = 1; i < argc; ++i) {
+		if (!DecodeFile(argv[i])) { exitCode = 1; }
+	}
+	return exitCode;
+}
@@ -0,0 +1,897 @@
+// Replays a TabTap.replay session (recorded with `TabTap.exe --record`)
+// against the tab window logic, with a fake window, clock and work area.
+//
+//   Replay [--iterations <n>] [--no-timing] [--check-prediction] <session.replay>
+//
+// The model mirrors the tab's WindowProc handlers and uses the same
+// TabLayout, GroupLayout and PointerPredictor code as TabTap. Messages that
+// an outer handler sent (depth > 0) and animation steps are not read from the
+// file; the model issues them itself so changed logic changes their count.
+//
+// Redraws compose a synthetic tab image on the headless render backend, so
+// the Render row times the software compositor and the frame hash changes
+// whenever the composed pixels do.
+//
+// Output: per-message handler cost (best of all iterations), then the window
+// moves, redraws, last frame and final geometry. The second part is
+// deterministic, so builds can be compared with a plain diff when run with
+// --no-timing.
+//
+// The predict line drives PointerPredictor through every right-button drag in
+// the recording and compares where the tab is drawn with where the pointer
+// is one horizon later, unpredicted (last sample) -> predicted: mean and p95
+// distance, and the lag, i.e. how long ago the pointer was where the tab is
+// drawn. --check-prediction fails the run if prediction does not beat the
+// last sample on both.
+
+// Implementation-specific headers
+#include "../../src/Core/ReplayFormat.h"
+#include "../../src/Core/TabLayout.h"
+#include "../../src/Core/GroupLayout.h"
+#include "../../src/Core/PointerPredictor.h"
+#include "../../src/Core/RenderBackend.h"
+#include "../../src/Core/SettingChange.h"
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+
+namespace
+{
+	// One recorded event with the environment in effect for it
+	struct Step
+	{
+		Replay::EventRecord event{};
+		Replay::Environment environment{};
+		bool hasEnvironment{};       // Environment changed before this event
+	};
+
+	struct Session
+	{
+		Replay::FileHeader header{};
+		Replay::Environment initial{};
+		std::vector<Step> steps{};
+	};
+
+	// Handler ids reported in the cost table (messages plus model-issued steps)
+	enum class Handler
+	{
+		MouseMove, MouseLeave, LButtonDown, LButtonUp, RButtonDown, RButtonUp,
+		RButtonDblClk, MButtonDown, MButtonUp, SettingChange, SyncPosition,
+		Animation, Render, Count
+	};
+
+	const char* GetHandlerName(Handler handler)
+	{
+		static constexpr const char* names[] = {
+			"MouseMove", "MouseLeave", "LButtonDown", "LButtonUp", "RButtonDown", "RButtonUp",
+			"RButtonDblClk", "MButtonDown", "MButtonUp", "SettingChange", "SyncPosition",
+			"Animation", "Render"
+		};
+		return names[size_t(handler)];
+	}
+
+	struct Cost
+	{
+		uint64_t calls{};
+		uint64_t totalNs{};
+		uint64_t maxNs{};
+	};
+
+	// Window system side effects issued by the model
+	struct Counters
+	{
+		uint64_t tabMoves{};         // Tab window position or size changes
+		uint64_t oskMoves{};         // OSK window position changes
+		uint64_t previewMoves{};     // Snap preview window updates
+		uint64_t redraws{};          // Layered window redraws
+		uint64_t blinks{};           // Blink effects started
+		uint64_t oskShows{};
+		uint64_t oskHides{};
+		uint64_t skipped{};          // Nested records issued by the model instead
+		uint64_t settingChanges{};   // WM_SETTINGCHANGE the tab reads
+		uint64_t settingPasses{};    // Passes run for settled bursts
+	};
+
+	bool ReadSession(const char* path, Session* pSession)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot open\n", path);
+			return false;
+		}
+		const std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+
+		if (data.size() < sizeof(Replay::FileHeader)) {
+			std::fprintf(stderr, "%s: not a TabTap session\n", path);
+			return false;
+		}
+		std::memcpy(&pSession->header, data.data(), sizeof(Replay::FileHeader));
+		if (pSession->header.magic != Replay::FileMagic) {
+			std::fprintf(stderr, "%s: not a TabTap session\n", path);
+			return false;
+		}
+		if (pSession->header.version != Replay::FileVersion) {
+			std::fprintf(stderr, "%s: unsupported version %u\n", path, pSession->header.version);
+			return false;
+		}
+
+		Replay::Environment environment{};
+		bool hasEnvironment{};
+		bool hasInitial{};
+		size_t offset = sizeof(Replay::FileHeader);
+
+		while (offset + sizeof(Replay::RecordHeader) <= data.size()) {
+			Replay::RecordHeader record{};
+			std::memcpy(&record, data.data() + offset, sizeof(record));
+			const size_t payload = offset + sizeof(record);
+			if (payload + record.size > data.size()) {
+				std::fprintf(stderr, "%s: truncated at offset %zu\n", path, offset);
+				break;  // Keep what was read; the session may have been cut off
+			}
+			offset = payload + record.size;
+
+			if (Replay::RecordType(record.type) == Replay::RecordType::Environment and
+				record.size >= sizeof(Replay::EnvironmentRecord))
+			{
+				Replay::EnvironmentRecord env{};
+				std::memcpy(&env, data.data() + payload, sizeof(env));
+				environment.workArea = Replay::FromRect32(env.workArea);
+				environment.oskRect = Replay::FromRect32(env.oskRect);
+				environment.screen = { env.screenWidth, env.screenHeight };
+				environment.isOskVisible = env.isOskVisible != 0;
+				hasEnvironment = true;
+
+				if (!hasInitial) {
+					pSession->initial = environment;
+					hasInitial = true;
+				}
+			}
+			else if (Replay::RecordType(record.type) == Replay::RecordType::Event and
+				record.size >= sizeof(Replay::EventRecord))
+			{
+				Step step{};
+				std::memcpy(&step.event, data.data() + payload, sizeof(step.event));
+				step.environment = environment;
+				step.hasEnvironment = hasEnvironment;
+				hasEnvironment = false;
+				pSession->steps.push_back(step);
+			}
+			// Unknown record types from newer writers are skipped
+		}
+
+		if (!hasInitial) {
+			std::fprintf(stderr, "%s: no environment record\n", path);
+			return false;
+		}
+		return true;
+	}
+
+
+
+	// Runs one handler and records its cost
+	template <typename FuncTy>
+	void Measure(Cost* pCosts, Handler handler, FuncTy func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const uint64_t elapsed = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count());
+
+		Cost& cost = pCosts[size_t(handler)];
+		++cost.calls;
+		cost.totalNs += elapsed;
+		cost.maxNs = std::max(cost.maxNs, elapsed);
+	}
+
+	// Premultiplied stand-in for TabTap.png (expanded size, opaque edge strip)
+	const Render::ImageView& GetTabImage()
+	{
+		static std::vector<Render::Pixel> pixels{};
+		static Render::ImageView view{};
+
+		if (pixels.empty()) {
+			const Geometry::Size size = TabLayout::ExpandedSize;
+			pixels.resize(size_t(size.cx) * size_t(size.cy));
+
+			for (long y{}; y < size.cy; ++y) {
+				for (long x{}; x < size.cx; ++x) {
+					const uint32_t a = (x >= size.cx - TabLayout::CollapsedSize.cx) ? 255 : 96 + uint32_t(y * 159 / size.cy);
+					const uint32_t r = uint32_t(x * 9) * a / 255;
+					const uint32_t g = uint32_t(y * 2) * a / 255;
+					const uint32_t b = 0xc0 * a / 255;
+					pixels[size_t(y) * size_t(size.cx) + size_t(x)] = (a << 24) | (r << 16) | (g << 8) | b;
+				}
+			}
+			view = { pixels.data(), size.cx, size.cy, size.cx };
+		}
+		return view;
+	}
+
+
+
+	// Tab window logic over fake windows (mirrors WindowProc in TabTap.cpp)
+	class TabModel
+	{
+	private:
+		// --- MainWindow ---
+		Geometry::Rect tabRect{};
+		TabLayout::Edge edge{};
+		bool isExpanded{};
+		bool isLinkedDrag{};
+		bool hasSkin{};
+
+		// --- Environment ---
+		Replay::Environment live{};          // What the system reports right now
+		Geometry::Rect workArea{};           // WorkAreaManager copy (refreshed explicitly)
+
+		// --- WindowDragger / DragPredictor ---
+		bool isDragging{};
+		Geometry::Point dragStart{};         // Cursor minus window origin
+		PointerPredictor dragPredictor{};
+
+		// --- EdgeSnapData ---
+		bool isSnapping{};
+		bool isPreview{};
+		Geometry::Rect snapRect{};
+		Geometry::Point snapStart{};
+		Geometry::Point snapCursor{};
+		TabLayout::Edge snapEdge{};
+
+		// --- AnimationData ---
+		bool isAnimating{};
+		Geometry::Point animCurrent{};
+		Geometry::Point animTarget{};
+
+		// --- WM_SETTINGCHANGE ---
+		Settings::Coalescer settings{};
+
+		// --- DrawContext ---
+		Render::HeadlessBackend renderer{};
+		Cost* pCosts{};                      // Receives the Render row
+
+		Geometry::Point cursor{};
+		uint32_t timeMs{};
+
+	public:
+		Counters counters{};
+		GroupLayout::MoveCounter dragMoves{};
+
+	private:
+		Geometry::Size GetSize() const
+		{
+			return isExpanded ? TabLayout::ExpandedSize : TabLayout::CollapsedSize;
+		}
+
+		// DrawContext::DrawImageOnLayeredWindow (PNG path) on the headless backend
+		void Redraw()
+		{
+			++counters.redraws;
+			if (!pCosts) { return; }
+
+			Measure(pCosts, Handler::Render, [&] {
+				const Geometry::Size size = GetSize();
+				renderer.CreateSurface(size);
+				renderer.Compose(Render::MakeTabLayer(GetTabImage(), size,
+					isExpanded, edge == TabLayout::Edge::Right, nullptr));
+				renderer.Present(tabRect.TopLeft(), 0xff);
+				});
+		}
+
+		void MoveTab(const Geometry::Point& pt)
+		{
+			tabRect = Geometry::MakeRect(pt, GetSize());
+			++counters.tabMoves;
+		}
+
+		void MoveOsk(long top)
+		{
+			live.oskRect = Geometry::MakeRect({ live.oskRect.left, top }, live.oskRect.GetSize());
+			++counters.oskMoves;
+		}
+
+		// MainWindow::SetPosition
+		void SetPosition(const Geometry::Point& pt)
+		{
+			const long top = TabLayout::ClampPoint(pt, GetSize(), workArea).y;
+			MoveTab({ tabRect.left, top });
+		}
+
+		// MainWindow::SetDragPosition
+		void SetDragPosition(const Geometry::Point& pt)
+		{
+			if (!isLinkedDrag) {
+				SetPosition(pt);
+				dragMoves.RecordFrame(1);
+				return;
+			}
+
+			const GroupLayout::Placement placement = GroupLayout::SolveLinkedDrag(
+				pt, tabRect, live.oskRect, workArea, live.isOskVisible);
+			if (placement.moveTab) { MoveTab(placement.tab); }
+			if (placement.moveOsk) { MoveOsk(placement.osk.y); }
+			dragMoves.RecordFrame(placement.moveTab + placement.moveOsk);
+		}
+
+		// MainWindow::SetExpansionState
+		void SetExpanded(bool expanded)
+		{
+			isExpanded = expanded;
+			const long x = TabLayout::EdgeLeft(edge, live.screen.cx, GetSize().cx);
+			MoveTab({ x, tabRect.top });
+		}
+
+		// MainWindow::SetSnapEdge
+		bool SetSnapEdge(TabLayout::Edge newEdge)
+		{
+			if ((newEdge != TabLayout::Edge::Left and newEdge != TabLayout::Edge::Right) or
+				!TabLayout::IsFreeEdge(newEdge, workArea, live.screen))
+			{
+				return false;
+			}
+
+			const long x = TabLayout::EdgeLeft(newEdge, live.screen.cx, GetSize().cx);
+			MoveTab(TabLayout::ClampPoint({ x, tabRect.top }, GetSize(), workArea));
+			edge = newEdge;
+			return true;
+		}
+
+		Geometry::Point PredictLead()
+		{
+			dragPredictor.AddSample({ cursor.x, cursor.y, timeMs });
+			const PointerPredictor::Offset offset = dragPredictor.Predict(timeMs);
+			return { offset.dx, offset.dy };
+		}
+
+	public:
+		void Reset(const Session& session, Cost* pCostTable)
+		{
+			*this = {};
+			pCosts = pCostTable;
+			tabRect = Replay::FromRect32(session.header.tabRect);
+			edge = TabLayout::Edge(session.header.edge);
+			isExpanded = session.header.isExpanded != 0;
+			isLinkedDrag = session.header.isLinkedDrag != 0;
+			hasSkin = session.header.hasSkin != 0;
+			live = session.initial;
+			workArea = live.workArea;
+		}
+
+		// Applies the recorded system state before an event
+		void SetEnvironment(const Replay::Environment& env)
+		{
+			live = env;
+		}
+
+		void SetInput(const Geometry::Point& pt, uint64_t timeNs)
+		{
+			cursor = pt;
+			timeMs = uint32_t(timeNs / 1000000);
+		}
+
+		bool IsAnimating() const { return isAnimating; }
+
+		// --- Message handlers ---
+
+		void OnMouseMove()
+		{
+			if (isDragging) {
+				const Geometry::Point lead = PredictLead();
+				SetDragPosition({
+					cursor.x - dragStart.x + lead.x,
+					cursor.y - dragStart.y + lead.y
+				});
+				return;
+			}
+
+			if (isSnapping) {
+				snapCursor = cursor;
+				if (isPreview) {
+					snapEdge = TabLayout::DetectSnapEdge(cursor, workArea, edge);
+					++counters.previewMoves;
+				}
+				else if (!snapRect.Contains(cursor)) {
+					isPreview = true;
+				}
+				return;
+			}
+
+			if (!isExpanded) {
+				SetExpanded(true);
+				Redraw();
+			}
+		}
+
+		void OnMouseLeave()
+		{
+			if (!isDragging and !isSnapping and isExpanded) {
+				SetExpanded(false);
+				Redraw();
+			}
+		}
+
+		void OnLButtonDown()
+		{
+			workArea = live.workArea;
+
+			snapRect = tabRect;
+			snapStart = cursor;
+			snapCursor = {};
+			snapEdge = TabLayout::Edge::None;
+			isSnapping = true;
+			isPreview = false;
+
+			if (hasSkin) { Redraw(); }
+		}
+
+		void OnLButtonUp()
+		{
+			if (isSnapping) {
+				const bool wasPreview = isPreview;
+				const Geometry::Point dest{
+					snapRect.left + snapCursor.x - snapStart.x,
+					snapRect.top + snapCursor.y - snapStart.y
+				};
+
+				if (snapEdge != TabLayout::Edge::None) {
+					if (SetSnapEdge(snapEdge)) {
+						SetPosition(dest);
+					}
+					else {
+						++counters.blinks;
+					}
+				}
+				isSnapping = false;
+				isPreview = false;
+
+				if (wasPreview) {
+					Redraw();
+					return;
+				}
+				if (hasSkin) { Redraw(); }
+			}
+
+			if (live.isOskVisible) {
+				live.isOskVisible = false;
+				++counters.oskHides;
+			}
+			else {
+				MoveOsk(TabLayout::OskSyncTop(tabRect, live.oskRect.Height(), workArea));
+				live.isOskVisible = true;
+				++counters.oskShows;
+			}
+		}
+
+		void OnRButtonDown()
+		{
+			workArea = live.workArea;
+			isDragging = true;
+			dragStart = { cursor.x - tabRect.left, cursor.y - tabRect.top };
+			dragPredictor.Reset();
+			if (hasSkin) { Redraw(); }
+		}
+
+		void OnRButtonUp()
+		{
+			isDragging = false;
+			dragPredictor.Reset();
+			if (hasSkin) { Redraw(); }
+		}
+
+		void OnSettingChange(Replay::SettingKind kind, uint64_t nowMs)
+		{
+			const uint8_t changes = kind == Replay::SettingKind::Theme ? Settings::ChangeTheme
+				: kind == Replay::SettingKind::WorkArea ? Settings::ChangeLayout
+				: Settings::ChangeNone;
+			if (settings.Add(changes, nowMs)) { ++counters.settingChanges; }
+		}
+
+		/// Returns when the pending setting pass is due (Settings::NoDeadline if none)
+		uint64_t GetSettingDeadline() const { return settings.GetDeadline(); }
+
+		// IDT_SETTINGS_SETTLE: the merged pass (the theme has nothing to model)
+		void OnSettingsSettled()
+		{
+			const uint8_t changes = settings.Flush();
+			if (!changes) { return; }
+			++counters.settingPasses;
+			if (!(changes & Settings::ChangeLayout)) { return; }
+
+			workArea = live.workArea;
+
+			auto UpdatePosition = [&](TabLayout::Edge newEdge) {
+				SetSnapEdge(newEdge);
+				++counters.blinks;
+				Redraw();
+				};
+
+			const TabLayout::Edge newEdge = TabLayout::ResolveWorkAreaChange(edge, workArea, live.screen);
+			if (newEdge != TabLayout::Edge::None) {
+				UpdatePosition(newEdge);
+			}
+			else if (TabLayout::ClampPoint(tabRect.TopLeft(), GetSize(), workArea).y != tabRect.top) {
+				UpdatePosition(edge);
+			}
+		}
+
+		void OnSyncPosition()
+		{
+			const long top = TabLayout::SyncTop(live.oskRect, GetSize().cy, workArea);
+
+			// Collapse if the cursor moved away (sent WM_MOUSELEAVE)
+			if (cursor.y < top or cursor.y > top + GetSize().cy) {
+				OnMouseLeave();
+			}
+
+			if (isAnimating) { return; }
+
+			workArea = live.workArea;
+			animCurrent = tabRect.TopLeft();
+			animTarget = TabLayout::ClampPoint({ tabRect.left, top }, tabRect.GetSize(), workArea);
+			isAnimating = true;
+		}
+
+		// One animation frame; returns false when the animation finished
+		bool OnAnimation()
+		{
+			if (!isAnimating) { return false; }
+
+			if (animCurrent == animTarget) {
+				isAnimating = false;
+				return false;
+			}
+
+			animCurrent = TabLayout::StepToward(animCurrent, animTarget);
+			tabRect = Geometry::MakeRect(animCurrent, tabRect.GetSize());
+			++counters.tabMoves;
+			return true;
+		}
+
+		// --- Results ---
+
+		void PrintFrame() const
+		{
+			const Render::ImageView frame = renderer.GetPixels();
+			std::printf("frame      %ldx%ld at %ld,%ld hash %08x\n",
+				frame.width, frame.height, renderer.GetPosition().x, renderer.GetPosition().y,
+				Render::HashPixels(frame));
+		}
+
+		void PrintGeometry() const
+		{
+			static constexpr const char* edgeNames[] = { "none", "left", "right", "top", "bottom" };
+			std::printf("tab        %ld,%ld %ldx%ld %s %s\n",
+				tabRect.left, tabRect.top, tabRect.Width(), tabRect.Height(),
+				edgeNames[size_t(edge)], isExpanded ? "expanded" : "collapsed");
+			std::printf("osk        %ld,%ld %ldx%ld %s\n",
+				live.oskRect.left, live.oskRect.top, live.oskRect.Width(), live.oskRect.Height(),
+				live.isOskVisible ? "visible" : "hidden");
+		}
+	};
+
+
+
+	void Run(const Session& session, TabModel* pModel, Cost* pCosts)
+	{
+		pModel->Reset(session, pCosts);
+
+		for (const Step& step : session.steps) {
+			// A settled setting burst runs its pass before the next event (and its environment)
+			if (step.event.time / 1000000 >= pModel->GetSettingDeadline()) {
+				Measure(pCosts, Handler::SettingChange, [&] { pModel->OnSettingsSettled(); });
+			}
+
+			if (step.hasEnvironment) { pModel->SetEnvironment(step.environment); }
+			pModel->SetInput({ step.event.x, step.event.y }, step.event.time);
+
+			// Sent by an outer handler that the model already ran
+			if (step.event.depth) {
+				++pModel->counters.skipped;
+				continue;
+			}
+
+			const Replay::Message message = Replay::Message(step.event.message);
+			switch (message)
+			{
+			case Replay::Message::MouseMove:
+				Measure(pCosts, Handler::MouseMove, [&] { pModel->OnMouseMove(); });
+				break;
+			case Replay::Message::MouseLeave:
+				Measure(pCosts, Handler::MouseLeave, [&] { pModel->OnMouseLeave(); });
+				break;
+			case Replay::Message::LButtonDown:
+				Measure(pCosts, Handler::LButtonDown, [&] { pModel->OnLButtonDown(); });
+				break;
+			case Replay::Message::LButtonUp:
+				Measure(pCosts, Handler::LButtonUp, [&] { pModel->OnLButtonUp(); });
+				break;
+			case Replay::Message::RButtonDown:
+				Measure(pCosts, Handler::RButtonDown, [&] { pModel->OnRButtonDown(); });
+				break;
+			case Replay::Message::RButtonUp:
+				Measure(pCosts, Handler::RButtonUp, [&] { pModel->OnRButtonUp(); });
+				break;
+			case Replay::Message::RButtonDblClk:
+				// Posts SyncPosition, which is recorded as its own event
+				Measure(pCosts, Handler::RButtonDblClk, [] {});
+				break;
+			case Replay::Message::MButtonDown:
+				Measure(pCosts, Handler::MButtonDown, [] {});
+				break;
+			case Replay::Message::MButtonUp:
+				Measure(pCosts, Handler::MButtonUp, [&] { pModel->OnLButtonUp(); });
+				break;
+			case Replay::Message::SettingChange:
+				Measure(pCosts, Handler::SettingChange, [&] {
+					pModel->OnSettingChange(Replay::SettingKind(step.event.detail), step.event.time / 1000000);
+					});
+				break;
+			case Replay::Message::SyncPosition:
+				Measure(pCosts, Handler::SyncPosition, [&] { pModel->OnSyncPosition(); });
+				break;
+			default:
+				continue;
+			}
+
+			// Run the animation frames before the next input
+			bool isRunning = pModel->IsAnimating();
+			while (isRunning) {
+				Measure(pCosts, Handler::Animation, [&] { isRunning = pModel->OnAnimation(); });
+			}
+		}
+
+		// The timer would still fire for a burst at the end of the recording
+		if (pModel->GetSettingDeadline() != Settings::NoDeadline) {
+			Measure(pCosts, Handler::SettingChange, [&] { pModel->OnSettingsSettled(); });
+		}
+	}
+
+	// --- Prediction check ---
+
+	struct TracePoint
+	{
+		double timeMs{};
+		double x{};
+		double y{};
+	};
+
+	// Cursor samples of one right-button drag, button down to button up
+	using DragTrace = std::vector<TracePoint>;
+
+	struct PredictionStats
+	{
+		size_t drags{};
+		std::vector<double> baseError{};     // px from the pointer one horizon later
+		std::vector<double> error{};
+		std::vector<double> baseLag{};       // ms behind the pointer, while it moves
+		std::vector<double> lag{};
+	};
+
+	std::vector<DragTrace> GetDragTraces(const Session& session)
+	{
+		std::vector<DragTrace> traces{};
+		bool isDragging{};
+		for (const Step& step : session.steps) {
+			if (step.event.depth) { continue; }
+			const TracePoint point{ double(step.event.time) / 1e6, double(step.event.x), double(step.event.y) };
+
+			switch (Replay::Message(step.event.message))
+			{
+			case Replay::Message::RButtonDown:
+				traces.emplace_back(1, point);
+				isDragging = true;
+				break;
+			case Replay::Message::MouseMove:
+				if (isDragging) { traces.back().push_back(point); }
+				break;
+			case Replay::Message::RButtonUp:
+				if (isDragging) { traces.back().push_back(point); }
+				isDragging = false;
+				break;
+			default:
+				break;
+			}
+		}
+		return traces;
+	}
+
+	// Pointer position at a time, linear between samples and held outside the drag
+	TracePoint Interpolate(const DragTrace& trace, double timeMs)
+	{
+		if (timeMs <= trace.front().timeMs) { return trace.front(); }
+		if (timeMs >= trace.back().timeMs) { return trace.back(); }
+
+		const auto next = std::upper_bound(trace.begin(), trace.end(), timeMs,
+			[](double time, const TracePoint& point) { return time < point.timeMs; });
+		const TracePoint& a = *(next - 1);
+		const TracePoint& b = *next;
+		const double f = b.timeMs > a.timeMs ? (timeMs - a.timeMs) / (b.timeMs - a.timeMs) : 1.0;
+		return { timeMs, a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f };
+	}
+
+	double Distance(const TracePoint& point, double x, double y)
+	{
+		return std::hypot(point.x - x, point.y - y);
+	}
+
+	// How long before `targetMs` the pointer was closest to (x, y), searched
+	// from one horizon ahead of it to three behind
+	double FindLag(const DragTrace& trace, double targetMs, double horizonMs, double x, double y)
+	{
+		double lag{};
+		double best = Distance(Interpolate(trace, targetMs), x, y);
+		for (double shift = -horizonMs; shift <= 3 * horizonMs; shift += 0.25) {
+			const double distance = Distance(Interpolate(trace, targetMs - shift), x, y);
+			if (distance < best) {
+				best = distance;
+				lag = shift;
+			}
+		}
+		return lag;
+	}
+
+	// Feeds each drag's moves to a predictor the way MainWindow does and
+	// scores the drawn position against where the pointer went
+	PredictionStats EvaluatePrediction(const Session& session)
+	{
+		PredictionStats stats{};
+		PointerPredictor predictor{};
+		const double horizonMs = double(predictor.GetConfig().horizonMs);
+
+		for (const DragTrace& trace : GetDragTraces(session)) {
+			++stats.drags;
+			predictor.Reset();
+
+			// The first sample is the button press; the last is the release
+			for (size_t i = 1; i + 1 < trace.size(); ++i) {
+				const TracePoint& sample = trace[i];
+				const uint32_t timeMs = uint32_t(sample.timeMs);
+				predictor.AddSample({ long(sample.x), long(sample.y), timeMs });
+				const PointerPredictor::Offset offset = predictor.Predict(timeMs);
+
+				// The frame for this move is seen one horizon later
+				const double targetMs = sample.timeMs + horizonMs;
+				if (targetMs > trace.back().timeMs) { break; }
+				const TracePoint target = Interpolate(trace, targetMs);
+				const double x = sample.x + double(offset.dx);
+				const double y = sample.y + double(offset.dy);
+				stats.baseError.push_back(Distance(target, sample.x, sample.y));
+				stats.error.push_back(Distance(target, x, y));
+
+				// A resting pointer has no lag to measure
+				if (Distance(target, sample.x, sample.y) < 2.0) { continue; }
+				stats.baseLag.push_back(FindLag(trace, targetMs, horizonMs, sample.x, sample.y));
+				stats.lag.push_back(FindLag(trace, targetMs, horizonMs, x, y));
+			}
+		}
+		return stats;
+	}
+
+	double Mean(const std::vector<double>& values)
+	{
+		double sum{};
+		for (double value : values) { sum += value; }
+		return values.empty() ? 0.0 : sum / double(values.size());
+	}
+
+	double Percentile95(std::vector<double> values)
+	{
+		if (values.empty()) { return 0.0; }
+		const size_t index = (values.size() - 1) * 95 / 100;
+		std::nth_element(values.begin(), values.begin() + ptrdiff_t(index), values.end());
+		return values[index];
+	}
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	unsigned iterations = 1;
+	bool isTiming = true;
+	bool isCheckingPrediction{};
+	const char* path{};
+
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--iterations") and i + 1 < argc) {
+			iterations = std::max(1u, unsigned(std::strtoul(argv[++i], nullptr, 10)));
+		}
+		else if (!std::strcmp(argv[i], "--no-timing")) {
+			isTiming = false;
+		}
+		else if (!std::strcmp(argv[i], "--check-prediction")) {
+			isCheckingPrediction = true;
+		}
+		else {
+			path = argv[i];
+		}
+	}
+
+	if (!path) {
+		std::fprintf(stderr, "Usage: Replay [--iterations <n>] [--no-timing] [--check-prediction] <session.replay>\n");
+		return 2;
+	}
+
+	Session session{};
+	if (!ReadSession(path, &session)) { return 1; }
+
+	// Best run per handler filters out scheduler noise
+	Cost best[size_t(Handler::Count)]{};
+	TabModel model{};
+
+	for (unsigned run{}; run < iterations; ++run) {
+		Cost costs[size_t(Handler::Count)]{};
+		Run(session, &model, costs);
+
+		for (size_t i{}; i < size_t(Handler::Count); ++i) {
+			if (!run or costs[i].totalNs < best[i].totalNs) { best[i] = costs[i]; }
+		}
+	}
+
+	const uint64_t durationMs = session.steps.empty() ? 0 : session.steps.back().event.time / 1000000;
+	std::printf("session    %zu events, %llu ms\n",
+		session.steps.size(), (unsigned long long)durationMs);
+
+	if (isTiming) {
+		std::printf("\n%-14s %10s %12s %10s %10s\n", "handler", "calls", "total ns", "mean ns", "max ns");
+		for (size_t i{}; i < size_t(Handler::Count); ++i) {
+			if (!best[i].calls) { continue; }
+			std::printf("%-14s %10llu %12llu %10llu %10llu\n",
+				GetHandlerName(Handler(i)),
+				(unsigned long long)best[i].calls,
+				(unsigned long long)best[i].totalNs,
+				(unsigned long long)(best[i].totalNs / best[i].calls),
+				(unsigned long long)best[i].maxNs);
+		}
+	}
+
+	const Counters& counters = model.counters;
+	std::printf("\ntab moves  %llu\n", (unsigned long long)counters.tabMoves);
+	std::printf("osk moves  %llu\n", (unsigned long long)counters.oskMoves);
+	std::printf("previews   %llu\n", (unsigned long long)counters.previewMoves);
+	std::printf("redraws    %llu\n", (unsigned long long)counters.redraws);
+	std::printf("blinks     %llu\n", (unsigned long long)counters.blinks);
+	std::printf("osk shown  %llu, hidden %llu\n",
+		(unsigned long long)counters.oskShows, (unsigned long long)counters.oskHides);
+	std::printf("drag       %llu frames, %.2f moves/frame, max %u\n",
+		(unsigned long long)model.dragMoves.GetFrameCount(),
+		model.dragMoves.GetMovesPerFrame(),
+		model.dragMoves.GetMaxMovesPerFrame());
+	std::printf("settings   %llu changes, %llu passes\n",
+		(unsigned long long)counters.settingChanges, (unsigned long long)counters.settingPasses);
+	std::printf("nested     %llu records issued by the model\n", (unsigned long long)counters.skipped);
+	model.PrintFrame();
+	model.PrintGeometry();
+
+	const PredictionStats prediction = EvaluatePrediction(session);
+	if (!prediction.error.empty()) {
+		std::printf("predict    %zu moves in %zu drags, error %.1f -> %.1f px, p95 %.1f -> %.1f px, lag %.1f -> %.1f ms\n",
+			prediction.error.size(), prediction.drags,
+			Mean(prediction.baseError), Mean(prediction.error),
+			Percentile95(prediction.baseError), Percentile95(prediction.error),
+			Mean(prediction.baseLag), Mean(prediction.lag));
+	}
+
+	if (isCheckingPrediction) {
+		if (prediction.error.empty() or prediction.lag.empty()) {
+			std::fprintf(stderr, "%s: no drag to check the prediction against\n", path);
+			return 3;
+		}
+		if (Mean(prediction.error) >= Mean(prediction.baseError) or Mean(prediction.lag) >= Mean(prediction.baseLag)) {
+			std::fprintf(stderr, "%s: prediction does not beat the last sample\n", path);
+			return 3;
+		}
+	}
+
+	return 0;
+}
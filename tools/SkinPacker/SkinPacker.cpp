@@ -0,0 +1,232 @@
+// Packs 32-bit BMP images into a TabTap.skin container.
+//
+//   SkinPacker <output.skin> <state>:<dpi>:<image.bmp> [...]
+//
+// States: idle, hover, pressed, dragging, rejected, osk
+// Every input is premultiplied and stored twice: as drawn and pre-mirrored
+// for the right screen edge.
+
+// Implementation-specific headers
+#include "../../src/Core/SkinFormat.h"
+
+// Standard library headers
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+
+namespace
+{
+	struct Image
+	{
+		uint16_t width{};
+		uint16_t height{};
+		std::vector<uint8_t> pixels{};  // Top-down premultiplied BGRA, tightly packed
+	};
+
+	struct Input
+	{
+		Skin::State state{};
+		uint16_t dpi{};
+		Image image{};
+	};
+
+	bool ParseState(const std::string& name, Skin::State* pState)
+	{
+		static const struct { const char* name; Skin::State state; } names[] = {
+			{ "idle",     Skin::State::Idle },
+			{ "hover",    Skin::State::Hover },
+			{ "pressed",  Skin::State::Pressed },
+			{ "dragging", Skin::State::Dragging },
+			{ "rejected", Skin::State::SnapRejected },
+			{ "osk",      Skin::State::OskVisible },
+		};
+
+		for (const auto& entry : names) {
+			if (name == entry.name) {
+				*pState = entry.state;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <typename ValueTy>
+	ValueTy ReadLE(const uint8_t* p)
+	{
+		ValueTy value{};
+		std::memcpy(&value, p, sizeof(ValueTy));
+		return value;
+	}
+
+	// Reads an uncompressed 32-bit BMP (BI_RGB or BI_BITFIELDS with BGRA masks)
+	bool LoadBitmap(const char* path, Image* pImage)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+		if (data.size() < 54 or data[0] != 'B' or data[1] != 'M') { return false; }
+
+		const uint32_t pixelOffset = ReadLE<uint32_t>(&data[10]);
+		const int32_t width = ReadLE<int32_t>(&data[18]);
+		const int32_t height = ReadLE<int32_t>(&data[22]);
+		const uint16_t bitCount = ReadLE<uint16_t>(&data[28]);
+		const uint32_t compression = ReadLE<uint32_t>(&data[30]);
+
+		if (bitCount != 32 or (compression != 0 and compression != 3)) { return false; }
+		if (width <= 0 or width > Skin::MaxDimension or
+			height == 0 or std::abs(height) > Skin::MaxDimension)
+		{
+			return false;
+		}
+
+		const bool isTopDown = height < 0;
+		const uint32_t rows = uint32_t(std::abs(height));
+		const size_t rowSize = size_t(width) * 4;
+		if (pixelOffset + rowSize * rows > data.size()) { return false; }
+
+		pImage->width = uint16_t(width);
+		pImage->height = uint16_t(rows);
+		pImage->pixels.resize(rowSize * rows);
+
+		for (uint32_t y{}; y < rows; ++y) {
+			const uint32_t srcRow = isTopDown ? y : rows - 1 - y;
+			const uint8_t* src = &data[pixelOffset + srcRow * rowSize];
+			uint8_t* dst = &pImage->pixels[y * rowSize];
+
+			for (int32_t x{}; x < width; ++x) {
+				const uint8_t alpha = src[x * 4 + 3];
+				dst[x * 4 + 0] = uint8_t((src[x * 4 + 0] * alpha + 127) / 255);
+				dst[x * 4 + 1] = uint8_t((src[x * 4 + 1] * alpha + 127) / 255);
+				dst[x * 4 + 2] = uint8_t((src[x * 4 + 2] * alpha + 127) / 255);
+				dst[x * 4 + 3] = alpha;
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t AlignUp(size_t value, uint32_t alignment)
+	{
+		return uint32_t((value + alignment - 1) / alignment * alignment);
+	}
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3) {
+		std::fprintf(stderr,
+			"Usage: %s <output.skin> <state>:<dpi>:<image.bmp> [...]\n"
+			"States: idle, hover, pressed, dragging, rejected, osk\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<Input> inputs{};
+
+	for (int i = 2; i < argc; ++i) {
+		const std::string arg = argv[i];
+		const size_t first = arg.find(':');
+		const size_t second = arg.find(':', first + 1);
+		if (first == std::string::npos or second == std::string::npos) {
+			std::fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+			return 1;
+		}
+
+		Input input{};
+		const int dpi = std::atoi(arg.substr(first + 1, second - first - 1).c_str());
+		if (!ParseState(arg.substr(0, first), &input.state) or dpi <= 0 or dpi > 0xFFFF) {
+			std::fprintf(stderr, "Invalid state or DPI: %s\n", argv[i]);
+			return 1;
+		}
+		input.dpi = uint16_t(dpi);
+
+		const std::string path = arg.substr(second + 1);
+		if (!LoadBitmap(path.c_str(), &input.image)) {
+			std::fprintf(stderr, "Unsupported or unreadable bitmap: %s\n", path.c_str());
+			return 1;
+		}
+
+		inputs.push_back(std::move(input));
+	}
+
+	const uint32_t frameCount = uint32_t(inputs.size() * 2);
+	if (frameCount > Skin::MaxFrames) {
+		std::fprintf(stderr, "Too many frames (max %u)\n", Skin::MaxFrames / 2);
+		return 1;
+	}
+
+	// Lay out header, frame table and aligned pixel blocks
+	std::vector<Skin::FrameEntry> entries{};
+	size_t offset = AlignUp(sizeof(Skin::Header) + frameCount * sizeof(Skin::FrameEntry),
+		Skin::PixelAlignment);
+
+	for (const Input& input : inputs) {
+		for (uint8_t flags : { uint8_t(Skin::FrameNone), uint8_t(Skin::FrameMirrored) }) {
+			Skin::FrameEntry entry{};
+			entry.state = uint8_t(input.state);
+			entry.flags = flags;
+			entry.dpi = input.dpi;
+			entry.width = input.image.width;
+			entry.height = input.image.height;
+			entry.stride = uint32_t(input.image.width) * 4;
+			entry.pixelOffset = uint32_t(offset);
+			entries.push_back(entry);
+
+			offset = AlignUp(offset + size_t(entry.stride) * entry.height, Skin::PixelAlignment);
+		}
+	}
+
+	Skin::Header header{};
+	header.magic = Skin::Magic;
+	header.version = Skin::Version;
+	header.headerSize = sizeof(Skin::Header);
+	header.fileSize = uint32_t(offset);
+	header.frameCount = frameCount;
+	header.frameTableOffset = sizeof(Skin::Header);
+
+	std::vector<uint8_t> output(offset);
+	std::memcpy(output.data(), &header, sizeof(header));
+	std::memcpy(output.data() + header.frameTableOffset, entries.data(),
+		entries.size() * sizeof(Skin::FrameEntry));
+
+	for (size_t i{}; i < entries.size(); ++i) {
+		const Skin::FrameEntry& entry = entries[i];
+		const Image& image = inputs[i / 2].image;
+		const bool isMirrored = (entry.flags & Skin::FrameMirrored) != 0;
+
+		for (uint32_t y{}; y < entry.height; ++y) {
+			const uint8_t* src = &image.pixels[y * entry.stride];
+			uint8_t* dst = &output[entry.pixelOffset + y * entry.stride];
+
+			if (!isMirrored) {
+				std::memcpy(dst, src, entry.stride);
+				continue;
+			}
+			for (uint32_t x{}; x < entry.width; ++x) {
+				std::memcpy(dst + x * 4, src + (entry.width - 1 - x) * 4, 4);
+			}
+		}
+	}
+
+	// Validate with the same reader the application uses
+	Skin::View view{ output.data(), output.size() };
+	if (!view.IsValid()) {
+		std::fprintf(stderr, "Internal error: packed skin failed validation\n");
+		return 1;
+	}
+
+	std::ofstream file{ argv[1], std::ios::binary | std::ios::trunc };
+	file.write(reinterpret_cast<const char*>(output.data()), std::streamsize(output.size()));
+	if (!file) {
+		std::fprintf(stderr, "Failed to write %s\n", argv[1]);
+		return 1;
+	}
+
+	std::printf("Packed %u frames into %s (%zu bytes)\n", frameCount, argv[1], output.size());
+	return 0;
+}